@@ -1,19 +1,58 @@
 #pragma once
+#include "Engine/Async/JobAllocator.hpp"
+
+#include <atomic>
 #include <mutex>
+#include <vector>
+
+
+enum eJobState {
+	JOB_STATE_CREATED = 0,
+	JOB_STATE_WAITING,		// Submitted, waiting on dependencies
+	JOB_STATE_QUEUED,
+	JOB_STATE_RUNNING,
+	JOB_STATE_FINISHED,		// Executed, waiting for the main thread to run OnComplete
+	JOB_STATE_COMPLETE		// OnComplete has run
+};
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Counts outstanding jobs. Pass one to SubmitJob and wait on it with JobSystem::WaitForCounter.
+class JobCounter {
+	friend class JobSystem;
+
+public:
+	JobCounter() { m_count.store( 0 ); }
+
+	bool IsDone() const { return m_count.load() == 0; }
+	int GetCount() const { return m_count.load(); }
+
+private:
+	std::atomic<int> m_count;
+};
+
 
+//----------------------------------------------------------------------------------------------------------------
+// By default the job system owns a job once it's submitted and deletes it after OnComplete. Call
+// SetDeleteWhenComplete( false ) to keep it, then delete it yourself once IsComplete() returns true.
 class Job {
+	friend class JobSystem;
 
 public:
+	Job() {
+		m_state.store( JOB_STATE_CREATED );
+		m_unmetDependencyCount.store( 1 );	// Held by the submitter until SubmitJob
+		m_unfinishedJobCount.store( 1 );	// This job plus any children it spawns
+	}
 	virtual ~Job() {}
 	virtual void Execute() = 0;
 	virtual void OnComplete() = 0;
 
-	int AssignID() {
-		s_jobIDLock.lock();
-		m_id = s_jobID;
-		s_jobID++;
-		s_jobIDLock.unlock();
+	static void* operator new( size_t size ) { return JobAllocator::Allocate( size ); }
+	static void operator delete( void* memory, size_t size ) { JobAllocator::Free( memory, size ); }
 
+	int AssignID() {
+		m_id = s_nextJobID.fetch_add( 1 );
 		return m_id;
 	}
 
@@ -21,8 +60,25 @@ public:
 		return m_id;
 	}
 
+	eJobState GetState() const { return (eJobState) m_state.load(); }
+	bool IsComplete() const { return GetState() == JOB_STATE_COMPLETE; }
+
+	void SetDeleteWhenComplete( bool deleteWhenComplete ) { m_deleteWhenComplete = deleteWhenComplete; }
+
 private:
-	static int s_jobID;
-	static std::mutex s_jobIDLock;
-	int m_id;
-};
\ No newline at end of file
+	static std::atomic<int> s_nextJobID;
+	int m_id = -1;
+	std::atomic<int> m_state;
+
+	std::atomic<int> m_unmetDependencyCount;
+	std::atomic<int> m_unfinishedJobCount;
+	Job* m_parent = nullptr;
+	JobCounter* m_counter = nullptr;
+	Job* m_nextFinished = nullptr;		// Link in the finished job list
+	bool m_returnWhenFinished = true;	// false skips OnComplete and is freed on the worker, e.g. ParallelFor helpers
+	bool m_deleteWhenComplete = true;
+
+	std::mutex m_continuationLock;
+	bool m_isFinished = false;
+	std::vector<Job*> m_continuations;	// Jobs waiting on this one
+};
@@ -0,0 +1,155 @@
+#include "Engine/Async/JobAllocator.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <new>
+
+
+struct JobFreeSlot_T {
+	JobFreeSlot_T* next;
+};
+
+
+struct JobAllocatorCentral_T {
+	std::mutex lock;
+	JobFreeSlot_T* freeLists[ JOB_ALLOCATOR_SIZE_CLASS_COUNT ] = {};
+};
+
+
+struct JobAllocatorThreadCache_T {
+	~JobAllocatorThreadCache_T();
+
+	JobFreeSlot_T* freeLists[ JOB_ALLOCATOR_SIZE_CLASS_COUNT ] = {};
+	int freeCounts[ JOB_ALLOCATOR_SIZE_CLASS_COUNT ] = {};
+};
+
+
+static JobAllocatorCentral_T s_central;
+static std::atomic<int> s_heapAllocationCount( 0 );
+static thread_local JobAllocatorThreadCache_T t_cache;
+
+
+//----------------------------------------------------------------------------------------------------------------
+static size_t GetSlotSize( int sizeClass ) {
+	return (size_t) JOB_ALLOCATOR_MIN_SLOT_SIZE << sizeClass;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Hands a thread's free slots back so they aren't lost when the thread exits
+JobAllocatorThreadCache_T::~JobAllocatorThreadCache_T() {
+	std::lock_guard<std::mutex> lock( s_central.lock );
+
+	for ( int sizeClass = 0; sizeClass < JOB_ALLOCATOR_SIZE_CLASS_COUNT; sizeClass++ ) {
+		while ( freeLists[sizeClass] != nullptr ) {
+			JobFreeSlot_T* slot = freeLists[sizeClass];
+			freeLists[sizeClass] = slot->next;
+			slot->next = s_central.freeLists[sizeClass];
+			s_central.freeLists[sizeClass] = slot;
+		}
+		freeCounts[sizeClass] = 0;
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int JobAllocator::GetSizeClass( size_t size ) {
+	for ( int sizeClass = 0; sizeClass < JOB_ALLOCATOR_SIZE_CLASS_COUNT; sizeClass++ ) {
+		if ( size <= GetSlotSize( sizeClass ) ) {
+			return sizeClass;
+		}
+	}
+	return -1;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+static void RefillThreadCache( JobAllocatorThreadCache_T& cache, int sizeClass ) {
+	std::lock_guard<std::mutex> lock( s_central.lock );
+
+	if ( s_central.freeLists[sizeClass] == nullptr ) {
+		size_t slotSize = GetSlotSize( sizeClass );
+		char* chunk = (char*) ::operator new( slotSize * JOB_ALLOCATOR_SLOTS_PER_CHUNK );
+		s_heapAllocationCount.fetch_add( 1 );
+
+		for ( int i = JOB_ALLOCATOR_SLOTS_PER_CHUNK - 1; i >= 0; i-- ) {
+			JobFreeSlot_T* slot = (JobFreeSlot_T*) (chunk + (slotSize * i));
+			slot->next = s_central.freeLists[sizeClass];
+			s_central.freeLists[sizeClass] = slot;
+		}
+	}
+
+	for ( int i = 0; i < JOB_ALLOCATOR_TRANSFER_BATCH && s_central.freeLists[sizeClass] != nullptr; i++ ) {
+		JobFreeSlot_T* slot = s_central.freeLists[sizeClass];
+		s_central.freeLists[sizeClass] = slot->next;
+		slot->next = cache.freeLists[sizeClass];
+		cache.freeLists[sizeClass] = slot;
+		cache.freeCounts[sizeClass]++;
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+static void DrainThreadCache( JobAllocatorThreadCache_T& cache, int sizeClass ) {
+	std::lock_guard<std::mutex> lock( s_central.lock );
+
+	for ( int i = 0; i < JOB_ALLOCATOR_THREAD_CACHE_LIMIT / 2; i++ ) {
+		JobFreeSlot_T* slot = cache.freeLists[sizeClass];
+		cache.freeLists[sizeClass] = slot->next;
+		cache.freeCounts[sizeClass]--;
+		slot->next = s_central.freeLists[sizeClass];
+		s_central.freeLists[sizeClass] = slot;
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void* JobAllocator::Allocate( size_t size ) {
+	int sizeClass = GetSizeClass( size );
+	if ( sizeClass < 0 ) {
+		s_heapAllocationCount.fetch_add( 1 );
+		return ::operator new( size );
+	}
+
+	JobAllocatorThreadCache_T& cache = t_cache;
+	if ( cache.freeLists[sizeClass] == nullptr ) {
+		RefillThreadCache( cache, sizeClass );
+	}
+
+	JobFreeSlot_T* slot = cache.freeLists[sizeClass];
+	cache.freeLists[sizeClass] = slot->next;
+	cache.freeCounts[sizeClass]--;
+	return slot;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Jobs are often deleted on a different thread than the one that made them (children spawned on workers are
+// completed on the main thread), so a cache that keeps growing gives half its slots back to everyone else
+void JobAllocator::Free( void* memory, size_t size ) {
+	if ( memory == nullptr ) {
+		return;
+	}
+
+	int sizeClass = GetSizeClass( size );
+	if ( sizeClass < 0 ) {
+		::operator delete( memory );
+		return;
+	}
+
+	JobAllocatorThreadCache_T& cache = t_cache;
+	JobFreeSlot_T* slot = (JobFreeSlot_T*) memory;
+	slot->next = cache.freeLists[sizeClass];
+	cache.freeLists[sizeClass] = slot;
+	cache.freeCounts[sizeClass]++;
+
+	if ( cache.freeCounts[sizeClass] > JOB_ALLOCATOR_THREAD_CACHE_LIMIT ) {
+		DrainThreadCache( cache, sizeClass );
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int JobAllocator::GetHeapAllocationCount() {
+	return s_heapAllocationCount.load();
+}
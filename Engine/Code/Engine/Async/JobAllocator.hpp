@@ -0,0 +1,27 @@
+#pragma once
+#include <stddef.h>
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Size-class pool for Job subclasses. Each thread keeps its own free lists and trades slots with a shared list in
+// batches, so allocating and deleting jobs only takes a lock once every JOB_ALLOCATOR_TRANSFER_BATCH jobs.
+// Slots are carved out of chunks that live for the rest of the program. Anything bigger than the largest size
+// class goes to the global heap.
+#define JOB_ALLOCATOR_MIN_SLOT_SIZE 64
+#define JOB_ALLOCATOR_SIZE_CLASS_COUNT 5		// 64, 128, 256, 512, 1024
+#define JOB_ALLOCATOR_SLOTS_PER_CHUNK 128
+#define JOB_ALLOCATOR_TRANSFER_BATCH 32
+#define JOB_ALLOCATOR_THREAD_CACHE_LIMIT 256
+
+
+class JobAllocator {
+
+public:
+	static void* Allocate( size_t size );
+	static void Free( void* memory, size_t size );
+
+	static int GetHeapAllocationCount();	// Chunks plus oversized jobs, should level off after warm up
+
+private:
+	static int GetSizeClass( size_t size );
+};
@@ -1,32 +1,52 @@
 #include "Engine/Async/JobSystem.hpp"
 #include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/DevConsole/DevConsole.hpp"
+#include "Engine/DevConsole/Command.hpp"
+#include "Engine/Profiler/Profiler.hpp"
 
+#include <new>
+#include <thread>
 
-bool JobSystem::s_workerThreadsContinue = true;
 
-int Job::s_jobID = 0;
-std::mutex Job::s_jobIDLock;
+std::atomic<int> Job::s_nextJobID( 0 );
+
+// Set on worker threads so jobs submitted from inside a job go to that worker's own deque
+static thread_local JobWorker_T* t_currentWorker = nullptr;
 
 
 //----------------------------------------------------------------------------------------------------------------
+// The epoch is read before looking for work, so a job enqueued after an empty search always moves it and the
+// worker either doesn't sleep or gets woken. A search that came up empty because another thread took the job
+// just parks, there's no spinning. Once stopped, workers keep going until there's nothing left to take.
 void RunWorkerThreadCB( void* userData ) {
-	userData;
+	JobWorker_T* worker = (JobWorker_T*) userData;
+	JobSystem* system = worker->system;
+	t_currentWorker = worker;
 
-	while( JobSystem::s_workerThreadsContinue ) {
-		Job* runningJob = g_theJobSystem->AcquireJob();
+	for (;;) {
+		unsigned int epoch = system->m_wakeEpoch.load();
+		Job* runningJob = system->AcquireJob( worker );
 		if ( runningJob != nullptr ) {
-			runningJob->Execute();
-			g_theJobSystem->ReturnJob( runningJob );
+			system->RunJob( runningJob );
+		} else if ( !system->m_isRunning.load() ) {
+			break;
 		} else {
-			SleepThread(10);
+			system->WaitForWork( epoch );
 		}
 	}
+
+	t_currentWorker = nullptr;
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
 JobSystem::JobSystem() {
-
+	m_isRunning.store( false );
+	m_wakeEpoch.store( 0 );
+	m_sleepingWorkerCount.store( 0 );
+	m_counterWaiterCount.store( 0 );
+	m_finishedJobHead.store( nullptr );
 }
 
 
@@ -37,10 +57,36 @@ JobSystem::~JobSystem() {
 
 
 //----------------------------------------------------------------------------------------------------------------
-void JobSystem::Startup() {
+int JobSystem::DetectWorkerCount() {
+	int hardwareThreads = (int) std::thread::hardware_concurrency();
+
+	// Leave a core for the main thread
+	int workerCount = hardwareThreads - 1;
+	if ( workerCount < 1 ) {
+		workerCount = 1;
+	}
+	if ( workerCount > JOB_SYSTEM_MAX_WORKER_THREAD_COUNT ) {
+		workerCount = JOB_SYSTEM_MAX_WORKER_THREAD_COUNT;
+	}
+
+	return workerCount;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void JobSystem::Startup( int workerCount /* = -1 */ ) {
+
+	if ( workerCount <= 0 ) {
+		workerCount = DetectWorkerCount();
+	}
 
-	for ( int i = 0; i < JOB_SYSTEM_WORKER_THREAD_COUNT; i++ ) {
-		m_workers[i] = CreateNewThread("Worker " + std::to_string(i), RunWorkerThreadCB );
+	StartWorkers( workerCount );
+
+	// Tests start more than one system, the command only needs registering once
+	static bool s_isCommandRegistered = false;
+	if ( !s_isCommandRegistered ) {
+		s_isCommandRegistered = true;
+		CommandRegistration::RegisterCommand("job_bench", BenchmarkCommand, "[jobCount] - Measures job latency and throughput for 1 to 64 worker threads" );
 	}
 }
 
@@ -48,59 +94,541 @@ void JobSystem::Startup() {
 //----------------------------------------------------------------------------------------------------------------
 void JobSystem::Shutdown() {
 
-	while ( !m_pendingJobs.IsEmpty() ) {
-		::SleepThread(10);
+	StopWorkers();
+
+	// Whatever finished on the way out gets freed without OnComplete, the systems it would talk to are going away
+	Job* finishedJob = m_finishedJobHead.exchange( nullptr );
+	while ( finishedJob != nullptr ) {
+		Job* next = finishedJob->m_nextFinished;
+		finishedJob->m_state.store( JOB_STATE_COMPLETE );
+		if ( finishedJob->m_deleteWhenComplete ) {
+			delete finishedJob;
+		}
+		finishedJob = next;
 	}
+}
 
-	s_workerThreadsContinue = false;
 
-	for ( int i = 0; i < JOB_SYSTEM_WORKER_THREAD_COUNT; i++ ) {
-		JoinThread( m_workers[i] );
+//----------------------------------------------------------------------------------------------------------------
+void JobSystem::StartWorkers( int workerCount ) {
+
+	if ( workerCount > JOB_SYSTEM_MAX_WORKER_THREAD_COUNT ) {
+		workerCount = JOB_SYSTEM_MAX_WORKER_THREAD_COUNT;
+	}
+
+	m_isRunning.store( true );
+
+	// Create every worker before any thread starts so thieves never see a partial list
+	for ( int i = 0; i < workerCount; i++ ) {
+		JobWorker_T* worker = new JobWorker_T();
+		worker->system = this;
+		worker->index = i;
+		worker->stealSeed = (unsigned int) i * 2654435761u + 1;
+		m_workers.push_back( worker );
+	}
+
+	for ( int i = 0; i < workerCount; i++ ) {
+		m_workers[i]->thread = CreateNewThread( "Worker " + std::to_string(i), RunWorkerThreadCB, m_workers[i] );
 	}
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
-int JobSystem::SubmitJob( Job* job ) {
+// Workers drain whatever is still queued before they exit
+void JobSystem::StopWorkers() {
+
+	m_isRunning.store( false );
+	{
+		std::lock_guard<std::mutex> lock( m_sleepLock );
+		m_wakeCondition.notify_all();
+	}
+
+	// Join everyone before freeing anything, a worker still draining can steal from any other worker's deque
+	for ( unsigned int i = 0; i < m_workers.size(); i++ ) {
+		JoinThread( m_workers[i]->thread );
+	}
+	for ( unsigned int i = 0; i < m_workers.size(); i++ ) {
+		delete m_workers[i];
+	}
+	m_workers.clear();
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int JobSystem::SubmitJob( Job* job, JobCounter* counter /* = nullptr */ ) {
 	int id = job->AssignID();
-	m_pendingJobs.Push( job );
+
+	job->m_counter = counter;
+	job->m_state.store( JOB_STATE_WAITING );
+	if ( counter != nullptr ) {
+		counter->m_count.fetch_add( 1 );
+	}
+
+	// Drop the hold taken in the Job constructor, queues it if nothing else is outstanding.
+	// The job may already be running (or finished) after this, so don't touch it again.
+	ReleaseDependency( job );
 	return id;
 }
 
 
+//----------------------------------------------------------------------------------------------------------------
+int JobSystem::SubmitChildJob( Job* parent, Job* child, JobCounter* counter /* = nullptr */ ) {
+	parent->m_unfinishedJobCount.fetch_add( 1 );
+	child->m_parent = parent;
+	return SubmitJob( child, counter );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// dependency must not have been claimed yet, it may still be running or finished
+void JobSystem::AddDependency( Job* job, Job* dependency ) {
+	std::lock_guard<std::mutex> lock( dependency->m_continuationLock );
+
+	if ( !dependency->m_isFinished ) {
+		job->m_unmetDependencyCount.fetch_add( 1 );
+		dependency->m_continuations.push_back( job );
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void JobSystem::ReleaseDependency( Job* job ) {
+	if ( job->m_unmetDependencyCount.fetch_sub( 1 ) == 1 ) {
+		EnqueueJob( job );
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Workers push to their own deque. Everyone else, and a worker whose deque is full, goes through the injection
+// queue; if that's full too a worker runs its own newest job to make room and any other thread waits for one.
+void JobSystem::EnqueueJob( Job* job ) {
+	job->m_state.store( JOB_STATE_QUEUED );
+
+	JobWorker_T* worker = t_currentWorker;
+	bool isOwnWorker = (worker != nullptr && worker->system == this);
+
+	if ( !isOwnWorker || !worker->queue.Push( job ) ) {
+		while ( !m_injectedJobs.Push( job ) ) {
+			Job* ownJob = nullptr;
+			if ( isOwnWorker && worker->queue.Pop( &ownJob ) ) {
+				RunJob( ownJob );
+			} else {
+				YieldThread();
+			}
+		}
+	}
+
+	WakeWorker();
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void JobSystem::RunJob( Job* job ) {
+	PROFILER_SCOPED_PUSH();
+	job->m_state.store( JOB_STATE_RUNNING );
+	job->Execute();
+	FinishJob( job );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Called once when a job's Execute returns and once per child as they finish
+void JobSystem::FinishJob( Job* job ) {
+	if ( job->m_unfinishedJobCount.fetch_sub( 1 ) != 1 ) {
+		return;
+	}
+
+	// Pull out everything we need, the job can be claimed and deleted once it's returned
+	Job* parent = job->m_parent;
+	JobCounter* counter = job->m_counter;
+	bool returnWhenFinished = job->m_returnWhenFinished;
+	bool deleteWhenComplete = job->m_deleteWhenComplete;
+
+	std::vector<Job*> continuations;
+	job->m_continuationLock.lock();
+	job->m_isFinished = true;
+	continuations.swap( job->m_continuations );
+	job->m_continuationLock.unlock();
+
+	for ( unsigned int i = 0; i < continuations.size(); i++ ) {
+		ReleaseDependency( continuations[i] );
+	}
+
+	if ( returnWhenFinished ) {
+		ReturnJob( job );
+	} else if ( deleteWhenComplete ) {
+		delete job;
+	} else {
+		job->m_state.store( JOB_STATE_COMPLETE );
+	}
+
+	// The waiter may destroy the counter as soon as it reads zero, so don't touch it after this
+	if ( counter != nullptr && counter->m_count.fetch_sub( 1 ) == 1 ) {
+		WakeCounterWaiters();
+	}
+
+	if ( parent != nullptr ) {
+		FinishJob( parent );
+	}
+}
+
+
 //----------------------------------------------------------------------------------------------------------------
 Job* JobSystem::AcquireJob() {
+	JobWorker_T* worker = t_currentWorker;
+	if ( worker == nullptr || worker->system != this ) {
+		Job* claimedJob = nullptr;
+		if ( m_injectedJobs.Pop( &claimedJob ) || StealJob( nullptr, &claimedJob ) ) {
+			return claimedJob;
+		}
+		return nullptr;
+	}
+
+	return AcquireJob( worker );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Own deque first, then the injection queue, then steal from the other workers
+Job* JobSystem::AcquireJob( JobWorker_T* worker ) {
 	Job* claimedJob = nullptr;
-	if ( m_pendingJobs.Pop( &claimedJob ) ) {
+
+	if ( worker->queue.Pop( &claimedJob ) || m_injectedJobs.Pop( &claimedJob ) || StealJob( worker, &claimedJob ) ) {
 		return claimedJob;
-	} else {
-		return nullptr;
 	}
+
+	return nullptr;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+bool JobSystem::StealJob( JobWorker_T* thief, Job** out_job ) {
+	int workerCount = (int) m_workers.size();
+	if ( workerCount == 0 || (workerCount == 1 && thief != nullptr) ) {
+		return false;
+	}
+
+	// xorshift to pick a starting victim so thieves don't all pile onto worker 0.
+	// Non-worker threads (helping in WaitForCounter) keep their own seed.
+	static thread_local unsigned int t_helperSeed = 0x9e3779b9u;
+	unsigned int& seed = (thief != nullptr) ? thief->stealSeed : t_helperSeed;
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+
+	int start = (int) (seed % (unsigned int) workerCount);
+	for ( int i = 0; i < workerCount; i++ ) {
+		JobWorker_T* victim = m_workers[ (start + i) % workerCount ];
+		if ( victim != thief && victim->queue.Steal( out_job ) ) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void JobSystem::WaitForWork( unsigned int seenEpoch ) {
+	std::unique_lock<std::mutex> lock( m_sleepLock );
+
+	// Sleeping count goes up before the epoch check so EnqueueJob can't miss us
+	m_sleepingWorkerCount.fetch_add( 1 );
+	m_wakeCondition.wait( lock, [this, seenEpoch]() {
+		return m_wakeEpoch.load() != seenEpoch || !m_isRunning.load();
+	});
+	m_sleepingWorkerCount.fetch_sub( 1 );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// The job is already queued when this runs. Workers waiting on a counter get a look at it too, they may be the
+// only ones left who can run it.
+void JobSystem::WakeWorker() {
+	m_wakeEpoch.fetch_add( 1 );
+	if ( m_sleepingWorkerCount.load() > 0 ) {
+		std::lock_guard<std::mutex> lock( m_sleepLock );
+		m_wakeCondition.notify_one();
+	}
+	WakeCounterWaiters();
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
 void JobSystem::ReturnJob( Job* job ) {
-	m_finishedJobsLock.lock();
-	m_finishedJobs[ job->GetID() ] = job;
-	m_finishedJobsLock.unlock();
+	job->m_state.store( JOB_STATE_FINISHED );
+
+	Job* head = m_finishedJobHead.load();
+	do {
+		job->m_nextFinished = head;
+	} while ( !m_finishedJobHead.compare_exchange_weak( head, job ) );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void JobSystem::ProcessFinishedJobs() {
+	Job* finishedJob = m_finishedJobHead.exchange( nullptr );
+
+	// The list comes out newest first, flip it so OnComplete runs in finish order
+	Job* ordered = nullptr;
+	while ( finishedJob != nullptr ) {
+		Job* next = finishedJob->m_nextFinished;
+		finishedJob->m_nextFinished = ordered;
+		ordered = finishedJob;
+		finishedJob = next;
+	}
+
+	while ( ordered != nullptr ) {
+		Job* next = ordered->m_nextFinished;
+		ordered->OnComplete();
+		ordered->m_state.store( JOB_STATE_COMPLETE );
+		if ( ordered->m_deleteWhenComplete ) {
+			delete ordered;
+		}
+		ordered = next;
+	}
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
-Job* JobSystem::ClaimFinishedJob( int jobID ) {
-	Job* returnedJob = nullptr;
+// A worker helps with whatever it can get, the same way its loop would: its own deque, where the jobs it just
+// submitted are, then the injection queue, then the other deques. Leaving a job it popped (or one under it) for
+// someone else deadlocks when there is nobody else, so it only sleeps once nothing is runnable and wakes for the
+// counter or for new work. Threads without a deque, like the main thread, never run jobs here, they just sleep
+// until the counter hits zero.
+void JobSystem::WaitForCounter( JobCounter* counter ) {
+	JobWorker_T* worker = t_currentWorker;
+	bool isOwnWorker = (worker != nullptr && worker->system == this);
+
+	while ( !counter->IsDone() ) {
+		unsigned int seenEpoch = m_wakeEpoch.load();
+		if ( isOwnWorker ) {
+			Job* job = AcquireJob( worker );
+			if ( job != nullptr ) {
+				RunJob( job );
+				continue;
+			}
+		}
+
+		// Waiter count goes up before the epoch check so WakeWorker can't miss us
+		std::unique_lock<std::mutex> lock( m_counterLock );
+		m_counterWaiterCount.fetch_add( 1 );
+		m_counterCondition.wait( lock, [this, counter, isOwnWorker, seenEpoch]() {
+			return counter->IsDone() || (isOwnWorker && m_wakeEpoch.load() != seenEpoch) || !m_isRunning.load();
+		});
+		m_counterWaiterCount.fetch_sub( 1 );
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void JobSystem::WakeCounterWaiters() {
+	if ( m_counterWaiterCount.load() > 0 ) {
+		std::lock_guard<std::mutex> lock( m_counterLock );
+		m_counterCondition.notify_all();
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Shared by a ParallelFor call and its helper jobs, from the job pool. Grains are claimed off nextGrain by whoever
+// gets there first; the last reference out frees it, so the caller can return before a helper that never got a
+// grain has even started.
+struct ParallelForState_T {
+	const std::function<void(int, int)>* function;
+	int begin;
+	int end;
+	int grainSize;
+	int grainCount;
+	std::atomic<int> nextGrain;
+	std::atomic<int> finishedGrainCount;
+	std::atomic<int> referenceCount;
+};
+
+
+//----------------------------------------------------------------------------------------------------------------
+static bool RunParallelForGrain( ParallelForState_T* state ) {
+	int grain = state->nextGrain.fetch_add( 1 );
+	if ( grain >= state->grainCount ) {
+		return false;
+	}
+
+	int grainBegin = state->begin + (grain * state->grainSize);
+	int grainEnd = (state->end - grainBegin > state->grainSize) ? grainBegin + state->grainSize : state->end;
+	(*state->function)( grainBegin, grainEnd );
+
+	state->finishedGrainCount.fetch_add( 1 );
+	return true;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+static void ReleaseParallelForState( ParallelForState_T* state ) {
+	if ( state->referenceCount.fetch_sub( 1 ) == 1 ) {
+		state->~ParallelForState_T();
+		JobAllocator::Free( state, sizeof( ParallelForState_T ) );
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+class ParallelForJob : public Job {
+public:
+	ParallelForJob( ParallelForState_T* state ) : m_state( state ) {}
+
+	virtual void Execute() override {
+		while ( RunParallelForGrain( m_state ) ) {}
+		ReleaseParallelForState( m_state );
+	}
+	virtual void OnComplete() override {}
 
-	m_finishedJobsLock.lock();
-	std::map< int, Job* >::iterator finishedJob = m_finishedJobs.find( jobID );
+private:
+	ParallelForState_T* m_state;
+};
 
-	if ( finishedJob != m_finishedJobs.end()) {
-		returnedJob = finishedJob->second;
-		returnedJob->OnComplete();
-		m_finishedJobs.erase(jobID);
-	} 
-	
-	m_finishedJobsLock.unlock();
-	return returnedJob;
-	
-}
\ No newline at end of file
+
+//----------------------------------------------------------------------------------------------------------------
+// Calls fn( grainBegin, grainEnd ) for grainSize sized pieces of [begin, end) and returns once all of them are
+// done. At most one helper job per worker is queued and the calling thread takes grains too, so nothing but fn
+// runs on the caller and a busy pool just means the caller does more of the work itself.
+void JobSystem::ParallelFor( int begin, int end, int grainSize, const std::function<void(int, int)>& fn ) {
+	if ( end <= begin ) {
+		return;
+	}
+	if ( grainSize < 1 ) {
+		grainSize = 1;
+	}
+
+	int grainCount = ((end - begin) + grainSize - 1) / grainSize;
+	int helperCount = (grainCount - 1 < (int) m_workers.size()) ? grainCount - 1 : (int) m_workers.size();
+	if ( helperCount <= 0 ) {
+		fn( begin, end );
+		return;
+	}
+
+	ParallelForState_T* state = new ( JobAllocator::Allocate( sizeof( ParallelForState_T ) ) ) ParallelForState_T();
+	state->function = &fn;
+	state->begin = begin;
+	state->end = end;
+	state->grainSize = grainSize;
+	state->grainCount = grainCount;
+	state->nextGrain.store( 0 );
+	state->finishedGrainCount.store( 0 );
+	state->referenceCount.store( helperCount + 1 );
+
+	for ( int i = 0; i < helperCount; i++ ) {
+		ParallelForJob* helper = new ParallelForJob( state );
+		helper->m_returnWhenFinished = false;
+		SubmitJob( helper );
+	}
+
+	while ( RunParallelForGrain( state ) ) {}
+
+	// Every grain left is already running on a worker
+	while ( state->finishedGrainCount.load() < grainCount ) {
+		YieldThread();
+	}
+
+	ReleaseParallelForState( state );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Benchmark
+//----------------------------------------------------------------------------------------------------------------
+class BenchmarkJob : public Job {
+public:
+	virtual void Execute() override {
+		m_latency = GetPerformanceCount() - m_submitTime;
+	}
+	virtual void OnComplete() override {}
+
+	uint64_t m_submitTime = 0;
+	uint64_t m_latency = 0;
+};
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Doesn't help like WaitForCounter does, the point is to time the workers
+static void SpinOnCounter( JobCounter* counter ) {
+	while ( !counter->IsDone() ) {
+		YieldThread();
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Runs on a JobSystem of its own, so it works without the game and doesn't disturb g_theJobSystem
+JobBenchmarkResult_T JobSystem::RunBenchmark( int threadCount, int jobCount, int latencySamples ) {
+	JobBenchmarkResult_T result;
+	result.threadCount = threadCount;
+	result.jobCount = jobCount;
+
+	JobSystem* system = new JobSystem();
+	system->StartWorkers( threadCount );
+
+	// Submit-to-execute latency, one job in flight at a time so workers have to wake up for each
+	uint64_t totalLatency = 0;
+	uint64_t maxLatency = 0;
+	for ( int i = 0; i < latencySamples; i++ ) {
+		JobCounter counter;
+		BenchmarkJob* job = new BenchmarkJob();
+		job->SetDeleteWhenComplete( false );
+		job->m_submitTime = GetPerformanceCount();
+		system->SubmitJob( job, &counter );
+
+		SpinOnCounter( &counter );
+		system->ProcessFinishedJobs();
+
+		totalLatency += job->m_latency;
+		if ( job->m_latency > maxLatency ) {
+			maxLatency = job->m_latency;
+		}
+		delete job;
+	}
+
+	// Throughput, everything submitted up front, completed and freed by the system
+	int heapAllocationsBefore = JobAllocator::GetHeapAllocationCount();
+	JobCounter counter;
+	uint64_t start = GetPerformanceCount();
+	for ( int i = 0; i < jobCount; i++ ) {
+		system->SubmitJob( new BenchmarkJob(), &counter );
+	}
+	SpinOnCounter( &counter );
+	system->ProcessFinishedJobs();
+	double elapsed = PerformanceCountToSeconds( GetPerformanceCount() - start );
+	result.heapAllocations = JobAllocator::GetHeapAllocationCount() - heapAllocationsBefore;
+
+	system->StopWorkers();
+	delete system;
+
+	if ( latencySamples > 0 ) {
+		result.averageLatencySeconds = PerformanceCountToSeconds( totalLatency ) / (double) latencySamples;
+	}
+	result.maxLatencySeconds = PerformanceCountToSeconds( maxLatency );
+	if ( elapsed > 0.0 ) {
+		result.jobsPerSecond = (double) jobCount / elapsed;
+	}
+	return result;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void JobSystem::BenchmarkCommand( const std::string& command ) {
+	Command parsed( command );
+	int jobCount = 100000;
+	int argument = 0;
+	if ( parsed.PeekNextInt( argument ) && parsed.GetNextInt( argument ) && argument > 0 ) {
+		jobCount = argument;
+	}
+
+	const int latencySamples = 256;
+
+	DevConsole::Printf( "job_bench: %d jobs per run, %d latency samples", jobCount, latencySamples );
+
+	for ( int threadCount = 1; threadCount <= JOB_SYSTEM_MAX_WORKER_THREAD_COUNT; threadCount *= 2 ) {
+		JobBenchmarkResult_T result = RunBenchmark( threadCount, jobCount, latencySamples );
+		DevConsole::Printf( "%2d threads: latency avg %.1fus max %.1fus, %.0f jobs/sec, %d job heap allocations", result.threadCount, result.averageLatencySeconds * 1000000.0, result.maxLatencySeconds * 1000000.0, result.jobsPerSecond, result.heapAllocations );
+	}
+}
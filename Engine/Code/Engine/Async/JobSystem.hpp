@@ -1,11 +1,40 @@
 #pragma once
 #include "Engine/Async/Threads.hpp"
-#include "Engine/Async/ThreadSafeQueue.hpp"
 #include "Engine/Async/ThreadSafeMap.hpp"
+#include "Engine/Async/LockFreeQueue.hpp"
+#include "Engine/Async/WorkStealingQueue.hpp"
 #include "Engine/Async/Job.hpp"
 
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <vector>
 
-#define JOB_SYSTEM_WORKER_THREAD_COUNT 7
+
+#define JOB_SYSTEM_MAX_WORKER_THREAD_COUNT 64
+#define JOB_SYSTEM_WORKER_QUEUE_CAPACITY 4096
+#define JOB_SYSTEM_INJECTION_QUEUE_CAPACITY 16384	// Submitters outside the workers wait for room past this
+
+
+struct JobBenchmarkResult_T {
+	int threadCount = 0;
+	int jobCount = 0;
+	double averageLatencySeconds = 0.0;		// Submit to Execute, one job in flight
+	double maxLatencySeconds = 0.0;
+	double jobsPerSecond = 0.0;
+	int heapAllocations = 0;				// Jobs the pool couldn't serve
+};
+
+
+class JobSystem;
+
+struct JobWorker_T {
+	JobSystem* system = nullptr;
+	int index = -1;
+	unsigned int stealSeed = 0;
+	ThreadHandle thread = nullptr;
+	WorkStealingQueue<Job*, JOB_SYSTEM_WORKER_QUEUE_CAPACITY> queue;
+};
 
 
 class JobSystem {
@@ -14,25 +43,60 @@ public:
 	JobSystem();
 	~JobSystem();
 
-	void Startup();
+	void Startup( int workerCount = -1 );	// -1 picks a count from the hardware
 	void Shutdown();
 
-	int SubmitJob( Job* job );			// Called elsewhere, returns job ID
+	int SubmitJob( Job* job, JobCounter* counter = nullptr );				// Called elsewhere, returns job ID
+	int SubmitChildJob( Job* parent, Job* child, JobCounter* counter = nullptr );	// Parent doesn't finish until child does
+	void AddDependency( Job* job, Job* dependency );						// Call before job is submitted
 	Job* AcquireJob();					// Called by worker threads
-	void ReturnJob( Job* job );			// Called by worker threads 
-	Job* ClaimFinishedJob( int jobID ); // Called by any thread
+	void FinishJob( Job* job );			// Called by worker threads
+	void ReturnJob( Job* job );			// Called by worker threads, lock free
+	void ProcessFinishedJobs();			// Called by the main thread once a frame, runs OnComplete
+
+	void WaitForCounter( JobCounter* counter );	// Workers run any queued job while waiting, other threads sleep
+	void ParallelFor( int begin, int end, int grainSize, const std::function<void(int, int)>& fn );
 
+	int GetWorkerCount() const { return (int) m_workers.size(); }
 
-	static bool s_workerThreadsContinue;
+	static int DetectWorkerCount();
+	static JobBenchmarkResult_T RunBenchmark( int threadCount, int jobCount, int latencySamples );
+	static void BenchmarkCommand( const std::string& command );
+
+	friend void RunWorkerThreadCB( void* userData );
+
+
+private:
+	void StartWorkers( int workerCount );
+	void StopWorkers();
+
+	void EnqueueJob( Job* job );
+	void ReleaseDependency( Job* job );
+	void RunJob( Job* job );
+
+	Job* AcquireJob( JobWorker_T* worker );
+	bool StealJob( JobWorker_T* thief, Job** out_job );
+	void WaitForWork( unsigned int seenEpoch );
+	void WakeWorker();
+	void WakeCounterWaiters();
 
 
 private:
 
-	ThreadHandle m_workers[JOB_SYSTEM_WORKER_THREAD_COUNT];
-	ThreadSafeQueue<Job*> m_pendingJobs;
-	std::map<int, Job*> m_finishedJobs;
-	std::mutex m_finishedJobsLock;
+	std::vector<JobWorker_T*> m_workers;
+	LockFreeQueue<Job*, JOB_SYSTEM_INJECTION_QUEUE_CAPACITY> m_injectedJobs;	// From threads that don't own a deque
+	std::atomic<bool> m_isRunning;
+	std::atomic<unsigned int> m_wakeEpoch;		// Bumped on every enqueue, sleepers wait for it to move
+	std::atomic<int> m_sleepingWorkerCount;
+	std::mutex m_sleepLock;
+	std::condition_variable m_wakeCondition;
+
+	std::atomic<int> m_counterWaiterCount;		// Threads asleep in WaitForCounter
+	std::mutex m_counterLock;
+	std::condition_variable m_counterCondition;
+
+	std::atomic<Job*> m_finishedJobHead;		// Intrusive list, any thread pushes, main thread takes all of it
 
 };
 
-void RunWorkerThreadCB( void* userData );
\ No newline at end of file
+void RunWorkerThreadCB( void* userData );
@@ -0,0 +1,96 @@
+#pragma once
+#include <atomic>
+#include <stdint.h>
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Bounded multi-producer multi-consumer FIFO (Vyukov). Every cell carries a sequence number that says whether it's
+// ready to be written or read for the current lap, so producers and consumers only contend on their own position
+// counter and never take a lock. CAPACITY must be a power of two.
+template<typename T, int CAPACITY>
+class LockFreeQueue {
+	static_assert( (CAPACITY & (CAPACITY - 1)) == 0, "LockFreeQueue capacity must be a power of two" );
+
+public:
+	LockFreeQueue() {
+		for ( int64_t i = 0; i < CAPACITY; i++ ) {
+			m_cells[i].sequence.store( i, std::memory_order_relaxed );
+		}
+		m_pushPosition.store( 0, std::memory_order_relaxed );
+		m_popPosition.store( 0, std::memory_order_relaxed );
+	}
+
+
+	// Any thread. Returns false if the queue is full.
+	bool Push( const T& entry ) {
+		int64_t position = m_pushPosition.load( std::memory_order_relaxed );
+		Cell_T* cell = nullptr;
+
+		for (;;) {
+			cell = &m_cells[ position & MASK ];
+			int64_t sequence = cell->sequence.load( std::memory_order_acquire );
+			int64_t difference = sequence - position;
+
+			if ( difference == 0 ) {
+				if ( m_pushPosition.compare_exchange_weak( position, position + 1, std::memory_order_relaxed ) ) {
+					break;
+				}
+			} else if ( difference < 0 ) {
+				// Still holds last lap's entry
+				return false;
+			} else {
+				position = m_pushPosition.load( std::memory_order_relaxed );
+			}
+		}
+
+		cell->entry = entry;
+		cell->sequence.store( position + 1, std::memory_order_release );
+		return true;
+	}
+
+
+	// Any thread. Returns false if the queue is empty.
+	bool Pop( T* out_entry ) {
+		int64_t position = m_popPosition.load( std::memory_order_relaxed );
+		Cell_T* cell = nullptr;
+
+		for (;;) {
+			cell = &m_cells[ position & MASK ];
+			int64_t sequence = cell->sequence.load( std::memory_order_acquire );
+			int64_t difference = sequence - (position + 1);
+
+			if ( difference == 0 ) {
+				if ( m_popPosition.compare_exchange_weak( position, position + 1, std::memory_order_relaxed ) ) {
+					break;
+				}
+			} else if ( difference < 0 ) {
+				// Not written yet this lap
+				return false;
+			} else {
+				position = m_popPosition.load( std::memory_order_relaxed );
+			}
+		}
+
+		*out_entry = cell->entry;
+		cell->sequence.store( position + CAPACITY, std::memory_order_release );
+		return true;
+	}
+
+
+	bool IsEmpty() const {
+		return m_popPosition.load( std::memory_order_relaxed ) >= m_pushPosition.load( std::memory_order_relaxed );
+	}
+
+
+private:
+	static const int64_t MASK = CAPACITY - 1;
+
+	struct Cell_T {
+		std::atomic<int64_t> sequence;
+		T entry;
+	};
+
+	alignas(64) std::atomic<int64_t> m_pushPosition;
+	alignas(64) std::atomic<int64_t> m_popPosition;
+	alignas(64) Cell_T m_cells[ CAPACITY ];
+};
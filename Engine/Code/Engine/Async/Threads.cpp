@@ -1,6 +1,7 @@
 #include "Engine/Async/Threads.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/DevConsole/DevConsole.hpp"
+#include "Engine/Profiler/Profiler.hpp"
 
 #include "Engine/Core/WindowsCommon.hpp"
 #include <fstream>
@@ -38,6 +39,7 @@ static DWORD WINAPI ThreadEntryPoint( void* arg ) {
 
 	ThreadCB cb = initData->callback;
 	void* passArgs = initData->arg;
+	Profiler::SetThreadName( initData->name.c_str() );
 
 	//delete arg;
 
@@ -0,0 +1,95 @@
+#pragma once
+#include <atomic>
+#include <stdint.h>
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Bounded Chase-Lev deque. The owning thread pushes and pops from the bottom (LIFO, cache warm),
+// any other thread may steal from the top (FIFO). CAPACITY must be a power of two.
+template<typename T, int CAPACITY>
+class WorkStealingQueue {
+	static_assert( (CAPACITY & (CAPACITY - 1)) == 0, "WorkStealingQueue capacity must be a power of two" );
+
+public:
+	WorkStealingQueue() {
+		m_top.store( 0, std::memory_order_relaxed );
+		m_bottom.store( 0, std::memory_order_relaxed );
+	}
+
+
+	// Owner thread only. Returns false if the queue is full.
+	bool Push( const T& entry ) {
+		int64_t bottom = m_bottom.load( std::memory_order_relaxed );
+		int64_t top = m_top.load( std::memory_order_acquire );
+
+		if ( bottom - top >= CAPACITY ) {
+			return false;
+		}
+
+		m_entries[ bottom & MASK ].store( entry, std::memory_order_relaxed );
+		std::atomic_thread_fence( std::memory_order_release );
+		m_bottom.store( bottom + 1, std::memory_order_relaxed );
+		return true;
+	}
+
+
+	// Owner thread only. Takes the most recently pushed entry.
+	bool Pop( T* out_entry ) {
+		int64_t bottom = m_bottom.load( std::memory_order_relaxed ) - 1;
+		m_bottom.store( bottom, std::memory_order_relaxed );
+		std::atomic_thread_fence( std::memory_order_seq_cst );
+		int64_t top = m_top.load( std::memory_order_relaxed );
+
+		if ( top > bottom ) {
+			// Empty, restore
+			m_bottom.store( bottom + 1, std::memory_order_relaxed );
+			return false;
+		}
+
+		T entry = m_entries[ bottom & MASK ].load( std::memory_order_relaxed );
+		if ( top == bottom ) {
+			// Last entry, race any thieves for it
+			bool won = m_top.compare_exchange_strong( top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed );
+			m_bottom.store( bottom + 1, std::memory_order_relaxed );
+			if ( !won ) {
+				return false;
+			}
+		}
+
+		*out_entry = entry;
+		return true;
+	}
+
+
+	// Any thread. Takes the oldest entry.
+	bool Steal( T* out_entry ) {
+		int64_t top = m_top.load( std::memory_order_acquire );
+		std::atomic_thread_fence( std::memory_order_seq_cst );
+		int64_t bottom = m_bottom.load( std::memory_order_acquire );
+
+		if ( top >= bottom ) {
+			return false;
+		}
+
+		T entry = m_entries[ top & MASK ].load( std::memory_order_relaxed );
+		if ( !m_top.compare_exchange_strong( top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed ) ) {
+			return false;
+		}
+
+		*out_entry = entry;
+		return true;
+	}
+
+
+	bool IsEmpty() const {
+		return m_bottom.load( std::memory_order_relaxed ) <= m_top.load( std::memory_order_relaxed );
+	}
+
+
+private:
+	static const int64_t MASK = CAPACITY - 1;
+
+	alignas(64) std::atomic<int64_t> m_top;
+	alignas(64) std::atomic<int64_t> m_bottom;
+	alignas(64) std::atomic<T> m_entries[ CAPACITY ];
+};
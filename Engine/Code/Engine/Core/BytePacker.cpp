@@ -32,15 +32,40 @@ BytePacker::BytePacker( size_t bufferSize, void* buffer, eEndianness endianness
 }
 
 
+//----------------------------------------------------------------------------------------------------------------
+BytePacker::BytePacker( void* externalBuffer, size_t bufferSize, size_t writtenByteCount, eEndianness endianness /* = LITTLE_ENDIAN */, eBytePackerOptions options /* = 0 */, const BytePackerHeap_T* heap /* = nullptr */ ) 
+	: m_endianness( endianness )
+	, m_data( (byte_t*) externalBuffer )
+	, m_dataByteCount( bufferSize )
+	, m_writeHeadByteIndex( writtenByteCount )
+	, m_options( options & BYTEPACKER_SPILLS_TO_HEAP )
+	, m_heap( heap )
+{}
+
+
 //----------------------------------------------------------------------------------------------------------------
 BytePacker::~BytePacker() {
 	if ( CanManageMemory() ) {
-		delete[] m_data;
+		FreeData( m_data, m_dataByteCount );
 		m_data = nullptr;
 	}
 }
 
 
+//----------------------------------------------------------------------------------------------------------------
+void BytePacker::WrapBuffer( void* externalBuffer, size_t bufferSize, size_t writtenByteCount ) {
+	if ( CanManageMemory() ) {
+		FreeData( m_data, m_dataByteCount );
+	}
+
+	m_options = 0;
+	m_data = (byte_t*) externalBuffer;
+	m_dataByteCount = bufferSize;
+	m_writeHeadByteIndex = writtenByteCount;
+	m_readHeadByteIndex = 0;
+}
+
+
 //----------------------------------------------------------------------------------------------------------------
 void BytePacker::SetEndianness( eEndianness endianness ) {
 	
@@ -113,7 +138,17 @@ size_t BytePacker::ReadSize( size_t* out_size ) {
 bool BytePacker::WriteBytes( size_t byteCount, void const* data ) {
 
 	// if the data is within the max but greater than the currently allocated, allocate 
-	while ( m_writeHeadByteIndex + byteCount >= m_dataByteCount ) {
+	while ( m_writeHeadByteIndex + byteCount > m_dataByteCount ) {
+
+		// A wrapped buffer that may spill copies itself into an owned one on the first write that doesn't fit
+		if ( CanSpillToHeap() ) {
+			byte_t* external = m_data;
+			m_data = AllocateData( m_dataByteCount * 2 );
+			memcpy( m_data, external, m_writeHeadByteIndex );
+			m_dataByteCount *= 2;
+			m_options = BYTEPACKER_OWNS_MEMORY | BYTEPACKER_CAN_GROW;
+			continue;
+		}
 
 		// If we can't grow, then failed to write.
 		if (!CanGrow()) {
@@ -122,11 +157,10 @@ bool BytePacker::WriteBytes( size_t byteCount, void const* data ) {
 
 		byte_t* temp = m_data;
 
-		m_data = new byte_t[ m_dataByteCount * 2 ];
+		m_data = AllocateData( m_dataByteCount * 2 );
 		memcpy( m_data, temp, m_dataByteCount );
+		FreeData( temp, m_dataByteCount );
 		m_dataByteCount *= 2;
-
-		delete[] temp;
 	}
 
 	// Write the bytes
@@ -202,6 +236,16 @@ size_t BytePacker::ReadString( char* out_str, size_t maxByteSize ) {
 }
 
 
+//----------------------------------------------------------------------------------------------------------------
+size_t BytePacker::SkipBytes( size_t maxByteCount ) {
+	if ( maxByteCount > GetRemainingReadableByteCount() ) {
+		maxByteCount = GetRemainingReadableByteCount();
+	}
+	m_readHeadByteIndex += maxByteCount;
+	return maxByteCount;
+}
+
+
 //----------------------------------------------------------------------------------------------------------------
 void BytePacker::ResetReadHead() {
 	m_readHeadByteIndex = 0;
@@ -224,6 +268,31 @@ bool BytePacker::CanGrow() const {
 }
 
 
+//----------------------------------------------------------------------------------------------------------------
+bool BytePacker::CanSpillToHeap() const {
+	return !CanManageMemory() && ((m_options & BYTEPACKER_SPILLS_TO_HEAP) == BYTEPACKER_SPILLS_TO_HEAP);
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+byte_t* BytePacker::AllocateData( size_t byteCount ) const {
+	if ( m_heap != nullptr ) {
+		return (byte_t*) m_heap->allocate( byteCount );
+	}
+	return new byte_t[ byteCount ];
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void BytePacker::FreeData( byte_t* data, size_t byteCount ) const {
+	if ( m_heap != nullptr ) {
+		m_heap->free( data, byteCount );
+		return;
+	}
+	delete[] data;
+}
+
+
 //----------------------------------------------------------------------------------------------------------------
 bool BytePacker::CanManageMemory() const {
 	if ( (m_options & BYTEPACKER_OWNS_MEMORY) == BYTEPACKER_OWNS_MEMORY ) {
@@ -253,7 +322,13 @@ size_t BytePacker::GetRemainingWritableByteCount() const {
 
 //----------------------------------------------------------------------------------------------------------------
 size_t BytePacker::GetRemainingReadableByteCount() const {
-	return m_dataByteCount - m_readHeadByteIndex;
+	return m_writeHeadByteIndex - m_readHeadByteIndex;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+byte_t* BytePacker::GetReadHead() const {
+	return m_data + m_readHeadByteIndex;
 }
 
 
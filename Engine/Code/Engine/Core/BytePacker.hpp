@@ -7,27 +7,41 @@
 
 enum eBytePackerOptionBit : unsigned int {
 	BYTEPACKER_OWNS_MEMORY = BIT_FLAG(0),
-	BYTEPACKER_CAN_GROW = BIT_FLAG(1) 
+	BYTEPACKER_CAN_GROW = BIT_FLAG(1),
+	BYTEPACKER_SPILLS_TO_HEAP = BIT_FLAG(2)		// Wrapped buffers only: a write that doesn't fit moves to an owned, growing copy
 };
 
 typedef unsigned int eBytePackerOptions;
 typedef unsigned char byte_t;
 
 
+//----------------------------------------------------------------------------------------------------------------
+// Where a spilled buffer and everything it grows into comes from, for owners that keep their own allocation
+// stats. Without one it's new[] and delete[].
+struct BytePackerHeap_T {
+	void* (*allocate)( size_t byteCount );
+	void (*free)( void* memory, size_t byteCount );
+};
+
+
 //----------------------------------------------------------------------------------------------------------------
 class BytePacker {
 public:
 	BytePacker( eEndianness endianness = LITTLE_ENDIAN, eBytePackerOptions options = (BYTEPACKER_OWNS_MEMORY | BYTEPACKER_CAN_GROW) );
 	BytePacker( size_t bufferSize, eEndianness endianness = LITTLE_ENDIAN, eBytePackerOptions options = BYTEPACKER_OWNS_MEMORY );
 	BytePacker( size_t bufferSize, void* buffer, eEndianness endianness = LITTLE_ENDIAN, eBytePackerOptions options = 0 );
+	BytePacker( void* externalBuffer, size_t bufferSize, size_t writtenByteCount, eEndianness endianness = LITTLE_ENDIAN, eBytePackerOptions options = 0, const BytePackerHeap_T* heap = nullptr );	// Wraps, never frees
 	~BytePacker();
 
+	void WrapBuffer( void* externalBuffer, size_t bufferSize, size_t writtenByteCount );	// Points at someone else's memory, releasing our own, never grows
+
 	void SetEndianness( eEndianness endianness );
 	void SetReadableByteCount( size_t byteCount );
 
 	bool	WriteBytes( size_t byteCount, void const* data );
 	bool	WriteBytesAt( size_t byteCount, void const* data, size_t pos );
 	size_t	ReadBytes( void* out_data, size_t maxByteCount );
+	size_t	SkipBytes( size_t maxByteCount );					// Moves the read head without copying, returns bytes skipped
 	size_t	WriteSize( size_t size );							// returns bytes used
 	size_t	ReadSize( size_t* out_size );						// returns bytes read, fills out_size
 	bool	WriteString( char const* str );						// see notes for encoding
@@ -82,15 +96,20 @@ public:
 	eEndianness GetEndianness() const;
 	size_t GetWrittenByteCount() const;
 	size_t GetRemainingWritableByteCount() const;
-	size_t GetRemainingReadableByteCount() const;
+	size_t GetRemainingReadableByteCount() const;		// Written bytes past the read head, not the rest of the buffer; packet and snapshot reads are bounded by it
 	byte_t* GetBuffer() const;
+	byte_t* GetReadHead() const;
 
 
 private:
 	bool CanManageMemory() const;
 	bool CanGrow() const;
+	bool CanSpillToHeap() const;
+	byte_t* AllocateData( size_t byteCount ) const;
+	void FreeData( byte_t* data, size_t byteCount ) const;
 
 	eBytePackerOptions m_options = 0;
+	const BytePackerHeap_T* m_heap = nullptr;
 
 	byte_t* m_data = nullptr;
 	size_t m_dataByteCount = 0;
@@ -2,27 +2,66 @@
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Math/MathUtils.hpp"
 #include "Engine/DevConsole/DevConsole.hpp"
 #include "Engine/DevConsole/Command.hpp"
+#include "Engine/Profiler/Profiler.hpp"
 
 #include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
 #include <fstream>
 #include <ctime>
+#include <mutex>
 #include <time.h>
 
-const int STRINGF_STACK_LOCAL_TEMP_LENGTH = 2048;
+#define LOGGER_RECORD_INDEX_MASK ( LOGGER_RECORD_COUNT - 1 )
+static_assert( ( LOGGER_RECORD_COUNT & LOGGER_RECORD_INDEX_MASK ) == 0, "LOGGER_RECORD_COUNT has to be a power of two" );
 
+static_assert( sizeof( LogRecord_T ) == 512, "LogRecord_T is meant to be 512 bytes" );
 
-bool Logger::isRunning = false;
+// Each piece keeps its own terminator
+#define LOGGER_PART_TEXT_LENGTH ( LOGGER_RECORD_TEXT_SIZE - 1 )
+#define LOGGER_MAX_MESSAGE_LENGTH ( LOGGER_MAX_MESSAGE_PARTS * LOGGER_PART_TEXT_LENGTH )
+
+#define LOGGER_IDLE_SLEEP_MILLISECONDS 10
+#define LOGGER_OUTPUT_WINDOW_CHUNK 2000				// DebuggerPrintf cuts off at 2048
+#define LOGGER_TEST_MESSAGES_PER_THREAD 100000
+
+
+std::atomic<bool> Logger::isRunning( false );
 ThreadHandle Logger::threadHandle = nullptr;
 
 std::shared_mutex Logger::m_hooksLock;
 std::vector<LogHook> Logger::m_hooks;
-std::vector<std::string> Logger::m_tagFilter;
 bool Logger::m_isFilterBlacklist = true;
 std::fstream* Logger::recentLogFile = nullptr;
 std::fstream* Logger::timestampedLogFile = nullptr;
-ThreadSafeQueue<LogEntry> Logger::m_messageQueue;
+
+LogRecord_T Logger::m_records[LOGGER_RECORD_COUNT];
+std::atomic<uint64_t> Logger::m_writePosition( 0 );
+std::atomic<uint64_t> Logger::m_flushedPosition( 0 );
+uint64_t Logger::m_readPosition = 0;
+std::atomic<uint64_t> Logger::m_fullRingWaitCount( 0 );
+std::atomic<uint64_t> Logger::m_writtenByteCount( 0 );
+std::string Logger::m_batchText;
+std::string Logger::m_longText;
+
+std::shared_mutex Logger::m_tagsLock;
+std::unordered_map<std::string, LogTagID> Logger::m_tagIDs = {
+	{ "Default", LOG_TAG_DEFAULT },
+	{ "Warning", LOG_TAG_WARNING },
+	{ "Error", LOG_TAG_ERROR },
+	{ "Debug", LOG_TAG_DEBUG }
+};
+std::string Logger::m_tagNames[LOGGER_MAX_TAGS] = { "Default", "Warning", "Error", "Debug" };
+std::atomic<int> Logger::m_tagCount( NUM_BUILT_IN_LOG_TAGS );
+std::atomic<uint32_t> Logger::m_tagFilterBits[LOGGER_FILTER_WORDS] = {
+	{ 0xffffffff }, { 0xffffffff }, { 0xffffffff }, { 0xffffffff },
+	{ 0xffffffff }, { 0xffffffff }, { 0xffffffff }, { 0xffffffff }
+};
+static_assert( LOGGER_FILTER_WORDS == 8, "m_tagFilterBits has to start with every tag shown" );
 
 
 //----------------------------------------------------------------------------------------------------------------
@@ -51,6 +90,8 @@ void Logger::Startup() {
 	timestampedLogFile = new std::fstream();
 	timestampedLogFile->open( timeStamp.c_str(), std::ios::out );
 
+	m_batchText.reserve( LOGGER_BATCH_RECORDS * ( LOGGER_RECORD_TEXT_SIZE + 64 ) );
+	m_longText.reserve( LOGGER_MAX_MESSAGE_LENGTH + 1 );
 
 	isRunning = true;
 	threadHandle = CreateNewThread("Logger", LogWorker);
@@ -60,11 +101,7 @@ void Logger::Startup() {
 	CommandRegistration::RegisterCommand("log_remove_filter", RemoveTagFromFilter, "Removes a tag from the filter" );
 	CommandRegistration::RegisterCommand("log_hide_all", HideAllLogs, "Clears the log filter and sets it to whitelist mode" );
 	CommandRegistration::RegisterCommand("log_show_all", EnableAllLogs, "Clears the log filter and sets it to blacklist mode" );
-	CommandRegistration::RegisterCommand("log_test", LogTest, "Log stress test" );
-
-	AddHook(WriteToFile, recentLogFile);
-	AddHook(WriteToFile, timestampedLogFile);
-	AddHook(OutputToOutputWindow, nullptr);
+	CommandRegistration::RegisterCommand("log_test", LogTest, "[file threads] - Log stress test, reports messages per second" );
 }
 
 
@@ -76,132 +113,327 @@ void Logger::Shutdown() {
 
 
 //----------------------------------------------------------------------------------------------------------------
+// Takes whatever is in the ring, a batch at a time. Each slot is handed back as soon as it's read so writers
+// waiting on a full ring can go again while the batch is being written. The later records of a long message are
+// published before its first one, so once the first is ready they all are.
 void Logger::FlushMessages() {
-	LogEntry entry;
+	PROFILER_SCOPED_PUSH();
+
+	bool isRingEmpty = false;
+	while (!isRingEmpty) {
+		std::shared_lock<std::shared_mutex> hooksLock( m_hooksLock );
+
+		int batchCount = 0;
+		while (batchCount < LOGGER_BATCH_RECORDS) {
+			LogRecord_T& record = m_records[m_readPosition & LOGGER_RECORD_INDEX_MASK];
+			uint64_t lap = m_readPosition / LOGGER_RECORD_COUNT;
+			if (record.sequence.load( std::memory_order_acquire ) != ( lap * 2 ) + 1) {
+				isRingEmpty = true;
+				break;
+			}
 
-	while (m_messageQueue.Pop(&entry)) {
+			int partCount = record.partCount;
+			if (partCount > 0) {
+				LogEntry entry;
+				entry.tag = record.tag;
+				entry.tagName = GetTagName( record.tag );
+				entry.text = record.text;
+				entry.time = record.time;
+
+				if (partCount > 1) {
+					m_longText.clear();
+					for (int partIndex = 0; partIndex < partCount; partIndex++) {
+						m_longText.append( m_records[( m_readPosition + partIndex ) & LOGGER_RECORD_INDEX_MASK].text );
+					}
+					entry.text = m_longText.c_str();
+				}
 
-		// Do filter removes so we capture that console command
-		if (entry.tag == "filterremove") {
-			for (unsigned int i = 0; i < m_tagFilter.size(); i++) {
-				if (entry.text == m_tagFilter[i]) {
-					m_tagFilter[i] = m_tagFilter[m_tagFilter.size() - 1];
-					m_tagFilter.pop_back();
-					break;
+				AppendToBatch( entry );
+				for (unsigned int i = 0; i < m_hooks.size(); i++) {
+					m_hooks[i].callback(&entry, m_hooks[i].arguments);
 				}
 			}
+
+			int readCount = Max( partCount, 1 );
+			for (int partIndex = 0; partIndex < readCount; partIndex++) {
+				uint64_t partPosition = m_readPosition + partIndex;
+				m_records[partPosition & LOGGER_RECORD_INDEX_MASK].sequence.store( ( ( partPosition / LOGGER_RECORD_COUNT ) + 1 ) * 2, std::memory_order_release );
+			}
+			m_readPosition += readCount;
+			batchCount += readCount;
 		}
 
+		hooksLock.unlock();
+		WriteBatch();
+		m_flushedPosition.store( m_readPosition, std::memory_order_release );
+	}
+}
 
-		// Find if tag is in the filter
-		bool isTagInFilter = false;
-		for (unsigned int i = 0; i < m_tagFilter.size(); i++) {
-			if (entry.tag == m_tagFilter[i]) {
-				isTagInFilter = true;
+
+//----------------------------------------------------------------------------------------------------------------
+// Same format the log files always had
+void Logger::AppendToBatch( const LogEntry& entry ) {
+	char timeText[32];
+	int timeLength = snprintf( timeText, sizeof( timeText ), "[%g] ", entry.time );
+
+	m_batchText.append( timeText, timeLength );
+	m_batchText.append( entry.tagName );
+	m_batchText.append( ": " );
+	m_batchText.append( entry.text );
+	m_batchText.push_back( '\n' );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// One write per file per batch. The output window is given whole lines in chunks DebuggerPrintf can take.
+void Logger::WriteBatch() {
+	if (m_batchText.empty()) {
+		return;
+	}
+
+	if (recentLogFile != nullptr) {
+		recentLogFile->write( m_batchText.data(), m_batchText.size() );
+		recentLogFile->flush();
+	}
+	if (timestampedLogFile != nullptr) {
+		timestampedLogFile->write( m_batchText.data(), m_batchText.size() );
+		timestampedLogFile->flush();
+	}
+	m_writtenByteCount += m_batchText.size();
+
+	size_t chunkStart = 0;
+	while (chunkStart < m_batchText.size()) {
+		size_t chunkEnd = Min( chunkStart + LOGGER_OUTPUT_WINDOW_CHUNK, m_batchText.size() );
+		if (chunkEnd < m_batchText.size()) {
+			size_t lineEnd = m_batchText.rfind( '\n', chunkEnd - 1 );
+			if (lineEnd != std::string::npos && lineEnd >= chunkStart) {
+				chunkEnd = lineEnd + 1;
 			}
 		}
+		DebuggerPrintf( "%.*s", (int) ( chunkEnd - chunkStart ), m_batchText.data() + chunkStart );
+		chunkStart = chunkEnd;
+	}
+
+	m_batchText.clear();
+}
 
-		// if it's a blacklist, we do not want to process if the tag was found.
-		// if it's a whitelist, we want to process only if it was found
-		if (isTagInFilter != m_isFilterBlacklist) {
-			for (unsigned int i = 0; i < m_hooks.size(); i++) {
-				m_hooks[i].callback(&entry, m_hooks[i].arguments);
+
+//----------------------------------------------------------------------------------------------------------------
+void Logger::Flush() {
+	uint64_t target = m_writePosition.load( std::memory_order_acquire );
+	while (isRunning && m_flushedPosition.load( std::memory_order_acquire ) < target) {
+		YieldThread();
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void Logger::LogFlushTest( const std::string& command ) {
+	Logger::Printf("LogFlushTest");
+	Flush();
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Claims partCount records in a row. A full ring makes the caller wait for the logger thread, unless there's no
+// logger thread to wait for, then nothing is claimed.
+bool Logger::ClaimRecords( int partCount, uint64_t* out_position ) {
+	uint64_t position = m_writePosition.load( std::memory_order_relaxed );
+	for (;;) {
+		int freeCount = 0;
+		bool isRingFull = false;
+		while (freeCount < partCount) {
+			uint64_t partPosition = position + freeCount;
+			uint64_t freeSequence = ( partPosition / LOGGER_RECORD_COUNT ) * 2;
+			uint64_t sequence = m_records[partPosition & LOGGER_RECORD_INDEX_MASK].sequence.load( std::memory_order_acquire );
+			if (sequence != freeSequence) {
+				isRingFull = ( sequence < freeSequence );
+				break;
 			}
+			freeCount++;
 		}
 
-		// Now add new filter so that we can capture the command that issued it
-		if (entry.tag == "filteradd") {
-			m_tagFilter.push_back(entry.text);
+		if (freeCount == partCount) {
+			if (m_writePosition.compare_exchange_weak( position, position + partCount, std::memory_order_relaxed )) {
+				*out_position = position;
+				return true;
+			}
+		}
+		else if (isRingFull) {
+			if (!isRunning) {
+				return false;
+			}
+			m_fullRingWaitCount++;
+			YieldThread();
+			position = m_writePosition.load( std::memory_order_relaxed );
+		}
+		else {
+			position = m_writePosition.load( std::memory_order_relaxed );
 		}
 	}
+}
 
+
+//----------------------------------------------------------------------------------------------------------------
+void Logger::PublishRecord( uint64_t position, LogTagID tag, int partCount ) {
+	LogRecord_T& record = m_records[position & LOGGER_RECORD_INDEX_MASK];
+	record.tag = tag;
+	record.partCount = (uint16_t) partCount;
+	record.time = ( g_masterClock != nullptr ) ? (float) g_masterClock->total.seconds : 0.f;
+	record.sequence.store( ( ( position / LOGGER_RECORD_COUNT ) * 2 ) + 1, std::memory_order_release );
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
-void Logger::LogFlushTest( const std::string& command ) {
-	Logger::Printf("LogFlushTest");
-	FlushMessages();
+// Claims the next record and formats straight into it. Messages that don't fit give that record up and are
+// formatted again into a thread local buffer, then copied over as many records as they need. A message that can't
+// be claimed because the logger thread is gone is lost.
+void Logger::PushRecord( LogTagID tag, const char* text, va_list variableArgumentList ) {
+	va_list longArgumentList;
+	va_copy( longArgumentList, variableArgumentList );
+
+	uint64_t position = 0;
+	if (!ClaimRecords( 1, &position )) {
+		va_end( longArgumentList );
+		return;
+	}
+
+	LogRecord_T& record = m_records[position & LOGGER_RECORD_INDEX_MASK];
+	int length = vsnprintf( record.text, LOGGER_RECORD_TEXT_SIZE, text, variableArgumentList );
+	record.text[ LOGGER_RECORD_TEXT_SIZE - 1 ] = '\0';
+	if (length < LOGGER_RECORD_TEXT_SIZE) {
+		PublishRecord( position, tag, 1 );
+		va_end( longArgumentList );
+		return;
+	}
+	PublishRecord( position, tag, 0 );
+
+	thread_local char t_longText[ LOGGER_MAX_MESSAGE_LENGTH + 1 ];
+	length = vsnprintf( t_longText, sizeof( t_longText ), text, longArgumentList );
+	va_end( longArgumentList );
+	length = ClampInt( length, 0, LOGGER_MAX_MESSAGE_LENGTH );
+
+	int partCount = Max( ( length + LOGGER_PART_TEXT_LENGTH - 1 ) / LOGGER_PART_TEXT_LENGTH, 1 );
+	if (!ClaimRecords( partCount, &position )) {
+		return;
+	}
+
+	// First record last, it's what the logger thread waits on
+	for (int partIndex = partCount - 1; partIndex >= 0; partIndex--) {
+		LogRecord_T& part = m_records[( position + partIndex ) & LOGGER_RECORD_INDEX_MASK];
+		int partStart = partIndex * LOGGER_PART_TEXT_LENGTH;
+		int partLength = Min( length - partStart, LOGGER_PART_TEXT_LENGTH );
+		memcpy( part.text, t_longText + partStart, partLength );
+		part.text[partLength] = '\0';
+		PublishRecord( position + partIndex, tag, ( partIndex == 0 ) ? partCount : 0 );
+	}
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
 void Logger::Printf( const char* text, ... ) {
-	// Copied from StringUtils
-	char textLiteral[ STRINGF_STACK_LOCAL_TEMP_LENGTH ];
+	if (!IsTagEnabled( LOG_TAG_DEFAULT )) {
+		return;
+	}
 
 	va_list variableArgumentList;
 	va_start( variableArgumentList, text );
-	vsnprintf_s( textLiteral, STRINGF_STACK_LOCAL_TEMP_LENGTH, _TRUNCATE, text, variableArgumentList );	
+	PushRecord( LOG_TAG_DEFAULT, text, variableArgumentList );
 	va_end( variableArgumentList );
+}
 
-	textLiteral[ STRINGF_STACK_LOCAL_TEMP_LENGTH - 1 ] = '\0'; // In case vsnprintf overran (doesn't auto-terminate)
 
-	LogEntry newEntry;
-	newEntry.tag = "Default";
-	newEntry.text = textLiteral;
-	newEntry.time = g_masterClock->total.seconds;
-	m_messageQueue.Push(newEntry);
+//----------------------------------------------------------------------------------------------------------------
+void Logger::PrintTaggedf( LogTagID tag, const char* text, ... ) {
+	if (!IsTagEnabled( tag )) {
+		return;
+	}
+
+	va_list variableArgumentList;
+	va_start( variableArgumentList, text );
+	PushRecord( tag, text, variableArgumentList );
+	va_end( variableArgumentList );
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
+// For tags that aren't known until run time, everything else should use LOG_TAGGEDF
 void Logger::PrintTaggedf( const char* tag, const char* text, ... ) {
-	// Copied from StringUtils
-	char textLiteral[ STRINGF_STACK_LOCAL_TEMP_LENGTH ];
+	LogTagID tagID = InternTag( tag );
+	if (!IsTagEnabled( tagID )) {
+		return;
+	}
 
 	va_list variableArgumentList;
 	va_start( variableArgumentList, text );
-	vsnprintf_s( textLiteral, STRINGF_STACK_LOCAL_TEMP_LENGTH, _TRUNCATE, text, variableArgumentList );	
+	PushRecord( tagID, text, variableArgumentList );
 	va_end( variableArgumentList );
-
-	textLiteral[ STRINGF_STACK_LOCAL_TEMP_LENGTH - 1 ] = '\0'; // In case vsnprintf overran (doesn't auto-terminate)
-
-	LogEntry newEntry;
-	newEntry.tag = tag;
-	newEntry.text = textLiteral;
-	newEntry.time = g_masterClock->total.seconds;
-	m_messageQueue.Push(newEntry);
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
 void Logger::Warningf( const char* text, ... ) {
-	// Copied from StringUtils
-	char textLiteral[ STRINGF_STACK_LOCAL_TEMP_LENGTH ];
+	if (!IsTagEnabled( LOG_TAG_WARNING )) {
+		return;
+	}
 
 	va_list variableArgumentList;
 	va_start( variableArgumentList, text );
-	vsnprintf_s( textLiteral, STRINGF_STACK_LOCAL_TEMP_LENGTH, _TRUNCATE, text, variableArgumentList );	
+	PushRecord( LOG_TAG_WARNING, text, variableArgumentList );
 	va_end( variableArgumentList );
-
-	textLiteral[ STRINGF_STACK_LOCAL_TEMP_LENGTH - 1 ] = '\0'; // In case vsnprintf overran (doesn't auto-terminate)
-
-	LogEntry newEntry;
-	newEntry.tag = "Warning";
-	newEntry.text = textLiteral;
-	newEntry.time = g_masterClock->total.seconds;
-	m_messageQueue.Push(newEntry);
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
 void Logger::Errorf( const char* text, ... ) {
-	// Copied from StringUtils
-	char textLiteral[ STRINGF_STACK_LOCAL_TEMP_LENGTH ];
+	if (!IsTagEnabled( LOG_TAG_ERROR )) {
+		return;
+	}
 
 	va_list variableArgumentList;
 	va_start( variableArgumentList, text );
-	vsnprintf_s( textLiteral, STRINGF_STACK_LOCAL_TEMP_LENGTH, _TRUNCATE, text, variableArgumentList );	
+	PushRecord( LOG_TAG_ERROR, text, variableArgumentList );
 	va_end( variableArgumentList );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Names are written before the count that makes them visible, so GetTagName never needs the lock
+LogTagID Logger::InternTag( const char* tagName ) {
+	{
+		std::shared_lock<std::shared_mutex> readLock( m_tagsLock );
+		std::unordered_map<std::string, LogTagID>::const_iterator found = m_tagIDs.find( tagName );
+		if (found != m_tagIDs.end()) {
+			return found->second;
+		}
+	}
+
+	std::unique_lock<std::shared_mutex> writeLock( m_tagsLock );
+	std::unordered_map<std::string, LogTagID>::const_iterator found = m_tagIDs.find( tagName );
+	if (found != m_tagIDs.end()) {
+		return found->second;
+	}
+
+	int tagCount = m_tagCount.load();
+	if (tagCount >= LOGGER_MAX_TAGS) {
+		return LOG_TAG_DEFAULT;
+	}
+
+	LogTagID tag = (LogTagID) tagCount;
+	m_tagNames[tag] = tagName;
+	m_tagIDs[tagName] = tag;
+	SetTagFiltered( tag, false );
+	m_tagCount.store( tagCount + 1, std::memory_order_release );
+	return tag;
+}
 
-	textLiteral[ STRINGF_STACK_LOCAL_TEMP_LENGTH - 1 ] = '\0'; // In case vsnprintf overran (doesn't auto-terminate)
 
-	LogEntry newEntry;
-	newEntry.tag = "Error";
-	newEntry.text = textLiteral;
-	newEntry.time = g_masterClock->total.seconds;
-	m_messageQueue.Push(newEntry);
+//----------------------------------------------------------------------------------------------------------------
+const char* Logger::GetTagName( LogTagID tag ) {
+	if (tag >= m_tagCount.load( std::memory_order_acquire )) {
+		return "?";
+	}
+	return m_tagNames[tag].c_str();
 }
 
 
@@ -209,9 +441,14 @@ void Logger::Errorf( const char* text, ... ) {
 void Logger::LogWorker( void* data ) {
 
 	while (isRunning) {
+		uint64_t readPosition = m_readPosition;
 		FlushMessages();
-		SleepThread( 30 );
+		if (readPosition == m_readPosition) {
+			SleepThread( LOGGER_IDLE_SLEEP_MILLISECONDS );
+		}
 	}
+
+	FlushMessages();
 }
 
 
@@ -235,21 +472,24 @@ void Logger::AddHook( logger_hook_cb hookCB, void* arguments ) {
 
 
 //----------------------------------------------------------------------------------------------------------------
-void Logger::WriteToFile( const LogEntry* entry, void* filePtr ) {
-	std::fstream* file = (std::fstream*) filePtr;
-	*file << "[" << entry->time << "] " << entry->tag << ": " << entry->text << std::endl;
-}
-
-
-//----------------------------------------------------------------------------------------------------------------
-void Logger::OutputToOutputWindow( const LogEntry* entry, void* arg ) {
-	DebuggerPrintf("%s: %s\n", entry->tag.c_str(), entry->text.c_str());
+// A filtered tag is hidden in blacklist mode and shown in whitelist mode, so new tags start out filtered by nothing
+void Logger::SetTagFiltered( LogTagID tag, bool isFiltered ) {
+	uint32_t bit = 1u << ( tag & 31 );
+	if (isFiltered != m_isFilterBlacklist) {
+		m_tagFilterBits[tag >> 5].fetch_or( bit, std::memory_order_relaxed );
+	}
+	else {
+		m_tagFilterBits[tag >> 5].fetch_and( ~bit, std::memory_order_relaxed );
+	}
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
 void Logger::SetTagFilterMode( bool isBlacklist ) {
 	m_isFilterBlacklist = isBlacklist;
+	for (int word = 0; word < LOGGER_FILTER_WORDS; word++) {
+		m_tagFilterBits[word].store( isBlacklist ? 0xffffffff : 0, std::memory_order_relaxed );
+	}
 }
 
 
@@ -257,7 +497,7 @@ void Logger::SetTagFilterMode( bool isBlacklist ) {
 void Logger::AddTagToFilter( const std::string& tag ) {
 	std::vector<std::string> tokens = SplitString(tag, ' ');
 	if (tokens.size() >= 2) {
-		PrintTaggedf("filteradd", tokens[1].c_str());
+		SetTagFiltered( InternTag( tokens[1].c_str() ), true );
 	}
 }
 
@@ -266,22 +506,20 @@ void Logger::AddTagToFilter( const std::string& tag ) {
 void Logger::RemoveTagFromFilter( const std::string& tag ) {
 	std::vector<std::string> tokens = SplitString(tag, ' ');
 	if (tokens.size() >= 2) {
-		PrintTaggedf("filterremove", tokens[1].c_str());
+		SetTagFiltered( InternTag( tokens[1].c_str() ), false );
 	}
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
 void Logger::HideAllLogs( const std::string& command ) {
-	m_isFilterBlacklist = false;
-	m_tagFilter.clear();
+	SetTagFilterMode( false );
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
 void Logger::EnableAllLogs( const std::string& command ) {
-	m_isFilterBlacklist = true;
-	m_tagFilter.clear();
+	SetTagFilterMode( true );
 }
 
 
@@ -290,36 +528,71 @@ void Logger::LogTestWorker( void* logTestArgs ) {
 
 	LogTestData* data = (LogTestData*) logTestArgs;
 
-	std::fstream file;
-	file.open( data->fileName, std::ios::in );
+	if (data->fileName != nullptr) {
+		std::fstream file;
+		file.open( data->fileName, std::ios::in );
 
-	std::string line;
-	unsigned int lineCount = 0;
-	while(std::getline(file, line)) {
-		PrintTaggedf("LogTest", "[%u:%u] %s", data->threadCount, lineCount, line.c_str());
-		lineCount++;
+		std::string line;
+		unsigned int lineCount = 0;
+		while(std::getline(file, line)) {
+			LOG_TAGGEDF("LogTest", "[%u:%u] %s", data->threadCount, lineCount, line.c_str());
+			lineCount++;
+		}
+		data->messageCount = lineCount;
+	}
+	else {
+		for (unsigned int lineCount = 0; lineCount < data->messageCount; lineCount++) {
+			LOG_TAGGEDF("LogTest", "[%u:%u] Net spam from a made up connection %u, seq %u", data->threadCount, lineCount, lineCount & 31, lineCount * 7);
+		}
 	}
-
-	delete data;
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
+// log_test <file> <threads> logs every line of the file from each thread, plain log_test makes up the lines on four
+// threads. The time runs until the last message is in the files.
 void Logger::LogTest( const std::string& command ) {
 
 	std::vector<std::string> commandTokens = SplitString(command, ' ');
-	std::vector<ThreadHandle> handles;
+	int threadCount = 4;
+	const char* fileName = nullptr;
 	if (commandTokens.size() >= 3) {
-		int threadCount = stoi(commandTokens[2]);
-		for (int i = 0; i < threadCount; i++) {
-			LogTestData* data = new LogTestData();
-			data->fileName = commandTokens[1].c_str();
-			data->threadCount = i;
-			handles.push_back( CreateNewThread( "test", LogTestWorker, data ) );
-		}
+		threadCount = stoi(commandTokens[2]);
+		fileName = commandTokens[1].c_str();
+	}
+
+	uint64_t waitsBefore = m_fullRingWaitCount.load();
+	uint64_t bytesBefore = m_writtenByteCount.load();
+	uint64_t startHPC = GetPerformanceCount();
+
+	std::vector<ThreadHandle> handles;
+	std::vector<LogTestData*> testData;
+	for (int i = 0; i < threadCount; i++) {
+		LogTestData* data = new LogTestData();
+		data->fileName = fileName;
+		data->threadCount = i;
+		data->messageCount = LOGGER_TEST_MESSAGES_PER_THREAD;
+		testData.push_back( data );
+		handles.push_back( CreateNewThread( "test", LogTestWorker, data ) );
 	}
 
+	unsigned int messageCount = 0;
 	for (unsigned int i = 0; i < handles.size(); i++) {
 		JoinThread( handles[i] );
+		messageCount += testData[i]->messageCount;
+		delete testData[i];
 	}
-}
\ No newline at end of file
+	uint64_t loggedHPC = GetPerformanceCount();
+	Flush();
+	uint64_t writtenHPC = GetPerformanceCount();
+
+	double loggedSeconds = PerformanceCountToSeconds( loggedHPC - startHPC );
+	double writtenSeconds = PerformanceCountToSeconds( writtenHPC - startHPC );
+	uint64_t bytesAfter = m_writtenByteCount.load();
+	double megabytes = (double) ( bytesAfter - bytesBefore ) / ( 1024.0 * 1024.0 );
+
+	DevConsole::Printf( "log_test: %u messages on %d threads", messageCount, threadCount );
+	DevConsole::Printf( "  logged in  %.3f s, %.0f messages per second", loggedSeconds, (double) messageCount / Max( loggedSeconds, 0.000001 ) );
+	DevConsole::Printf( "  written in %.3f s, %.0f messages per second, %.1f MB/s to each log file", writtenSeconds, (double) messageCount / Max( writtenSeconds, 0.000001 ), megabytes / Max( writtenSeconds, 0.000001 ) );
+	DevConsole::Printf( "  %llu waits on a full ring", m_fullRingWaitCount.load() - waitsBefore );
+}
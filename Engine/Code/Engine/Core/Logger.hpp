@@ -1,13 +1,54 @@
 #pragma once
 #include "Engine/Async/Threads.hpp"
-#include "Engine/Async/ThreadSafeQueue.hpp"
 
+#include <atomic>
+#include <fstream>
 #include <shared_mutex>
+#include <stdarg.h>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Tags are interned to small IDs, and whether one is shown is a bit checked before anything is formatted
+typedef uint16_t LogTagID;
+
+#define LOGGER_MAX_TAGS 256
+#define LOGGER_FILTER_WORDS ( LOGGER_MAX_TAGS / 32 )
+#define LOGGER_RECORD_COUNT 4096					// Power of two, 512 bytes each
+#define LOGGER_RECORD_TEXT_SIZE 496					// Longer messages span several records
+#define LOGGER_MAX_MESSAGE_PARTS 8					// Most records one message spans, past that it's cut off
+#define LOGGER_BATCH_RECORDS 1024					// Most records the writer takes before writing them out
+
+enum eLogTag : LogTagID {
+	LOG_TAG_DEFAULT,
+	LOG_TAG_WARNING,
+	LOG_TAG_ERROR,
+	LOG_TAG_DEBUG,
+	NUM_BUILT_IN_LOG_TAGS
+};
+
+
+//----------------------------------------------------------------------------------------------------------------
+// A message already formatted at the call site. sequence says whose turn the slot is: even when it's free for a
+// writer, odd once the message is in and waiting for the logger thread. A message too long for one record is
+// split over partCount records in a row, each piece null terminated.
+struct LogRecord_T {
+	std::atomic<uint64_t> sequence;
+	float time;
+	LogTagID tag;
+	uint16_t partCount;			// On the first record of a message. 0 for a record given up by a message that didn't fit.
+	char text[LOGGER_RECORD_TEXT_SIZE];
+};
 
 
+// What hooks are given, only valid during the call
 struct LogEntry {
-	std::string tag;
-	std::string text;
+	LogTagID tag;
+	const char* tagName;
+	const char* text;
 	float time;
 };
 
@@ -22,11 +63,16 @@ struct LogHook {
 
 
 struct LogTestData {
-	const char* fileName;
+	const char* fileName;			// Lines of this file are logged, or made up ones when it's nullptr
 	unsigned int threadCount;
+	unsigned int messageCount;
 };
 
 
+//----------------------------------------------------------------------------------------------------------------
+// Any number of threads log into one lock free ring of fixed size records; the logger thread takes them out in
+// batches, calls the hooks and writes the batch to the log files and output window in one go. A thread only waits
+// when the ring is full.
 class Logger {
 
 public:
@@ -40,15 +86,28 @@ public:
 	static void HideAllLogs( const std::string& command );
 	static void EnableAllLogs( const std::string& command );
 
+	// Same name, same ID, from any thread. Takes a lock the first time a name is seen, so call sites keep the result;
+	// LOG_TAGGEDF does that for you.
+	static LogTagID InternTag( const char* tagName );
+	static const char* GetTagName( LogTagID tag );
+
+	static bool IsTagEnabled( LogTagID tag ) {
+		return ( ( m_tagFilterBits[tag >> 5].load( std::memory_order_relaxed ) >> ( tag & 31 ) ) & 1 ) != 0;
+	}
+
 	static void Printf( const char* text, ... );
+	static void PrintTaggedf( LogTagID tag, const char* text, ... );
 	static void PrintTaggedf( const char* tag, const char* text, ... );
 	static void Warningf( const char* text, ... );
 	static void Errorf( const char* text, ... );
 
+	// Returns once everything logged before the call has been written out
+	static void Flush();
+
 	static void LogTest( const std::string& command );
 	static void LogFlushTest( const std::string& command );
 
-	static bool isRunning;
+	static std::atomic<bool> isRunning;
 	static ThreadHandle threadHandle;
 
 
@@ -56,17 +115,45 @@ private:
 	static void LogWorker( void* data );
 	static void FlushMessages();
 	static void StopThread();
-	static void WriteToFile( const LogEntry* entry, void* filePtr );
-	static void OutputToOutputWindow( const LogEntry* entry, void* arg );
+	static void PushRecord( LogTagID tag, const char* text, va_list variableArgumentList );
+	static bool ClaimRecords( int partCount, uint64_t* out_position );
+	static void PublishRecord( uint64_t position, LogTagID tag, int partCount );
+	static void SetTagFiltered( LogTagID tag, bool isFiltered );
+	static void AppendToBatch( const LogEntry& entry );
+	static void WriteBatch();
 
 	static void LogTestWorker( void* logTestArgs );
 
 	static std::shared_mutex m_hooksLock;
 	static std::vector<LogHook> m_hooks;
-	static ThreadSafeQueue<LogEntry> m_messageQueue;
-	static std::vector<std::string> m_tagFilter;
 	static bool m_isFilterBlacklist;
 	static std::fstream* recentLogFile;
 	static std::fstream* timestampedLogFile;
 
-};
\ No newline at end of file
+	static LogRecord_T m_records[LOGGER_RECORD_COUNT];
+	static std::atomic<uint64_t> m_writePosition;		// Next record a thread will claim
+	static std::atomic<uint64_t> m_flushedPosition;		// Everything before this is written out
+	static uint64_t m_readPosition;						// Logger thread only
+	static std::atomic<uint64_t> m_fullRingWaitCount;
+	static std::atomic<uint64_t> m_writtenByteCount;
+	static std::string m_batchText;
+	static std::string m_longText;						// A message spanning several records, put back together
+
+	static std::shared_mutex m_tagsLock;
+	static std::unordered_map<std::string, LogTagID> m_tagIDs;
+	static std::string m_tagNames[LOGGER_MAX_TAGS];
+	static std::atomic<int> m_tagCount;
+	static std::atomic<uint32_t> m_tagFilterBits[LOGGER_FILTER_WORDS];		// Set bit means the tag is shown
+
+};
+
+
+//----------------------------------------------------------------------------------------------------------------
+// The tag is interned once per call site, and a filtered tag costs one bit test; the arguments aren't even evaluated
+#define LOG_TAGGEDF( tagName, ... ) \
+	do { \
+		static const LogTagID __log_tag = Logger::InternTag( tagName ); \
+		if ( Logger::IsTagEnabled( __log_tag ) ) { \
+			Logger::PrintTaggedf( __log_tag, __VA_ARGS__ ); \
+		} \
+	} while ( 0 )
@@ -5,6 +5,10 @@
 
 Transform const Transform::IDENTITY = Transform(nullptr, Vector3(0.f, 0.f, 0.f), Vector3(0.f, 0.f, 0.f), Vector3(1.f, 1.f, 1.f));
 
+// One counter for every transform rather than one each, so swapping a parent for another can't look like no change
+// just because the two happen to be on the same version. Only UpdateWorld touches it, same one thread rule.
+static uint32_t s_lastWorldVersion = 0;
+
 
 Transform::Transform( Transform* par, const Vector3& pos /* = Vector3() */, const Vector3& eul /* = Vector3() */, const Vector3& scl /* = Vector3() */) 
 	: position( pos )
@@ -13,33 +17,47 @@ Transform::Transform( Transform* par, const Vector3& pos /* = Vector3() */, cons
 	, parent( par )
 {}
 
+//----------------------------------------------------------------------------------------------------------------
+Matrix44 Transform::MakeLocalToParentMatrix( const Vector3& position, const Vector3& euler, const Vector3& scale ) {
+	Matrix44 srt = Matrix44::MakeRotationDegrees( euler );
+
+	srt.Ix *= scale.x;
+	srt.Iy *= scale.x;
+	srt.Iz *= scale.x;
+	srt.Jx *= scale.y;
+	srt.Jy *= scale.y;
+	srt.Jz *= scale.y;
+	srt.Kx *= scale.z;
+	srt.Ky *= scale.z;
+	srt.Kz *= scale.z;
+	srt.Tx = position.x;
+	srt.Ty = position.y;
+	srt.Tz = position.z;
+
+	return srt;
+}
+
+
 Matrix44 Transform::GetLocalToWorldMatrix() const {
-	Matrix44 scaleMat = Matrix44::MakeScale(scale);
-	Matrix44 rotMat = Matrix44::MakeRotationDegrees(euler);
-	Matrix44 transMat = Matrix44::MakeTranslation(position);
+	if ( IsWorldCurrent() ) {
+		return m_world.localToWorld;
+	}
 
-	transMat.Append(rotMat);
-	transMat.Append(scaleMat);
+	Matrix44 localToParent = MakeLocalToParentMatrix( position, euler, scale );
 	if (parent != nullptr) {
 		Matrix44 parentModel = parent->GetLocalToWorldMatrix();
-		parentModel.Append(transMat);
+		parentModel.Append(localToParent);
 		return parentModel;
 	}
 	else {
-		return transMat;
+		return localToParent;
 	}
 	
 }
 
 
 Matrix44 Transform::GetLocalToParentMatrix() const {
-	Matrix44 scaleMat = Matrix44::MakeScale(scale);
-	Matrix44 rotMat = Matrix44::MakeRotationDegrees(euler);
-	Matrix44 transMat = Matrix44::MakeTranslation(position);
-
-	transMat.Append(rotMat);
-	transMat.Append(scaleMat);
-	return transMat;
+	return MakeLocalToParentMatrix( position, euler, scale );
 }
 
 
@@ -60,24 +78,113 @@ Vector3 Transform::GetWorldLocation() const {
 }
 
 Vector3 Transform::GetWorldForward() const {
+	if ( IsWorldCurrent() ) {
+		return m_world.forward;
+	}
 	return GetLocalToWorldMatrix().GetForward();
 }
 
 Vector3 Transform::GetWorldUp() const {
+	if ( IsWorldCurrent() ) {
+		return m_world.up;
+	}
 	return GetLocalToWorldMatrix().GetUp();
 }
 
 Vector3 Transform::GetWorldRight() const {
+	if ( IsWorldCurrent() ) {
+		return m_world.right;
+	}
 	return GetLocalToWorldMatrix().GetRight();
 }
 
+
+//----------------------------------------------------------------------------------------------------------------
+TransformWorld_T Transform::ComputeWorld() const {
+	if ( IsWorldCurrent() ) {
+		return m_world;
+	}
+	return BuildWorld();
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+TransformWorld_T Transform::BuildWorld() const {
+	TransformWorld_T world;
+	world.localToWorld = GetLocalToWorldMatrix();
+	world.right = world.localToWorld.GetRight();
+	world.up = world.localToWorld.GetUp();
+	world.forward = world.localToWorld.GetForward();
+	return world;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Once the parent is up to date only this level needs checking, a stale grandparent would have changed its version
+bool Transform::UpdateWorld() {
+	if ( parent != nullptr ) {
+		parent->UpdateWorld();
+	}
+	if ( IsBuiltFromCurrentValues() ) {
+		return false;
+	}
+
+	m_world = BuildWorld();
+	m_builtPosition = position;
+	m_builtEuler = euler;
+	m_builtScale = scale;
+	m_builtParent = parent;
+	m_builtParentVersion = ( parent != nullptr ) ? parent->m_worldVersion : 0;
+
+	s_lastWorldVersion++;
+	if ( s_lastWorldVersion == 0 ) {
+		s_lastWorldVersion = 1;
+	}
+	m_worldVersion = s_lastWorldVersion;
+	return true;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Walks up the chain, nine float compares a level, which is still far cheaper than building the matrices
+bool Transform::IsWorldCurrent() const {
+	if ( !IsBuiltFromCurrentValues() ) {
+		return false;
+	}
+	return ( parent == nullptr ) || parent->IsWorldCurrent();
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+bool Transform::IsBuiltFromCurrentValues() const {
+	if ( m_worldVersion == 0 || parent != m_builtParent ) {
+		return false;
+	}
+	if ( parent != nullptr && parent->m_worldVersion != m_builtParentVersion ) {
+		return false;
+	}
+	return ( position == m_builtPosition ) && ( euler == m_builtEuler ) && ( scale == m_builtScale );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+uint32_t Transform::GetWorldVersion() const {
+	return m_worldVersion;
+}
+
+
 void Transform::Translate( const Vector3& translation ) {
 	position = position + translation;
 }
 
 
 void Transform::Rotate( const Vector3& rotationEuler ) {
-	Matrix44 srt = GetLocalToWorldMatrix();
+	Rotate( rotationEuler, GetLocalToWorldMatrix() );
+}
+
+
+void Transform::Rotate( const Vector3& rotationEuler, const Matrix44& localToWorld ) {
+	Matrix44 srt = localToWorld;
 	Matrix44 rot = Matrix44::MakeRotationDegrees(rotationEuler);
 	srt.Append(rot);
 	euler = srt.GetRotation();
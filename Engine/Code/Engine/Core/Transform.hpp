@@ -1,7 +1,27 @@
 #pragma once
 #include "Engine/Math/Matrix44.hpp"
 
+#include <stdint.h>
 
+
+//----------------------------------------------------------------------------------------------------------------
+// A transform's world matrix and basis. Transform caches one, and ComputeWorld hands out a copy, so build it again
+// after changing the transform.
+struct TransformWorld_T {
+	Matrix44 localToWorld;
+	Vector3 right;
+	Vector3 up;
+	Vector3 forward;
+};
+
+
+//----------------------------------------------------------------------------------------------------------------
+// position, euler and scale are public and written directly all over the games, so there's no setter to raise a
+// dirty flag from. The world matrix and basis are cached instead, along with the values they were built from and
+// the parent's version at the time. Only UpdateWorld writes the cache, from the one thread that owns the
+// transforms (TransformHierarchy does it for a whole scene once a frame), so the const getters never write
+// anything and any number of threads can read at once. A getter uses the cache while nothing up the chain has
+// changed since the last update, and builds the chain itself otherwise.
 class Transform {
 public:
 	Transform( Transform* parent = nullptr, const Vector3& pos = Vector3(), const Vector3& eul = Vector3(), const Vector3& scl = Vector3(1.f, 1.f, 1.f));
@@ -26,6 +46,20 @@ public:
 	void TurnToward( const Matrix44& current, const Matrix44& target, float maxDeltaDegrees );
 	void LookToward( const Vector3& forward, const Vector3& worldUp = Vector3::UP );
 
+	TransformWorld_T ComputeWorld() const;
+
+	// Rebuilds the cache if this transform or anything above it changed, parents first. Not thread safe, and
+	// returns whether this transform's cache was rebuilt.
+	bool UpdateWorld();
+	bool IsWorldCurrent() const;
+	uint32_t GetWorldVersion() const;				// Changes every time UpdateWorld rebuilds, 0 until the first
+
+	// Same as Rotate, for when the caller already has the local to world matrix
+	void Rotate( const Vector3& rotationEuler, const Matrix44& localToWorld );
+
+	// T * R * S without the three full matrix multiplies
+	static Matrix44 MakeLocalToParentMatrix( const Vector3& position, const Vector3& euler, const Vector3& scale );
+
 	static Transform const IDENTITY;
 public:
 	Vector3 position = Vector3();
@@ -33,4 +67,16 @@ public:
 	Vector3 scale = Vector3(1.f, 1.f, 1.f);
 
 	Transform* parent = nullptr;
-};
\ No newline at end of file
+
+private:
+	TransformWorld_T BuildWorld() const;
+	bool IsBuiltFromCurrentValues() const;
+
+	TransformWorld_T m_world;
+	Vector3 m_builtPosition;
+	Vector3 m_builtEuler;
+	Vector3 m_builtScale;
+	const Transform* m_builtParent = nullptr;
+	uint32_t m_builtParentVersion = 0;
+	uint32_t m_worldVersion = 0;
+};
@@ -0,0 +1,45 @@
+#include "Engine/Core/TransformHierarchy.hpp"
+#include "Engine/Profiler/Profiler.hpp"
+
+#include <algorithm>
+
+
+//----------------------------------------------------------------------------------------------------------------
+void TransformHierarchy::Add( Transform* transform ) {
+	m_transforms.push_back( transform );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void TransformHierarchy::Remove( Transform* transform ) {
+	std::vector<Transform*>::iterator searchResult = std::find( m_transforms.begin(), m_transforms.end(), transform );
+	if ( searchResult != m_transforms.end() ) {
+		*searchResult = m_transforms.back();
+		m_transforms.pop_back();
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void TransformHierarchy::Clear() {
+	m_transforms.clear();
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int TransformHierarchy::UpdateWorlds() {
+	PROFILER_SCOPED_PUSH();
+	int rebuiltCount = 0;
+	for ( Transform* transform : m_transforms ) {
+		if ( transform->UpdateWorld() ) {
+			rebuiltCount++;
+		}
+	}
+	return rebuiltCount;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int TransformHierarchy::GetTransformCount() const {
+	return (int) m_transforms.size();
+}
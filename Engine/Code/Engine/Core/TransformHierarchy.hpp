@@ -0,0 +1,28 @@
+#pragma once
+#include "Engine/Core/Transform.hpp"
+
+#include <vector>
+
+
+//----------------------------------------------------------------------------------------------------------------
+// The once a frame pass that keeps every Transform's cached world matrix current, so reads for the rest of the
+// frame (culling, particles, jobs) are just a check and a copy. Run it from the thread that owns the transforms,
+// after gameplay has moved things and before anything reads them.
+//
+// Order doesn't matter for correctness, UpdateWorld brings a transform's parents up to date first, including ones
+// that were never added here. A parent that's already current only costs the check.
+class TransformHierarchy {
+
+public:
+	void Add( Transform* transform );
+	void Remove( Transform* transform );
+	void Clear();
+
+	// Returns how many world matrices were rebuilt
+	int UpdateWorlds();
+
+	int GetTransformCount() const;
+
+private:
+	std::vector<Transform*> m_transforms;
+};
@@ -16,8 +16,18 @@ const VertexAttribute Vertex3D_Lit::s_attributes[] {
 
 };
 
+const VertexAttribute Vertex3D_LitTiled::s_attributes[] {
+	VertexAttribute( "POSITION", RENDER_DATA_FLOAT, 3, false, offsetof(Vertex3D_LitTiled, position), sizeof(Vertex3D_LitTiled)),
+	VertexAttribute( "COLOR", RENDER_DATA_UNSIGNED_BYTE, 4, true, offsetof(Vertex3D_LitTiled, color), sizeof(Vertex3D_LitTiled)),
+	VertexAttribute( "UV", RENDER_DATA_FLOAT, 2, false, offsetof(Vertex3D_LitTiled, uv), sizeof(Vertex3D_LitTiled)),
+	VertexAttribute( "NORMAL", RENDER_DATA_FLOAT, 3, false, offsetof(Vertex3D_LitTiled, normal), sizeof(Vertex3D_LitTiled)),
+	VertexAttribute( "TANGENT", RENDER_DATA_FLOAT, 3, false, offsetof(Vertex3D_LitTiled, tangent), sizeof(Vertex3D_LitTiled)),
+	VertexAttribute( "ATLAS_BOUNDS", RENDER_DATA_FLOAT, 4, false, offsetof(Vertex3D_LitTiled, atlasBounds), sizeof(Vertex3D_LitTiled))
+};
+
 const VertexLayout Vertex3D_PCU::LAYOUT = VertexLayout(sizeof(Vertex3D_PCU), Vertex3D_PCU::s_attributes, 3);
 const VertexLayout Vertex3D_Lit::LAYOUT = VertexLayout(sizeof(Vertex3D_Lit), Vertex3D_Lit::s_attributes, 5);
+const VertexLayout Vertex3D_LitTiled::LAYOUT = VertexLayout(sizeof(Vertex3D_LitTiled), Vertex3D_LitTiled::s_attributes, Vertex3D_LitTiled::NUM_ATTRIBUTES);
 
 
 VertexLayout::VertexLayout( unsigned int vertStride, const VertexAttribute attributes[], int numAttributes ) {
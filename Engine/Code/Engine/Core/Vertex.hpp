@@ -2,6 +2,7 @@
 #include "Engine/Core/Rgba.hpp"
 #include "Engine/Math/Vector2.hpp"
 #include "Engine/Math/Vector3.hpp"
+#include "Engine/Math/Vector4.hpp"
 #include <string>
 #include <vector>
 
@@ -107,6 +108,32 @@ struct Vertex3D_Lit {
 	static const int NUM_ATTRIBUTES = 5;
 	static const VertexLayout LAYOUT;
 };
+
+
+// Lit, for faces that repeat one sprite of an atlas across several tiles. uv counts tiles instead of being a texture
+// coordinate, and the shader wraps it into atlasBounds (mins.x, mins.y, maxs.x, maxs.y).
+struct Vertex3D_LitTiled {
+	Vector3 position;
+	Rgba	color;
+	Vector2 uv;
+	Vector3 normal;
+	Vector3 tangent;
+	Vector4 atlasBounds;
+
+	Vertex3D_LitTiled() {}
+	Vertex3D_LitTiled( const Vector3& pos, const Rgba& col, const Vector2& u, const Vector3& norm, const Vector3& tang, const Vector4& bounds ) {
+		position = pos;
+		color = col;
+		uv = u;
+		normal = norm;
+		tangent = tang;
+		atlasBounds = bounds;
+	}
+
+	static const VertexAttribute s_attributes[];
+	static const int NUM_ATTRIBUTES = 6;
+	static const VertexLayout LAYOUT;
+};
 /*
 
 
@@ -333,7 +333,7 @@ void DevConsole::Printf( const char* format, ... ) {
 	textLiteral[ STRINGF_STACK_LOCAL_TEMP_LENGTH - 1 ] = '\0'; // In case vsnprintf overran (doesn't auto-terminate)
 
 	//m_instance->AddMessage(textLiteral, Rgba());
-	Logger::PrintTaggedf("Debug", "%s", textLiteral );
+	Logger::PrintTaggedf( LOG_TAG_DEBUG, "%s", textLiteral );
 }
 
 
@@ -349,7 +349,7 @@ void DevConsole::Printf( const Rgba& color, const char* format, ... ) {
 	textLiteral[ STRINGF_STACK_LOCAL_TEMP_LENGTH - 1 ] = '\0'; // In case vsnprintf overran (doesn't auto-terminate)
 
 	//m_instance->AddMessage(textLiteral, color);
-	Logger::PrintTaggedf("Debug", "%s", textLiteral );
+	Logger::PrintTaggedf( LOG_TAG_DEBUG, "%s", textLiteral );
 
 }
 
@@ -380,7 +380,7 @@ void DevConsole::Clear( const std::string& command ) {
 
 //----------------------------------------------------------------------------------------------------------------
 void DevConsole::ProcessLoggerMessages( const LogEntry* entry, void* args ) {
-	if (entry->tag == "Debug") {
-		m_instance->AddMessage(entry->text.c_str(), Rgba());
+	if (entry->tag == LOG_TAG_DEBUG) {
+		m_instance->AddMessage(entry->text, Rgba());
 	}
 }
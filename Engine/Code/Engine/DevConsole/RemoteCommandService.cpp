@@ -195,7 +195,7 @@ void RemoteCommandService::ProcessFrameAsHost() {
 					DevConsole::Printf("[%s]: %s", m_remoteClientConnections[index]->address.to_string().c_str(), message );
 				}
 				
-				Logger::PrintTaggedf("RCS", "size: %u; should echo: %u; message: %s", messageSize, isEcho, message);
+				LOG_TAGGEDF("RCS", "size: %u; should echo: %u; message: %s", messageSize, isEcho, message);
 
 			} else {
 				// DisconnectClient( index );
@@ -234,7 +234,7 @@ void RemoteCommandService::ProcessFrameAsClient() {
 				DevConsole::Printf("[%s]: %s", m_remoteServerSocket.address.to_string().c_str(), message );
 			}
 
-			Logger::PrintTaggedf("RCS", "size: %u; should echo: %u; message: %s", messageSize, isEcho, message);
+			LOG_TAGGEDF("RCS", "size: %u; should echo: %u; message: %s", messageSize, isEcho, message);
 
 		} else {
 			//DisconnectAll();
@@ -267,7 +267,7 @@ void RemoteCommandService::ProcessClientAsHost( unsigned int clientIndex ) {
 			Command commandMinusRC( commandStringReduced );
 			CommandRegistration::RunCommand( commandMinusRC );
 
-			Logger::PrintTaggedf("RCS", "size: %u; should echo: %u; message: %s", messageSize, shouldEcho, message);
+			LOG_TAGGEDF("RCS", "size: %u; should echo: %u; message: %s", messageSize, shouldEcho, message);
 		}
 	} else if ( bytesReceived == 0 ) {
 		DisconnectClient( clientIndex );
@@ -1,4 +1,7 @@
 #include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+#include <math.h>
 
 AABB3::AABB3() 
 	: mins(Vector3(1.f, 1.f, 1.f))
@@ -24,6 +27,86 @@ Vector3 AABB3::GetDimensions() const {
 }
 
 
+//----------------------------------------------------------------------------------------------------------------
+Vector3 AABB3::GetHalfExtents() const {
+	return Vector3( (maxs.x - mins.x) * 0.5f, (maxs.y - mins.y) * 0.5f, (maxs.z - mins.z) * 0.5f );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+float AABB3::GetSurfaceArea() const {
+	Vector3 dimensions = GetDimensions();
+	return 2.f * ( dimensions.x * dimensions.y + dimensions.y * dimensions.z + dimensions.z * dimensions.x );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+bool AABB3::IsValid() const {
+	return mins.x <= maxs.x && mins.y <= maxs.y && mins.z <= maxs.z;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void AABB3::StretchToIncludePoint( const Vector3& point ) {
+	if ( !IsValid() ) {
+		mins = point;
+		maxs = point;
+		return;
+	}
+
+	mins = Vector3( Min( mins.x, point.x ), Min( mins.y, point.y ), Min( mins.z, point.z ) );
+	maxs = Vector3( Max( maxs.x, point.x ), Max( maxs.y, point.y ), Max( maxs.z, point.z ) );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void AABB3::StretchToIncludeBox( const AABB3& other ) {
+	if ( !other.IsValid() ) {
+		return;
+	}
+	StretchToIncludePoint( other.mins );
+	StretchToIncludePoint( other.maxs );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void AABB3::AddPaddingToSides( float padding ) {
+	mins = mins - Vector3( padding, padding, padding );
+	maxs = maxs + Vector3( padding, padding, padding );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Arvo's method in center/extent form. The result is conservative for rotations, never smaller than the
+// transformed corners.
+AABB3 AABB3::GetTransformed( const Matrix44& transform ) const {
+	Vector3 center = transform.TransformPosition( GetCenter() );
+	Vector3 halfExtents = GetHalfExtents();
+
+	Vector3 newHalfExtents(
+		fabsf( transform.Ix ) * halfExtents.x + fabsf( transform.Jx ) * halfExtents.y + fabsf( transform.Kx ) * halfExtents.z,
+		fabsf( transform.Iy ) * halfExtents.x + fabsf( transform.Jy ) * halfExtents.y + fabsf( transform.Ky ) * halfExtents.z,
+		fabsf( transform.Iz ) * halfExtents.x + fabsf( transform.Jz ) * halfExtents.y + fabsf( transform.Kz ) * halfExtents.z
+	);
+
+	return AABB3( center - newHalfExtents, center + newHalfExtents );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+bool AABB3::Contains( const AABB3& other ) const {
+	return mins.x <= other.mins.x && mins.y <= other.mins.y && mins.z <= other.mins.z
+		&& maxs.x >= other.maxs.x && maxs.y >= other.maxs.y && maxs.z >= other.maxs.z;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+AABB3 AABB3::GetUnion( const AABB3& a, const AABB3& b ) {
+	return AABB3( Vector3( Min( a.mins.x, b.mins.x ), Min( a.mins.y, b.mins.y ), Min( a.mins.z, b.mins.z ) ),
+				  Vector3( Max( a.maxs.x, b.maxs.x ), Max( a.maxs.y, b.maxs.y ), Max( a.maxs.z, b.maxs.z ) ) );
+}
+
+
 bool AABB3::Contains( const Vector3& point ) const {
 	if (   mins.x <= point.x && mins.y <= point.y && mins.z <= point.z
 		&& maxs.x >= point.x && maxs.y >= point.y && maxs.z >= point.z) {
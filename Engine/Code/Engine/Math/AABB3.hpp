@@ -3,6 +3,7 @@
 #include "Engine/Math/Vector3.hpp"
 #include "Engine/Math/Ray.hpp"
 #include "Engine/Math/Plane.hpp"
+#include "Engine/Math/Matrix44.hpp"
 
 #include <vector>
 
@@ -14,8 +15,19 @@ public:
 
 	Vector3 GetCenter() const;
 	Vector3 GetDimensions() const;
+	Vector3 GetHalfExtents() const;
+	float GetSurfaceArea() const;
+	bool IsValid() const;										// The default box is inside out until it's stretched
+
+	void StretchToIncludePoint( const Vector3& point );
+	void StretchToIncludeBox( const AABB3& other );
+	void AddPaddingToSides( float padding );
+
+	// Box around this one after transform, using the absolute value of the rotation and scale to grow the extents
+	AABB3 GetTransformed( const Matrix44& transform ) const;
 
 	bool Contains( const Vector3& point ) const;
+	bool Contains( const AABB3& other ) const;
 	std::vector<RaycastHit3> DoesRayIntersect( const Ray3& ray ) const;
 	bool DoAABB3sOverlap( const AABB3& other ) const;
 
@@ -28,6 +40,8 @@ public:
 
 	Vector3 GetNearestPointOnSurface( const Vector3& outsidePoint );
 
+	static AABB3 GetUnion( const AABB3& a, const AABB3& b );
+
 public:
 	Vector3 mins;
 	Vector3 maxs;
@@ -0,0 +1,574 @@
+#include "Engine/Math/AABBTree.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/DevConsole/DevConsole.hpp"
+#include "Engine/DevConsole/Command.hpp"
+
+#include <algorithm>
+
+
+//----------------------------------------------------------------------------------------------------------------
+AABBTree::AABBTree( float margin /* = AABB_TREE_DEFAULT_MARGIN */ )
+	: m_margin( margin )
+{
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int AABBTree::AllocateNode() {
+	if ( m_freeList == AABB_TREE_NULL_NODE ) {
+		m_nodes.push_back( AABBTreeNode_T() );
+		m_nodes.back().height = 0;
+		return (int) m_nodes.size() - 1;
+	}
+
+	int nodeIndex = m_freeList;
+	m_freeList = m_nodes[nodeIndex].parent;
+	m_nodes[nodeIndex] = AABBTreeNode_T();
+	m_nodes[nodeIndex].height = 0;
+	return nodeIndex;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void AABBTree::FreeNode( int nodeIndex ) {
+	m_nodes[nodeIndex].parent = m_freeList;
+	m_nodes[nodeIndex].height = -1;
+	m_freeList = nodeIndex;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int AABBTree::CreateProxy( const AABB3& bounds, int userID ) {
+	int proxyID = AllocateNode();
+	AABBTreeNode_T& node = m_nodes[proxyID];
+	node.bounds = bounds;
+	node.fatBounds = bounds;
+	node.fatBounds.AddPaddingToSides( m_margin );
+	node.userID = userID;
+
+	InsertLeaf( proxyID );
+	m_proxyCount++;
+	return proxyID;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void AABBTree::DestroyProxy( int proxyID ) {
+	GUARANTEE_OR_DIE( proxyID >= 0 && proxyID < (int) m_nodes.size() && m_nodes[proxyID].IsLeaf() && m_nodes[proxyID].height == 0, "AABBTree::DestroyProxy given a node that isn't a proxy" );
+	RemoveLeaf( proxyID );
+	FreeNode( proxyID );
+	m_proxyCount--;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+bool AABBTree::MoveProxy( int proxyID, const AABB3& bounds ) {
+	AABBTreeNode_T& node = m_nodes[proxyID];
+	node.bounds = bounds;
+	if ( node.fatBounds.Contains( bounds ) ) {
+		return false;
+	}
+
+	RemoveLeaf( proxyID );
+	m_nodes[proxyID].fatBounds = bounds;
+	m_nodes[proxyID].fatBounds.AddPaddingToSides( m_margin );
+	InsertLeaf( proxyID );
+	return true;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void AABBTree::SetUserID( int proxyID, int userID ) {
+	m_nodes[proxyID].userID = userID;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int AABBTree::GetUserID( int proxyID ) const {
+	return m_nodes[proxyID].userID;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+const AABB3& AABBTree::GetFatBounds( int proxyID ) const {
+	return m_nodes[proxyID].fatBounds;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+const AABB3& AABBTree::GetBounds( int proxyID ) const {
+	return m_nodes[proxyID].bounds;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void AABBTree::Clear() {
+	m_nodes.clear();
+	m_root = AABB_TREE_NULL_NODE;
+	m_freeList = AABB_TREE_NULL_NODE;
+	m_proxyCount = 0;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int AABBTree::GetProxyCount() const {
+	return m_proxyCount;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int AABBTree::GetHeight() const {
+	if ( m_root == AABB_TREE_NULL_NODE ) {
+		return 0;
+	}
+	return m_nodes[m_root].height;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Walks down picking whichever child grows the least, and stops early when pairing with the current node is
+// cheaper than descending. Cost is surface area, the chance a random ray or frustum touches the box.
+void AABBTree::InsertLeaf( int leaf ) {
+	if ( m_root == AABB_TREE_NULL_NODE ) {
+		m_root = leaf;
+		m_nodes[leaf].parent = AABB_TREE_NULL_NODE;
+		return;
+	}
+
+	AABB3 leafBounds = m_nodes[leaf].fatBounds;
+	int index = m_root;
+	while ( !m_nodes[index].IsLeaf() ) {
+		const AABBTreeNode_T& node = m_nodes[index];
+		int left = node.left;
+		int right = node.right;
+
+		float area = node.fatBounds.GetSurfaceArea();
+		float combinedArea = AABB3::GetUnion( node.fatBounds, leafBounds ).GetSurfaceArea();
+
+		// Cost of making a new parent for this node and the leaf, and the cost every level below pays for the
+		// leaf being pushed further down
+		float cost = 2.f * combinedArea;
+		float inheritanceCost = 2.f * ( combinedArea - area );
+
+		float leftCost = AABB3::GetUnion( leafBounds, m_nodes[left].fatBounds ).GetSurfaceArea() + inheritanceCost;
+		if ( !m_nodes[left].IsLeaf() ) {
+			leftCost -= m_nodes[left].fatBounds.GetSurfaceArea();
+		}
+
+		float rightCost = AABB3::GetUnion( leafBounds, m_nodes[right].fatBounds ).GetSurfaceArea() + inheritanceCost;
+		if ( !m_nodes[right].IsLeaf() ) {
+			rightCost -= m_nodes[right].fatBounds.GetSurfaceArea();
+		}
+
+		if ( cost < leftCost && cost < rightCost ) {
+			break;
+		}
+
+		index = ( leftCost < rightCost ) ? left : right;
+	}
+
+	// AllocateNode can grow m_nodes, so nothing above holds a reference past this point
+	int sibling = index;
+	int oldParent = m_nodes[sibling].parent;
+	int newParent = AllocateNode();
+	m_nodes[newParent].parent = oldParent;
+	m_nodes[newParent].fatBounds = AABB3::GetUnion( leafBounds, m_nodes[sibling].fatBounds );
+	m_nodes[newParent].height = m_nodes[sibling].height + 1;
+	m_nodes[newParent].left = sibling;
+	m_nodes[newParent].right = leaf;
+	m_nodes[sibling].parent = newParent;
+	m_nodes[leaf].parent = newParent;
+
+	if ( oldParent == AABB_TREE_NULL_NODE ) {
+		m_root = newParent;
+	}
+	else if ( m_nodes[oldParent].left == sibling ) {
+		m_nodes[oldParent].left = newParent;
+	}
+	else {
+		m_nodes[oldParent].right = newParent;
+	}
+
+	RefitUpward( m_nodes[leaf].parent );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// The leaf's parent goes away and its sibling takes the parent's place
+void AABBTree::RemoveLeaf( int leaf ) {
+	if ( leaf == m_root ) {
+		m_root = AABB_TREE_NULL_NODE;
+		return;
+	}
+
+	int parent = m_nodes[leaf].parent;
+	int grandParent = m_nodes[parent].parent;
+	int sibling = ( m_nodes[parent].left == leaf ) ? m_nodes[parent].right : m_nodes[parent].left;
+
+	m_nodes[sibling].parent = grandParent;
+	FreeNode( parent );
+
+	if ( grandParent == AABB_TREE_NULL_NODE ) {
+		m_root = sibling;
+		return;
+	}
+
+	if ( m_nodes[grandParent].left == parent ) {
+		m_nodes[grandParent].left = sibling;
+	}
+	else {
+		m_nodes[grandParent].right = sibling;
+	}
+	RefitUpward( grandParent );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void AABBTree::RefitUpward( int nodeIndex ) {
+	while ( nodeIndex != AABB_TREE_NULL_NODE ) {
+		nodeIndex = Balance( nodeIndex );
+
+		AABBTreeNode_T& node = m_nodes[nodeIndex];
+		node.height = 1 + Max( m_nodes[node.left].height, m_nodes[node.right].height );
+		node.fatBounds = AABB3::GetUnion( m_nodes[node.left].fatBounds, m_nodes[node.right].fatBounds );
+		nodeIndex = node.parent;
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// If one child of A is more than one level taller than the other, rotates that child up into A's place. The
+// taller child keeps its own taller child and hands A the shorter one. Returns the index of the node now in A's
+// spot.
+int AABBTree::Balance( int indexA ) {
+	AABBTreeNode_T& nodeA = m_nodes[indexA];
+	if ( nodeA.IsLeaf() || nodeA.height < 2 ) {
+		return indexA;
+	}
+
+	int indexB = nodeA.left;
+	int indexC = nodeA.right;
+	int balance = m_nodes[indexC].height - m_nodes[indexB].height;
+
+	// Rotate C up
+	if ( balance > 1 ) {
+		AABBTreeNode_T& nodeB = m_nodes[indexB];
+		AABBTreeNode_T& nodeC = m_nodes[indexC];
+		int indexF = nodeC.left;
+		int indexG = nodeC.right;
+		AABBTreeNode_T& nodeF = m_nodes[indexF];
+		AABBTreeNode_T& nodeG = m_nodes[indexG];
+
+		nodeC.left = indexA;
+		nodeC.parent = nodeA.parent;
+		nodeA.parent = indexC;
+
+		if ( nodeC.parent == AABB_TREE_NULL_NODE ) {
+			m_root = indexC;
+		}
+		else if ( m_nodes[nodeC.parent].left == indexA ) {
+			m_nodes[nodeC.parent].left = indexC;
+		}
+		else {
+			m_nodes[nodeC.parent].right = indexC;
+		}
+
+		if ( nodeF.height > nodeG.height ) {
+			nodeC.right = indexF;
+			nodeA.right = indexG;
+			nodeG.parent = indexA;
+			nodeA.fatBounds = AABB3::GetUnion( nodeB.fatBounds, nodeG.fatBounds );
+			nodeC.fatBounds = AABB3::GetUnion( nodeA.fatBounds, nodeF.fatBounds );
+			nodeA.height = 1 + Max( nodeB.height, nodeG.height );
+			nodeC.height = 1 + Max( nodeA.height, nodeF.height );
+		}
+		else {
+			nodeC.right = indexG;
+			nodeA.right = indexF;
+			nodeF.parent = indexA;
+			nodeA.fatBounds = AABB3::GetUnion( nodeB.fatBounds, nodeF.fatBounds );
+			nodeC.fatBounds = AABB3::GetUnion( nodeA.fatBounds, nodeG.fatBounds );
+			nodeA.height = 1 + Max( nodeB.height, nodeF.height );
+			nodeC.height = 1 + Max( nodeA.height, nodeG.height );
+		}
+		return indexC;
+	}
+
+	// Rotate B up, the mirror image
+	if ( balance < -1 ) {
+		AABBTreeNode_T& nodeB = m_nodes[indexB];
+		AABBTreeNode_T& nodeC = m_nodes[indexC];
+		int indexD = nodeB.left;
+		int indexE = nodeB.right;
+		AABBTreeNode_T& nodeD = m_nodes[indexD];
+		AABBTreeNode_T& nodeE = m_nodes[indexE];
+
+		nodeB.left = indexA;
+		nodeB.parent = nodeA.parent;
+		nodeA.parent = indexB;
+
+		if ( nodeB.parent == AABB_TREE_NULL_NODE ) {
+			m_root = indexB;
+		}
+		else if ( m_nodes[nodeB.parent].left == indexA ) {
+			m_nodes[nodeB.parent].left = indexB;
+		}
+		else {
+			m_nodes[nodeB.parent].right = indexB;
+		}
+
+		if ( nodeD.height > nodeE.height ) {
+			nodeB.right = indexD;
+			nodeA.left = indexE;
+			nodeE.parent = indexA;
+			nodeA.fatBounds = AABB3::GetUnion( nodeC.fatBounds, nodeE.fatBounds );
+			nodeB.fatBounds = AABB3::GetUnion( nodeA.fatBounds, nodeD.fatBounds );
+			nodeA.height = 1 + Max( nodeC.height, nodeE.height );
+			nodeB.height = 1 + Max( nodeA.height, nodeD.height );
+		}
+		else {
+			nodeB.right = indexE;
+			nodeA.left = indexD;
+			nodeD.parent = indexA;
+			nodeA.fatBounds = AABB3::GetUnion( nodeC.fatBounds, nodeD.fatBounds );
+			nodeB.fatBounds = AABB3::GetUnion( nodeA.fatBounds, nodeE.fatBounds );
+			nodeA.height = 1 + Max( nodeC.height, nodeD.height );
+			nodeB.height = 1 + Max( nodeA.height, nodeE.height );
+		}
+		return indexB;
+	}
+
+	return indexA;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void AABBTree::QueryFrustum( const Frustum& frustum, std::vector<int>& outUserIDs, AABBTreeQueryStats_T* outStats /* = nullptr */ ) const {
+	AABBTreeQueryStats_T stats;
+	m_candidateBounds.clear();
+	m_candidateUserIDs.clear();
+	m_queryStack.clear();
+
+	if ( m_root != AABB_TREE_NULL_NODE ) {
+		m_queryStack.push_back( { m_root, FRUSTUM_ALL_PLANES_MASK } );
+	}
+
+	while ( !m_queryStack.empty() ) {
+		QueryEntry_T entry = m_queryStack.back();
+		m_queryStack.pop_back();
+		stats.nodesVisited++;
+
+		const AABBTreeNode_T& node = m_nodes[entry.nodeIndex];
+		int planeMask = entry.planeMask;
+		if ( frustum.GetOverlap( node.fatBounds, planeMask ) == FRUSTUM_OUTSIDE ) {
+			continue;
+		}
+
+		// A fat box inside every plane means every real box below it is too
+		if ( planeMask == 0 ) {
+			AddSubtree( entry.nodeIndex, outUserIDs, stats );
+			continue;
+		}
+
+		if ( node.IsLeaf() ) {
+			m_candidateBounds.push_back( node.bounds );
+			m_candidateUserIDs.push_back( node.userID );
+			continue;
+		}
+
+		m_queryStack.push_back( { node.right, planeMask } );
+		m_queryStack.push_back( { node.left, planeMask } );
+	}
+
+	int candidateCount = (int) m_candidateBounds.size();
+	m_visibleIndices.resize( candidateCount );
+	int visibleCandidates = frustum.GetVisibleAABBs( m_candidateBounds.data(), candidateCount, m_visibleIndices.data() );
+	for ( int visibleIndex = 0; visibleIndex < visibleCandidates; visibleIndex++ ) {
+		outUserIDs.push_back( m_candidateUserIDs[ m_visibleIndices[visibleIndex] ] );
+	}
+
+	stats.leavesTested = candidateCount;
+	stats.visibleCount = stats.leavesAccepted + visibleCandidates;
+	if ( outStats != nullptr ) {
+		*outStats = stats;
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void AABBTree::AddSubtree( int nodeIndex, std::vector<int>& outUserIDs, AABBTreeQueryStats_T& stats ) const {
+	const AABBTreeNode_T& node = m_nodes[nodeIndex];
+	if ( node.IsLeaf() ) {
+		outUserIDs.push_back( node.userID );
+		stats.leavesAccepted++;
+		return;
+	}
+
+	// Balanced, so the recursion is only as deep as the tree's height
+	AddSubtree( node.left, outUserIDs, stats );
+	AddSubtree( node.right, outUserIDs, stats );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+bool AABBTree::IsValid() const {
+	if ( m_root == AABB_TREE_NULL_NODE ) {
+		return m_proxyCount == 0;
+	}
+	if ( m_nodes[m_root].parent != AABB_TREE_NULL_NODE ) {
+		return false;
+	}
+	return IsSubtreeValid( m_root );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+bool AABBTree::IsSubtreeValid( int nodeIndex ) const {
+	const AABBTreeNode_T& node = m_nodes[nodeIndex];
+	if ( node.IsLeaf() ) {
+		return node.height == 0 && node.fatBounds.Contains( node.bounds );
+	}
+
+	const AABBTreeNode_T& left = m_nodes[node.left];
+	const AABBTreeNode_T& right = m_nodes[node.right];
+	if ( left.parent != nodeIndex || right.parent != nodeIndex ) {
+		return false;
+	}
+	if ( node.height != 1 + Max( left.height, right.height ) ) {
+		return false;
+	}
+	if ( !node.fatBounds.Contains( left.fatBounds ) || !node.fatBounds.Contains( right.fatBounds ) ) {
+		return false;
+	}
+	return IsSubtreeValid( node.left ) && IsSubtreeValid( node.right );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void AABBTreeStartup() {
+	CommandRegistration::RegisterCommand( "cull_test", CullTestCommand, "[count] - Checks and times frustum culling of count random boxes" );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+static AABB3 MakeRandomBox( float worldRange ) {
+	Vector3 center( GetRandomFloatInRange( -worldRange, worldRange ), GetRandomFloatInRange( -worldRange, worldRange ), GetRandomFloatInRange( -worldRange, worldRange ) );
+	Vector3 halfExtents( GetRandomFloatInRange( 0.25f, 5.f ), GetRandomFloatInRange( 0.25f, 5.f ), GetRandomFloatInRange( 0.25f, 5.f ) );
+	return AABB3( center - halfExtents, center + halfExtents );
+}
+
+
+static Matrix44 MakeRandomViewProjection() {
+	Matrix44 cameraMatrix = Matrix44::MakeRotationDegrees( Vector3( GetRandomFloatInRange( -60.f, 60.f ), GetRandomFloatInRange( -180.f, 180.f ), 0.f ) );
+	cameraMatrix.Tx = GetRandomFloatInRange( -100.f, 100.f );
+	cameraMatrix.Ty = GetRandomFloatInRange( -100.f, 100.f );
+	cameraMatrix.Tz = GetRandomFloatInRange( -100.f, 100.f );
+
+	Matrix44 viewProjection = Matrix44::MakeProjection( 60.f, 16.f / 9.f, 0.1f, 400.f );
+	viewProjection.Append( cameraMatrix.GetInverseAffine() );
+	return viewProjection;
+}
+
+
+static double GetMicroseconds( uint64_t performanceCount ) {
+	return PerformanceCountToSeconds( performanceCount ) * 1000000.0;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Random boxes in a 1000 unit cube, seen from random cameras. Checks that the SSE and scalar kernels agree and
+// that the tree finds exactly what testing every box finds, while moving and removing boxes between frames the
+// way a scene would.
+void CullTestCommand( const std::string& command ) {
+	Command parsed( command );
+	int boxCount = 20000;
+	int argument = 0;
+	if ( parsed.PeekNextInt( argument ) && parsed.GetNextInt( argument ) && argument > 0 ) {
+		boxCount = argument;
+	}
+	const int frameCount = 32;
+	const float worldRange = 500.f;
+
+	std::vector<AABB3> boxes( boxCount );
+	std::vector<int> proxies( boxCount );
+	AABBTree tree;
+	for ( int boxIndex = 0; boxIndex < boxCount; boxIndex++ ) {
+		boxes[boxIndex] = MakeRandomBox( worldRange );
+		proxies[boxIndex] = tree.CreateProxy( boxes[boxIndex], boxIndex );
+	}
+
+	std::vector<int> scalarVisible( boxCount );
+	std::vector<int> simdVisible( boxCount );
+	std::vector<int> treeVisible;
+	treeVisible.reserve( boxCount );
+
+	uint64_t scalarTime = 0;
+	uint64_t simdTime = 0;
+	uint64_t treeTime = 0;
+	uint64_t moveTime = 0;
+	int kernelMismatches = 0;
+	int treeMismatches = 0;
+	int totalVisible = 0;
+	int totalBoxTests = 0;
+	int totalNodes = 0;
+	int reinserted = 0;
+
+	for ( int frame = 0; frame < frameCount; frame++ ) {
+
+		// A tenth of the boxes drift a little, most stay inside their fat box. A few leave and come back.
+		uint64_t start = GetPerformanceCount();
+		for ( int boxIndex = 0; boxIndex < boxCount; boxIndex += 10 ) {
+			Vector3 offset( GetRandomFloatInRange( -0.2f, 0.2f ), GetRandomFloatInRange( -0.2f, 0.2f ), GetRandomFloatInRange( -0.2f, 0.2f ) );
+			boxes[boxIndex] = AABB3( boxes[boxIndex].mins + offset, boxes[boxIndex].maxs + offset );
+			reinserted += tree.MoveProxy( proxies[boxIndex], boxes[boxIndex] ) ? 1 : 0;
+		}
+		for ( int churn = 0; churn < 16; churn++ ) {
+			int boxIndex = GetRandomIntLessThan( boxCount );
+			tree.DestroyProxy( proxies[boxIndex] );
+			boxes[boxIndex] = MakeRandomBox( worldRange );
+			proxies[boxIndex] = tree.CreateProxy( boxes[boxIndex], boxIndex );
+		}
+		moveTime += GetPerformanceCount() - start;
+
+		Frustum frustum = Frustum::FromMatrix( MakeRandomViewProjection() );
+
+		start = GetPerformanceCount();
+		int scalarCount = CullAABBs_Scalar( frustum, boxes.data(), boxCount, scalarVisible.data() );
+		scalarTime += GetPerformanceCount() - start;
+
+		start = GetPerformanceCount();
+		int simdCount = CullAABBs_SSE( frustum, boxes.data(), boxCount, simdVisible.data() );
+		simdTime += GetPerformanceCount() - start;
+
+		AABBTreeQueryStats_T stats;
+		treeVisible.clear();
+		start = GetPerformanceCount();
+		tree.QueryFrustum( frustum, treeVisible, &stats );
+		treeTime += GetPerformanceCount() - start;
+
+		if ( scalarCount != simdCount || !std::equal( scalarVisible.begin(), scalarVisible.begin() + scalarCount, simdVisible.begin() ) ) {
+			kernelMismatches++;
+		}
+
+		std::sort( treeVisible.begin(), treeVisible.end() );
+		if ( (int) treeVisible.size() != scalarCount || !std::equal( treeVisible.begin(), treeVisible.end(), scalarVisible.begin() ) ) {
+			treeMismatches++;
+		}
+
+		totalVisible += scalarCount;
+		totalBoxTests += stats.leavesTested;
+		totalNodes += stats.nodesVisited;
+	}
+
+	bool isTreeValid = tree.IsValid();
+	bool passed = ( kernelMismatches == 0 && treeMismatches == 0 && isTreeValid );
+
+	DevConsole::Printf( "cull_test: %d boxes, %d frames, %.1f visible per frame, tree height %d", boxCount, frameCount, (float) totalVisible / (float) frameCount, tree.GetHeight() );
+	DevConsole::Printf( "  scalar, every box   %9.2f us/frame", GetMicroseconds( scalarTime ) / (double) frameCount );
+	DevConsole::Printf( "  SSE, every box      %9.2f us/frame  %5.2fx", GetMicroseconds( simdTime ) / (double) frameCount, PerformanceCountToSeconds( scalarTime ) / Max( PerformanceCountToSeconds( simdTime ), 0.000000001 ) );
+	DevConsole::Printf( "  tree query          %9.2f us/frame  %5.2fx, %d nodes and %d box tests per frame", GetMicroseconds( treeTime ) / (double) frameCount, PerformanceCountToSeconds( scalarTime ) / Max( PerformanceCountToSeconds( treeTime ), 0.000000001 ), totalNodes / frameCount, totalBoxTests / frameCount );
+	DevConsole::Printf( "  tree updates        %9.2f us/frame, %d reinserted", GetMicroseconds( moveTime ) / (double) frameCount, reinserted );
+	DevConsole::Printf( passed ? Rgba( 0, 255, 0, 255 ) : Rgba( 255, 0, 0, 255 ), "  %d kernel mismatches, %d tree mismatches, tree %s", kernelMismatches, treeMismatches, isTreeValid ? "valid" : "INVALID" );
+}
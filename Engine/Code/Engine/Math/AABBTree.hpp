@@ -0,0 +1,96 @@
+#pragma once
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/Frustum.hpp"
+
+#include <string>
+#include <vector>
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Dynamic bounding volume tree, the same scheme as Box2D's b2DynamicTree in 3D. Every object is a leaf with a
+// "fat" box, its real box grown by a margin, so small moves don't touch the tree at all. Leaves are inserted next
+// to the sibling that grows the total surface area the least, and AVL style rotations keep it balanced.
+//
+// Proxy IDs are node indices and stay valid until DestroyProxy. Nodes live in one array and are recycled through
+// a free list, so the tree only allocates when it grows past its largest size so far.
+#define AABB_TREE_NULL_NODE -1
+#define AABB_TREE_DEFAULT_MARGIN 0.5f
+
+
+struct AABBTreeNode_T {
+	AABB3 fatBounds;
+	AABB3 bounds;					// Leaves only, what the final visibility test uses
+	int userID = -1;
+	int parent = AABB_TREE_NULL_NODE;	// Next free node while on the free list
+	int left = AABB_TREE_NULL_NODE;
+	int right = AABB_TREE_NULL_NODE;
+	int height = -1;				// 0 for leaves, -1 when free
+
+	bool IsLeaf() const { return left == AABB_TREE_NULL_NODE; }
+};
+
+
+struct AABBTreeQueryStats_T {
+	int nodesVisited = 0;
+	int leavesTested = 0;			// Leaves that needed the exact box test
+	int leavesAccepted = 0;			// Leaves kept without a test because a parent was fully inside
+	int visibleCount = 0;
+};
+
+
+class AABBTree {
+
+public:
+	explicit AABBTree( float margin = AABB_TREE_DEFAULT_MARGIN );
+
+	int CreateProxy( const AABB3& bounds, int userID );
+	void DestroyProxy( int proxyID );
+
+	// Reinserts the leaf only if bounds left its fat box. Returns true when it did.
+	bool MoveProxy( int proxyID, const AABB3& bounds );
+
+	void SetUserID( int proxyID, int userID );
+	int GetUserID( int proxyID ) const;
+	const AABB3& GetFatBounds( int proxyID ) const;
+	const AABB3& GetBounds( int proxyID ) const;
+
+	// Appends the user IDs of every leaf whose box is visible. Whole subtrees are taken without testing once a
+	// node is fully inside; leaves on the border are batched and go through Frustum::GetVisibleAABBs.
+	void QueryFrustum( const Frustum& frustum, std::vector<int>& outUserIDs, AABBTreeQueryStats_T* outStats = nullptr ) const;
+
+	void Clear();
+	int GetProxyCount() const;
+	int GetHeight() const;
+	bool IsValid() const;			// Walks the whole tree checking links, heights and boxes, for debugging
+
+private:
+	int AllocateNode();
+	void FreeNode( int nodeIndex );
+	void InsertLeaf( int leaf );
+	void RemoveLeaf( int leaf );
+	int Balance( int nodeIndex );
+	void RefitUpward( int nodeIndex );
+	void AddSubtree( int nodeIndex, std::vector<int>& outUserIDs, AABBTreeQueryStats_T& stats ) const;
+	bool IsSubtreeValid( int nodeIndex ) const;
+
+	std::vector<AABBTreeNode_T> m_nodes;
+	int m_root = AABB_TREE_NULL_NODE;
+	int m_freeList = AABB_TREE_NULL_NODE;
+	int m_proxyCount = 0;
+	float m_margin;
+
+	// Query scratch, kept so queries don't allocate after the first frame
+	struct QueryEntry_T {
+		int nodeIndex;
+		int planeMask;
+	};
+	mutable std::vector<QueryEntry_T> m_queryStack;
+	mutable std::vector<AABB3> m_candidateBounds;
+	mutable std::vector<int> m_candidateUserIDs;
+	mutable std::vector<int> m_visibleIndices;
+};
+
+
+//----------------------------------------------------------------------------------------------------------------
+void AABBTreeStartup();
+void CullTestCommand( const std::string& command );
@@ -1,37 +1,214 @@
+#include "Game/EngineBuildPreferences.hpp"
 #include "Engine/Math/Frustum.hpp"
-#include "Engine/Math/AABB3.hpp"
-#include "Engine/Math/Vector4.hpp"
+#include "Engine/Math/MathUtils.hpp"
 
-Frustum Frustum::FromMatrix( const Matrix44& mat ) {
-	AABB3 ndc( Vector3(-1.f, -1.f, -1.f), Vector3(1.f, 1.f, 1.f) );
+#include <immintrin.h>
+#include <math.h>
 
-	Vector3 corners[8] = {
-		Vector3(ndc.mins.x, ndc.mins.y, ndc.mins.z),
-		Vector3(ndc.mins.x, ndc.mins.y, ndc.maxs.z),
-		Vector3(ndc.mins.x, ndc.maxs.y, ndc.mins.z),
-		Vector3(ndc.mins.x, ndc.maxs.y, ndc.maxs.z),
-		Vector3(ndc.maxs.x, ndc.mins.y, ndc.mins.z),
-		Vector3(ndc.maxs.x, ndc.mins.y, ndc.maxs.z),
-		Vector3(ndc.maxs.x, ndc.maxs.y, ndc.mins.z),
-		Vector3(ndc.maxs.x, ndc.maxs.y, ndc.maxs.z)
-	};
 
-	Matrix44 inverse = mat.GetInverse();
-	Vector3 worldCorners[8];
-	for (unsigned int i = 0; i < 8; i++) {
-		Vector4 ndcPos = Vector4(corners[i], 1);
-		Vector4 kindaWorldPos = inverse.Transform(ndcPos);
+//----------------------------------------------------------------------------------------------------------------
+// Zero planes, which keeps everything
+Frustum::Frustum() {
+}
 
-		worldCorners[i] = Vector3(kindaWorldPos.x, kindaWorldPos.y, kindaWorldPos.z) * (1.f / kindaWorldPos.w);
-	}
+
+//----------------------------------------------------------------------------------------------------------------
+// Gribb/Hartmann. Clip space is -w <= x, y, z <= w, so each plane is the last row of the matrix plus or minus one
+// of the others. Matrix44 is column major, row r is ( I[r], J[r], K[r], T[r] ).
+static Plane MakeNormalizedPlane( float a, float b, float c, float d ) {
+	float length = sqrtf( a * a + b * b + c * c );
+	float scale = ( length > 0.f ) ? ( 1.f / length ) : 0.f;
+	return Plane( Vector3( a * scale, b * scale, c * scale ), -d * scale );
+}
+
+
+Frustum Frustum::FromMatrix( const Matrix44& viewProjection ) {
+	const Matrix44& m = viewProjection;
 
 	Frustum result;
-	result.right = Plane(worldCorners[5], worldCorners[6], worldCorners[7]);
-	result.left	 = Plane(worldCorners[0], worldCorners[1], worldCorners[2]);
-	result.up	 = Plane(worldCorners[2], worldCorners[3], worldCorners[6]);
-	result.down	 = Plane(worldCorners[0], worldCorners[1], worldCorners[4]);
-	result.far   = Plane(worldCorners[1], worldCorners[3], worldCorners[5]);
-	result.near  = Plane(worldCorners[0], worldCorners[2], worldCorners[4]);
+	result.planes[FRUSTUM_PLANE_LEFT]	= MakeNormalizedPlane( m.Iw + m.Ix, m.Jw + m.Jx, m.Kw + m.Kx, m.Tw + m.Tx );
+	result.planes[FRUSTUM_PLANE_RIGHT]	= MakeNormalizedPlane( m.Iw - m.Ix, m.Jw - m.Jx, m.Kw - m.Kx, m.Tw - m.Tx );
+	result.planes[FRUSTUM_PLANE_BOTTOM]	= MakeNormalizedPlane( m.Iw + m.Iy, m.Jw + m.Jy, m.Kw + m.Ky, m.Tw + m.Ty );
+	result.planes[FRUSTUM_PLANE_TOP]	= MakeNormalizedPlane( m.Iw - m.Iy, m.Jw - m.Jy, m.Kw - m.Ky, m.Tw - m.Ty );
+	result.planes[FRUSTUM_PLANE_NEAR]	= MakeNormalizedPlane( m.Iw + m.Iz, m.Jw + m.Jz, m.Kw + m.Kz, m.Tw + m.Tz );
+	result.planes[FRUSTUM_PLANE_FAR]	= MakeNormalizedPlane( m.Iw - m.Iz, m.Jw - m.Jz, m.Kw - m.Kz, m.Tw - m.Tz );
 	return result;
 }
 
+
+//----------------------------------------------------------------------------------------------------------------
+bool Frustum::IsContained( const Vector3& point ) const {
+	for ( int planeIndex = 0; planeIndex < FRUSTUM_PLANE_COUNT; planeIndex++ ) {
+		if ( planes[planeIndex].GetDistance( point ) < 0.f ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+bool Frustum::IsVisible( const Vector3& center, float radius ) const {
+	for ( int planeIndex = 0; planeIndex < FRUSTUM_PLANE_COUNT; planeIndex++ ) {
+		if ( planes[planeIndex].GetDistance( center ) < -radius ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Written out in the same order as the SSE kernel so both round the same way
+static inline bool IsAABBOutside( const Frustum& frustum, const AABB3& bounds ) {
+	float centerX = ( bounds.mins.x + bounds.maxs.x ) * 0.5f;
+	float centerY = ( bounds.mins.y + bounds.maxs.y ) * 0.5f;
+	float centerZ = ( bounds.mins.z + bounds.maxs.z ) * 0.5f;
+	float extentX = ( bounds.maxs.x - bounds.mins.x ) * 0.5f;
+	float extentY = ( bounds.maxs.y - bounds.mins.y ) * 0.5f;
+	float extentZ = ( bounds.maxs.z - bounds.mins.z ) * 0.5f;
+
+	for ( int planeIndex = 0; planeIndex < FRUSTUM_PLANE_COUNT; planeIndex++ ) {
+		const Plane& plane = frustum.planes[planeIndex];
+		float centerDistance = plane.normal.x * centerX + plane.normal.y * centerY + plane.normal.z * centerZ - plane.distance;
+		float radius = fabsf( plane.normal.x ) * extentX + fabsf( plane.normal.y ) * extentY + fabsf( plane.normal.z ) * extentZ;
+		if ( centerDistance + radius < 0.f ) {
+			return true;
+		}
+	}
+	return false;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+bool Frustum::IsVisible( const AABB3& bounds ) const {
+	return !IsAABBOutside( *this, bounds );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Called for every node a hierarchy visits, so it works on plain floats rather than building Vector3s
+eFrustumOverlap Frustum::GetOverlap( const AABB3& bounds, int& inOutPlaneMask ) const {
+	float centerX = ( bounds.mins.x + bounds.maxs.x ) * 0.5f;
+	float centerY = ( bounds.mins.y + bounds.maxs.y ) * 0.5f;
+	float centerZ = ( bounds.mins.z + bounds.maxs.z ) * 0.5f;
+	float extentX = ( bounds.maxs.x - bounds.mins.x ) * 0.5f;
+	float extentY = ( bounds.maxs.y - bounds.mins.y ) * 0.5f;
+	float extentZ = ( bounds.maxs.z - bounds.mins.z ) * 0.5f;
+
+	for ( int planeIndex = 0; planeIndex < FRUSTUM_PLANE_COUNT; planeIndex++ ) {
+		int planeBit = 1 << planeIndex;
+		if ( ( inOutPlaneMask & planeBit ) == 0 ) {
+			continue;
+		}
+
+		const Plane& plane = planes[planeIndex];
+		float centerDistance = plane.normal.x * centerX + plane.normal.y * centerY + plane.normal.z * centerZ - plane.distance;
+		float radius = fabsf( plane.normal.x ) * extentX + fabsf( plane.normal.y ) * extentY + fabsf( plane.normal.z ) * extentZ;
+		if ( centerDistance + radius < 0.f ) {
+			return FRUSTUM_OUTSIDE;
+		}
+		if ( centerDistance - radius >= 0.f ) {
+			inOutPlaneMask &= ~planeBit;
+		}
+	}
+
+	return ( inOutPlaneMask == 0 ) ? FRUSTUM_INSIDE : FRUSTUM_INTERSECTS;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int Frustum::GetVisibleAABBs( const AABB3* bounds, int count, int* outVisibleIndices ) const {
+#if defined(ENGINE_DISABLE_SIMD)
+	return CullAABBs_Scalar( *this, bounds, count, outVisibleIndices );
+#else
+	return CullAABBs_SSE( *this, bounds, count, outVisibleIndices );
+#endif
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int CullAABBs_Scalar( const Frustum& frustum, const AABB3* bounds, int count, int* outVisibleIndices ) {
+	int visibleCount = 0;
+	for ( int index = 0; index < count; index++ ) {
+		if ( !IsAABBOutside( frustum, bounds[index] ) ) {
+			outVisibleIndices[visibleCount++] = index;
+		}
+	}
+	return visibleCount;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Four boxes per iteration, one per lane. The planes are splatted once up front; the boxes are gathered out of
+// the AABB3 array into x, y and z registers since they're stored as mins/maxs structs.
+int CullAABBs_SSE( const Frustum& frustum, const AABB3* bounds, int count, int* outVisibleIndices ) {
+	__m128 normalX[FRUSTUM_PLANE_COUNT];
+	__m128 normalY[FRUSTUM_PLANE_COUNT];
+	__m128 normalZ[FRUSTUM_PLANE_COUNT];
+	__m128 absNormalX[FRUSTUM_PLANE_COUNT];
+	__m128 absNormalY[FRUSTUM_PLANE_COUNT];
+	__m128 absNormalZ[FRUSTUM_PLANE_COUNT];
+	__m128 planeDistance[FRUSTUM_PLANE_COUNT];
+	for ( int planeIndex = 0; planeIndex < FRUSTUM_PLANE_COUNT; planeIndex++ ) {
+		const Plane& plane = frustum.planes[planeIndex];
+		normalX[planeIndex] = _mm_set1_ps( plane.normal.x );
+		normalY[planeIndex] = _mm_set1_ps( plane.normal.y );
+		normalZ[planeIndex] = _mm_set1_ps( plane.normal.z );
+		absNormalX[planeIndex] = _mm_set1_ps( fabsf( plane.normal.x ) );
+		absNormalY[planeIndex] = _mm_set1_ps( fabsf( plane.normal.y ) );
+		absNormalZ[planeIndex] = _mm_set1_ps( fabsf( plane.normal.z ) );
+		planeDistance[planeIndex] = _mm_set1_ps( plane.distance );
+	}
+
+	const __m128 half = _mm_set1_ps( 0.5f );
+	const __m128 zero = _mm_setzero_ps();
+
+	int visibleCount = 0;
+	int index = 0;
+	for ( ; index + 4 <= count; index += 4 ) {
+		const AABB3* box = bounds + index;
+		__m128 minX = _mm_setr_ps( box[0].mins.x, box[1].mins.x, box[2].mins.x, box[3].mins.x );
+		__m128 minY = _mm_setr_ps( box[0].mins.y, box[1].mins.y, box[2].mins.y, box[3].mins.y );
+		__m128 minZ = _mm_setr_ps( box[0].mins.z, box[1].mins.z, box[2].mins.z, box[3].mins.z );
+		__m128 maxX = _mm_setr_ps( box[0].maxs.x, box[1].maxs.x, box[2].maxs.x, box[3].maxs.x );
+		__m128 maxY = _mm_setr_ps( box[0].maxs.y, box[1].maxs.y, box[2].maxs.y, box[3].maxs.y );
+		__m128 maxZ = _mm_setr_ps( box[0].maxs.z, box[1].maxs.z, box[2].maxs.z, box[3].maxs.z );
+
+		__m128 centerX = _mm_mul_ps( _mm_add_ps( minX, maxX ), half );
+		__m128 centerY = _mm_mul_ps( _mm_add_ps( minY, maxY ), half );
+		__m128 centerZ = _mm_mul_ps( _mm_add_ps( minZ, maxZ ), half );
+		__m128 extentX = _mm_mul_ps( _mm_sub_ps( maxX, minX ), half );
+		__m128 extentY = _mm_mul_ps( _mm_sub_ps( maxY, minY ), half );
+		__m128 extentZ = _mm_mul_ps( _mm_sub_ps( maxZ, minZ ), half );
+
+		__m128 outside = zero;
+		for ( int planeIndex = 0; planeIndex < FRUSTUM_PLANE_COUNT; planeIndex++ ) {
+			__m128 centerDistance = _mm_add_ps( _mm_add_ps( _mm_mul_ps( normalX[planeIndex], centerX ), _mm_mul_ps( normalY[planeIndex], centerY ) ), _mm_mul_ps( normalZ[planeIndex], centerZ ) );
+			centerDistance = _mm_sub_ps( centerDistance, planeDistance[planeIndex] );
+			__m128 radius = _mm_add_ps( _mm_add_ps( _mm_mul_ps( absNormalX[planeIndex], extentX ), _mm_mul_ps( absNormalY[planeIndex], extentY ) ), _mm_mul_ps( absNormalZ[planeIndex], extentZ ) );
+			outside = _mm_or_ps( outside, _mm_cmplt_ps( _mm_add_ps( centerDistance, radius ), zero ) );
+		}
+
+		int outsideMask = _mm_movemask_ps( outside );
+		if ( outsideMask == 0 ) {
+			outVisibleIndices[visibleCount++] = index;
+			outVisibleIndices[visibleCount++] = index + 1;
+			outVisibleIndices[visibleCount++] = index + 2;
+			outVisibleIndices[visibleCount++] = index + 3;
+			continue;
+		}
+		for ( int lane = 0; lane < 4; lane++ ) {
+			if ( ( outsideMask & ( 1 << lane ) ) == 0 ) {
+				outVisibleIndices[visibleCount++] = index + lane;
+			}
+		}
+	}
+
+	for ( ; index < count; index++ ) {
+		if ( !IsAABBOutside( frustum, bounds[index] ) ) {
+			outVisibleIndices[visibleCount++] = index;
+		}
+	}
+	return visibleCount;
+}
@@ -2,18 +2,60 @@
 #include "Engine/Math/Plane.hpp"
 #include "Engine/Math/Matrix44.hpp"
 #include "Engine/Math/Vector3.hpp"
+#include "Engine/Math/AABB3.hpp"
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Six planes pulled straight out of a view projection matrix, normals pointing inward, so a point is inside when
+// every Plane::GetDistance is >= 0. Boxes are tested center/extent against each plane, which can keep a box that
+// straddles two planes outside a corner, but never drops a visible one.
+//
+// The plane array is indexed by eFrustumPlane instead of named members since near and far are macros on Windows.
+#define FRUSTUM_PLANE_COUNT 6
+#define FRUSTUM_ALL_PLANES_MASK 0x3F
+
+
+enum eFrustumPlane {
+	FRUSTUM_PLANE_LEFT,
+	FRUSTUM_PLANE_RIGHT,
+	FRUSTUM_PLANE_BOTTOM,
+	FRUSTUM_PLANE_TOP,
+	FRUSTUM_PLANE_NEAR,
+	FRUSTUM_PLANE_FAR
+};
+
+
+enum eFrustumOverlap {
+	FRUSTUM_OUTSIDE,
+	FRUSTUM_INTERSECTS,
+	FRUSTUM_INSIDE
+};
+
 
 class Frustum {
 public:
 	Frustum();
-	Plane left;
-	Plane right;
-	Plane up;
-	Plane down;
-	Plane near;
-	Plane far;
 
-	static Frustum FromMatrix( const Matrix44& mat );
+	static Frustum FromMatrix( const Matrix44& viewProjection );
+
+	bool IsContained( const Vector3& point ) const;
+	bool IsVisible( const AABB3& bounds ) const;
+	bool IsVisible( const Vector3& center, float radius ) const;
+
+	// For hierarchies. Only tests the planes set in inOutPlaneMask and clears the bits of the planes the box is
+	// completely inside of, so children of the box can skip them.
+	eFrustumOverlap GetOverlap( const AABB3& bounds, int& inOutPlaneMask ) const;
+
+	// Writes the indices of the visible boxes in order and returns how many there were. Uses SSE unless the game
+	// defines ENGINE_DISABLE_SIMD.
+	int GetVisibleAABBs( const AABB3* bounds, int count, int* outVisibleIndices ) const;
+
+public:
+	Plane planes[FRUSTUM_PLANE_COUNT];
+};
+
 
-	bool IsContained( const Vector3& point );
-};
\ No newline at end of file
+//----------------------------------------------------------------------------------------------------------------
+// Both kernels give the same answer for every box, cull_test checks that
+int CullAABBs_Scalar( const Frustum& frustum, const AABB3* bounds, int count, int* outVisibleIndices );
+int CullAABBs_SSE( const Frustum& frustum, const AABB3* bounds, int count, int* outVisibleIndices );
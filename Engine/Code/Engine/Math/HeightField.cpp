@@ -0,0 +1,133 @@
+#include "Engine/Math/HeightField.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+#include <math.h>
+
+
+//----------------------------------------------------------------------------------------------------------------
+HeightField::HeightField() {
+
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Rounds up to whole tiles, the padding samples are never read
+void HeightField::SetDimensions( const IntVector2& sampleCount ) {
+	m_dimensions = sampleCount;
+	m_tilesPerRow = ( sampleCount.x + HEIGHT_FIELD_TILE_MASK ) >> HEIGHT_FIELD_TILE_SHIFT;
+	int tileRows = ( sampleCount.y + HEIGHT_FIELD_TILE_MASK ) >> HEIGHT_FIELD_TILE_SHIFT;
+
+	m_samples.clear();
+	m_samples.resize( m_tilesPerRow * tileRows * HEIGHT_FIELD_TILE_SIZE * HEIGHT_FIELD_TILE_SIZE );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+IntVector2 HeightField::GetDimensions() const {
+	return m_dimensions;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void HeightField::SetHeight( int x, int y, float height ) {
+	m_samples[ GetSampleIndex( x, y ) ].height = height;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+/*
+	ul---u
+	|\ 2|\
+	| \ | \
+	| 1\|3 \
+	l---c---r
+	 \ 6|\ 4|
+	  \ | \ |
+	   \|5 \|
+		d---dr
+
+	Each triangle is listed so cross( b - a, c - a ) points up.
+*/
+static const int NORMAL_TRIANGLE_COUNT = 6;
+static const IntVector2 NORMAL_TRIANGLES[ NORMAL_TRIANGLE_COUNT ][3] = {
+	{ IntVector2( -1,  0 ), IntVector2( -1,  1 ), IntVector2(  0,  0 ) },	// 1: l, ul, c
+	{ IntVector2(  0,  0 ), IntVector2( -1,  1 ), IntVector2(  0,  1 ) },	// 2: c, ul, u
+	{ IntVector2(  0,  0 ), IntVector2(  0,  1 ), IntVector2(  1,  0 ) },	// 3: c, u, r
+	{ IntVector2(  0,  0 ), IntVector2(  1,  0 ), IntVector2(  1, -1 ) },	// 4: c, r, dr
+	{ IntVector2(  0, -1 ), IntVector2(  0,  0 ), IntVector2(  1, -1 ) },	// 5: d, c, dr
+	{ IntVector2(  0,  0 ), IntVector2(  0, -1 ), IntVector2( -1,  0 ) },	// 6: c, d, l
+};
+
+
+void HeightField::ComputeNormals( int rowBegin, int rowEnd ) {
+	for ( int y = rowBegin; y < rowEnd; y++ ) {
+		for ( int x = 0; x < m_dimensions.x; x++ ) {
+			Vector3 normalSum = Vector3::ZERO;
+
+			for ( int triangleIndex = 0; triangleIndex < NORMAL_TRIANGLE_COUNT; triangleIndex++ ) {
+				Vector3 corners[3];
+				bool isInside = true;
+				for ( int cornerIndex = 0; cornerIndex < 3; cornerIndex++ ) {
+					int cornerX = x + NORMAL_TRIANGLES[ triangleIndex ][ cornerIndex ].x;
+					int cornerY = y + NORMAL_TRIANGLES[ triangleIndex ][ cornerIndex ].y;
+					if ( cornerX < 0 || cornerY < 0 || cornerX >= m_dimensions.x || cornerY >= m_dimensions.y ) {
+						isInside = false;
+						break;
+					}
+					corners[ cornerIndex ] = Vector3( (float) cornerX, GetHeight( cornerX, cornerY ), (float) cornerY );
+				}
+
+				if ( isInside ) {
+					normalSum += Vector3::CrossProduct( corners[1] - corners[0], corners[2] - corners[0] );
+				}
+			}
+
+			m_samples[ GetSampleIndex( x, y ) ].normal = normalSum.GetNormalized();
+		}
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Clamps instead of branching on the edges: the cell is pinned inside the field and the fraction to [0,1]
+void HeightField::GetBilinearCorners( float x, float y, int* outIndices, float& outFractionX, float& outFractionY ) const {
+	float maxCellX = (float) ( m_dimensions.x - 2 );
+	float maxCellY = (float) ( m_dimensions.y - 2 );
+	float cellX = ClampFloat( floorf( x ), 0.f, maxCellX );
+	float cellY = ClampFloat( floorf( y ), 0.f, maxCellY );
+	outFractionX = ClampFloatZeroToOne( x - cellX );
+	outFractionY = ClampFloatZeroToOne( y - cellY );
+
+	int lowerX = (int) cellX;
+	int lowerY = (int) cellY;
+	outIndices[0] = GetSampleIndex( lowerX,		lowerY );
+	outIndices[1] = GetSampleIndex( lowerX + 1,	lowerY );
+	outIndices[2] = GetSampleIndex( lowerX,		lowerY + 1 );
+	outIndices[3] = GetSampleIndex( lowerX + 1,	lowerY + 1 );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+float HeightField::SampleHeight( float x, float y ) const {
+	int corners[4];
+	float fractionX;
+	float fractionY;
+	GetBilinearCorners( x, y, corners, fractionX, fractionY );
+
+	float bottom = Interpolate( m_samples[ corners[0] ].height, m_samples[ corners[1] ].height, fractionX );
+	float top = Interpolate( m_samples[ corners[2] ].height, m_samples[ corners[3] ].height, fractionX );
+	return Interpolate( bottom, top, fractionY );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+Vector3 HeightField::SampleNormal( float x, float y ) const {
+	int corners[4];
+	float fractionX;
+	float fractionY;
+	GetBilinearCorners( x, y, corners, fractionX, fractionY );
+
+	Vector3 bottom = Interpolate( m_samples[ corners[0] ].normal, m_samples[ corners[1] ].normal, fractionX );
+	Vector3 top = Interpolate( m_samples[ corners[2] ].normal, m_samples[ corners[3] ].normal, fractionX );
+	return Interpolate( bottom, top, fractionY );
+}
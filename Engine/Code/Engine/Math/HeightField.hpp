@@ -0,0 +1,74 @@
+#pragma once
+#include "Engine/Math/Vector3.hpp"
+#include "Engine/Math/IntVector2.hpp"
+
+#include <vector>
+
+
+//----------------------------------------------------------------------------------------------------------------
+// A grid of float heights with a normal per sample, spaced one unit apart on the XZ plane. Samples are stored in
+// square tiles of HEIGHT_FIELD_TILE_SIZE x HEIGHT_FIELD_TILE_SIZE, each tile contiguous and row-major inside, so
+// a bilinear lookup touches one or two cache lines instead of two rows a whole map apart. The height and normal
+// of a sample sit next to each other for the same reason.
+//
+// Writers that only touch their own rows or tiles (SetHeight, ComputeNormals over disjoint row ranges) can run
+// on separate threads.
+#define HEIGHT_FIELD_TILE_SHIFT 3
+#define HEIGHT_FIELD_TILE_SIZE ( 1 << HEIGHT_FIELD_TILE_SHIFT )
+#define HEIGHT_FIELD_TILE_MASK ( HEIGHT_FIELD_TILE_SIZE - 1 )
+
+
+struct HeightFieldSample_T {
+	float height = 0.f;
+	Vector3 normal = Vector3( 0.f, 1.f, 0.f );
+};
+
+
+class HeightField {
+
+public:
+	HeightField();
+
+	void SetDimensions( const IntVector2& sampleCount );
+	IntVector2 GetDimensions() const;
+
+	void SetHeight( int x, int y, float height );
+	float GetHeight( int x, int y ) const;
+	const Vector3& GetNormal( int x, int y ) const;
+
+	// Area weighted average of the six triangles around each sample, the same split MeshBuilder uses for the
+	// terrain. Reads neighbouring rows, so every height has to be written first.
+	void ComputeNormals( int rowBegin, int rowEnd );
+
+	// Bilinear, clamped to the edges of the field
+	float SampleHeight( float x, float y ) const;
+	Vector3 SampleNormal( float x, float y ) const;
+
+private:
+	int GetSampleIndex( int x, int y ) const;
+	void GetBilinearCorners( float x, float y, int* outIndices, float& outFractionX, float& outFractionY ) const;
+
+	IntVector2 m_dimensions;
+	int m_tilesPerRow = 0;
+	std::vector<HeightFieldSample_T> m_samples;
+};
+
+
+//----------------------------------------------------------------------------------------------------------------
+inline int HeightField::GetSampleIndex( int x, int y ) const {
+	int tileIndex = ( ( y >> HEIGHT_FIELD_TILE_SHIFT ) * m_tilesPerRow ) + ( x >> HEIGHT_FIELD_TILE_SHIFT );
+	int indexInTile = ( ( y & HEIGHT_FIELD_TILE_MASK ) << HEIGHT_FIELD_TILE_SHIFT ) + ( x & HEIGHT_FIELD_TILE_MASK );
+	return ( tileIndex << ( 2 * HEIGHT_FIELD_TILE_SHIFT ) ) + indexInTile;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+inline float HeightField::GetHeight( int x, int y ) const {
+	return m_samples[ GetSampleIndex( x, y ) ].height;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+inline const Vector3& HeightField::GetNormal( int x, int y ) const {
+	return m_samples[ GetSampleIndex( x, y ) ].normal;
+}
@@ -1,5 +1,6 @@
 #include "Game/EngineBuildPreferences.hpp"
 #include "Engine/Math/Matrix44.hpp"
+#include "Engine/Math/MatrixKernels.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Math/Vector4.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
@@ -78,25 +79,11 @@ void Matrix44::SetValues( float values[16] ) {
 
 
 void Matrix44::Append( const Matrix44& rightSide) {
-
-	Matrix44 leftSide = *this;
-
-	Ix = (leftSide.Ix * rightSide.Ix) + (leftSide.Jx * rightSide.Iy) + (leftSide.Kx * rightSide.Iz) + (leftSide.Tx * rightSide.Iw);
-	Iy = (leftSide.Iy * rightSide.Ix) + (leftSide.Jy * rightSide.Iy) + (leftSide.Ky * rightSide.Iz) + (leftSide.Ty * rightSide.Iw);
-	Iz = (leftSide.Iz * rightSide.Ix) + (leftSide.Jz * rightSide.Iy) + (leftSide.Kz * rightSide.Iz) + (leftSide.Tz * rightSide.Iw);
-	Iw = (leftSide.Iw * rightSide.Ix) + (leftSide.Jw * rightSide.Iy) + (leftSide.Kw * rightSide.Iz) + (leftSide.Tw * rightSide.Iw);
-	Jx = (leftSide.Ix * rightSide.Jx) + (leftSide.Jx * rightSide.Jy) + (leftSide.Kx * rightSide.Jz) + (leftSide.Tx * rightSide.Jw);
-	Jy = (leftSide.Iy * rightSide.Jx) + (leftSide.Jy * rightSide.Jy) + (leftSide.Ky * rightSide.Jz) + (leftSide.Ty * rightSide.Jw);
-	Jz = (leftSide.Iz * rightSide.Jx) + (leftSide.Jz * rightSide.Jy) + (leftSide.Kz * rightSide.Jz) + (leftSide.Tz * rightSide.Jw);
-	Jw = (leftSide.Iw * rightSide.Jx) + (leftSide.Jw * rightSide.Jy) + (leftSide.Kw * rightSide.Jz) + (leftSide.Tw * rightSide.Jw);
-	Kx = (leftSide.Ix * rightSide.Kx) + (leftSide.Jx * rightSide.Ky) + (leftSide.Kx * rightSide.Kz) + (leftSide.Tx * rightSide.Kw);
-	Ky = (leftSide.Iy * rightSide.Kx) + (leftSide.Jy * rightSide.Ky) + (leftSide.Ky * rightSide.Kz) + (leftSide.Ty * rightSide.Kw);
-	Kz = (leftSide.Iz * rightSide.Kx) + (leftSide.Jz * rightSide.Ky) + (leftSide.Kz * rightSide.Kz) + (leftSide.Tz * rightSide.Kw);
-	Kw = (leftSide.Iw * rightSide.Kx) + (leftSide.Jw * rightSide.Ky) + (leftSide.Kw * rightSide.Kz) + (leftSide.Tw * rightSide.Kw);
-	Tx = (leftSide.Ix * rightSide.Tx) + (leftSide.Jx * rightSide.Ty) + (leftSide.Kx * rightSide.Tz) + (leftSide.Tx * rightSide.Tw);
-	Ty = (leftSide.Iy * rightSide.Tx) + (leftSide.Jy * rightSide.Ty) + (leftSide.Ky * rightSide.Tz) + (leftSide.Ty * rightSide.Tw);
-	Tz = (leftSide.Iz * rightSide.Tx) + (leftSide.Jz * rightSide.Ty) + (leftSide.Kz * rightSide.Tz) + (leftSide.Tz * rightSide.Tw);
-	Tw = (leftSide.Iw * rightSide.Tx) + (leftSide.Jw * rightSide.Ty) + (leftSide.Kw * rightSide.Tz) + (leftSide.Tw * rightSide.Tw);
+#if defined(ENGINE_DISABLE_SIMD)
+	MultiplyMatrix_Scalar( *this, rightSide, this );
+#else
+	MultiplyMatrix_SSE( *this, rightSide, this );
+#endif
 }
 
 
@@ -158,11 +145,11 @@ Vector2 Matrix44::TransformPosition2D( const Vector2& point ) {
 }
 
 Vector3 Matrix44::TransformPosition(const Vector3& point) const {
-	float transformedX = (point.x * Ix) + (point.y * Jx) + (point.z * Kx) + Tx;
-	float transformedY = (point.x * Iy) + (point.y * Jy) + (point.z * Ky) + Ty;
-	float transformedZ = (point.x * Iz) + (point.y * Jz) + (point.z * Kz) + Tz;
-
-	return Vector3(transformedX, transformedY, transformedZ);
+#if defined(ENGINE_DISABLE_SIMD)
+	return TransformPosition_Scalar( *this, point );
+#else
+	return TransformPosition_SSE( *this, point );
+#endif
 }
 
 Vector4 Matrix44::Transform(const Vector4& point) const {
@@ -349,27 +336,25 @@ Matrix44 Matrix44::MakeRotationDegrees( const Vector3& rotation ) {
 	// on the basis we are currently using. Always do Yaw -> Pitch -> Roll
 #ifdef X_RIGHT_Y_UP_Z_FORWARD
 
-	Matrix44 xRot;
-	xRot.Jy = CosDegrees(rotation.x);
-	xRot.Jz = -SinDegrees(rotation.x);
-	xRot.Ky = SinDegrees(rotation.x);
-	xRot.Kz = CosDegrees(rotation.x);
-
-	Matrix44 yRot;
-	yRot.Ix = CosDegrees(rotation.y);
-	yRot.Iz = -SinDegrees(rotation.y);
-	yRot.Kx = SinDegrees(rotation.y);
-	yRot.Kz = CosDegrees(rotation.y);
-
-	Matrix44 zRot;
-	zRot.Ix = CosDegrees(rotation.z);
-	zRot.Iy = SinDegrees(rotation.z);
-	zRot.Jx = -SinDegrees(rotation.z);
-	zRot.Jy = CosDegrees(rotation.z);
-
-	yRot.Append(xRot);
-	yRot.Append(zRot);
-	return yRot;
+	// yRot * xRot * zRot multiplied out, so each sin/cos is computed once and nothing gets appended
+	float cosX = CosDegrees(rotation.x);
+	float sinX = SinDegrees(rotation.x);
+	float cosY = CosDegrees(rotation.y);
+	float sinY = SinDegrees(rotation.y);
+	float cosZ = CosDegrees(rotation.z);
+	float sinZ = SinDegrees(rotation.z);
+
+	Matrix44 rot;
+	rot.Ix = (cosY * cosZ) - (sinX * sinY * sinZ);
+	rot.Iy = cosX * sinZ;
+	rot.Iz = -(sinY * cosZ) - (sinX * cosY * sinZ);
+	rot.Jx = -(cosY * sinZ) - (sinX * sinY * cosZ);
+	rot.Jy = cosX * cosZ;
+	rot.Jz = (sinY * sinZ) - (sinX * cosY * cosZ);
+	rot.Kx = cosX * sinY;
+	rot.Ky = sinX;
+	rot.Kz = cosX * cosY;
+	return rot;
 #endif
 
 #ifdef X_FORWARD_Y_LEFT_Z_UP
@@ -452,297 +437,36 @@ Matrix44 Matrix44::MakeScale( const Vector3& scale ) {
 }
 
 
-//------------------------------------------------------------------------
-// Lifted from GLU
-void Matrix44::Invert()
-{
-	double inv[16];
-	double det;
-	double m[16];
-	unsigned int i;
-	m[0] = Ix;
-	m[1] = Iy;
-	m[2] = Iz;
-	m[3] = Iw;
-	m[4] = Jx;
-	m[5] = Jy;
-	m[6] = Jz;
-	m[7] = Jw;
-	m[8] = Kx;
-	m[9] = Ky;
-	m[10] = Kz;
-	m[11] = Kw;
-	m[12] = Tx;
-	m[13] = Ty;
-	m[14] = Tz;
-	m[15] = Tw;
-
-	inv[0] = m[5]  * m[10] * m[15] - 
-		m[5]  * m[11] * m[14] - 
-		m[9]  * m[6]  * m[15] + 
-		m[9]  * m[7]  * m[14] +
-		m[13] * m[6]  * m[11] - 
-		m[13] * m[7]  * m[10];
-
-	inv[4] = -m[4]  * m[10] * m[15] + 
-		m[4]  * m[11] * m[14] + 
-		m[8]  * m[6]  * m[15] - 
-		m[8]  * m[7]  * m[14] - 
-		m[12] * m[6]  * m[11] + 
-		m[12] * m[7]  * m[10];
-
-	inv[8] = m[4]  * m[9] * m[15] - 
-		m[4]  * m[11] * m[13] - 
-		m[8]  * m[5] * m[15] + 
-		m[8]  * m[7] * m[13] + 
-		m[12] * m[5] * m[11] - 
-		m[12] * m[7] * m[9];
-
-	inv[12] = -m[4]  * m[9] * m[14] + 
-		m[4]  * m[10] * m[13] +
-		m[8]  * m[5] * m[14] - 
-		m[8]  * m[6] * m[13] - 
-		m[12] * m[5] * m[10] + 
-		m[12] * m[6] * m[9];
-
-	inv[1] = -m[1]  * m[10] * m[15] + 
-		m[1]  * m[11] * m[14] + 
-		m[9]  * m[2] * m[15] - 
-		m[9]  * m[3] * m[14] - 
-		m[13] * m[2] * m[11] + 
-		m[13] * m[3] * m[10];
-
-	inv[5] = m[0]  * m[10] * m[15] - 
-		m[0]  * m[11] * m[14] - 
-		m[8]  * m[2] * m[15] + 
-		m[8]  * m[3] * m[14] + 
-		m[12] * m[2] * m[11] - 
-		m[12] * m[3] * m[10];
-
-	inv[9] = -m[0]  * m[9] * m[15] + 
-		m[0]  * m[11] * m[13] + 
-		m[8]  * m[1] * m[15] - 
-		m[8]  * m[3] * m[13] - 
-		m[12] * m[1] * m[11] + 
-		m[12] * m[3] * m[9];
-
-	inv[13] = m[0]  * m[9] * m[14] - 
-		m[0]  * m[10] * m[13] - 
-		m[8]  * m[1] * m[14] + 
-		m[8]  * m[2] * m[13] + 
-		m[12] * m[1] * m[10] - 
-		m[12] * m[2] * m[9];
-
-	inv[2] = m[1]  * m[6] * m[15] - 
-		m[1]  * m[7] * m[14] - 
-		m[5]  * m[2] * m[15] + 
-		m[5]  * m[3] * m[14] + 
-		m[13] * m[2] * m[7] - 
-		m[13] * m[3] * m[6];
-
-	inv[6] = -m[0]  * m[6] * m[15] + 
-		m[0]  * m[7] * m[14] + 
-		m[4]  * m[2] * m[15] - 
-		m[4]  * m[3] * m[14] - 
-		m[12] * m[2] * m[7] + 
-		m[12] * m[3] * m[6];
-
-	inv[10] = m[0]  * m[5] * m[15] - 
-		m[0]  * m[7] * m[13] - 
-		m[4]  * m[1] * m[15] + 
-		m[4]  * m[3] * m[13] + 
-		m[12] * m[1] * m[7] - 
-		m[12] * m[3] * m[5];
-
-	inv[14] = -m[0]  * m[5] * m[14] + 
-		m[0]  * m[6] * m[13] + 
-		m[4]  * m[1] * m[14] - 
-		m[4]  * m[2] * m[13] - 
-		m[12] * m[1] * m[6] + 
-		m[12] * m[2] * m[5];
-
-	inv[3] = -m[1] * m[6] * m[11] + 
-		m[1] * m[7] * m[10] + 
-		m[5] * m[2] * m[11] - 
-		m[5] * m[3] * m[10] - 
-		m[9] * m[2] * m[7] + 
-		m[9] * m[3] * m[6];
-
-	inv[7] = m[0] * m[6] * m[11] - 
-		m[0] * m[7] * m[10] - 
-		m[4] * m[2] * m[11] + 
-		m[4] * m[3] * m[10] + 
-		m[8] * m[2] * m[7] - 
-		m[8] * m[3] * m[6];
-
-	inv[11] = -m[0] * m[5] * m[11] + 
-		m[0] * m[7] * m[9] + 
-		m[4] * m[1] * m[11] - 
-		m[4] * m[3] * m[9] - 
-		m[8] * m[1] * m[7] + 
-		m[8] * m[3] * m[5];
-
-	inv[15] = m[0] * m[5] * m[10] - 
-		m[0] * m[6] * m[9] - 
-		m[4] * m[1] * m[10] + 
-		m[4] * m[2] * m[9] + 
-		m[8] * m[1] * m[6] - 
-		m[8] * m[2] * m[5];
-
-	det = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
-	det = 1.0 / det;
-
-	float data[16];
-	for (i = 0; i < 16; i++) {
-		data[i] = (float)(inv[i] * det);
-	}
-	SetValues(data);
-}
-
-
-Matrix44 Matrix44::GetInverse() const
-{
-	double inv[16];
-	double det;
-	double m[16];
-	unsigned int i;
-	m[0] = Ix;
-	m[1] = Iy;
-	m[2] = Iz;
-	m[3] = Iw;
-	m[4] = Jx;
-	m[5] = Jy;
-	m[6] = Jz;
-	m[7] = Jw;
-	m[8] = Kx;
-	m[9] = Ky;
-	m[10] = Kz;
-	m[11] = Kw;
-	m[12] = Tx;
-	m[13] = Ty;
-	m[14] = Tz;
-	m[15] = Tw;
-
-	inv[0] = m[5]  * m[10] * m[15] - 
-		m[5]  * m[11] * m[14] - 
-		m[9]  * m[6]  * m[15] + 
-		m[9]  * m[7]  * m[14] +
-		m[13] * m[6]  * m[11] - 
-		m[13] * m[7]  * m[10];
-
-	inv[4] = -m[4]  * m[10] * m[15] + 
-		m[4]  * m[11] * m[14] + 
-		m[8]  * m[6]  * m[15] - 
-		m[8]  * m[7]  * m[14] - 
-		m[12] * m[6]  * m[11] + 
-		m[12] * m[7]  * m[10];
-
-	inv[8] = m[4]  * m[9] * m[15] - 
-		m[4]  * m[11] * m[13] - 
-		m[8]  * m[5] * m[15] + 
-		m[8]  * m[7] * m[13] + 
-		m[12] * m[5] * m[11] - 
-		m[12] * m[7] * m[9];
-
-	inv[12] = -m[4]  * m[9] * m[14] + 
-		m[4]  * m[10] * m[13] +
-		m[8]  * m[5] * m[14] - 
-		m[8]  * m[6] * m[13] - 
-		m[12] * m[5] * m[10] + 
-		m[12] * m[6] * m[9];
-
-	inv[1] = -m[1]  * m[10] * m[15] + 
-		m[1]  * m[11] * m[14] + 
-		m[9]  * m[2] * m[15] - 
-		m[9]  * m[3] * m[14] - 
-		m[13] * m[2] * m[11] + 
-		m[13] * m[3] * m[10];
-
-	inv[5] = m[0]  * m[10] * m[15] - 
-		m[0]  * m[11] * m[14] - 
-		m[8]  * m[2] * m[15] + 
-		m[8]  * m[3] * m[14] + 
-		m[12] * m[2] * m[11] - 
-		m[12] * m[3] * m[10];
-
-	inv[9] = -m[0]  * m[9] * m[15] + 
-		m[0]  * m[11] * m[13] + 
-		m[8]  * m[1] * m[15] - 
-		m[8]  * m[3] * m[13] - 
-		m[12] * m[1] * m[11] + 
-		m[12] * m[3] * m[9];
-
-	inv[13] = m[0]  * m[9] * m[14] - 
-		m[0]  * m[10] * m[13] - 
-		m[8]  * m[1] * m[14] + 
-		m[8]  * m[2] * m[13] + 
-		m[12] * m[1] * m[10] - 
-		m[12] * m[2] * m[9];
-
-	inv[2] = m[1]  * m[6] * m[15] - 
-		m[1]  * m[7] * m[14] - 
-		m[5]  * m[2] * m[15] + 
-		m[5]  * m[3] * m[14] + 
-		m[13] * m[2] * m[7] - 
-		m[13] * m[3] * m[6];
-
-	inv[6] = -m[0]  * m[6] * m[15] + 
-		m[0]  * m[7] * m[14] + 
-		m[4]  * m[2] * m[15] - 
-		m[4]  * m[3] * m[14] - 
-		m[12] * m[2] * m[7] + 
-		m[12] * m[3] * m[6];
-
-	inv[10] = m[0]  * m[5] * m[15] - 
-		m[0]  * m[7] * m[13] - 
-		m[4]  * m[1] * m[15] + 
-		m[4]  * m[3] * m[13] + 
-		m[12] * m[1] * m[7] - 
-		m[12] * m[3] * m[5];
-
-	inv[14] = -m[0]  * m[5] * m[14] + 
-		m[0]  * m[6] * m[13] + 
-		m[4]  * m[1] * m[14] - 
-		m[4]  * m[2] * m[13] - 
-		m[12] * m[1] * m[6] + 
-		m[12] * m[2] * m[5];
-
-	inv[3] = -m[1] * m[6] * m[11] + 
-		m[1] * m[7] * m[10] + 
-		m[5] * m[2] * m[11] - 
-		m[5] * m[3] * m[10] - 
-		m[9] * m[2] * m[7] + 
-		m[9] * m[3] * m[6];
-
-	inv[7] = m[0] * m[6] * m[11] - 
-		m[0] * m[7] * m[10] - 
-		m[4] * m[2] * m[11] + 
-		m[4] * m[3] * m[10] + 
-		m[8] * m[2] * m[7] - 
-		m[8] * m[3] * m[6];
-
-	inv[11] = -m[0] * m[5] * m[11] + 
-		m[0] * m[7] * m[9] + 
-		m[4] * m[1] * m[11] - 
-		m[4] * m[3] * m[9] - 
-		m[8] * m[1] * m[7] + 
-		m[8] * m[3] * m[5];
-
-	inv[15] = m[0] * m[5] * m[10] - 
-		m[0] * m[6] * m[9] - 
-		m[4] * m[1] * m[10] + 
-		m[4] * m[2] * m[9] + 
-		m[8] * m[1] * m[6] - 
-		m[8] * m[2] * m[5];
-
-	det = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
-	det = 1.0 / det;
-
-	float data[16];
-	for (i = 0; i < 16; i++) {
-		data[i] = (float)(inv[i] * det);
+//----------------------------------------------------------------------------------------------------------------
+void Matrix44::Invert() {
+	*this = GetInverse();
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Affine matrices (every model and view matrix) take the SIMD affine path, which is exact to float precision.
+// Anything with a projection in it stays on the double precision cofactor path: the float block inverse loses
+// about three digits on a view-projection with a 0.1 near plane and translations in the thousands.
+Matrix44 Matrix44::GetInverse() const {
+	if ( Iw == 0.f && Jw == 0.f && Kw == 0.f && Tw == 1.f ) {
+		return GetInverseAffine();
 	}
-	return Matrix44(data);
+
+	Matrix44 inverse;
+	InvertMatrix_Scalar( *this, &inverse );
+	return inverse;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+Matrix44 Matrix44::GetInverseAffine() const {
+	Matrix44 inverse;
+#if defined(ENGINE_DISABLE_SIMD)
+	InvertAffineMatrix_Scalar( *this, &inverse );
+#else
+	InvertAffineMatrix_SSE( *this, &inverse );
+#endif
+	return inverse;
 }
 
 
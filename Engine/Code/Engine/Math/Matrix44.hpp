@@ -15,6 +15,7 @@ public:
 	Matrix44 GetTranspose() const;
 	Matrix44 GetInverseFast() const;
 	Matrix44 GetInverse() const;
+	Matrix44 GetInverseAffine() const;		// Any matrix with a ( 0, 0, 0, 1 ) bottom row, scale and shear included
 
 	Vector2 TransformDisplacement2D( const Vector2& displacement );
 	Vector2 TransformPosition2D( const Vector2& point );
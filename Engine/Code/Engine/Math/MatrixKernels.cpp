@@ -0,0 +1,886 @@
+#include "Game/EngineBuildPreferences.hpp"
+#include "Engine/Math/MatrixKernels.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/DevConsole/DevConsole.hpp"
+#include "Engine/DevConsole/Command.hpp"
+
+#include <immintrin.h>
+#include <math.h>
+#include <vector>
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+	#define MATRIX_KERNEL_AVX_TARGET
+#else
+	#define MATRIX_KERNEL_AVX_TARGET __attribute__(( target( "avx" ) ))
+#endif
+
+
+//----------------------------------------------------------------------------------------------------------------
+// SSE helpers. Columns are loaded unaligned since nothing guarantees a Matrix44 sits on a 16 byte boundary.
+#define SHUFFLE_MASK( x, y, z, w ) ( (x) | ( (y) << 2 ) | ( (z) << 4 ) | ( (w) << 6 ) )
+#define SWIZZLE( vec, x, y, z, w ) _mm_shuffle_ps( vec, vec, SHUFFLE_MASK( x, y, z, w ) )
+#define SPLAT( vec, index ) _mm_shuffle_ps( vec, vec, SHUFFLE_MASK( index, index, index, index ) )
+
+
+static inline __m128 LoadColumn( const Matrix44& matrix, int column ) {
+	return _mm_loadu_ps( &matrix.Ix + ( column * 4 ) );
+}
+
+
+static inline void StoreColumn( Matrix44* matrix, int column, __m128 value ) {
+	_mm_storeu_ps( &matrix->Ix + ( column * 4 ), value );
+}
+
+
+static inline void StoreVector3( Vector3* out, __m128 value ) {
+	_mm_storel_pi( (__m64*) &out->x, value );
+	_mm_store_ss( &out->z, _mm_movehl_ps( value, value ) );
+}
+
+
+static inline const Vector3* OffsetVector3( const Vector3* base, int index, int stride ) {
+	return (const Vector3*) ( (const unsigned char*) base + ( (size_t) index * stride ) );
+}
+
+
+static inline Vector3* OffsetVector3( Vector3* base, int index, int stride ) {
+	return (Vector3*) ( (unsigned char*) base + ( (size_t) index * stride ) );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Output column c is the left matrix's columns weighted by the right matrix's column c
+static inline void MultiplyColumns( const __m128* left, const Matrix44& right, Matrix44* out ) {
+	__m128 result[4];
+	for ( int column = 0; column < 4; column++ ) {
+		__m128 rightColumn = LoadColumn( right, column );
+		__m128 sum = _mm_mul_ps( left[0], SPLAT( rightColumn, 0 ) );
+		sum = _mm_add_ps( sum, _mm_mul_ps( left[1], SPLAT( rightColumn, 1 ) ) );
+		sum = _mm_add_ps( sum, _mm_mul_ps( left[2], SPLAT( rightColumn, 2 ) ) );
+		sum = _mm_add_ps( sum, _mm_mul_ps( left[3], SPLAT( rightColumn, 3 ) ) );
+		result[ column ] = sum;
+	}
+
+	// Stored after all four are computed so out can alias right
+	for ( int column = 0; column < 4; column++ ) {
+		StoreColumn( out, column, result[ column ] );
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void MultiplyMatrix_Scalar( const Matrix44& leftSide, const Matrix44& rightSide, Matrix44* out ) {
+	Matrix44 result;
+
+	result.Ix = (leftSide.Ix * rightSide.Ix) + (leftSide.Jx * rightSide.Iy) + (leftSide.Kx * rightSide.Iz) + (leftSide.Tx * rightSide.Iw);
+	result.Iy = (leftSide.Iy * rightSide.Ix) + (leftSide.Jy * rightSide.Iy) + (leftSide.Ky * rightSide.Iz) + (leftSide.Ty * rightSide.Iw);
+	result.Iz = (leftSide.Iz * rightSide.Ix) + (leftSide.Jz * rightSide.Iy) + (leftSide.Kz * rightSide.Iz) + (leftSide.Tz * rightSide.Iw);
+	result.Iw = (leftSide.Iw * rightSide.Ix) + (leftSide.Jw * rightSide.Iy) + (leftSide.Kw * rightSide.Iz) + (leftSide.Tw * rightSide.Iw);
+	result.Jx = (leftSide.Ix * rightSide.Jx) + (leftSide.Jx * rightSide.Jy) + (leftSide.Kx * rightSide.Jz) + (leftSide.Tx * rightSide.Jw);
+	result.Jy = (leftSide.Iy * rightSide.Jx) + (leftSide.Jy * rightSide.Jy) + (leftSide.Ky * rightSide.Jz) + (leftSide.Ty * rightSide.Jw);
+	result.Jz = (leftSide.Iz * rightSide.Jx) + (leftSide.Jz * rightSide.Jy) + (leftSide.Kz * rightSide.Jz) + (leftSide.Tz * rightSide.Jw);
+	result.Jw = (leftSide.Iw * rightSide.Jx) + (leftSide.Jw * rightSide.Jy) + (leftSide.Kw * rightSide.Jz) + (leftSide.Tw * rightSide.Jw);
+	result.Kx = (leftSide.Ix * rightSide.Kx) + (leftSide.Jx * rightSide.Ky) + (leftSide.Kx * rightSide.Kz) + (leftSide.Tx * rightSide.Kw);
+	result.Ky = (leftSide.Iy * rightSide.Kx) + (leftSide.Jy * rightSide.Ky) + (leftSide.Ky * rightSide.Kz) + (leftSide.Ty * rightSide.Kw);
+	result.Kz = (leftSide.Iz * rightSide.Kx) + (leftSide.Jz * rightSide.Ky) + (leftSide.Kz * rightSide.Kz) + (leftSide.Tz * rightSide.Kw);
+	result.Kw = (leftSide.Iw * rightSide.Kx) + (leftSide.Jw * rightSide.Ky) + (leftSide.Kw * rightSide.Kz) + (leftSide.Tw * rightSide.Kw);
+	result.Tx = (leftSide.Ix * rightSide.Tx) + (leftSide.Jx * rightSide.Ty) + (leftSide.Kx * rightSide.Tz) + (leftSide.Tx * rightSide.Tw);
+	result.Ty = (leftSide.Iy * rightSide.Tx) + (leftSide.Jy * rightSide.Ty) + (leftSide.Ky * rightSide.Tz) + (leftSide.Ty * rightSide.Tw);
+	result.Tz = (leftSide.Iz * rightSide.Tx) + (leftSide.Jz * rightSide.Ty) + (leftSide.Kz * rightSide.Tz) + (leftSide.Tz * rightSide.Tw);
+	result.Tw = (leftSide.Iw * rightSide.Tx) + (leftSide.Jw * rightSide.Ty) + (leftSide.Kw * rightSide.Tz) + (leftSide.Tw * rightSide.Tw);
+
+	*out = result;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void MultiplyMatrix_SSE( const Matrix44& left, const Matrix44& right, Matrix44* out ) {
+	__m128 leftColumns[4] = { LoadColumn( left, 0 ), LoadColumn( left, 1 ), LoadColumn( left, 2 ), LoadColumn( left, 3 ) };
+	MultiplyColumns( leftColumns, right, out );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Lifted from GLU
+void InvertMatrix_Scalar( const Matrix44& matrix, Matrix44* out ) {
+	double inv[16];
+	double det;
+	double m[16];
+	unsigned int i;
+	const float* values = &matrix.Ix;
+	for (i = 0; i < 16; i++) {
+		m[i] = values[i];
+	}
+
+	inv[0] = m[5]  * m[10] * m[15] -
+		m[5]  * m[11] * m[14] -
+		m[9]  * m[6]  * m[15] +
+		m[9]  * m[7]  * m[14] +
+		m[13] * m[6]  * m[11] -
+		m[13] * m[7]  * m[10];
+
+	inv[4] = -m[4]  * m[10] * m[15] +
+		m[4]  * m[11] * m[14] +
+		m[8]  * m[6]  * m[15] -
+		m[8]  * m[7]  * m[14] -
+		m[12] * m[6]  * m[11] +
+		m[12] * m[7]  * m[10];
+
+	inv[8] = m[4]  * m[9] * m[15] -
+		m[4]  * m[11] * m[13] -
+		m[8]  * m[5] * m[15] +
+		m[8]  * m[7] * m[13] +
+		m[12] * m[5] * m[11] -
+		m[12] * m[7] * m[9];
+
+	inv[12] = -m[4]  * m[9] * m[14] +
+		m[4]  * m[10] * m[13] +
+		m[8]  * m[5] * m[14] -
+		m[8]  * m[6] * m[13] -
+		m[12] * m[5] * m[10] +
+		m[12] * m[6] * m[9];
+
+	inv[1] = -m[1]  * m[10] * m[15] +
+		m[1]  * m[11] * m[14] +
+		m[9]  * m[2] * m[15] -
+		m[9]  * m[3] * m[14] -
+		m[13] * m[2] * m[11] +
+		m[13] * m[3] * m[10];
+
+	inv[5] = m[0]  * m[10] * m[15] -
+		m[0]  * m[11] * m[14] -
+		m[8]  * m[2] * m[15] +
+		m[8]  * m[3] * m[14] +
+		m[12] * m[2] * m[11] -
+		m[12] * m[3] * m[10];
+
+	inv[9] = -m[0]  * m[9] * m[15] +
+		m[0]  * m[11] * m[13] +
+		m[8]  * m[1] * m[15] -
+		m[8]  * m[3] * m[13] -
+		m[12] * m[1] * m[11] +
+		m[12] * m[3] * m[9];
+
+	inv[13] = m[0]  * m[9] * m[14] -
+		m[0]  * m[10] * m[13] -
+		m[8]  * m[1] * m[14] +
+		m[8]  * m[2] * m[13] +
+		m[12] * m[1] * m[10] -
+		m[12] * m[2] * m[9];
+
+	inv[2] = m[1]  * m[6] * m[15] -
+		m[1]  * m[7] * m[14] -
+		m[5]  * m[2] * m[15] +
+		m[5]  * m[3] * m[14] +
+		m[13] * m[2] * m[7] -
+		m[13] * m[3] * m[6];
+
+	inv[6] = -m[0]  * m[6] * m[15] +
+		m[0]  * m[7] * m[14] +
+		m[4]  * m[2] * m[15] -
+		m[4]  * m[3] * m[14] -
+		m[12] * m[2] * m[7] +
+		m[12] * m[3] * m[6];
+
+	inv[10] = m[0]  * m[5] * m[15] -
+		m[0]  * m[7] * m[13] -
+		m[4]  * m[1] * m[15] +
+		m[4]  * m[3] * m[13] +
+		m[12] * m[1] * m[7] -
+		m[12] * m[3] * m[5];
+
+	inv[14] = -m[0]  * m[5] * m[14] +
+		m[0]  * m[6] * m[13] +
+		m[4]  * m[1] * m[14] -
+		m[4]  * m[2] * m[13] -
+		m[12] * m[1] * m[6] +
+		m[12] * m[2] * m[5];
+
+	inv[3] = -m[1] * m[6] * m[11] +
+		m[1] * m[7] * m[10] +
+		m[5] * m[2] * m[11] -
+		m[5] * m[3] * m[10] -
+		m[9] * m[2] * m[7] +
+		m[9] * m[3] * m[6];
+
+	inv[7] = m[0] * m[6] * m[11] -
+		m[0] * m[7] * m[10] -
+		m[4] * m[2] * m[11] +
+		m[4] * m[3] * m[10] +
+		m[8] * m[2] * m[7] -
+		m[8] * m[3] * m[6];
+
+	inv[11] = -m[0] * m[5] * m[11] +
+		m[0] * m[7] * m[9] +
+		m[4] * m[1] * m[11] -
+		m[4] * m[3] * m[9] -
+		m[8] * m[1] * m[7] +
+		m[8] * m[3] * m[5];
+
+	inv[15] = m[0] * m[5] * m[10] -
+		m[0] * m[6] * m[9] -
+		m[4] * m[1] * m[10] +
+		m[4] * m[2] * m[9] +
+		m[8] * m[1] * m[6] -
+		m[8] * m[2] * m[5];
+
+	det = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+	det = 1.0 / det;
+
+	float data[16];
+	for (i = 0; i < 16; i++) {
+		data[i] = (float)(inv[i] * det);
+	}
+	out->SetValues(data);
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// 2x2 helpers for the block inverse, each __m128 holds a 2x2 block as (m00, m01, m10, m11)
+static inline __m128 Mat2Multiply( __m128 a, __m128 b ) {
+	return _mm_add_ps( _mm_mul_ps( a, SWIZZLE( b, 0, 3, 0, 3 ) ), _mm_mul_ps( SWIZZLE( a, 1, 0, 3, 2 ), SWIZZLE( b, 2, 1, 2, 1 ) ) );
+}
+
+
+// adjugate( a ) * b
+static inline __m128 Mat2AdjugateMultiply( __m128 a, __m128 b ) {
+	return _mm_sub_ps( _mm_mul_ps( SWIZZLE( a, 3, 3, 0, 0 ), b ), _mm_mul_ps( SWIZZLE( a, 1, 1, 2, 2 ), SWIZZLE( b, 2, 3, 0, 1 ) ) );
+}
+
+
+// a * adjugate( b )
+static inline __m128 Mat2MultiplyAdjugate( __m128 a, __m128 b ) {
+	return _mm_sub_ps( _mm_mul_ps( a, SWIZZLE( b, 3, 0, 3, 0 ) ), _mm_mul_ps( SWIZZLE( a, 1, 0, 3, 2 ), SWIZZLE( b, 2, 1, 2, 1 ) ) );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Splits the matrix into four 2x2 blocks and builds the inverse from their adjugates and determinants. Inverting
+// the transpose gives the transpose of the inverse, so this works the same on columns as it would on rows.
+void InvertMatrix_SSE( const Matrix44& matrix, Matrix44* out ) {
+	__m128 column0 = LoadColumn( matrix, 0 );
+	__m128 column1 = LoadColumn( matrix, 1 );
+	__m128 column2 = LoadColumn( matrix, 2 );
+	__m128 column3 = LoadColumn( matrix, 3 );
+
+	__m128 a = _mm_movelh_ps( column0, column1 );
+	__m128 b = _mm_movehl_ps( column1, column0 );
+	__m128 c = _mm_movelh_ps( column2, column3 );
+	__m128 d = _mm_movehl_ps( column3, column2 );
+
+	// ( |A|, |B|, |C|, |D| )
+	__m128 subDeterminants = _mm_sub_ps(
+		_mm_mul_ps( _mm_shuffle_ps( column0, column2, SHUFFLE_MASK( 0, 2, 0, 2 ) ), _mm_shuffle_ps( column1, column3, SHUFFLE_MASK( 1, 3, 1, 3 ) ) ),
+		_mm_mul_ps( _mm_shuffle_ps( column0, column2, SHUFFLE_MASK( 1, 3, 1, 3 ) ), _mm_shuffle_ps( column1, column3, SHUFFLE_MASK( 0, 2, 0, 2 ) ) ) );
+	__m128 determinantA = SPLAT( subDeterminants, 0 );
+	__m128 determinantB = SPLAT( subDeterminants, 1 );
+	__m128 determinantC = SPLAT( subDeterminants, 2 );
+	__m128 determinantD = SPLAT( subDeterminants, 3 );
+
+	__m128 adjugateDC = Mat2AdjugateMultiply( d, c );
+	__m128 adjugateAB = Mat2AdjugateMultiply( a, b );
+	__m128 x = _mm_sub_ps( _mm_mul_ps( determinantD, a ), Mat2Multiply( b, adjugateDC ) );
+	__m128 w = _mm_sub_ps( _mm_mul_ps( determinantA, d ), Mat2Multiply( c, adjugateAB ) );
+	__m128 y = _mm_sub_ps( _mm_mul_ps( determinantB, c ), Mat2MultiplyAdjugate( d, adjugateAB ) );
+	__m128 z = _mm_sub_ps( _mm_mul_ps( determinantC, b ), Mat2MultiplyAdjugate( a, adjugateDC ) );
+
+	// |M| = |A||D| + |B||C| - trace( (A#B)(D#C) ), the trace summed without SSE3's horizontal add
+	__m128 trace = _mm_mul_ps( adjugateAB, SWIZZLE( adjugateDC, 0, 2, 1, 3 ) );
+	trace = _mm_add_ps( trace, _mm_movehl_ps( trace, trace ) );
+	trace = _mm_add_ss( trace, SPLAT( trace, 1 ) );
+	trace = SPLAT( trace, 0 );
+	__m128 determinant = _mm_add_ps( _mm_mul_ps( determinantA, determinantD ), _mm_mul_ps( determinantB, determinantC ) );
+	determinant = _mm_sub_ps( determinant, trace );
+
+	__m128 reciprocal = _mm_div_ps( _mm_setr_ps( 1.f, -1.f, -1.f, 1.f ), determinant );
+	x = _mm_mul_ps( x, reciprocal );
+	y = _mm_mul_ps( y, reciprocal );
+	z = _mm_mul_ps( z, reciprocal );
+	w = _mm_mul_ps( w, reciprocal );
+
+	StoreColumn( out, 0, _mm_shuffle_ps( x, y, SHUFFLE_MASK( 3, 1, 3, 1 ) ) );
+	StoreColumn( out, 1, _mm_shuffle_ps( x, y, SHUFFLE_MASK( 2, 0, 2, 0 ) ) );
+	StoreColumn( out, 2, _mm_shuffle_ps( z, w, SHUFFLE_MASK( 3, 1, 3, 1 ) ) );
+	StoreColumn( out, 3, _mm_shuffle_ps( z, w, SHUFFLE_MASK( 2, 0, 2, 0 ) ) );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// For columns a, b, c the rows of the 3x3 inverse are ( b x c, c x a, a x b ) / det, then T' = -( R' * T )
+void InvertAffineMatrix_Scalar( const Matrix44& matrix, Matrix44* out ) {
+	Vector3 i( matrix.Ix, matrix.Iy, matrix.Iz );
+	Vector3 j( matrix.Jx, matrix.Jy, matrix.Jz );
+	Vector3 k( matrix.Kx, matrix.Ky, matrix.Kz );
+	Vector3 t( matrix.Tx, matrix.Ty, matrix.Tz );
+
+	Vector3 row0 = Vector3::CrossProduct( j, k );
+	Vector3 row1 = Vector3::CrossProduct( k, i );
+	Vector3 row2 = Vector3::CrossProduct( i, j );
+	float inverseDeterminant = 1.f / DotProduct( i, row0 );
+	row0 = row0 * inverseDeterminant;
+	row1 = row1 * inverseDeterminant;
+	row2 = row2 * inverseDeterminant;
+
+	Matrix44 result;
+	result.Ix = row0.x;
+	result.Iy = row1.x;
+	result.Iz = row2.x;
+	result.Jx = row0.y;
+	result.Jy = row1.y;
+	result.Jz = row2.y;
+	result.Kx = row0.z;
+	result.Ky = row1.z;
+	result.Kz = row2.z;
+	result.Tx = -DotProduct( row0, t );
+	result.Ty = -DotProduct( row1, t );
+	result.Tz = -DotProduct( row2, t );
+
+	*out = result;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+static inline __m128 CrossProduct_SSE( __m128 a, __m128 b ) {
+	__m128 aYZX = SWIZZLE( a, 1, 2, 0, 3 );
+	__m128 bYZX = SWIZZLE( b, 1, 2, 0, 3 );
+	__m128 crossZXY = _mm_sub_ps( _mm_mul_ps( a, bYZX ), _mm_mul_ps( aYZX, b ) );
+	return SWIZZLE( crossZXY, 1, 2, 0, 3 );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void InvertAffineMatrix_SSE( const Matrix44& matrix, Matrix44* out ) {
+	__m128 w0Mask = _mm_castsi128_ps( _mm_setr_epi32( -1, -1, -1, 0 ) );
+	__m128 i = _mm_and_ps( LoadColumn( matrix, 0 ), w0Mask );
+	__m128 j = _mm_and_ps( LoadColumn( matrix, 1 ), w0Mask );
+	__m128 k = _mm_and_ps( LoadColumn( matrix, 2 ), w0Mask );
+	__m128 t = LoadColumn( matrix, 3 );
+
+	__m128 row0 = CrossProduct_SSE( j, k );
+	__m128 row1 = CrossProduct_SSE( k, i );
+	__m128 row2 = CrossProduct_SSE( i, j );
+
+	__m128 determinant = _mm_mul_ps( i, row0 );
+	determinant = _mm_add_ps( determinant, _mm_movehl_ps( determinant, determinant ) );
+	determinant = _mm_add_ss( determinant, SPLAT( determinant, 1 ) );
+	__m128 inverseDeterminant = _mm_div_ps( _mm_set1_ps( 1.f ), SPLAT( determinant, 0 ) );
+	row0 = _mm_mul_ps( row0, inverseDeterminant );
+	row1 = _mm_mul_ps( row1, inverseDeterminant );
+	row2 = _mm_mul_ps( row2, inverseDeterminant );
+
+	// The rows, transposed into columns. The fourth row is zero, which leaves the w of each column at 0.
+	__m128 row3 = _mm_setzero_ps();
+	_MM_TRANSPOSE4_PS( row0, row1, row2, row3 );
+
+	__m128 translation = _mm_mul_ps( row0, SPLAT( t, 0 ) );
+	translation = _mm_add_ps( translation, _mm_mul_ps( row1, SPLAT( t, 1 ) ) );
+	translation = _mm_add_ps( translation, _mm_mul_ps( row2, SPLAT( t, 2 ) ) );
+	translation = _mm_sub_ps( _mm_setr_ps( 0.f, 0.f, 0.f, 1.f ), translation );
+
+	StoreColumn( out, 0, row0 );
+	StoreColumn( out, 1, row1 );
+	StoreColumn( out, 2, row2 );
+	StoreColumn( out, 3, translation );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+Vector3 TransformPosition_Scalar( const Matrix44& transform, const Vector3& point ) {
+	float transformedX = (point.x * transform.Ix) + (point.y * transform.Jx) + (point.z * transform.Kx) + transform.Tx;
+	float transformedY = (point.x * transform.Iy) + (point.y * transform.Jy) + (point.z * transform.Ky) + transform.Ty;
+	float transformedZ = (point.x * transform.Iz) + (point.y * transform.Jz) + (point.z * transform.Kz) + transform.Tz;
+
+	return Vector3( transformedX, transformedY, transformedZ );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+Vector3 TransformPosition_SSE( const Matrix44& transform, const Vector3& position ) {
+	__m128 result = _mm_mul_ps( LoadColumn( transform, 0 ), _mm_set1_ps( position.x ) );
+	result = _mm_add_ps( result, _mm_mul_ps( LoadColumn( transform, 1 ), _mm_set1_ps( position.y ) ) );
+	result = _mm_add_ps( result, _mm_mul_ps( LoadColumn( transform, 2 ), _mm_set1_ps( position.z ) ) );
+	result = _mm_add_ps( result, LoadColumn( transform, 3 ) );
+
+	Vector3 transformed;
+	StoreVector3( &transformed, result );
+	return transformed;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void TransformPositions_Scalar( const Matrix44& transform, const Vector3* positions, Vector3* outPositions, int count, int stride ) {
+	for ( int index = 0; index < count; index++ ) {
+		*OffsetVector3( outPositions, index, stride ) = TransformPosition_Scalar( transform, *OffsetVector3( positions, index, stride ) );
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void TransformPositions_SSE( const Matrix44& transform, const Vector3* positions, Vector3* outPositions, int count, int stride ) {
+	__m128 i = LoadColumn( transform, 0 );
+	__m128 j = LoadColumn( transform, 1 );
+	__m128 k = LoadColumn( transform, 2 );
+	__m128 t = LoadColumn( transform, 3 );
+
+	for ( int index = 0; index < count; index++ ) {
+		const Vector3* position = OffsetVector3( positions, index, stride );
+		__m128 result = _mm_mul_ps( i, _mm_set1_ps( position->x ) );
+		result = _mm_add_ps( result, _mm_mul_ps( j, _mm_set1_ps( position->y ) ) );
+		result = _mm_add_ps( result, _mm_mul_ps( k, _mm_set1_ps( position->z ) ) );
+		result = _mm_add_ps( result, t );
+		StoreVector3( OffsetVector3( outPositions, index, stride ), result );
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void TransformDirections_Scalar( const Matrix44& transform, const Vector3* directions, Vector3* outDirections, int count, int stride ) {
+	for ( int index = 0; index < count; index++ ) {
+		*OffsetVector3( outDirections, index, stride ) = transform.TransformDirection( *OffsetVector3( directions, index, stride ) );
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void TransformDirections_SSE( const Matrix44& transform, const Vector3* directions, Vector3* outDirections, int count, int stride ) {
+	__m128 i = LoadColumn( transform, 0 );
+	__m128 j = LoadColumn( transform, 1 );
+	__m128 k = LoadColumn( transform, 2 );
+
+	for ( int index = 0; index < count; index++ ) {
+		const Vector3* direction = OffsetVector3( directions, index, stride );
+		__m128 result = _mm_mul_ps( i, _mm_set1_ps( direction->x ) );
+		result = _mm_add_ps( result, _mm_mul_ps( j, _mm_set1_ps( direction->y ) ) );
+		result = _mm_add_ps( result, _mm_mul_ps( k, _mm_set1_ps( direction->z ) ) );
+		StoreVector3( OffsetVector3( outDirections, index, stride ), result );
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void MultiplyMatrices_Scalar( const Matrix44* left, const Matrix44* right, Matrix44* out, int count ) {
+	for ( int index = 0; index < count; index++ ) {
+		MultiplyMatrix_Scalar( left[ index ], right[ index ], &out[ index ] );
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void MultiplyMatrices_SSE( const Matrix44* left, const Matrix44* right, Matrix44* out, int count ) {
+	for ( int index = 0; index < count; index++ ) {
+		MultiplyMatrix_SSE( left[ index ], right[ index ], &out[ index ] );
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Two output columns per 256 bit register: each left column is broadcast into both halves, and an in-lane
+// permute of two adjacent right columns gives ( right[c][k] x4, right[c+1][k] x4 ).
+MATRIX_KERNEL_AVX_TARGET void MultiplyMatrices_AVX( const Matrix44* left, const Matrix44* right, Matrix44* out, int count ) {
+	for ( int index = 0; index < count; index++ ) {
+		const float* leftValues = &left[ index ].Ix;
+		const float* rightValues = &right[ index ].Ix;
+
+		__m256 left0 = _mm256_broadcast_ps( (const __m128*) ( leftValues ) );
+		__m256 left1 = _mm256_broadcast_ps( (const __m128*) ( leftValues + 4 ) );
+		__m256 left2 = _mm256_broadcast_ps( (const __m128*) ( leftValues + 8 ) );
+		__m256 left3 = _mm256_broadcast_ps( (const __m128*) ( leftValues + 12 ) );
+
+		__m256 rightIJ = _mm256_loadu_ps( rightValues );
+		__m256 rightKT = _mm256_loadu_ps( rightValues + 8 );
+
+		__m256 resultIJ = _mm256_mul_ps( left0, _mm256_permute_ps( rightIJ, SHUFFLE_MASK( 0, 0, 0, 0 ) ) );
+		resultIJ = _mm256_add_ps( resultIJ, _mm256_mul_ps( left1, _mm256_permute_ps( rightIJ, SHUFFLE_MASK( 1, 1, 1, 1 ) ) ) );
+		resultIJ = _mm256_add_ps( resultIJ, _mm256_mul_ps( left2, _mm256_permute_ps( rightIJ, SHUFFLE_MASK( 2, 2, 2, 2 ) ) ) );
+		resultIJ = _mm256_add_ps( resultIJ, _mm256_mul_ps( left3, _mm256_permute_ps( rightIJ, SHUFFLE_MASK( 3, 3, 3, 3 ) ) ) );
+
+		__m256 resultKT = _mm256_mul_ps( left0, _mm256_permute_ps( rightKT, SHUFFLE_MASK( 0, 0, 0, 0 ) ) );
+		resultKT = _mm256_add_ps( resultKT, _mm256_mul_ps( left1, _mm256_permute_ps( rightKT, SHUFFLE_MASK( 1, 1, 1, 1 ) ) ) );
+		resultKT = _mm256_add_ps( resultKT, _mm256_mul_ps( left2, _mm256_permute_ps( rightKT, SHUFFLE_MASK( 2, 2, 2, 2 ) ) ) );
+		resultKT = _mm256_add_ps( resultKT, _mm256_mul_ps( left3, _mm256_permute_ps( rightKT, SHUFFLE_MASK( 3, 3, 3, 3 ) ) ) );
+
+		float* outValues = &out[ index ].Ix;
+		_mm256_storeu_ps( outValues, resultIJ );
+		_mm256_storeu_ps( outValues + 8, resultKT );
+	}
+	_mm256_zeroupper();
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Needs both the CPU flag and the OS saving the upper halves of the registers on context switches
+static bool DetectAVXSupport() {
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid( info, 1 );
+	bool hasAVX = ( info[2] & ( 1 << 28 ) ) != 0;
+	bool hasOSXSave = ( info[2] & ( 1 << 27 ) ) != 0;
+	return hasAVX && hasOSXSave && ( _xgetbv( 0 ) & 6 ) == 6;
+#else
+	return __builtin_cpu_supports( "avx" ) != 0;
+#endif
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Called from job workers too, the function-local static is initialized exactly once
+bool IsAVXSupported() {
+	static const bool s_isSupported = DetectAVXSupport();
+	return s_isSupported;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void TransformPositions( const Matrix44& transform, const Vector3* positions, Vector3* outPositions, int count, int stride /* = sizeof( Vector3 ) */ ) {
+#if defined(ENGINE_DISABLE_SIMD)
+	TransformPositions_Scalar( transform, positions, outPositions, count, stride );
+#else
+	TransformPositions_SSE( transform, positions, outPositions, count, stride );
+#endif
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void TransformDirections( const Matrix44& transform, const Vector3* directions, Vector3* outDirections, int count, int stride /* = sizeof( Vector3 ) */ ) {
+#if defined(ENGINE_DISABLE_SIMD)
+	TransformDirections_Scalar( transform, directions, outDirections, count, stride );
+#else
+	TransformDirections_SSE( transform, directions, outDirections, count, stride );
+#endif
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void MultiplyMatrices( const Matrix44* left, const Matrix44* right, Matrix44* out, int count ) {
+#if defined(ENGINE_DISABLE_SIMD)
+	MultiplyMatrices_Scalar( left, right, out, count );
+#else
+	if ( IsAVXSupported() ) {
+		MultiplyMatrices_AVX( left, right, out, count );
+	} else {
+		MultiplyMatrices_SSE( left, right, out, count );
+	}
+#endif
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void MultiplyMatrices( const Matrix44& left, const Matrix44* right, Matrix44* out, int count ) {
+#if defined(ENGINE_DISABLE_SIMD)
+	for ( int index = 0; index < count; index++ ) {
+		MultiplyMatrix_Scalar( left, right[ index ], &out[ index ] );
+	}
+#else
+	__m128 leftColumns[4] = { LoadColumn( left, 0 ), LoadColumn( left, 1 ), LoadColumn( left, 2 ), LoadColumn( left, 3 ) };
+	for ( int index = 0; index < count; index++ ) {
+		MultiplyColumns( leftColumns, right[ index ], &out[ index ] );
+	}
+#endif
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void MatrixKernelsStartup() {
+	CommandRegistration::RegisterCommand( "math_test", MatrixKernelTestCommand, "[count] - Checks the SIMD matrix kernels against the scalar ones" );
+	CommandRegistration::RegisterCommand( "math_bench", MatrixKernelBenchmarkCommand, "[count] - Times the scalar and SIMD matrix kernels" );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Rotation, non-uniform scale and translation, the kind of matrix Transform produces
+static Matrix44 MakeRandomAffineMatrix( float translationRange = 1000.f ) {
+	Matrix44 matrix = Matrix44::MakeRotationDegrees( Vector3( GetRandomFloatInRange( -180.f, 180.f ), GetRandomFloatInRange( -180.f, 180.f ), GetRandomFloatInRange( -180.f, 180.f ) ) );
+	matrix.Append( Matrix44::MakeScale( Vector3( GetRandomFloatInRange( 0.25f, 4.f ), GetRandomFloatInRange( 0.25f, 4.f ), GetRandomFloatInRange( 0.25f, 4.f ) ) ) );
+	matrix.Tx = GetRandomFloatInRange( -translationRange, translationRange );
+	matrix.Ty = GetRandomFloatInRange( -translationRange, translationRange );
+	matrix.Tz = GetRandomFloatInRange( -translationRange, translationRange );
+	return matrix;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// An affine matrix pushed through a perspective projection, so the bottom row is not ( 0, 0, 0, 1 )
+static Matrix44 MakeRandomProjectiveMatrix( float translationRange = 1000.f ) {
+	Matrix44 matrix = Matrix44::MakeProjection( GetRandomFloatInRange( 30.f, 120.f ), GetRandomFloatInRange( 1.f, 2.f ), 0.1f, 1000.f );
+	matrix.Append( MakeRandomAffineMatrix( translationRange ) );
+	return matrix;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Relative to the largest value in the expected matrix. Float inverses of matrices with big translations and a
+// projection lose digits in the small entries, per-entry relative error would flag that as a failure when it's
+// just float precision.
+static float GetMatrixError( const Matrix44& actual, const Matrix44& expected ) {
+	const float* actualValues = &actual.Ix;
+	const float* expectedValues = &expected.Ix;
+	float scale = 1.f;
+	for ( int index = 0; index < 16; index++ ) {
+		scale = Max( scale, fabsf( expectedValues[ index ] ) );
+	}
+
+	float maxError = 0.f;
+	for ( int index = 0; index < 16; index++ ) {
+		maxError = Max( maxError, fabsf( actualValues[ index ] - expectedValues[ index ] ) / scale );
+	}
+	return maxError;
+}
+
+
+static float GetVectorError( const Vector3& actual, const Vector3& expected ) {
+	float error = fabsf( actual.x - expected.x ) / Max( 1.f, fabsf( expected.x ) );
+	error = Max( error, fabsf( actual.y - expected.y ) / Max( 1.f, fabsf( expected.y ) ) );
+	error = Max( error, fabsf( actual.z - expected.z ) / Max( 1.f, fabsf( expected.z ) ) );
+	return error;
+}
+
+
+static void PrintTestResult( const char* name, float maxError ) {
+	bool passed = maxError <= MATRIX_KERNEL_TEST_EPSILON;
+	DevConsole::Printf( passed ? Rgba( 0, 255, 0, 255 ) : Rgba( 255, 0, 0, 255 ), "  %-22s max error %.3g %s", name, maxError, passed ? "ok" : "FAILED" );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+static int GetCountArgument( const std::string& command, int defaultCount ) {
+	Command parsed( command );
+	int argument = 0;
+	if ( parsed.PeekNextInt( argument ) && parsed.GetNextInt( argument ) && argument > 0 ) {
+		return argument;
+	}
+	return defaultCount;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void MatrixKernelTestCommand( const std::string& command ) {
+	int count = GetCountArgument( command, 10000 );
+	DevConsole::Printf( "math_test: %d random matrices, epsilon %g", count, MATRIX_KERNEL_TEST_EPSILON );
+
+	// The float block inverse is only checked on projective matrices with small translations, see
+	// Matrix44::GetInverse for why the large ones stay on the double path
+	std::vector<Matrix44> affine( count );
+	std::vector<Matrix44> projective( count );
+	std::vector<Matrix44> nearProjective( count );
+	std::vector<Vector3> points( count );
+	for ( int index = 0; index < count; index++ ) {
+		affine[ index ] = MakeRandomAffineMatrix();
+		projective[ index ] = MakeRandomProjectiveMatrix();
+		nearProjective[ index ] = MakeRandomProjectiveMatrix( 10.f );
+		points[ index ] = Vector3( GetRandomFloatInRange( -100.f, 100.f ), GetRandomFloatInRange( -100.f, 100.f ), GetRandomFloatInRange( -100.f, 100.f ) );
+	}
+
+	float multiplyError = 0.f;
+	float inverseError = 0.f;
+	float affineInverseError = 0.f;
+	float positionError = 0.f;
+	for ( int index = 0; index < count; index++ ) {
+		const Matrix44& other = affine[ ( index + 1 ) % count ];
+		Matrix44 expected;
+		Matrix44 actual;
+
+		MultiplyMatrix_Scalar( projective[ index ], other, &expected );
+		MultiplyMatrix_SSE( projective[ index ], other, &actual );
+		multiplyError = Max( multiplyError, GetMatrixError( actual, expected ) );
+
+		InvertMatrix_Scalar( nearProjective[ index ], &expected );
+		InvertMatrix_SSE( nearProjective[ index ], &actual );
+		inverseError = Max( inverseError, GetMatrixError( actual, expected ) );
+
+		InvertAffineMatrix_SSE( affine[ index ], &actual );
+		InvertMatrix_Scalar( affine[ index ], &expected );
+		affineInverseError = Max( affineInverseError, GetMatrixError( actual, expected ) );
+		InvertAffineMatrix_Scalar( affine[ index ], &actual );
+		affineInverseError = Max( affineInverseError, GetMatrixError( actual, expected ) );
+
+		Vector3 expectedPosition = TransformPosition_Scalar( affine[ index ], points[ index ] );
+		positionError = Max( positionError, GetVectorError( TransformPosition_SSE( affine[ index ], points[ index ] ), expectedPosition ) );
+	}
+
+	PrintTestResult( "multiply", multiplyError );
+	PrintTestResult( "inverse", inverseError );
+	PrintTestResult( "affine inverse", affineInverseError );
+	PrintTestResult( "transform position", positionError );
+
+	// Batches, checked against the single scalar kernels
+	std::vector<Vector3> expectedPoints( count );
+	std::vector<Vector3> actualPoints( count );
+	TransformPositions_Scalar( affine[0], points.data(), expectedPoints.data(), count, sizeof( Vector3 ) );
+	TransformPositions_SSE( affine[0], points.data(), actualPoints.data(), count, sizeof( Vector3 ) );
+	float batchPositionError = 0.f;
+	for ( int index = 0; index < count; index++ ) {
+		batchPositionError = Max( batchPositionError, GetVectorError( actualPoints[ index ], expectedPoints[ index ] ) );
+	}
+	PrintTestResult( "transform positions", batchPositionError );
+
+	TransformDirections_Scalar( affine[0], points.data(), expectedPoints.data(), count, sizeof( Vector3 ) );
+	TransformDirections_SSE( affine[0], points.data(), actualPoints.data(), count, sizeof( Vector3 ) );
+	float batchDirectionError = 0.f;
+	for ( int index = 0; index < count; index++ ) {
+		batchDirectionError = Max( batchDirectionError, GetVectorError( actualPoints[ index ], expectedPoints[ index ] ) );
+	}
+	PrintTestResult( "transform directions", batchDirectionError );
+
+	std::vector<Matrix44> expectedMatrices( count );
+	std::vector<Matrix44> actualMatrices( count );
+	MultiplyMatrices_Scalar( projective.data(), affine.data(), expectedMatrices.data(), count );
+	MultiplyMatrices_SSE( projective.data(), affine.data(), actualMatrices.data(), count );
+	float batchMultiplyError = 0.f;
+	for ( int index = 0; index < count; index++ ) {
+		batchMultiplyError = Max( batchMultiplyError, GetMatrixError( actualMatrices[ index ], expectedMatrices[ index ] ) );
+	}
+	PrintTestResult( "multiply matrices sse", batchMultiplyError );
+
+	if ( IsAVXSupported() ) {
+		MultiplyMatrices_AVX( projective.data(), affine.data(), actualMatrices.data(), count );
+		batchMultiplyError = 0.f;
+		for ( int index = 0; index < count; index++ ) {
+			batchMultiplyError = Max( batchMultiplyError, GetMatrixError( actualMatrices[ index ], expectedMatrices[ index ] ) );
+		}
+		PrintTestResult( "multiply matrices avx", batchMultiplyError );
+	} else {
+		DevConsole::Printf( "  multiply matrices avx  skipped, no AVX on this CPU" );
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+static void PrintBenchmarkResult( const char* name, int count, uint64_t scalarTime, uint64_t simdTime ) {
+	double scalarSeconds = PerformanceCountToSeconds( scalarTime );
+	double simdSeconds = PerformanceCountToSeconds( simdTime );
+	DevConsole::Printf( "  %-22s scalar %7.2f ns  simd %7.2f ns  %5.2fx", name
+		, ( scalarSeconds * 1000000000.0 ) / (double) count
+		, ( simdSeconds * 1000000000.0 ) / (double) count
+		, scalarSeconds / Max( simdSeconds, 0.000000001 ) );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Each kernel runs over the same arrays scalar first, then SIMD. Results are folded into a checksum that gets
+// printed so the optimizer can't drop the loops.
+void MatrixKernelBenchmarkCommand( const std::string& command ) {
+	int count = GetCountArgument( command, 100000 );
+	DevConsole::Printf( "math_bench: %d elements per kernel, AVX %s", count, IsAVXSupported() ? "available" : "unavailable" );
+
+	std::vector<Matrix44> left( count );
+	std::vector<Matrix44> right( count );
+	std::vector<Matrix44> results( count );
+	std::vector<Vector3> points( count );
+	std::vector<Vector3> transformedPoints( count );
+	for ( int index = 0; index < count; index++ ) {
+		left[ index ] = MakeRandomProjectiveMatrix();
+		right[ index ] = MakeRandomAffineMatrix();
+		points[ index ] = Vector3( GetRandomFloatInRange( -100.f, 100.f ), GetRandomFloatInRange( -100.f, 100.f ), GetRandomFloatInRange( -100.f, 100.f ) );
+	}
+
+	float checksum = 0.f;
+	uint64_t start;
+	uint64_t scalarTime;
+	uint64_t simdTime;
+
+	start = GetPerformanceCount();
+	for ( int index = 0; index < count; index++ ) {
+		MultiplyMatrix_Scalar( left[ index ], right[ index ], &results[ index ] );
+	}
+	scalarTime = GetPerformanceCount() - start;
+	checksum += results[ count - 1 ].Tx;
+	start = GetPerformanceCount();
+	for ( int index = 0; index < count; index++ ) {
+		MultiplyMatrix_SSE( left[ index ], right[ index ], &results[ index ] );
+	}
+	simdTime = GetPerformanceCount() - start;
+	checksum += results[ count - 1 ].Tx;
+	PrintBenchmarkResult( "multiply", count, scalarTime, simdTime );
+
+	start = GetPerformanceCount();
+	for ( int index = 0; index < count; index++ ) {
+		InvertMatrix_Scalar( left[ index ], &results[ index ] );
+	}
+	scalarTime = GetPerformanceCount() - start;
+	checksum += results[ count - 1 ].Tx;
+	start = GetPerformanceCount();
+	for ( int index = 0; index < count; index++ ) {
+		InvertMatrix_SSE( left[ index ], &results[ index ] );
+	}
+	simdTime = GetPerformanceCount() - start;
+	checksum += results[ count - 1 ].Tx;
+	PrintBenchmarkResult( "inverse", count, scalarTime, simdTime );
+
+	start = GetPerformanceCount();
+	for ( int index = 0; index < count; index++ ) {
+		InvertAffineMatrix_Scalar( right[ index ], &results[ index ] );
+	}
+	scalarTime = GetPerformanceCount() - start;
+	checksum += results[ count - 1 ].Tx;
+	start = GetPerformanceCount();
+	for ( int index = 0; index < count; index++ ) {
+		InvertAffineMatrix_SSE( right[ index ], &results[ index ] );
+	}
+	simdTime = GetPerformanceCount() - start;
+	checksum += results[ count - 1 ].Tx;
+	PrintBenchmarkResult( "affine inverse", count, scalarTime, simdTime );
+
+	start = GetPerformanceCount();
+	for ( int index = 0; index < count; index++ ) {
+		transformedPoints[ index ] = TransformPosition_Scalar( right[ index ], points[ index ] );
+	}
+	scalarTime = GetPerformanceCount() - start;
+	checksum += transformedPoints[ count - 1 ].x;
+	start = GetPerformanceCount();
+	for ( int index = 0; index < count; index++ ) {
+		transformedPoints[ index ] = TransformPosition_SSE( right[ index ], points[ index ] );
+	}
+	simdTime = GetPerformanceCount() - start;
+	checksum += transformedPoints[ count - 1 ].x;
+	PrintBenchmarkResult( "transform position", count, scalarTime, simdTime );
+
+	start = GetPerformanceCount();
+	TransformPositions_Scalar( right[0], points.data(), transformedPoints.data(), count, sizeof( Vector3 ) );
+	scalarTime = GetPerformanceCount() - start;
+	checksum += transformedPoints[ count - 1 ].x;
+	start = GetPerformanceCount();
+	TransformPositions_SSE( right[0], points.data(), transformedPoints.data(), count, sizeof( Vector3 ) );
+	simdTime = GetPerformanceCount() - start;
+	checksum += transformedPoints[ count - 1 ].x;
+	PrintBenchmarkResult( "transform positions", count, scalarTime, simdTime );
+
+	start = GetPerformanceCount();
+	TransformDirections_Scalar( right[0], points.data(), transformedPoints.data(), count, sizeof( Vector3 ) );
+	scalarTime = GetPerformanceCount() - start;
+	checksum += transformedPoints[ count - 1 ].x;
+	start = GetPerformanceCount();
+	TransformDirections_SSE( right[0], points.data(), transformedPoints.data(), count, sizeof( Vector3 ) );
+	simdTime = GetPerformanceCount() - start;
+	checksum += transformedPoints[ count - 1 ].x;
+	PrintBenchmarkResult( "transform directions", count, scalarTime, simdTime );
+
+	start = GetPerformanceCount();
+	MultiplyMatrices_Scalar( left.data(), right.data(), results.data(), count );
+	scalarTime = GetPerformanceCount() - start;
+	checksum += results[ count - 1 ].Tx;
+	start = GetPerformanceCount();
+	MultiplyMatrices_SSE( left.data(), right.data(), results.data(), count );
+	simdTime = GetPerformanceCount() - start;
+	checksum += results[ count - 1 ].Tx;
+	PrintBenchmarkResult( "multiply matrices sse", count, scalarTime, simdTime );
+
+	if ( IsAVXSupported() ) {
+		start = GetPerformanceCount();
+		MultiplyMatrices_AVX( left.data(), right.data(), results.data(), count );
+		simdTime = GetPerformanceCount() - start;
+		checksum += results[ count - 1 ].Tx;
+		PrintBenchmarkResult( "multiply matrices avx", count, scalarTime, simdTime );
+	}
+
+	start = GetPerformanceCount();
+	for ( int index = 0; index < count; index++ ) {
+		results[ index ] = Matrix44::MakeRotationDegrees( points[ index ] );
+	}
+	simdTime = GetPerformanceCount() - start;
+	checksum += results[ count - 1 ].Ix;
+	DevConsole::Printf( "  %-22s %7.2f ns", "make rotation", ( PerformanceCountToSeconds( simdTime ) * 1000000000.0 ) / (double) count );
+
+	DevConsole::Printf( "  checksum %f", checksum );
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "Engine/Math/Matrix44.hpp"
+
+#include <string>
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Scalar and SIMD versions of the Matrix44 hot paths. Matrix44::Append, TransformPosition, the affine inverses
+// and the batch functions below call the SSE versions unless the game defines ENGINE_DISABLE_SIMD in its
+// EngineBuildPreferences.hpp. MultiplyMatrices also uses AVX when the CPU reports it. Every version is always compiled so math_test can check the SIMD results
+// against the scalar ones, and math_bench can time them side by side.
+//
+// Matrix44 is column major (I, J, K, T), so each basis vector is one unaligned 128 bit load.
+#define MATRIX_KERNEL_TEST_EPSILON 0.0001f
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Batch API, what callers should use. Strides are in bytes and apply to both the input and output arrays, so
+// positions can be transformed in place inside an array of vertices.
+void TransformPositions( const Matrix44& transform, const Vector3* positions, Vector3* outPositions, int count, int stride = sizeof( Vector3 ) );
+void TransformDirections( const Matrix44& transform, const Vector3* directions, Vector3* outDirections, int count, int stride = sizeof( Vector3 ) );
+
+// out[i] = left[i] * right[i]
+void MultiplyMatrices( const Matrix44* left, const Matrix44* right, Matrix44* out, int count );
+
+// out[i] = left * right[i], e.g. one parent or view-projection against many model matrices
+void MultiplyMatrices( const Matrix44& left, const Matrix44* right, Matrix44* out, int count );
+
+bool IsAVXSupported();
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Individual kernels. out may alias an input.
+void MultiplyMatrix_Scalar( const Matrix44& left, const Matrix44& right, Matrix44* out );
+void MultiplyMatrix_SSE( const Matrix44& left, const Matrix44& right, Matrix44* out );
+
+void InvertMatrix_Scalar( const Matrix44& matrix, Matrix44* out );				// Cofactors in doubles
+void InvertMatrix_SSE( const Matrix44& matrix, Matrix44* out );					// 2x2 block method in floats, for well conditioned matrices
+
+// Inverse of a matrix with a (0, 0, 0, 1) bottom row. Handles scale and shear, unlike GetInverseFast.
+void InvertAffineMatrix_Scalar( const Matrix44& matrix, Matrix44* out );
+void InvertAffineMatrix_SSE( const Matrix44& matrix, Matrix44* out );
+
+Vector3 TransformPosition_Scalar( const Matrix44& transform, const Vector3& position );
+Vector3 TransformPosition_SSE( const Matrix44& transform, const Vector3& position );
+
+void TransformPositions_Scalar( const Matrix44& transform, const Vector3* positions, Vector3* outPositions, int count, int stride );
+void TransformPositions_SSE( const Matrix44& transform, const Vector3* positions, Vector3* outPositions, int count, int stride );
+void TransformDirections_Scalar( const Matrix44& transform, const Vector3* directions, Vector3* outDirections, int count, int stride );
+void TransformDirections_SSE( const Matrix44& transform, const Vector3* directions, Vector3* outDirections, int count, int stride );
+
+void MultiplyMatrices_Scalar( const Matrix44* left, const Matrix44* right, Matrix44* out, int count );
+void MultiplyMatrices_SSE( const Matrix44* left, const Matrix44* right, Matrix44* out, int count );
+void MultiplyMatrices_AVX( const Matrix44* left, const Matrix44* right, Matrix44* out, int count );		// Only call if IsAVXSupported
+
+
+//----------------------------------------------------------------------------------------------------------------
+void MatrixKernelsStartup();
+void MatrixKernelTestCommand( const std::string& command );
+void MatrixKernelBenchmarkCommand( const std::string& command );
@@ -0,0 +1,127 @@
+//-----------------------------------------------------------------------------------------------
+// NoiseSIMD.hpp
+//
+// Internal to RawNoise.cpp, SmoothNoise.cpp and the engine tests. SSE2 and AVX2 versions of
+//	SquirrelNoise4, so the batch noise functions can hash 4 or 8 lattice points at once. Every kernel
+//	here must give the exact same bits as the scalar version; no FMA, same operation order.
+//
+#pragma once
+
+
+//-----------------------------------------------------------------------------------------------
+// Widest kernel the batch functions may use. They default to the best the CPU supports; tests lower
+//	the limit to check each path against the scalar functions.
+//
+enum eNoisePath
+{
+	NOISE_PATH_SCALAR = 0,
+	NOISE_PATH_SSE2,
+	NOISE_PATH_AVX2
+};
+
+void SetNoisePathLimit( eNoisePath limit );
+eNoisePath GetNoisePath();
+
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define NOISE_SIMD_ENABLED
+#endif
+
+#if defined(NOISE_SIMD_ENABLED)
+
+#include <immintrin.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define NOISE_AVX2_FUNCTION
+#else
+#include <cpuid.h>
+#define NOISE_AVX2_FUNCTION __attribute__((target("avx2")))
+#endif
+
+
+#define NOISE_BIT_NOISE1 0xD2A80A23
+#define NOISE_BIT_NOISE2 0xA884F197
+#define NOISE_BIT_NOISE3 0x1B56C4E9
+
+
+//-----------------------------------------------------------------------------------------------
+// AVX2 needs both the CPU and the OS (saving ymm state) to agree.
+//
+inline bool DetectNoiseAVX2Support()
+{
+	bool isSupported = false;
+#if defined(_MSC_VER)
+	int info[ 4 ];
+	__cpuid( info, 1 );
+	bool hasOSXSave = (info[ 2 ] & (1 << 27)) != 0;
+	bool hasAVX = (info[ 2 ] & (1 << 28)) != 0;
+	if( hasOSXSave && hasAVX && (_xgetbv( 0 ) & 0x6) == 0x6 )
+	{
+		__cpuidex( info, 7, 0 );
+		isSupported = (info[ 1 ] & (1 << 5)) != 0;
+	}
+#else
+	unsigned int eax, ebx, ecx, edx;
+	if( __get_cpuid( 1, &eax, &ebx, &ecx, &edx ) && (ecx & (1 << 27)) && (ecx & (1 << 28)) )
+	{
+		unsigned int xcrLow, xcrHigh;
+		__asm__( "xgetbv" : "=a"( xcrLow ), "=d"( xcrHigh ) : "c"( 0 ) );
+		if( (xcrLow & 0x6) == 0x6 && __get_cpuid_count( 7, 0, &eax, &ebx, &ecx, &edx ) )
+			isSupported = (ebx & (1 << 5)) != 0;
+	}
+#endif
+	return isSupported;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Checked once; job system workers call this concurrently, and a function-local static is
+//	initialized exactly once even then.
+//
+inline bool IsNoiseAVX2Supported()
+{
+	static const bool s_isSupported = DetectNoiseAVX2Support();
+	return s_isSupported;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// SSE2 has no 32-bit low multiply (that's SSE4.1), so build it from two 32x32->64 multiplies
+//
+inline __m128i MultiplyLowInt32x4( __m128i a, __m128i b )
+{
+	__m128i evens = _mm_mul_epu32( a, b );
+	__m128i odds = _mm_mul_epu32( _mm_srli_epi64( a, 32 ), _mm_srli_epi64( b, 32 ) );
+	return _mm_unpacklo_epi32( _mm_shuffle_epi32( evens, _MM_SHUFFLE( 0, 0, 2, 0 ) ), _mm_shuffle_epi32( odds, _MM_SHUFFLE( 0, 0, 2, 0 ) ) );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+inline __m128i Get1dNoiseUintx4( __m128i positions, __m128i seed )
+{
+	__m128i mangledBits = MultiplyLowInt32x4( positions, _mm_set1_epi32( (int) NOISE_BIT_NOISE1 ) );
+	mangledBits = _mm_add_epi32( mangledBits, seed );
+	mangledBits = _mm_xor_si128( mangledBits, _mm_srli_epi32( mangledBits, 7 ) );
+	mangledBits = _mm_add_epi32( mangledBits, _mm_set1_epi32( (int) NOISE_BIT_NOISE2 ) );
+	mangledBits = _mm_xor_si128( mangledBits, _mm_srli_epi32( mangledBits, 8 ) );
+	mangledBits = MultiplyLowInt32x4( mangledBits, _mm_set1_epi32( (int) NOISE_BIT_NOISE3 ) );
+	mangledBits = _mm_xor_si128( mangledBits, _mm_srli_epi32( mangledBits, 11 ) );
+	return mangledBits;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+NOISE_AVX2_FUNCTION inline __m256i Get1dNoiseUintx8( __m256i positions, __m256i seed )
+{
+	__m256i mangledBits = _mm256_mullo_epi32( positions, _mm256_set1_epi32( (int) NOISE_BIT_NOISE1 ) );
+	mangledBits = _mm256_add_epi32( mangledBits, seed );
+	mangledBits = _mm256_xor_si256( mangledBits, _mm256_srli_epi32( mangledBits, 7 ) );
+	mangledBits = _mm256_add_epi32( mangledBits, _mm256_set1_epi32( (int) NOISE_BIT_NOISE2 ) );
+	mangledBits = _mm256_xor_si256( mangledBits, _mm256_srli_epi32( mangledBits, 8 ) );
+	mangledBits = _mm256_mullo_epi32( mangledBits, _mm256_set1_epi32( (int) NOISE_BIT_NOISE3 ) );
+	mangledBits = _mm256_xor_si256( mangledBits, _mm256_srli_epi32( mangledBits, 11 ) );
+	return mangledBits;
+}
+
+#endif
@@ -6,6 +6,7 @@
 class Plane {
 
 public:
+	Plane() : normal( 0.f, 0.f, 0.f ), distance( 0.f ) {}
 	Plane( const Vector3& pos1, const Vector3& pos2, const Vector3& pos3 );
 	Plane( const Vector3& norm, float dist );
 
@@ -18,6 +19,6 @@ public:
 
 public:
 	Vector3 normal;
-	float distance;
+	float distance = 0.f;
 
 };
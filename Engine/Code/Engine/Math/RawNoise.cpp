@@ -2,6 +2,40 @@
 // RawNoise.cpp
 //
 #include "Engine/Math/RawNoise.hpp"
+#include "Engine/Math/NoiseSIMD.hpp"
+
+#include <atomic>
+
+// The SIMD kernels promise the scalar version's exact bits, so nothing here may be fused into an FMA
+#if defined(_MSC_VER)
+#pragma fp_contract( off )
+#elif defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#endif
+
+
+static std::atomic<int> s_noisePathLimit( NOISE_PATH_AVX2 );
+
+
+//-----------------------------------------------------------------------------------------------
+void SetNoisePathLimit( eNoisePath limit )
+{
+	s_noisePathLimit.store( (int) limit );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+eNoisePath GetNoisePath()
+{
+	int limit = s_noisePathLimit.load();
+#if defined(NOISE_SIMD_ENABLED)
+	int supported = IsNoiseAVX2Supported() ? NOISE_PATH_AVX2 : NOISE_PATH_SSE2;
+#else
+	int supported = NOISE_PATH_SCALAR;
+#endif
+	return (eNoisePath) ((limit < supported) ? limit : supported);
+}
+
 
 
 //-----------------------------------------------------------------------------------------------
@@ -34,3 +68,68 @@ unsigned int Get1dNoiseUint( int positionX, unsigned int seed )
 }
 
 
+#if defined(NOISE_SIMD_ENABLED)
+//-----------------------------------------------------------------------------------------------
+NOISE_AVX2_FUNCTION static int Get1dNoiseUintRowAVX2( int startIndex, int count, unsigned int* out_values, unsigned int seed )
+{
+	const __m256i laneOffsets = _mm256_setr_epi32( 0, 1, 2, 3, 4, 5, 6, 7 );
+	const __m256i seeds = _mm256_set1_epi32( (int) seed );
+
+	int index = 0;
+	for( ; index + 8 <= count; index += 8 )
+	{
+		__m256i positions = _mm256_add_epi32( _mm256_set1_epi32( (int) ((unsigned int) startIndex + (unsigned int) index) ), laneOffsets );
+		_mm256_storeu_si256( (__m256i*) (out_values + index), Get1dNoiseUintx8( positions, seeds ) );
+	}
+	return index;
+}
+#endif
+
+
+//-----------------------------------------------------------------------------------------------
+// Indices wrap like the scalar version does, so the row may cross INT_MAX safely
+//
+void Get1dNoiseUintRow( int startIndex, int count, unsigned int* out_values, unsigned int seed )
+{
+	int index = 0;
+
+#if defined(NOISE_SIMD_ENABLED)
+	eNoisePath path = GetNoisePath();
+	if( path == NOISE_PATH_AVX2 )
+	{
+		index = Get1dNoiseUintRowAVX2( startIndex, count, out_values, seed );
+	}
+	else if( path == NOISE_PATH_SSE2 )
+	{
+		const __m128i laneOffsets = _mm_setr_epi32( 0, 1, 2, 3 );
+		const __m128i seeds = _mm_set1_epi32( (int) seed );
+		for( ; index + 4 <= count; index += 4 )
+		{
+			__m128i positions = _mm_add_epi32( _mm_set1_epi32( (int) ((unsigned int) startIndex + (unsigned int) index) ), laneOffsets );
+			_mm_storeu_si128( (__m128i*) (out_values + index), Get1dNoiseUintx4( positions, seeds ) );
+		}
+	}
+#endif
+
+	for( ; index < count; ++ index )
+	{
+		out_values[ index ] = Get1dNoiseUint( (int) ((unsigned int) startIndex + (unsigned int) index), seed );
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Get2dNoiseUint folds (x,y) to x + (PRIME * y), so each row of the grid is one contiguous 1D row
+//
+void Get2dNoiseUintGrid( int startX, int startY, int width, int height, unsigned int* out_values, unsigned int seed )
+{
+	const unsigned int PRIME_NUMBER = 198491317;
+
+	for( int row = 0; row < height; ++ row )
+	{
+		unsigned int indexY = (unsigned int) startY + (unsigned int) row;
+		int rowStart = (int) ((unsigned int) startX + (PRIME_NUMBER * indexY));
+		Get1dNoiseUintRow( rowStart, width, out_values + (row * width), seed );
+	}
+}
+
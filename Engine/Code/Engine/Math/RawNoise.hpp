@@ -60,6 +60,13 @@ float Get2dNoiseNegOneToOne( int indexX, int indexY, unsigned int seed=0 );
 float Get3dNoiseNegOneToOne( int indexX, int indexY, int indexZ, unsigned int seed=0 );
 float Get4dNoiseNegOneToOne( int indexX, int indexY, int indexZ, int indexT, unsigned int seed=0 );
 
+//-----------------------------------------------------------------------------------------------
+// Batch versions: hash a row of consecutive indices (or a grid of rows) in one call.  Uses
+//	SSE2/AVX2 where available; results are bit-identical to calling the functions above per index.
+//
+void Get1dNoiseUintRow( int startIndex, int count, unsigned int* out_values, unsigned int seed=0 );
+void Get2dNoiseUintGrid( int startX, int startY, int width, int height, unsigned int* out_values, unsigned int seed=0 );
+
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 // Simple functions inlined below
@@ -2,11 +2,20 @@
 // SmoothNoise.cpp
 //
 #include "Engine/Math/RawNoise.hpp"
+#include "Engine/Math/NoiseSIMD.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Math/Vector2.hpp"
 #include "Engine/Math/Vector3.hpp"
 //#include "Engine/Math/Vector4.hpp"
 #include <math.h>
+#include <vector>
+
+// The SIMD kernels promise the scalar version's exact bits, so nothing here may be fused into an FMA
+#if defined(_MSC_VER)
+#pragma fp_contract( off )
+#elif defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#endif
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 // For all fractal (and Perlin) noise functions, the following internal naming conventions
@@ -450,6 +459,311 @@ float Compute2dPerlinNoise( float posX, float posY, float scale, unsigned int nu
 }
 
 
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Batch 2D Perlin noise
+//
+// The SIMD kernels below are line-for-line copies of Compute2dPerlinNoise, one lane per sample.
+//	Keep the operation order identical to the scalar version (and never use FMA) so every lane
+//	produces exactly the same bits; anything that doesn't fill a full vector goes through the
+//	scalar function.
+/////////////////////////////////////////////////////////////////////////////////////////////////
+struct PerlinBatchParams_T
+{
+	float invScale;
+	unsigned int numOctaves;
+	float octavePersistence;
+	float octaveScale;
+	bool renormalize;
+	unsigned int seed;
+};
+
+
+#if defined(NOISE_SIMD_ENABLED)
+//-----------------------------------------------------------------------------------------------
+inline __m128 SmoothStep3x4( __m128 t )
+{
+	const __m128 one = _mm_set1_ps( 1.f );
+	__m128 oneMinusT = _mm_sub_ps( one, t );
+	__m128 smoothStart = _mm_mul_ps( _mm_mul_ps( t, t ), t );
+	__m128 smoothStop = _mm_sub_ps( one, _mm_mul_ps( _mm_mul_ps( oneMinusT, oneMinusT ), oneMinusT ) );
+	return _mm_add_ps( _mm_mul_ps( oneMinusT, smoothStart ), _mm_mul_ps( t, smoothStop ) );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// No variable permute in SSE2, so build the 8 gradients from the low 3 bits instead of a table.
+//	Components are always (+/-0.9238, +/-0.3827) or (+/-0.3827, +/-0.9238).
+//
+inline void Get2dPerlinGradientx4( __m128i noise, __m128& out_gradientX, __m128& out_gradientY )
+{
+	const __m128i oneBit = _mm_set1_epi32( 1 );
+	const __m128 major = _mm_set1_ps( 0.923879533f );
+	const __m128 minor = _mm_set1_ps( 0.382683432f );
+
+	__m128i bit0 = _mm_and_si128( noise, oneBit );
+	__m128i bit1 = _mm_and_si128( _mm_srli_epi32( noise, 1 ), oneBit );
+	__m128i bit2 = _mm_and_si128( _mm_srli_epi32( noise, 2 ), oneBit );
+
+	__m128 isMajorX = _mm_castsi128_ps( _mm_cmpeq_epi32( bit0, bit1 ) );
+	__m128 magnitudeX = _mm_or_ps( _mm_and_ps( isMajorX, major ), _mm_andnot_ps( isMajorX, minor ) );
+	__m128 magnitudeY = _mm_or_ps( _mm_andnot_ps( isMajorX, major ), _mm_and_ps( isMajorX, minor ) );
+	__m128 signX = _mm_castsi128_ps( _mm_slli_epi32( _mm_xor_si128( bit1, bit2 ), 31 ) );
+	__m128 signY = _mm_castsi128_ps( _mm_slli_epi32( bit2, 31 ) );
+
+	out_gradientX = _mm_xor_ps( magnitudeX, signX );
+	out_gradientY = _mm_xor_ps( magnitudeY, signY );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// SSE2 has no floor, so truncate and step down where truncation rounded up.  OR-ing in the
+//	input's sign keeps floorf's -0 for -0 inputs.  Valid while |position| < 2^31, same as the
+//	(int) cast in the scalar version.
+//
+inline __m128 Floorx4( __m128 values, __m128i& out_indices )
+{
+	__m128i truncated = _mm_cvttps_epi32( values );
+	__m128 truncatedFloats = _mm_cvtepi32_ps( truncated );
+	__m128 wasRoundedUp = _mm_cmpgt_ps( truncatedFloats, values );
+	__m128 floored = _mm_sub_ps( truncatedFloats, _mm_and_ps( wasRoundedUp, _mm_set1_ps( 1.f ) ) );
+
+	out_indices = _mm_add_epi32( truncated, _mm_castps_si128( wasRoundedUp ) );
+	return _mm_or_ps( floored, _mm_and_ps( values, _mm_set1_ps( -0.f ) ) );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static void Compute2dPerlinNoiseSSE2( const float* positionsX, const float* positionsY, float* out_values, const PerlinBatchParams_T& params )
+{
+	const float OCTAVE_OFFSET = 0.636764989593174f;
+	const float PERLIN_2D_NORMALIZER = 1.f / 0.662578106f;
+	const int PRIME_NUMBER = 198491317;
+	const __m128 one = _mm_set1_ps( 1.f );
+
+	float totalAmplitude = 0.f;
+	float currentAmplitude = 1.f;
+	unsigned int seed = params.seed;
+	__m128 totalNoise = _mm_setzero_ps();
+	__m128 currentX = _mm_mul_ps( _mm_loadu_ps( positionsX ), _mm_set1_ps( params.invScale ) );
+	__m128 currentY = _mm_mul_ps( _mm_loadu_ps( positionsY ), _mm_set1_ps( params.invScale ) );
+
+	for( unsigned int octaveNum = 0; octaveNum < params.numOctaves; ++ octaveNum )
+	{
+		__m128i indexWestX;
+		__m128i indexSouthY;
+		__m128 cellMinsX = Floorx4( currentX, indexWestX );
+		__m128 cellMinsY = Floorx4( currentY, indexSouthY );
+		__m128 cellMaxsX = _mm_add_ps( cellMinsX, one );
+		__m128 cellMaxsY = _mm_add_ps( cellMinsY, one );
+
+		// Get2dNoiseUint( x, y ) hashes x + (PRIME * y), so the other corners are offsets from SW
+		__m128i seeds = _mm_set1_epi32( (int) seed );
+		__m128i indexSW = _mm_add_epi32( indexWestX, MultiplyLowInt32x4( indexSouthY, _mm_set1_epi32( PRIME_NUMBER ) ) );
+		__m128i indexSE = _mm_add_epi32( indexSW, _mm_set1_epi32( 1 ) );
+		__m128i indexNW = _mm_add_epi32( indexSW, _mm_set1_epi32( PRIME_NUMBER ) );
+		__m128i indexNE = _mm_add_epi32( indexNW, _mm_set1_epi32( 1 ) );
+
+		__m128 gradientSWX, gradientSWY, gradientSEX, gradientSEY, gradientNWX, gradientNWY, gradientNEX, gradientNEY;
+		Get2dPerlinGradientx4( Get1dNoiseUintx4( indexSW, seeds ), gradientSWX, gradientSWY );
+		Get2dPerlinGradientx4( Get1dNoiseUintx4( indexSE, seeds ), gradientSEX, gradientSEY );
+		Get2dPerlinGradientx4( Get1dNoiseUintx4( indexNW, seeds ), gradientNWX, gradientNWY );
+		Get2dPerlinGradientx4( Get1dNoiseUintx4( indexNE, seeds ), gradientNEX, gradientNEY );
+
+		__m128 displacementWestX = _mm_sub_ps( currentX, cellMinsX );
+		__m128 displacementEastX = _mm_sub_ps( currentX, cellMaxsX );
+		__m128 displacementSouthY = _mm_sub_ps( currentY, cellMinsY );
+		__m128 displacementNorthY = _mm_sub_ps( currentY, cellMaxsY );
+
+		__m128 dotSouthWest = _mm_add_ps( _mm_mul_ps( gradientSWX, displacementWestX ), _mm_mul_ps( gradientSWY, displacementSouthY ) );
+		__m128 dotSouthEast = _mm_add_ps( _mm_mul_ps( gradientSEX, displacementEastX ), _mm_mul_ps( gradientSEY, displacementSouthY ) );
+		__m128 dotNorthWest = _mm_add_ps( _mm_mul_ps( gradientNWX, displacementWestX ), _mm_mul_ps( gradientNWY, displacementNorthY ) );
+		__m128 dotNorthEast = _mm_add_ps( _mm_mul_ps( gradientNEX, displacementEastX ), _mm_mul_ps( gradientNEY, displacementNorthY ) );
+
+		__m128 weightEast = SmoothStep3x4( displacementWestX );
+		__m128 weightNorth = SmoothStep3x4( displacementSouthY );
+		__m128 weightWest = _mm_sub_ps( one, weightEast );
+		__m128 weightSouth = _mm_sub_ps( one, weightNorth );
+
+		__m128 blendSouth = _mm_add_ps( _mm_mul_ps( weightEast, dotSouthEast ), _mm_mul_ps( weightWest, dotSouthWest ) );
+		__m128 blendNorth = _mm_add_ps( _mm_mul_ps( weightEast, dotNorthEast ), _mm_mul_ps( weightWest, dotNorthWest ) );
+		__m128 blendTotal = _mm_add_ps( _mm_mul_ps( weightSouth, blendSouth ), _mm_mul_ps( weightNorth, blendNorth ) );
+		__m128 noiseThisOctave = _mm_mul_ps( blendTotal, _mm_set1_ps( PERLIN_2D_NORMALIZER ) );
+
+		totalNoise = _mm_add_ps( totalNoise, _mm_mul_ps( noiseThisOctave, _mm_set1_ps( currentAmplitude ) ) );
+		totalAmplitude += currentAmplitude;
+		currentAmplitude *= params.octavePersistence;
+		currentX = _mm_add_ps( _mm_mul_ps( currentX, _mm_set1_ps( params.octaveScale ) ), _mm_set1_ps( OCTAVE_OFFSET ) );
+		currentY = _mm_add_ps( _mm_mul_ps( currentY, _mm_set1_ps( params.octaveScale ) ), _mm_set1_ps( OCTAVE_OFFSET ) );
+		++ seed;
+	}
+
+	if( params.renormalize && totalAmplitude > 0.f )
+	{
+		totalNoise = _mm_div_ps( totalNoise, _mm_set1_ps( totalAmplitude ) );
+		totalNoise = _mm_add_ps( _mm_mul_ps( totalNoise, _mm_set1_ps( 0.5f ) ), _mm_set1_ps( 0.5f ) );
+		totalNoise = SmoothStep3x4( totalNoise );
+		totalNoise = _mm_sub_ps( _mm_mul_ps( totalNoise, _mm_set1_ps( 2.f ) ), one );
+	}
+
+	_mm_storeu_ps( out_values, totalNoise );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+NOISE_AVX2_FUNCTION inline __m256 SmoothStep3x8( __m256 t )
+{
+	const __m256 one = _mm256_set1_ps( 1.f );
+	__m256 oneMinusT = _mm256_sub_ps( one, t );
+	__m256 smoothStart = _mm256_mul_ps( _mm256_mul_ps( t, t ), t );
+	__m256 smoothStop = _mm256_sub_ps( one, _mm256_mul_ps( _mm256_mul_ps( oneMinusT, oneMinusT ), oneMinusT ) );
+	return _mm256_add_ps( _mm256_mul_ps( oneMinusT, smoothStart ), _mm256_mul_ps( t, smoothStop ) );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// AVX2 can index the gradient table directly with a lane permute
+//
+NOISE_AVX2_FUNCTION static void Compute2dPerlinNoiseAVX2( const float* positionsX, const float* positionsY, float* out_values, const PerlinBatchParams_T& params )
+{
+	const float OCTAVE_OFFSET = 0.636764989593174f;
+	const float PERLIN_2D_NORMALIZER = 1.f / 0.662578106f;
+	const int PRIME_NUMBER = 198491317;
+	const __m256 one = _mm256_set1_ps( 1.f );
+	const __m256 gradientTableX = _mm256_setr_ps( +0.923879533f, +0.382683432f, -0.382683432f, -0.923879533f, -0.923879533f, -0.382683432f, +0.382683432f, +0.923879533f );
+	const __m256 gradientTableY = _mm256_setr_ps( +0.382683432f, +0.923879533f, +0.923879533f, +0.382683432f, -0.382683432f, -0.923879533f, -0.923879533f, -0.382683432f );
+
+	float totalAmplitude = 0.f;
+	float currentAmplitude = 1.f;
+	unsigned int seed = params.seed;
+	__m256 totalNoise = _mm256_setzero_ps();
+	__m256 currentX = _mm256_mul_ps( _mm256_loadu_ps( positionsX ), _mm256_set1_ps( params.invScale ) );
+	__m256 currentY = _mm256_mul_ps( _mm256_loadu_ps( positionsY ), _mm256_set1_ps( params.invScale ) );
+
+	for( unsigned int octaveNum = 0; octaveNum < params.numOctaves; ++ octaveNum )
+	{
+		__m256 cellMinsX = _mm256_floor_ps( currentX );
+		__m256 cellMinsY = _mm256_floor_ps( currentY );
+		__m256 cellMaxsX = _mm256_add_ps( cellMinsX, one );
+		__m256 cellMaxsY = _mm256_add_ps( cellMinsY, one );
+		__m256i indexWestX = _mm256_cvttps_epi32( cellMinsX );
+		__m256i indexSouthY = _mm256_cvttps_epi32( cellMinsY );
+
+		__m256i seeds = _mm256_set1_epi32( (int) seed );
+		__m256i indexSW = _mm256_add_epi32( indexWestX, _mm256_mullo_epi32( indexSouthY, _mm256_set1_epi32( PRIME_NUMBER ) ) );
+		__m256i indexSE = _mm256_add_epi32( indexSW, _mm256_set1_epi32( 1 ) );
+		__m256i indexNW = _mm256_add_epi32( indexSW, _mm256_set1_epi32( PRIME_NUMBER ) );
+		__m256i indexNE = _mm256_add_epi32( indexNW, _mm256_set1_epi32( 1 ) );
+
+		// permutevar only reads the low 3 bits of each index, which is the & 7 in the scalar version
+		__m256i noiseSW = Get1dNoiseUintx8( indexSW, seeds );
+		__m256i noiseSE = Get1dNoiseUintx8( indexSE, seeds );
+		__m256i noiseNW = Get1dNoiseUintx8( indexNW, seeds );
+		__m256i noiseNE = Get1dNoiseUintx8( indexNE, seeds );
+
+		__m256 displacementWestX = _mm256_sub_ps( currentX, cellMinsX );
+		__m256 displacementEastX = _mm256_sub_ps( currentX, cellMaxsX );
+		__m256 displacementSouthY = _mm256_sub_ps( currentY, cellMinsY );
+		__m256 displacementNorthY = _mm256_sub_ps( currentY, cellMaxsY );
+
+		__m256 dotSouthWest = _mm256_add_ps( _mm256_mul_ps( _mm256_permutevar8x32_ps( gradientTableX, noiseSW ), displacementWestX ), _mm256_mul_ps( _mm256_permutevar8x32_ps( gradientTableY, noiseSW ), displacementSouthY ) );
+		__m256 dotSouthEast = _mm256_add_ps( _mm256_mul_ps( _mm256_permutevar8x32_ps( gradientTableX, noiseSE ), displacementEastX ), _mm256_mul_ps( _mm256_permutevar8x32_ps( gradientTableY, noiseSE ), displacementSouthY ) );
+		__m256 dotNorthWest = _mm256_add_ps( _mm256_mul_ps( _mm256_permutevar8x32_ps( gradientTableX, noiseNW ), displacementWestX ), _mm256_mul_ps( _mm256_permutevar8x32_ps( gradientTableY, noiseNW ), displacementNorthY ) );
+		__m256 dotNorthEast = _mm256_add_ps( _mm256_mul_ps( _mm256_permutevar8x32_ps( gradientTableX, noiseNE ), displacementEastX ), _mm256_mul_ps( _mm256_permutevar8x32_ps( gradientTableY, noiseNE ), displacementNorthY ) );
+
+		__m256 weightEast = SmoothStep3x8( displacementWestX );
+		__m256 weightNorth = SmoothStep3x8( displacementSouthY );
+		__m256 weightWest = _mm256_sub_ps( one, weightEast );
+		__m256 weightSouth = _mm256_sub_ps( one, weightNorth );
+
+		__m256 blendSouth = _mm256_add_ps( _mm256_mul_ps( weightEast, dotSouthEast ), _mm256_mul_ps( weightWest, dotSouthWest ) );
+		__m256 blendNorth = _mm256_add_ps( _mm256_mul_ps( weightEast, dotNorthEast ), _mm256_mul_ps( weightWest, dotNorthWest ) );
+		__m256 blendTotal = _mm256_add_ps( _mm256_mul_ps( weightSouth, blendSouth ), _mm256_mul_ps( weightNorth, blendNorth ) );
+		__m256 noiseThisOctave = _mm256_mul_ps( blendTotal, _mm256_set1_ps( PERLIN_2D_NORMALIZER ) );
+
+		totalNoise = _mm256_add_ps( totalNoise, _mm256_mul_ps( noiseThisOctave, _mm256_set1_ps( currentAmplitude ) ) );
+		totalAmplitude += currentAmplitude;
+		currentAmplitude *= params.octavePersistence;
+		currentX = _mm256_add_ps( _mm256_mul_ps( currentX, _mm256_set1_ps( params.octaveScale ) ), _mm256_set1_ps( OCTAVE_OFFSET ) );
+		currentY = _mm256_add_ps( _mm256_mul_ps( currentY, _mm256_set1_ps( params.octaveScale ) ), _mm256_set1_ps( OCTAVE_OFFSET ) );
+		++ seed;
+	}
+
+	if( params.renormalize && totalAmplitude > 0.f )
+	{
+		totalNoise = _mm256_div_ps( totalNoise, _mm256_set1_ps( totalAmplitude ) );
+		totalNoise = _mm256_add_ps( _mm256_mul_ps( totalNoise, _mm256_set1_ps( 0.5f ) ), _mm256_set1_ps( 0.5f ) );
+		totalNoise = SmoothStep3x8( totalNoise );
+		totalNoise = _mm256_sub_ps( _mm256_mul_ps( totalNoise, _mm256_set1_ps( 2.f ) ), one );
+	}
+
+	_mm256_storeu_ps( out_values, totalNoise );
+}
+#endif
+
+
+//-----------------------------------------------------------------------------------------------
+void Compute2dPerlinNoiseBatch( const float* positionsX, const float* positionsY, int count, float* out_values, float scale, unsigned int numOctaves, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed )
+{
+	int index = 0;
+
+#if defined(NOISE_SIMD_ENABLED)
+	PerlinBatchParams_T params;
+	params.invScale = (1.f / scale);
+	params.numOctaves = numOctaves;
+	params.octavePersistence = octavePersistence;
+	params.octaveScale = octaveScale;
+	params.renormalize = renormalize;
+	params.seed = seed;
+
+	eNoisePath path = GetNoisePath();
+	if( path == NOISE_PATH_AVX2 )
+	{
+		for( ; index + 8 <= count; index += 8 )
+		{
+			Compute2dPerlinNoiseAVX2( positionsX + index, positionsY + index, out_values + index, params );
+		}
+	}
+
+	if( path >= NOISE_PATH_SSE2 )
+	{
+		for( ; index + 4 <= count; index += 4 )
+		{
+			Compute2dPerlinNoiseSSE2( positionsX + index, positionsY + index, out_values + index, params );
+		}
+	}
+#endif
+
+	for( ; index < count; ++ index )
+	{
+		out_values[ index ] = Compute2dPerlinNoise( positionsX[ index ], positionsY[ index ], scale, numOctaves, octavePersistence, octaveScale, renormalize, seed );
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void Compute2dPerlinNoiseGrid( const Vector2& origin, const Vector2& step, int width, int height, float* out_values, float scale, unsigned int numOctaves, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed )
+{
+	std::vector<float> rowX( width );
+	std::vector<float> rowY( width );
+
+	for( int column = 0; column < width; ++ column )
+	{
+		rowX[ column ] = origin.x + ((float) column * step.x);
+	}
+
+	for( int row = 0; row < height; ++ row )
+	{
+		float positionY = origin.y + ((float) row * step.y);
+		for( int column = 0; column < width; ++ column )
+		{
+			rowY[ column ] = positionY;
+		}
+
+		Compute2dPerlinNoiseBatch( rowX.data(), rowY.data(), width, out_values + (row * width), scale, numOctaves, octavePersistence, octaveScale, renormalize, seed );
+	}
+}
+
+
 //-----------------------------------------------------------------------------------------------
 // Perlin noise is fractal noise with "gradient vector smoothing" applied.
 //
@@ -3,6 +3,8 @@
 //
 #pragma once
 
+class Vector2;
+
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 // Squirrel's Smooth Noise utilities (version 4)
@@ -75,6 +77,17 @@ float Compute3dPerlinNoise( float posX, float posY, float posZ, float scale=1.f,
 float Compute4dPerlinNoise( float posX, float posY, float posZ, float posT, float scale=1.f, unsigned int numOctaves=1, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
 
 
+//-----------------------------------------------------------------------------------------------
+// Batch Perlin noise (SSE2/AVX2 where available)
+//
+// Same parameters and bit-identical results as Compute2dPerlinNoise, evaluated 4 or 8 samples at
+//	a time.  Batch takes separate X and Y position arrays; Grid samples (origin + column*step.x,
+//	origin + row*step.y) and writes row-major into <out_values>, which must hold width*height floats.
+//
+void Compute2dPerlinNoiseBatch( const float* positionsX, const float* positionsY, int count, float* out_values, float scale=1.f, unsigned int numOctaves=1, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
+void Compute2dPerlinNoiseGrid( const Vector2& origin, const Vector2& step, int width, int height, float* out_values, float scale=1.f, unsigned int numOctaves=1, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
+
+
 //-----------------------------------------------------------------------------------------------
 // Simplex noise functions (random-access / deterministic)
 //
@@ -99,7 +99,7 @@ NetAddress_T NetAddress_T::GetLocal( unsigned int serviceNumber ) {
 	addrinfo* result = nullptr;
 	int status = ::getaddrinfo( myName, service, &hints, &result ); // Find address info for my own host name
 	if (status != 0) {
-		Logger::PrintTaggedf("Net", "failed to find address for \\[%s:%s]. Error\\[%s]", myName, service, ::gai_strerror(status) );
+		LOG_TAGGEDF("Net", "failed to find address for \\[%s:%s]. Error\\[%s]", myName, service, ::gai_strerror(status) );
 	}
 
 	// Result is a linked list of addresses that the search found. Iterate through and print the addresses
@@ -149,7 +149,7 @@ void GetAddressExample( std::string const& command ) {
 	addrinfo* result = nullptr;
 	int status = ::getaddrinfo( myName, service, &hints, &result ); // Find address info for my own host name
 	if (status != 0) {
-		Logger::PrintTaggedf("Net", "failed to find address for \\[%s:%s]. Error\\[%s]", myName, service, ::gai_strerror(status) );
+		LOG_TAGGEDF("Net", "failed to find address for \\[%s:%s]. Error\\[%s]", myName, service, ::gai_strerror(status) );
 	}
 
 	// Result is a linked list of addresses that the search found. Iterate through and print the addresses
@@ -0,0 +1,139 @@
+#include "Engine/Net/NetAllocator.hpp"
+#include "Engine/DevConsole/DevConsole.hpp"
+
+#include <new>
+
+
+struct NetFreeSlot_T {
+	NetFreeSlot_T* next;
+};
+
+
+struct NetSizeClass_T {
+	size_t size = 0;
+	NetFreeSlot_T* freeList = nullptr;
+};
+
+
+static NetSizeClass_T s_sizeClasses[ NET_ALLOCATOR_MAX_SIZE_CLASSES ];
+static int s_heapAllocationCount = 0;
+static int s_liveAllocationCount = 0;
+static int s_liveBufferCount = 0;
+static int s_heapAllocationCountAtLastPrint = 0;
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Sizes are rounded up to a pointer so every slot can hold the free list link
+static size_t GetSlotSize( size_t size ) {
+	size_t alignment = sizeof(void*);
+	return (size + alignment - 1) & ~(alignment - 1);
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+static NetSizeClass_T* FindOrAddSizeClass( size_t slotSize ) {
+	for ( int i = 0; i < NET_ALLOCATOR_MAX_SIZE_CLASSES; i++ ) {
+		if ( s_sizeClasses[i].size == slotSize ) {
+			return &s_sizeClasses[i];
+		}
+		if ( s_sizeClasses[i].size == 0 ) {
+			s_sizeClasses[i].size = slotSize;
+			return &s_sizeClasses[i];
+		}
+	}
+	return nullptr;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void* NetAllocator::Allocate( size_t size ) {
+	s_liveAllocationCount++;
+
+	size_t slotSize = GetSlotSize( size );
+	NetSizeClass_T* sizeClass = FindOrAddSizeClass( slotSize );
+	if ( sizeClass == nullptr ) {
+		s_heapAllocationCount++;
+		return ::operator new( size );
+	}
+
+	if ( sizeClass->freeList == nullptr ) {
+		s_heapAllocationCount++;
+		char* chunk = (char*) ::operator new( slotSize * NET_ALLOCATOR_SLOTS_PER_CHUNK );
+		for ( int i = 0; i < NET_ALLOCATOR_SLOTS_PER_CHUNK; i++ ) {
+			NetFreeSlot_T* slot = (NetFreeSlot_T*) (chunk + (i * slotSize));
+			slot->next = sizeClass->freeList;
+			sizeClass->freeList = slot;
+		}
+	}
+
+	NetFreeSlot_T* slot = sizeClass->freeList;
+	sizeClass->freeList = slot->next;
+	return slot;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void NetAllocator::Free( void* memory, size_t size ) {
+	if ( memory == nullptr ) {
+		return;
+	}
+	s_liveAllocationCount--;
+
+	NetSizeClass_T* sizeClass = FindOrAddSizeClass( GetSlotSize( size ) );
+	if ( sizeClass == nullptr ) {
+		::operator delete( memory );
+		return;
+	}
+
+	NetFreeSlot_T* slot = (NetFreeSlot_T*) memory;
+	slot->next = sizeClass->freeList;
+	sizeClass->freeList = slot;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void* NetAllocator::AllocateBuffer( size_t size ) {
+	s_heapAllocationCount++;
+	s_liveBufferCount++;
+	return ::operator new( size );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void NetAllocator::FreeBuffer( void* memory, size_t size ) {
+	if ( memory == nullptr ) {
+		return;
+	}
+	s_liveBufferCount--;
+	::operator delete( memory );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int NetAllocator::GetHeapAllocationCount() {
+	return s_heapAllocationCount;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int NetAllocator::GetLiveAllocationCount() {
+	return s_liveAllocationCount;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int NetAllocator::GetLiveBufferCount() {
+	return s_liveBufferCount;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Run it twice during a game, new heap allocations between the two should be 0
+void NetAllocator::PrintStatsCommand( std::string const& command ) {
+	int newAllocations = s_heapAllocationCount - s_heapAllocationCountAtLastPrint;
+	s_heapAllocationCountAtLastPrint = s_heapAllocationCount;
+
+	DevConsole::Printf( "Net heap allocations: %d total, %d since last check", s_heapAllocationCount, newAllocations );
+	DevConsole::Printf( "Net pooled objects in use: %d", s_liveAllocationCount );
+	DevConsole::Printf( "Net spilled message buffers in use: %d", s_liveBufferCount );
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <stddef.h>
+#include <string>
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Free lists for the objects the net loop creates every tick (queued messages, datagrams waiting in the latency
+// sim). Each distinct object size gets its own list, carved out of chunks that are never handed back, so once a
+// session has warmed up it sends and receives without touching the heap. Main thread only, like NetSession.
+//
+// Payloads that outgrow a message's inline storage are too varied in size to pool. They come straight from the
+// heap through AllocateBuffer, which still counts them, so net_alloc_stats shows when big messages are costing
+// allocations.
+#define NET_ALLOCATOR_MAX_SIZE_CLASSES 4
+#define NET_ALLOCATOR_SLOTS_PER_CHUNK 32
+
+
+class NetAllocator {
+
+public:
+	static void* Allocate( size_t size );
+	static void Free( void* memory, size_t size );
+
+	static void* AllocateBuffer( size_t size );
+	static void FreeBuffer( void* memory, size_t size );
+
+	static int GetHeapAllocationCount();	// Chunks plus anything that didn't fit a size class
+	static int GetLiveAllocationCount();
+	static int GetLiveBufferCount();
+
+	static void PrintStatsCommand( std::string const& command );
+};
@@ -0,0 +1,82 @@
+#pragma once
+#include "Engine/Net/NetSnapshotLayout.hpp"
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+// Change mask plus the widest field (raw Vector3) for every field
+#define NET_SNAPSHOT_MAX_DELTA_BYTES ((NET_SNAPSHOT_MAX_FIELDS / 8) + (NET_SNAPSHOT_MAX_FIELDS * 12))
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Bits go in LSB first, a whole delta is built here and handed to the packer with one write
+class NetBitWriter {
+public:
+	void Write( uint32_t value, uint8_t bitCount ) {
+		while ( bitCount > 0 ) {
+			size_t byteIndex = m_bitCount >> 3;
+			uint8_t bitOffset = (uint8_t) (m_bitCount & 7);
+			uint8_t bitsThisByte = 8 - bitOffset;
+			if ( bitsThisByte > bitCount ) {
+				bitsThisByte = bitCount;
+			}
+
+			if ( bitOffset == 0 ) {
+				m_bytes[ byteIndex ] = 0;
+			}
+			m_bytes[ byteIndex ] |= (uint8_t) ((value & ((1u << bitsThisByte) - 1u)) << bitOffset);
+
+			value >>= bitsThisByte;
+			bitCount -= bitsThisByte;
+			m_bitCount += bitsThisByte;
+		}
+	}
+
+	size_t GetByteCount() const { return (m_bitCount + 7) >> 3; }
+	uint8_t const* GetBytes() const { return m_bytes; }
+
+private:
+	uint8_t m_bytes[ NET_SNAPSHOT_MAX_DELTA_BYTES ];
+	size_t m_bitCount = 0;
+};
+
+
+//----------------------------------------------------------------------------------------------------------------
+class NetBitReader {
+public:
+	NetBitReader( uint8_t const* bytes, size_t byteCount ) : m_bytes( bytes ), m_byteCount( byteCount ) {}
+
+	bool Read( uint32_t* out_value, uint8_t bitCount ) {
+		if ( m_bitCount + bitCount > m_byteCount * 8 ) {
+			return false;
+		}
+
+		uint32_t value = 0;
+		uint8_t bitsRead = 0;
+		while ( bitsRead < bitCount ) {
+			size_t byteIndex = m_bitCount >> 3;
+			uint8_t bitOffset = (uint8_t) (m_bitCount & 7);
+			uint8_t bitsThisByte = 8 - bitOffset;
+			if ( bitsThisByte > bitCount - bitsRead ) {
+				bitsThisByte = bitCount - bitsRead;
+			}
+
+			uint32_t bits = (m_bytes[ byteIndex ] >> bitOffset) & ((1u << bitsThisByte) - 1u);
+			value |= bits << bitsRead;
+
+			bitsRead += bitsThisByte;
+			m_bitCount += bitsThisByte;
+		}
+
+		*out_value = value;
+		return true;
+	}
+
+	size_t GetByteCount() const { return (m_bitCount + 7) >> 3; }
+
+private:
+	uint8_t const* m_bytes;
+	size_t m_byteCount;
+	size_t m_bitCount = 0;
+};
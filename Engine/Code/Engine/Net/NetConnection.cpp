@@ -5,6 +5,8 @@
 
 #include "Engine/Core/EngineCommon.hpp"
 
+#include <algorithm>
+
 //----------------------------------------------------------------------------------------------------------------
 NetConnection::NetConnection( NetSession* session, uint8_t connectionIndex, NetAddress_T const& address )
 	: m_remoteAddress( address )
@@ -40,7 +42,15 @@ NetConnection::NetConnection( NetSession* session, NetConnectionInfo_T const& in
 
 //----------------------------------------------------------------------------------------------------------------
 NetConnection::~NetConnection() {
-
+	for ( unsigned int i = 0; i < m_unsentReliables.size(); i++ ) {
+		delete m_unsentReliables[i];
+	}
+	for ( unsigned int i = 0; i < m_unconfirmedReliables.size(); i++ ) {
+		delete m_unconfirmedReliables[i];
+	}
+	for ( unsigned int i = 0; i < m_outgoingUnreliables.size(); i++ ) {
+		delete m_outgoingUnreliables[i];
+	}
 }
 
 
@@ -80,15 +90,14 @@ void NetConnection::UpdateHeartbeat() {
 
 
 //----------------------------------------------------------------------------------------------------------------
-int NetConnection::SendPacket( UDPSocket* socketToSendFrom ) {
+bool NetConnection::BuildPacket( NetPacket& out_packet ) {
 	
 	// Early out if nothing needs to be sent
 	if ( m_outgoingUnreliables.size() == 0 && m_unconfirmedReliables.size() == 0 && m_unsentReliables.size() == 0 ) {
-		return 0;
+		return false;
 	}
 
 	// Write the packet header
-	NetPacket* packet = new NetPacket();
 	NetPacketHeader_T packetHeader;
 
 	packetHeader.connectionIndex = m_session->GetMyConnectionIndex();
@@ -96,15 +105,15 @@ int NetConnection::SendPacket( UDPSocket* socketToSendFrom ) {
 	packetHeader.ack = GetNextAckToSend();
 	packetHeader.lastRecvdAck = m_highestRecvdAck;
 	packetHeader.previousRecvdAckBitfield = m_previousRecvdAckBitfield;
-	packet->WriteHeader( packetHeader ); // We should write the header to reserve the space in the buffer
+	out_packet.WriteHeader( packetHeader ); // We should write the header to reserve the space in the buffer
 
-	TrackedPacket* trackedPacket = AddTrackedPacket( packet, (uint8_t) packetHeader.ack );
+	TrackedPacket* trackedPacket = AddTrackedPacket( packetHeader.ack );
 
 	int reliablesInPacket = 0;
 
 	//-----
 	// Unconfirmed reliables
-	if ( m_unconfirmedReliables.size() > 0 && packet->GetWrittenByteCount() < MTU) {
+	if ( m_unconfirmedReliables.size() > 0 && out_packet.GetWrittenByteCount() < MTU) {
 		for ( int i = 0; i < m_unconfirmedReliables.size(); i++ ) {
 
 			if (reliablesInPacket >= MAX_RELIABLES_PER_PACKET) {
@@ -113,11 +122,10 @@ int NetConnection::SendPacket( UDPSocket* socketToSendFrom ) {
 
 			if ( g_masterClock->total.seconds - m_unconfirmedReliables[i]->GetTimeLastSent() > UNRELIABLE_RESEND_TIME ) {
 				
-				if (m_unconfirmedReliables[i]->GetWrittenByteCount() + (m_unconfirmedReliables[i]->IsInOrder() ? 7 : 5) + packet->GetWrittenByteCount() >= MTU) {
+				if ( !out_packet.WriteMessage( *m_unconfirmedReliables[i] ) ) {
 					break;
 				}
 
-				packet->WriteMessage( *m_unconfirmedReliables[i] );
 				reliablesInPacket++;
 				packetHeader.messageCount++;
 				m_unconfirmedReliables[i]->SetTimeLastSent( g_masterClock->total.seconds );
@@ -128,62 +136,74 @@ int NetConnection::SendPacket( UDPSocket* socketToSendFrom ) {
 
 	//-----
 	// Unsent reliables
-	if ( m_unsentReliables.size() > 0 && packet->GetWrittenByteCount() < MTU) {
-		while ( !m_unsentReliables.empty() && CanSendNewReliable() ) {
+	if ( m_unsentReliables.size() > 0 && out_packet.GetWrittenByteCount() < MTU) {
+		unsigned int sentCount = 0;
+		while ( sentCount < m_unsentReliables.size() && CanSendNewReliable() ) {
 		
-			NetMessage* msg = m_unsentReliables.front(); 
-
-			msg->SetReliableID( m_lastSentReliable + 1 );
-			m_lastSentReliable++;
+			NetMessage* msg = m_unsentReliables[ sentCount ]; 
 
-			if (reliablesInPacket > MAX_RELIABLES_PER_PACKET || packet->GetWrittenByteCount() + msg->GetWrittenByteCount() + (msg->IsInOrder() ? 7 : 5) >= MTU ) {
+			// Only take the next ID once we know it fits, otherwise it's skipped for good
+			if ( reliablesInPacket >= MAX_RELIABLES_PER_PACKET || out_packet.GetRemainingWritableByteCount() < msg->GetWrittenByteCount() + NetPacket::GetMessageHeaderSize( *msg ) ) {
 				break;
 			}
 
-			packet->WriteMessage( *msg );
+			msg->SetReliableID( m_lastSentReliable + 1 );
+			m_lastSentReliable++;
+
+			out_packet.WriteMessage( *msg );
 			m_unconfirmedReliables.push_back( msg );
 			m_unconfirmedReliables[ m_unconfirmedReliables.size() - 1 ]->SetTimeLastSent( g_masterClock->total.seconds );
 			reliablesInPacket++;
 			packetHeader.messageCount++;
 			trackedPacket->AddSentReliable( msg->GetReliableID() );
-			m_unsentReliables.pop();
+			sentCount++;
 		}
+		m_unsentReliables.erase( m_unsentReliables.begin(), m_unsentReliables.begin() + sentCount );
  	}
 
 	//-----
 	// Unreliables
-	if ( m_outgoingUnreliables.size() > 0 && packet->GetWrittenByteCount() < MTU ) {
+	if ( m_outgoingUnreliables.size() > 0 && out_packet.GetWrittenByteCount() < MTU ) {
 
-		// Write messages to the packet
-		while ( !m_outgoingUnreliables.empty() ) {
-			packet->WriteMessage( *m_outgoingUnreliables.front() );
+		// Write messages to the packet, anything that doesn't fit waits for the next one
+		unsigned int sentCount = 0;
+		while ( sentCount < m_outgoingUnreliables.size() && out_packet.WriteMessage( *m_outgoingUnreliables[ sentCount ] ) ) {
+			delete m_outgoingUnreliables[ sentCount ];
 			packetHeader.messageCount++;
-			m_outgoingUnreliables.pop();
+			sentCount++;
 		}
+		m_outgoingUnreliables.erase( m_outgoingUnreliables.begin(), m_outgoingUnreliables.begin() + sentCount );
 	}
 
 
 	// Add net object updates
 	if ( m_session->AmIHost() ) {
-		packetHeader.messageCount += m_session->netObjectSystem->FillPacketWithUpdates( packet, this );
+		packetHeader.messageCount += m_session->netObjectSystem->FillPacketWithUpdates( &out_packet, this );
 	}
 
-	packet->WriteHeader( packetHeader ); // Write the real values over that
-
-	// Send the packet 
-	int sentBytes = (int) socketToSendFrom->SendTo( m_remoteAddress, packet->GetBuffer(), packet->GetWrittenByteCount() );
+	out_packet.WriteHeader( packetHeader ); // Write the real values over that
 
 	m_timeAtLastSend = g_masterClock->total.seconds;
 	IncrementNextAckToSend();
 
-	return sentBytes;
+	return true;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int NetConnection::SendPacket( UDPSocket* socketToSendFrom ) {
+	NetPacket packet;
+	if ( !BuildPacket( packet ) ) {
+		return 0;
+	}
+	return (int) socketToSendFrom->SendTo( m_remoteAddress, packet.GetBuffer(), packet.GetWrittenByteCount() );
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
 int NetConnection::SendPacketImmediate( UDPSocket* socketToSendFrom, NetMessage& message, bool isAckConfirm /* = false */ ) {
 
-	NetPacket* packet = new NetPacket();
+	NetPacket packet;
 	NetPacketHeader_T packetHeader;
 	packetHeader.connectionIndex = m_session->GetMyConnectionIndex();
 
@@ -199,10 +219,10 @@ int NetConnection::SendPacketImmediate( UDPSocket* socketToSendFrom, NetMessage&
 	packetHeader.lastRecvdAck = m_highestRecvdAck;
 	packetHeader.previousRecvdAckBitfield = m_previousRecvdAckBitfield;
 
-	packet->WriteHeader( packetHeader );
+	packet.WriteHeader( packetHeader );
 
 	if (!isAckConfirm) {
-		TrackedPacket* trackedPacket = AddTrackedPacket( packet, (uint8_t) packetHeader.ack );
+		TrackedPacket* trackedPacket = AddTrackedPacket( packetHeader.ack );
 		if ( message.IsReliable() && CanSendNewReliable() ) {
 			NetMessage* msg = new NetMessage( message );
 			msg->SetReliableID(m_lastSentReliable + 1);
@@ -210,7 +230,7 @@ int NetConnection::SendPacketImmediate( UDPSocket* socketToSendFrom, NetMessage&
 			m_unconfirmedReliables.push_back( msg );
 			trackedPacket->AddSentReliable( m_lastSentReliable );
 		}
-		packet->WriteMessage( message );
+		packet.WriteMessage( message );
 	}
 
 	m_timeAtLastSend = g_masterClock->total.seconds;
@@ -221,7 +241,7 @@ int NetConnection::SendPacketImmediate( UDPSocket* socketToSendFrom, NetMessage&
 
 	
 
-	return (int) socketToSendFrom->SendTo( m_remoteAddress, packet->GetBuffer(), packet->GetWrittenByteCount() );
+	return (int) socketToSendFrom->SendTo( m_remoteAddress, packet.GetBuffer(), packet.GetWrittenByteCount() );
 }
 
 
@@ -233,9 +253,9 @@ void NetConnection::Send( NetMessage& message ) {
 		SetSequenceIDOnMessage( msg );
 	}
 	if ( msg->IsReliable() ) {
-		m_unsentReliables.push( msg );
+		m_unsentReliables.push_back( msg );
 	} else {
-		m_outgoingUnreliables.push( msg );
+		m_outgoingUnreliables.push_back( msg );
 	}
 }
 
@@ -254,17 +274,16 @@ void NetConnection::ProcessIncoming( NetPacket& packet ) {
 	NetPacketHeader_T packetHeader;
 	packet.ReadHeader( packetHeader );
 
+	// Views into the packet, nothing is copied
+	NetMessage message;
+
 	int actualSize = 8;
 	for ( int i = 0; i < packetHeader.messageCount; i++) {
-		NetMessage* message = packet.ReadMessage( m_session );
-
-		if ( message->IsInOrder() ) {
-			actualSize += (int) message->GetMessageLength() + 7;
-		} else if ( message->IsReliable() ) {
-			actualSize += (int) message->GetMessageLength() + 5;
-		} else {
-			actualSize += (int) message->GetMessageLength() + 3;
+		if ( !packet.ReadMessage( message ) ) {
+			DevConsole::Printf("A message was malformed");
+			return;
 		}
+		actualSize += (int) (message.GetMessageLength() + NetPacket::GetMessageHeaderSize( message ));
 	}
 
 	if (actualSize != packet.GetWrittenByteCount()) {
@@ -315,55 +334,49 @@ void NetConnection::ProcessIncoming( NetPacket& packet ) {
 	packet.ReadHeader( packetHeader );
 
 	for ( int i = 0; i < packetHeader.messageCount; i++ ) {
-		NetMessage* message = packet.ReadMessage( m_session );
-
-		if ( message == nullptr ) {
-			delete message;
-			message = nullptr;
+		if ( !packet.ReadMessage( message ) ) {
 			DevConsole::Printf("A message was malformed");
 			break;
 		}
 
-		NetCommand messageCommand = NetSession::GetCommand( message->GetMessageIndex() );
+		NetCommand const& messageCommand = NetSession::GetCommand( message.GetMessageIndex() );
 		if (messageCommand.id != 0xFF) {
 			if ( !m_session->IsValidConnectionIndex( m_connectionIndex ) && messageCommand.RequiresConnection() ) {
 				DevConsole::Printf( "Message from someone unconnected requires a connection!!" );
 			}
 			else if ( m_session->IsValidConnectionIndex( m_connectionIndex ) || !messageCommand.RequiresConnection() ) {
 				
-				if ( message->IsReliable() ) {
-					std::list<uint16_t>::iterator it = m_receivedReliables.begin();
-					while ( it != m_receivedReliables.end() && *it != message->GetReliableID() ) {
-						it++;
-					}
+				if ( message.IsReliable() ) {
+					bool alreadyReceived = std::find( m_receivedReliables.begin(), m_receivedReliables.end(), message.GetReliableID() ) != m_receivedReliables.end();
 
-					if ( it == m_receivedReliables.end() ) {
+					if ( !alreadyReceived ) {
 
-						if ( m_highestReceivedReliable - message->GetReliableID() < RELIABLE_WINDOW ) {
+						if ( m_highestReceivedReliable - message.GetReliableID() < RELIABLE_WINDOW ) {
 							
-							if ( message->IsInOrder() ) {
-								NetMessageChannel& channel = GetChannelForMessage( message );
+							if ( message.IsInOrder() ) {
+								NetMessageChannel& channel = GetChannelForMessage( &message );
 								
-								if ( message->GetSequenceID() == channel.m_nextExpectedSequenceID ) {
-									messageCommand.callback( *message, *this );
+								if ( message.GetSequenceID() == channel.m_nextExpectedSequenceID ) {
+									messageCommand.callback( message, *this );
 									channel.m_nextExpectedSequenceID++;
 								} 
 
+								// The view dies with the packet, so keep a pooled copy
 								else {
-									channel.m_outOfOrderMessages.push_back( message );
-									AddToReceivedReliablesList( message->GetReliableID() );
+									channel.m_outOfOrderMessages.push_back( new NetMessage( message ) );
+									AddToReceivedReliablesList( message.GetReliableID() );
 								}
 							}
 
 							else {
-								messageCommand.callback( *message, *this );
-								AddToReceivedReliablesList( message->GetReliableID() );
+								messageCommand.callback( message, *this );
+								AddToReceivedReliablesList( message.GetReliableID() );
 							}
 						}
 					}
 				}
 				else {
-					messageCommand.callback( *message, *this );
+					messageCommand.callback( message, *this );
 				}
 			}
 		}
@@ -416,18 +429,10 @@ float NetConnection::GetTimeSinceLastReceivedMessage() const {
 
 
 //----------------------------------------------------------------------------------------------------------------
-TrackedPacket* NetConnection::AddTrackedPacket( NetPacket* packet, uint8_t ack ) {
-
-	TrackedPacket* trackedPacket = new TrackedPacket();
-	uint8_t trackerIndex = ack % MAX_TRACKED_HISTORY_SIZE;
-	trackedPacket->SetPacket(packet);
-	trackedPacket->SetTimeSent(g_masterClock->total.seconds);
-
-	if (m_trackedPackets[trackerIndex] != nullptr) {
-		delete m_trackedPackets[trackerIndex];
-	}
-	m_trackedPackets[trackerIndex] = trackedPacket;
-
+// Overwrites whatever was in the slot, packets that old are considered lost
+TrackedPacket* NetConnection::AddTrackedPacket( uint16_t ack ) {
+	TrackedPacket* trackedPacket = &m_trackedPackets[ ack % MAX_TRACKED_HISTORY_SIZE ];
+	trackedPacket->Reset( g_masterClock->total.seconds );
 	return trackedPacket;
 }
 
@@ -451,31 +456,34 @@ void NetConnection::IncrementNextAckToSend() {
 void NetConnection::ConfirmPacketReceived( uint16_t lastRecvdAck ) {
 	
 	// If this received ack isn't in the tracked packet slot, something went wrong?
-	int trackedPacketSlot = lastRecvdAck % MAX_TRACKED_HISTORY_SIZE;
-	if (  m_trackedPackets[ trackedPacketSlot ] != nullptr ) {
-
-		// Check if the tracked packet is valid. If so, calculate rtt, invalidate it and check if it has reliables
-		if ( m_trackedPackets[ trackedPacketSlot ]->IsValid() ) {
-			m_rtt = Interpolate( m_rtt, g_masterClock->total.seconds - m_trackedPackets[ trackedPacketSlot ]->GetTimeSent(), 0.2f );
-			m_trackedPackets[ trackedPacketSlot ]->Invalidate();
-
-			// If it has reliables, iterate through and confirm those reliables.
-			uint16_t* reliableIDs = m_trackedPackets[ trackedPacketSlot ]->GetSentReliablesArray();
-			for ( int i = 0; i < m_trackedPackets[ trackedPacketSlot ]->GetNumReliablesInPacket(); i++ ) {
-				uint16_t id = reliableIDs[ i ];
-
-				// now that we have the actual reliable ID, check it against the unconfirmed
-				// reliables and remove it from the list.
-				for ( int message = 0; message < m_unconfirmedReliables.size(); message++ ) {
-					if ( id == m_unconfirmedReliables[ message ]->GetReliableID() ) {
-						delete m_unconfirmedReliables[ message ];
-						m_unconfirmedReliables[ message ] = m_unconfirmedReliables[ m_unconfirmedReliables.size() - 1 ];
-						m_unconfirmedReliables.pop_back();
-						message--;
-					}
-				}
-			} 
+	TrackedPacket& trackedPacket = m_trackedPackets[ lastRecvdAck % MAX_TRACKED_HISTORY_SIZE ];
+
+	// Check if the tracked packet is valid. If so, calculate rtt, invalidate it and check if it has reliables
+	if ( trackedPacket.IsValid() ) {
+		m_rtt = Interpolate( m_rtt, g_masterClock->total.seconds - trackedPacket.GetTimeSent(), 0.2f );
+		trackedPacket.Invalidate();
+
+		// Net object snapshots in this packet can now be used as delta baselines
+		if ( m_session->netObjectSystem != nullptr ) {
+			m_session->netObjectSystem->OnPacketConfirmed( this, lastRecvdAck );
 		}
+
+		// If it has reliables, iterate through and confirm those reliables.
+		uint16_t* reliableIDs = trackedPacket.GetSentReliablesArray();
+		for ( int i = 0; i < trackedPacket.GetNumReliablesInPacket(); i++ ) {
+			uint16_t id = reliableIDs[ i ];
+
+			// now that we have the actual reliable ID, check it against the unconfirmed
+			// reliables and remove it from the list.
+			for ( int message = 0; message < m_unconfirmedReliables.size(); message++ ) {
+				if ( id == m_unconfirmedReliables[ message ]->GetReliableID() ) {
+					delete m_unconfirmedReliables[ message ];
+					m_unconfirmedReliables[ message ] = m_unconfirmedReliables[ m_unconfirmedReliables.size() - 1 ];
+					m_unconfirmedReliables.pop_back();
+					message--;
+				}
+			}
+		} 
 	}
 }
 
@@ -571,16 +579,10 @@ void NetConnection::AddToReceivedReliablesList( uint16_t reliableID ) {
 	}
 	m_receivedReliables.push_back( reliableID );
 
-	std::list<uint16_t>::iterator it = m_receivedReliables.begin();
-
-	while (it != m_receivedReliables.end()) {
-
-		if (*it < m_highestReceivedReliable - RELIABLE_WINDOW) {
-			it = m_receivedReliables.erase(it);
-		} else {
-			it++;
-		}
-	}
+	uint16_t highestReceived = m_highestReceivedReliable;
+	m_receivedReliables.erase( std::remove_if( m_receivedReliables.begin(), m_receivedReliables.end(), [highestReceived]( uint16_t id ) {
+		return id < highestReceived - RELIABLE_WINDOW;
+	}), m_receivedReliables.end() );
 }
 
 
@@ -601,23 +603,23 @@ NetMessageChannel& NetConnection::GetChannelForMessage( NetMessage* msg ) {
 //----------------------------------------------------------------------------------------------------------------
 void NetConnection::ProcessChannelOutOfOrders( NetMessageChannel& channel ) {
 
-	std::list<NetMessage*>::iterator it = channel.m_outOfOrderMessages.begin();
+	unsigned int i = 0;
+	while ( i < channel.m_outOfOrderMessages.size() ) {
+		NetMessage* message = channel.m_outOfOrderMessages[i];
 
-	while ( it != channel.m_outOfOrderMessages.end() ) {
+		if ( message->GetSequenceID() == channel.m_nextExpectedSequenceID ) {
+			NetCommand const& command = NetSession::GetCommand( message->GetMessageIndex() );
+			command.callback( *message, *this );
 
-		if ( (*it)->GetSequenceID() == channel.m_nextExpectedSequenceID ) {
-			NetCommand command = NetSession::GetCommand( (*it)->GetMessageIndex() );
-			command.callback( **it, *this );
-
-			delete *it;
-			channel.m_outOfOrderMessages.erase( it );
-			it = channel.m_outOfOrderMessages.begin();
+			delete message;
+			channel.m_outOfOrderMessages.erase( channel.m_outOfOrderMessages.begin() + i );
+			i = 0;
 
 			channel.m_nextExpectedSequenceID++;
 		}
 
 		else {
-			it++;
+			i++;
 		}
 	}
 }
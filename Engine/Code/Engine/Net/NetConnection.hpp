@@ -15,7 +15,7 @@
 #include "Engine/Core/Stopwatch.hpp"
 
 #include <queue>
-#include <list>
+#include <vector>
 
 
 #define MAX_TRACKED_HISTORY_SIZE 128
@@ -39,7 +39,7 @@ class NetMessageChannel {
 public:
 	uint16_t m_nextSequenceID = 0;
 	uint16_t m_nextExpectedSequenceID = 0;
-	std::list<NetMessage*> m_outOfOrderMessages;
+	std::vector<NetMessage*> m_outOfOrderMessages;
 
 	uint16_t GetAndIncrementNextSequenceID() {
 		uint16_t id = m_nextSequenceID;
@@ -48,12 +48,10 @@ public:
 	}
 
 	~NetMessageChannel() {
-		std::list<NetMessage*>::iterator it = m_outOfOrderMessages.begin(); 
-		while (it != m_outOfOrderMessages.end()) {
-			delete *it;
-			m_outOfOrderMessages.erase(it);
-			it = m_outOfOrderMessages.begin();
+		for ( unsigned int i = 0; i < m_outOfOrderMessages.size(); i++ ) {
+			delete m_outOfOrderMessages[i];
 		}
+		m_outOfOrderMessages.clear();
 	}
 };
 
@@ -76,6 +74,7 @@ public:
 	~NetConnection();
 
 	void	Send( NetMessage& message );
+	bool	BuildPacket( NetPacket& out_packet );		// Writes the next packet without sending it, false if there's nothing to send
 	int		SendPacket( UDPSocket* socketToSendFrom );
 	int		SendPacketImmediate( UDPSocket* socketToSendFrom, NetMessage& message, bool isAckConfirm = false );
 	void	Receive( NetMessage* message );
@@ -87,7 +86,7 @@ public:
 	void	SetSendRate( float rate );
 
 	// Acks and Reliables
-	TrackedPacket*	AddTrackedPacket( NetPacket* packet, uint8_t ack );
+	TrackedPacket*	AddTrackedPacket( uint16_t ack );
 	uint16_t		GetNextAckToSend();
 	void			IncrementNextAckToSend();
 	void			ConfirmPacketReceived( uint16_t ack );
@@ -149,20 +148,21 @@ private:
 	Stopwatch m_heartbeat;
 	Stopwatch m_joinRequestResend;
 
-	std::queue<NetMessage*> m_unsentReliables;
+	// Vectors rather than queues so the storage sticks around between ticks
+	std::vector<NetMessage*> m_unsentReliables;
 	std::vector<NetMessage*> m_unconfirmedReliables;
-	std::queue<NetMessage*> m_outgoingUnreliables;
+	std::vector<NetMessage*> m_outgoingUnreliables;
 	std::queue<NetMessage*> m_incomingMessages;
 
 	// ack members
 	uint16_t m_nextSentAck = 0U;
 	uint16_t m_highestRecvdAck = INVALID_PACKET_ACK;
 	uint16_t m_previousRecvdAckBitfield = 0U;
-	TrackedPacket* m_trackedPackets[MAX_TRACKED_HISTORY_SIZE];
+	TrackedPacket m_trackedPackets[MAX_TRACKED_HISTORY_SIZE];
 
 	// reliable members
 	uint16_t m_lastSentReliable = 0;
-	std::list<uint16_t> m_receivedReliables;
+	std::vector<uint16_t> m_receivedReliables;
 	uint16_t m_oldestUnconfirmedReliable = 0;
 	uint16_t m_highestReceivedReliable = 0;
 
@@ -1,29 +1,46 @@
 #include "Engine/Net/NetMessage.hpp"
 #include "Engine/Net/NetSession.hpp"
 
+
+// Spilled payloads go through NetAllocator so net_alloc_stats sees them
+static const BytePackerHeap_T NET_MESSAGE_HEAP = { NetAllocator::AllocateBuffer, NetAllocator::FreeBuffer };
+
+//----------------------------------------------------------------------------------------------------------------
+NetMessage::NetMessage() 
+	: BytePacker( m_storage, NET_MESSAGE_INLINE_SIZE, 0, LITTLE_ENDIAN, BYTEPACKER_SPILLS_TO_HEAP, &NET_MESSAGE_HEAP )
+{
+	m_messageIndex = 0xFF;
+}
+
+
 //----------------------------------------------------------------------------------------------------------------
-NetMessage::NetMessage( uint8_t messageIndex ) {
+NetMessage::NetMessage( uint8_t messageIndex ) 
+	: BytePacker( m_storage, NET_MESSAGE_INLINE_SIZE, 0, LITTLE_ENDIAN, BYTEPACKER_SPILLS_TO_HEAP, &NET_MESSAGE_HEAP )
+{
 	m_messageIndex = messageIndex;
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
 NetMessage::NetMessage( uint8_t messageIndex, byte_t* payload, size_t payloadSize, uint16_t reliableID /* = 0 */, uint16_t sequenceID ) 
-	: BytePacker(payloadSize, (void*) payload)
+	: BytePacker( m_storage, NET_MESSAGE_INLINE_SIZE, 0, LITTLE_ENDIAN, BYTEPACKER_SPILLS_TO_HEAP, &NET_MESSAGE_HEAP )
 	, m_reliableID( reliableID )
 	, m_sequenceID( sequenceID )
 {
 	m_messageIndex = messageIndex;
+	WriteBytes( payloadSize, payload );
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
+// Always copies into our own storage, even when copying a view
 NetMessage::NetMessage( NetMessage const& copy ) 
-	: BytePacker( copy.GetWrittenByteCount(), copy.GetBuffer() )
+	: BytePacker( m_storage, NET_MESSAGE_INLINE_SIZE, 0, LITTLE_ENDIAN, BYTEPACKER_SPILLS_TO_HEAP, &NET_MESSAGE_HEAP )
 {
 	m_messageIndex = copy.GetMessageIndex();
 	m_reliableID = copy.GetReliableID();
 	m_sequenceID = copy.GetSequenceID();
+	WriteBytes( copy.GetWrittenByteCount(), copy.GetBuffer() );
 }
 
 
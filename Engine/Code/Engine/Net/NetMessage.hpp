@@ -6,13 +6,26 @@
 #pragma once 
 #include "Engine/Core/BytePacker.hpp"
 #include "Engine/Net/NetAddress.hpp"
+#include "Engine/Net/NetAllocator.hpp"
 
 #include <string>
 
+#define MTU (1500-48)
+#define NET_MESSAGE_INLINE_SIZE 128		// Covers object updates, pings and the like, bigger messages spill to the heap
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Payloads up to NET_MESSAGE_INLINE_SIZE live inline, so a typical message on the stack, or a queued copy from
+// NetAllocator, never touches the heap. Writing past that moves the payload to a buffer from
+// NetAllocator::AllocateBuffer that grows like any BytePacker's, so it still shows in net_alloc_stats; keeping the inline part small keeps the reliable queues from holding an MTU per message.
+// Messages read out of a packet are views instead: they point into the packet's buffer and are only good until
+// that packet is recycled, so copy one if it needs to be kept.
 
 class NetMessage : public BytePacker {
+	friend class NetPacket;
 
 public:
+	NetMessage();		// Invalid index, filled in by NetPacket::ReadMessage
 
 	NetMessage( std::string const& messageName, byte_t* messageData, size_t messageDataSize );
 
@@ -22,6 +35,10 @@ public:
 	NetMessage( uint8_t messageIndex, byte_t* payload, size_t payloadSize, uint16_t reliableID = 0, uint16_t sequenceID = 0 );
 
 	NetMessage( NetMessage const& copy );
+	NetMessage& operator=( NetMessage const& copy ) = delete;
+
+	static void* operator new( size_t size )				{ return NetAllocator::Allocate( size ); }
+	static void operator delete( void* memory, size_t size )	{ NetAllocator::Free( memory, size ); }
 
 	void SetTimeLastSent( float seconds );
 	void SetReliableID( uint16_t reliableID );
@@ -44,4 +61,5 @@ private:
 	uint16_t m_reliableID = 0;
 	uint16_t m_sequenceID = 0;
 	float m_timeLastSent = 0.f;
+	byte_t m_storage[ NET_MESSAGE_INLINE_SIZE ];
 };
\ No newline at end of file
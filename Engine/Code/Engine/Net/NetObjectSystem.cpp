@@ -2,27 +2,32 @@
 #include "Engine/Net/NetMessage.hpp"
 #include "Engine/Net/NetObjectSystem.hpp"
 
+#include "Engine/DevConsole/Command.hpp"
+#include "Engine/DevConsole/DevConsole.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Core/Time.hpp"
+
+#include <algorithm>
+#include <string.h>
+
 
 //----------------------------------------------------------------------------------------------------------------
 // NetObjectConnectionView
 //----------------------------------------------------------------------------------------------------------------
 NetObjectConnectionView::~NetObjectConnectionView() {
-	std::list< NetObjectView_T* >::iterator it = objectViews.begin();
-
-	while( it != objectViews.end() ) {
-		delete *it;
-		it++;
+	for ( unsigned int i = 0; i < objectViews.size(); i++ ) {
+		delete objectViews[i];
 	}
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
-void NetObjectConnectionView::AddNetObject( NetObject* obj ) {
+void NetObjectConnectionView::AddNetObject( NetObject* obj, double netTime ) {
 	NetObjectView_T* objView = new NetObjectView_T();
-	objView->lastSentSnapshot = nullptr;
 	objView->networkID = (uint16_t) obj->networkID;
 	objView->typeID = obj->typeID;
-	objView->timeLastSent = NetSession::instance->GetNetTime();
+	objView->object = obj;
+	objView->timeLastSent = netTime;
 
 	objectViews.push_back(objView);
 	objectViewByNetworkID[ obj->networkID ] = objView;
@@ -36,15 +41,10 @@ void NetObjectConnectionView::RemoveNetObject( NetObject* obj ) {
 	objectViewByNetworkID.erase( obj->networkID );
 	objectViewByLocalPtr.erase( obj->localPtr );
 
-	std::list< NetObjectView_T* >::iterator it = objectViews.begin();
-	while ( it != objectViews.end() ) {
-
-		if ((*it)->networkID == obj->networkID ) {
-			objectViews.erase( it );
-			break;
-		}
-
-		it++;
+	std::vector< NetObjectView_T* >::iterator it = std::find( objectViews.begin(), objectViews.end(), objView );
+	if ( it != objectViews.end() ) {
+		*it = objectViews.back();
+		objectViews.pop_back();
 	}
 
 	delete objView;
@@ -52,15 +52,15 @@ void NetObjectConnectionView::RemoveNetObject( NetObject* obj ) {
 
 
 //----------------------------------------------------------------------------------------------------------------
-NetObjectView_T* NetObjectConnectionView::FindOldestView() {
+NetObjectView_T* NetObjectConnectionView::FindOldestView( double netTime ) {
 
-	std::list< NetObjectView_T* >::iterator it = objectViews.begin();
+	std::vector< NetObjectView_T* >::iterator it = objectViews.begin();
 
 	if ( it == objectViews.end() ) {
 		return nullptr;
 	}
 
-	double newestTime = NetSession::instance->GetNetTime();
+	double newestTime = netTime;
 	NetObjectView_T* toReturn = nullptr;
 
 
@@ -76,10 +76,63 @@ NetObjectView_T* NetObjectConnectionView::FindOldestView() {
 }
 
 
+//----------------------------------------------------------------------------------------------------------------
+void NetObjectConnectionView::AccumulatePriority( float deltaSeconds, std::vector< NetObjectDef_T* > const& types ) {
+	for ( unsigned int i = 0; i < objectViews.size(); i++ ) {
+		NetObjectView_T* objView = objectViews[i];
+		NetObjectDef_T const* type = types[ objView->typeID ];
+		float gain = deltaSeconds * type->priorityWeight;
+
+		if ( hasFocus && type->getPositionCB != nullptr ) {
+			float falloffSquared = type->priorityFalloffDistance * type->priorityFalloffDistance;
+			float distanceSquared = (objView->object->position - focusPosition).GetLengthSquared();
+			gain *= falloffSquared / (falloffSquared + distanceSquared);
+		}
+
+		objView->priority += gain;
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+static bool IsLowerPriority( NetObjectView_T const* a, NetObjectView_T const* b ) {
+	return a->priority < b->priority;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Building the heap is linear and a packet only holds a few dozen updates, so it's cheaper than keeping it sorted
+void NetObjectConnectionView::BuildSendQueue() {
+	m_sendQueue.assign( objectViews.begin(), objectViews.end() );
+	std::make_heap( m_sendQueue.begin(), m_sendQueue.end(), IsLowerPriority );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// nullptr once the queue is empty or nothing left in it has waited at all
+NetObjectView_T* NetObjectConnectionView::PopHighestPriorityView() {
+	if ( m_sendQueue.empty() ) {
+		return nullptr;
+	}
+
+	std::pop_heap( m_sendQueue.begin(), m_sendQueue.end(), IsLowerPriority );
+	NetObjectView_T* highest = m_sendQueue.back();
+	m_sendQueue.pop_back();
+
+	if ( highest->priority <= 0.f ) {
+		m_sendQueue.clear();
+		return nullptr;
+	}
+	return highest;
+}
+
+
 
 //----------------------------------------------------------------------------------------------------------------
 // Net Object System
 //----------------------------------------------------------------------------------------------------------------
+bool NetObjectSystem::s_useLegacyPriority = false;
+
 
 //----------------------------------------------------------------------------------------------------------------
 NetObjectSystem::NetObjectSystem( NetSession* session ) : session( session ) {
@@ -129,12 +182,9 @@ NetObjectDef_T const& NetObjectSystem::GetObjectTypeByID( uint8_t id ) {
 
 //----------------------------------------------------------------------------------------------------------------
 NetObject* NetObjectSystem::GetObjectByNetID( uint32_t id ) {
-	std::list<NetObject*>::iterator it = m_objects.begin();
-	while ( it != m_objects.end() ) {
-		if ( (*it)->networkID == id ) {
-			return *it;
-		}
-		it++;
+	std::map< uint16_t, NetObject* >::iterator it = m_netIDObjectLookup.find( (uint16_t) id );
+	if ( it != m_netIDObjectLookup.end() ) {
+		return it->second;
 	}
 	return nullptr;
 }
@@ -142,12 +192,9 @@ NetObject* NetObjectSystem::GetObjectByNetID( uint32_t id ) {
 
 //----------------------------------------------------------------------------------------------------------------
 NetObject* NetObjectSystem::GetObjectByLocalPtr( void* ptr ) {
-	std::list<NetObject*>::iterator it = m_objects.begin();
-	while ( it != m_objects.end() ) {
-		if ( (*it)->localPtr == ptr ) {
-			return *it;
-		}
-		it++;
+	std::map< void*, NetObject* >::iterator it = m_localPtrObjectLookup.find( ptr );
+	if ( it != m_localPtrObjectLookup.end() ) {
+		return it->second;
 	}
 	return nullptr;
 }
@@ -175,7 +222,7 @@ void NetObjectSystem::SyncObject( uint8_t type, void* ptr ) {
 
 	for ( int i = 0; i < MAX_CLIENTS; i++ ) {
 		if (m_connectionViews[i] != nullptr ) {
-			m_connectionViews[i]->AddNetObject( obj );
+			m_connectionViews[i]->AddNetObject( obj, session->GetNetTime() );
 		}
 	}
 }
@@ -273,13 +320,28 @@ void NetObjectSystem::UpdateSnapshots() {
 
 	while ( objectIterator != m_objects.end() ) {
 		
-		NetObjectDef_T const& typeDef = GetObjectTypeByID( (*objectIterator)->typeID );
+		NetObject* obj = *objectIterator;
+		NetObjectDef_T const& typeDef = GetObjectTypeByID( obj->typeID );
 
-		if( (*objectIterator)->snapshot != nullptr ) {
-			delete (*objectIterator)->snapshot;
+		typeDef.getSnapshotCB( obj->snapshot, obj->localPtr );
+		if ( typeDef.getPositionCB != nullptr ) {
+			obj->position = typeDef.getPositionCB( obj->localPtr );
 		}
 
-		typeDef.getSnapshotCB( (*objectIterator)->snapshot, (*objectIterator)->localPtr );
+		// Only a snapshot that actually changed gets a new ID, so idle objects stop being sent once acked
+		NetSnapshotLayout const& layout = typeDef.snapshotLayout;
+		if ( layout.IsEnabled() ) {
+			NetSnapshotHistory& history = obj->snapshotHistory;
+			if ( !history.IsInitialized() ) {
+				history.Initialize( layout.GetSnapshotSize() );
+			}
+
+			if ( history.IsEmpty() ) {
+				history.Store( 0, obj->snapshot );
+			} else if ( layout.HasChanged( history.GetLatest(), obj->snapshot ) ) {
+				history.Store( history.GetLatestID() + 1, obj->snapshot );
+			}
+		}
 
 		objectIterator++;
 	}
@@ -294,21 +356,110 @@ void NetObjectSystem::CreateViewForConnection( int connectionIndex ) {
 	std::list< NetObject* >::iterator objectIt = m_objects.begin();
 
 	while ( objectIt != m_objects.end() ) {
-		view->AddNetObject( *objectIt );
+		view->AddNetObject( *objectIt, session->GetNetTime() );
 		objectIt++;
 	}
 
+	view->timeLastAccumulated = session->GetNetTime();
 	m_connectionViews[ connectionIndex ] = view;
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
 uint8_t NetObjectSystem::FillPacketWithUpdates( NetPacket* packet, NetConnection* conn ) {
+	if ( s_useLegacyPriority ) {
+		return FillPacketWithUpdatesLegacy( packet, conn );
+	}
+
 	NetObjectConnectionView* view = m_connectionViews[conn->GetConnectionIndex()];
-	NetObjectView_T* oldest = view->FindOldestView();
-	//NetObjectView_T* previousView = nullptr;
+	uint16_t packetAck = conn->GetNextAckToSend();
 	uint8_t addedMessages = 0;
 
+	// Anything older than the tracked packet history will never be confirmed
+	for ( unsigned int i = 0; i < view->inFlightSnapshots.size(); i++ ) {
+		if ( (uint16_t) (packetAck - view->inFlightSnapshots[i].packetAck) >= MAX_TRACKED_HISTORY_SIZE ) {
+			view->inFlightSnapshots[i] = view->inFlightSnapshots[ view->inFlightSnapshots.size() - 1 ];
+			view->inFlightSnapshots.pop_back();
+			i--;
+		}
+	}
+
+	double now = session->GetNetTime();
+	view->AccumulatePriority( (float) (now - view->timeLastAccumulated), m_typeDefinitions );
+	view->timeLastAccumulated = now;
+	view->BuildSendQueue();
+
+	NetObjectView_T* next = view->PopHighestPriorityView();
+	while ( packet->GetWrittenByteCount() < MTU && next != nullptr ) {
+
+		NetMessage update( NETMSG_OBJECT_UPDATE );
+		NetObjectDef_T const& nextDef = GetObjectTypeByID( next->typeID );
+		NetObject* nextObj = next->object;
+
+		update.WriteValue<uint8_t>( next->typeID );
+		update.WriteValue<uint16_t>( next->networkID );
+
+		bool isDelta = nextDef.snapshotLayout.IsEnabled();
+		bool isFullSnapshot = false;
+		if ( isDelta ) {
+
+			// Nothing new since what they acked, so it has nothing to wait for either
+			if ( !WriteSnapshotDelta( &update, nextObj, next, &isFullSnapshot ) ) {
+				next->priority = 0.f;
+				next = view->PopHighestPriorityView();
+				continue;
+			}
+		} else {
+			nextDef.sendSnapshotCB( &update, nextObj->snapshot );
+		}
+
+		// Whatever doesn't fit keeps its priority for the next packet
+		if ( !packet->WriteMessage( update ) ) {
+			break;
+		}
+
+		addedMessages++;
+		next->timeLastSent = now;
+		next->priority = 0.f;
+
+		if ( isDelta ) {
+			if ( isFullSnapshot ) {
+				next->updatesSinceFullSnapshot = 0;
+			} else {
+				next->updatesSinceFullSnapshot++;
+			}
+
+			NetSnapshotInFlight_T inFlight;
+			inFlight.packetAck = packetAck;
+			inFlight.networkID = next->networkID;
+			inFlight.snapshotID = nextObj->snapshotHistory.GetLatestID();
+			view->inFlightSnapshots.push_back( inFlight );
+		}
+
+		next = view->PopHighestPriorityView();
+	}
+	return addedMessages;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Oldest first, rescanning every view after each update. Only the delta bookkeeping has kept up with the above.
+uint8_t NetObjectSystem::FillPacketWithUpdatesLegacy( NetPacket* packet, NetConnection* conn ) {
+	NetObjectConnectionView* view = m_connectionViews[conn->GetConnectionIndex()];
+	uint16_t packetAck = conn->GetNextAckToSend();
+	uint8_t addedMessages = 0;
+
+	// Anything older than the tracked packet history will never be confirmed
+	for ( unsigned int i = 0; i < view->inFlightSnapshots.size(); i++ ) {
+		if ( (uint16_t) (packetAck - view->inFlightSnapshots[i].packetAck) >= MAX_TRACKED_HISTORY_SIZE ) {
+			view->inFlightSnapshots[i] = view->inFlightSnapshots[ view->inFlightSnapshots.size() - 1 ];
+			view->inFlightSnapshots.pop_back();
+			i--;
+		}
+	}
+
+	NetObjectView_T* oldest = view->FindOldestView( session->GetNetTime() );
+
 	while ( packet->GetWrittenByteCount() < MTU && oldest != nullptr ) {
 
 		NetMessage update( NETMSG_OBJECT_UPDATE );
@@ -318,13 +469,38 @@ uint8_t NetObjectSystem::FillPacketWithUpdates( NetPacket* packet, NetConnection
 		if ( oldestObj != nullptr ) {
 			update.WriteValue<uint8_t>( oldest->typeID );
 			update.WriteValue<uint16_t>( oldest->networkID );
-			oldestDef.sendSnapshotCB( &update, oldestObj->snapshot );
 
-			if ( packet->GetWrittenByteCount() + update.GetWrittenByteCount() + 3 < MTU ) {
-				packet->WriteMessage( update );
+			bool isDelta = oldestDef.snapshotLayout.IsEnabled();
+			bool isFullSnapshot = false;
+			if ( isDelta ) {
+
+				// Nothing new since what they acked, it just goes to the back of the line
+				if ( !WriteSnapshotDelta( &update, oldestObj, oldest, &isFullSnapshot ) ) {
+					oldest->timeLastSent = session->GetNetTime();
+					oldest = view->FindOldestView( session->GetNetTime() );
+					continue;
+				}
+			} else {
+				oldestDef.sendSnapshotCB( &update, oldestObj->snapshot );
+			}
+
+			if ( packet->WriteMessage( update ) ) {
 				addedMessages++;
 				oldest->timeLastSent = session->GetNetTime();
-				oldest->lastSentSnapshot = oldestObj->snapshot;
+
+				if ( isDelta ) {
+					if ( isFullSnapshot ) {
+						oldest->updatesSinceFullSnapshot = 0;
+					} else {
+						oldest->updatesSinceFullSnapshot++;
+					}
+
+					NetSnapshotInFlight_T inFlight;
+					inFlight.packetAck = packetAck;
+					inFlight.networkID = oldest->networkID;
+					inFlight.snapshotID = oldestObj->snapshotHistory.GetLatestID();
+					view->inFlightSnapshots.push_back( inFlight );
+				}
 			} else {
 				break;
 			}
@@ -333,7 +509,280 @@ uint8_t NetObjectSystem::FillPacketWithUpdates( NetPacket* packet, NetConnection
 		else {
 			break;
 		}
-		oldest = view->FindOldestView();
+		oldest = view->FindOldestView( session->GetNetTime() );
 	}
 	return addedMessages;
-}
\ No newline at end of file
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Writes the object's latest snapshot against the newest one this view has acked. Returns false if they already have it.
+// The view isn't touched, the message may still not fit in the packet.
+bool NetObjectSystem::WriteSnapshotDelta( NetMessage* msg, NetObject* obj, NetObjectView_T* view, bool* out_isFullSnapshot ) {
+	NetSnapshotLayout const& layout = GetObjectTypeByID( obj->typeID ).snapshotLayout;
+	NetSnapshotHistory const& history = obj->snapshotHistory;
+	if ( history.IsEmpty() ) {
+		return false;
+	}
+
+	uint32_t snapshotID = history.GetLatestID();
+	if ( view->hasAckedSnapshot && view->ackedSnapshotID == snapshotID ) {
+		return false;
+	}
+
+	// Every so often a full one goes out anyway, in case the client ever had to guess at a baseline
+	void const* baseline = nullptr;
+	uint32_t baselineAge = 0;
+	if ( view->hasAckedSnapshot && view->updatesSinceFullSnapshot < NET_SNAPSHOT_FULL_UPDATE_INTERVAL ) {
+		baselineAge = snapshotID - view->ackedSnapshotID;
+		if ( baselineAge < NET_SNAPSHOT_MAX_BASELINE_AGE ) {
+			baseline = history.Find( view->ackedSnapshotID );
+		}
+		if ( baseline == nullptr ) {
+			baselineAge = 0;
+		}
+	}
+
+	*out_isFullSnapshot = (baseline == nullptr);
+
+	// Only the low byte of the ID goes out, the client rebuilds the rest from the IDs it has
+	msg->WriteValue<uint8_t>( (uint8_t) snapshotID );
+	msg->WriteValue<uint8_t>( (uint8_t) baselineAge );
+	layout.WriteDelta( msg, baseline, history.GetLatest() );
+	return true;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Called for every packet this connection acks, moves the baselines of the snapshots it carried forward
+void NetObjectSystem::OnPacketConfirmed( NetConnection* conn, uint16_t ack ) {
+	NetObjectConnectionView* view = m_connectionViews[ conn->GetConnectionIndex() ];
+	if ( view == nullptr ) {
+		return;
+	}
+
+	for ( unsigned int i = 0; i < view->inFlightSnapshots.size(); i++ ) {
+		NetSnapshotInFlight_T const& inFlight = view->inFlightSnapshots[i];
+		if ( inFlight.packetAck != ack ) {
+			continue;
+		}
+
+		std::map< uint16_t, NetObjectView_T* >::iterator viewIt = view->objectViewByNetworkID.find( inFlight.networkID );
+		if ( viewIt != view->objectViewByNetworkID.end() ) {
+			NetObjectView_T* objView = viewIt->second;
+
+			// Acks can come back out of order, only ever move forward
+			if ( !objView->hasAckedSnapshot || (int32_t) (inFlight.snapshotID - objView->ackedSnapshotID) > 0 ) {
+				objView->ackedSnapshotID = inFlight.snapshotID;
+				objView->hasAckedSnapshot = true;
+			}
+		}
+
+		view->inFlightSnapshots[i] = view->inFlightSnapshots[ view->inFlightSnapshots.size() - 1 ];
+		view->inFlightSnapshots.pop_back();
+		i--;
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void NetObjectSystem::SetConnectionFocus( uint8_t connectionIndex, Vector3 const& position ) {
+	NetObjectConnectionView* view = m_connectionViews[ connectionIndex ];
+	if ( view != nullptr ) {
+		view->focusPosition = position;
+		view->hasFocus = true;
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Client side. Rebuilds the snapshot from the baseline the host picked and applies it if it's the newest one.
+void NetObjectSystem::ReadSnapshotDelta( NetMessage* msg, NetObject* obj, float snapshotAge ) {
+	NetObjectDef_T const& typeDef = GetObjectTypeByID( obj->typeID );
+	NetSnapshotLayout const& layout = typeDef.snapshotLayout;
+	NetSnapshotHistory& history = obj->snapshotHistory;
+	if ( !history.IsInitialized() ) {
+		history.Initialize( layout.GetSnapshotSize() );
+	}
+
+	uint8_t shortID;
+	uint8_t baselineAge;
+	msg->ReadValue<uint8_t>( &shortID );
+	msg->ReadValue<uint8_t>( &baselineAge );
+
+	// Full IDs are only local, the wire carries the low byte and it's taken to be within 128 of the latest
+	uint32_t snapshotID = shortID;
+	bool isNewest = true;
+	if ( !history.IsEmpty() ) {
+		uint32_t latestID = history.GetLatestID();
+		int8_t offset = (int8_t) (uint8_t) (shortID - (uint8_t) latestID);
+		snapshotID = latestID + offset;
+		isNewest = offset > 0;
+
+		// Duplicates, and ones so late that storing them would push out newer snapshots
+		if ( offset == 0 || offset <= -NET_SNAPSHOT_HISTORY_SIZE || history.Find( snapshotID ) != nullptr ) {
+			return;
+		}
+	}
+
+	// A full update starts from the current state, so fields outside the layout keep their local values.
+	// A missing baseline only happens after a lot of reordering, the newest snapshot is the closest guess.
+	void const* baseline = obj->snapshot;
+	if ( baselineAge > 0 ) {
+		baseline = history.Find( snapshotID - baselineAge );
+		if ( baseline == nullptr ) {
+			baseline = history.IsEmpty() ? obj->snapshot : history.GetLatest();
+		}
+	}
+
+	// A delta that doesn't read cleanly never makes it into the history, nothing can use it as a baseline
+	m_receivedSnapshot.resize( layout.GetSnapshotSize() );
+	memcpy( m_receivedSnapshot.data(), baseline, layout.GetSnapshotSize() );
+	if ( !layout.ReadDelta( msg, m_receivedSnapshot.data() ) ) {
+		return;
+	}
+	history.Store( snapshotID, m_receivedSnapshot.data() );
+
+	if ( isNewest ) {
+		memcpy( obj->snapshot, m_receivedSnapshot.data(), layout.GetSnapshotSize() );
+		typeDef.applySnapshotCB( obj->snapshot, obj->localPtr, snapshotAge );
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Benchmark
+//----------------------------------------------------------------------------------------------------------------
+static Vector3 GetBenchmarkObjectPosition( void* obj ) {
+	return *(Vector3*) obj;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// A 20Hz session sending one packet per connection per tick, objects scattered over a 10km square and every
+// connection focused on one of them. No sockets or snapshots involved, and no NetSession either. The legacy
+// scan is the real NetObjectConnectionView::FindOldestView.
+NetPriorityBenchmarkResult_T NetObjectSystem::RunPriorityBenchmark( int objectCount, int connectionCount, int tickCount ) {
+	NetPriorityBenchmarkResult_T result;
+	result.objectCount = objectCount;
+	result.connectionCount = connectionCount;
+	result.tickCount = tickCount;
+
+	int const updatesPerPacket = MTU / 40;		// About one delta compressed entity update each
+	float const deltaSeconds = 1.f / 20.f;
+
+	NetObjectDef_T benchmarkType;
+	benchmarkType.getPositionCB = GetBenchmarkObjectPosition;
+	std::vector< NetObjectDef_T* > types;
+	types.push_back( &benchmarkType );
+
+	std::vector< Vector3 > positions( objectCount );
+	std::vector< NetObject > objects( objectCount );
+	for ( int i = 0; i < objectCount; i++ ) {
+		positions[i] = Vector3( GetRandomFloatInRange( -5000.f, 5000.f ), GetRandomFloatInRange( 0.f, 2000.f ), GetRandomFloatInRange( -5000.f, 5000.f ) );
+		objects[i].networkID = (uint16_t) i;
+		objects[i].localPtr = &positions[i];
+		objects[i].position = positions[i];
+	}
+
+	// Views are added in object order, so a view's index is its object's
+	std::vector< NetObjectConnectionView* > views( connectionCount );
+	std::vector< std::vector< bool > > isNear( connectionCount );
+	std::vector< float > distancesSquared( objectCount );
+	for ( int connIndex = 0; connIndex < connectionCount; connIndex++ ) {
+		NetObjectConnectionView* view = new NetObjectConnectionView();
+		view->connectionIndex = (uint8_t) connIndex;
+		view->focusPosition = positions[ GetRandomIntLessThan( objectCount ) ];
+		view->hasFocus = true;
+		for ( int i = 0; i < objectCount; i++ ) {
+			view->AddNetObject( &objects[i], 0.0 );
+		}
+		views[ connIndex ] = view;
+
+		for ( int i = 0; i < objectCount; i++ ) {
+			distancesSquared[i] = (positions[i] - view->focusPosition).GetLengthSquared();
+		}
+		std::vector< float > sortedDistances = distancesSquared;
+		int nearCount = Max( objectCount / 10, 1 );
+		std::nth_element( sortedDistances.begin(), sortedDistances.begin() + (nearCount - 1), sortedDistances.end() );
+		float nearDistanceSquared = sortedDistances[ nearCount - 1 ];
+
+		isNear[ connIndex ].resize( objectCount );
+		for ( int i = 0; i < objectCount; i++ ) {
+			isNear[ connIndex ][i] = distancesSquared[i] <= nearDistanceSquared;
+		}
+	}
+
+	int nearUpdates = 0;
+	uint64_t startCount = GetPerformanceCount();
+	for ( int tick = 0; tick < tickCount; tick++ ) {
+		for ( int connIndex = 0; connIndex < connectionCount; connIndex++ ) {
+			NetObjectConnectionView* view = views[ connIndex ];
+			view->AccumulatePriority( deltaSeconds, types );
+			view->BuildSendQueue();
+
+			NetObjectView_T* next = view->PopHighestPriorityView();
+			for ( int sent = 0; sent < updatesPerPacket && next != nullptr; sent++ ) {
+				next->priority = 0.f;
+				result.priorityUpdates++;
+				nearUpdates += isNear[ connIndex ][ next->object - objects.data() ] ? 1 : 0;
+				next = view->PopHighestPriorityView();
+			}
+		}
+	}
+	result.prioritySeconds = PerformanceCountToSeconds( GetPerformanceCount() - startCount );
+	result.priorityNearShare = (float) nearUpdates / (float) Max( result.priorityUpdates, 1 );
+
+	nearUpdates = 0;
+	startCount = GetPerformanceCount();
+	for ( int tick = 0; tick < tickCount; tick++ ) {
+		double netTime = (double) (tick + 1) * deltaSeconds;
+		for ( int connIndex = 0; connIndex < connectionCount; connIndex++ ) {
+			NetObjectConnectionView* view = views[ connIndex ];
+
+			for ( int sent = 0; sent < updatesPerPacket; sent++ ) {
+				NetObjectView_T* oldest = view->FindOldestView( netTime );
+				if ( oldest == nullptr ) {
+					break;
+				}
+				oldest->timeLastSent = netTime;
+				result.legacyUpdates++;
+				nearUpdates += isNear[ connIndex ][ oldest->object - objects.data() ] ? 1 : 0;
+			}
+		}
+	}
+	result.legacyScanSeconds = PerformanceCountToSeconds( GetPerformanceCount() - startCount );
+	result.legacyNearShare = (float) nearUpdates / (float) Max( result.legacyUpdates, 1 );
+
+	for ( int connIndex = 0; connIndex < connectionCount; connIndex++ ) {
+		delete views[ connIndex ];
+	}
+	return result;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void NetObjectSystem::PriorityBenchmarkCommand( std::string const& command ) {
+	std::vector< int > objectCounts;
+	Command parsed( command );
+	int argument = 0;
+	if ( parsed.PeekNextInt( argument ) && parsed.GetNextInt( argument ) && argument > 0 ) {
+		objectCounts.push_back( argument );
+	} else {
+		objectCounts = { 1000, 2500, 5000, 10000 };
+	}
+
+	for ( int objectCount : objectCounts ) {
+		NetPriorityBenchmarkResult_T result = RunPriorityBenchmark( objectCount, 32, 20 );
+		DevConsole::Printf( "%5d objects x %d connections: %.3f ms/tick priority queue, %.3f ms/tick oldest-first scan", objectCount, result.connectionCount,
+			result.prioritySeconds * 1000.0 / (double) result.tickCount, result.legacyScanSeconds * 1000.0 / (double) result.tickCount );
+		DevConsole::Printf( "      nearest tenth of objects got %.0f%% of updates, %.0f%% oldest-first", result.priorityNearShare * 100.f, result.legacyNearShare * 100.f );
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void NetObjectSystem::PriorityLegacyCommand( std::string const& command ) {
+	s_useLegacyPriority = !s_useLegacyPriority;
+	DevConsole::Printf( "net_priority_legacy: %s", s_useLegacyPriority ? "oldest-first scan" : "priority accumulators" );
+}
@@ -1,30 +1,56 @@
 #pragma once
 
+#include "Engine/Net/NetSnapshotLayout.hpp"
+#include "Engine/Math/Vector3.hpp"
+
+#include <string>
 #include <list>
 #include <vector>
 #include <map>
 
 class NetSession;
+class NetConnection;
 class NetObject;
+struct NetObjectDef_T;
 class NetMessage;
+class NetPacket;
 
 typedef void	(*send_create_cb)( NetMessage* msg, void* obj );		
 typedef void*	(*recv_create_cb)( NetMessage* msg );				
 typedef void	(*send_destroy_cb)( NetMessage* msg, void* obj );
 typedef void	(*recv_destroy_cb)( NetMessage* msg, void* obj );
 
+// Fills the snapshot in place, only allocating it when snapshot is still nullptr
 typedef void	(*get_snapshot_cb)( void*& snapshot, void* obj );
 typedef void	(*send_snapshot_cb)( NetMessage* msg, void* snapshot );
 typedef void	(*recv_snapshot_cb)( NetMessage* msg, void* snapshot );
 typedef void	(*apply_snapshot_cb)( void* snapshot, void* obj, float snapshotAge );
+typedef Vector3	(*get_position_cb)( void* obj );
+
+
+// Deltas are only ever built against a snapshot the connection has acked, any older and a full one is sent
+#define NET_SNAPSHOT_MAX_BASELINE_AGE (NET_SNAPSHOT_HISTORY_SIZE / 2)
+#define NET_SNAPSHOT_FULL_UPDATE_INTERVAL 64
 
 
 struct NetObjectView_T {
 	uint8_t typeID = 0;
 	uint16_t networkID = 0;
 	uint8_t ownerConnectionID = 0;
-	void* lastSentSnapshot = nullptr;
+	NetObject* object = nullptr;
+	float priority = 0.f;
 	double timeLastSent = 0.0;
+	uint32_t ackedSnapshotID = 0;
+	bool hasAckedSnapshot = false;
+	int updatesSinceFullSnapshot = 0;
+};
+
+
+// A snapshot sent in a packet that hasn't been acked yet
+struct NetSnapshotInFlight_T {
+	uint16_t packetAck = 0;
+	uint16_t networkID = 0;
+	uint32_t snapshotID = 0;
 };
 
 
@@ -35,15 +61,31 @@ public:
 
 public:
 	uint8_t connectionIndex;
-	std::list< NetObjectView_T* > objectViews;
+	std::vector< NetObjectView_T* > objectViews;
 	std::map< void*, NetObjectView_T* > objectViewByLocalPtr;
 	std::map< uint16_t, NetObjectView_T* > objectViewByNetworkID;
+	std::vector< NetSnapshotInFlight_T > inFlightSnapshots;
+
+	// Where this connection's player is, objects closer to it gain priority faster
+	Vector3 focusPosition;
+	bool hasFocus = false;
+	double timeLastAccumulated = 0.0;
 
-	void AddNetObject( NetObject* );
+	void AddNetObject( NetObject*, double netTime );
 	void RemoveNetObject( NetObject* );
 	void UpdateNetObject( NetObject* );
-	NetObjectView_T* FindOldestView();
 
+	// The oldest-first scan the accumulators replaced, still used while net_priority_legacy is on
+	NetObjectView_T* FindOldestView( double netTime );
+
+	// Every view gains priority while it waits, the packet filler takes the highest first and resets them
+	void AccumulatePriority( float deltaSeconds, std::vector< NetObjectDef_T* > const& types );
+	void BuildSendQueue();
+	NetObjectView_T* PopHighestPriorityView();
+
+
+private:
+	std::vector< NetObjectView_T* > m_sendQueue;		// Max heap on priority, rebuilt for every packet
 };
 
 
@@ -59,6 +101,29 @@ struct NetObjectDef_T {
 	send_snapshot_cb	sendSnapshotCB = nullptr;
 	recv_snapshot_cb	recvSnapshotCB = nullptr;
 	apply_snapshot_cb	applySnapshotCB = nullptr;
+
+	// Priority gained per second unsent is priorityWeight, scaled down by distance to the connection's focus
+	// when getPositionCB is set. At priorityFalloffDistance it's half as much.
+	float				priorityWeight = 1.f;
+	float				priorityFalloffDistance = 1000.f;
+	get_position_cb		getPositionCB = nullptr;
+
+	// Optional. When it has fields, snapshots go out as quantized deltas and the send/recv snapshot callbacks are unused
+	NetSnapshotLayout	snapshotLayout;
+};
+
+
+// Scheduling only, per tick every connection fills one packet's worth of updates
+struct NetPriorityBenchmarkResult_T {
+	int objectCount = 0;
+	int connectionCount = 0;
+	int tickCount = 0;
+	double prioritySeconds = 0.0;		// AccumulatePriority, BuildSendQueue and the pops
+	double legacyScanSeconds = 0.0;		// NetObjectConnectionView::FindOldestView once per update
+	int priorityUpdates = 0;
+	int legacyUpdates = 0;
+	float priorityNearShare = 0.f;		// Of the priority updates, how many went to the tenth of objects nearest the focus
+	float legacyNearShare = 0.f;
 };
 
 
@@ -69,6 +134,8 @@ public:
 	uint16_t networkID = 0;
 	void* localPtr = nullptr;
 	void* snapshot = nullptr;
+	NetSnapshotHistory snapshotHistory;		// Only used by types with a snapshot layout
+	Vector3 position;						// Refreshed with the snapshot when the type has getPositionCB
 };
 
 
@@ -93,6 +160,9 @@ public:
 	void RemoveNetObjectFromLists( NetObject* netObj );
 	void UpdateSnapshots();
 	uint8_t FillPacketWithUpdates( NetPacket* packet, NetConnection* conn );
+	void OnPacketConfirmed( NetConnection* conn, uint16_t ack );
+	void SetConnectionFocus( uint8_t connectionIndex, Vector3 const& position );
+	void ReadSnapshotDelta( NetMessage* msg, NetObject* obj, float snapshotAge );
 
 	// Views
 	void CreateViewForConnection( int connectionIndex );
@@ -100,11 +170,19 @@ public:
 	void OnConnectionJoined( NetConnection* conn );
 	void OnConnectionLeft( NetConnection* conn );
 
+	static NetPriorityBenchmarkResult_T RunPriorityBenchmark( int objectCount, int connectionCount, int tickCount );
+	static void PriorityBenchmarkCommand( std::string const& command );
+	static void PriorityLegacyCommand( std::string const& command );
+
+	static bool s_useLegacyPriority;
+
 
 public:
 	NetSession* session = nullptr;
 
 private:
+	bool WriteSnapshotDelta( NetMessage* msg, NetObject* obj, NetObjectView_T* view, bool* out_isFullSnapshot );
+	uint8_t FillPacketWithUpdatesLegacy( NetPacket* packet, NetConnection* conn );
 
 
 private:
@@ -117,4 +195,6 @@ private:
 	std::map< void*, NetObject* > m_localPtrObjectLookup;
 	std::map< uint16_t, NetObject* > m_netIDObjectLookup;
 
+	std::vector< uint8_t > m_receivedSnapshot;		// Deltas are decoded here and only stored once they read cleanly
+
 };
\ No newline at end of file
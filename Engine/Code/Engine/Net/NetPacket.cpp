@@ -3,12 +3,16 @@
 
 
 //----------------------------------------------------------------------------------------------------------------
-NetPacket::NetPacket() {
+NetPacket::NetPacket() 
+	: BytePacker( m_storage, MTU, 0 )
+{
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
-NetPacket::NetPacket( void* buffer, size_t length ) : BytePacker( ) {
+NetPacket::NetPacket( void* buffer, size_t length ) 
+	: BytePacker( m_storage, MTU, 0 )
+{
 	WriteBytes( length, buffer );
 }
 
@@ -19,6 +23,12 @@ NetPacket::~NetPacket() {
 }
 
 
+//----------------------------------------------------------------------------------------------------------------
+void NetPacket::SetReceivedByteCount( size_t byteCount ) {
+	WrapBuffer( m_storage, MTU, byteCount );
+}
+
+
 //----------------------------------------------------------------------------------------------------------------
 void NetPacket::WriteHeader( NetPacketHeader_T header ) {
 	WriteBytesAt( 1, &header.connectionIndex, 0 );
@@ -30,19 +40,28 @@ void NetPacket::WriteHeader( NetPacketHeader_T header ) {
 
 
 //----------------------------------------------------------------------------------------------------------------
-void NetPacket::WriteMessage( NetMessage const& message ) {
-
-	uint8_t headerSize;
-
+// Size field plus index, reliable ID and sequence ID
+size_t NetPacket::GetMessageHeaderSize( NetMessage const& message ) {
 	if ( message.IsInOrder() ) {
-		headerSize = 5;
+		return 7;
 	} else if ( message.IsReliable() ) {
-		headerSize = 3;
+		return 5;
 	} else {
-		headerSize = 1;
+		return 3;
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+bool NetPacket::WriteMessage( NetMessage const& message ) {
+
+	size_t headerSize = GetMessageHeaderSize( message );
+	if ( headerSize + message.GetMessageLength() > GetRemainingWritableByteCount() ) {
+		return false;
 	}
 
-	WriteValue<uint16_t>( (uint16_t) message.GetMessageLength() + headerSize );
+	// The size field doesn't count itself
+	WriteValue<uint16_t>( (uint16_t) (message.GetMessageLength() + headerSize - 2) );
 	WriteValue<uint8_t>( message.GetMessageIndex() );
 	if ( message.IsReliable() ) {
 		WriteValue<uint16_t>( message.GetReliableID() );
@@ -51,6 +70,7 @@ void NetPacket::WriteMessage( NetMessage const& message ) {
 		WriteValue<uint16_t>( message.GetSequenceID() );
 	}
 	WriteBytes( message.GetMessageLength(), message.GetBuffer() );
+	return true;
 }
 
 
@@ -65,44 +85,37 @@ void NetPacket::ReadHeader( NetPacketHeader_T& out_header ) {
 
 
 //----------------------------------------------------------------------------------------------------------------
-NetMessage* NetPacket::ReadMessage( NetSession* session ) {
-	uint16_t size;
-	ReadValue<uint16_t>( &size );
+// No copy, the message just points at its payload in our buffer
+bool NetPacket::ReadMessage( NetMessage& out_message ) {
+	uint16_t size = 0;
+	uint8_t messageIndex = 0xFF;
+	if ( ReadValue<uint16_t>( &size ) != sizeof(uint16_t) || ReadValue<uint8_t>( &messageIndex ) != sizeof(uint8_t) ) {
+		return false;
+	}
 
-	uint8_t messageIndex;
-	ReadValue<uint8_t>( &messageIndex );
+	NetCommand const& command = NetSession::GetCommand( messageIndex );
+	uint16_t reliableID = 0;
+	uint16_t sequenceID = 0;
+	size_t headerSize = 1;
 
-	if ( NetSession::GetCommand( messageIndex ).IsInOrder() ) {
-		uint16_t reliableID;
+	if ( command.IsReliable() ) {
 		ReadValue<uint16_t>( &reliableID );
-
-		uint16_t sequenceID;
+		headerSize += 2;
+	}
+	if ( command.IsInOrder() ) {
 		ReadValue<uint16_t>( &sequenceID );
-
-		char* buffer = new char[size - 5U];
-		ReadBytes( buffer, size - 5U );
-
-		NetMessage* message = new NetMessage( messageIndex, (byte_t*) buffer, size - 5U, reliableID, sequenceID );
-		return message;
+		headerSize += 2;
 	}
 
-	else if ( NetSession::GetCommand( messageIndex ).IsReliable() ) {
-
-		uint16_t reliableID;
-		ReadValue<uint16_t>( &reliableID );
-
-		char* buffer = new char[size - 3U];
-		ReadBytes( buffer, size - 3U );
-
-		NetMessage* message = new NetMessage( messageIndex, (byte_t*) buffer, size - 3U, reliableID );
-		return message;
+	if ( size < headerSize || size - headerSize > GetRemainingReadableByteCount() ) {
+		return false;
 	}
 
-	else {
-		char* buffer = new char[size - 1U];
-		ReadBytes( buffer, size - 1U );
-
-		NetMessage* message = new NetMessage( messageIndex, (byte_t*) buffer, size - 1U );
-		return message;
-	}
-}
\ No newline at end of file
+	size_t payloadSize = size - headerSize;
+	out_message.WrapBuffer( GetReadHead(), payloadSize, payloadSize );
+	out_message.m_messageIndex = messageIndex;
+	out_message.m_reliableID = reliableID;
+	out_message.m_sequenceID = sequenceID;
+	SkipBytes( payloadSize );
+	return true;
+}
@@ -18,6 +18,8 @@ struct NetPacketHeader_T {
 };
 
 
+//----------------------------------------------------------------------------------------------------------------
+// One datagram, held inline so packets can live on the stack or be recycled without allocating
 class NetPacket : public BytePacker {
 
 public:
@@ -25,13 +27,17 @@ public:
 	NetPacket( void* buffer, size_t length );
 	~NetPacket();
 
+	void SetReceivedByteCount( size_t byteCount );		// After receiving straight into GetBuffer()
+
 	void WriteHeader( NetPacketHeader_T header );
-	void WriteMessage( NetMessage const& message );
+	bool WriteMessage( NetMessage const& message );		// False if it won't fit in the MTU
 
 	void ReadHeader( NetPacketHeader_T& out_header );
-	NetMessage* ReadMessage( NetSession* session );
+	bool ReadMessage( NetMessage& out_message );		// out_message becomes a view into this packet, false if malformed
 
-private:
+	static size_t GetMessageHeaderSize( NetMessage const& message );
 
+private:
+	byte_t m_storage[ MTU ];
 
 };
\ No newline at end of file
@@ -175,7 +175,7 @@ bool OnJoinRequest( NetMessage& message, NetConnection& sender ) {
 	}
 
 	if ( shouldAccept ) {
-		Logger::PrintTaggedf( "Debug", "Accepting join request from %s", info.addr.to_string().c_str() );
+		LOG_TAGGEDF( "Debug", "Accepting join request from %s", info.addr.to_string().c_str() );
 
 		NetMessage acceptMsg( sender.m_session->GetMessageIndexForName( "join_accept" ) );
 		acceptMsg.WriteValue<uint8_t>( info.sessionIndex );
@@ -194,7 +194,7 @@ bool OnJoinRequest( NetMessage& message, NetConnection& sender ) {
 	} 
 	
 	else {
-		Logger::PrintTaggedf( "Debug", "Declining join request from %s", info.addr.to_string().c_str() );
+		LOG_TAGGEDF( "Debug", "Declining join request from %s", info.addr.to_string().c_str() );
 		NetMessage denyMsg( sender.m_session->GetMessageIndexForName( "join_deny" ) );
 		sender.SendPacketImmediate( sender.m_session->GetSocket(), denyMsg );
 
@@ -233,7 +233,7 @@ bool OnJoinAccept( NetMessage& message, NetConnection& sender ) {
 bool OnJoinDeny( NetMessage& message, NetConnection& sender ) {
 	if ( NetSession::instance->GetState() == SESSION_CONNECTING ) {
 		NetSession::instance->Disconnect();
-		Logger::PrintTaggedf("NetSession", "Received a join deny");
+		LOG_TAGGEDF("NetSession", "Received a join deny");
 	}
 
 	return true;
@@ -340,10 +340,16 @@ bool OnNetObjectUpdate( NetMessage& message, NetConnection& sender ) {
 	NetObjectDef_T const& typeDef = NetSession::instance->netObjectSystem->GetObjectTypeByID( typeID );
 	NetObject* obj = NetSession::instance->netObjectSystem->GetObjectByNetID( networkID );
 
+	// Snapshots don't carry a send time, half the round trip is how long this one has been travelling
 	if ( obj != nullptr ) {
-		void* snapshot = obj->snapshot;
-		typeDef.recvSnapshotCB( &message, snapshot ); 
-		typeDef.applySnapshotCB( snapshot, obj->localPtr, 0.f );
+		float snapshotAge = sender.GetRTT() * 0.5f;
+		if ( typeDef.snapshotLayout.IsEnabled() ) {
+			NetSession::instance->netObjectSystem->ReadSnapshotDelta( &message, obj, snapshotAge );
+		} else {
+			void* snapshot = obj->snapshot;
+			typeDef.recvSnapshotCB( &message, snapshot ); 
+			typeDef.applySnapshotCB( snapshot, obj->localPtr, snapshotAge );
+		}
 	}
 
 	return true;
@@ -412,6 +418,13 @@ NetSession::NetSession()
 	CommandRegistration::RegisterCommand( "host", HostCommand, "port - Starts hosting a game net session" );
 	CommandRegistration::RegisterCommand( "join", JoinCommand, "ip:port id - Sends a join request to the ip" );
 	CommandRegistration::RegisterCommand( "disconnect", DisconnectCommand, " - Sends a join request to the ip" );
+	CommandRegistration::RegisterCommand( "net_alloc_stats", NetAllocator::PrintStatsCommand, " - Prints net heap allocations, which should stop growing once a session is running" );
+	CommandRegistration::RegisterCommand( "net_priority_bench", NetObjectSystem::PriorityBenchmarkCommand, "[objects] - Times net object update scheduling for 32 connections, 1k-10k objects by default, against the oldest-first scan" );
+	CommandRegistration::RegisterCommand( "net_priority_legacy", NetObjectSystem::PriorityLegacyCommand, " - Toggles update scheduling back to the oldest-first scan" );
+
+	for ( int i = 0; i < UDP_MAX_BATCH_SIZE; i++ ) {
+		m_receiveBatch[i] = new PacketInLatencySim_T();
+	}
 
 	instance = this;
 	netObjectSystem = new NetObjectSystem( this );
@@ -439,6 +452,14 @@ NetSession::~NetSession() {
 		delete m_incomingPackets[i];
 		m_incomingPackets[i] = nullptr;
 	}
+
+	for ( int i = 0; i < UDP_MAX_BATCH_SIZE; i++ ) {
+		delete m_receiveBatch[i];
+		m_receiveBatch[i] = nullptr;
+
+		delete m_outgoingPackets[i];
+		m_outgoingPackets[i] = nullptr;
+	}
 }
 
 
@@ -473,13 +494,13 @@ void NetSession::Host( std::string const& myID, uint16_t port, uint16_t portRang
 	
 	// We must be currently disconnected to host
 	if ( m_state != SESSION_DISCONNECTED ) {
-		Logger::PrintTaggedf( "NetSession", "Cannot host - not in a disconnected state!" );
+		LOG_TAGGEDF( "NetSession", "Cannot host - not in a disconnected state!" );
 		return;
 	}
 	
 	// Attempt to bind my socket
 	if ( !AddBinding( port ) ) {
-		Logger::PrintTaggedf( "NetSession", "Cannot host - failed to bind the socket!" );
+		LOG_TAGGEDF( "NetSession", "Cannot host - failed to bind the socket!" );
 		return;
 	}
 	
@@ -589,7 +610,7 @@ void NetSession::Update() {
 	if ( m_state == SESSION_CONNECTING ) {
 		if ( m_joinTimer.CheckAndReset() ) {
 			Disconnect();
-			Logger::PrintTaggedf( "NetSession", "Join timed out" );
+			LOG_TAGGEDF( "NetSession", "Join timed out" );
 		}
 	}
 
@@ -621,16 +642,24 @@ void NetSession::Update() {
 void NetSession::ProcessIncoming() {
 
 	if ( m_state != SESSION_DISCONNECTED ) {
-		char buffer[ MTU ];
 
-		NetAddress_T from_addr; 
-		size_t read = m_socket->ReceiveFrom( from_addr, buffer, MTU ); 
-		while ( read > 0U ) {
-
-			NetPacket* packet = new NetPacket( buffer, read );
-			AddPacketToLatencyQueue( packet, from_addr );
+		// Receive a batch at a time straight into the session's packets. Only the ones the latency queue
+		// takes are replaced, dropped packets and unused slots wait for the next receive.
+		int received = UDP_MAX_BATCH_SIZE;
+		while ( received == UDP_MAX_BATCH_SIZE ) {
+			for ( int i = 0; i < UDP_MAX_BATCH_SIZE; i++ ) {
+				m_receiveDatagrams[i].buffer = m_receiveBatch[i]->packet.GetBuffer();
+				m_receiveDatagrams[i].byteCount = MTU;
+			}
 
-			read = m_socket->ReceiveFrom( from_addr, buffer, MTU ); 
+			received = m_socket->ReceiveMany( m_receiveDatagrams, UDP_MAX_BATCH_SIZE );
+			for ( int i = 0; i < received; i++ ) {
+				m_receiveBatch[i]->addr = m_receiveDatagrams[i].address;
+				m_receiveBatch[i]->packet.SetReceivedByteCount( m_receiveDatagrams[i].byteCount );
+				if ( AddPacketToLatencyQueue( m_receiveBatch[i] ) ) {
+					m_receiveBatch[i] = new PacketInLatencySim_T();
+				}
+			}
 		}
 
 		ProcessLatencyQueue();
@@ -640,7 +669,7 @@ void NetSession::ProcessIncoming() {
 
 //----------------------------------------------------------------------------------------------------------------
 void NetSession::ProcessPacket( PacketInLatencySim_T* wrappedPacket ) {
-	NetPacket* packet = wrappedPacket->packet;
+	NetPacket* packet = &wrappedPacket->packet;
 
 	NetPacketHeader_T header;
 	packet->ReadHeader( header );
@@ -653,34 +682,37 @@ void NetSession::ProcessPacket( PacketInLatencySim_T* wrappedPacket ) {
 	// If the packet doesn't specify a connection it came from
 	else {
 
+		NetMessage message;
 		for ( int i = 0; i < header.messageCount; i++ ) {
-			NetMessage* message = packet->ReadMessage( this );
-			NetCommand netCommand = GetCommand( message->GetMessageIndex() );
+			if ( !packet->ReadMessage( message ) ) {
+				DevConsole::Printf("A message was malformed");
+				break;
+			}
 
-			if (!netCommand.RequiresConnection()) {
+			NetCommand const& netCommand = GetCommand( message.GetMessageIndex() );
+			if ( netCommand.id == 0xFF ) {
+				DevConsole::Printf("Message index was not valid");
+			}
+			else if (!netCommand.RequiresConnection()) {
 				NetConnection tempConnection( this, 0xFF, wrappedPacket->addr );
-				netCommand.callback( *message, tempConnection );
+				netCommand.callback( message, tempConnection );
 			}
 			else {
 				DevConsole::Printf("Received a message that requires a connection without one");
 			}
-			
-			delete message;
-			message = nullptr;
 		}
 	}
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
-void NetSession::AddPacketToLatencyQueue( NetPacket* packet, NetAddress_T addr ) {
+bool NetSession::AddPacketToLatencyQueue( PacketInLatencySim_T* packet ) {
 	if ( GetRandomFloatZeroToOne() > m_simLossRate ) {
-		PacketInLatencySim_T* p = new PacketInLatencySim_T();
-		p->packet = packet;
-		p->timestamp = m_sessionClock->total.seconds + m_simLatency.GetRandomInRange();
-		p->addr = addr;
-		m_incomingPackets.push_back(p);
+		packet->timestamp = m_sessionClock->total.seconds + m_simLatency.GetRandomInRange();
+		m_incomingPackets.push_back( packet );
+		return true;
 	}
+	return false;
 }
 
 
@@ -701,6 +733,39 @@ void NetSession::ProcessLatencyQueue() {
 }
 
 
+//----------------------------------------------------------------------------------------------------------------
+void NetSession::QueueOutgoingPacket( NetConnection* connection ) {
+	if ( m_outgoingPacketCount == UDP_MAX_BATCH_SIZE ) {
+		FlushOutgoingPackets();
+	}
+
+	if ( m_outgoingPackets[ m_outgoingPacketCount ] == nullptr ) {
+		m_outgoingPackets[ m_outgoingPacketCount ] = new NetPacket();
+	}
+
+	NetPacket& packet = *m_outgoingPackets[ m_outgoingPacketCount ];
+	packet.ResetWriteHead();
+	if ( !connection->BuildPacket( packet ) ) {
+		return;
+	}
+
+	UDPDatagram_T& datagram = m_outgoingDatagrams[ m_outgoingPacketCount ];
+	datagram.address = connection->GetAddress();
+	datagram.buffer = packet.GetBuffer();
+	datagram.byteCount = packet.GetWrittenByteCount();
+	m_outgoingPacketCount++;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void NetSession::FlushOutgoingPackets() {
+	if ( m_outgoingPacketCount > 0 ) {
+		m_socket->SendMany( m_outgoingDatagrams, m_outgoingPacketCount );
+		m_outgoingPacketCount = 0;
+	}
+}
+
+
 //----------------------------------------------------------------------------------------------------------------
 bool NetSession::IsValidConnectionIndex( uint8_t connectionIndex ) {
 	
@@ -737,7 +802,7 @@ void NetSession::ProcessOutgoing() {
 			while ( it != m_allConnections.end() ) {
 				if ( *it != nullptr ) {
 					if ( (*it)->HasTickElapsed() ) {
-						(*it)->SendPacket( m_socket );
+						QueueOutgoingPacket( *it );
 					}
 				}
 				it++;
@@ -749,12 +814,14 @@ void NetSession::ProcessOutgoing() {
 			while ( it != m_allConnections.end() ) {
 				if ( *it != nullptr ) {
 					if ( (*it)->HasTickElapsed() ) {
-						(*it)->SendPacket( m_socket );
+						QueueOutgoingPacket( *it );
 					}
 				}
 				it++;
 			}
 		}
+
+		FlushOutgoingPackets();
 	}
 }
 
@@ -991,7 +1058,12 @@ NetConnection* NetSession::GetMyConnection() const {
 
 
 //----------------------------------------------------------------------------------------------------------------
-NetCommand NetSession::GetCommand( uint8_t index ) {
+// Unregistered indices (say, from a bad packet) get the null command
+NetCommand const& NetSession::GetCommand( uint8_t index ) {
+	static NetCommand s_invalidCommand;
+	if ( index >= m_registeredMessages.size() ) {
+		return s_invalidCommand;
+	}
 	return m_registeredMessages[index];
 }
 
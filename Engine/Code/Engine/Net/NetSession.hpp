@@ -23,7 +23,6 @@
 #define DEFAULT_PORT_RANGE 32
 #define CLIENT_SYNC_MAX_TIME 10
 #define MAX_CLIENTS 32
-#define MTU (1500-48)
 #define UNRELIABLE_RESEND_TIME 0.1f
 #define MAX_RELIABLES_PER_PACKET 32
 #define JOIN_TIMEOUT 10.f
@@ -48,9 +47,9 @@ struct NetCommand {
 	uint16_t flags = 0;
 	uint8_t channel = 0;
 
-	bool RequiresConnection()	{ return !(flags & NETMSG_OPTION_CONNECTIONLESS); }
-	bool IsReliable()			{ return (flags & NETMSG_OPTION_RELIABLE) == NETMSG_OPTION_RELIABLE; }
-	bool IsInOrder()			{ return (flags & NETMSG_OPTION_IN_ORDER) == NETMSG_OPTION_IN_ORDER; }
+	bool RequiresConnection() const	{ return !(flags & NETMSG_OPTION_CONNECTIONLESS); }
+	bool IsReliable() const			{ return (flags & NETMSG_OPTION_RELIABLE) == NETMSG_OPTION_RELIABLE; }
+	bool IsInOrder() const			{ return (flags & NETMSG_OPTION_IN_ORDER) == NETMSG_OPTION_IN_ORDER; }
 };
 
 
@@ -97,15 +96,14 @@ enum eNetCoreMessage {
 
 
 
+// Received straight into the inline packet, recycled through NetAllocator
 struct PacketInLatencySim_T {
-	NetPacket* packet;
+	NetPacket packet;
 	NetAddress_T addr;
-	float timestamp;
+	float timestamp = 0.f;
 
-	~PacketInLatencySim_T() {
-		delete packet;
-		packet = nullptr;
-	}
+	static void* operator new( size_t size )				{ return NetAllocator::Allocate( size ); }
+	static void operator delete( void* memory, size_t size )	{ NetAllocator::Free( memory, size ); }
 };
 
 
@@ -129,7 +127,7 @@ public:
 	void ProcessOutgoing();		// Tries to send all messages in the queue - At the end of Game's update
 	void ProcessIncoming();		// Does receives, unpacks the messages and fires the callbacks if needed - beginning of game update
 	void ProcessPacket( PacketInLatencySim_T* packet );
-	void AddPacketToLatencyQueue( NetPacket* packet, NetAddress_T addr );
+	bool AddPacketToLatencyQueue( PacketInLatencySim_T* packet );		// False if the loss sim dropped it, caller keeps it
 	void ProcessLatencyQueue();
 
 	void Update();				// Called at the beginning of ProcessOutgoing()
@@ -168,7 +166,7 @@ public:
 	// Processing received messages
 	static net_message_cb GetCallbackForMessage( uint8_t index ); // can return nullptr if registered message isn't found
 	static uint8_t GetMessageIndexForName( std::string const& name );
-	static NetCommand GetCommand( uint8_t index );
+	static NetCommand const& GetCommand( uint8_t index );
 
 
 	//----------------------------------------------------------------------------------------------------------------
@@ -229,6 +227,8 @@ public:
 
 private:
 	bool AddBinding( unsigned short session );
+	void QueueOutgoingPacket( NetConnection* connection );	// Builds the connection's packet into the send batch
+	void FlushOutgoingPackets();
 
 
 public:
@@ -251,6 +251,16 @@ private:
 
 	std::vector< PacketInLatencySim_T* > m_incomingPackets;
 
+	// Receives land here. Slots handed to the latency queue get a fresh packet, the rest are reused next frame.
+	PacketInLatencySim_T*				m_receiveBatch[ UDP_MAX_BATCH_SIZE ] = {};
+	UDPDatagram_T						m_receiveDatagrams[ UDP_MAX_BATCH_SIZE ];
+
+	// Packets built this tick, sent with one SendMany. Allocated the first time a slot is used and kept,
+	// most sessions only ever need one per connection.
+	NetPacket*							m_outgoingPackets[ UDP_MAX_BATCH_SIZE ] = {};
+	UDPDatagram_T						m_outgoingDatagrams[ UDP_MAX_BATCH_SIZE ];
+	int									m_outgoingPacketCount = 0;
+
 	session_join_cb m_joinCallback = nullptr;
 	session_leave_cb m_leaveCallback = nullptr;
 
@@ -0,0 +1,461 @@
+#include "Engine/Net/NetSnapshotLayout.hpp"
+#include "Engine/Net/NetBitStream.hpp"
+#include "Engine/Core/BytePacker.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+
+#include <math.h>
+#include <string.h>
+
+
+//----------------------------------------------------------------------------------------------------------------
+static uint32_t GetMaxQuantizedValue( uint8_t bitCount ) {
+	return (bitCount >= 32) ? 0xFFFFFFFFu : ((1u << bitCount) - 1u);
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Doubles so 24+ bit fields don't lose steps to float precision
+static uint32_t QuantizeFloat( float value, float minValue, float maxValue, uint8_t bitCount ) {
+	double fraction = ((double) value - (double) minValue) / ((double) maxValue - (double) minValue);
+	if ( !(fraction > 0.0) ) {
+		fraction = 0.0;		// Also catches NaN
+	} else if ( fraction > 1.0 ) {
+		fraction = 1.0;
+	}
+	return (uint32_t) ((fraction * (double) GetMaxQuantizedValue( bitCount )) + 0.5);
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+static float DequantizeFloat( uint32_t quantized, float minValue, float maxValue, uint8_t bitCount ) {
+	double fraction = (double) quantized / (double) GetMaxQuantizedValue( bitCount );
+	return (float) ((double) minValue + (fraction * ((double) maxValue - (double) minValue)));
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// 360 wraps back to 0, so the steps are 360 / 2^bits rather than 360 / (2^bits - 1)
+static uint32_t QuantizeAngle( float degrees, uint8_t bitCount ) {
+	double wrapped = fmod( (double) degrees, 360.0 );
+	if ( wrapped < 0.0 ) {
+		wrapped += 360.0;
+	}
+	double stepCount = (double) (1ull << bitCount);
+	uint64_t quantized = (uint64_t) (((wrapped / 360.0) * stepCount) + 0.5);
+	return (uint32_t) (quantized & ((1ull << bitCount) - 1ull));
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+static float DequantizeAngle( uint32_t quantized, uint8_t bitCount ) {
+	return (float) (((double) quantized * 360.0) / (double) (1ull << bitCount));
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+static float SignNotZero( float value ) {
+	return (value >= 0.f) ? 1.f : -1.f;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Octahedral mapping, the unit sphere folded onto a square
+static void EncodeUnitVector( float const* vector, uint8_t bitCount, uint32_t* out_values ) {
+	float length = fabsf( vector[0] ) + fabsf( vector[1] ) + fabsf( vector[2] );
+	float u = 0.f;
+	float v = 0.f;
+
+	if ( length > 0.f ) {
+		u = vector[0] / length;
+		v = vector[1] / length;
+		if ( vector[2] < 0.f ) {
+			float foldedU = (1.f - fabsf( v )) * SignNotZero( u );
+			float foldedV = (1.f - fabsf( u )) * SignNotZero( v );
+			u = foldedU;
+			v = foldedV;
+		}
+	}
+
+	out_values[0] = QuantizeFloat( u, -1.f, 1.f, bitCount );
+	out_values[1] = QuantizeFloat( v, -1.f, 1.f, bitCount );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+static void DecodeUnitVector( uint32_t const* values, uint8_t bitCount, float* out_vector ) {
+	float u = DequantizeFloat( values[0], -1.f, 1.f, bitCount );
+	float v = DequantizeFloat( values[1], -1.f, 1.f, bitCount );
+	float x = u;
+	float y = v;
+	float z = 1.f - fabsf( u ) - fabsf( v );
+
+	if ( z < 0.f ) {
+		x = (1.f - fabsf( v )) * SignNotZero( u );
+		y = (1.f - fabsf( u )) * SignNotZero( v );
+	}
+
+	float length = sqrtf( (x * x) + (y * y) + (z * z) );
+	out_vector[0] = x / length;
+	out_vector[1] = y / length;
+	out_vector[2] = z / length;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Everything turns into up to three integers of field.bitCount (or the type's natural size) bits.
+// Changes are detected on these, so a value that wobbles inside one quantization step isn't resent.
+static int QuantizeField( NetSnapshotField_T const& field, void const* snapshot, uint32_t* out_values, uint8_t* out_bitCount ) {
+	uint8_t const* fieldData = ((uint8_t const*) snapshot) + field.offset;
+	float const* components = (float const*) fieldData;
+
+	switch ( field.type ) {
+	case NETFIELD_BOOL:
+		out_values[0] = (*fieldData != 0) ? 1 : 0;
+		*out_bitCount = 1;
+		return 1;
+
+	case NETFIELD_UINT8:
+		out_values[0] = *fieldData;
+		*out_bitCount = 8;
+		return 1;
+
+	case NETFIELD_INT32:
+	case NETFIELD_FLOAT:
+		memcpy( out_values, fieldData, 4 );
+		*out_bitCount = 32;
+		return 1;
+
+	case NETFIELD_VECTOR3:
+		memcpy( out_values, fieldData, 12 );
+		*out_bitCount = 32;
+		return 3;
+
+	case NETFIELD_QUANTIZED_FLOAT:
+		out_values[0] = QuantizeFloat( components[0], field.minValue, field.maxValue, field.bitCount );
+		*out_bitCount = field.bitCount;
+		return 1;
+
+	case NETFIELD_QUANTIZED_VECTOR3:
+		for ( int i = 0; i < 3; i++ ) {
+			out_values[i] = QuantizeFloat( components[i], field.minValue, field.maxValue, field.bitCount );
+		}
+		*out_bitCount = field.bitCount;
+		return 3;
+
+	case NETFIELD_ANGLES:
+		for ( int i = 0; i < 3; i++ ) {
+			out_values[i] = QuantizeAngle( components[i], field.bitCount );
+		}
+		*out_bitCount = field.bitCount;
+		return 3;
+
+	case NETFIELD_UNIT_VECTOR:
+		EncodeUnitVector( components, field.bitCount, out_values );
+		*out_bitCount = field.bitCount;
+		return 2;
+
+	default:
+		*out_bitCount = 0;
+		return 0;
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+static int GetFieldValueCount( eNetFieldType type ) {
+	switch ( type ) {
+	case NETFIELD_VECTOR3:
+	case NETFIELD_QUANTIZED_VECTOR3:
+	case NETFIELD_ANGLES:			return 3;
+	case NETFIELD_UNIT_VECTOR:		return 2;
+	default:						return 1;
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+static uint8_t GetFieldBitCount( NetSnapshotField_T const& field ) {
+	switch ( field.type ) {
+	case NETFIELD_BOOL:		return 1;
+	case NETFIELD_UINT8:	return 8;
+	case NETFIELD_INT32:
+	case NETFIELD_FLOAT:
+	case NETFIELD_VECTOR3:	return 32;
+	default:				return field.bitCount;
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+static void DequantizeField( NetSnapshotField_T const& field, uint32_t const* values, void* snapshot ) {
+	uint8_t* fieldData = ((uint8_t*) snapshot) + field.offset;
+	float* components = (float*) fieldData;
+
+	switch ( field.type ) {
+	case NETFIELD_BOOL:
+		*((bool*) fieldData) = (values[0] != 0);
+		break;
+
+	case NETFIELD_UINT8:
+		*fieldData = (uint8_t) values[0];
+		break;
+
+	case NETFIELD_INT32:
+	case NETFIELD_FLOAT:
+		memcpy( fieldData, values, 4 );
+		break;
+
+	case NETFIELD_VECTOR3:
+		memcpy( fieldData, values, 12 );
+		break;
+
+	case NETFIELD_QUANTIZED_FLOAT:
+		components[0] = DequantizeFloat( values[0], field.minValue, field.maxValue, field.bitCount );
+		break;
+
+	case NETFIELD_QUANTIZED_VECTOR3:
+		for ( int i = 0; i < 3; i++ ) {
+			components[i] = DequantizeFloat( values[i], field.minValue, field.maxValue, field.bitCount );
+		}
+		break;
+
+	case NETFIELD_ANGLES:
+		for ( int i = 0; i < 3; i++ ) {
+			components[i] = DequantizeAngle( values[i], field.bitCount );
+		}
+		break;
+
+	case NETFIELD_UNIT_VECTOR:
+		DecodeUnitVector( values, field.bitCount, components );
+		break;
+
+	default:
+		break;
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// NetSnapshotLayout
+//----------------------------------------------------------------------------------------------------------------
+void NetSnapshotLayout::SetSnapshotSize( size_t snapshotSize ) {
+	m_snapshotSize = snapshotSize;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void NetSnapshotLayout::AddField( eNetFieldType type, size_t offset ) {
+	GUARANTEE_OR_DIE( m_fields.size() < NET_SNAPSHOT_MAX_FIELDS, "Too many fields in a NetSnapshotLayout" );
+
+	NetSnapshotField_T field;
+	field.type = type;
+	field.offset = offset;
+	m_fields.push_back( field );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void NetSnapshotLayout::AddQuantizedFloat( size_t offset, float minValue, float maxValue, uint8_t bitCount ) {
+	AddField( NETFIELD_QUANTIZED_FLOAT, offset );
+	m_fields.back().minValue = minValue;
+	m_fields.back().maxValue = maxValue;
+	m_fields.back().bitCount = bitCount;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void NetSnapshotLayout::AddQuantizedVector3( size_t offset, float minValue, float maxValue, uint8_t bitCount ) {
+	AddField( NETFIELD_QUANTIZED_VECTOR3, offset );
+	m_fields.back().minValue = minValue;
+	m_fields.back().maxValue = maxValue;
+	m_fields.back().bitCount = bitCount;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void NetSnapshotLayout::AddAngles( size_t offset, uint8_t bitCount ) {
+	GUARANTEE_OR_DIE( bitCount < 32, "Angles need fewer than 32 bits" );
+	AddField( NETFIELD_ANGLES, offset );
+	m_fields.back().bitCount = bitCount;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void NetSnapshotLayout::AddUnitVector( size_t offset, uint8_t bitCount ) {
+	AddField( NETFIELD_UNIT_VECTOR, offset );
+	m_fields.back().bitCount = bitCount;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+bool NetSnapshotLayout::IsEnabled() const {
+	return m_snapshotSize > 0 && !m_fields.empty();
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+size_t NetSnapshotLayout::GetSnapshotSize() const {
+	return m_snapshotSize;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+bool NetSnapshotLayout::HasChanged( void const* baseline, void const* snapshot ) const {
+	for ( unsigned int i = 0; i < m_fields.size(); i++ ) {
+		uint32_t values[3];
+		uint32_t baselineValues[3];
+		uint8_t bitCount;
+		int valueCount = QuantizeField( m_fields[i], snapshot, values, &bitCount );
+		QuantizeField( m_fields[i], baseline, baselineValues, &bitCount );
+
+		if ( memcmp( values, baselineValues, valueCount * sizeof(uint32_t) ) != 0 ) {
+			return true;
+		}
+	}
+	return false;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int NetSnapshotLayout::WriteDelta( BytePacker* packer, void const* baseline, void const* snapshot ) const {
+	uint32_t values[ NET_SNAPSHOT_MAX_FIELDS ][3];
+	uint8_t bitCounts[ NET_SNAPSHOT_MAX_FIELDS ];
+	int valueCounts[ NET_SNAPSHOT_MAX_FIELDS ];
+	bool isChanged[ NET_SNAPSHOT_MAX_FIELDS ];
+	int changedCount = 0;
+
+	for ( unsigned int i = 0; i < m_fields.size(); i++ ) {
+		valueCounts[i] = QuantizeField( m_fields[i], snapshot, values[i], &bitCounts[i] );
+		isChanged[i] = true;
+
+		if ( baseline != nullptr ) {
+			uint32_t baselineValues[3];
+			uint8_t baselineBitCount;
+			QuantizeField( m_fields[i], baseline, baselineValues, &baselineBitCount );
+			isChanged[i] = memcmp( values[i], baselineValues, valueCounts[i] * sizeof(uint32_t) ) != 0;
+		}
+
+		if ( isChanged[i] ) {
+			changedCount++;
+		}
+	}
+
+	NetBitWriter writer;
+	for ( unsigned int i = 0; i < m_fields.size(); i++ ) {
+		writer.Write( isChanged[i] ? 1 : 0, 1 );
+	}
+	for ( unsigned int i = 0; i < m_fields.size(); i++ ) {
+		if ( isChanged[i] ) {
+			for ( int valueIndex = 0; valueIndex < valueCounts[i]; valueIndex++ ) {
+				writer.Write( values[i][valueIndex], bitCounts[i] );
+			}
+		}
+	}
+
+	packer->WriteBytes( writer.GetByteCount(), writer.GetBytes() );
+	return changedCount;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+bool NetSnapshotLayout::ReadDelta( BytePacker* packer, void* io_snapshot ) const {
+	NetBitReader reader( packer->GetReadHead(), packer->GetRemainingReadableByteCount() );
+
+	bool isChanged[ NET_SNAPSHOT_MAX_FIELDS ];
+	for ( unsigned int i = 0; i < m_fields.size(); i++ ) {
+		uint32_t bit;
+		if ( !reader.Read( &bit, 1 ) ) {
+			return false;
+		}
+		isChanged[i] = (bit != 0);
+	}
+
+	for ( unsigned int i = 0; i < m_fields.size(); i++ ) {
+		if ( !isChanged[i] ) {
+			continue;
+		}
+
+		uint32_t values[3];
+		uint8_t bitCount = GetFieldBitCount( m_fields[i] );
+		int valueCount = GetFieldValueCount( m_fields[i].type );
+		for ( int valueIndex = 0; valueIndex < valueCount; valueIndex++ ) {
+			if ( !reader.Read( &values[valueIndex], bitCount ) ) {
+				return false;
+			}
+		}
+		DequantizeField( m_fields[i], values, io_snapshot );
+	}
+
+	packer->SkipBytes( reader.GetByteCount() );
+	return true;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// NetSnapshotHistory
+//----------------------------------------------------------------------------------------------------------------
+void NetSnapshotHistory::Initialize( size_t snapshotSize ) {
+	m_snapshotSize = snapshotSize;
+	m_data.resize( snapshotSize * NET_SNAPSHOT_HISTORY_SIZE );
+	for ( int i = 0; i < NET_SNAPSHOT_HISTORY_SIZE; i++ ) {
+		m_isSlotValid[i] = false;
+	}
+	m_isEmpty = true;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+bool NetSnapshotHistory::IsInitialized() const {
+	return m_snapshotSize > 0;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+bool NetSnapshotHistory::IsEmpty() const {
+	return m_isEmpty;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Storing an older ID than the latest is fine (late packets), it just doesn't become the latest
+void* NetSnapshotHistory::Store( uint32_t id, void const* snapshot ) {
+	int slot = id % NET_SNAPSHOT_HISTORY_SIZE;
+	void* storage = &m_data[ slot * m_snapshotSize ];
+	if ( storage != snapshot ) {
+		memcpy( storage, snapshot, m_snapshotSize );
+	}
+
+	m_ids[ slot ] = id;
+	m_isSlotValid[ slot ] = true;
+
+	if ( m_isEmpty || (int32_t) (id - m_latestID) > 0 ) {
+		m_latestID = id;
+		m_isEmpty = false;
+	}
+	return storage;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void const* NetSnapshotHistory::Find( uint32_t id ) const {
+	int slot = id % NET_SNAPSHOT_HISTORY_SIZE;
+	if ( !m_isSlotValid[ slot ] || m_ids[ slot ] != id ) {
+		return nullptr;
+	}
+	return &m_data[ slot * m_snapshotSize ];
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void const* NetSnapshotHistory::GetLatest() const {
+	if ( m_isEmpty ) {
+		return nullptr;
+	}
+	return Find( m_latestID );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+uint32_t NetSnapshotHistory::GetLatestID() const {
+	return m_latestID;
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+class BytePacker;
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Describes a snapshot struct field by field so the net object system can send it as a delta against a baseline
+// the other side already has. Only fields whose quantized value changed are written, bit packed, behind a one bit
+// per field change mask. Snapshot structs described this way have to be safe to memcpy.
+#define NET_SNAPSHOT_HISTORY_SIZE 32
+#define NET_SNAPSHOT_MAX_FIELDS 64
+
+
+enum eNetFieldType {
+	NETFIELD_BOOL = 0,
+	NETFIELD_UINT8,
+	NETFIELD_INT32,
+	NETFIELD_FLOAT,					// Raw 32 bits
+	NETFIELD_VECTOR3,				// Raw 96 bits
+	NETFIELD_QUANTIZED_FLOAT,		// [minValue, maxValue] in bitCount bits
+	NETFIELD_QUANTIZED_VECTOR3,		// Positions, velocities... each component [minValue, maxValue] in bitCount bits
+	NETFIELD_ANGLES,				// Euler degrees, each component wrapped to [0, 360) in bitCount bits
+	NETFIELD_UNIT_VECTOR			// Octahedral mapping, two components of bitCount bits
+};
+
+
+struct NetSnapshotField_T {
+	eNetFieldType type = NETFIELD_FLOAT;
+	size_t offset = 0;
+	float minValue = 0.f;
+	float maxValue = 0.f;
+	uint8_t bitCount = 32;
+};
+
+
+class NetSnapshotLayout {
+
+public:
+	void SetSnapshotSize( size_t snapshotSize );
+	void AddField( eNetFieldType type, size_t offset );
+	void AddQuantizedFloat( size_t offset, float minValue, float maxValue, uint8_t bitCount );
+	void AddQuantizedVector3( size_t offset, float minValue, float maxValue, uint8_t bitCount );
+	void AddAngles( size_t offset, uint8_t bitCount );
+	void AddUnitVector( size_t offset, uint8_t bitCount );
+
+	bool IsEnabled() const;
+	size_t GetSnapshotSize() const;
+
+	// True if any field quantizes differently, so values moving inside one step don't make a new snapshot
+	bool HasChanged( void const* baseline, void const* snapshot ) const;
+
+	// A null baseline writes every field. Returns the number of fields written.
+	int WriteDelta( BytePacker* packer, void const* baseline, void const* snapshot ) const;
+
+	// io_snapshot has to hold the baseline (or the current state for a full update), changed fields are overwritten
+	bool ReadDelta( BytePacker* packer, void* io_snapshot ) const;
+
+
+private:
+	size_t m_snapshotSize = 0;
+	std::vector< NetSnapshotField_T > m_fields;
+};
+
+
+//----------------------------------------------------------------------------------------------------------------
+// The last few snapshots of one object by ID. The host keeps what it sent, clients keep what they received,
+// and both look baselines up here.
+class NetSnapshotHistory {
+
+public:
+	void		Initialize( size_t snapshotSize );
+	bool		IsInitialized() const;
+	bool		IsEmpty() const;
+
+	void*		Store( uint32_t id, void const* snapshot );		// Copies the snapshot in, returns the stored copy
+	void const*	Find( uint32_t id ) const;						// nullptr if it was never stored or has been overwritten
+	void const*	GetLatest() const;
+	uint32_t	GetLatestID() const;
+
+
+private:
+	size_t m_snapshotSize = 0;
+	std::vector< uint8_t > m_data;
+	uint32_t m_ids[ NET_SNAPSHOT_HISTORY_SIZE ];
+	bool m_isSlotValid[ NET_SNAPSHOT_HISTORY_SIZE ] = {};
+	uint32_t m_latestID = 0;
+	bool m_isEmpty = true;
+};
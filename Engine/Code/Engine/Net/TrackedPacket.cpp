@@ -4,9 +4,10 @@
 
 
 //----------------------------------------------------------------------------------------------------------------
-void TrackedPacket::SetPacket( NetPacket* packet ) {
-	m_packet = packet;
-	m_timeSent = g_masterClock->total.seconds;
+void TrackedPacket::Reset( float timeSent ) {
+	m_isValid = true;
+	m_timeSent = timeSent;
+	m_reliablesInPacket = 0;
 }
 
 
@@ -4,10 +4,12 @@
 
 #define MAX_RELIABLES_PER_PACKET 32
 
+//----------------------------------------------------------------------------------------------------------------
+// Only the bookkeeping is kept, the packet itself is gone as soon as it's sent
 class TrackedPacket {
 
 public:
-	void SetPacket( NetPacket* packet );
+	void Reset( float timeSent );
 	void SetTimeSent( float seconds );
 	void AddSentReliable( uint16_t id );
 	uint8_t GetIndex();
@@ -19,9 +21,8 @@ public:
 
 
 private:
-	NetPacket* m_packet = nullptr;
 	uint8_t m_index;
-	bool m_isValid = true;
+	bool m_isValid = false;
 	float m_timeSent = 0.f;
 	uint16_t m_sentReliables[ MAX_RELIABLES_PER_PACKET ];
 	uint8_t m_reliablesInPacket = 0;
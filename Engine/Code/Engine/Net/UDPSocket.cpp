@@ -95,3 +95,46 @@ size_t UDPSocket::ReceiveFrom( NetAddress_T& out_address, void* out_buffer, size
 	}
 }
 
+
+//----------------------------------------------------------------------------------------------------------------
+int UDPSocket::ReceiveMany( UDPDatagram_T* datagrams, int maxCount ) {
+
+	if ( IsClosed() || maxCount <= 0 ) {
+		return 0;
+	}
+	if ( maxCount > UDP_MAX_BATCH_SIZE ) {
+		maxCount = UDP_MAX_BATCH_SIZE;
+	}
+
+	int received = 0;
+	while ( received < maxCount ) {
+		UDPDatagram_T& datagram = datagrams[ received ];
+		size_t read = ReceiveFrom( datagram.address, datagram.buffer, datagram.byteCount );
+		if ( read == 0 ) {
+			break;
+		}
+		datagram.byteCount = read;
+		received++;
+	}
+	return received;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int UDPSocket::SendMany( UDPDatagram_T const* datagrams, int count ) {
+
+	if ( IsClosed() || count <= 0 ) {
+		return 0;
+	}
+	if ( count > UDP_MAX_BATCH_SIZE ) {
+		count = UDP_MAX_BATCH_SIZE;
+	}
+
+	int sent = 0;
+	for ( int i = 0; i < count; i++ ) {
+		if ( SendTo( datagrams[i].address, datagrams[i].buffer, datagrams[i].byteCount ) > 0 ) {
+			sent++;
+		}
+	}
+	return sent;
+}
@@ -5,6 +5,18 @@
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 
+#define UDP_MAX_BATCH_SIZE 32
+
+
+//----------------------------------------------------------------------------------------------------------------
+// One entry in a ReceiveMany/SendMany batch. For receives byteCount goes in as the buffer size and comes back as
+// the datagram size, for sends it's the size to send.
+struct UDPDatagram_T {
+	NetAddress_T address;
+	void* buffer = nullptr;
+	size_t byteCount = 0;
+};
+
 
 class UDPSocket : public Socket {
 
@@ -15,6 +27,11 @@ public:
 	size_t SendTo( NetAddress_T const& address, void const* data, size_t byteCount );
 	size_t ReceiveFrom( NetAddress_T& out_address, void* out_buffer, size_t const maxReadSize );
 
+	// Winsock has no batched UDP calls, so this is one syscall per datagram, but callers only deal in batches.
+	// Both handle at most UDP_MAX_BATCH_SIZE at a time and return how many went through.
+	int ReceiveMany( UDPDatagram_T* datagrams, int maxCount );
+	int SendMany( UDPDatagram_T const* datagrams, int count );
+
 
 };
 
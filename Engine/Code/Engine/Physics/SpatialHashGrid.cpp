@@ -0,0 +1,116 @@
+#include "Engine/Physics/SpatialHashGrid.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+
+#include <algorithm>
+
+
+//----------------------------------------------------------------------------------------------------------------
+SpatialHashGrid::SpatialHashGrid( float cellSize, int bucketCount /* = SPATIAL_HASH_DEFAULT_BUCKET_COUNT */ )
+	: m_cellSize( cellSize )
+	, m_inverseCellSize( 1.f / cellSize )
+	, m_bucketMask( bucketCount - 1 )
+{
+	GUARANTEE_OR_DIE( cellSize > 0.f, "SpatialHashGrid cell size must be positive" );
+	GUARANTEE_OR_DIE( bucketCount > 0 && ( bucketCount & ( bucketCount - 1 ) ) == 0, "SpatialHashGrid bucket count must be a power of two" );
+
+	m_bucketStarts.resize( bucketCount + 1, 0 );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void SpatialHashGrid::Clear() {
+	m_pending.clear();
+	m_maxItemRadius = 0.f;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void SpatialHashGrid::Insert( int id, const Vector3& position, float radius /* = 0.f */ ) {
+	SpatialHashItem_T item;
+	item.position = position;
+	item.radius = radius;
+	item.id = id;
+	item.cellX = GetCellCoordinate( position.x );
+	item.cellZ = GetCellCoordinate( position.z );
+	m_pending.push_back( item );
+
+	if ( radius > m_maxItemRadius ) {
+		m_maxItemRadius = radius;
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Counting sort: count items per bucket, turn the counts into start offsets, then scatter. Each bucket's items end
+// up contiguous, so a query walks one short run of memory per cell instead of chasing pointers.
+void SpatialHashGrid::Build() {
+	int bucketCount = m_bucketMask + 1;
+	std::fill( m_bucketStarts.begin(), m_bucketStarts.end(), 0 );
+
+	int itemCount = (int) m_pending.size();
+	for ( int itemIndex = 0; itemIndex < itemCount; itemIndex++ ) {
+		const SpatialHashItem_T& item = m_pending[ itemIndex ];
+		m_bucketStarts[ GetBucketIndex( item.cellX, item.cellZ ) + 1 ]++;
+	}
+	for ( int bucket = 0; bucket < bucketCount; bucket++ ) {
+		m_bucketStarts[ bucket + 1 ] += m_bucketStarts[ bucket ];
+	}
+
+	// m_bucketStarts[bucket] is used as the write cursor and ends up at the next bucket's start, shift it back after
+	m_items.resize( itemCount );
+	for ( int itemIndex = 0; itemIndex < itemCount; itemIndex++ ) {
+		const SpatialHashItem_T& item = m_pending[ itemIndex ];
+		int bucket = GetBucketIndex( item.cellX, item.cellZ );
+		m_items[ m_bucketStarts[ bucket ]++ ] = item;
+	}
+	for ( int bucket = bucketCount; bucket > 0; bucket-- ) {
+		m_bucketStarts[ bucket ] = m_bucketStarts[ bucket - 1 ];
+	}
+	m_bucketStarts[0] = 0;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int SpatialHashGrid::Query( const Vector3& center, float radius, bool includeItemRadius, int* outIDs, int maxResults ) const {
+	int matchCount = 0;
+	float searchRadius = includeItemRadius ? radius + m_maxItemRadius : radius;
+
+	ForEachInRadius( center, searchRadius, [&]( const SpatialHashItem_T& item ) {
+		if ( includeItemRadius ) {
+			float combinedRadius = radius + item.radius;
+			if ( ( item.position - center ).GetLengthSquared() >= combinedRadius * combinedRadius ) {
+				return;
+			}
+		}
+		if ( matchCount < maxResults ) {
+			outIDs[ matchCount ] = item.id;
+		}
+		matchCount++;
+	} );
+
+	return matchCount;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int SpatialHashGrid::QueryRadius( const Vector3& center, float radius, int* outIDs, int maxResults ) const {
+	return Query( center, radius, false, outIDs, maxResults );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int SpatialHashGrid::QueryOverlaps( const Vector3& center, float radius, int* outIDs, int maxResults ) const {
+	return Query( center, radius, true, outIDs, maxResults );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int SpatialHashGrid::GetItemCount() const {
+	return (int) m_items.size();
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+float SpatialHashGrid::GetCellSize() const {
+	return m_cellSize;
+}
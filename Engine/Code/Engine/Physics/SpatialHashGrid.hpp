@@ -0,0 +1,114 @@
+#pragma once
+#include "Engine/Math/Vector3.hpp"
+
+#include <stdint.h>
+#include <vector>
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Uniform grid over the XZ plane, hashed into a fixed bucket table so the world doesn't need bounds. Items are
+// an ID (usually an index into the caller's own array), a position and a radius. Fill it with Insert once per
+// frame, then Build, which counting-sorts the items by bucket. After the first few frames the arrays stop growing
+// and neither building nor querying touches the heap.
+//
+// Heights are ignored for bucketing but not for the distance test, so this suits things that live on a terrain.
+#define SPATIAL_HASH_DEFAULT_BUCKET_COUNT 4096
+
+
+struct SpatialHashItem_T {
+	Vector3 position;
+	float radius;
+	int id;
+	int cellX;
+	int cellZ;
+};
+
+
+class SpatialHashGrid {
+
+public:
+	explicit SpatialHashGrid( float cellSize, int bucketCount = SPATIAL_HASH_DEFAULT_BUCKET_COUNT );
+
+	void Clear();
+	void Insert( int id, const Vector3& position, float radius = 0.f );
+	void Build();
+
+	// Items whose position is within radius of center. Writes up to maxResults IDs, returns how many matched
+	// (which can be more than maxResults, so callers can tell they were cut off).
+	int QueryRadius( const Vector3& center, float radius, int* outIDs, int maxResults ) const;
+
+	// Items whose sphere overlaps the given sphere, i.e. distance < radius + item radius
+	int QueryOverlaps( const Vector3& center, float radius, int* outIDs, int maxResults ) const;
+
+	// Same as QueryRadius, but hands each match to a callback instead of an array: callback( const SpatialHashItem_T& )
+	template <typename CALLBACK_T>
+	void ForEachInRadius( const Vector3& center, float radius, CALLBACK_T callback ) const;
+
+	int GetItemCount() const;
+	float GetCellSize() const;
+
+private:
+	int GetCellCoordinate( float value ) const;
+	int GetBucketIndex( int cellX, int cellZ ) const;
+	int Query( const Vector3& center, float radius, bool includeItemRadius, int* outIDs, int maxResults ) const;
+
+	float m_cellSize;
+	float m_inverseCellSize;
+	int m_bucketMask;
+	float m_maxItemRadius = 0.f;
+
+	std::vector<SpatialHashItem_T> m_pending;	// Inserted since the last Clear, in insertion order
+	std::vector<SpatialHashItem_T> m_items;		// Sorted by bucket by Build
+	std::vector<int> m_bucketStarts;			// bucketCount + 1 offsets into m_items
+};
+
+
+//----------------------------------------------------------------------------------------------------------------
+inline int SpatialHashGrid::GetCellCoordinate( float value ) const {
+	float scaled = value * m_inverseCellSize;
+	int truncated = (int) scaled;
+	return ( scaled < (float) truncated ) ? truncated - 1 : truncated;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+inline int SpatialHashGrid::GetBucketIndex( int cellX, int cellZ ) const {
+	uint32_t hash = ( (uint32_t) cellX * 73856093u ) ^ ( (uint32_t) cellZ * 19349663u );
+	return (int) ( hash & (uint32_t) m_bucketMask );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Several cells can share a bucket, so items are checked against the cell being visited as well as the distance.
+// That way an item is never reported twice when two visited cells collide.
+template <typename CALLBACK_T>
+void SpatialHashGrid::ForEachInRadius( const Vector3& center, float radius, CALLBACK_T callback ) const {
+	if ( m_items.empty() ) {
+		return;
+	}
+
+	float radiusSquared = radius * radius;
+	int minX = GetCellCoordinate( center.x - radius );
+	int maxX = GetCellCoordinate( center.x + radius );
+	int minZ = GetCellCoordinate( center.z - radius );
+	int maxZ = GetCellCoordinate( center.z + radius );
+
+	for ( int cellZ = minZ; cellZ <= maxZ; cellZ++ ) {
+		for ( int cellX = minX; cellX <= maxX; cellX++ ) {
+			int bucket = GetBucketIndex( cellX, cellZ );
+			int end = m_bucketStarts[ bucket + 1 ];
+			for ( int itemIndex = m_bucketStarts[ bucket ]; itemIndex < end; itemIndex++ ) {
+				const SpatialHashItem_T& item = m_items[ itemIndex ];
+				if ( item.cellX != cellX || item.cellZ != cellZ ) {
+					continue;
+				}
+				float dx = item.position.x - center.x;
+				float dy = item.position.y - center.y;
+				float dz = item.position.z - center.z;
+				if ( ( dx * dx ) + ( dy * dy ) + ( dz * dz ) <= radiusSquared ) {
+					callback( item );
+				}
+			}
+		}
+	}
+}
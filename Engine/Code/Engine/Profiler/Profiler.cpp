@@ -1,9 +1,54 @@
 #include "Engine/Profiler/Profiler.hpp"
+#include "Engine/Profiler/ProfilerCapture.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
 #include "Engine/Core/Time.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Async/Threads.hpp"
 #include "Engine/DevConsole/DevConsole.hpp"
 #include "Engine/DevConsole/Command.hpp"
 
+#include <intrin.h>
+#include <mutex>
+#include <string.h>
+#include <thread>
+#include <unordered_map>
+
+#define PROFILER_EVENT_INDEX_MASK (PROFILER_EVENTS_PER_THREAD - 1)
+static_assert( ( PROFILER_EVENTS_PER_THREAD & PROFILER_EVENT_INDEX_MASK ) == 0, "PROFILER_EVENTS_PER_THREAD has to be a power of two" );
+
+// The first estimate of the timestamp rate spins this long, MarkFrame refines it from there
+#define PROFILER_CALIBRATION_SECONDS 0.002
+
+
+//////////////////////////////////////////////////////////////////////////
+// Tags and threads, shared by every thread behind one lock. Neither is touched while recording: tags are interned
+// once per call site and a thread's buffer is found once per thread.
+static std::mutex s_registryLock;
+static std::unordered_map<std::string, ProfilerTagID> s_tagIDs;
+static std::deque<std::string> s_tagNames;						// Index is ID - 1
+static std::vector<ProfilerThreadBuffer_T*> s_threadBuffers;	// Never freed, other threads may be reading them
+
+static std::atomic<bool> s_isRecording( false );
+static ProfilerTagID s_frameTag = PROFILER_TAG_INVALID;
+static int s_mainThreadIndex = 0;
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Gives the buffer back when its thread exits
+struct ProfilerThreadRegistration_T {
+	ProfilerThreadBuffer_T* buffer = nullptr;
+
+	~ProfilerThreadRegistration_T() {
+		if ( buffer != nullptr ) {
+			buffer->isInUse.store( false, std::memory_order_release );
+		}
+	}
+};
+
+static thread_local ProfilerThreadRegistration_T t_threadRegistration;
+
+
 //////////////////////////////////////////////////////////////////////////
 // Profiler Console Command Callbacks
 //----------------------------------------------------------------------------------------------------------------
@@ -41,16 +86,9 @@ void ProfilerMeasurement::SetParent( ProfilerMeasurement* p ) {
 }
 
 
-//----------------------------------------------------------------------------------------------------------------
-void ProfilerMeasurement::FinishMeasurement() {
-	hpcEnd = GetPerformanceCount();
-}
-
-
 //----------------------------------------------------------------------------------------------------------------
 float ProfilerMeasurement::GetLengthSeconds() {
-	uint64_t length = hpcEnd - hpcStart;
-	return (float) PerformanceCountToSeconds(length);
+	return (float) Profiler::TicksToSeconds( tscEnd - tscStart );
 }
 
 
@@ -63,7 +101,8 @@ Profiler* Profiler::instance = nullptr;
 
 //----------------------------------------------------------------------------------------------------------------
 Profiler::Profiler() {
-
+	m_ticksPerSecond.store( 0 );
+	m_isPaused.store( false );
 }
 
 
@@ -81,24 +120,51 @@ void Profiler::Initialize() {
 		instance = new Profiler();
 	}
 
+	// The first estimate: spin a moment against the performance counter
+	instance->m_calibrationTsc = GetTimestamp();
+	instance->m_calibrationHpc = GetPerformanceCount();
+	while ( PerformanceCountToSeconds( GetPerformanceCount() - instance->m_calibrationHpc ) < PROFILER_CALIBRATION_SECONDS ) {
+	}
+	instance->Calibrate();
+
+	SetThreadName( "main" );
+	s_mainThreadIndex = GetOrCreateThreadBuffer()->threadIndex;
+	s_frameTag = InternTag( "frame" );
+	s_isRecording.store( true );
+
 	CommandRegistration::RegisterCommand("pf_pause", ProfilerPauseCommand, "Pauses the profiler" );
 	CommandRegistration::RegisterCommand("pf_unpause", ProfilerUnpauseCommand, "Unpauses the profiler" );
+	CommandRegistration::RegisterCommand("pf_bench", BenchmarkCommand, "[scopes] - Measures the cost of a profiled scope, old recorder vs event rings, 1 and 4 threads" );
+	CommandRegistration::RegisterCommand("pf_capture_start", ProfilerCapture::StartCommand, "[file] - Streams every thread's scopes to a Chrome trace file (chrome://tracing, ui.perfetto.dev)" );
+	CommandRegistration::RegisterCommand("pf_capture_stop", ProfilerCapture::StopCommand, "Finishes the trace started with pf_capture_start" );
+
+#endif
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// A capture left running would keep its thread reading the rings while statics are destroyed at exit
+void Profiler::Shutdown() {
+#ifdef PROFILER_ENABLED
+
+	ProfilerCapture::Stop();
+	s_isRecording.store( false );
 
 #endif
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
+// A frame is just the time between two MarkFrames; every thread's events in that window belong to it
 void Profiler::MarkFrame() {
 #ifdef PROFILER_ENABLED
 
+	uint64_t now = GetTimestamp();
 	if (!instance->IsInstancePaused()) {
-		// Pop previous frame and save it
-		if (instance->m_root != nullptr) {
-			ASSERT_OR_DIE( instance->m_root == instance->m_current, "Profiler was pushed and popped unevenly" );
-			instance->SaveFrame();
-			Pop();
+		if (instance->m_frameStartTsc != 0) {
+			instance->SaveFrame( now );
 		}
+		instance->Calibrate();
 	}
 
 	// Check if we're supposed to pause or unpause this frame
@@ -109,86 +175,344 @@ void Profiler::MarkFrame() {
 		instance->UnpauseInstance();
 	}
 
-	// If not paused, push the next frame
-	if (!instance->IsInstancePaused()) {
-		Profiler::Push("frame");
-	}
+	instance->m_frameStartTsc = instance->IsInstancePaused() ? 0 : now;
+	instance->m_frameCounters.clear();
+	WriteEvent( s_frameTag, PROFILER_EVENT_MARKER );
 
 #endif
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
-void Profiler::Push( const std::string& id ) {
+void Profiler::Push( ProfilerTagID tag ) {
 #ifdef PROFILER_ENABLED
+	WriteEvent( tag, PROFILER_EVENT_BEGIN );
+#endif
+}
 
-	if (!instance->IsInstancePaused()) {
-		ProfilerMeasurement* pm = instance->CreateMeasurement( id );
 
-		if ( nullptr == instance->m_root ) {
-			pm->SetParent( nullptr );
-			instance->m_root = pm;
-			instance->m_current = pm;
-		}
-		else {
-			instance->m_current->AddChild( pm );
-			pm->SetParent( instance->m_current );
-			instance->m_current = pm;
-		}
+//----------------------------------------------------------------------------------------------------------------
+void Profiler::Pop() {
+#ifdef PROFILER_ENABLED
+	WriteEvent( PROFILER_TAG_INVALID, PROFILER_EVENT_END );
+#endif
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// The event is filled in before writeCount moves past it, so a reader that sees the new count sees the whole event
+void Profiler::WriteEvent( ProfilerTagID tag, eProfilerEventType type ) {
+	if (!s_isRecording.load( std::memory_order_relaxed )) {
+		return;
+	}
+
+	ProfilerThreadBuffer_T* buffer = GetOrCreateThreadBuffer();
+	uint64_t index = buffer->writeCount.load( std::memory_order_relaxed );
+	ProfilerEvent_T& profilerEvent = buffer->events[index & PROFILER_EVENT_INDEX_MASK];
+	profilerEvent.tsc = GetTimestamp();
+	profilerEvent.tagID = tag;
+	profilerEvent.type = type;
+	buffer->writeCount.store( index + 1, std::memory_order_release );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+ProfilerTagID Profiler::InternTag( const char* name ) {
+	std::lock_guard<std::mutex> lock( s_registryLock );
+
+	std::unordered_map<std::string, ProfilerTagID>::iterator found = s_tagIDs.find( name );
+	if ( found != s_tagIDs.end() ) {
+		return found->second;
 	}
-	
+
+	s_tagNames.push_back( name );
+	ProfilerTagID tag = (ProfilerTagID) s_tagNames.size();
+	s_tagIDs[name] = tag;
+	return tag;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+std::string Profiler::GetTagName( ProfilerTagID tag ) {
+	std::lock_guard<std::mutex> lock( s_registryLock );
+	if ( tag == PROFILER_TAG_INVALID || tag > s_tagNames.size() ) {
+		return "?";
+	}
+	return s_tagNames[tag - 1];
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void Profiler::SetThreadName( const char* name ) {
+#ifdef PROFILER_ENABLED
+
+	ProfilerThreadBuffer_T* buffer = GetOrCreateThreadBuffer();
+	std::lock_guard<std::mutex> lock( s_registryLock );
+	strncpy_s( buffer->name, sizeof( buffer->name ), name, _TRUNCATE );
+
 #endif
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
-void Profiler::Pop() {
+void Profiler::AddCounter( const std::string& name, int amount ) {
 #ifdef PROFILER_ENABLED
 
 	if (!instance->IsInstancePaused()) {
+		instance->m_frameCounters[name] += amount;
+	}
+
+#endif
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void Profiler::SaveFrame( uint64_t frameEndTsc ) {
+	ProfilerFrame_T frame;
+	frame.tscStart = m_frameStartTsc;
+	frame.tscEnd = frameEndTsc;
+	frame.counters.swap( m_frameCounters );
+	m_history.push_back( frame );
+
+	if (m_history.size() > PROFILER_MAX_FRAME_HISTORY) {
+		m_history.pop_front();
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Timestamps since Initialize against the performance counter since Initialize, so the estimate keeps getting
+// better the longer the game runs
+void Profiler::Calibrate() {
+	uint64_t tscElapsed = GetTimestamp() - m_calibrationTsc;
+	double secondsElapsed = PerformanceCountToSeconds( GetPerformanceCount() - m_calibrationHpc );
+	if ( secondsElapsed > 0.0 ) {
+		m_ticksPerSecond.store( (uint64_t) ( (double) tscElapsed / secondsElapsed ) );
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Only the first push on a thread gets past the first line
+ProfilerThreadBuffer_T* Profiler::GetOrCreateThreadBuffer() {
+	if ( t_threadRegistration.buffer != nullptr ) {
+		return t_threadRegistration.buffer;
+	}
 
-		ASSERT_OR_DIE( instance->m_root != nullptr, "Tried to pop the Profiler when there was no root");
-		instance->m_current->FinishMeasurement();
-	
-		//DevConsole::Printf( "%s took %f", instance->m_current->id.c_str(), instance->m_current->GetLengthSeconds() );
-	
-		if (instance->m_current == instance->m_root) {
-			instance->m_current = nullptr;
-			instance->m_root = nullptr;
+	std::lock_guard<std::mutex> lock( s_registryLock );
+
+	ProfilerThreadBuffer_T* buffer = nullptr;
+	for ( size_t bufferIndex = 0; bufferIndex < s_threadBuffers.size() && buffer == nullptr; bufferIndex++ ) {
+		if ( !s_threadBuffers[bufferIndex]->isInUse.load( std::memory_order_acquire ) ) {
+			buffer = s_threadBuffers[bufferIndex];
 		}
-		else {
-			instance->m_current = instance->m_current->parent;
+	}
+
+	if ( buffer == nullptr ) {
+		buffer = new ProfilerThreadBuffer_T();
+		buffer->writeCount.store( 0 );
+		buffer->threadIndex = (int) s_threadBuffers.size();
+		s_threadBuffers.push_back( buffer );
+	}
+
+	buffer->isInUse.store( true );
+	strncpy_s( buffer->name, sizeof( buffer->name ), Stringf( "thread %d", buffer->threadIndex ).c_str(), _TRUNCATE );
+	t_threadRegistration.buffer = buffer;
+	return buffer;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+ProfilerThreadBuffer_T* Profiler::GetThreadBuffer( int threadIndex ) {
+	std::lock_guard<std::mutex> lock( s_registryLock );
+	if ( threadIndex < 0 || threadIndex >= (int) s_threadBuffers.size() ) {
+		return nullptr;
+	}
+	return s_threadBuffers[threadIndex];
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Copies the events stamped inside [tscStart, tscEnd] while the thread keeps writing. Events in a ring are in
+// timestamp order, so the first one is found with a binary search. Anything the writer lapped during the copy is
+// dropped from the front.
+void Profiler::CopyEvents( ProfilerThreadBuffer_T* buffer, uint64_t tscStart, uint64_t tscEnd, std::vector<ProfilerEvent_T>& outEvents ) {
+	outEvents.clear();
+
+	uint64_t writeCount = buffer->writeCount.load( std::memory_order_acquire );
+	uint64_t oldest = ( writeCount > PROFILER_EVENTS_PER_THREAD ) ? writeCount - PROFILER_EVENTS_PER_THREAD : 0;
+
+	uint64_t low = oldest;
+	uint64_t high = writeCount;
+	while ( low < high ) {
+		uint64_t middle = low + ( ( high - low ) / 2 );
+		if ( buffer->events[middle & PROFILER_EVENT_INDEX_MASK].tsc < tscStart ) {
+			low = middle + 1;
+		} else {
+			high = middle;
 		}
 	}
 
-#endif
+	uint64_t first = low;
+	for ( uint64_t index = first; index < writeCount; index++ ) {
+		const ProfilerEvent_T& profilerEvent = buffer->events[index & PROFILER_EVENT_INDEX_MASK];
+		if ( profilerEvent.tsc > tscEnd ) {
+			break;
+		}
+		outEvents.push_back( profilerEvent );
+	}
+
+	uint64_t writeCountAfter = buffer->writeCount.load( std::memory_order_acquire );
+	uint64_t oldestAfter = ( writeCountAfter > PROFILER_EVENTS_PER_THREAD ) ? writeCountAfter - PROFILER_EVENTS_PER_THREAD : 0;
+	if ( oldestAfter > first ) {
+		size_t lappedCount = (size_t) Min( oldestAfter - first, (uint64_t) outEvents.size() );
+		outEvents.erase( outEvents.begin(), outEvents.begin() + lappedCount );
+	}
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
-void Profiler::SaveFrame() {
-#ifdef PROFILER_ENABLED
+ProfilerMeasurement* Profiler::ReconstructFrame( unsigned int frameIndex, int threadIndex ) {
+	if ( instance == nullptr || frameIndex >= instance->m_history.size() ) {
+		return nullptr;
+	}
 
-	m_root->FinishMeasurement();
-	m_history.push_back(m_root);
+	const ProfilerFrame_T& frame = instance->m_history[instance->m_history.size() - 1 - frameIndex];
+	ProfilerMeasurement* root = ReconstructRange( threadIndex, frame.tscStart, frame.tscEnd );
+	if ( root != nullptr ) {
+		root->counters = frame.counters;
+	}
+	return root;
+}
 
-	if (m_history.size() > PROFILER_MAX_FRAME_HISTORY) {
-		ProfilerMeasurement* oldest = m_history.front();
-		delete oldest;
-		oldest = nullptr;
-		m_history.pop_front();
+
+//----------------------------------------------------------------------------------------------------------------
+// Scopes still open at tscEnd are cut off there, ends of scopes that began before tscStart are skipped
+ProfilerMeasurement* Profiler::ReconstructRange( int threadIndex, uint64_t tscStart, uint64_t tscEnd ) {
+	ProfilerThreadBuffer_T* buffer = GetThreadBuffer( threadIndex );
+	if ( buffer == nullptr ) {
+		return nullptr;
 	}
 
-#endif
+	std::vector<ProfilerEvent_T> events;
+	CopyEvents( buffer, tscStart, tscEnd, events );
+
+	ProfilerMeasurement* root = new ProfilerMeasurement();
+	root->id = "frame";
+	root->tscStart = tscStart;
+	root->tscEnd = tscEnd;
+
+	// Names are looked up once per tag, not once per event
+	std::map<ProfilerTagID, std::string> names;
+	ProfilerMeasurement* current = root;
+	for ( size_t eventIndex = 0; eventIndex < events.size(); eventIndex++ ) {
+		const ProfilerEvent_T& profilerEvent = events[eventIndex];
+		if ( profilerEvent.type == PROFILER_EVENT_BEGIN ) {
+			std::map<ProfilerTagID, std::string>::iterator name = names.find( profilerEvent.tagID );
+			if ( name == names.end() ) {
+				name = names.insert( std::make_pair( profilerEvent.tagID, GetTagName( profilerEvent.tagID ) ) ).first;
+			}
+
+			ProfilerMeasurement* measurement = new ProfilerMeasurement();
+			measurement->id = name->second;
+			measurement->tscStart = profilerEvent.tsc;
+			measurement->tscEnd = tscEnd;
+			measurement->SetParent( current );
+			current->AddChild( measurement );
+			current = measurement;
+		} else if ( profilerEvent.type == PROFILER_EVENT_END && current != root ) {
+			current->tscEnd = profilerEvent.tsc;
+			current = current->parent;
+		}
+	}
+
+	return root;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Same lapping check as CopyEvents, but by position instead of by time
+size_t Profiler::ReadEvents( int threadIndex, uint64_t& inOutReadCount, ProfilerEvent_T* outEvents, size_t maxEventCount, uint64_t& outLostCount ) {
+	ProfilerThreadBuffer_T* buffer = GetThreadBuffer( threadIndex );
+	if ( buffer == nullptr ) {
+		return 0;
+	}
+
+	uint64_t writeCount = buffer->writeCount.load( std::memory_order_acquire );
+	uint64_t oldest = ( writeCount > PROFILER_EVENTS_PER_THREAD ) ? writeCount - PROFILER_EVENTS_PER_THREAD : 0;
+	if ( inOutReadCount < oldest ) {
+		outLostCount += oldest - inOutReadCount;
+		inOutReadCount = oldest;
+	}
+
+	size_t copyCount = (size_t) Min( writeCount - inOutReadCount, (uint64_t) maxEventCount );
+	for ( size_t eventIndex = 0; eventIndex < copyCount; eventIndex++ ) {
+		outEvents[eventIndex] = buffer->events[( inOutReadCount + eventIndex ) & PROFILER_EVENT_INDEX_MASK];
+	}
+
+	uint64_t writeCountAfter = buffer->writeCount.load( std::memory_order_acquire );
+	uint64_t oldestAfter = ( writeCountAfter > PROFILER_EVENTS_PER_THREAD ) ? writeCountAfter - PROFILER_EVENTS_PER_THREAD : 0;
+	size_t lappedCount = 0;
+	if ( oldestAfter > inOutReadCount ) {
+		lappedCount = (size_t) Min( oldestAfter - inOutReadCount, (uint64_t) copyCount );
+		memmove( outEvents, outEvents + lappedCount, ( copyCount - lappedCount ) * sizeof( ProfilerEvent_T ) );
+		outLostCount += lappedCount;
+	}
+
+	inOutReadCount += copyCount;
+	return copyCount - lappedCount;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+uint64_t Profiler::GetEventWriteCount( int threadIndex ) {
+	ProfilerThreadBuffer_T* buffer = GetThreadBuffer( threadIndex );
+	return ( buffer == nullptr ) ? 0 : buffer->writeCount.load( std::memory_order_acquire );
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
-ProfilerMeasurement* Profiler::CreateMeasurement( const std::string& id ) {
-	ProfilerMeasurement* pm = new ProfilerMeasurement();
-	pm->id = id;
-	pm->hpcStart = GetPerformanceCount();
-	return pm;
+int Profiler::GetMainThreadIndex() {
+	return s_mainThreadIndex;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int Profiler::GetThreadCount() {
+	std::lock_guard<std::mutex> lock( s_registryLock );
+	return (int) s_threadBuffers.size();
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+std::string Profiler::GetThreadName( int threadIndex ) {
+	std::lock_guard<std::mutex> lock( s_registryLock );
+	if ( threadIndex < 0 || threadIndex >= (int) s_threadBuffers.size() ) {
+		return "";
+	}
+	return s_threadBuffers[threadIndex]->name;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+unsigned int Profiler::GetFrameCount() {
+	return ( instance == nullptr ) ? 0 : (unsigned int) instance->m_history.size();
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+double Profiler::TicksToSeconds( uint64_t ticks ) {
+	uint64_t ticksPerSecond = ( instance == nullptr ) ? 0 : instance->m_ticksPerSecond.load( std::memory_order_relaxed );
+	if ( ticksPerSecond == 0 ) {
+		return 0.0;
+	}
+	return (double) ticks / (double) ticksPerSecond;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+uint64_t Profiler::GetTimestamp() {
+	return __rdtsc();
 }
 
 
@@ -217,8 +541,10 @@ void Profiler::SignalAboutToUnpause() {
 
 
 //----------------------------------------------------------------------------------------------------------------
+// Recording stops too, so the frames in the history stay in the rings while paused
 void Profiler::PauseInstance() {
-	m_isPaused = true;
+	m_isPaused.store( true );
+	s_isRecording.store( false );
 	m_isAboutToPause = false;
 	m_isAboutToUnpause = false;
 }
@@ -226,7 +552,8 @@ void Profiler::PauseInstance() {
 
 //----------------------------------------------------------------------------------------------------------------
 void Profiler::UnpauseInstance() {
-	m_isPaused = false;
+	m_isPaused.store( false );
+	s_isRecording.store( true );
 	m_isAboutToPause = false;
 	m_isAboutToUnpause = false;
 }
@@ -234,7 +561,7 @@ void Profiler::UnpauseInstance() {
 
 //----------------------------------------------------------------------------------------------------------------
 bool Profiler::IsInstancePaused() {
-	return m_isPaused;
+	return m_isPaused.load();
 }
 
 
@@ -244,13 +571,183 @@ bool Profiler::IsPaused() {
 }
 
 
+//////////////////////////////////////////////////////////////////////////
+// Benchmark
 //----------------------------------------------------------------------------------------------------------------
-ProfilerMeasurement* Profiler::GetPreviousFrame( unsigned int index /* = 0 */ ) {
-	if (index >= instance->m_history.size()) {
-		return nullptr;
+// What Push and Pop used to do per scope: a string built from the tag, a heap node, and a child vector
+struct LegacyMeasurement_T {
+	std::string id;
+	uint64_t hpcStart;
+	uint64_t hpcEnd;
+	LegacyMeasurement_T* parent = nullptr;
+	std::vector<LegacyMeasurement_T*> children;
+
+	~LegacyMeasurement_T() {
+		for ( size_t childIndex = 0; childIndex < children.size(); childIndex++ ) {
+			delete children[childIndex];
+		}
 	}
+};
+
+
+struct LegacyRecorder_T {
+	LegacyMeasurement_T* root = nullptr;
+	LegacyMeasurement_T* current = nullptr;
+
+	void Push( const std::string& id ) {
+		LegacyMeasurement_T* measurement = new LegacyMeasurement_T();
+		measurement->id = id;
+		measurement->hpcStart = GetPerformanceCount();
+		measurement->parent = current;
+		if ( current != nullptr ) {
+			current->children.push_back( measurement );
+		} else {
+			root = measurement;
+		}
+		current = measurement;
+	}
+
+	void Pop() {
+		current->hpcEnd = GetPerformanceCount();
+		current = current->parent;
+	}
+};
+
+
+struct ProfilerBenchThread_T {
+	int scopeCount = 0;
+	uint64_t tscStart = 0;
+	uint64_t tscEnd = 0;
+	uint64_t hpcElapsed = 0;
+	int threadIndex = -1;
+	std::atomic<int>* finishedCount = nullptr;	// Threads hold their buffers until the whole run is done, so none get reused
+	int threadCount = 0;
+};
 
-	else {
-		return instance->m_history[instance->m_history.size() - 1 - index];
+
+//----------------------------------------------------------------------------------------------------------------
+// Two scopes deep, so every iteration is two pushes and two pops like a function calling a function
+static void RunProfiledScopes( int iterationCount ) {
+	static const ProfilerTagID s_outerTag = Profiler::InternTag( "pf_bench outer" );
+	static const ProfilerTagID s_innerTag = Profiler::InternTag( "pf_bench inner" );
+	for ( int iteration = 0; iteration < iterationCount; iteration++ ) {
+		ProfilerScopedEntry outer( s_outerTag );
+		ProfilerScopedEntry inner( s_innerTag );
 	}
-}
\ No newline at end of file
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+static void BenchThreadCB( void* userData ) {
+	ProfilerBenchThread_T* bench = (ProfilerBenchThread_T*) userData;
+	bench->tscStart = Profiler::GetTimestamp();
+	uint64_t hpcStart = GetPerformanceCount();
+	RunProfiledScopes( bench->scopeCount / 2 );
+	bench->hpcElapsed = GetPerformanceCount() - hpcStart;
+	bench->tscEnd = Profiler::GetTimestamp();
+	bench->threadIndex = ( t_threadRegistration.buffer != nullptr ) ? t_threadRegistration.buffer->threadIndex : -1;
+
+	bench->finishedCount->fetch_add( 1 );
+	while ( bench->finishedCount->load() < bench->threadCount ) {
+		std::this_thread::yield();
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+static int CountMeasurements( const ProfilerMeasurement* measurement ) {
+	int count = 1;
+	for ( size_t childIndex = 0; childIndex < measurement->children.size(); childIndex++ ) {
+		count += CountMeasurements( measurement->children[childIndex] );
+	}
+	return count;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+static double GetNanosecondsPer( uint64_t performanceCount, int count ) {
+	return ( PerformanceCountToSeconds( performanceCount ) * 1000000000.0 ) / (double) Max( count, 1 );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Runs on its own threads so the game's rings and history are left alone. The recorded scopes are read back
+// and counted to check nothing was lost on the way.
+void Profiler::BenchmarkCommand( const std::string& command ) {
+	Command parsed( command );
+	int scopeCount = PROFILER_EVENTS_PER_THREAD / 2;		// As many as a ring holds, so every one can be checked
+	int argument = 0;
+	if ( parsed.PeekNextInt( argument ) && parsed.GetNextInt( argument ) && argument > 0 ) {
+		scopeCount = argument;
+	}
+	scopeCount = ( scopeCount + 1 ) & ~1;
+	if ( !s_isRecording.load() ) {
+		DevConsole::Printf( Rgba( 255, 255, 0, 255 ), "pf_bench: unpause the profiler first" );
+		return;
+	}
+
+	// Empty loop, what a scope costs with nothing recorded
+	volatile int sink = 0;
+	uint64_t baselineStart = GetPerformanceCount();
+	for ( int scopeIndex = 0; scopeIndex < scopeCount; scopeIndex++ ) {
+		sink = sink + 1;
+	}
+	uint64_t baselineTime = GetPerformanceCount() - baselineStart;
+
+	// The old recorder, a string from __FUNCTION__ and a new node per scope
+	LegacyRecorder_T legacy;
+	uint64_t legacyStart = GetPerformanceCount();
+	legacy.Push( "frame" );
+	for ( int scopeIndex = 0; scopeIndex < scopeCount / 2; scopeIndex++ ) {
+		legacy.Push( __FUNCTION__ );
+		legacy.Push( __FUNCTION__ );
+		legacy.Pop();
+		legacy.Pop();
+	}
+	legacy.Pop();
+	uint64_t legacyTime = GetPerformanceCount() - legacyStart;
+	delete legacy.root;
+
+	// Event rings on 1 and then 4 threads at once
+	const int maxThreadCount = 4;
+	ProfilerBenchThread_T benches[maxThreadCount];
+	uint64_t ringTimes[2] = { 0, 0 };
+	int mismatches = 0;
+	int runThreadCounts[2] = { 1, maxThreadCount };
+	for ( int runIndex = 0; runIndex < 2; runIndex++ ) {
+		int threadCount = runThreadCounts[runIndex];
+		ThreadHandle threads[maxThreadCount];
+		std::atomic<int> finishedCount( 0 );
+		for ( int threadIndex = 0; threadIndex < threadCount; threadIndex++ ) {
+			benches[threadIndex] = ProfilerBenchThread_T();
+			benches[threadIndex].scopeCount = scopeCount;
+			benches[threadIndex].finishedCount = &finishedCount;
+			benches[threadIndex].threadCount = threadCount;
+			threads[threadIndex] = CreateNewThread( Stringf( "pf_bench %d", threadIndex ), BenchThreadCB, &benches[threadIndex] );
+		}
+		for ( int threadIndex = 0; threadIndex < threadCount; threadIndex++ ) {
+			JoinThread( threads[threadIndex] );
+			ringTimes[runIndex] += benches[threadIndex].hpcElapsed;
+
+			// Everything still in the ring has to come back. When the run lapped the ring, the oldest scope left
+			// can be missing its begin.
+			bool isWholeRunInRing = scopeCount <= PROFILER_EVENTS_PER_THREAD / 2;
+			int expectedScopes = Min( scopeCount, PROFILER_EVENTS_PER_THREAD / 2 );
+			ProfilerMeasurement* recorded = ReconstructRange( benches[threadIndex].threadIndex, benches[threadIndex].tscStart, benches[threadIndex].tscEnd );
+			int recordedScopes = ( recorded != nullptr ) ? CountMeasurements( recorded ) - 1 : 0;
+			if ( isWholeRunInRing ? ( recordedScopes != expectedScopes ) : ( recordedScopes < expectedScopes - 2 ) ) {
+				mismatches++;
+			}
+			delete recorded;
+		}
+		ringTimes[runIndex] /= (uint64_t) threadCount;
+	}
+
+	DevConsole::Printf( "pf_bench: %d scopes, two deep", scopeCount );
+	DevConsole::Printf( "  empty loop          %6.2f ns per scope", GetNanosecondsPer( baselineTime, scopeCount ) );
+	DevConsole::Printf( "  old recorder        %6.2f ns per scope", GetNanosecondsPer( legacyTime, scopeCount ) );
+	DevConsole::Printf( "  event ring          %6.2f ns per scope", GetNanosecondsPer( ringTimes[0], scopeCount ) );
+	DevConsole::Printf( "  event ring x%d      %6.2f ns per scope per thread", maxThreadCount, GetNanosecondsPer( ringTimes[1], scopeCount ) );
+	DevConsole::Printf( "  timestamp rate      %.3f GHz", 1.0 / TicksToSeconds( 1000000000 ) );
+	DevConsole::Printf( mismatches == 0 ? Rgba( 0, 255, 0, 255 ) : Rgba( 255, 0, 0, 255 ), "  %d threads lost scopes", mismatches );
+}
@@ -1,25 +1,70 @@
 #pragma once
 #include "Engine/Core/EngineCommon.hpp"
+#include <atomic>
 #include <deque>
+#include <map>
+#include <stdint.h>
 
+
+//----------------------------------------------------------------------------------------------------------------
+// Scopes are recorded as fixed size begin / end events into a ring per thread, stamped with the CPU timestamp
+// counter and tagged with an interned ID instead of a string. Nothing is allocated or hashed while recording;
+// the tree of measurements for a frame is only put together when a report asks for it.
+typedef uint32_t ProfilerTagID;
+
+#define PROFILER_TAG_INVALID 0
+#define PROFILER_EVENTS_PER_THREAD (1 << 16)		// Power of two, 16 bytes each
+
+
+enum eProfilerEventType : uint32_t {
+	PROFILER_EVENT_BEGIN,
+	PROFILER_EVENT_END,
+	PROFILER_EVENT_MARKER			// A point in time rather than a scope, MarkFrame leaves one on the main thread
+};
+
+
+struct ProfilerEvent_T {
+	uint64_t tsc;
+	ProfilerTagID tagID;			// PROFILER_TAG_INVALID on end events, they close whatever began last
+	eProfilerEventType type;
+};
+
+
+// Written only by the thread it belongs to. writeCount goes up forever; event i lives in events[i % capacity]
+// until it's overwritten capacity events later, readers check writeCount again after copying to find out.
+struct ProfilerThreadBuffer_T {
+	ProfilerEvent_T events[PROFILER_EVENTS_PER_THREAD];
+	std::atomic<uint64_t> writeCount;
+	std::atomic<bool> isInUse;		// Cleared when the thread exits, the next new thread takes the buffer over
+	int threadIndex;
+	char name[32];
+};
+
+
+//----------------------------------------------------------------------------------------------------------------
+// A frame rebuilt from events, only made for reports. The caller of Profiler::ReconstructFrame owns the tree.
 struct ProfilerMeasurement {
 public:
 	std::string		id;
-	uint64_t		hpcStart;
-	uint64_t		hpcEnd;
+	uint64_t		tscStart;
+	uint64_t		tscEnd;
 
-	ProfilerMeasurement* parent;
+	ProfilerMeasurement* parent = nullptr;
 	std::vector<ProfilerMeasurement*> children;
+	std::map<std::string, int> counters;		// Only filled on the frame's root, see Profiler::AddCounter
 
 	~ProfilerMeasurement();
 	void AddChild( ProfilerMeasurement* child );
 	void SetParent( ProfilerMeasurement* parent );
-	void FinishMeasurement();
 	float GetLengthSeconds();
 };
 
 
-#define PROFILER_SCOPED_PUSH() ProfilerScopedEntry __profiler_scoped_ ## __LINE__ ## (__FUNCTION__)
+struct ProfilerFrame_T {
+	uint64_t tscStart;
+	uint64_t tscEnd;
+	std::map<std::string, int> counters;
+};
 
 
 class Profiler {
@@ -29,45 +74,100 @@ public:
 	~Profiler();
 
 	static void Initialize();
+	static void Shutdown();
 	static void MarkFrame();
-	static void Push( const std::string& id );
+	static void Push( ProfilerTagID tag );
 	static void Pop();
 	static void Pause();
 	static void Unpause();
-	
-	static ProfilerMeasurement* GetPreviousFrame( unsigned int index = 0 );
+
+	// Same name, same ID, from any thread. Takes a lock, so call it once per call site and keep the result;
+	// PROFILER_SCOPED_PUSH does that with a function local static.
+	static ProfilerTagID InternTag( const char* name );
+	static std::string GetTagName( ProfilerTagID tag );
+
+	// Shown in reports instead of "thread N". Threads made with CreateNewThread are named for you.
+	static void SetThreadName( const char* name );
+
+	// Per frame totals shown in the profiler window, e.g. how many renderables culling threw away. Adding to the
+	// same name again in a frame sums. Main thread only.
+	static void AddCounter( const std::string& name, int amount );
+
+	// Builds the tree for a recorded frame, 0 is the last finished one. nullptr if the frame isn't in the history
+	// or the thread doesn't exist.
+	static ProfilerMeasurement* ReconstructFrame( unsigned int frameIndex, int threadIndex );
+	static ProfilerMeasurement* ReconstructRange( int threadIndex, uint64_t tscStart, uint64_t tscEnd );
+
+	// Streams a thread's events in the order they were written, for readers that keep up with the ring instead of
+	// asking for whole frames. inOutReadCount is where the reader got to; anything the ring overwrote before it was
+	// read is skipped and added to outLostCount. Returns how many events were copied.
+	static size_t ReadEvents( int threadIndex, uint64_t& inOutReadCount, ProfilerEvent_T* outEvents, size_t maxEventCount, uint64_t& outLostCount );
+	static uint64_t GetEventWriteCount( int threadIndex );
+
+	// Thread indices go in the order threads first push or get named, so workers started before Initialize come
+	// ahead of the main thread. This is the index of the thread that called Initialize.
+	static int GetMainThreadIndex();
+	static int GetThreadCount();
+	static std::string GetThreadName( int threadIndex );
+	static unsigned int GetFrameCount();
+	static double TicksToSeconds( uint64_t ticks );
+	static uint64_t GetTimestamp();
 	static bool IsPaused();
 
+	static void BenchmarkCommand( const std::string& command );
+
 	static Profiler* instance;
 	bool m_isAboutToPause = false;
 	bool m_isAboutToUnpause = false;
 
 private:
-	void SaveFrame();
-	ProfilerMeasurement* CreateMeasurement( const std::string& id );
+	void SaveFrame( uint64_t frameEndTsc );
+	void Calibrate();
 	void SignalAboutToPause();
 	void SignalAboutToUnpause();
 	void PauseInstance();
 	void UnpauseInstance();
 	bool IsInstancePaused();
 
-	ProfilerMeasurement* m_root = nullptr;
-	ProfilerMeasurement* m_current = nullptr;
+	static void WriteEvent( ProfilerTagID tag, eProfilerEventType type );
+	static ProfilerThreadBuffer_T* GetOrCreateThreadBuffer();
+	static ProfilerThreadBuffer_T* GetThreadBuffer( int threadIndex );
+	static void CopyEvents( ProfilerThreadBuffer_T* buffer, uint64_t tscStart, uint64_t tscEnd, std::vector<ProfilerEvent_T>& outEvents );
 
-	bool m_isPaused = false;
+	uint64_t m_frameStartTsc = 0;
+	std::map<std::string, int> m_frameCounters;
+	std::deque<ProfilerFrame_T> m_history;
 
+	uint64_t m_calibrationTsc = 0;
+	uint64_t m_calibrationHpc = 0;
+	std::atomic<uint64_t> m_ticksPerSecond;
 
-	std::deque<ProfilerMeasurement*> m_history;
+	std::atomic<bool> m_isPaused;
 };
 
 
+//----------------------------------------------------------------------------------------------------------------
 class ProfilerScopedEntry {
 public:
 
-	ProfilerScopedEntry( const std::string& tag ) {
+	explicit ProfilerScopedEntry( ProfilerTagID tag ) {
 		Profiler::Push(tag);
 	}
 	~ProfilerScopedEntry() {
 		Profiler::Pop();
 	}
 };
+
+
+#define PROFILER_CONCAT_INNER( a, b ) a ## b
+#define PROFILER_CONCAT( a, b ) PROFILER_CONCAT_INNER( a, b )
+
+#ifdef PROFILER_ENABLED
+	#define PROFILER_SCOPED_PUSH_NAMED( name ) \
+		static const ProfilerTagID PROFILER_CONCAT( __profiler_tag_, __LINE__ ) = Profiler::InternTag( name ); \
+		ProfilerScopedEntry PROFILER_CONCAT( __profiler_scoped_, __LINE__ )( PROFILER_CONCAT( __profiler_tag_, __LINE__ ) )
+#else
+	#define PROFILER_SCOPED_PUSH_NAMED( name )
+#endif
+
+#define PROFILER_SCOPED_PUSH() PROFILER_SCOPED_PUSH_NAMED( __FUNCTION__ )
@@ -0,0 +1,316 @@
+#include "Engine/Profiler/ProfilerCapture.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/DevConsole/DevConsole.hpp"
+
+#include <ctime>
+#include <stdarg.h>
+#include <stdio.h>
+
+
+std::atomic<bool> ProfilerCapture::m_isRunning( false );
+ThreadHandle ProfilerCapture::m_threadHandle = nullptr;
+std::fstream* ProfilerCapture::m_file = nullptr;
+std::string ProfilerCapture::m_filePath;
+std::string ProfilerCapture::m_pendingText;
+std::vector<ProfilerEvent_T> ProfilerCapture::m_readEvents;
+std::vector<ProfilerCaptureThread_T> ProfilerCapture::m_threads;
+std::vector<std::string> ProfilerCapture::m_tagNames;
+uint64_t ProfilerCapture::m_startTsc = 0;
+uint64_t ProfilerCapture::m_eventCount = 0;
+uint64_t ProfilerCapture::m_lostEventCount = 0;
+bool ProfilerCapture::m_isFirstEvent = true;
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Names come from __FUNCTION__ and the like, so only quotes and backslashes ever need escaping
+static std::string EscapeJsonString( const std::string& text ) {
+	std::string escaped;
+	escaped.reserve( text.size() );
+	for ( size_t charIndex = 0; charIndex < text.size(); charIndex++ ) {
+		char character = text[charIndex];
+		if ( character == '"' || character == '\\' ) {
+			escaped.push_back( '\\' );
+		}
+		if ( (unsigned char) character >= ' ' ) {
+			escaped.push_back( character );
+		}
+	}
+	return escaped;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Everything the worker touches is set up here, before it starts, and only read again after it's joined
+bool ProfilerCapture::Start( const std::string& filePath ) {
+	if ( m_isRunning.load() ) {
+		return false;
+	}
+
+	m_file = new std::fstream();
+	m_file->open( filePath.c_str(), std::ios::out | std::ios::binary );
+	if ( !m_file->is_open() ) {
+		delete m_file;
+		m_file = nullptr;
+		return false;
+	}
+
+	m_filePath = filePath;
+	m_pendingText.clear();
+	m_pendingText.reserve( PROFILER_CAPTURE_FLUSH_BYTES + 1024 );
+	m_readEvents.resize( PROFILER_CAPTURE_EVENTS_PER_READ );
+	m_tagNames.clear();
+	m_eventCount = 0;
+	m_lostEventCount = 0;
+	m_isFirstEvent = true;
+
+	// Threads that already exist start from now, rings made later are read from the beginning
+	m_startTsc = Profiler::GetTimestamp();
+	m_threads.clear();
+	m_threads.resize( Profiler::GetThreadCount() );
+	for ( size_t threadIndex = 0; threadIndex < m_threads.size(); threadIndex++ ) {
+		m_threads[threadIndex].readCount = Profiler::GetEventWriteCount( (int) threadIndex );
+		m_threads[threadIndex].lastTsc = m_startTsc;
+	}
+
+	// The JSON array format, so a capture cut short by a crash still opens
+	m_pendingText += "[\n";
+
+	m_isRunning.store( true );
+	m_threadHandle = CreateNewThread( "Profiler Capture", CaptureWorker );
+	return true;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void ProfilerCapture::Stop() {
+	if ( !m_isRunning.load() ) {
+		return;
+	}
+
+	m_isRunning.store( false );
+	JoinThread( m_threadHandle );
+	m_threadHandle = nullptr;
+
+	m_file->close();
+	delete m_file;
+	m_file = nullptr;
+
+	m_pendingText.clear();
+	m_pendingText.shrink_to_fit();
+	m_readEvents.clear();
+	m_readEvents.shrink_to_fit();
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+bool ProfilerCapture::IsCapturing() {
+	return m_isRunning.load();
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void ProfilerCapture::StartCommand( const std::string& command ) {
+	std::vector<std::string> tokens = SplitString( command, ' ' );
+	std::string filePath;
+	if ( tokens.size() >= 2 ) {
+		filePath = tokens[1];
+	} else {
+		std::time_t currentTime = std::time( nullptr );
+		std::tm timeComponents;
+		localtime_s( &timeComponents, &currentTime );
+		filePath = Stringf( "Log/trace_%d-%02d-%02d_%02d-%02d-%02d.json", timeComponents.tm_year + 1900, timeComponents.tm_mon + 1,
+			timeComponents.tm_mday, timeComponents.tm_hour, timeComponents.tm_min, timeComponents.tm_sec );
+	}
+
+	if ( IsCapturing() ) {
+		DevConsole::Printf( Rgba( 255, 255, 0, 255 ), "Already capturing to %s", m_filePath.c_str() );
+		return;
+	}
+	if ( Profiler::IsPaused() ) {
+		DevConsole::Printf( Rgba( 255, 255, 0, 255 ), "The profiler is paused, nothing will be captured until pf_unpause" );
+	}
+
+	if ( Start( filePath ) ) {
+		DevConsole::Printf( Rgba( 0, 255, 0, 255 ), "Capturing profiler events to %s", filePath.c_str() );
+	} else {
+		DevConsole::Printf( Rgba( 255, 0, 0, 255 ), "Couldn't open %s for the capture", filePath.c_str() );
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void ProfilerCapture::StopCommand( const std::string& command ) {
+	if ( !IsCapturing() ) {
+		DevConsole::Printf( Rgba( 255, 255, 0, 255 ), "No capture running, start one with pf_capture_start" );
+		return;
+	}
+
+	Stop();
+	DevConsole::Printf( Rgba( 0, 255, 0, 255 ), "Wrote %llu events to %s", m_eventCount, m_filePath.c_str() );
+	if ( m_lostEventCount > 0 ) {
+		DevConsole::Printf( Rgba( 255, 255, 0, 255 ), "%llu events were overwritten before the capture read them", m_lostEventCount );
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Whatever was recorded before the stop is still read, then scopes left open are closed so the viewer draws them
+void ProfilerCapture::CaptureWorker( void* data ) {
+	while ( m_isRunning.load() ) {
+		ReadNewEvents();
+		SleepThread( PROFILER_CAPTURE_POLL_MILLISECONDS );
+	}
+
+	ReadNewEvents();
+	uint64_t stopTsc = Profiler::GetTimestamp();
+	for ( size_t threadIndex = 0; threadIndex < m_threads.size(); threadIndex++ ) {
+		CloseOpenScopes( (int) threadIndex, stopTsc );
+	}
+
+	m_pendingText += "\n]\n";
+	FlushText();
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Names are checked every read since a thread that exits hands its ring to the next new thread
+void ProfilerCapture::ReadNewEvents() {
+	int threadCount = Profiler::GetThreadCount();
+	if ( (int) m_threads.size() < threadCount ) {
+		m_threads.resize( threadCount );
+	}
+
+	for ( int threadIndex = 0; threadIndex < threadCount; threadIndex++ ) {
+		ProfilerCaptureThread_T& thread = m_threads[threadIndex];
+
+		std::string name = Profiler::GetThreadName( threadIndex );
+		if ( name != thread.name ) {
+			thread.name = name;
+			AppendEvent( "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}", threadIndex, EscapeJsonString( name ).c_str() );
+		}
+
+		size_t eventCount = m_readEvents.size();
+		while ( eventCount == m_readEvents.size() ) {
+			uint64_t lostCount = 0;
+			eventCount = Profiler::ReadEvents( threadIndex, thread.readCount, m_readEvents.data(), m_readEvents.size(), lostCount );
+
+			// Whatever was open when the gap started can't be matched up any more
+			if ( lostCount > 0 ) {
+				m_lostEventCount += lostCount;
+				CloseOpenScopes( threadIndex, thread.lastTsc );
+			}
+			WriteThreadEvents( threadIndex, m_readEvents.data(), eventCount );
+		}
+	}
+
+	FlushText();
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Ends with nothing open are from scopes that began before the capture (or the gap), and are left out. A begin
+// that can't be written takes its nested scopes with it, so every end written still has its begin
+void ProfilerCapture::WriteThreadEvents( int threadIndex, const ProfilerEvent_T* events, size_t eventCount ) {
+	ProfilerCaptureThread_T& thread = m_threads[threadIndex];
+
+	for ( size_t eventIndex = 0; eventIndex < eventCount; eventIndex++ ) {
+		const ProfilerEvent_T& profilerEvent = events[eventIndex];
+		if ( profilerEvent.tsc < m_startTsc ) {
+			continue;
+		}
+		thread.lastTsc = profilerEvent.tsc;
+
+		double timestamp = GetMicroseconds( profilerEvent.tsc );
+		if ( profilerEvent.type == PROFILER_EVENT_BEGIN ) {
+			if ( thread.skippedScopeDepth > 0 ) {
+				thread.skippedScopeDepth++;
+			} else if ( AppendEvent( "{\"name\":\"%s\",\"ph\":\"B\",\"pid\":1,\"tid\":%d,\"ts\":%.3f}", GetTagName( profilerEvent.tagID ).c_str(), threadIndex, timestamp ) ) {
+				thread.openScopeCount++;
+			} else {
+				thread.skippedScopeDepth = 1;
+			}
+		} else if ( profilerEvent.type == PROFILER_EVENT_END ) {
+			if ( thread.skippedScopeDepth > 0 ) {
+				thread.skippedScopeDepth--;
+			} else if ( thread.openScopeCount > 0 ) {
+				AppendEvent( "{\"ph\":\"E\",\"pid\":1,\"tid\":%d,\"ts\":%.3f}", threadIndex, timestamp );
+				thread.openScopeCount--;
+			}
+		} else {
+			AppendEvent( "{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":%d,\"ts\":%.3f}", GetTagName( profilerEvent.tagID ).c_str(), threadIndex, timestamp );
+		}
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void ProfilerCapture::CloseOpenScopes( int threadIndex, uint64_t tsc ) {
+	ProfilerCaptureThread_T& thread = m_threads[threadIndex];
+	double timestamp = GetMicroseconds( tsc );
+	thread.skippedScopeDepth = 0;
+	while ( thread.openScopeCount > 0 ) {
+		AppendEvent( "{\"ph\":\"E\",\"pid\":1,\"tid\":%d,\"ts\":%.3f}", threadIndex, timestamp );
+		thread.openScopeCount--;
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// False if the event was left out
+bool ProfilerCapture::AppendEvent( const char* format, ... ) {
+	char eventText[512];
+
+	va_list variableArgumentList;
+	va_start( variableArgumentList, format );
+	int length = vsnprintf( eventText, sizeof( eventText ), format, variableArgumentList );
+	va_end( variableArgumentList );
+
+	// Only a ridiculous tag name gets here, and cutting it would break the JSON
+	if ( length < 0 || length >= (int) sizeof( eventText ) ) {
+		return false;
+	}
+
+	if ( !m_isFirstEvent ) {
+		m_pendingText += ",\n";
+	}
+	m_pendingText.append( eventText, length );
+	m_isFirstEvent = false;
+	m_eventCount++;
+
+	if ( m_pendingText.size() >= PROFILER_CAPTURE_FLUSH_BYTES ) {
+		FlushText();
+	}
+	return true;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void ProfilerCapture::FlushText() {
+	if ( m_pendingText.empty() ) {
+		return;
+	}
+
+	m_file->write( m_pendingText.data(), m_pendingText.size() );
+	m_file->flush();
+	m_pendingText.clear();
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Profiler::GetTagName takes the registry lock, so each tag is only looked up the first time it's seen
+const std::string& ProfilerCapture::GetTagName( ProfilerTagID tag ) {
+	if ( tag >= m_tagNames.size() ) {
+		m_tagNames.resize( tag + 1 );
+	}
+	if ( m_tagNames[tag].empty() ) {
+		m_tagNames[tag] = EscapeJsonString( Profiler::GetTagName( tag ) );
+	}
+	return m_tagNames[tag];
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+double ProfilerCapture::GetMicroseconds( uint64_t tsc ) {
+	uint64_t ticks = ( tsc > m_startTsc ) ? tsc - m_startTsc : 0;
+	return Profiler::TicksToSeconds( ticks ) * 1000000.0;
+}
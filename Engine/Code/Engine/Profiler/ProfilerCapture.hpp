@@ -0,0 +1,64 @@
+#pragma once
+#include "Engine/Profiler/Profiler.hpp"
+#include "Engine/Async/Threads.hpp"
+
+#include <atomic>
+#include <fstream>
+#include <string>
+#include <vector>
+
+
+#define PROFILER_CAPTURE_POLL_MILLISECONDS 5
+#define PROFILER_CAPTURE_EVENTS_PER_READ 4096			// Per thread per read, the rest waits for the next one
+#define PROFILER_CAPTURE_FLUSH_BYTES (256 * 1024)		// Text is written out once this much has built up
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Where the capture got to in one thread's ring
+struct ProfilerCaptureThread_T {
+	uint64_t readCount = 0;
+	uint64_t lastTsc = 0;
+	int openScopeCount = 0;			// Begins written without their end yet, closed by hand when events are lost
+	int skippedScopeDepth = 0;		// Inside a begin that couldn't be written, its ends are left out too
+	std::string name;
+};
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Streams every thread's profiler events to a Chrome Trace Event file while the game runs, for looking at far more
+// frames than the profiler history keeps. A background thread follows each thread's event ring and converts
+// whatever is new, so memory stays the same however long the capture runs and the frame never waits on the disk.
+// The file opens in chrome://tracing and ui.perfetto.dev.
+class ProfilerCapture {
+
+public:
+	static bool Start( const std::string& filePath );
+	static void Stop();
+	static bool IsCapturing();
+
+	static void StartCommand( const std::string& command );
+	static void StopCommand( const std::string& command );
+
+private:
+	static void CaptureWorker( void* data );
+	static void ReadNewEvents();
+	static void WriteThreadEvents( int threadIndex, const ProfilerEvent_T* events, size_t eventCount );
+	static void CloseOpenScopes( int threadIndex, uint64_t tsc );
+	static bool AppendEvent( const char* format, ... );
+	static void FlushText();
+	static const std::string& GetTagName( ProfilerTagID tag );
+	static double GetMicroseconds( uint64_t tsc );
+
+	static std::atomic<bool> m_isRunning;
+	static ThreadHandle m_threadHandle;
+	static std::fstream* m_file;
+	static std::string m_filePath;
+	static std::string m_pendingText;
+	static std::vector<ProfilerEvent_T> m_readEvents;
+	static std::vector<ProfilerCaptureThread_T> m_threads;
+	static std::vector<std::string> m_tagNames;			// Index is the tag ID, filled in as tags show up
+	static uint64_t m_startTsc;
+	static uint64_t m_eventCount;
+	static uint64_t m_lostEventCount;
+	static bool m_isFirstEvent;
+};
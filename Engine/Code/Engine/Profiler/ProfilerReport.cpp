@@ -6,6 +6,7 @@ void ProfilerReport::GenerateFlatReportFromFrame( ProfilerMeasurement* rootMeasu
 	root->id = rootMeasurement->id;
 	root->AccumulateData(rootMeasurement);
 	root->PopulateFlat( rootMeasurement, root );
+	counters = rootMeasurement->counters;
 	Finish();
 }
 
@@ -14,10 +15,33 @@ void ProfilerReport::GenerateTreeReportFromFrame( ProfilerMeasurement* rootMeasu
 	root = new ProfilerReportEntry();
 	root->id = rootMeasurement->id;
 	root->PopulateTree( rootMeasurement );
+	counters = rootMeasurement->counters;
 	Finish();
 }
 
 
+bool ProfilerReport::GenerateTreeReport( unsigned int frameIndex, int threadIndex ) {
+	ProfilerMeasurement* frame = Profiler::ReconstructFrame( frameIndex, threadIndex );
+	if (frame == nullptr) {
+		return false;
+	}
+	GenerateTreeReportFromFrame( frame );
+	delete frame;
+	return true;
+}
+
+
+bool ProfilerReport::GenerateFlatReport( unsigned int frameIndex, int threadIndex ) {
+	ProfilerMeasurement* frame = Profiler::ReconstructFrame( frameIndex, threadIndex );
+	if (frame == nullptr) {
+		return false;
+	}
+	GenerateFlatReportFromFrame( frame );
+	delete frame;
+	return true;
+}
+
+
 void ProfilerReport::Finish() {
 	root->Finish(root);
 }
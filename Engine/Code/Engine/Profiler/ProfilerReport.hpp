@@ -9,9 +9,14 @@ public:
 
 	void GenerateTreeReportFromFrame( ProfilerMeasurement* root );
 	void GenerateFlatReportFromFrame( ProfilerMeasurement* root );
+
+	// Rebuilds the frame from the profiler's event rings just for this report. False if it's no longer recorded.
+	bool GenerateTreeReport( unsigned int frameIndex, int threadIndex );
+	bool GenerateFlatReport( unsigned int frameIndex, int threadIndex );
 	void Finish();
 	double GetTotalFrameTime();
 
 public:
 	ProfilerReportEntry* root;
+	std::map<std::string, int> counters;
 };
\ No newline at end of file
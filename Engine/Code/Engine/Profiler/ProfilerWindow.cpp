@@ -27,6 +27,7 @@ void CloseProfiler( const std::string& command ) {
 //----------------------------------------------------------------------------------------------------------------
 void ProfilerWindow::Initialize() {
 	instance = new ProfilerWindow();
+	instance->threadIndex = Profiler::GetMainThreadIndex();
 
 	CommandRegistration::RegisterCommand("pf_open", OpenProfiler, "Opens the profiler window");
 	CommandRegistration::RegisterCommand("pf_close", CloseProfiler, "Closes the profiler window");
@@ -66,13 +67,22 @@ void ProfilerWindow::Update() {
 			}
 		}
 
-		ProfilerMeasurement* previousFrameMeasurement = Profiler::GetPreviousFrame();
+		if (g_theInputSystem->WasKeyJustPressed('T')) {
+			threadIndex = (threadIndex + 1) % Max(Profiler::GetThreadCount(), 1);
+		}
+
+		// Only the frame being shown is ever rebuilt from the event rings
 		ProfilerReport* frameReport = new ProfilerReport();
+		bool isGenerated = false;
 		if ( currentProfilerViewMode == PROFILER_VIEW_TREE ) {
-			frameReport->GenerateTreeReportFromFrame(previousFrameMeasurement);
+			isGenerated = frameReport->GenerateTreeReport(0, threadIndex);
 		}
 		else if ( currentProfilerViewMode == PROFILER_VIEW_FLAT ) {
-			frameReport->GenerateFlatReportFromFrame(previousFrameMeasurement);
+			isGenerated = frameReport->GenerateFlatReport(0, threadIndex);
+		}
+		if (!isGenerated) {
+			delete frameReport;
+			return;
 		}
 
 		savedFrames.push_back(frameReport);
@@ -103,7 +113,7 @@ void ProfilerWindow::Update() {
 
 //----------------------------------------------------------------------------------------------------------------
 void ProfilerWindow::Render() const {
-	if (isOpen) {
+	if (isOpen && !savedFrames.empty()) {
 		ProfilerReport* latestFrame = savedFrames.back();
 
 		g_theRenderer->SetShader(nullptr);
@@ -112,6 +122,7 @@ void ProfilerWindow::Render() const {
 		RenderBackground();
 		g_theRenderer->BindMaterial(g_theRenderer->GetMaterial("ui-font"));
 		RenderGeneralFrameInfo(latestFrame->root);
+		RenderCounters(latestFrame);
 		RenderReportEntries(latestFrame->root);
 		RenderHistoryGraph();
 	}
@@ -123,6 +134,7 @@ void ProfilerWindow::RenderGeneralFrameInfo( ProfilerReportEntry* root ) const {
 
 	g_theRenderer->DrawTextInBox2D(generalRenderBox, Vector2(0.f, 1.f), "FPS: " + std::to_string( 1.0 / root->totalTime), textHeight * 2.f, Rgba(), 0.4f, g_theRenderer->CreateOrGetBitmapFont("Bisasam"), TEXT_DRAW_OVERRUN);
 	g_theRenderer->DrawTextInBox2D(generalRenderBox, Vector2(0.f, 0.8f), "Frame Time: " + std::to_string( root->totalTime), textHeight * 2.f, Rgba(), 0.4f, g_theRenderer->CreateOrGetBitmapFont("Bisasam"), TEXT_DRAW_OVERRUN);
+	g_theRenderer->DrawTextInBox2D(generalRenderBox, Vector2(0.f, 0.3f), Stringf("Thread: %s (T to cycle)", Profiler::GetThreadName(threadIndex).c_str()), textHeight, Rgba(), 0.4f, g_theRenderer->CreateOrGetBitmapFont("Bisasam"), TEXT_DRAW_OVERRUN);
 	
 	std::string reportHeader = Stringf("%-75s %10s %10s %10s %10s", "Function scope and name:", "time Inc", "%% Inc", "time Excl", "%% Excl");
 	g_theRenderer->DrawTextInBox2D(generalRenderBox, Vector2(0.f, 0.0f), reportHeader, textHeight, Rgba(), 0.4f, g_theRenderer->CreateOrGetBitmapFont("Bisasam"), TEXT_DRAW_OVERRUN);
@@ -130,6 +142,22 @@ void ProfilerWindow::RenderGeneralFrameInfo( ProfilerReportEntry* root ) const {
 }
 
 
+//----------------------------------------------------------------------------------------------------------------
+void ProfilerWindow::RenderCounters( const ProfilerReport* report ) const {
+	if (report->counters.empty()) {
+		return;
+	}
+
+	std::string counterLine;
+	std::map<std::string, int>::const_iterator it = report->counters.begin();
+	while (it != report->counters.end()) {
+		counterLine += Stringf("%s: %d   ", it->first.c_str(), it->second);
+		it++;
+	}
+	g_theRenderer->DrawTextInBox2D(generalRenderBox, Vector2(0.f, 0.5f), counterLine, textHeight, Rgba(), 0.4f, g_theRenderer->CreateOrGetBitmapFont("Bisasam"), TEXT_DRAW_OVERRUN);
+}
+
+
 //----------------------------------------------------------------------------------------------------------------
 void ProfilerWindow::RenderReportEntries( ProfilerReportEntry* root ) const {
 
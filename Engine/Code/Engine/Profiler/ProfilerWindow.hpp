@@ -24,6 +24,7 @@ public:
 private:
 	void RenderBackground() const;
 	void RenderGeneralFrameInfo( ProfilerReportEntry* root ) const;
+	void RenderCounters( const ProfilerReport* report ) const;
 	void RenderHistoryGraph() const;
 	void RenderReportEntries( ProfilerReportEntry* root ) const;
 	unsigned int RenderEntry( ProfilerReportEntry* node, unsigned int index, unsigned int indent ) const;
@@ -38,6 +39,7 @@ private:
 	float maxFrameTimeInHistory = 0.0001f;
 	unsigned int lastFrameThatSetMax = 0;
 	unsigned int frameCount = 0;
+	int threadIndex = 0;			// Whose scopes are listed. Starts on the main thread, T cycles through every thread that has pushed
 
 	std::deque<ProfilerReport*> savedFrames;
 };
\ No newline at end of file
@@ -117,10 +117,27 @@ void DebugRenderBasis(float lifetime, const Matrix44& basis, const Rgba& start_c
 	DebugRenderState::objects->push_back(DebugRenderObject(start_color, end_color, lifetime, g_masterClock->total.seconds, mode, basisMesh));
 }
 
+// The unit sphere is built once, each call just bakes a translate and scale into a copy of it instead of redoing
+// the trig for every vertex
 void DebugRenderWireSphere(float lifetime, const Vector3& pos, float radius, const Rgba& start_color /* = Rgba(0, 255, 0, 255) */, const Rgba& end_color /* = Rgba(255, 0, 0, 255) */, DebugRenderMode mode /* = DEBUG_RENDER_USE_DEPTH */) {
+	static MeshBuilder s_unitWireSphere;
+	if (s_unitWireSphere.GetVertexCount() == 0) {
+		s_unitWireSphere.Begin(LINES, true);
+		s_unitWireSphere.AddWireSphere(Vector3(0.f, 0.f, 0.f), 1.f, 15, 10);
+		s_unitWireSphere.End();
+	}
+
+	Matrix44 transform = Matrix44::MakeTranslation(pos);
+	transform.Append(Matrix44::MakeScale(Vector3(radius, radius, radius)));
+
 	MeshBuilder builder;
+	builder.Begin(LINES, true);
+	builder.AddTransformed(s_unitWireSphere, transform);
+	builder.End();
+
 	Mesh* sphereMesh = new Mesh();
-	builder.BuildWireSphere(sphereMesh, pos, radius, 15, 10);
+	sphereMesh->FromBuilderAsType<Vertex3D_Lit>(&builder);
+	sphereMesh->SetDrawPrimitive(LINES);
 	DebugRenderState::objects->push_back(DebugRenderObject(start_color, end_color, lifetime, g_masterClock->total.seconds, mode, sphereMesh));
 }
 
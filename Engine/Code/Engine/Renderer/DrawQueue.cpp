@@ -0,0 +1,444 @@
+#include "Engine/Renderer/DrawQueue.hpp"
+#include "Engine/Renderer/ForwardRenderPath.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Profiler/Profiler.hpp"
+#include "Engine/DevConsole/DevConsole.hpp"
+#include "Engine/DevConsole/Command.hpp"
+
+#include <string.h>
+
+
+#define DRAW_KEY_QUEUE_SHIFT	( 64 - DRAW_KEY_QUEUE_BITS )
+#define DRAW_KEY_LAYER_SHIFT	( DRAW_KEY_QUEUE_SHIFT - DRAW_KEY_LAYER_BITS )
+#define DRAW_KEY_MESH_MAX		( ( 1u << DRAW_KEY_MESH_BITS ) - 1 )
+#define DRAW_KEY_MATERIAL_MAX	( ( 1u << DRAW_KEY_MATERIAL_BITS ) - 1 )
+#define DRAW_KEY_DEPTH_MAX		( ( 1u << DRAW_KEY_DEPTH_BITS ) - 1 )
+
+#define RADIX_BITS 8
+#define RADIX_BUCKETS ( 1 << RADIX_BITS )
+#define RADIX_PASSES ( 64 / RADIX_BITS )
+
+
+//----------------------------------------------------------------------------------------------------------------
+void RecordingDrawBackend::BindMaterial( Material* material ) {
+	DrawCommand_T drawCommand = { DRAW_COMMAND_BIND_MATERIAL, material };
+	m_commands.push_back( drawCommand );
+	m_counts[ DRAW_COMMAND_BIND_MATERIAL ]++;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void RecordingDrawBackend::BindMesh( Mesh* mesh ) {
+	DrawCommand_T drawCommand = { DRAW_COMMAND_BIND_MESH, mesh };
+	m_commands.push_back( drawCommand );
+	m_counts[ DRAW_COMMAND_BIND_MESH ]++;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void RecordingDrawBackend::BindLights( const DrawCall& drawCall ) {
+	DrawCommand_T drawCommand = { DRAW_COMMAND_BIND_LIGHTS, &drawCall };
+	m_commands.push_back( drawCommand );
+	m_counts[ DRAW_COMMAND_BIND_LIGHTS ]++;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void RecordingDrawBackend::DrawBoundMeshInstances( const Matrix44* models, int instanceCount ) {
+	DrawCommand_T drawCommand = { DRAW_COMMAND_DRAW, nullptr, (int) m_instanceModels.size(), instanceCount };
+	m_commands.push_back( drawCommand );
+	m_instanceModels.insert( m_instanceModels.end(), models, models + instanceCount );
+	m_counts[ DRAW_COMMAND_DRAW ]++;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void RecordingDrawBackend::Reset() {
+	m_commands.clear();
+	m_instanceModels.clear();
+	memset( m_counts, 0, sizeof( m_counts ) );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int RecordingDrawBackend::GetCount( eDrawCommandType type ) const {
+	return m_counts[ type ];
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int RecordingDrawBackend::GetInstanceCount() const {
+	return (int) m_instanceModels.size();
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+const std::vector<DrawCommand_T>& RecordingDrawBackend::GetCommands() const {
+	return m_commands;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+const std::vector<Matrix44>& RecordingDrawBackend::GetInstanceModels() const {
+	return m_instanceModels;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void DrawQueue::Clear() {
+	m_drawCalls.clear();
+	m_keys.clear();
+	m_order.clear();
+	m_materialIDs.clear();
+	m_meshIDs.clear();
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void DrawQueue::Reserve( int drawCount ) {
+	m_drawCalls.reserve( drawCount );
+	m_keys.reserve( drawCount );
+	m_order.reserve( drawCount );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void DrawQueue::Add( const DrawCall& drawCall, float distanceSquared ) {
+	unsigned int materialID = GetMaterialID( drawCall.m_material );
+	unsigned int meshID = GetMeshID( drawCall.m_mesh );
+
+	m_keys.push_back( MakeSortKey( drawCall.m_queue, drawCall.m_layer, materialID, meshID, distanceSquared ) );
+	m_order.push_back( (unsigned int) m_drawCalls.size() );
+	m_drawCalls.push_back( drawCall );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// LSD radix sort, 8 bits at a time. All eight histograms come from one read of the keys, and any pass where every
+// key has the same digit is skipped. With a handful of queues and layers the top passes usually are.
+// Stable, so equal keys keep the order they were added in.
+void DrawQueue::Sort() {
+	PROFILER_SCOPED_PUSH();
+
+	int drawCount = (int) m_keys.size();
+	if ( drawCount < 2 ) {
+		return;
+	}
+
+	unsigned int histograms[ RADIX_PASSES ][ RADIX_BUCKETS ];
+	memset( histograms, 0, sizeof( histograms ) );
+	for ( int drawIndex = 0; drawIndex < drawCount; drawIndex++ ) {
+		uint64_t key = m_keys[ drawIndex ];
+		for ( int pass = 0; pass < RADIX_PASSES; pass++ ) {
+			histograms[ pass ][ ( key >> ( pass * RADIX_BITS ) ) & ( RADIX_BUCKETS - 1 ) ]++;
+		}
+	}
+
+	m_scratchKeys.resize( drawCount );
+	m_scratchOrder.resize( drawCount );
+
+	for ( int pass = 0; pass < RADIX_PASSES; pass++ ) {
+		int shift = pass * RADIX_BITS;
+		unsigned int* histogram = histograms[ pass ];
+		if ( histogram[ ( m_keys[0] >> shift ) & ( RADIX_BUCKETS - 1 ) ] == (unsigned int) drawCount ) {
+			continue;
+		}
+
+		// Counts to start offsets
+		unsigned int offset = 0;
+		for ( int bucket = 0; bucket < RADIX_BUCKETS; bucket++ ) {
+			unsigned int bucketCount = histogram[ bucket ];
+			histogram[ bucket ] = offset;
+			offset += bucketCount;
+		}
+
+		for ( int drawIndex = 0; drawIndex < drawCount; drawIndex++ ) {
+			uint64_t key = m_keys[ drawIndex ];
+			unsigned int destination = histogram[ ( key >> shift ) & ( RADIX_BUCKETS - 1 ) ]++;
+			m_scratchKeys[ destination ] = key;
+			m_scratchOrder[ destination ] = m_order[ drawIndex ];
+		}
+
+		m_keys.swap( m_scratchKeys );
+		m_order.swap( m_scratchOrder );
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+static bool HaveSameLights( const DrawCall& a, const DrawCall& b ) {
+	if ( a.m_lightCount != b.m_lightCount ) {
+		return false;
+	}
+	return memcmp( a.m_lightIndices, b.m_lightIndices, sizeof( a.m_lightIndices[0] ) * Min( a.m_lightCount, (unsigned int) MAX_LIGHTS ) ) == 0;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void DrawQueue::Submit( DrawBackend* backend ) {
+	PROFILER_SCOPED_PUSH();
+
+	bool isMaterialBound = false;
+	const Material* boundMaterial = nullptr;
+	const Mesh* boundMesh = nullptr;
+	const DrawCall* boundLights = nullptr;
+
+	int drawCount = (int) m_order.size();
+	int sortedIndex = 0;
+	while ( sortedIndex < drawCount ) {
+		const DrawCall& drawCall = m_drawCalls[ m_order[ sortedIndex ] ];
+
+		if ( !isMaterialBound || drawCall.m_material != boundMaterial ) {
+			backend->BindMaterial( drawCall.m_material );
+			isMaterialBound = true;
+			boundMaterial = drawCall.m_material;
+			boundMesh = nullptr;
+			boundLights = nullptr;
+		}
+
+		if ( boundMesh == nullptr || drawCall.m_mesh != boundMesh ) {
+			backend->BindMesh( drawCall.m_mesh );
+			boundMesh = drawCall.m_mesh;
+		}
+
+		if ( boundLights == nullptr || !HaveSameLights( *boundLights, drawCall ) ) {
+			backend->BindLights( drawCall );
+			boundLights = &drawCall;
+		}
+
+		// Everything after this that needs nothing rebound goes in the same batch
+		m_batchModels.clear();
+		m_batchModels.push_back( drawCall.m_model );
+		sortedIndex++;
+		while ( sortedIndex < drawCount ) {
+			const DrawCall& nextDrawCall = m_drawCalls[ m_order[ sortedIndex ] ];
+			if ( nextDrawCall.m_material != boundMaterial || nextDrawCall.m_mesh != boundMesh || !HaveSameLights( *boundLights, nextDrawCall ) ) {
+				break;
+			}
+			m_batchModels.push_back( nextDrawCall.m_model );
+			sortedIndex++;
+		}
+
+		backend->DrawBoundMeshInstances( m_batchModels.data(), (int) m_batchModels.size() );
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int DrawQueue::GetDrawCount() const {
+	return (int) m_drawCalls.size();
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+const DrawCall& DrawQueue::GetSortedDraw( int sortedIndex ) const {
+	return m_drawCalls[ m_order[ sortedIndex ] ];
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+uint64_t DrawQueue::GetSortedKey( int sortedIndex ) const {
+	return m_keys[ sortedIndex ];
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// IDs past the end of their field all share the last value. That only costs some batching, Submit compares the
+// actual pointers.
+uint64_t DrawQueue::MakeSortKey( unsigned int queue, unsigned int layer, unsigned int materialID, unsigned int meshID, float distanceSquared ) {
+	// Positive floats order the same as their bit patterns. Drop the sign bit and keep the top 24 of what's left.
+	uint32_t distanceBits;
+	memcpy( &distanceBits, &distanceSquared, sizeof( distanceBits ) );
+	uint64_t depth = ( distanceSquared > 0.f ) ? ( distanceBits >> ( 31 - DRAW_KEY_DEPTH_BITS ) ) : 0;
+
+	uint64_t material = Min( materialID, (unsigned int) DRAW_KEY_MATERIAL_MAX );
+	uint64_t mesh = Min( meshID, (unsigned int) DRAW_KEY_MESH_MAX );
+	uint64_t key = ( (uint64_t) queue << DRAW_KEY_QUEUE_SHIFT ) | ( (uint64_t) ( layer & 0xff ) << DRAW_KEY_LAYER_SHIFT );
+
+	if ( queue == DRAW_QUEUE_ALPHA ) {
+		depth = DRAW_KEY_DEPTH_MAX - depth;
+		key |= depth << ( DRAW_KEY_MATERIAL_BITS + DRAW_KEY_MESH_BITS );
+		key |= material << DRAW_KEY_MESH_BITS;
+		key |= mesh;
+	}
+	else {
+		key |= material << ( DRAW_KEY_MESH_BITS + DRAW_KEY_DEPTH_BITS );
+		key |= mesh << DRAW_KEY_DEPTH_BITS;
+		key |= depth;
+	}
+	return key;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+unsigned int DrawQueue::GetMaterialID( const Material* material ) {
+	std::unordered_map<const Material*, unsigned int>::iterator found = m_materialIDs.find( material );
+	if ( found != m_materialIDs.end() ) {
+		return found->second;
+	}
+
+	unsigned int materialID = (unsigned int) m_materialIDs.size();
+	m_materialIDs[ material ] = materialID;
+	return materialID;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+unsigned int DrawQueue::GetMeshID( const Mesh* mesh ) {
+	std::unordered_map<const Mesh*, unsigned int>::iterator found = m_meshIDs.find( mesh );
+	if ( found != m_meshIDs.end() ) {
+		return found->second;
+	}
+
+	unsigned int meshID = (unsigned int) m_meshIDs.size();
+	m_meshIDs[ mesh ] = meshID;
+	return meshID;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void DrawQueueStartup() {
+	CommandRegistration::RegisterCommand( "draw_sort_bench", DrawQueueBenchmarkCommand, "[count] - Sorts and submits count fake draws, against the old bubble sort" );
+	CommandRegistration::RegisterCommand( "draw_sort_legacy", DrawSortLegacyCommand, "Toggles ForwardRenderPath back to the old bubble sort and per-draw binds" );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void DrawSortLegacyCommand( const std::string& command ) {
+	ForwardRenderPath::s_useLegacyDrawSort = !ForwardRenderPath::s_useLegacyDrawSort;
+	DevConsole::Printf( "draw_sort_legacy: %s", ForwardRenderPath::s_useLegacyDrawSort ? "bubble sort, per-draw binds" : "sort keys, batched submit" );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Headless: the materials and meshes are never bound to GL, the recording backend only looks at their addresses.
+// Scatters draws over 64 materials, 32 meshes and a 1000 unit cube around the camera, an eighth of them alpha.
+// The legacy sort is the real ForwardRenderPath::SortDrawCallsLegacy, which is quadratic in the alpha draws.
+DrawQueueBenchmarkResult_T DrawQueue::RunBenchmark( int drawCount ) {
+	DrawQueueBenchmarkResult_T result;
+	result.drawCount = drawCount;
+
+	const int materialCount = 64;
+	const int meshCount = 32;
+	Shader* noShader = nullptr;
+	std::vector<Material*> materials;
+	std::vector<Mesh*> meshes;
+	for ( int materialIndex = 0; materialIndex < materialCount; materialIndex++ ) {
+		materials.push_back( new Material( noShader ) );
+	}
+	for ( int meshIndex = 0; meshIndex < meshCount; meshIndex++ ) {
+		meshes.push_back( new Mesh() );
+	}
+
+	Vector3 cameraPosition = Vector3::ZERO;
+	std::vector<DrawCall> drawCalls( drawCount );
+	std::vector<float> distances( drawCount );
+	for ( int drawIndex = 0; drawIndex < drawCount; drawIndex++ ) {
+		DrawCall& drawCall = drawCalls[ drawIndex ];
+		drawCall.m_model = Matrix44::MakeTranslation( Vector3( GetRandomFloatInRange( -500.f, 500.f ), GetRandomFloatInRange( -500.f, 500.f ), GetRandomFloatInRange( -500.f, 500.f ) ) );
+		drawCall.m_material = materials[ GetRandomIntLessThan( materialCount ) ];
+		drawCall.m_mesh = meshes[ GetRandomIntLessThan( meshCount ) ];
+		drawCall.m_layer = 0;
+		drawCall.m_queue = ( GetRandomIntLessThan( 8 ) == 0 ) ? DRAW_QUEUE_ALPHA : 0;
+
+		// Neighbours share lights, like they would picking from the light clusters
+		unsigned int region = (unsigned int) ( ( drawCall.m_model.Tx + 500.f ) / 250.f );
+		drawCall.m_lightCount = 2;
+		drawCall.m_lightIndices[0] = region;
+		drawCall.m_lightIndices[1] = region + 1;
+
+		distances[ drawIndex ] = ( cameraPosition - drawCall.m_model.GetTranslation() ).GetLengthSquared();
+	}
+
+	// Old path: bubble sort copies of the DrawCalls themselves
+	std::vector<DrawCall> legacySorted( drawCalls );
+	uint64_t start = GetPerformanceCount();
+	ForwardRenderPath::SortDrawCallsLegacy( legacySorted, cameraPosition );
+	result.legacySortSeconds = PerformanceCountToSeconds( GetPerformanceCount() - start );
+
+	// Run twice so the second build doesn't pay for growing the arrays, like every frame after the first
+	DrawQueue drawQueue;
+	for ( int run = 0; run < 2; run++ ) {
+		drawQueue.Clear();
+		start = GetPerformanceCount();
+		for ( int drawIndex = 0; drawIndex < drawCount; drawIndex++ ) {
+			drawQueue.Add( drawCalls[ drawIndex ], distances[ drawIndex ] );
+		}
+		result.keyBuildSeconds = PerformanceCountToSeconds( GetPerformanceCount() - start );
+		start = GetPerformanceCount();
+		drawQueue.Sort();
+		result.radixSortSeconds = PerformanceCountToSeconds( GetPerformanceCount() - start );
+	}
+
+	// Keys ascending, and each alpha draw no closer than the next
+	result.isOrdered = true;
+	for ( int sortedIndex = 1; sortedIndex < drawCount; sortedIndex++ ) {
+		if ( drawQueue.GetSortedKey( sortedIndex - 1 ) > drawQueue.GetSortedKey( sortedIndex ) ) {
+			result.isOrdered = false;
+		}
+		const DrawCall& previous = drawQueue.GetSortedDraw( sortedIndex - 1 );
+		const DrawCall& current = drawQueue.GetSortedDraw( sortedIndex );
+		if ( previous.m_queue > current.m_queue ) {
+			result.isOrdered = false;
+		}
+		if ( previous.m_queue == DRAW_QUEUE_ALPHA && current.m_queue == DRAW_QUEUE_ALPHA ) {
+			float previousDistance = ( cameraPosition - previous.m_model.GetTranslation() ).GetLengthSquared();
+			float currentDistance = ( cameraPosition - current.m_model.GetTranslation() ).GetLengthSquared();
+			if ( previousDistance < currentDistance * 0.999f ) {
+				result.isOrdered = false;
+			}
+		}
+	}
+
+	RecordingDrawBackend backend;
+	start = GetPerformanceCount();
+	drawQueue.Submit( &backend );
+	result.submitSeconds = PerformanceCountToSeconds( GetPerformanceCount() - start );
+
+	result.materialBinds = backend.GetCount( DRAW_COMMAND_BIND_MATERIAL );
+	result.meshBinds = backend.GetCount( DRAW_COMMAND_BIND_MESH );
+	result.lightBinds = backend.GetCount( DRAW_COMMAND_BIND_LIGHTS );
+	result.drawBatches = backend.GetCount( DRAW_COMMAND_DRAW );
+	result.drawnInstances = backend.GetInstanceCount();
+
+	for ( Material* material : materials ) {
+		delete material;
+	}
+	for ( Mesh* mesh : meshes ) {
+		delete mesh;
+	}
+	return result;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+static double GetNanosecondsPer( double seconds, int count ) {
+	return ( seconds * 1000000000.0 ) / (double) count;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// The old path bound the material, mesh and lights for every draw, so its bind counts are all drawCount
+void DrawQueueBenchmarkCommand( const std::string& command ) {
+	Command parsed( command );
+	int drawCount = 5000;
+	int argument = 0;
+	if ( parsed.PeekNextInt( argument ) && parsed.GetNextInt( argument ) && argument > 0 ) {
+		drawCount = argument;
+	}
+
+	DrawQueueBenchmarkResult_T result = DrawQueue::RunBenchmark( drawCount );
+	double newSortSeconds = result.keyBuildSeconds + result.radixSortSeconds;
+
+	DevConsole::Printf( "draw_sort_bench: %d draws, 64 materials, 32 meshes", drawCount );
+	DevConsole::Printf( "  legacy bubble sort %8.2f ns/draw", GetNanosecondsPer( result.legacySortSeconds, drawCount ) );
+	DevConsole::Printf( "  key build          %8.2f ns/draw", GetNanosecondsPer( result.keyBuildSeconds, drawCount ) );
+	DevConsole::Printf( "  radix sort         %8.2f ns/draw  %5.2fx with key build", GetNanosecondsPer( result.radixSortSeconds, drawCount ), result.legacySortSeconds / Max( newSortSeconds, 0.000000001 ) );
+	DevConsole::Printf( "  submit             %8.2f ns/draw", GetNanosecondsPer( result.submitSeconds, drawCount ) );
+	DevConsole::Printf( "  material binds     %8d  legacy %8d", result.materialBinds, drawCount );
+	DevConsole::Printf( "  mesh binds         %8d  legacy %8d", result.meshBinds, drawCount );
+	DevConsole::Printf( "  light binds        %8d  legacy %8d", result.lightBinds, drawCount );
+	DevConsole::Printf( "  draw batches       %8d  legacy %8d", result.drawBatches, drawCount );
+	DevConsole::Printf( result.isOrdered ? Rgba( 0, 255, 0, 255 ) : Rgba( 255, 0, 0, 255 ), "  order %s", result.isOrdered ? "ok" : "FAILED" );
+}
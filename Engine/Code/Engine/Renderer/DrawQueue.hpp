@@ -0,0 +1,159 @@
+#pragma once
+#include "Engine/Renderer/Renderer.hpp"
+
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Draws are never moved once added. Each one gets a 64 bit sort key, and a radix sort reorders an array of
+// indices by those keys, so the Matrix44 and light list inside a DrawCall are copied exactly once per frame.
+//
+// Key layout, most significant bits first:
+//		opaque:	queue (2) | layer (8) | material (16) | mesh (14) | depth (24, front to back)
+//		alpha:	queue (2) | layer (8) | depth (24, back to front) | material (16) | mesh (14)
+//
+// Material and mesh IDs are handed out per frame in the order they're first seen, so identical draws end up
+// next to each other and Submit only binds what changed. Depth is the top 24 bits of the squared distance's
+// float representation, which sort the same way as the float itself.
+//
+// Alpha draws go back to front, farthest first, so each one blends over whatever is behind it. The bubble sort
+// this replaced (ForwardRenderPath::SortDrawCallsLegacy) put them front to back.
+#define DRAW_KEY_QUEUE_BITS		2
+#define DRAW_KEY_LAYER_BITS		8
+#define DRAW_KEY_MATERIAL_BITS	16
+#define DRAW_KEY_MESH_BITS		14
+#define DRAW_KEY_DEPTH_BITS		24
+#define DRAW_QUEUE_ALPHA		1
+
+
+struct DrawCall {
+
+	Matrix44 m_model;
+	Mesh* m_mesh;
+	Material* m_material;
+
+	unsigned int m_lightCount;
+	unsigned int m_lightIndices[MAX_LIGHTS] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+
+	int m_layer;
+	int m_queue;
+
+};
+
+
+//----------------------------------------------------------------------------------------------------------------
+// What DrawQueue::Submit talks to. The renderer backend lives in ForwardRenderPath; RecordingDrawBackend below
+// only counts and logs, so sorting and batching can be measured without a GL context.
+// DrawBoundMeshInstances gets one contiguous array of model matrices per run of draws that needed nothing
+// rebound, in sorted order.
+class DrawBackend {
+
+public:
+	virtual ~DrawBackend() {}
+
+	virtual void BindMaterial( Material* material ) = 0;
+	virtual void BindMesh( Mesh* mesh ) = 0;
+	virtual void BindLights( const DrawCall& drawCall ) = 0;
+	virtual void DrawBoundMeshInstances( const Matrix44* models, int instanceCount ) = 0;
+};
+
+
+enum eDrawCommandType {
+	DRAW_COMMAND_BIND_MATERIAL,
+	DRAW_COMMAND_BIND_MESH,
+	DRAW_COMMAND_BIND_LIGHTS,
+	DRAW_COMMAND_DRAW
+};
+
+
+struct DrawCommand_T {
+	eDrawCommandType type;
+	const void* resource;		// Material or mesh for binds, the DrawCall for lights, nothing for draws
+	int firstInstance;			// Draws only, index into GetInstanceModels
+	int instanceCount;
+};
+
+
+class RecordingDrawBackend : public DrawBackend {
+
+public:
+	virtual void BindMaterial( Material* material ) override;
+	virtual void BindMesh( Mesh* mesh ) override;
+	virtual void BindLights( const DrawCall& drawCall ) override;
+	virtual void DrawBoundMeshInstances( const Matrix44* models, int instanceCount ) override;
+
+	void Reset();
+	int GetCount( eDrawCommandType type ) const;		// For draws, the number of batches
+	int GetInstanceCount() const;
+	const std::vector<DrawCommand_T>& GetCommands() const;
+	const std::vector<Matrix44>& GetInstanceModels() const;
+
+private:
+	std::vector<DrawCommand_T> m_commands;
+	std::vector<Matrix44> m_instanceModels;
+	int m_counts[ DRAW_COMMAND_DRAW + 1 ] = { 0, 0, 0, 0 };
+};
+
+
+//----------------------------------------------------------------------------------------------------------------
+struct DrawQueueBenchmarkResult_T {
+	int drawCount = 0;
+	double legacySortSeconds = 0.0;			// ForwardRenderPath::SortDrawCallsLegacy
+	double keyBuildSeconds = 0.0;
+	double radixSortSeconds = 0.0;
+	double submitSeconds = 0.0;				// To a RecordingDrawBackend
+	int materialBinds = 0;
+	int meshBinds = 0;
+	int lightBinds = 0;
+	int drawBatches = 0;
+	int drawnInstances = 0;
+	bool isOrdered = false;
+};
+
+
+//----------------------------------------------------------------------------------------------------------------
+class DrawQueue {
+
+public:
+	void Clear();
+	void Reserve( int drawCount );
+
+	// distanceSquared is from the camera, it only feeds the depth bits
+	void Add( const DrawCall& drawCall, float distanceSquared );
+	void Sort();
+
+	// Walks the sorted draws and only rebinds the material, mesh or lights when they differ from the last draw.
+	// A material change rebinds the mesh and lights too, since attribute bindings and uniforms are per program.
+	// Each run of draws with the same material, mesh and lights is merged into one DrawBoundMeshInstances call.
+	void Submit( DrawBackend* backend );
+
+	int GetDrawCount() const;
+	const DrawCall& GetSortedDraw( int sortedIndex ) const;
+	uint64_t GetSortedKey( int sortedIndex ) const;
+
+	static uint64_t MakeSortKey( unsigned int queue, unsigned int layer, unsigned int materialID, unsigned int meshID, float distanceSquared );
+	static DrawQueueBenchmarkResult_T RunBenchmark( int drawCount );
+
+private:
+	unsigned int GetMaterialID( const Material* material );
+	unsigned int GetMeshID( const Mesh* mesh );
+
+	std::vector<DrawCall> m_drawCalls;			// In the order they were added
+	std::vector<uint64_t> m_keys;				// Sorted along with m_order
+	std::vector<unsigned int> m_order;			// Indices into m_drawCalls
+	std::vector<uint64_t> m_scratchKeys;
+	std::vector<unsigned int> m_scratchOrder;
+	std::vector<Matrix44> m_batchModels;		// The run Submit is currently gathering
+
+	std::unordered_map<const Material*, unsigned int> m_materialIDs;
+	std::unordered_map<const Mesh*, unsigned int> m_meshIDs;
+};
+
+
+//----------------------------------------------------------------------------------------------------------------
+void DrawQueueStartup();
+void DrawQueueBenchmarkCommand( const std::string& command );
+void DrawSortLegacyCommand( const std::string& command );
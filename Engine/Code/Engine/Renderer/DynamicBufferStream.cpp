@@ -0,0 +1,195 @@
+#include "Engine/Renderer/DynamicBufferStream.hpp"
+#include "Engine/Renderer/glbindings.h"
+
+#include <string.h>
+
+
+// How long to block on a fence before checking again, the wait only ends early once the GPU has caught up
+#define STREAM_FENCE_WAIT_NANOSECONDS 1000000
+
+
+//----------------------------------------------------------------------------------------------------------------
+DynamicBufferStream::DynamicBufferStream() {
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+DynamicBufferStream::~DynamicBufferStream() {
+	for ( size_t fenceIndex = 0; fenceIndex < m_fences.size(); fenceIndex++ ) {
+		glDeleteSync( (GLsync) m_fences[fenceIndex].sync );
+	}
+	m_fences.clear();
+
+	if ( m_handle != 0 ) {
+		if ( m_mappedData != nullptr ) {
+			glBindBuffer( GL_COPY_WRITE_BUFFER, m_handle );
+			glUnmapBuffer( GL_COPY_WRITE_BUFFER );
+			m_mappedData = nullptr;
+		}
+		glDeleteBuffers( 1, &m_handle );
+		m_handle = 0;
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// A bound entry point only means the driver exports the name, the context itself has to be 4.4 or list the extension
+static bool IsBufferStorageSupported() {
+	if ( glBufferStorage == nullptr || glMapBufferRange == nullptr || glGetIntegerv == nullptr ) {
+		return false;
+	}
+
+	GLint majorVersion = 0;
+	GLint minorVersion = 0;
+	glGetIntegerv( GL_MAJOR_VERSION, &majorVersion );
+	glGetIntegerv( GL_MINOR_VERSION, &minorVersion );
+	if ( majorVersion > 4 || ( majorVersion == 4 && minorVersion >= 4 ) ) {
+		return true;
+	}
+
+	if ( glGetStringi == nullptr ) {
+		return false;
+	}
+	GLint extensionCount = 0;
+	glGetIntegerv( GL_NUM_EXTENSIONS, &extensionCount );
+	for ( GLint extensionIndex = 0; extensionIndex < extensionCount; extensionIndex++ ) {
+		const char* extension = (const char*) glGetStringi( GL_EXTENSIONS, extensionIndex );
+		if ( extension != nullptr && strcmp( extension, "GL_ARB_buffer_storage" ) == 0 ) {
+			return true;
+		}
+	}
+	return false;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Bound on GL_COPY_WRITE_BUFFER so setting it up doesn't disturb the vertex or index buffer bindings
+void DynamicBufferStream::Initialize( size_t capacity ) {
+	m_ring.Reset( capacity );
+
+	glGenBuffers( 1, &m_handle );
+	glBindBuffer( GL_COPY_WRITE_BUFFER, m_handle );
+
+	if ( IsBufferStorageSupported() ) {
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage( GL_COPY_WRITE_BUFFER, capacity, nullptr, flags );
+		m_mappedData = (unsigned char*) glMapBufferRange( GL_COPY_WRITE_BUFFER, 0, capacity, flags );
+
+		// The storage is immutable now and glBufferData on it is an error, staging needs a buffer of its own
+		if ( m_mappedData == nullptr ) {
+			glDeleteBuffers( 1, &m_handle );
+			glGenBuffers( 1, &m_handle );
+			glBindBuffer( GL_COPY_WRITE_BUFFER, m_handle );
+		}
+	}
+
+	if ( m_mappedData == nullptr ) {
+		glBufferData( GL_COPY_WRITE_BUFFER, capacity, nullptr, GL_STREAM_DRAW );
+		m_stagingData.resize( capacity );
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+bool DynamicBufferStream::Allocate( size_t byteCount, size_t alignment, DynamicRange_T& outRange ) {
+	size_t offset = 0;
+	while ( !m_ring.Allocate( byteCount, alignment, offset ) ) {
+		if ( m_fences.empty() ) {
+			return false;
+		}
+		WaitForOldestFence();
+		m_frameStallCount++;
+	}
+
+	unsigned char* base = ( m_mappedData != nullptr ) ? m_mappedData : m_stagingData.data();
+	outRange.data = base + offset;
+	outRange.byteOffset = offset;
+	outRange.byteCount = byteCount;
+	outRange.bufferHandle = m_handle;
+	m_frameBytes += byteCount;
+	return true;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// The persistent mapping is coherent, so there's nothing to flush
+void DynamicBufferStream::Commit( const DynamicRange_T& range ) {
+	if ( m_mappedData != nullptr ) {
+		return;
+	}
+
+	glBindBuffer( GL_COPY_WRITE_BUFFER, m_handle );
+	glBufferSubData( GL_COPY_WRITE_BUFFER, range.byteOffset, range.byteCount, range.data );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void DynamicBufferStream::EndFrame() {
+	if ( !m_ring.IsOpenRegionEmpty() ) {
+		StreamFence_T fence;
+		fence.fenceValue = m_ring.Fence();
+		fence.sync = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+		m_fences.push_back( fence );
+	}
+
+	ReleaseSignaledFences();
+	m_frameBytes = 0;
+	m_frameStallCount = 0;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// The flush makes sure the fence actually reaches the GPU, otherwise waiting on it can hang
+void DynamicBufferStream::WaitForOldestFence() {
+	StreamFence_T fence = m_fences.front();
+	m_fences.pop_front();
+
+	GLenum result = GL_TIMEOUT_EXPIRED;
+	while ( result == GL_TIMEOUT_EXPIRED ) {
+		result = glClientWaitSync( (GLsync) fence.sync, GL_SYNC_FLUSH_COMMANDS_BIT, STREAM_FENCE_WAIT_NANOSECONDS );
+	}
+
+	glDeleteSync( (GLsync) fence.sync );
+	m_ring.Release( fence.fenceValue );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Polls without blocking, oldest first, and stops at the first frame the GPU is still on
+void DynamicBufferStream::ReleaseSignaledFences() {
+	while ( !m_fences.empty() ) {
+		const StreamFence_T& fence = m_fences.front();
+		GLenum result = glClientWaitSync( (GLsync) fence.sync, 0, 0 );
+		if ( result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED ) {
+			return;
+		}
+
+		glDeleteSync( (GLsync) fence.sync );
+		m_ring.Release( fence.fenceValue );
+		m_fences.pop_front();
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+bool DynamicBufferStream::IsPersistentlyMapped() const {
+	return m_mappedData != nullptr;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+unsigned int DynamicBufferStream::GetHandle() const {
+	return m_handle;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+size_t DynamicBufferStream::GetFrameBytes() const {
+	return m_frameBytes;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int DynamicBufferStream::GetFrameStallCount() const {
+	return m_frameStallCount;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include "Engine/Renderer/RingAllocator.hpp"
+
+#include <deque>
+#include <vector>
+
+
+//----------------------------------------------------------------------------------------------------------------
+// A piece of a DynamicBufferStream. data is write only: it can point straight at GPU visible memory, so fill it
+// in order and never read it back.
+struct DynamicRange_T {
+	void* data = nullptr;
+	size_t byteOffset = 0;				// From the start of the buffer
+	size_t byteCount = 0;
+	unsigned int bufferHandle = 0;
+};
+
+
+//----------------------------------------------------------------------------------------------------------------
+// One big GL buffer that dynamic geometry is written into every frame instead of each mesh making its own. It's
+// mapped once for the life of the stream when the context has buffer storage (GL 4.4 or ARB_buffer_storage), otherwise
+// ranges are written to a CPU copy and uploaded with glBufferSubData on Commit. Either way RingAllocator decides
+// where a range goes and a GL fence per frame decides when its memory can be handed out again.
+class DynamicBufferStream {
+
+public:
+	DynamicBufferStream();
+	~DynamicBufferStream();
+
+	void Initialize( size_t capacity );
+
+	// Waits on the GPU when the ring is full of frames still in flight. Fails when the request doesn't fit even with
+	// everything before this frame released; the caller falls back to its own buffer.
+	bool Allocate( size_t byteCount, size_t alignment, DynamicRange_T& outRange );
+
+	// Call once a range is written, before drawing from it
+	void Commit( const DynamicRange_T& range );
+
+	// Fences everything allocated this frame and releases the frames the GPU has finished
+	void EndFrame();
+
+	bool IsPersistentlyMapped() const;
+	unsigned int GetHandle() const;
+	size_t GetFrameBytes() const;
+	int GetFrameStallCount() const;
+
+private:
+	struct StreamFence_T {
+		uint64_t fenceValue;
+		void* sync;						// GLsync, kept opaque so this header doesn't need GL
+	};
+
+	void WaitForOldestFence();
+	void ReleaseSignaledFences();
+
+	RingAllocator m_ring;
+	std::deque<StreamFence_T> m_fences;
+	unsigned int m_handle = 0;
+	unsigned char* m_mappedData = nullptr;
+	std::vector<unsigned char> m_stagingData;
+	size_t m_frameBytes = 0;
+	int m_frameStallCount = 0;
+};
@@ -4,12 +4,43 @@
 #include "Engine/Profiler/Profiler.hpp"
 
 
-struct LightComparisonData {
-	unsigned int index;
-	float weight;
+//----------------------------------------------------------------------------------------------------------------
+// Sends DrawQueue::Submit's binds to the renderer
+class RendererDrawBackend : public DrawBackend {
+
+public:
+	RendererDrawBackend( Renderer* r, const std::vector<Light*>& lights ) : renderer( r ), m_lights( lights ) {}
+
+	virtual void BindMaterial( Material* material ) override {
+		renderer->BindMaterial( material );
+	}
+
+	virtual void BindMesh( Mesh* mesh ) override {
+		renderer->BindMesh( mesh );
+	}
+
+	virtual void BindLights( const DrawCall& drawCall ) override {
+		PROFILER_SCOPED_PUSH();
+		int maxLights = (int) min(drawCall.m_lightCount, m_lights.size());
+		for (int i = 0; i < maxLights; i++) {
+			int lightIndexToUse = drawCall.m_lightIndices[i];
+			renderer->SetLight(i, *m_lights[lightIndexToUse]);
+		}
+		renderer->BindLightState();
+	}
+
+	virtual void DrawBoundMeshInstances( const Matrix44* models, int instanceCount ) override {
+		renderer->DrawBoundMeshInstances( models, instanceCount );
+	}
+
+private:
+	Renderer* renderer;
+	const std::vector<Light*>& m_lights;
 };
 
 
+bool ForwardRenderPath::s_useLegacyDrawSort = false;
+
 
 //----------------------------------------------------------------------------------------------------------------
 ForwardRenderPath::ForwardRenderPath( Renderer* r ) : renderer( r ) {
@@ -38,6 +69,7 @@ ForwardRenderPath::~ForwardRenderPath() {
 //----------------------------------------------------------------------------------------------------------------
 void ForwardRenderPath::Render( RenderSceneGraph* scene ) {
 	PROFILER_SCOPED_PUSH();
+	scene->UpdateTransforms();
 	scene->SortCameras();
 
 	for ( Camera* cam : scene->m_cameras ) {
@@ -46,11 +78,35 @@ void ForwardRenderPath::Render( RenderSceneGraph* scene ) {
 }
 
 
+//----------------------------------------------------------------------------------------------------------------
+// Culling results for the profiler window, summed over every camera and shadow pass in the frame
+// Counter names are built once, not every frame
+static const std::string CAMERA_VISIBLE_COUNTER = "camera visible";
+static const std::string CAMERA_CULLED_COUNTER = "camera culled";
+static const std::string SHADOW_VISIBLE_COUNTER = "shadow visible";
+static const std::string SHADOW_CULLED_COUNTER = "shadow culled";
+static const std::string CULL_NODES_COUNTER = "cull nodes";
+static const std::string CULL_BOX_TESTS_COUNTER = "cull box tests";
+
+static void AddCullCounters( const std::string& visibleName, const std::string& culledName, int renderableCount, const AABBTreeQueryStats_T& stats ) {
+	Profiler::AddCounter( visibleName, stats.visibleCount );
+	Profiler::AddCounter( culledName, renderableCount - stats.visibleCount );
+	Profiler::AddCounter( CULL_NODES_COUNTER, stats.nodesVisited );
+	Profiler::AddCounter( CULL_BOX_TESTS_COUNTER, stats.leavesTested );
+}
+
+
 //----------------------------------------------------------------------------------------------------------------
 void ForwardRenderPath::RenderSceneForCamera( Camera* camera, RenderSceneGraph* scene ) {
 
 	PROFILER_SCOPED_PUSH();
 
+	// Particle meshes are rebuilt facing this camera, so their bounds are only right after this
+	for ( ParticleEmitter* particleEmitter : scene->m_particleEmitters ) {
+		particleEmitter->PreRender( particleEmitter, camera );
+	}
+	scene->UpdateBounds();
+
 	for ( Light* light : scene->m_lights ) {
 		if (light->m_isShadowcasting > 0.f) {
 			RenderShadowCastingObjectsForLight( light, scene, camera );
@@ -63,27 +119,46 @@ void ForwardRenderPath::RenderSceneForCamera( Camera* camera, RenderSceneGraph*
 		renderer->DrawRenderable(camera->skybox);
 	}
 
-	for ( ParticleEmitter* particleEmitter : scene->m_particleEmitters ) {
-		particleEmitter->PreRender( particleEmitter, camera );
-	}
+	AABBTreeQueryStats_T cullStats;
+	scene->CullRenderables( camera->GetViewProjection(), m_visibleRenderables, &cullStats );
+	AddCullCounters( CAMERA_VISIBLE_COUNTER, CAMERA_CULLED_COUNTER, (int) scene->m_renderables.size(), cullStats );
+
+	AssignLightsToClusters( camera, scene );
 
-	std::vector<DrawCall> drawCalls;
-	for( Renderable* renderable : scene->m_renderables ) {
+	// The queue keeps its arrays between frames, so after the first frame building it doesn't allocate
+	Vector3 cameraPosition = camera->m_cameraMatrix.GetTranslation();
+	m_drawQueue.Clear();
+	m_drawQueue.Reserve( (int) m_visibleRenderables.size() );
+	std::vector<DrawCall> legacyDrawCalls;
+	for( int visibleIndex = 0; visibleIndex < (int) m_visibleRenderables.size(); visibleIndex++ ) {
+		Renderable* renderable = scene->m_renderables[ m_visibleRenderables[visibleIndex] ];
 		DrawCall dc;
-		ComputeMostContributingLights( &(dc.m_lightCount), dc.m_lightIndices, renderable->GetPosition(), scene );
+		dc.m_lightCount = (unsigned int) m_lightClusters.SelectLights( m_renderablePositions[visibleIndex], dc.m_lightIndices, MAX_LIGHTS );
 		dc.m_model = renderable->GetModelMatrix();
 		dc.m_mesh = renderable->GetMesh();
 		dc.m_material = renderable->GetMaterial();
 		dc.m_layer = 0;
 		dc.m_queue = dc.m_material->GetQueue();
-		drawCalls.push_back(dc);
+		if ( s_useLegacyDrawSort ) {
+			legacyDrawCalls.push_back(dc);
+		}
+		else {
+			m_drawQueue.Add( dc, (cameraPosition - dc.m_model.GetTranslation()).GetLengthSquared() );
+		}
 	}
 
-	SortDrawCalls( drawCalls, camera );
+	if ( s_useLegacyDrawSort ) {
+		SortDrawCallsLegacy( legacyDrawCalls, cameraPosition );
+		for( DrawCall& drawCall : legacyDrawCalls ) {
+			EnableLightsForDrawCall( drawCall, scene );
+			renderer->Draw( drawCall );
+		}
+	}
+	else {
+		m_drawQueue.Sort();
 
-	for( DrawCall& drawCall : drawCalls ) {
-		EnableLightsForDrawCall( drawCall, scene );
-		renderer->Draw( drawCall );
+		RendererDrawBackend backend( renderer, scene->m_lights );
+		m_drawQueue.Submit( &backend );
 	}
 
 	ApplyBloom( camera );
@@ -122,7 +197,13 @@ void ForwardRenderPath::RenderShadowCastingObjectsForLight( Light* light, Render
 
 	g_theRenderer->SetViewport(0, 0, light->m_shadowMapResolution.x, light->m_shadowMapResolution.y);
 	g_theRenderer->ClearDepth();
-	for (Renderable* r : scene->m_renderables) {
+
+	AABBTreeQueryStats_T cullStats;
+	scene->CullRenderables( light->m_viewProjection, m_visibleShadowCasters, &cullStats );
+	AddCullCounters( SHADOW_VISIBLE_COUNTER, SHADOW_CULLED_COUNTER, (int) scene->m_renderables.size(), cullStats );
+
+	for (int renderableIndex : m_visibleShadowCasters) {
+		Renderable* r = scene->m_renderables[renderableIndex];
 		if ( r->GetMesh() != nullptr ) {
 			g_theRenderer->SetModelMatrix(r->GetModelMatrix());
 			g_theRenderer->DrawMesh(r->GetMesh());
@@ -154,50 +235,32 @@ void ForwardRenderPath::ClearBasedOnCameraOptions( Camera* camera ){
 
 
 //----------------------------------------------------------------------------------------------------------------
-void ForwardRenderPath::ComputeMostContributingLights( unsigned int* m_lightCount, unsigned int m_lightIndices[MAX_LIGHTS], const Vector3& position, RenderSceneGraph* scene ) {
+// Bins the scene's lights into clusters once for this camera, so each renderable only ranks the lights near it
+void ForwardRenderPath::AssignLightsToClusters( Camera* camera, RenderSceneGraph* scene ) {
 	PROFILER_SCOPED_PUSH();
-	unsigned int numLights = (unsigned int) scene->m_lights.size();
-	LightComparisonData* lights = new LightComparisonData[numLights];
-
-	// Get the distance to each light
-	for (unsigned int sceneLightIndex = 0; sceneLightIndex < numLights; sceneLightIndex++) {
-		const Light& light = *scene->m_lights[sceneLightIndex];
-		lights[sceneLightIndex].index = sceneLightIndex;
-		if (light.m_isPointLight != 0.f) {
-			lights[sceneLightIndex].weight = light.m_intensity / ( 1.f + (light.m_attenuation * light.m_position.DistanceFrom(position)) );
-		}
-		else  {
-			lights[sceneLightIndex].weight = light.m_intensity;
-		}
-	}
-	
-	// Sort by distance, i'm extremely lazy and am using a bubble sort for now. will improve when slow
-	for (unsigned int i = 0; i < numLights; i++) {
-		for (unsigned int j = 0; j < numLights - i - 1; j++) {
-			if (lights[j].weight < lights[j+1].weight) {
-				LightComparisonData temp = lights[j];
-				lights[j] = lights[j+1];
-				lights[j+1] = temp;
-			}
-		}
+
+	m_clusterLights.resize( scene->m_lights.size() );
+	for ( int lightIndex = 0; lightIndex < (int) scene->m_lights.size(); lightIndex++ ) {
+		const Light& light = *scene->m_lights[lightIndex];
+		ClusterLight_T& clusterLight = m_clusterLights[lightIndex];
+		clusterLight.position = light.m_position;
+		clusterLight.intensity = light.m_intensity;
+		clusterLight.attenuation = light.m_attenuation;
+		clusterLight.isPointLight = ( light.m_isPointLight != 0.f );
 	}
 
-	// Copy the closest 8 or all lights if there is less than 8
-	for (unsigned int i = 0; i < numLights; i++) {
-		m_lightIndices[i] = lights[i].index;
-		*m_lightCount = i + 1;
-		if (i == MAX_LIGHTS - 1) {
-			delete lights;
-			return;
-		}
-	}	
+	// Only what survived culling asks for lights, so only those positions fit the depth slices
+	m_renderablePositions.resize( m_visibleRenderables.size() );
+	for ( int visibleIndex = 0; visibleIndex < (int) m_visibleRenderables.size(); visibleIndex++ ) {
+		m_renderablePositions[visibleIndex] = scene->m_renderables[ m_visibleRenderables[visibleIndex] ]->GetPosition();
+	}
 
-	delete[] lights;
+	m_lightClusters.Build( camera->GetViewProjection(), m_clusterLights.data(), (int) m_clusterLights.size(), m_renderablePositions.data(), (int) m_renderablePositions.size() );
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
-void ForwardRenderPath::SortDrawCalls( std::vector<DrawCall>& drawCalls, Camera* camera ) {
+void ForwardRenderPath::SortDrawCallsLegacy( std::vector<DrawCall>& drawCalls, const Vector3& cameraPosition ) {
 	PROFILER_SCOPED_PUSH();
 	// Sort based on the queue, so we can draw opaque before transparent things
 	for (int i = 0; i < drawCalls.size(); i++) {
@@ -230,8 +293,8 @@ void ForwardRenderPath::SortDrawCalls( std::vector<DrawCall>& drawCalls, Camera*
 			for (int j = alphaStartIndex; j < drawCalls.size() - 1; j++) {
 				DrawCall& current = drawCalls[j];
 				DrawCall& next = drawCalls[j+1];
-				float distanceToCameraCurrent = (camera->m_cameraMatrix.GetTranslation() - current.m_model.GetTranslation()).GetLengthSquared();
-				float distanceToCameraNext    = (camera->m_cameraMatrix.GetTranslation() - next.m_model.GetTranslation()).GetLengthSquared();
+				float distanceToCameraCurrent = (cameraPosition - current.m_model.GetTranslation()).GetLengthSquared();
+				float distanceToCameraNext    = (cameraPosition - next.m_model.GetTranslation()).GetLengthSquared();
 
 				if (distanceToCameraCurrent > distanceToCameraNext) {
 					DrawCall temp = drawCalls[j];
@@ -257,7 +320,8 @@ void ForwardRenderPath::ApplyBloom( Camera* camera ) {
 	AABB2 screenBounds = AABB2( -screenHalfWidth, -screenHalfHeight, screenHalfWidth, screenHalfHeight );
 
 	// We need to run the blur shader on our bloom target
-	Profiler::Push("bloom target creates");
+	static const ProfilerTagID s_bloomTargetTag = Profiler::InternTag("bloom target creates");
+	Profiler::Push(s_bloomTargetTag);
 	if ( m_bloomScratchTargetSrc == nullptr ) {
 		m_bloomScratchTargetSrc = Texture::CreateDuplicateTarget( camera->m_frameBuffer->m_colorTarget );
 		m_bloomScratchTargetSrc->SetSamplerMode( SAMPLER_LINEAR );
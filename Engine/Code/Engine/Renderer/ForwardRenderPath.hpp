@@ -1,24 +1,12 @@
 #pragma once
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Renderer/RenderSceneGraph.hpp"
+#include "Engine/Renderer/DrawQueue.hpp"
+#include "Engine/Renderer/LightClusterGrid.hpp"
 
 
 constexpr int BLOOM_PASSES = 10;
 
-struct DrawCall {
-
-	Matrix44 m_model;
-	Mesh* m_mesh;
-	Material* m_material;
-
-	unsigned int m_lightCount;
-	unsigned int m_lightIndices[MAX_LIGHTS] = { 0, 0, 0, 0, 0, 0, 0, 0 };
-
-	int m_layer;
-	int m_queue;
-
-};
-
 
 class ForwardRenderPath {
 
@@ -30,11 +18,15 @@ public:
 	void Render( RenderSceneGraph* scene );
 	void RenderSceneForCamera( Camera* camera, RenderSceneGraph* scene );
 	void ClearBasedOnCameraOptions( Camera* camera );
+
+	// The bubble sorts DrawQueue replaced, kept so draw_sort_bench and draw_sort_legacy can compare against the
+	// real thing. Sorts by queue, then the alpha draws front to back.
+	static void SortDrawCallsLegacy( std::vector<DrawCall>& drawCalls, const Vector3& cameraPosition );
+	static bool s_useLegacyDrawSort;
 	 
 private:
-	void ComputeMostContributingLights( unsigned int* m_lightCount, unsigned int m_lightIndices[MAX_LIGHTS], const Vector3& position, RenderSceneGraph* scene );
-	void SortDrawCalls( std::vector<DrawCall>& drawCalls, Camera* camera );
 	void EnableLightsForDrawCall( const DrawCall& drawCall, RenderSceneGraph* scene );
+	void AssignLightsToClusters( Camera* camera, RenderSceneGraph* scene );
 	void ApplyCameraEffects( Camera* camera );
 	void ApplyBloom( Camera* camera );
 	void RenderShadowCastingObjectsForLight( Light* light, RenderSceneGraph* scene, Camera* currentCamera );
@@ -42,6 +34,12 @@ private:
 
 	Renderer* renderer;
 	Camera* m_effectCamera = nullptr;
+	DrawQueue m_drawQueue;
+	LightClusterGrid m_lightClusters;
+	std::vector<ClusterLight_T> m_clusterLights;
+	std::vector<Vector3> m_renderablePositions;		// One per visible renderable
+	std::vector<int> m_visibleRenderables;			// Indices into the scene's renderables that survived culling
+	std::vector<int> m_visibleShadowCasters;
 
 	Texture* m_bloomScratchTargetSrc = nullptr;
 	Texture* m_bloomScratchTargetDest = nullptr;
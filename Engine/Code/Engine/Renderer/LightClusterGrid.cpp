@@ -0,0 +1,494 @@
+#include "Engine/Renderer/LightClusterGrid.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Profiler/Profiler.hpp"
+#include "Engine/DevConsole/DevConsole.hpp"
+#include "Engine/DevConsole/Command.hpp"
+
+#include <float.h>
+#include <math.h>
+
+
+// Light selection keeps its running top list on the stack
+#define LIGHT_CLUSTER_MAX_SELECTION 32
+
+// Grows light radii a little so rounding in the clip space bounds can't drop a light right at its edge
+#define LIGHT_CLUSTER_RANGE_PADDING 1.01f
+
+
+//----------------------------------------------------------------------------------------------------------------
+LightClusterGrid::LightClusterGrid( int tilesX /* = LIGHT_CLUSTER_TILES_X */, int tilesY /* = LIGHT_CLUSTER_TILES_Y */, int slices /* = LIGHT_CLUSTER_SLICES */ )
+	: m_tilesX( tilesX )
+	, m_tilesY( tilesY )
+	, m_slices( slices )
+{
+	GUARANTEE_OR_DIE( tilesX > 0 && tilesY > 0 && slices > 0, "LightClusterGrid needs at least one cluster" );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Same counting sort as SpatialHashGrid::Build: find each light's block of clusters, count lights per cluster,
+// turn the counts into offsets, then fill. Every cluster's lights end up contiguous and in index order.
+void LightClusterGrid::Build( const Matrix44& viewProjection, const ClusterLight_T* lights, int lightCount, const Vector3* positions, int positionCount ) {
+	PROFILER_SCOPED_PUSH();
+
+	m_viewProjection = viewProjection;
+	m_isPerspective = ( viewProjection.Iw != 0.f || viewProjection.Jw != 0.f || viewProjection.Kw != 0.f );
+	m_lights = lights;
+	m_lightCount = lightCount;
+	m_globalLights.clear();
+
+	// Fit the slices to the depths of the positions inside the frustum
+	m_hasClusters = false;
+	m_minDepth = FLT_MAX;
+	m_maxDepth = -FLT_MAX;
+	for ( int positionIndex = 0; positionIndex < positionCount; positionIndex++ ) {
+		Vector4 clip = viewProjection.Transform( Vector4( positions[ positionIndex ].x, positions[ positionIndex ].y, positions[ positionIndex ].z, 1.f ) );
+		if ( m_isPerspective && clip.w < LIGHT_CLUSTER_MIN_DEPTH ) {
+			continue;
+		}
+		if ( fabsf( clip.x ) > fabsf( clip.w ) || fabsf( clip.y ) > fabsf( clip.w ) ) {
+			continue;
+		}
+		float depth = m_isPerspective ? clip.w : clip.z;
+		m_minDepth = Min( m_minDepth, depth );
+		m_maxDepth = Max( m_maxDepth, depth );
+		m_hasClusters = true;
+	}
+
+	m_sliceScale = 0.f;
+	if ( m_hasClusters ) {
+		if ( m_isPerspective && m_maxDepth > m_minDepth * 1.0001f ) {
+			m_sliceScale = (float) m_slices / logf( m_maxDepth / m_minDepth );
+		}
+		else if ( !m_isPerspective && m_maxDepth > m_minDepth ) {
+			m_sliceScale = (float) m_slices / ( m_maxDepth - m_minDepth );
+		}
+	}
+
+	int clusterCount = GetClusterCount();
+	m_clusterStarts.assign( clusterCount + 1, 0 );
+	m_lightBounds.resize( lightCount * 6 );
+
+	// Clip space rows, their xyz lengths scale a world radius into clip space extents
+	const Matrix44& vp = viewProjection;
+	float rowLengthX = sqrtf( ( vp.Ix * vp.Ix ) + ( vp.Jx * vp.Jx ) + ( vp.Kx * vp.Kx ) );
+	float rowLengthY = sqrtf( ( vp.Iy * vp.Iy ) + ( vp.Jy * vp.Jy ) + ( vp.Ky * vp.Ky ) );
+	float rowLengthZ = sqrtf( ( vp.Iz * vp.Iz ) + ( vp.Jz * vp.Jz ) + ( vp.Kz * vp.Kz ) );
+	float rowLengthW = sqrtf( ( vp.Iw * vp.Iw ) + ( vp.Jw * vp.Jw ) + ( vp.Kw * vp.Kw ) );
+
+	for ( int lightIndex = 0; lightIndex < lightCount; lightIndex++ ) {
+		int* bounds = &m_lightBounds[ lightIndex * 6 ];
+		bounds[0] = 1;		// Empty until proven otherwise, min x > max x
+		bounds[1] = 0;
+
+		float range = GetLightRange( lights[ lightIndex ] );
+		if ( range < 0.f ) {
+			m_globalLights.push_back( lightIndex );
+			continue;
+		}
+		if ( !m_hasClusters ) {
+			continue;
+		}
+
+		float radius = range * LIGHT_CLUSTER_RANGE_PADDING;
+		const Vector3& center = lights[ lightIndex ].position;
+		Vector4 clip = vp.Transform( Vector4( center.x, center.y, center.z, 1.f ) );
+		float extentX = radius * rowLengthX;
+		float extentY = radius * rowLengthY;
+		float extentW = radius * rowLengthW;
+		float depthCenter = m_isPerspective ? clip.w : clip.z;
+		float depthExtent = m_isPerspective ? extentW : radius * rowLengthZ;
+
+		float minDepth = depthCenter - depthExtent;
+		float maxDepth = depthCenter + depthExtent;
+		if ( maxDepth < m_minDepth || minDepth > m_maxDepth ) {
+			continue;
+		}
+
+		int minTileX = 0;
+		int maxTileX = m_tilesX - 1;
+		int minTileY = 0;
+		int maxTileY = m_tilesY - 1;
+
+		// A sphere reaching behind the camera can project anywhere, otherwise x / w is extreme at a corner of the
+		// x and w intervals
+		float minW = clip.w - extentW;
+		float maxW = clip.w + extentW;
+		if ( !m_isPerspective || minW >= LIGHT_CLUSTER_MIN_DEPTH ) {
+			float minX = clip.x - extentX;
+			float maxX = clip.x + extentX;
+			float minY = clip.y - extentY;
+			float maxY = clip.y + extentY;
+			float minNdcX = Min( Min( minX / minW, minX / maxW ), Min( maxX / minW, maxX / maxW ) );
+			float maxNdcX = Max( Max( minX / minW, minX / maxW ), Max( maxX / minW, maxX / maxW ) );
+			float minNdcY = Min( Min( minY / minW, minY / maxW ), Min( maxY / minW, maxY / maxW ) );
+			float maxNdcY = Max( Max( minY / minW, minY / maxW ), Max( maxY / minW, maxY / maxW ) );
+			if ( maxNdcX < -1.f || minNdcX > 1.f || maxNdcY < -1.f || minNdcY > 1.f ) {
+				continue;
+			}
+			minTileX = GetTile( minNdcX, m_tilesX );
+			maxTileX = GetTile( maxNdcX, m_tilesX );
+			minTileY = GetTile( minNdcY, m_tilesY );
+			maxTileY = GetTile( maxNdcY, m_tilesY );
+		}
+
+		bounds[0] = minTileX;
+		bounds[1] = maxTileX;
+		bounds[2] = minTileY;
+		bounds[3] = maxTileY;
+		bounds[4] = GetSlice( Max( minDepth, m_minDepth ) );
+		bounds[5] = GetSlice( Min( maxDepth, m_maxDepth ) );
+
+		for ( int slice = bounds[4]; slice <= bounds[5]; slice++ ) {
+			for ( int tileY = bounds[2]; tileY <= bounds[3]; tileY++ ) {
+				int rowStart = ( ( slice * m_tilesY ) + tileY ) * m_tilesX;
+				for ( int tileX = bounds[0]; tileX <= bounds[1]; tileX++ ) {
+					m_clusterStarts[ rowStart + tileX + 1 ]++;
+				}
+			}
+		}
+	}
+
+	for ( int clusterIndex = 0; clusterIndex < clusterCount; clusterIndex++ ) {
+		m_clusterStarts[ clusterIndex + 1 ] += m_clusterStarts[ clusterIndex ];
+	}
+	m_clusterLights.resize( m_clusterStarts[ clusterCount ] );
+
+	// m_clusterStarts[c] is the write cursor and ends up at the next cluster's start, shift it back after
+	for ( int lightIndex = 0; lightIndex < lightCount; lightIndex++ ) {
+		const int* bounds = &m_lightBounds[ lightIndex * 6 ];
+		if ( bounds[0] > bounds[1] ) {
+			continue;
+		}
+		for ( int slice = bounds[4]; slice <= bounds[5]; slice++ ) {
+			for ( int tileY = bounds[2]; tileY <= bounds[3]; tileY++ ) {
+				int rowStart = ( ( slice * m_tilesY ) + tileY ) * m_tilesX;
+				for ( int tileX = bounds[0]; tileX <= bounds[1]; tileX++ ) {
+					m_clusterLights[ m_clusterStarts[ rowStart + tileX ]++ ] = lightIndex;
+				}
+			}
+		}
+	}
+	for ( int clusterIndex = clusterCount; clusterIndex > 0; clusterIndex-- ) {
+		m_clusterStarts[ clusterIndex ] = m_clusterStarts[ clusterIndex - 1 ];
+	}
+	m_clusterStarts[0] = 0;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Strongest first, ties to the lower index
+static inline bool IsStrongerLight( float weight, unsigned int index, float otherWeight, unsigned int otherIndex ) {
+	return ( weight > otherWeight ) || ( weight == otherWeight && index < otherIndex );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Insertion into a short sorted list, cheaper than sorting every candidate when only a handful are kept
+static void InsertLight( unsigned int index, float weight, unsigned int* indices, float* weights, int& count, int maxLights ) {
+	if ( count == maxLights && !IsStrongerLight( weight, index, weights[ count - 1 ], indices[ count - 1 ] ) ) {
+		return;
+	}
+
+	int slot = ( count < maxLights ) ? count++ : maxLights - 1;
+	while ( slot > 0 && IsStrongerLight( weight, index, weights[ slot - 1 ], indices[ slot - 1 ] ) ) {
+		indices[ slot ] = indices[ slot - 1 ];
+		weights[ slot ] = weights[ slot - 1 ];
+		slot--;
+	}
+	indices[ slot ] = index;
+	weights[ slot ] = weight;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Drops on the weight itself rather than the range, GetLightRange solves the same cutoff so the grid never leaves
+// out a light that would be kept here
+static void ConsiderLight( const ClusterLight_T& light, unsigned int index, const Vector3& position, unsigned int* indices, float* weights, int& count, int maxLights, bool dropsFaintLights ) {
+	float weight = LightClusterGrid::GetLightWeight( light, position );
+	if ( dropsFaintLights && LightClusterGrid::IsBelowCutoff( light, weight ) ) {
+		return;
+	}
+	InsertLight( index, weight, indices, weights, count, maxLights );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int LightClusterGrid::SelectLights( const Vector3& position, unsigned int* outIndices, int maxLights ) const {
+	int clusterIndex = GetClusterIndex( position );
+	if ( clusterIndex < 0 ) {
+		return SelectLightsBruteForce( m_lights, m_lightCount, position, outIndices, maxLights );
+	}
+
+	maxLights = Min( maxLights, LIGHT_CLUSTER_MAX_SELECTION );
+	float weights[ LIGHT_CLUSTER_MAX_SELECTION ];
+	int count = 0;
+	if ( maxLights <= 0 ) {
+		return 0;
+	}
+
+	for ( int lightSlot = m_clusterStarts[ clusterIndex ]; lightSlot < m_clusterStarts[ clusterIndex + 1 ]; lightSlot++ ) {
+		unsigned int lightIndex = m_clusterLights[ lightSlot ];
+		ConsiderLight( m_lights[ lightIndex ], lightIndex, position, outIndices, weights, count, maxLights, true );
+	}
+	for ( unsigned int lightIndex : m_globalLights ) {
+		ConsiderLight( m_lights[ lightIndex ], lightIndex, position, outIndices, weights, count, maxLights, true );
+	}
+	return count;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+static int SelectLightsFromAll( const ClusterLight_T* lights, int lightCount, const Vector3& position, unsigned int* outIndices, int maxLights, bool dropsFaintLights ) {
+	maxLights = Min( maxLights, LIGHT_CLUSTER_MAX_SELECTION );
+	float weights[ LIGHT_CLUSTER_MAX_SELECTION ];
+	int count = 0;
+	if ( maxLights <= 0 ) {
+		return 0;
+	}
+
+	for ( int lightIndex = 0; lightIndex < lightCount; lightIndex++ ) {
+		ConsiderLight( lights[ lightIndex ], lightIndex, position, outIndices, weights, count, maxLights, dropsFaintLights );
+	}
+	return count;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int LightClusterGrid::SelectLightsBruteForce( const ClusterLight_T* lights, int lightCount, const Vector3& position, unsigned int* outIndices, int maxLights ) {
+	return SelectLightsFromAll( lights, lightCount, position, outIndices, maxLights, true );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int LightClusterGrid::SelectLightsUnfiltered( const ClusterLight_T* lights, int lightCount, const Vector3& position, unsigned int* outIndices, int maxLights ) {
+	return SelectLightsFromAll( lights, lightCount, position, outIndices, maxLights, false );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int LightClusterGrid::GetClusterIndex( const Vector3& position ) const {
+	if ( !m_hasClusters ) {
+		return -1;
+	}
+
+	Vector4 clip = m_viewProjection.Transform( Vector4( position.x, position.y, position.z, 1.f ) );
+	if ( m_isPerspective && clip.w < LIGHT_CLUSTER_MIN_DEPTH ) {
+		return -1;
+	}
+	if ( fabsf( clip.x ) > fabsf( clip.w ) || fabsf( clip.y ) > fabsf( clip.w ) ) {
+		return -1;
+	}
+
+	float depth = m_isPerspective ? clip.w : clip.z;
+	if ( depth < m_minDepth || depth > m_maxDepth ) {
+		return -1;
+	}
+
+	int tileX = GetTile( clip.x / clip.w, m_tilesX );
+	int tileY = GetTile( clip.y / clip.w, m_tilesY );
+	return ( ( ( GetSlice( depth ) * m_tilesY ) + tileY ) * m_tilesX ) + tileX;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int LightClusterGrid::GetClusterCount() const {
+	return m_tilesX * m_tilesY * m_slices;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int LightClusterGrid::GetAssignmentCount() const {
+	return (int) m_clusterLights.size();
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int LightClusterGrid::GetGlobalLightCount() const {
+	return (int) m_globalLights.size();
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+float LightClusterGrid::GetLightWeight( const ClusterLight_T& light, const Vector3& position ) {
+	if ( light.isPointLight ) {
+		return light.intensity / ( 1.f + ( light.attenuation * light.position.DistanceFrom( position ) ) );
+	}
+	return light.intensity;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Solves intensity / ( 1 + attenuation * distance ) = LIGHT_CLUSTER_MIN_CONTRIBUTION for distance. A light too dim
+// to reach the cutoff anywhere gets a range of zero.
+float LightClusterGrid::GetLightRange( const ClusterLight_T& light ) {
+	if ( !light.isPointLight || light.attenuation <= 0.f ) {
+		return -1.f;
+	}
+	return Max( ( light.intensity / LIGHT_CLUSTER_MIN_CONTRIBUTION ) - 1.f, 0.f ) / light.attenuation;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Lights that reach everywhere are never cut off, however dim
+bool LightClusterGrid::IsBelowCutoff( const ClusterLight_T& light, float weight ) {
+	return ( GetLightRange( light ) >= 0.f ) && ( weight < LIGHT_CLUSTER_MIN_CONTRIBUTION );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Logarithmic for perspective so near slices are thin and far ones thick, roughly even in screen space
+int LightClusterGrid::GetSlice( float depth ) const {
+	float slice;
+	if ( m_isPerspective ) {
+		slice = logf( depth / m_minDepth ) * m_sliceScale;
+	}
+	else {
+		slice = ( depth - m_minDepth ) * m_sliceScale;
+	}
+	return ClampInt( (int) slice, 0, m_slices - 1 );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int LightClusterGrid::GetTile( float ndc, int tileCount ) const {
+	return ClampInt( (int) floorf( ( ndc + 1.f ) * 0.5f * (float) tileCount ), 0, tileCount - 1 );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// A position matches when the grid's pick is the unfiltered pick with its faint tail cut off: the same lights in
+// the same order, and whatever the unfiltered ranking has past that is under the cutoff
+LightClusterTestResult_T LightClusterGrid::RunComparison( const Matrix44& viewProjection, const ClusterLight_T* lights, int lightCount, const Vector3* positions, int positionCount, int maxLights ) {
+	LightClusterTestResult_T result;
+	result.positionCount = positionCount;
+
+	LightClusterGrid grid;
+	uint64_t start = GetPerformanceCount();
+	grid.Build( viewProjection, lights, lightCount, positions, positionCount );
+	result.buildSeconds = PerformanceCountToSeconds( GetPerformanceCount() - start );
+	result.assignmentCount = grid.GetAssignmentCount();
+	result.globalLightCount = grid.GetGlobalLightCount();
+
+	std::vector<unsigned int> clusteredIndices( positionCount * maxLights );
+	std::vector<unsigned int> unfilteredIndices( positionCount * maxLights );
+	std::vector<int> clusteredCounts( positionCount );
+	std::vector<int> unfilteredCounts( positionCount );
+
+	start = GetPerformanceCount();
+	for ( int positionIndex = 0; positionIndex < positionCount; positionIndex++ ) {
+		clusteredCounts[ positionIndex ] = grid.SelectLights( positions[ positionIndex ], &clusteredIndices[ positionIndex * maxLights ], maxLights );
+	}
+	result.clusteredSeconds = PerformanceCountToSeconds( GetPerformanceCount() - start );
+
+	start = GetPerformanceCount();
+	for ( int positionIndex = 0; positionIndex < positionCount; positionIndex++ ) {
+		unfilteredCounts[ positionIndex ] = SelectLightsUnfiltered( lights, lightCount, positions[ positionIndex ], &unfilteredIndices[ positionIndex * maxLights ], maxLights );
+	}
+	result.unfilteredSeconds = PerformanceCountToSeconds( GetPerformanceCount() - start );
+
+	for ( int positionIndex = 0; positionIndex < positionCount; positionIndex++ ) {
+		if ( grid.GetClusterIndex( positions[ positionIndex ] ) >= 0 ) {
+			result.inGridCount++;
+		}
+
+		const unsigned int* clustered = &clusteredIndices[ positionIndex * maxLights ];
+		const unsigned int* unfiltered = &unfilteredIndices[ positionIndex * maxLights ];
+		int clusteredCount = clusteredCounts[ positionIndex ];
+		bool isMatch = ( clusteredCount <= unfilteredCounts[ positionIndex ] );
+		for ( int slot = 0; isMatch && slot < clusteredCount; slot++ ) {
+			isMatch = ( clustered[ slot ] == unfiltered[ slot ] );
+		}
+		for ( int slot = clusteredCount; isMatch && slot < unfilteredCounts[ positionIndex ]; slot++ ) {
+			const ClusterLight_T& light = lights[ unfiltered[ slot ] ];
+			isMatch = IsBelowCutoff( light, GetLightWeight( light, positions[ positionIndex ] ) );
+			result.droppedCount++;
+		}
+		if ( !isMatch ) {
+			result.mismatchCount++;
+		}
+	}
+	return result;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void LightClusterGridStartup() {
+	CommandRegistration::RegisterCommand( "light_cluster_test", LightClusterTestCommand, "[lightCount] - Checks clustered light selection against the unfiltered ranking and times both" );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Somewhere in front of the camera, inside a 60 degree cone out to 400 units
+static Vector3 GetRandomPositionInView( const Matrix44& cameraMatrix ) {
+	float depth = GetRandomFloatInRange( 1.f, 400.f );
+	float halfWidth = depth * 0.6f;
+	Vector3 viewPosition( GetRandomFloatInRange( -halfWidth, halfWidth ), GetRandomFloatInRange( -halfWidth, halfWidth ), depth );
+	return cameraMatrix.TransformPosition( viewPosition );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Random lights and positions, mostly in front of a camera at a random spot and angle. Checked against a
+// perspective projection, then an orthographic one.
+void LightClusterTestCommand( const std::string& command ) {
+	Command parsed( command );
+	int lightCount = 256;
+	int argument = 0;
+	if ( parsed.PeekNextInt( argument ) && parsed.GetNextInt( argument ) && argument > 0 ) {
+		lightCount = argument;
+	}
+
+	const int positionCount = 20000;
+	const int maxLights = 8;
+
+	Matrix44 cameraMatrix = Matrix44::MakeRotationDegrees( Vector3( GetRandomFloatInRange( -45.f, 45.f ), GetRandomFloatInRange( -180.f, 180.f ), 0.f ) );
+	cameraMatrix.Tx = GetRandomFloatInRange( -150.f, 150.f );
+	cameraMatrix.Ty = GetRandomFloatInRange( -150.f, 150.f );
+	cameraMatrix.Tz = GetRandomFloatInRange( -150.f, 150.f );
+	Matrix44 view = cameraMatrix.GetInverse();
+
+	// Radii of 5 to 80 units, and a few directional lights
+	std::vector<ClusterLight_T> lights( lightCount );
+	for ( int lightIndex = 0; lightIndex < lightCount; lightIndex++ ) {
+		ClusterLight_T& light = lights[ lightIndex ];
+		light.position = GetRandomPositionInView( cameraMatrix );
+		light.intensity = GetRandomFloatInRange( 0.5f, 2.f );
+		light.attenuation = GetRandomFloatInRange( 2.5f, 10.f );
+		light.isPointLight = ( GetRandomIntLessThan( 64 ) != 0 );
+	}
+
+	// One in ten anywhere around the camera, to exercise the brute force fallback
+	std::vector<Vector3> positions( positionCount );
+	for ( int positionIndex = 0; positionIndex < positionCount; positionIndex++ ) {
+		if ( GetRandomIntLessThan( 10 ) == 0 ) {
+			positions[ positionIndex ] = cameraMatrix.TransformPosition( Vector3( GetRandomFloatInRange( -400.f, 400.f ), GetRandomFloatInRange( -400.f, 400.f ), GetRandomFloatInRange( -400.f, 400.f ) ) );
+		}
+		else {
+			positions[ positionIndex ] = GetRandomPositionInView( cameraMatrix );
+		}
+	}
+
+	Matrix44 viewProjections[2];
+	viewProjections[0] = Matrix44::MakeProjection( 60.f, 16.f / 9.f, 0.1f, 1000.f );
+	viewProjections[0].Append( view );
+	viewProjections[1] = Matrix44::MakeOrthographic( -150.f, 150.f, 100.f, -100.f, 400.f, -400.f );
+	viewProjections[1].Append( view );
+	const char* cameraNames[2] = { "perspective", "orthographic" };
+
+	DevConsole::Printf( "light_cluster_test: %d lights, %d positions, top %d", lightCount, positionCount, maxLights );
+
+	for ( int cameraIndex = 0; cameraIndex < 2; cameraIndex++ ) {
+		LightClusterTestResult_T result = LightClusterGrid::RunComparison( viewProjections[ cameraIndex ], lights.data(), lightCount, positions.data(), positionCount, maxLights );
+
+		DevConsole::Printf( "  %s: %d of %d positions in the grid, %d light/cluster pairs, %d global lights", cameraNames[ cameraIndex ], result.inGridCount, positionCount, result.assignmentCount, result.globalLightCount );
+		DevConsole::Printf( "    build %.3f ms, select %.1f ns/position clustered, %.1f ns/position unfiltered, %d faint picks dropped"
+			, result.buildSeconds * 1000.0
+			, ( result.clusteredSeconds * 1000000000.0 ) / (double) positionCount
+			, ( result.unfilteredSeconds * 1000000000.0 ) / (double) positionCount
+			, result.droppedCount );
+		DevConsole::Printf( result.mismatchCount == 0 ? Rgba( 0, 255, 0, 255 ) : Rgba( 255, 0, 0, 255 ), "    %d mismatches %s", result.mismatchCount, result.mismatchCount == 0 ? "ok" : "FAILED" );
+	}
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include "Engine/Math/Vector3.hpp"
+#include "Engine/Math/Matrix44.hpp"
+
+#include <string>
+#include <vector>
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Assigns lights to a grid of clusters in clip space once per frame, so picking the lights for a draw only looks
+// at the few lights near it instead of every light in the scene. Tiles split NDC x and y evenly, slices split
+// depth (view distance for perspective, logarithmic; clip z for orthographic) over the range the drawn positions
+// actually cover.
+//
+// Lights are ranked the way the lit shaders attenuate them, intensity / ( 1 + attenuation * distance ). A point
+// light stops counting where that weight drops below LIGHT_CLUSTER_MIN_CONTRIBUTION, which is what gives it a
+// radius; brighter lights reach further. Directional lights and lights without attenuation reach everything and
+// skip the grid. Against ranking every light, the only difference is that slots lights this faint would have
+// filled stay empty.
+//
+// Only uses math types, so it can be built and checked without a renderer. light_cluster_test and EngineTests
+// compare it against the unfiltered ranking over random scenes.
+#define LIGHT_CLUSTER_TILES_X 16
+#define LIGHT_CLUSTER_TILES_Y 9
+#define LIGHT_CLUSTER_SLICES 24
+#define LIGHT_CLUSTER_MIN_CONTRIBUTION 0.01f
+#define LIGHT_CLUSTER_MIN_DEPTH 0.01f
+
+
+struct ClusterLight_T {
+	Vector3 position;
+	float intensity = 1.f;
+	float attenuation = 0.f;
+	bool isPointLight = true;
+};
+
+
+struct LightClusterTestResult_T {
+	int positionCount = 0;
+	int inGridCount = 0;
+	int assignmentCount = 0;
+	int globalLightCount = 0;
+	int mismatchCount = 0;			// Positions whose pick isn't the unfiltered one minus lights under the cutoff
+	int droppedCount = 0;			// Lights the unfiltered ranking picked that were under the cutoff
+	double buildSeconds = 0.0;
+	double clusteredSeconds = 0.0;
+	double unfilteredSeconds = 0.0;
+};
+
+
+class LightClusterGrid {
+
+public:
+	explicit LightClusterGrid( int tilesX = LIGHT_CLUSTER_TILES_X, int tilesY = LIGHT_CLUSTER_TILES_Y, int slices = LIGHT_CLUSTER_SLICES );
+
+	// positions are what will ask for lights this frame, only used to fit the depth slices. Light indices handed
+	// out later are indices into lights.
+	void Build( const Matrix44& viewProjection, const ClusterLight_T* lights, int lightCount, const Vector3* positions, int positionCount );
+
+	// Writes the indices of the maxLights most contributing lights at position, strongest first, and returns how
+	// many were written. Equal weights go to the lower index. Positions outside the grid check every light.
+	int SelectLights( const Vector3& position, unsigned int* outIndices, int maxLights ) const;
+
+	int GetClusterIndex( const Vector3& position ) const;		// -1 when outside the grid
+	int GetClusterCount() const;
+	int GetAssignmentCount() const;								// Light/cluster pairs, for stats
+	int GetGlobalLightCount() const;
+
+	static float GetLightWeight( const ClusterLight_T& light, const Vector3& position );
+	static float GetLightRange( const ClusterLight_T& light );	// Negative for lights that reach everywhere
+	static bool IsBelowCutoff( const ClusterLight_T& light, float weight );
+
+	// The same pick without the grid
+	static int SelectLightsBruteForce( const ClusterLight_T* lights, int lightCount, const Vector3& position, unsigned int* outIndices, int maxLights );
+
+	// Every light ranked, none dropped, the way draws picked lights before the grid
+	static int SelectLightsUnfiltered( const ClusterLight_T* lights, int lightCount, const Vector3& position, unsigned int* outIndices, int maxLights );
+
+	// Builds a grid for viewProjection and checks every position's pick against SelectLightsUnfiltered
+	static LightClusterTestResult_T RunComparison( const Matrix44& viewProjection, const ClusterLight_T* lights, int lightCount, const Vector3* positions, int positionCount, int maxLights );
+
+private:
+	int GetSlice( float depth ) const;
+	int GetTile( float ndc, int tileCount ) const;
+
+	int m_tilesX;
+	int m_tilesY;
+	int m_slices;
+
+	Matrix44 m_viewProjection;
+	bool m_isPerspective = true;
+	bool m_hasClusters = false;
+	float m_minDepth = 0.f;
+	float m_maxDepth = 0.f;
+	float m_sliceScale = 0.f;
+
+	const ClusterLight_T* m_lights = nullptr;
+	int m_lightCount = 0;
+
+	std::vector<int> m_clusterStarts;				// m_clusterStarts[c] to m_clusterStarts[c + 1] in m_clusterLights
+	std::vector<unsigned int> m_clusterLights;
+	std::vector<unsigned int> m_globalLights;
+	std::vector<int> m_lightBounds;					// Scratch, six cluster coordinates per light
+};
+
+
+//----------------------------------------------------------------------------------------------------------------
+void LightClusterGridStartup();
+void LightClusterTestCommand( const std::string& command );
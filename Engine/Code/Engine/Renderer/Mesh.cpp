@@ -10,6 +10,7 @@ Mesh::Mesh() {
 
 Mesh::Mesh( unsigned int vertCount, unsigned int indexCount, Vertex3D_PCU* vertices, unsigned int* indices ) {
 	m_vbo.SetVertices(sizeof(Vertex3D_PCU), vertCount, vertices);
+	ComputeBounds( vertCount, vertices );
 	m_ibo.SetIndices(indexCount, indices);
 	m_instructions.startIndex = 0;
 	m_instructions.type = TRIANGLES;
@@ -22,6 +23,7 @@ Mesh::Mesh( unsigned int vertCount, unsigned int indexCount, Vertex3D_PCU* verti
 
 Mesh::Mesh( unsigned int vertCount, unsigned int indexCount, Vertex3D_Lit* vertices, unsigned int* indices ) {
 	m_vbo.SetVertices(sizeof(Vertex3D_Lit), vertCount, vertices);
+	ComputeBounds( vertCount, vertices );
 	m_ibo.SetIndices(indexCount, indices);
 	m_instructions.startIndex = 0;
 	m_instructions.type = TRIANGLES;
@@ -34,6 +36,7 @@ Mesh::Mesh( unsigned int vertCount, unsigned int indexCount, Vertex3D_Lit* verti
 
 Mesh::Mesh( unsigned int count,  Vertex3D_PCU* vertices ) {
 	m_vbo.SetVertices( sizeof(Vertex3D_PCU), count, vertices );
+	ComputeBounds( count, vertices );
 	m_instructions.startIndex = 0;
 	m_instructions.type = TRIANGLES;
 	m_instructions.vertexCount = m_vbo.GetVertexCount();
@@ -49,6 +52,7 @@ Mesh::~Mesh() {
 
 void Mesh::SetMesh( unsigned int vertCount, unsigned int indexCount, Vertex3D_PCU* vertices, unsigned int* indices ) {
 	m_vbo.SetVertices(sizeof(Vertex3D_PCU), vertCount, vertices);
+	ComputeBounds( vertCount, vertices );
 	m_ibo.SetIndices(indexCount, indices);
 	m_instructions.startIndex = 0;
 	m_instructions.type = TRIANGLES;
@@ -56,29 +60,51 @@ void Mesh::SetMesh( unsigned int vertCount, unsigned int indexCount, Vertex3D_PC
 	m_instructions.useIndices = true;
 	m_instructions.indexCount = m_ibo.GetIndexCount();
 	m_layout = &Vertex3D_PCU::LAYOUT;
+	m_instructions.indexByteOffset = 0;
+	m_instructions.baseVertex = 0;
+	m_dynamicVertexHandle = 0;
+	m_dynamicIndexHandle = 0;
 }
 
 void Mesh::SetMesh( unsigned int count, Vertex3D_PCU* vertices ) {
 	m_vbo.SetVertices( sizeof(Vertex3D_PCU), count, vertices );
+	ComputeBounds( count, vertices );
 	m_instructions.startIndex = 0;
 	m_instructions.type = TRIANGLES;
 	m_instructions.vertexCount = m_vbo.GetVertexCount();
 	m_instructions.useIndices = false;
 	m_layout = &Vertex3D_PCU::LAYOUT;
+	m_instructions.indexByteOffset = 0;
+	m_instructions.baseVertex = 0;
+	m_dynamicVertexHandle = 0;
+	m_dynamicIndexHandle = 0;
 }
 
 
 void Mesh::SetIndices( unsigned int count, const unsigned int* data )  {
 	m_ibo.SetIndices(count, data);
+	m_instructions.useIndices = true;
+	m_instructions.indexCount = count;
+	m_dynamicIndexHandle = 0;
+	m_instructions.indexByteOffset = 0;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void Mesh::SetDynamicIndices( const DynamicRange_T& range, unsigned int count ) {
+	m_dynamicIndexHandle = range.bufferHandle;
+	m_instructions.useIndices = true;
+	m_instructions.indexCount = count;
+	m_instructions.indexByteOffset = (unsigned int) range.byteOffset;
 }
 
 
 unsigned int Mesh::GetIndexBufferHandle() {
-	return m_ibo.GetHandle();
+	return ( m_dynamicIndexHandle != 0 ) ? m_dynamicIndexHandle : m_ibo.GetHandle();
 }
 
 unsigned int Mesh::GetVertexBufferHandle() {
-	return m_vbo.GetHandle();
+	return ( m_dynamicVertexHandle != 0 ) ? m_dynamicVertexHandle : m_vbo.GetHandle();
 }
 
 
@@ -94,4 +120,19 @@ void Mesh::SetDrawPrimitive(DrawPrimitive type) {
 
 const VertexLayout* Mesh::GetVertexLayout() const {
 	return m_layout;
+}
+
+
+const AABB3& Mesh::GetBounds() const {
+	return m_bounds;
+}
+
+
+float Mesh::GetBoundingRadius() const {
+	return m_bounds.GetHalfExtents().GetLength();
+}
+
+
+void Mesh::SetBounds( const AABB3& bounds ) {
+	m_bounds = bounds;
 }
\ No newline at end of file
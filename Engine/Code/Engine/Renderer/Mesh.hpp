@@ -1,5 +1,7 @@
 #pragma once
 #include "Engine/Renderer/RenderBuffer.hpp"
+#include "Engine/Renderer/DynamicBufferStream.hpp"
+#include "Engine/Math/AABB3.hpp"
 
 struct Vertex3D_PCU;
 class VertexLayout;
@@ -12,6 +14,8 @@ struct DrawInstructions {
 	unsigned int vertexCount;
 	bool useIndices;
 	unsigned int indexCount;
+	unsigned int indexByteOffset = 0;	// Into the index buffer, only dynamic indices start past zero
+	int baseVertex = 0;					// Added to every index, where dynamic vertices start in their buffer
 };
 
 
@@ -34,16 +38,55 @@ public:
 	const DrawInstructions& GetDrawInstructions();
 	const VertexLayout* GetVertexLayout() const;
 
+	// Local space box around the last vertices set, culling builds world bounds from it
+	const AABB3& GetBounds() const;
+	float GetBoundingRadius() const;
+	void SetBounds( const AABB3& bounds );
+
 	void SetIndices( unsigned int count, const unsigned int* data );
 
+	// Points the mesh at indices written to a range of the renderer's dynamic index stream this frame. Call after
+	// SetDynamicVertices.
+	void SetDynamicIndices( const DynamicRange_T& range, unsigned int count );
+
+	// Points the mesh at vertices written to a range of the renderer's dynamic vertex stream this frame, see
+	// Renderer::MapDynamicVertices. The range is aligned to the vertex size so drawing starts at the vertex
+	// byteOffset / stride. Nothing is read back from the range, so set the bounds with SetBounds.
+	template <typename VERTEX_TYPE>
+	void SetDynamicVertices( const DynamicRange_T& range, unsigned int count ) {
+		m_layout = &VERTEX_TYPE::LAYOUT;
+		m_dynamicVertexHandle = range.bufferHandle;
+		m_dynamicIndexHandle = 0;
+		m_instructions.startIndex = (unsigned int) ( range.byteOffset / sizeof( VERTEX_TYPE ) );
+		m_instructions.vertexCount = count;
+		m_instructions.useIndices = false;
+		m_instructions.indexByteOffset = 0;
+		m_instructions.baseVertex = (int) m_instructions.startIndex;
+	}
+
 	template <typename VERTEXTYPE>
 	void SetVertices( unsigned int count, VERTEXTYPE* vertices ) {
 
 		m_layout = &VERTEXTYPE::LAYOUT;
+		m_dynamicVertexHandle = 0;
+		m_dynamicIndexHandle = 0;
 		m_instructions.startIndex = 0;
 		m_instructions.vertexCount = count;
 		m_instructions.useIndices = 0;
+		m_instructions.baseVertex = 0;
 		m_vbo.SetVertices( sizeof(VERTEXTYPE), count, vertices);
+		ComputeBounds<VERTEXTYPE>( count, vertices );
+	}
+
+	template <typename VERTEXTYPE>
+	void ComputeBounds( unsigned int count, const VERTEXTYPE* vertices ) {
+		m_bounds = AABB3();
+		for (unsigned int i = 0; i < count; i++) {
+			m_bounds.StretchToIncludePoint( vertices[i].position );
+		}
+		if ( count == 0 ) {
+			m_bounds = AABB3( Vector3(0.f, 0.f, 0.f), Vector3(0.f, 0.f, 0.f) );
+		}
 	}
 
 	template <typename VERTEX_TYPE>
@@ -74,4 +117,7 @@ private:
 	IndexBuffer m_ibo;
 	DrawInstructions m_instructions;
 	const VertexLayout* m_layout;
+	unsigned int m_dynamicVertexHandle = 0;		// Stream buffers when the vertices or indices are dynamic, 0 otherwise
+	unsigned int m_dynamicIndexHandle = 0;
+	AABB3 m_bounds = AABB3( Vector3(0.f, 0.f, 0.f), Vector3(0.f, 0.f, 0.f) );
 };
\ No newline at end of file
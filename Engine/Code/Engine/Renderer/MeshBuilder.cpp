@@ -2,6 +2,7 @@
 #include "Engine/Renderer/MeshBuilder.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/MatrixKernels.hpp"
 #include "Engine/Math/SmoothNoise.hpp"
 #include "Engine/Math/IntVector2.hpp"
 #include "Engine/Core/Vertex.hpp"
@@ -675,10 +676,19 @@ void MeshBuilder::BuildWireSphere( Mesh* mesh
 	, unsigned int slices
 	, const Rgba& color /* = Rgba() */ ) {
 
-	//std::vector<Vertex3D_Lit> vertices;
-	//std::vector<unsigned int> indices;
 	Begin(LINES, true);
 	SetColor(color);
+	AddWireSphere(position, radius, wedges, slices);
+	End();
+
+	mesh->FromBuilderAsType<Vertex3D_Lit>(this);
+	mesh->SetDrawPrimitive(LINES);
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void MeshBuilder::AddWireSphere( const Vector3& position, float radius, unsigned int wedges, unsigned int slices ) {
+	unsigned int vertices = (unsigned int) m_vertices.size();
 
 	for (unsigned int slice = 0; slice <= slices; slice++) {
 		float v = (float) slice / (float) slices;
@@ -697,7 +707,7 @@ void MeshBuilder::BuildWireSphere( Mesh* mesh
 
 	for (unsigned int wedgeIndex = 0; wedgeIndex < wedges; ++wedgeIndex) {
 		for (unsigned int sliceIndex = 0; sliceIndex < slices; ++sliceIndex) {
-			unsigned int bottomLeft = (sliceIndex * (wedges + 1)) + wedgeIndex;
+			unsigned int bottomLeft = vertices + (sliceIndex * (wedges + 1)) + wedgeIndex;
 			unsigned int bottomRight = bottomLeft + 1;
 			unsigned int topLeft = bottomLeft + wedges + 1;
 			unsigned int topRight = topLeft + 1;
@@ -707,17 +717,54 @@ void MeshBuilder::BuildWireSphere( Mesh* mesh
 			m_indices.push_back(bottomRight);
 			m_indices.push_back(topRight);
 			m_indices.push_back(topRight);
-			m_indices.push_back(topLeft);		
-			m_indices.push_back(topLeft);			
+			m_indices.push_back(topLeft);
+			m_indices.push_back(topLeft);
 			m_indices.push_back(bottomLeft);
-
 		}
 	}
+}
 
-	End();
 
-	mesh->FromBuilderAsType<Vertex3D_Lit>(this);
-	mesh->SetDrawPrimitive(LINES);
+//----------------------------------------------------------------------------------------------------------------
+// Copies another builder's vertices and indices into this one, baking the transform into the copies
+void MeshBuilder::AddTransformed( const MeshBuilder& source, const Matrix44& transform ) {
+	unsigned int firstVertex = (unsigned int) m_vertices.size();
+	m_vertices.insert( m_vertices.end(), source.m_vertices.begin(), source.m_vertices.end() );
+
+	m_indices.reserve( m_indices.size() + source.m_indices.size() );
+	for ( unsigned int index = 0; index < source.m_indices.size(); index++ ) {
+		m_indices.push_back( firstVertex + source.m_indices[ index ] );
+	}
+
+	TransformVertices( transform, firstVertex );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Runs straight over the interleaved vertices with the batch kernels. Normals and tangents only go through the
+// upper 3x3 and get renormalized, which is right for rotations and uniform scale.
+void MeshBuilder::TransformVertices( const Matrix44& transform, unsigned int firstVertex /* = 0 */ ) {
+	int count = (int) m_vertices.size() - (int) firstVertex;
+	if ( count <= 0 ) {
+		return;
+	}
+
+	VertexMaster* first = &m_vertices[ firstVertex ];
+	TransformPositions( transform, &first->position, &first->position, count, sizeof( VertexMaster ) );
+	TransformDirections( transform, &first->normal, &first->normal, count, sizeof( VertexMaster ) );
+	TransformDirections( transform, &first->tangent, &first->tangent, count, sizeof( VertexMaster ) );
+
+	for ( int index = 0; index < count; index++ ) {
+		VertexMaster& vertex = first[ index ];
+		float normalLength = vertex.normal.GetLength();
+		if ( normalLength > 0.f ) {
+			vertex.normal = vertex.normal * ( 1.f / normalLength );
+		}
+		float tangentLength = vertex.tangent.GetLength();
+		if ( tangentLength > 0.f ) {
+			vertex.tangent = vertex.tangent * ( 1.f / tangentLength );
+		}
+	}
 }
 
 
@@ -732,16 +779,43 @@ void MeshBuilder::BuildTexturedGridFromPerlinParams( const IntVector2& facesInDi
 
 	SetColor(Rgba());
 
+	// Noise for a whole row of corners at once. Faces don't share corners unless faceDimensions is 1,
+	// so each corner of the face gets its own row of samples.
+	int columns = facesInDimensions.y;
+	std::vector<float> leftX( columns );
+	std::vector<float> rightX( columns );
+	std::vector<float> bottomZ( columns );
+	std::vector<float> topZ( columns );
+	std::vector<float> bottomLeftHeights( columns );
+	std::vector<float> bottomRightHeights( columns );
+	std::vector<float> topLeftHeights( columns );
+	std::vector<float> topRightHeights( columns );
+
+	for (int col = 0; col < columns; col++) {
+		leftX[col] = (float) col + bottomLeftPosition.x;
+		rightX[col] = ((float) faceDimensions.x + col) + bottomLeftPosition.x;
+	}
+
 	for (int row = 0; row < facesInDimensions.x; row++) {
-		for (int col = 0; col < facesInDimensions.y; col++) {
+		for (int col = 0; col < columns; col++) {
+			bottomZ[col] = (float) row + bottomLeftPosition.y;
+			topZ[col] = ((float) row + faceDimensions.y) + bottomLeftPosition.y;
+		}
+
+		Compute2dPerlinNoiseBatch( leftX.data(),  bottomZ.data(), columns, bottomLeftHeights.data(),  perlinScale, perlinNumOctaves, perlinOctavePersistence, perlinOctaveScale, true, seed );
+		Compute2dPerlinNoiseBatch( rightX.data(), bottomZ.data(), columns, bottomRightHeights.data(), perlinScale, perlinNumOctaves, perlinOctavePersistence, perlinOctaveScale, true, seed );
+		Compute2dPerlinNoiseBatch( leftX.data(),  topZ.data(),    columns, topLeftHeights.data(),     perlinScale, perlinNumOctaves, perlinOctavePersistence, perlinOctaveScale, true, seed );
+		Compute2dPerlinNoiseBatch( rightX.data(), topZ.data(),    columns, topRightHeights.data(),    perlinScale, perlinNumOctaves, perlinOctavePersistence, perlinOctaveScale, true, seed );
+
+		for (int col = 0; col < columns; col++) {
 			Vector3 bottomLeft	( (float) col,						0.f, (float) row );
 			Vector3 bottomRight	( (float) faceDimensions.x + col,	0.f, (float) row );
 			Vector3 topLeft		( (float) col,						0.f, (float) row + faceDimensions.y );
 			Vector3 topRight	( (float) faceDimensions.x + col,	0.f, (float) row + faceDimensions.y );
-			bottomLeft.y	= 10.f * Compute2dPerlinNoise( bottomLeft.x + bottomLeftPosition.x, bottomLeft.z + bottomLeftPosition.y, perlinScale, perlinNumOctaves, perlinOctavePersistence, perlinOctaveScale, true, seed );
-			bottomRight.y	= 10.f * Compute2dPerlinNoise( bottomRight.x + bottomLeftPosition.x, bottomRight.z + bottomLeftPosition.y, perlinScale, perlinNumOctaves, perlinOctavePersistence, perlinOctaveScale, true, seed );
-			topLeft.y		= 10.f * Compute2dPerlinNoise( topLeft.x + bottomLeftPosition.x, topLeft.z + bottomLeftPosition.y, perlinScale, perlinNumOctaves, perlinOctavePersistence, perlinOctaveScale, true, seed );
-			topRight.y		= 10.f * Compute2dPerlinNoise( topRight.x + bottomLeftPosition.x, topRight.z + bottomLeftPosition.y, perlinScale, perlinNumOctaves, perlinOctavePersistence, perlinOctaveScale, true, seed );
+			bottomLeft.y	= 10.f * bottomLeftHeights[col];
+			bottomRight.y	= 10.f * bottomRightHeights[col];
+			topLeft.y		= 10.f * topLeftHeights[col];
+			topRight.y		= 10.f * topRightHeights[col];
 			
 			Vector3 bottomTangent = (bottomRight - bottomLeft).GetNormalized();
 			Vector3 bottomBitangent = (topLeft - bottomLeft).GetNormalized();
@@ -785,32 +859,23 @@ void MeshBuilder::BuildTexturedGridFromPerlinParams( const IntVector2& facesInDi
 }
 
 
-void MeshBuilder::BuildTexturedGridFromHeightMap( Image* heightMap, const std::vector<Vector3>& normals, const IntVector2& startIndex, unsigned int chunkSize, float minHeight, float maxHeight ) {
+void MeshBuilder::BuildTexturedGridFromHeightField( const HeightField& heightField, const IntVector2& startIndex, unsigned int chunkSize ) {
 
 	SetColor(Rgba());
 
-	IntVector2 endIndex( startIndex.x + chunkSize, startIndex.y + chunkSize );
-
 	for ( unsigned int row = 0; row < chunkSize; row++) {
 		for ( unsigned int col = 0; col < chunkSize; col++) {
-			Vector3 bottomLeft	( (float) col,		0.f, (float) row );
-			Vector3 bottomRight	( (float) 1 + col,	0.f, (float) row );
-			Vector3 topLeft		( (float) col,		0.f, (float) row + 1 );
-			Vector3 topRight	( (float) 1 + col,	0.f, (float) row + 1 );
-			bottomLeft.y	= RangeMapFloat(heightMap->GetTexel(startIndex.x + col,		startIndex.y + row	).r, 0.f, 255.f, minHeight, maxHeight);
-			bottomRight.y	= RangeMapFloat(heightMap->GetTexel(startIndex.x + col + 1, startIndex.y + row	).r, 0.f, 255.f, minHeight, maxHeight);
-			topLeft.y		= RangeMapFloat(heightMap->GetTexel(startIndex.x + col,		startIndex.y + row + 1).r, 0.f, 255.f, minHeight, maxHeight);
-			topRight.y		= RangeMapFloat(heightMap->GetTexel(startIndex.x + col + 1, startIndex.y + row + 1).r, 0.f, 255.f, minHeight, maxHeight);
-
-			// Get normals from the passed in normal map
-			unsigned int bottomLeftIndex = (startIndex.y + row) * heightMap->GetDimensions().x + (startIndex.x + col);
-			unsigned int bottomRightIndex = (startIndex.y + row) * heightMap->GetDimensions().x + (startIndex.x + col + 1);
-			unsigned int topLeftIndex = (startIndex.y + row + 1) * heightMap->GetDimensions().x + (startIndex.x + col);
-			unsigned int topRightIndex = (startIndex.y + row + 1) * heightMap->GetDimensions().x + (startIndex.x + col + 1);
-			Vector3 bottomLeftNormal( normals[bottomLeftIndex] );
-			Vector3 bottomRightNormal( normals[bottomRightIndex] );
-			Vector3 topLeftNormal( normals[topLeftIndex] );
-			Vector3 topRightNormal( normals[topRightIndex] );
+			int sampleX = startIndex.x + (int) col;
+			int sampleY = startIndex.y + (int) row;
+			Vector3 bottomLeft	( (float) col,		heightField.GetHeight( sampleX,		sampleY		), (float) row );
+			Vector3 bottomRight	( (float) 1 + col,	heightField.GetHeight( sampleX + 1, sampleY		), (float) row );
+			Vector3 topLeft		( (float) col,		heightField.GetHeight( sampleX,		sampleY + 1 ), (float) row + 1 );
+			Vector3 topRight	( (float) 1 + col,	heightField.GetHeight( sampleX + 1, sampleY + 1 ), (float) row + 1 );
+
+			Vector3 bottomLeftNormal	= heightField.GetNormal( sampleX,		sampleY );
+			Vector3 bottomRightNormal	= heightField.GetNormal( sampleX + 1,	sampleY );
+			Vector3 topLeftNormal		= heightField.GetNormal( sampleX,		sampleY + 1 );
+			Vector3 topRightNormal		= heightField.GetNormal( sampleX + 1,	sampleY + 1 );
 
 			// Generate tangents using that normal and the bitangent
 			Vector3 bottomBitangent = (topLeft - bottomLeft).GetNormalized();
@@ -4,6 +4,7 @@
 #include "Engine/Math/AABB2.hpp"
 #include "Engine/Math/Matrix44.hpp"
 #include "Engine/Math/IntVector2.hpp"
+#include "Engine/Math/HeightField.hpp"
 #include "Engine/Core/Rgba.hpp"
 #include "Engine/Core/Image.hpp"
 #include "Engine/Renderer/Mesh.hpp"
@@ -42,13 +43,18 @@ public:
 	void BuildSphere( Mesh* mesh, const Vector3& position, float radius, unsigned int wedges, unsigned int slices, const Rgba& color = Rgba() ); 
 	void BuildDeformedSphere( Mesh* mesh, const Vector3& position, float radius, unsigned int wedges, unsigned int slices, float deformAmount, const Rgba& color = Rgba() ); 
 	void BuildTexturedGridFromPerlinParams( const IntVector2& facesInDimensions, const Vector2& faceDimensions, const Vector2& bottomLeftPosition, unsigned int seed, float perlinScale = 1.f, unsigned int perlinNumOctaves = 1, float perlinOctavePersistence = 0.5f, float perlinOctaveScale = 2.f );
-	void BuildTexturedGridFromHeightMap( Image* heightMap, const std::vector<Vector3>& normals, const IntVector2& startIndex, unsigned int chunkSize, float minHeight, float maxHeight );
+	void BuildTexturedGridFromHeightField( const HeightField& heightField, const IntVector2& startIndex, unsigned int chunkSize );
 	void BuildTexturedGridFlat( unsigned int quadsPerDimension, float height );
 
 	void BuildWireSphere( Mesh* mesh, const Vector3& position, float radius, unsigned int wedges, unsigned int slices, const Rgba& color = Rgba() );
 
 	void AddCube( const Vector3& center, const Vector3& size, const Rgba& color = Rgba(255, 255, 255, 255), const AABB2& topUVs = AABB2::ZERO_TO_ONE, const AABB2& sideUVs = AABB2::ZERO_TO_ONE, const AABB2& bottomUVs = AABB2::ZERO_TO_ONE );
 	void AddSphere( const Vector3& position, float radius, unsigned int wedges, unsigned int slices, const Rgba& color = Rgba() ); 
+	void AddWireSphere( const Vector3& position, float radius, unsigned int wedges, unsigned int slices );
+	void AddTransformed( const MeshBuilder& source, const Matrix44& transform );
+
+	// Bakes a transform into every vertex from firstVertex on
+	void TransformVertices( const Matrix44& transform, unsigned int firstVertex = 0 );
 
 	void LoadMeshFromOBJ( const std::string& path );
 
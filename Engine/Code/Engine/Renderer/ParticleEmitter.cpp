@@ -1,6 +1,8 @@
 #include "Engine/Renderer/ParticleEmitter.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Math/MathUtils.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+#include <vector>
 
 
 //----------------------------------------------------------------------------------------------------------------
@@ -116,14 +118,26 @@ void ParticleEmitter::DefaultUpdate( ParticleEmitter* pe ) {
 
 
 //----------------------------------------------------------------------------------------------------------------
-void ParticleEmitter::DefaultPreRender( ParticleEmitter* pe, Camera* camera ) {
+// Same two triangles and UVs as MeshBuilder::PushQuad. out can be mapped memory, so only write to it.
+static void WriteParticleQuad( Vertex3D_PCU* out, const Vector3& bl, const Vector3& br, const Vector3& tr, const Vector3& tl, const Rgba& color ) {
+	out[0] = Vertex3D_PCU( bl, Vector2( 0.f, 0.f ), color );
+	out[1] = Vertex3D_PCU( br, Vector2( 1.f, 0.f ), color );
+	out[2] = Vertex3D_PCU( tr, Vector2( 1.f, 1.f ), color );
+	out[3] = Vertex3D_PCU( bl, Vector2( 0.f, 0.f ), color );
+	out[4] = Vertex3D_PCU( tr, Vector2( 1.f, 1.f ), color );
+	out[5] = Vertex3D_PCU( tl, Vector2( 0.f, 1.f ), color );
+}
+
 
-	if (pe->mesh != nullptr) {
-		delete pe->mesh;
+//----------------------------------------------------------------------------------------------------------------
+// The billboards go straight into the renderer's dynamic vertex stream in their final format, and the emitter
+// keeps the same Mesh from frame to frame pointing at wherever this frame's quads landed. Only when the stream is
+// full do they go through a CPU array into the mesh's own buffer.
+void ParticleEmitter::DefaultPreRender( ParticleEmitter* pe, Camera* camera ) {
+	if ( pe->mesh == nullptr ) {
+		pe->mesh = new Mesh();
 	}
-	pe->mesh = new Mesh();
-	MeshBuilder builder;
-	builder.Begin(TRIANGLES, false);
+
 	Matrix44 cameraModel = camera->transform.GetLocalToWorldMatrix();
 	Matrix44 particleModel = pe->transform.GetWorldToLocalMatrix();
 	particleModel.Append(cameraModel);
@@ -131,6 +145,19 @@ void ParticleEmitter::DefaultPreRender( ParticleEmitter* pe, Camera* camera ) {
 	Vector3 up = particleModel.GetUp();
 	Vector3 right = particleModel.GetRight();
 
+	unsigned int vertexCount = (unsigned int) pe->particles.size() * 6;
+	DynamicRange_T range;
+	std::vector<Vertex3D_PCU> fallbackVertices;
+	Vertex3D_PCU* vertices = nullptr;
+	bool isDynamic = ( vertexCount > 0 ) && g_theRenderer->MapDynamicVertices<Vertex3D_PCU>( vertexCount, range );
+	if ( isDynamic ) {
+		vertices = (Vertex3D_PCU*) range.data;
+	} else {
+		fallbackVertices.resize( vertexCount );
+		vertices = fallbackVertices.data();
+	}
+
+	AABB3 bounds;
 	for (int particleIndex = 0; particleIndex < pe->particles.size(); particleIndex++) {
 		Particle* p = &(pe->particles[particleIndex]);
 
@@ -140,12 +167,21 @@ void ParticleEmitter::DefaultPreRender( ParticleEmitter* pe, Camera* camera ) {
 		Vector3 tl = p->position + (up * p->size) - (right * p->size);
 		Rgba color = Interpolate( pe->startColor, pe->endColor, p->GetNormalizedAge( pe->clock->total.seconds ) );
 
-		builder.SetColor(color);
-		builder.PushQuad(bl, br, tr, tl);
+		WriteParticleQuad( vertices + ( particleIndex * 6 ), bl, br, tr, tl, color );
+		bounds.StretchToIncludePoint( bl );
+		bounds.StretchToIncludePoint( br );
+		bounds.StretchToIncludePoint( tr );
+		bounds.StretchToIncludePoint( tl );
 	}
 
-	builder.End();
-	pe->mesh->FromBuilderAsType<Vertex3D_PCU>(&builder);
+	if ( isDynamic ) {
+		g_theRenderer->UnmapDynamic( range );
+		pe->mesh->SetDynamicVertices<Vertex3D_PCU>( range, vertexCount );
+		pe->mesh->SetBounds( bounds );
+	} else {
+		pe->mesh->SetVertices<Vertex3D_PCU>( vertexCount, vertices );
+	}
+	pe->mesh->SetDrawPrimitive( TRIANGLES );
 	pe->renderable->SetMesh(pe->mesh);
 	pe->renderable->SetModelMatrix(pe->transform.GetLocalToWorldMatrix());
-}
\ No newline at end of file
+}
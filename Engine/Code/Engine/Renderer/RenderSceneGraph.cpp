@@ -1,28 +1,34 @@
 #include "Engine/Renderer/RenderSceneGraph.hpp"
+#include "Engine/Profiler/Profiler.hpp"
 
 
 //----------------------------------------------------------------------------------------------------------------
 void RenderSceneGraph::AddRenderable( Renderable* r ) {
+	int proxy = m_renderableTree.CreateProxy( r->GetWorldBounds(), (int) m_renderables.size() );
 	m_renderables.push_back(r);
+	m_renderableProxies.push_back(proxy);
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
 void RenderSceneGraph::AddCamera( Camera* c ) {
 	m_cameras.push_back(c);
+	m_transforms.Add( &c->transform );
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
 void RenderSceneGraph::AddLight( Light* l ) {
 	m_lights.push_back(l);
+	m_transforms.Add( &l->m_transform );
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
 void RenderSceneGraph::AddParticleEmitter( ParticleEmitter* p ) {
 	m_particleEmitters.push_back(p);
-	m_renderables.push_back(p->renderable);
+	m_transforms.Add( &p->transform );
+	AddRenderable(p->renderable);
 }
 
 
@@ -31,8 +37,16 @@ void RenderSceneGraph::RemoveRenderable( Renderable* r) {
 	std::vector<Renderable*>::iterator searchResult = std::find(m_renderables.begin(), m_renderables.end(), r);
 	if (searchResult != m_renderables.end()) {
 		unsigned int index = (unsigned int) (searchResult - m_renderables.begin());
+		m_renderableTree.DestroyProxy( m_renderableProxies[index] );
+
+		// The last renderable moves into this slot, so its proxy has to point at the new index
 		m_renderables[index] = m_renderables[ m_renderables.size() - 1 ];
+		m_renderableProxies[index] = m_renderableProxies[ m_renderableProxies.size() - 1 ];
 		m_renderables.pop_back();
+		m_renderableProxies.pop_back();
+		if ( index < m_renderables.size() ) {
+			m_renderableTree.SetUserID( m_renderableProxies[index], (int) index );
+		}
 	}
 }
 
@@ -44,6 +58,7 @@ void RenderSceneGraph::RemoveCamera( Camera* c ) {
 		unsigned int index = (unsigned int) (searchResult - m_cameras.begin());
 		m_cameras[index] = m_cameras[ m_cameras.size() - 1 ];
 		m_cameras.pop_back();
+		m_transforms.Remove( &c->transform );
 	}
 }
 
@@ -55,6 +70,7 @@ void RenderSceneGraph::RemoveLight( Light* l ) {
 		unsigned int index = (unsigned int) (searchResult - m_lights.begin());
 		m_lights[index] = m_lights[ m_lights.size() - 1 ];
 		m_lights.pop_back();
+		m_transforms.Remove( &l->m_transform );
 	}
 }
 
@@ -66,6 +82,7 @@ void RenderSceneGraph::RemoveParticleEmitter( ParticleEmitter* l ) {
 	if (searchResult != m_particleEmitters.end()) {
 		unsigned int index = (unsigned int) (searchResult - m_particleEmitters.begin());
 		RemoveRenderable(m_particleEmitters[index]->renderable);
+		m_transforms.Remove( &l->transform );
 		m_particleEmitters[index] = m_particleEmitters[ m_particleEmitters.size() - 1 ];
 		m_particleEmitters.pop_back();
 	}
@@ -78,6 +95,29 @@ void RenderSceneGraph::SortCameras() {
 }
 
 
+//----------------------------------------------------------------------------------------------------------------
+void RenderSceneGraph::UpdateTransforms() {
+	m_transforms.UpdateWorlds();
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void RenderSceneGraph::UpdateBounds() {
+	PROFILER_SCOPED_PUSH();
+	for ( int renderableIndex = 0; renderableIndex < (int) m_renderables.size(); renderableIndex++ ) {
+		m_renderableTree.MoveProxy( m_renderableProxies[renderableIndex], m_renderables[renderableIndex]->GetWorldBounds() );
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void RenderSceneGraph::CullRenderables( const Matrix44& viewProjection, std::vector<int>& outVisibleIndices, AABBTreeQueryStats_T* outStats /* = nullptr */ ) const {
+	PROFILER_SCOPED_PUSH();
+	outVisibleIndices.clear();
+	m_renderableTree.QueryFrustum( Frustum::FromMatrix( viewProjection ), outVisibleIndices, outStats );
+}
+
+
 //----------------------------------------------------------------------------------------------------------------
 unsigned int RenderSceneGraph::GetRenderableCount() const {
 	return (unsigned int) m_renderables.size();
@@ -3,6 +3,8 @@
 #include "Engine/Renderer/Camera.hpp"
 #include "Engine/Renderer/Light.hpp"
 #include "Engine/Renderer/ParticleEmitter.hpp"
+#include "Engine/Math/AABBTree.hpp"
+#include "Engine/Core/TransformHierarchy.hpp"
 #include <vector>
 
 
@@ -27,9 +29,24 @@ public:
 
 	void SortCameras();
 
+	// Brings the cached world matrices of every camera, light and particle emitter transform (and their parents) up
+	// to date. Call once a frame, on the main thread, before anything reads them.
+	void UpdateTransforms();
+
+	// Refits the bounds tree to where the renderables are now. Call once a frame before culling; renderables that
+	// stayed inside their fat box cost one containment check.
+	void UpdateBounds();
+
+	// Indices into the scene's renderables whose world bounds are at least partly inside viewProjection's frustum,
+	// in no particular order
+	void CullRenderables( const Matrix44& viewProjection, std::vector<int>& outVisibleIndices, AABBTreeQueryStats_T* outStats = nullptr ) const;
+
 private:
 	std::vector<Renderable*> m_renderables;
+	std::vector<int> m_renderableProxies;		// Bounds tree proxy for each renderable, same order as m_renderables
+	AABBTree m_renderableTree;
 	std::vector<Light*> m_lights;
 	std::vector<Camera*> m_cameras;
 	std::vector<ParticleEmitter*> m_particleEmitters;
+	TransformHierarchy m_transforms;
 };
\ No newline at end of file
@@ -58,4 +58,20 @@ const Matrix44& Renderable::GetModelMatrix() {
 
 Vector3 Renderable::GetPosition() {
 	return m_modelMatrix.GetTranslation();
+}
+
+
+AABB3 Renderable::GetWorldBounds() const {
+	if ( nullptr == m_mesh ) {
+		Vector3 position = m_modelMatrix.GetTranslation();
+		return AABB3( position, position );
+	}
+	return m_mesh->GetBounds().GetTransformed( m_modelMatrix );
+}
+
+
+void Renderable::GetWorldBoundingSphere( Vector3& outCenter, float& outRadius ) const {
+	AABB3 worldBounds = GetWorldBounds();
+	outCenter = worldBounds.GetCenter();
+	outRadius = worldBounds.GetHalfExtents().GetLength();
 }
\ No newline at end of file
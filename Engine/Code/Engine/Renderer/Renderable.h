@@ -4,6 +4,7 @@
 #include "Engine/Renderer/Mesh.hpp"
 #include "Engine/Renderer/Material.hpp"
 #include "Engine/Math/Matrix44.hpp"
+#include "Engine/Math/AABB3.hpp"
 
 
 class Renderable {
@@ -22,6 +23,10 @@ public:
 	const Matrix44& GetModelMatrix();
 	Vector3 GetPosition();
 
+	// The mesh's local bounds pushed through the model matrix. A renderable without a mesh is a point.
+	AABB3 GetWorldBounds() const;
+	void GetWorldBoundingSphere( Vector3& outCenter, float& outRadius ) const;
+
 private:
 	Matrix44 m_modelMatrix;
 	Mesh* m_mesh;
@@ -8,6 +8,7 @@
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Math/Vector3.hpp"
 #include "Engine/Math/Matrix44.hpp"
+#include "Engine/Math/MatrixKernels.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Renderer/glbindings.h"
 #include "Engine/Renderer/RenderBuffer.hpp"
@@ -19,6 +20,8 @@
 #include "Engine/Renderer/ForwardRenderPath.hpp"
 #include "Engine/Renderer/Light.hpp"
 #include "Engine/Profiler/Profiler.hpp"
+#include "Engine/DevConsole/DevConsole.hpp"
+#include "Engine/DevConsole/Command.hpp"
 
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include "Engine/ThirdParty/stb/stb_image.h"
@@ -36,6 +39,40 @@ HGLRC g_openGLRenderingContext;
 HMODULE g_GLLibrary = nullptr;
 
 
+// Sized for a few frames of particles, contrails and immediate draws in flight at once
+#define DYNAMIC_VERTEX_STREAM_BYTES		(8 * 1024 * 1024)
+#define DYNAMIC_INDEX_STREAM_BYTES		(2 * 1024 * 1024)
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Hashed once here so binding a draw never hashes or passes a name
+static const UniformID UNIFORM_MODEL					= MakeUniformID("MODEL");
+static const UniformID UNIFORM_VIEW						= MakeUniformID("VIEW");
+static const UniformID UNIFORM_PROJECTION				= MakeUniformID("PROJECTION");
+static const UniformID UNIFORM_CAMERA					= MakeUniformID("CAMERA");
+static const UniformID UNIFORM_EYE_POSITION				= MakeUniformID("EYE_POSITION");
+static const UniformID UNIFORM_EYE_DIRECTION			= MakeUniformID("EYE_DIRECTION");
+static const UniformID UNIFORM_MAX_FOG_DISTANCE			= MakeUniformID("MAX_FOG_DISTANCE");
+static const UniformID UNIFORM_FOG_FACTOR				= MakeUniformID("FOG_FACTOR");
+static const UniformID UNIFORM_FOG_COLOR				= MakeUniformID("FOG_COLOR");
+static const UniformID UNIFORM_TIME_IN_SECONDS			= MakeUniformID("TIME_IN_SECONDS");
+static const UniformID UNIFORM_AMBIENT_COLOR			= MakeUniformID("AMBIENT_COLOR");
+static const UniformID UNIFORM_AMBIENT_INTENSITY		= MakeUniformID("AMBIENT_INTENSITY");
+static const UniformID UNIFORM_LIGHT_POSITION			= MakeUniformID("LIGHT_POSITION");
+static const UniformID UNIFORM_LIGHT_DIRECTION			= MakeUniformID("LIGHT_DIRECTION");
+static const UniformID UNIFORM_LIGHT_INNER_ANGLE		= MakeUniformID("LIGHT_INNER_ANGLE");
+static const UniformID UNIFORM_LIGHT_OUTER_ANGLE		= MakeUniformID("LIGHT_OUTER_ANGLE");
+static const UniformID UNIFORM_LIGHT_COLOR				= MakeUniformID("LIGHT_COLOR");
+static const UniformID UNIFORM_LIGHT_INTENSITY			= MakeUniformID("LIGHT_INTENSITY");
+static const UniformID UNIFORM_LIGHT_ATTENUATION		= MakeUniformID("LIGHT_ATTENUATION");
+static const UniformID UNIFORM_LIGHT_IS_POINT			= MakeUniformID("LIGHT_IS_POINT");
+static const UniformID UNIFORM_LIGHT_IS_SHADOWCASTING	= MakeUniformID("LIGHT_IS_SHADOWCASTING");
+static const UniformID UNIFORM_SPECULAR_POWER			= MakeUniformID("SPECULAR_POWER");
+static const UniformID UNIFORM_SPECULAR_AMOUNT			= MakeUniformID("SPECULAR_AMOUNT");
+static const UniformID UNIFORM_SHADOW_VP				= MakeUniformID("SHADOW_VP");
+static const UniformID UNIFORM_SHADOW_INVERSE_VP		= MakeUniformID("SHADOW_INVERSE_VP");
+
+
 //----------------------------------------------------------------------------------------------------------------
 GLenum Renderer::ToGLCompare( DepthCompare compare ) 
 {
@@ -296,6 +333,8 @@ void Renderer::Initialize() {
 	// default_vao is a GLuint member variable
 	glGenVertexArrays( 1, &default_vao ); 
 	glBindVertexArray( default_vao ); 
+	m_dynamicVertices.Initialize( DYNAMIC_VERTEX_STREAM_BYTES );
+	m_dynamicIndices.Initialize( DYNAMIC_INDEX_STREAM_BYTES );
 	m_defaultShader = new Shader();
 	m_currentShader = m_defaultShader;
 	m_defaultShader->SetProgram( CreateOrGetShaderProgram("Data/Shaders/passthroughTex") );
@@ -392,64 +431,132 @@ void Renderer::Draw( DrawCall& drawCall ) {
 //----------------------------------------------------------------------------------------------------------------
 void Renderer::BindLightState() {
 	PROFILER_SCOPED_PUSH();
-	SetUniform("AMBIENT_COLOR", &m_ambientLightColor);
-	SetUniform("AMBIENT_INTENSITY", &m_ambientLightIntensity);
-	SetUniform("LIGHT_POSITION", m_lightPositions, MAX_LIGHTS);
-	SetUniform("LIGHT_DIRECTION", m_lightDirections, MAX_LIGHTS);
-	SetUniform("LIGHT_INNER_ANGLE", m_lightInnerAngles, MAX_LIGHTS);
-	SetUniform("LIGHT_OUTER_ANGLE", m_lightOuterAngles, MAX_LIGHTS);
-	SetUniform("LIGHT_COLOR", m_lightColors, MAX_LIGHTS);
-	SetUniform("LIGHT_INTENSITY", m_lightIntensities, MAX_LIGHTS);
-	SetUniform("LIGHT_ATTENUATION", m_lightAttenuation, MAX_LIGHTS);
-	SetUniform("LIGHT_IS_POINT", m_isPointLight, MAX_LIGHTS);
-	SetUniform("SPECULAR_POWER", &m_specularPower);
-	SetUniform("SPECULAR_AMOUNT", &m_specularAmount);
-	SetUniform("LIGHT_IS_SHADOWCASTING", m_isShadowcasting, MAX_LIGHTS);
-	GLint shadowVPUniform			= glGetUniformLocation(m_currentShader->GetProgram()->GetHandle(), "SHADOW_VP");
-	GLint shadowInverseVPUniform	= glGetUniformLocation(m_currentShader->GetProgram()->GetHandle(), "SHADOW_INVERSE_VP");
-	glProgramUniformMatrix4fv(m_currentShader->GetProgram()->GetHandle(), shadowVPUniform,		  MAX_LIGHTS, GL_FALSE, &(m_lightVP[0].Ix));
-	glProgramUniformMatrix4fv(m_currentShader->GetProgram()->GetHandle(), shadowInverseVPUniform, MAX_LIGHTS, GL_FALSE, &(m_inverseLightVP[0].Ix));
-	
-	GLint cameraPosUniform	= glGetUniformLocation(m_currentShader->GetProgram()->GetHandle(), "EYE_POSITION");
-	GLint cameraDirUniform	= glGetUniformLocation(m_currentShader->GetProgram()->GetHandle(), "EYE_DIRECTION");
-	Vector3 cameraPosition = m_currentCamera->m_cameraMatrix.GetTranslation();
-	Vector3 cameraDirection = m_currentCamera->GetForward();
-	glUniform3f(cameraPosUniform, cameraPosition.x, cameraPosition.y, cameraPosition.z);
-	glUniform3f(cameraDirUniform, cameraDirection.x, cameraDirection.y, cameraDirection.z);
+	SetUniform(UNIFORM_AMBIENT_COLOR, &m_ambientLightColor);
+	SetUniform(UNIFORM_AMBIENT_INTENSITY, &m_ambientLightIntensity);
+	SetUniform(UNIFORM_LIGHT_POSITION, m_lightPositions, MAX_LIGHTS);
+	SetUniform(UNIFORM_LIGHT_DIRECTION, m_lightDirections, MAX_LIGHTS);
+	SetUniform(UNIFORM_LIGHT_INNER_ANGLE, m_lightInnerAngles, MAX_LIGHTS);
+	SetUniform(UNIFORM_LIGHT_OUTER_ANGLE, m_lightOuterAngles, MAX_LIGHTS);
+	SetUniform(UNIFORM_LIGHT_COLOR, m_lightColors, MAX_LIGHTS);
+	SetUniform(UNIFORM_LIGHT_INTENSITY, m_lightIntensities, MAX_LIGHTS);
+	SetUniform(UNIFORM_LIGHT_ATTENUATION, m_lightAttenuation, MAX_LIGHTS);
+	SetUniform(UNIFORM_LIGHT_IS_POINT, m_isPointLight, MAX_LIGHTS);
+	SetUniform(UNIFORM_SPECULAR_POWER, &m_specularPower);
+	SetUniform(UNIFORM_SPECULAR_AMOUNT, &m_specularAmount);
+	SetUniform(UNIFORM_LIGHT_IS_SHADOWCASTING, m_isShadowcasting, MAX_LIGHTS);
+	SetUniform(UNIFORM_SHADOW_VP, m_lightVP, MAX_LIGHTS);
+	SetUniform(UNIFORM_SHADOW_INVERSE_VP, m_inverseLightVP, MAX_LIGHTS);
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
 void Renderer::DrawMesh( Mesh* mesh ) {
 	PROFILER_SCOPED_PUSH();	
+	BindMesh( mesh );
+	DrawBoundMesh();
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// The attribute bindings depend on the current shader, so rebind after changing it
+void Renderer::BindMesh( Mesh* mesh ) {
 	glBindBuffer(GL_ARRAY_BUFFER, mesh->GetVertexBufferHandle());
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->GetIndexBufferHandle());
+	m_frameCounters.bufferBinds += 2;
 	BindLayoutToProgram(mesh->GetVertexLayout());
+	m_boundMesh = mesh;
+}
 
-	BindRenderState();
 
-	GLint modelUniform		= glGetUniformLocation(m_currentShader->GetProgram()->GetHandle(), "MODEL");
-	GLint viewUniform		= glGetUniformLocation(m_currentShader->GetProgram()->GetHandle(), "VIEW");
-	GLint projectionUniform = glGetUniformLocation(m_currentShader->GetProgram()->GetHandle(), "PROJECTION");
-	GLint cameraUniform		= glGetUniformLocation(m_currentShader->GetProgram()->GetHandle(), "CAMERA");
+//----------------------------------------------------------------------------------------------------------------
+// Draws the last mesh passed to BindMesh with the current model matrix
+void Renderer::DrawBoundMesh() {
+	DrawBoundMeshInstances(&m_modelMatrix, 1);
+}
 
-	glProgramUniformMatrix4fv(m_currentShader->GetProgram()->GetHandle(), modelUniform,	1, GL_FALSE, &(m_modelMatrix.Ix));
-	glProgramUniformMatrix4fv(m_currentShader->GetProgram()->GetHandle(), viewUniform, 1, GL_FALSE, &(m_currentCamera->m_viewMatrix.Ix));
-	glProgramUniformMatrix4fv(m_currentShader->GetProgram()->GetHandle(), projectionUniform, 1, GL_FALSE, &(m_currentCamera->m_projMatrix.Ix));
-	glProgramUniformMatrix4fv(m_currentShader->GetProgram()->GetHandle(), cameraUniform, 1, GL_FALSE, &(m_currentCamera->m_cameraMatrix.Ix));
-		
 
-	SetUniform("MAX_FOG_DISTANCE", &m_fogMaxDistance);
-	SetUniform("FOG_FACTOR", &m_fogFactor);
-	SetUniform("FOG_COLOR", &m_fogColor);
-	SetUniform("TIME_IN_SECONDS", &g_masterClock->total.seconds);
+//----------------------------------------------------------------------------------------------------------------
+// Draws the last mesh passed to BindMesh once per model matrix. Render state, program, uniform blocks and the
+// MODEL location are set up once for the whole run, so between draws only the matrix itself is uploaded. Leaves
+// the model matrix at the last one drawn.
+void Renderer::DrawBoundMeshInstances( const Matrix44* models, int instanceCount ) {
+	Mesh* mesh = m_boundMesh;
+	const ShaderProgram* program = m_currentShader->GetProgram();
+	BindRenderState();
+	UseProgram(program->GetHandle());
+
+	UpdateUniformBlocks();
+
+	m_frameCounters.uniformTableLookups++;
+	GLint modelLocation = program->GetUniformLocation(UNIFORM_MODEL);
 
 	DrawInstructions di = mesh->GetDrawInstructions();
-	if (di.useIndices) {
-		glDrawElements(GetGLDrawMode(di.type), di.indexCount, GL_UNSIGNED_INT, (void*) 0);
+	GLenum drawMode = GetGLDrawMode(di.type);
+	for (int instanceIndex = 0; instanceIndex < instanceCount; instanceIndex++) {
+		m_modelMatrix = models[instanceIndex];
+		if (modelLocation >= 0) {
+			glProgramUniformMatrix4fv(program->GetHandle(), modelLocation, 1, GL_FALSE, &(m_modelMatrix.Ix));
+			m_frameCounters.uniformUploads++;
+		}
+
+		if (di.useIndices && di.baseVertex != 0) {
+			glDrawElementsBaseVertex(drawMode, di.indexCount, GL_UNSIGNED_INT, (void*) (size_t) di.indexByteOffset, di.baseVertex);
+		}
+		else if (di.useIndices) {
+			glDrawElements(drawMode, di.indexCount, GL_UNSIGNED_INT, (void*) (size_t) di.indexByteOffset);
+		}
+		else {
+			glDrawArrays(drawMode, di.startIndex, di.vertexCount);
+		}
 	}
-	else {
-		glDrawArrays(GetGLDrawMode(di.type), di.startIndex, di.vertexCount);
+	m_frameCounters.draws += instanceCount;
+	m_frameCounters.drawBatches++;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Rebuilt every draw since cameras can change their matrices after SetCamera, but the buffers only upload when
+// the contents changed, which works out to once per frame and once per camera. Programs without the blocks still
+// get the old plain uniforms.
+void Renderer::UpdateUniformBlocks() {
+	CameraBlock_T camera;
+	camera.view = m_currentCamera->m_viewMatrix;
+	camera.projection = m_currentCamera->m_projMatrix;
+	camera.camera = m_currentCamera->m_cameraMatrix;
+	camera.eyePosition = m_currentCamera->m_cameraMatrix.GetTranslation();
+	camera.padding0 = 0.f;
+	camera.eyeDirection = m_currentCamera->GetForward();
+	camera.padding1 = 0.f;
+
+	FrameBlock_T frame;
+	frame.time = g_masterClock->total.seconds;
+	frame.maxFogDistance = m_fogMaxDistance;
+	frame.fogFactor = m_fogFactor;
+	frame.padding0 = 0.f;
+	m_fogColor.GetAsFloats(frame.fogColor[0], frame.fogColor[1], frame.fogColor[2], frame.fogColor[3]);
+
+	m_cameraUniforms.Set(camera);
+	m_frameUniforms.Set(frame);
+	if (m_cameraUniforms.Flush(UNIFORM_BLOCK_CAMERA)) {
+		m_frameCounters.uniformBlockUploads++;
+	}
+	if (m_frameUniforms.Flush(UNIFORM_BLOCK_FRAME)) {
+		m_frameCounters.uniformBlockUploads++;
+	}
+
+	const ShaderProgram* program = m_currentShader->GetProgram();
+	if (!program->HasUniformBlock(UNIFORM_BLOCK_CAMERA)) {
+		SetUniform(UNIFORM_VIEW, &camera.view);
+		SetUniform(UNIFORM_PROJECTION, &camera.projection);
+		SetUniform(UNIFORM_CAMERA, &camera.camera);
+		SetUniform(UNIFORM_EYE_POSITION, &camera.eyePosition);
+		SetUniform(UNIFORM_EYE_DIRECTION, &camera.eyeDirection);
+	}
+	if (!program->HasUniformBlock(UNIFORM_BLOCK_FRAME)) {
+		SetUniform(UNIFORM_MAX_FOG_DISTANCE, &m_fogMaxDistance);
+		SetUniform(UNIFORM_FOG_FACTOR, &m_fogFactor);
+		SetUniform(UNIFORM_FOG_COLOR, &m_fogColor);
+		SetUniform(UNIFORM_TIME_IN_SECONDS, &frame.time);
 	}
 }
 
@@ -457,26 +564,73 @@ void Renderer::DrawMesh( Mesh* mesh ) {
 //----------------------------------------------------------------------------------------------------------------
 void Renderer::DrawMeshImmediate( Vertex3D_PCU* verts, int numVerts, DrawPrimitive drawPrimitive ) {
 	PROFILER_SCOPED_PUSH();
-	glUseProgram(m_currentShader->GetProgram()->GetHandle());
+	UseProgram(m_currentShader->GetProgram()->GetHandle());
 
 	Matrix44 model;
+	SetModelMatrix(model);
+
+	DynamicRange_T vertexRange;
+	if ( numVerts > 0 && MapDynamicVertices<Vertex3D_PCU>( numVerts, vertexRange ) ) {
+		memcpy( vertexRange.data, verts, numVerts * sizeof( Vertex3D_PCU ) );
+		UnmapDynamic( vertexRange );
+
+		Mesh immediateMesh;
+		immediateMesh.SetDynamicVertices<Vertex3D_PCU>( vertexRange, numVerts );
+		immediateMesh.SetDrawPrimitive( drawPrimitive );
+		DrawMesh( &immediateMesh );
+		return;
+	}
+
 	Mesh* immediateMesh = new Mesh(numVerts, verts);
 	immediateMesh->SetDrawPrimitive(drawPrimitive);
-	SetModelMatrix(model);
 	DrawMesh(immediateMesh);
 	delete immediateMesh;
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
+// Converts straight from the builder's VertexMaster into the stream, no temporary array in between
 void Renderer::DrawMeshImmediate( MeshBuilder* builder ) {
 	PROFILER_SCOPED_PUSH();
-	glUseProgram(m_currentShader->GetProgram()->GetHandle());
+	UseProgram(m_currentShader->GetProgram()->GetHandle());
 
 	Matrix44 model;
+	SetModelMatrix(model);
+
+	const std::vector<VertexMaster>& vertices = builder->GetVertices();
+	const std::vector<unsigned int>& indices = builder->GetIndices();
+	DrawInstructions instructions = builder->GetDrawInstructions();
+	unsigned int vertexCount = (unsigned int) vertices.size();
+	unsigned int indexCount = instructions.useIndices ? (unsigned int) indices.size() : 0;
+
+	DynamicRange_T vertexRange;
+	DynamicRange_T indexRange;
+	bool isMapped = vertexCount > 0 && MapDynamicVertices<Vertex3D_PCU>( vertexCount, vertexRange );
+	if ( isMapped && indexCount > 0 ) {
+		isMapped = MapDynamicIndices( indexCount, indexRange );
+	}
+
+	if ( isMapped ) {
+		Vertex3D_PCU* mappedVertices = (Vertex3D_PCU*) vertexRange.data;
+		for ( unsigned int vertexIndex = 0; vertexIndex < vertexCount; vertexIndex++ ) {
+			mappedVertices[vertexIndex] = Vertex3D_PCU( vertices[vertexIndex] );
+		}
+		UnmapDynamic( vertexRange );
+
+		Mesh immediateMesh;
+		immediateMesh.SetDynamicVertices<Vertex3D_PCU>( vertexRange, vertexCount );
+		if ( indexCount > 0 ) {
+			memcpy( indexRange.data, indices.data(), indexCount * sizeof( unsigned int ) );
+			UnmapDynamic( indexRange );
+			immediateMesh.SetDynamicIndices( indexRange, indexCount );
+		}
+		immediateMesh.SetDrawPrimitive( instructions.type );
+		DrawMesh( &immediateMesh );
+		return;
+	}
+
 	Mesh immediateMesh;
 	immediateMesh.FromBuilderAsType<Vertex3D_PCU>( builder );
-	SetModelMatrix(model);
 	DrawMesh(&immediateMesh);
 }
 
@@ -484,16 +638,47 @@ void Renderer::DrawMeshImmediate( MeshBuilder* builder ) {
 //----------------------------------------------------------------------------------------------------------------
 void Renderer::DrawMeshImmediate( Vertex3D_Lit* verts, int numVerts, unsigned int* indices, int numIndices, DrawPrimitive drawPrimitive ) {
 	PROFILER_SCOPED_PUSH();
-	glUseProgram(m_currentShader->GetProgram()->GetHandle());
-
+	UseProgram(m_currentShader->GetProgram()->GetHandle());
 
 	Matrix44 model;
+	SetModelMatrix(model);
+
+	DynamicRange_T vertexRange;
+	DynamicRange_T indexRange;
+	if ( numVerts > 0 && numIndices > 0 && MapDynamicVertices<Vertex3D_Lit>( numVerts, vertexRange ) && MapDynamicIndices( numIndices, indexRange ) ) {
+		memcpy( vertexRange.data, verts, numVerts * sizeof( Vertex3D_Lit ) );
+		memcpy( indexRange.data, indices, numIndices * sizeof( unsigned int ) );
+		UnmapDynamic( vertexRange );
+		UnmapDynamic( indexRange );
+
+		Mesh immediateMesh;
+		immediateMesh.SetDynamicVertices<Vertex3D_Lit>( vertexRange, numVerts );
+		immediateMesh.SetDynamicIndices( indexRange, numIndices );
+		immediateMesh.SetDrawPrimitive( drawPrimitive );
+		DrawMesh( &immediateMesh );
+		return;
+	}
+
 	Mesh* immediateMesh = new Mesh(numVerts, numIndices, verts, indices);
 	immediateMesh->SetDrawPrimitive(drawPrimitive);
-	SetModelMatrix(model);
 	DrawMesh(immediateMesh);
 	delete immediateMesh;
+}
+
 
+//----------------------------------------------------------------------------------------------------------------
+bool Renderer::MapDynamicIndices( unsigned int count, DynamicRange_T& outRange ) {
+	return m_dynamicIndices.Allocate( count * sizeof( unsigned int ), sizeof( unsigned int ), outRange );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void Renderer::UnmapDynamic( const DynamicRange_T& range ) {
+	if ( range.bufferHandle == m_dynamicIndices.GetHandle() ) {
+		m_dynamicIndices.Commit( range );
+	} else {
+		m_dynamicVertices.Commit( range );
+	}
 }
 
 
@@ -516,6 +701,37 @@ void Renderer::EndFrame() {
 
 	// "Present" the backbuffer by swapping the front (visible) and back (working) screen buffers
 	SwapBuffers( g_displayDeviceContext ); // Note: call this once at the end of each frame
+
+	m_frameCounters.dynamicBytes = (int) ( m_dynamicVertices.GetFrameBytes() + m_dynamicIndices.GetFrameBytes() );
+	m_frameCounters.dynamicStalls = m_dynamicVertices.GetFrameStallCount() + m_dynamicIndices.GetFrameStallCount();
+	m_dynamicVertices.EndFrame();
+	m_dynamicIndices.EndFrame();
+
+	PublishCounters();
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void Renderer::PublishCounters() {
+	Profiler::AddCounter("draws", m_frameCounters.draws);
+	Profiler::AddCounter("draw batches", m_frameCounters.drawBatches);
+	Profiler::AddCounter("program binds", m_frameCounters.programBinds);
+	Profiler::AddCounter("texture binds", m_frameCounters.textureBinds);
+	Profiler::AddCounter("buffer binds", m_frameCounters.bufferBinds);
+	Profiler::AddCounter("uniform uploads", m_frameCounters.uniformUploads);
+	Profiler::AddCounter("uniform block uploads", m_frameCounters.uniformBlockUploads);
+	Profiler::AddCounter("attribute name lookups", m_frameCounters.attributeNameLookups);
+	Profiler::AddCounter("dynamic bytes", m_frameCounters.dynamicBytes);
+	Profiler::AddCounter("dynamic stalls", m_frameCounters.dynamicStalls);
+
+	m_lastFrameCounters = m_frameCounters;
+	m_frameCounters = RenderCounters_T();
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+const RenderCounters_T& Renderer::GetLastFrameCounters() const {
+	return m_lastFrameCounters;
 }
 
 
@@ -559,17 +775,15 @@ void Renderer::DrawQuad(const Matrix44& transform, const Vector2& dimensions, co
 	Vector3 bottomLeft(-halfWidth, -halfHeight, 0.f);
 	Vector3 bottomRight(halfWidth, -halfHeight, 0.f);
 
-	topLeft =     transform.TransformPosition(topLeft);
-	topRight =    transform.TransformPosition(topRight);
-	bottomLeft =  transform.TransformPosition(bottomLeft);
-	bottomRight = transform.TransformPosition(bottomRight);
+	Vector3 corners[4] = { topLeft, topRight, bottomLeft, bottomRight };
+	TransformPositions(transform, corners, corners, 4);
 		
-	vertices[0].position = Vector3(topLeft.x, topLeft.y, 0.f);
-	vertices[1].position = Vector3(topRight.x, topRight.y, 0.f);
-	vertices[2].position = Vector3(bottomLeft.x, bottomLeft.y, 0.f);
-	vertices[3].position = Vector3(topRight.x, topRight.y, 0.f);
-	vertices[4].position = Vector3(bottomRight.x, bottomRight.y, 0.f);
-	vertices[5].position = Vector3(bottomLeft.x, bottomLeft.y, 0.f);
+	vertices[0].position = Vector3(corners[0].x, corners[0].y, 0.f);
+	vertices[1].position = Vector3(corners[1].x, corners[1].y, 0.f);
+	vertices[2].position = Vector3(corners[2].x, corners[2].y, 0.f);
+	vertices[3].position = Vector3(corners[1].x, corners[1].y, 0.f);
+	vertices[4].position = Vector3(corners[3].x, corners[3].y, 0.f);
+	vertices[5].position = Vector3(corners[2].x, corners[2].y, 0.f);
 
 	for (int i = 0; i < 6; i++) {
 		vertices[i].color = color;
@@ -1125,6 +1339,7 @@ void Renderer::ReloadAllShaders() {
 
 	m_defaultShader->SetProgram( m_loadedShaders["Data/Shaders/passthrough"] );
 	m_currentShader = m_defaultShader;
+	m_boundProgramHandle = 0;
 
 	Renderer::LoadBuiltInShaders();
 }
@@ -1389,6 +1604,7 @@ void Renderer::UseTexture( unsigned int slot, const Texture& tex, Sampler* sampl
 		glBindTexture(GL_TEXTURE_2D, tex.GetTextureID());
 
 	}
+	m_frameCounters.textureBinds++;
 }
 
 
@@ -1402,6 +1618,7 @@ void Renderer::UseCubemap( unsigned int slot, const CubeMap& cubeMap, Sampler* s
 		glBindSampler(slot, sampler->GetHandle());
 	}
 	glBindTexture(GL_TEXTURE_CUBE_MAP, cubeMap.GetTextureID());
+	m_frameCounters.textureBinds++;
 }
 
 
@@ -1604,52 +1821,88 @@ void Renderer::DrawSprite(const Vector3& position, Sprite* sprite, const Vector3
 
 
 //----------------------------------------------------------------------------------------------------------------
+// The name versions are for one-off uniforms; they hash the name and go through the program's table like the rest
 void Renderer::SetUniform(const std::string& name, const Rgba* color, unsigned int size ) const {
-	PROFILER_SCOPED_PUSH();
+	SetUniform(MakeUniformID(name), color, size);
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void Renderer::SetUniform(const std::string& name, const float* param, unsigned int size) const {
+	SetUniform(MakeUniformID(name), param, size);
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void Renderer::SetUniform( const std::string& name, const Vector3* vec3, unsigned int size ) const {
+	SetUniform(MakeUniformID(name), vec3, size);
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void Renderer::SetUniform( const std::string& name, const Vector4* vec4, unsigned int size ) const {
+	SetUniform(MakeUniformID(name), vec4, size);
+}
 
-	GLint uniformLocation = glGetUniformLocation(m_currentShader->GetProgram()->GetHandle(), name.c_str());
+
+//----------------------------------------------------------------------------------------------------------------
+void Renderer::SetUniform( UniformID id, const Rgba* color, unsigned int size ) const {
+	m_frameCounters.uniformTableLookups++;
+	GLint uniformLocation = m_currentShader->GetProgram()->GetUniformLocation(id);
 	
 	if (uniformLocation >= 0) {
-		//float* c = new float[MAX_LIGHTS * size];
-		float c[32];
+		float c[4 * MAX_LIGHTS];
 		for (unsigned int i = 0; i < size; i++) {
 			unsigned int colorIndex = i * 4;
 			color[i].GetAsFloats(c[colorIndex], c[colorIndex+1], c[colorIndex+2], c[colorIndex+3]);
 		}
 		glUniform4fv(uniformLocation, size, c);
+		m_frameCounters.uniformUploads++;
 	}
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
-void Renderer::SetUniform(const std::string& name, const float* param, unsigned int size) const {
-	PROFILER_SCOPED_PUSH();
-
-	GLint uniformLocation = glGetUniformLocation(m_currentShader->GetProgram()->GetHandle(), name.c_str());
+void Renderer::SetUniform( UniformID id, const float* param, unsigned int size ) const {
+	m_frameCounters.uniformTableLookups++;
+	GLint uniformLocation = m_currentShader->GetProgram()->GetUniformLocation(id);
 	if (uniformLocation >= 0) {
 		glUniform1fv(uniformLocation, size, param);
+		m_frameCounters.uniformUploads++;
 	}
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
-void Renderer::SetUniform( const std::string& name, const Vector3* vec3, unsigned int size ) const {
-	PROFILER_SCOPED_PUSH();
-
-	GLint uniformLocation = glGetUniformLocation(m_currentShader->GetProgram()->GetHandle(), name.c_str());
+void Renderer::SetUniform( UniformID id, const Vector3* vec3, unsigned int size ) const {
+	m_frameCounters.uniformTableLookups++;
+	GLint uniformLocation = m_currentShader->GetProgram()->GetUniformLocation(id);
 	if (uniformLocation >= 0) {
 		glUniform3fv(uniformLocation, size, &(vec3->x));
+		m_frameCounters.uniformUploads++;
 	}
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
-void Renderer::SetUniform( const std::string& name, const Vector4* vec4, unsigned int size ) const {
-	PROFILER_SCOPED_PUSH();
-
-	GLint uniformLocation = glGetUniformLocation(m_currentShader->GetProgram()->GetHandle(), name.c_str());
+void Renderer::SetUniform( UniformID id, const Vector4* vec4, unsigned int size ) const {
+	m_frameCounters.uniformTableLookups++;
+	GLint uniformLocation = m_currentShader->GetProgram()->GetUniformLocation(id);
 	if (uniformLocation >= 0) {
 		glUniform4fv(uniformLocation, size, &(vec4->x));
+		m_frameCounters.uniformUploads++;
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void Renderer::SetUniform( UniformID id, const Matrix44* matrices, unsigned int size ) const {
+	m_frameCounters.uniformTableLookups++;
+	const ShaderProgram* program = m_currentShader->GetProgram();
+	GLint uniformLocation = program->GetUniformLocation(id);
+	if (uniformLocation >= 0) {
+		glProgramUniformMatrix4fv(program->GetHandle(), uniformLocation, size, GL_FALSE, &(matrices->Ix));
+		m_frameCounters.uniformUploads++;
 	}
 }
 
@@ -1662,7 +1915,19 @@ void Renderer::SetShader( Shader* shader ) {
 		shader = m_defaultShader;
 	}
 	m_currentShader = shader;
-	glUseProgram(m_currentShader->GetProgram()->GetHandle());
+	UseProgram(m_currentShader->GetProgram()->GetHandle());
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Binds are skipped when the program is already current, which most draws in a material sorted frame are
+void Renderer::UseProgram( unsigned int programHandle ) {
+	if (programHandle == m_boundProgramHandle) {
+		return;
+	}
+	glUseProgram(programHandle);
+	m_boundProgramHandle = programHandle;
+	m_frameCounters.programBinds++;
 }
 
 
@@ -1705,10 +1970,14 @@ void Renderer::BindRenderState() {
 void Renderer::BindLayoutToProgram(VertexLayout const *layout) {
 	PROFILER_SCOPED_PUSH();
 	
+	int nameLookups = 0;
+	const std::vector<int>& locations = m_currentShader->GetProgram()->GetAttributeLocations( layout, &nameLookups );
+	m_frameCounters.attributeNameLookups += nameLookups;
+
 	unsigned int attribCount = layout->GetAttributeCount();
 	for (unsigned int attribIndex = 0; attribIndex < attribCount; attribIndex++) {
 		const VertexAttribute& attrib = layout->GetAttribute(attribIndex);
-		GLint bind = glGetAttribLocation( m_currentShader->GetProgram()->GetHandle(), attrib.handle.c_str() );
+		GLint bind = locations[attribIndex];
 		if (bind >= 0) {
 			glEnableVertexAttribArray( bind );
 			glVertexAttribPointer( bind, 
@@ -2030,4 +2299,28 @@ Matrix44 Renderer::GetClipToScreenSpace( Camera* worldCam ) {
 
 	Matrix44 uiProjectionInverse = m_defaultUICamera->GetViewProjection().GetInverse();
 	return uiProjectionInverse;
-}
\ No newline at end of file
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void RenderStatsStartup() {
+	CommandRegistration::RegisterCommand( "render_stats", RenderStatsCommand, "Prints the GL work the renderer did last frame" );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void RenderStatsCommand( const std::string& command ) {
+	const RenderCounters_T& counters = g_theRenderer->GetLastFrameCounters();
+	DevConsole::Printf( "render_stats: last frame" );
+	DevConsole::Printf( "  draws                 %8d", counters.draws );
+	DevConsole::Printf( "  draw batches          %8d", counters.drawBatches );
+	DevConsole::Printf( "  program binds         %8d", counters.programBinds );
+	DevConsole::Printf( "  texture binds         %8d", counters.textureBinds );
+	DevConsole::Printf( "  buffer binds          %8d", counters.bufferBinds );
+	DevConsole::Printf( "  uniform table lookups %8d", counters.uniformTableLookups );
+	DevConsole::Printf( "  attrib name lookups   %8d", counters.attributeNameLookups );
+	DevConsole::Printf( "  uniform uploads       %8d", counters.uniformUploads );
+	DevConsole::Printf( "  uniform block uploads %8d", counters.uniformBlockUploads );
+	DevConsole::Printf( "  dynamic bytes         %8d", counters.dynamicBytes );
+	DevConsole::Printf( "  dynamic stalls        %8d", counters.dynamicStalls );
+}
@@ -12,6 +12,8 @@
 #include "Engine/Renderer/Texture.hpp"
 #include "Engine/Renderer/BitmapFont.hpp"
 #include "Engine/Renderer/ShaderProgram.hpp"
+#include "Engine/Renderer/UniformBuffer.hpp"
+#include "Engine/Renderer/DynamicBufferStream.hpp"
 #include "Engine/Renderer/Sampler.hpp"
 #include "Engine/Renderer/Camera.hpp"
 #include "Engine/Renderer/Sprites/Sprite.hpp"
@@ -113,6 +115,25 @@ public:
 	bool blend = false;
 };
 
+//----------------------------------------------------------------------------------------------------------------
+// GL work the renderer asked for in a frame. Published as profiler counters at EndFrame, render_stats prints the
+// last frame's. Uniforms are never looked up by name after a link, and attribute name lookups only happen the first
+// time a vertex layout is bound to a program, so they should drop to zero once everything in view has drawn once.
+struct RenderCounters_T {
+	int draws = 0;
+	int drawBatches = 0;				// Runs of draws that shared one state setup
+	int programBinds = 0;
+	int textureBinds = 0;
+	int bufferBinds = 0;				// Vertex and index buffers
+	int uniformTableLookups = 0;
+	int attributeNameLookups = 0;		// glGetAttribLocation
+	int uniformUploads = 0;
+	int uniformBlockUploads = 0;
+	int dynamicBytes = 0;				// Written to the dynamic vertex and index streams
+	int dynamicStalls = 0;				// Times a stream waited on the GPU for space
+};
+
+
 class Renderer {
 
 public:
@@ -130,10 +151,24 @@ public:
 	void Draw( DrawCall& drawCall );
 	void DrawRenderable( Renderable* renderable );
 	void DrawMesh( Mesh* mesh );
+	void BindMesh( Mesh* mesh );
+	void DrawBoundMesh();
+	void DrawBoundMeshInstances( const Matrix44* models, int instanceCount );
 	void DrawMeshImmediate( Vertex3D_PCU* verts, int numVerts, DrawPrimitive drawPrimitive );
 	void DrawMeshImmediate( Vertex3D_Lit* verts, int numVerts, unsigned int* indices, int numIndices, DrawPrimitive drawPrimitive );
 	void DrawMeshImmediate( MeshBuilder* builder );
 
+	//----------------------------------------------------------------------------------------------------------------
+	// Dynamic geometry, rebuilt every frame. Write count vertices (or indices) into outRange.data, UnmapDynamic the
+	// range, then point a Mesh at it with SetDynamicVertices / SetDynamicIndices and draw it any time this frame.
+	// Returns false when the stream can't fit it, draw from the mesh's own buffers instead.
+	template <typename VERTEX_TYPE>
+	bool MapDynamicVertices( unsigned int count, DynamicRange_T& outRange ) {
+		return m_dynamicVertices.Allocate( count * sizeof( VERTEX_TYPE ), sizeof( VERTEX_TYPE ), outRange );
+	}
+	bool MapDynamicIndices( unsigned int count, DynamicRange_T& outRange );
+	void UnmapDynamic( const DynamicRange_T& range );
+
 	//----------------------------------------------------------------------------------------------------------------
 	// Shape draw calls
 	void DrawRegularPolygon(const Vector2& center, float radius, float degreesToRotate, int sides, Rgba color = Rgba(255, 255, 255, 255));
@@ -253,6 +288,11 @@ public:
 	void SetUniform( const std::string& name, const float* param, unsigned int size = 1 ) const;
 	void SetUniform( const std::string& name, const Vector3* vec3, unsigned int size = 1 ) const;
 	void SetUniform( const std::string& name, const Vector4* vec4, unsigned int size = 1 ) const;
+	void SetUniform( UniformID id, const Rgba* color, unsigned int size = 1 ) const;
+	void SetUniform( UniformID id, const float* param, unsigned int size = 1 ) const;
+	void SetUniform( UniformID id, const Vector3* vec3, unsigned int size = 1 ) const;
+	void SetUniform( UniformID id, const Vector4* vec4, unsigned int size = 1 ) const;
+	void SetUniform( UniformID id, const Matrix44* matrices, unsigned int size = 1 ) const;
 
 	//----------------------------------------------------------------------------------------------------------------
 	// Lighting functions
@@ -272,7 +312,12 @@ public:
 	void SaveScreenshot();
 	Matrix44 GetClipToScreenSpace( Camera* worldCam );
 
+	const RenderCounters_T& GetLastFrameCounters() const;
+
 private:
+	void UseProgram( unsigned int programHandle );
+	void UpdateUniformBlocks();
+	void PublishCounters();
 	void LoadBuiltInShaders();
 	void LoadShaders();
 	void LoadMaterials();
@@ -297,6 +342,7 @@ private:
 	BitmapFont* m_defaultFont = nullptr;
 
 	unsigned int default_vao;
+	Mesh* m_boundMesh = nullptr;
 	//ShaderProgram* m_currentShaderProgram = nullptr;
 	//ShaderProgram* m_defaultShaderProgram = nullptr;
 	Shader* m_defaultShader = nullptr;
@@ -341,4 +387,21 @@ private:
 	float m_fogFactor = 1.f;
 	Rgba m_fogColor = Rgba(200, 200, 200, 255);
 
-};
\ No newline at end of file
+	// Per frame and per camera uniforms, shared by every program that declares the blocks
+	UniformBuffer m_frameUniforms;
+	UniformBuffer m_cameraUniforms;
+	unsigned int m_boundProgramHandle = 0;
+
+	// Ring buffered streams for geometry that changes every frame, fenced and recycled at EndFrame
+	DynamicBufferStream m_dynamicVertices;
+	DynamicBufferStream m_dynamicIndices;
+
+	mutable RenderCounters_T m_frameCounters;
+	RenderCounters_T m_lastFrameCounters;
+
+};
+
+
+//----------------------------------------------------------------------------------------------------------------
+void RenderStatsStartup();
+void RenderStatsCommand( const std::string& command );
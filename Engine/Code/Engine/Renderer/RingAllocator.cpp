@@ -0,0 +1,320 @@
+#include "Engine/Renderer/RingAllocator.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/DevConsole/DevConsole.hpp"
+#include "Engine/DevConsole/Command.hpp"
+
+#include <vector>
+
+
+//----------------------------------------------------------------------------------------------------------------
+static size_t AlignUp( size_t value, size_t alignment ) {
+	if ( alignment <= 1 ) {
+		return value;
+	}
+	return ( ( value + alignment - 1 ) / alignment ) * alignment;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+RingAllocator::RingAllocator( size_t capacity ) {
+	Reset( capacity );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void RingAllocator::Reset( size_t capacity ) {
+	m_capacity = capacity;
+	m_head = 0;
+	m_tail = 0;
+	m_usedBytes = 0;
+	m_openRegionBytes = 0;
+	m_pendingRegions.clear();
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// The free space is [head, capacity) + [0, tail) when head is ahead of tail, and [head, tail) once head has wrapped
+// behind it. head == tail is either empty or full, m_usedBytes tells which. Bytes skipped for alignment or at the
+// end of the buffer when wrapping are charged to the open region so they come back when it's released.
+bool RingAllocator::Allocate( size_t byteCount, size_t alignment, size_t& outOffset ) {
+	outOffset = RING_ALLOCATOR_INVALID_OFFSET;
+	if ( byteCount == 0 || byteCount > m_capacity ) {
+		return false;
+	}
+
+	if ( m_usedBytes == 0 ) {
+		m_head = 0;
+		m_tail = 0;
+	} else if ( m_head == m_tail ) {
+		return false;
+	}
+
+	size_t offset = AlignUp( m_head, alignment );
+	size_t newHead = 0;
+	if ( m_head >= m_tail ) {
+		if ( offset + byteCount <= m_capacity ) {
+			newHead = offset + byteCount;
+		} else if ( byteCount <= m_tail ) {
+			offset = 0;
+			newHead = byteCount;
+		} else {
+			return false;
+		}
+	} else {
+		if ( offset + byteCount > m_tail ) {
+			return false;
+		}
+		newHead = offset + byteCount;
+	}
+
+	size_t consumedBytes = ( newHead > m_head ) ? ( newHead - m_head ) : ( m_capacity - m_head + newHead );
+	m_usedBytes += consumedBytes;
+	m_openRegionBytes += consumedBytes;
+	m_head = newHead;
+	outOffset = offset;
+	return true;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+uint64_t RingAllocator::Fence() {
+	RingRegion_T region;
+	region.end = m_head;
+	region.byteCount = m_openRegionBytes;
+	region.fenceValue = m_nextFenceValue++;
+	m_pendingRegions.push_back( region );
+
+	m_openRegionBytes = 0;
+	return region.fenceValue;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void RingAllocator::Release( uint64_t completedFenceValue ) {
+	while ( !m_pendingRegions.empty() && m_pendingRegions.front().fenceValue <= completedFenceValue ) {
+		const RingRegion_T& region = m_pendingRegions.front();
+		m_tail = region.end;
+		m_usedBytes -= region.byteCount;
+		m_pendingRegions.pop_front();
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+bool RingAllocator::HasPendingRegions() const {
+	return !m_pendingRegions.empty();
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+uint64_t RingAllocator::GetOldestPendingFence() const {
+	return m_pendingRegions.empty() ? 0 : m_pendingRegions.front().fenceValue;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+bool RingAllocator::IsOpenRegionEmpty() const {
+	return m_openRegionBytes == 0;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+size_t RingAllocator::GetCapacity() const {
+	return m_capacity;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+size_t RingAllocator::GetUsedBytes() const {
+	return m_usedBytes;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+size_t RingAllocator::GetOpenRegionBytes() const {
+	return m_openRegionBytes;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void RingAllocatorStartup() {
+	CommandRegistration::RegisterCommand( "ring_test", RingTestCommand, "[frames] [latency] - Streams random allocations through a ring with simulated GPU fences" );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+struct RingTestRange_T {
+	size_t offset;
+	size_t byteCount;
+	uint64_t fenceValue;		// 0 while the frame that allocated it is still open
+};
+
+
+//----------------------------------------------------------------------------------------------------------------
+static bool DoRangesOverlap( size_t offsetA, size_t byteCountA, size_t offsetB, size_t byteCountB ) {
+	return ( offsetA < offsetB + byteCountB ) && ( offsetB < offsetA + byteCountA );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Simulated GPU: finishes everything fenced up to fenceValue, in the ring and in the list of ranges it might read
+static void RingTestRelease( RingAllocator& ring, std::vector<RingTestRange_T>& liveRanges, uint64_t fenceValue ) {
+	ring.Release( fenceValue );
+	size_t keptCount = 0;
+	for ( size_t rangeIndex = 0; rangeIndex < liveRanges.size(); rangeIndex++ ) {
+		if ( liveRanges[rangeIndex].fenceValue == 0 || liveRanges[rangeIndex].fenceValue > fenceValue ) {
+			liveRanges[keptCount++] = liveRanges[rangeIndex];
+		}
+	}
+	liveRanges.resize( keptCount );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+static double GetNanosecondsPer( uint64_t performanceCount, int count ) {
+	return ( PerformanceCountToSeconds( performanceCount ) * 1000000000.0 ) / (double) Max( count, 1 );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Headless: every frame makes a random number of vertex and index sized allocations, the way particles and
+// immediate draws do, and the GPU finishes a frame `latency` frames after it was fenced. Checks every allocation
+// against alignment, the buffer bounds, and every range the GPU could still be reading. Then times the same
+// sequence of sizes against new[] / delete[], which is what the dynamic meshes did before.
+void RingTestCommand( const std::string& command ) {
+	Command parsed( command );
+	int frameCount = 1000;
+	int latency = 2;
+	int argument = 0;
+	if ( parsed.PeekNextInt( argument ) && parsed.GetNextInt( argument ) && argument > 0 ) {
+		frameCount = argument;
+	}
+	if ( parsed.PeekNextInt( argument ) && parsed.GetNextInt( argument ) && argument >= 0 ) {
+		latency = argument;
+	}
+
+	const size_t capacity = 1024 * 1024;
+	const size_t strides[] = { 24, 48, 4, 36 };		// Vertex3D_PCU, Vertex3D_Lit, 32 bit indices, and an odd one
+	const int strideCount = (int) ( sizeof( strides ) / sizeof( strides[0] ) );
+
+	// Generate the sizes up front so the timed runs do the same work
+	std::vector<int> allocationsPerFrame( frameCount );
+	std::vector<size_t> byteCounts;
+	std::vector<size_t> alignments;
+	for ( int frameIndex = 0; frameIndex < frameCount; frameIndex++ ) {
+		allocationsPerFrame[frameIndex] = GetRandomIntInRange( 1, 48 );
+		for ( int allocationIndex = 0; allocationIndex < allocationsPerFrame[frameIndex]; allocationIndex++ ) {
+			size_t stride = strides[GetRandomIntLessThan( strideCount )];
+			byteCounts.push_back( stride * (size_t) GetRandomIntInRange( 1, 512 ) );
+			alignments.push_back( stride );
+		}
+	}
+	byteCounts.push_back( capacity + 1 );		// One that can never fit
+	alignments.push_back( 4 );
+	allocationsPerFrame.back()++;
+
+	// Correctness
+	RingAllocator ring( capacity );
+	std::vector<RingTestRange_T> liveRanges;
+	std::vector<uint64_t> frameFences;
+	int errors = 0;
+	int stalls = 0;
+	int refused = 0;
+	size_t peakUsedBytes = 0;
+	size_t totalBytes = 0;
+	size_t allocationCursor = 0;
+	for ( int frameIndex = 0; frameIndex < frameCount; frameIndex++ ) {
+		for ( int allocationIndex = 0; allocationIndex < allocationsPerFrame[frameIndex]; allocationIndex++, allocationCursor++ ) {
+			size_t byteCount = byteCounts[allocationCursor];
+			size_t alignment = alignments[allocationCursor];
+			size_t offset = 0;
+			bool isAllocated = ring.Allocate( byteCount, alignment, offset );
+			while ( !isAllocated && ring.HasPendingRegions() ) {
+				// What DynamicBufferStream does: wait for the oldest fence and try again. The open region can't be
+				// waited on, its ranges haven't been drawn yet.
+				RingTestRelease( ring, liveRanges, ring.GetOldestPendingFence() );
+				stalls++;
+				isAllocated = ring.Allocate( byteCount, alignment, offset );
+			}
+
+			if ( !isAllocated ) {
+				refused++;
+				continue;
+			}
+
+			if ( offset % alignment != 0 || offset + byteCount > capacity ) {
+				errors++;
+			}
+			for ( size_t rangeIndex = 0; rangeIndex < liveRanges.size(); rangeIndex++ ) {
+				if ( DoRangesOverlap( offset, byteCount, liveRanges[rangeIndex].offset, liveRanges[rangeIndex].byteCount ) ) {
+					errors++;
+				}
+			}
+			RingTestRange_T range = { offset, byteCount, 0 };
+			liveRanges.push_back( range );
+			totalBytes += byteCount;
+			peakUsedBytes = Max( peakUsedBytes, ring.GetUsedBytes() );
+			if ( ring.GetUsedBytes() > capacity ) {
+				errors++;
+			}
+		}
+
+		uint64_t fenceValue = ring.Fence();
+		for ( size_t rangeIndex = 0; rangeIndex < liveRanges.size(); rangeIndex++ ) {
+			if ( liveRanges[rangeIndex].fenceValue == 0 ) {
+				liveRanges[rangeIndex].fenceValue = fenceValue;
+			}
+		}
+		frameFences.push_back( fenceValue );
+		if ( (int) frameFences.size() > latency ) {
+			RingTestRelease( ring, liveRanges, frameFences[frameFences.size() - 1 - latency] );
+		}
+	}
+
+	RingTestRelease( ring, liveRanges, frameFences.back() );
+	if ( ring.GetUsedBytes() != 0 || ring.HasPendingRegions() || refused == 0 ) {
+		errors++;
+	}
+
+	// Timing, the ring with the GPU always keeping up, against the heap
+	int allocationCount = (int) byteCounts.size();
+	RingAllocator timedRing( capacity );
+	uint64_t ringStart = GetPerformanceCount();
+	allocationCursor = 0;
+	for ( int frameIndex = 0; frameIndex < frameCount; frameIndex++ ) {
+		for ( int allocationIndex = 0; allocationIndex < allocationsPerFrame[frameIndex]; allocationIndex++, allocationCursor++ ) {
+			size_t offset = 0;
+			if ( !timedRing.Allocate( byteCounts[allocationCursor], alignments[allocationCursor], offset ) && timedRing.HasPendingRegions() ) {
+				timedRing.Release( timedRing.GetOldestPendingFence() );
+				timedRing.Allocate( byteCounts[allocationCursor], alignments[allocationCursor], offset );
+			}
+		}
+		uint64_t fenceValue = timedRing.Fence();
+		if ( fenceValue > (uint64_t) latency ) {
+			timedRing.Release( fenceValue - (uint64_t) latency );
+		}
+	}
+	uint64_t ringTime = GetPerformanceCount() - ringStart;
+
+	std::vector<unsigned char*> frameAllocations;
+	uint64_t heapStart = GetPerformanceCount();
+	allocationCursor = 0;
+	for ( int frameIndex = 0; frameIndex < frameCount; frameIndex++ ) {
+		for ( int allocationIndex = 0; allocationIndex < allocationsPerFrame[frameIndex]; allocationIndex++, allocationCursor++ ) {
+			frameAllocations.push_back( new unsigned char[byteCounts[allocationCursor]] );
+		}
+		for ( size_t allocationIndex = 0; allocationIndex < frameAllocations.size(); allocationIndex++ ) {
+			delete[] frameAllocations[allocationIndex];
+		}
+		frameAllocations.clear();
+	}
+	uint64_t heapTime = GetPerformanceCount() - heapStart;
+
+	DevConsole::Printf( "ring_test: %d frames, %d allocations, %.1f MB through a %d KB ring, GPU %d frames behind", frameCount, allocationCount, (double) totalBytes / ( 1024.0 * 1024.0 ), (int) ( capacity / 1024 ), latency );
+	DevConsole::Printf( "  peak used           %d KB", (int) ( peakUsedBytes / 1024 ) );
+	DevConsole::Printf( "  stalls              %d", stalls );
+	DevConsole::Printf( "  refused             %d  (the frame alone filled the ring, at least 1 expected)", refused );
+	DevConsole::Printf( "  time                %.2f ns ring  %.2f ns new[]/delete[] per allocation", GetNanosecondsPer( ringTime, allocationCount ), GetNanosecondsPer( heapTime, allocationCount ) );
+	DevConsole::Printf( errors == 0 ? Rgba( 0, 255, 0, 255 ) : Rgba( 255, 0, 0, 255 ), "  %d errors", errors );
+}
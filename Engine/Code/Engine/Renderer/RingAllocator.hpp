@@ -0,0 +1,66 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <deque>
+#include <string>
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Hands out byte ranges of a fixed size buffer in order, wrapping back to the start when the end doesn't fit. The
+// ranges allocated between two calls to Fence form a region, and Fence returns the value the GPU side signals
+// once it's done reading that region. Nothing in a region is handed out again until Release is called with that
+// value or a later one, so the renderer can write into memory the GPU might still be drawing from last frame.
+//
+// Only offsets are tracked, never memory, which keeps this usable without a GL context. DynamicBufferStream puts
+// a mapped buffer and GL fences around it.
+#define RING_ALLOCATOR_INVALID_OFFSET ((size_t) -1)
+
+
+struct RingRegion_T {
+	size_t end;					// Head when the region was fenced, the tail moves here on release
+	size_t byteCount;			// Including the padding for alignment and wrapping
+	uint64_t fenceValue;
+};
+
+
+class RingAllocator {
+
+public:
+	explicit RingAllocator( size_t capacity = 0 );
+
+	// Drops every region, fenced or not
+	void Reset( size_t capacity );
+
+	// Any alignment works, not only powers of two, so vertex allocations can be aligned to their stride and drawn
+	// with offset / stride as the first vertex. Returns false when the ring is too full; the caller waits on the
+	// oldest fence, releases, and tries again.
+	bool Allocate( size_t byteCount, size_t alignment, size_t& outOffset );
+
+	// Closes the open region and returns its fence value. Values start at 1 and go up by one per call.
+	uint64_t Fence();
+
+	// Frees every region whose fence value is <= completedFenceValue
+	void Release( uint64_t completedFenceValue );
+
+	bool HasPendingRegions() const;
+	uint64_t GetOldestPendingFence() const;
+	bool IsOpenRegionEmpty() const;
+
+	size_t GetCapacity() const;
+	size_t GetUsedBytes() const;
+	size_t GetOpenRegionBytes() const;
+
+private:
+	size_t m_capacity = 0;
+	size_t m_head = 0;			// Next free byte
+	size_t m_tail = 0;			// Oldest byte still in use
+	size_t m_usedBytes = 0;
+	size_t m_openRegionBytes = 0;
+	uint64_t m_nextFenceValue = 1;
+	std::deque<RingRegion_T> m_pendingRegions;
+};
+
+
+//----------------------------------------------------------------------------------------------------------------
+void RingAllocatorStartup();
+void RingTestCommand( const std::string& command );
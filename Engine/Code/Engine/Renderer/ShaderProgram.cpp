@@ -1,11 +1,15 @@
 #include "Engine/Renderer/ShaderProgram.hpp"
 #include "Engine/Renderer/glbindings.h"
 #include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Renderer/UniformBuffer.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Vertex.hpp"
 #include <string>
 #include <fstream>
 #include <sstream>
+#include <vector>
 
 
 // static unsigned int LoadShader( char const *filename, GLenum type );
@@ -39,6 +43,7 @@ bool ShaderProgram::LoadFromFiles( const char* root ) {
 	// Link the program
 	// program_handle is a member GLuint. 
 	program_handle =  CreateAndLinkProgram( vert_shader, frag_shader ); 
+	Reflect();
 
 	glDeleteShader( vert_shader ); 
 	glDeleteShader( frag_shader ); 
@@ -59,6 +64,7 @@ bool ShaderProgram::LoadFromFiles( const char* vs, const char* fs ) {
 	// Link the program
 	// program_handle is a member GLuint. 
 	program_handle =  CreateAndLinkProgram( vert_shader, frag_shader ); 
+	Reflect();
 
 	glDeleteShader( vert_shader ); 
 	glDeleteShader( frag_shader ); 
@@ -111,6 +117,7 @@ bool ShaderProgram::LoadFromString(const char* vertShaderText, const char* fragS
 	// Link the program
 	// program_handle is a member GLuint. 
 	program_handle =  CreateAndLinkProgram( vertShaderID, fragShaderID ); 
+	Reflect();
 
 	glDeleteShader( vertShaderID ); 
 	glDeleteShader( fragShaderID ); 
@@ -238,4 +245,86 @@ void ShaderProgram::LogProgramError(GLuint program_id)
 
 unsigned int ShaderProgram::GetHandle() const {
 	return program_handle;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+const UniformTable& ShaderProgram::GetUniforms() const {
+	return m_uniforms;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+bool ShaderProgram::HasUniformBlock( unsigned int bindPoint ) const {
+	return ( m_uniformBlockMask & ( 1u << bindPoint ) ) != 0;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Block members come back from glGetActiveUniform too, with a location of -1, so they never make it into the table
+// and the renderer's plain uniform path skips them for free.
+void ShaderProgram::Reflect() {
+	m_uniforms.Clear();
+	m_uniformBlockMask = 0;
+	m_attributeLocations.clear();
+	if (program_handle == 0) {
+		return;
+	}
+
+	GLint uniformCount = 0;
+	GLint maxNameLength = 0;
+	glGetProgramiv(program_handle, GL_ACTIVE_UNIFORMS, &uniformCount);
+	glGetProgramiv(program_handle, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+	std::vector<GLchar> name(maxNameLength + 1);
+	for (GLint uniformIndex = 0; uniformIndex < uniformCount; uniformIndex++) {
+		GLsizei nameLength = 0;
+		GLint arraySize = 0;
+		GLenum type = 0;
+		glGetActiveUniform(program_handle, (GLuint) uniformIndex, (GLsizei) name.size(), &nameLength, &arraySize, &type, name.data());
+		name[nameLength] = '\0';
+
+		GLint location = glGetUniformLocation(program_handle, name.data());
+		if (location < 0) {
+			continue;
+		}
+		if (!m_uniforms.Add(name.data(), location, type, arraySize)) {
+			ERROR_RECOVERABLE(Stringf("Uniform %s has the same ID as %s", name.data(), m_uniforms.Find(MakeUniformID(name.data()))->name.c_str()));
+		}
+	}
+
+	BindUniformBlock("FrameBlock", UNIFORM_BLOCK_FRAME);
+	BindUniformBlock("CameraBlock", UNIFORM_BLOCK_CAMERA);
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+const std::vector<int>& ShaderProgram::GetAttributeLocations( const VertexLayout* layout, int* out_nameLookups ) const {
+	*out_nameLookups = 0;
+	for (size_t entryIndex = 0; entryIndex < m_attributeLocations.size(); entryIndex++) {
+		if (m_attributeLocations[entryIndex].layout == layout) {
+			return m_attributeLocations[entryIndex].locations;
+		}
+	}
+
+	AttributeLocations_T entry;
+	entry.layout = layout;
+	unsigned int attribCount = layout->GetAttributeCount();
+	for (unsigned int attribIndex = 0; attribIndex < attribCount; attribIndex++) {
+		entry.locations.push_back(glGetAttribLocation(program_handle, layout->GetAttribute(attribIndex).handle.c_str()));
+	}
+	*out_nameLookups = (int) attribCount;
+
+	m_attributeLocations.push_back(entry);
+	return m_attributeLocations.back().locations;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void ShaderProgram::BindUniformBlock( const char* blockName, unsigned int bindPoint ) {
+	GLuint blockIndex = glGetUniformBlockIndex(program_handle, blockName);
+	if (blockIndex != GL_INVALID_INDEX) {
+		glUniformBlockBinding(program_handle, blockIndex, bindPoint);
+		m_uniformBlockMask |= 1u << bindPoint;
+	}
 }
\ No newline at end of file
@@ -1,5 +1,12 @@
 #pragma once
 #include "Engine/Renderer/glbindings.h"
+#include "Engine/Renderer/UniformTable.hpp"
+
+#include <vector>
+
+
+class VertexLayout;
+
 
 class ShaderProgram {
 public:
@@ -12,11 +19,32 @@ public:
 
 	unsigned int GetHandle() const;
 
+	// Filled in after every successful link, so drawing never asks the driver for a location by name
+	int GetUniformLocation( UniformID id ) const { return m_uniforms.GetLocation( id ); }
+	const UniformTable& GetUniforms() const;
+	bool HasUniformBlock( unsigned int bindPoint ) const;
+
+	// One location per attribute of layout, -1 where the program doesn't use it. Asked for by name the first time a
+	// layout meets this program and cached after that; out_nameLookups gets how many glGetAttribLocation calls it took.
+	const std::vector<int>& GetAttributeLocations( const VertexLayout* layout, int* out_nameLookups ) const;
+
 private:
 	static unsigned int LoadShader( char const *filename, GLenum type );
 	static void LogShaderError(GLuint shader_id);
 	static void LogProgramError(GLuint program_id);
 	static GLuint CreateAndLinkProgram( GLint vs, GLint fs );
 
+	void Reflect();
+	void BindUniformBlock( const char* blockName, unsigned int bindPoint );
+
 	unsigned int program_handle = 0;
+	UniformTable m_uniforms;
+	unsigned int m_uniformBlockMask = 0;	// Bit per binding point the program has a block for
+
+	// Only a handful of vertex layouts exist, so a linear search beats a map
+	struct AttributeLocations_T {
+		const VertexLayout* layout;
+		std::vector<int> locations;
+	};
+	mutable std::vector<AttributeLocations_T> m_attributeLocations;
 };
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "Engine/Renderer/UniformBuffer.hpp"
+#include "Engine/Renderer/glbindings.h"
+
+#include <string.h>
+
+
+//----------------------------------------------------------------------------------------------------------------
+UniformBuffer::UniformBuffer() {
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+UniformBuffer::~UniformBuffer() {
+	if ( m_handle != 0 ) {
+		glDeleteBuffers( 1, &m_handle );
+		m_handle = 0;
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+bool UniformBuffer::SetData( const void* data, size_t byteCount ) {
+	if ( m_cpuData.size() == byteCount && memcmp( m_cpuData.data(), data, byteCount ) == 0 ) {
+		return false;
+	}
+
+	m_cpuData.resize( byteCount );
+	memcpy( m_cpuData.data(), data, byteCount );
+	m_isDirty = true;
+	return true;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// The binding point is only set on upload. Nothing else binds to the block binding points, so it sticks between.
+bool UniformBuffer::Flush( unsigned int bindPoint ) {
+	if ( !m_isDirty ) {
+		return false;
+	}
+
+	if ( m_handle == 0 ) {
+		glGenBuffers( 1, &m_handle );
+	}
+
+	glBindBuffer( GL_UNIFORM_BUFFER, m_handle );
+	if ( m_gpuSize == m_cpuData.size() ) {
+		glBufferSubData( GL_UNIFORM_BUFFER, 0, m_cpuData.size(), m_cpuData.data() );
+	} else {
+		glBufferData( GL_UNIFORM_BUFFER, m_cpuData.size(), m_cpuData.data(), GL_DYNAMIC_DRAW );
+		m_gpuSize = m_cpuData.size();
+	}
+	glBindBufferBase( GL_UNIFORM_BUFFER, bindPoint, m_handle );
+
+	m_isDirty = false;
+	return true;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+bool UniformBuffer::IsDirty() const {
+	return m_isDirty;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+size_t UniformBuffer::GetSize() const {
+	return m_cpuData.size();
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+unsigned int UniformBuffer::GetHandle() const {
+	return m_handle;
+}
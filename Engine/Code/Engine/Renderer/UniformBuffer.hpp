@@ -0,0 +1,83 @@
+#pragma once
+#include "Engine/Math/Matrix44.hpp"
+#include "Engine/Math/Vector3.hpp"
+
+#include <stddef.h>
+#include <vector>
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Binding points for the blocks every shader can declare. Shaders give the same numbers with layout(binding = N),
+// ShaderProgram also sets them after linking so programs built from strings without a layout qualifier work too.
+#define UNIFORM_BLOCK_FRAME		1
+#define UNIFORM_BLOCK_CAMERA	2
+
+
+// std140 layouts, these have to match the block declarations in the shaders member for member:
+//
+//		layout(std140, binding = 1) uniform FrameBlock {
+//			float TIME_IN_SECONDS;
+//			float MAX_FOG_DISTANCE;
+//			float FOG_FACTOR;
+//			vec4 FOG_COLOR;
+//		};
+//
+//		layout(std140, binding = 2) uniform CameraBlock {
+//			mat4 VIEW;
+//			mat4 PROJECTION;
+//			mat4 CAMERA;
+//			vec3 EYE_POSITION;
+//			vec3 EYE_DIRECTION;
+//		};
+struct FrameBlock_T {
+	float time;
+	float maxFogDistance;
+	float fogFactor;
+	float padding0;				// vec4 is 16 byte aligned
+	float fogColor[4];
+};
+
+
+struct CameraBlock_T {
+	Matrix44 view;
+	Matrix44 projection;
+	Matrix44 camera;
+	Vector3 eyePosition;
+	float padding0;				// vec3 is 16 byte aligned
+	Vector3 eyeDirection;
+	float padding1;
+};
+
+
+static_assert( sizeof( FrameBlock_T ) == 32, "FrameBlock_T no longer matches the std140 FrameBlock" );
+static_assert( sizeof( CameraBlock_T ) == 224, "CameraBlock_T no longer matches the std140 CameraBlock" );
+
+
+//----------------------------------------------------------------------------------------------------------------
+// A GL uniform buffer with a CPU copy. SetData only compares and copies; the upload happens in Flush, and only
+// when the contents changed since the last one, so setting the same camera for every draw costs a memcmp.
+class UniformBuffer {
+
+public:
+	UniformBuffer();
+	~UniformBuffer();
+
+	// Returns true if data differs from what was set last
+	bool SetData( const void* data, size_t byteCount );
+
+	template <typename T>
+	bool Set( const T& data ) { return SetData( &data, sizeof( T ) ); }
+
+	// Uploads if dirty and binds the buffer to bindPoint. Returns true when it uploaded.
+	bool Flush( unsigned int bindPoint );
+
+	bool IsDirty() const;
+	size_t GetSize() const;
+	unsigned int GetHandle() const;
+
+private:
+	std::vector<unsigned char> m_cpuData;
+	size_t m_gpuSize = 0;
+	unsigned int m_handle = 0;
+	bool m_isDirty = false;
+};
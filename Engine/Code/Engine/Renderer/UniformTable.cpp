@@ -0,0 +1,143 @@
+#include "Engine/Renderer/UniformTable.hpp"
+
+
+#define UNIFORM_TABLE_MIN_SLOTS 16
+
+
+//----------------------------------------------------------------------------------------------------------------
+// 64 bit FNV-1a. Zero is kept for UNIFORM_ID_INVALID.
+UniformID MakeUniformID( const char* name ) {
+	uint64_t hash = 14695981039346656037ull;
+	for ( const char* character = name; *character != '\0'; character++ ) {
+		hash ^= (uint8_t) *character;
+		hash *= 1099511628211ull;
+	}
+	return ( hash == UNIFORM_ID_INVALID ) ? 1 : hash;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+UniformID MakeUniformID( const std::string& name ) {
+	return MakeUniformID( name.c_str() );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// glGetActiveUniform reports arrays as "NAME[0]"
+static std::string GetBareUniformName( const char* name ) {
+	std::string bareName = name;
+	size_t bracket = bareName.find( '[' );
+	if ( bracket != std::string::npos ) {
+		bareName.erase( bracket );
+	}
+	return bareName;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+UniformTable::UniformTable() {
+	Rehash( UNIFORM_TABLE_MIN_SLOTS );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void UniformTable::Clear() {
+	m_uniforms.clear();
+	Rehash( UNIFORM_TABLE_MIN_SLOTS );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+bool UniformTable::Add( const char* name, int location, unsigned int glType, int arraySize ) {
+	std::string bareName = GetBareUniformName( name );
+	UniformID id = MakeUniformID( bareName );
+	int existingSlot = FindSlot( id );
+	if ( m_slots[existingSlot].uniformIndex >= 0 ) {
+		return m_uniforms[ m_slots[existingSlot].uniformIndex ].name == bareName;
+	}
+
+	if ( ( m_uniforms.size() + 1 ) * 2 > m_slots.size() ) {
+		Rehash( (int) m_slots.size() * 2 );
+	}
+
+	UniformInfo_T info;
+	info.id = id;
+	info.location = location;
+	info.glType = glType;
+	info.arraySize = arraySize;
+	info.name = bareName;
+	m_uniforms.push_back( info );
+
+	UniformSlot_T& slot = m_slots[ FindSlot( id ) ];
+	slot.id = id;
+	slot.location = location;
+	slot.uniformIndex = (int) m_uniforms.size() - 1;
+	return true;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int UniformTable::GetLocation( UniformID id ) const {
+	uint32_t slotIndex = (uint32_t) id & m_slotMask;
+	for ( ;; ) {
+		const UniformSlot_T& slot = m_slots[slotIndex];
+		if ( slot.uniformIndex < 0 ) {
+			return UNIFORM_LOCATION_NONE;
+		}
+		if ( slot.id == id ) {
+			return slot.location;
+		}
+		slotIndex = ( slotIndex + 1 ) & m_slotMask;
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+const UniformInfo_T* UniformTable::Find( UniformID id ) const {
+	int uniformIndex = m_slots[ FindSlot( id ) ].uniformIndex;
+	return ( uniformIndex >= 0 ) ? &m_uniforms[uniformIndex] : nullptr;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int UniformTable::GetUniformCount() const {
+	return (int) m_uniforms.size();
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+const UniformInfo_T& UniformTable::GetUniform( int index ) const {
+	return m_uniforms[index];
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// The slot holding id, or the empty slot it would go in
+int UniformTable::FindSlot( UniformID id ) const {
+	uint32_t slotIndex = (uint32_t) id & m_slotMask;
+	while ( m_slots[slotIndex].uniformIndex >= 0 && m_slots[slotIndex].id != id ) {
+		slotIndex = ( slotIndex + 1 ) & m_slotMask;
+	}
+	return (int) slotIndex;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// slotCount has to be a power of two
+void UniformTable::Rehash( int slotCount ) {
+	UniformSlot_T emptySlot;
+	emptySlot.id = UNIFORM_ID_INVALID;
+	emptySlot.location = UNIFORM_LOCATION_NONE;
+	emptySlot.uniformIndex = -1;
+
+	m_slots.assign( slotCount, emptySlot );
+	m_slotMask = (uint32_t) slotCount - 1;
+
+	for ( int uniformIndex = 0; uniformIndex < (int) m_uniforms.size(); uniformIndex++ ) {
+		UniformSlot_T& slot = m_slots[ FindSlot( m_uniforms[uniformIndex].id ) ];
+		slot.id = m_uniforms[uniformIndex].id;
+		slot.location = m_uniforms[uniformIndex].location;
+		slot.uniformIndex = uniformIndex;
+	}
+}
+
@@ -0,0 +1,70 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Uniforms are looked up by a 64 bit FNV-1a hash of their name instead of the name itself. The renderer hashes the
+// names it sets every draw once at startup, so a draw never hands a string to the driver; ShaderProgram fills a
+// table per program at link time with every active uniform and its location.
+//
+// The whole 64 bits are compared on lookup, so a uniform the program doesn't have can't land on another one's
+// location by sharing the low bits; two names in one program hashing the same are caught at link time by Add.
+//
+// Array uniforms are stored under their bare name ("LIGHT_COLOR", not "LIGHT_COLOR[0]") with the location of
+// element zero, which is what glUniform*v wants for the whole array.
+typedef uint64_t UniformID;
+
+#define UNIFORM_ID_INVALID 0
+#define UNIFORM_LOCATION_NONE -1
+
+
+UniformID MakeUniformID( const char* name );
+UniformID MakeUniformID( const std::string& name );
+
+
+struct UniformInfo_T {
+	UniformID id;
+	int location;
+	unsigned int glType;
+	int arraySize;
+	std::string name;
+};
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Open addressing with linear probing, kept at most half full. The slots hold the ID and location directly so a
+// lookup that hits only touches one cache line; the full UniformInfo_T is only needed for debugging.
+class UniformTable {
+
+public:
+	UniformTable();
+
+	void Clear();
+
+	// Returns false without adding anything if a different name already has the same ID
+	bool Add( const char* name, int location, unsigned int glType = 0, int arraySize = 1 );
+
+	// UNIFORM_LOCATION_NONE when the program doesn't use the uniform
+	int GetLocation( UniformID id ) const;
+	const UniformInfo_T* Find( UniformID id ) const;
+
+	int GetUniformCount() const;
+	const UniformInfo_T& GetUniform( int index ) const;
+
+private:
+	struct UniformSlot_T {
+		UniformID id;
+		int location;
+		int uniformIndex;			// Into m_uniforms, -1 when the slot is empty
+	};
+
+	int FindSlot( UniformID id ) const;
+	void Rehash( int slotCount );
+
+	std::vector<UniformInfo_T> m_uniforms;
+	std::vector<UniformSlot_T> m_slots;
+	uint32_t m_slotMask = 0;
+};
+
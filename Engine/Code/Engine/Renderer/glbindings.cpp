@@ -79,6 +79,20 @@ PFNGLDELETETEXTURESPROC				glDeleteTextures			= nullptr;
 PFNGLGENERATEMIPMAPPROC				glGenerateMipmap			= nullptr;
 PFNGLVIEWPORTPROC					glViewport					= nullptr;
 PFNGLSAMPLERPARAMETERFVPROC			glSamplerParameterfv		= nullptr;
+PFNGLGETACTIVEUNIFORMPROC			glGetActiveUniform					= nullptr;
+PFNGLGETUNIFORMBLOCKINDEXPROC		glGetUniformBlockIndex			= nullptr;
+PFNGLUNIFORMBLOCKBINDINGPROC		glUniformBlockBinding				= nullptr;
+PFNGLBINDBUFFERBASEPROC				glBindBufferBase						= nullptr;
+PFNGLBUFFERSUBDATAPROC				glBufferSubData						= nullptr;
+PFNGLFENCESYNCPROC					glFenceSync						= nullptr;
+PFNGLCLIENTWAITSYNCPROC				glClientWaitSync				= nullptr;
+PFNGLDELETESYNCPROC					glDeleteSync					= nullptr;
+PFNGLBUFFERSTORAGEPROC				glBufferStorage					= nullptr;
+PFNGLMAPBUFFERRANGEPROC				glMapBufferRange				= nullptr;
+PFNGLUNMAPBUFFERPROC				glUnmapBuffer					= nullptr;
+PFNGLDRAWELEMENTSBASEVERTEXPROC		glDrawElementsBaseVertex		= nullptr;
+PFNGLGETINTEGERVPROC				glGetIntegerv					= nullptr;
+PFNGLGETSTRINGIPROC					glGetStringi					= nullptr;
 
 
 void BindGLFunctions() {
@@ -161,4 +175,18 @@ void BindGLFunctions() {
 	GL_BIND_FUNCTION( glGenerateMipmap );
 	GL_BIND_FUNCTION( glViewport );
 	GL_BIND_FUNCTION( glSamplerParameterfv );
+	GL_BIND_FUNCTION( glGetActiveUniform );
+	GL_BIND_FUNCTION( glGetUniformBlockIndex );
+	GL_BIND_FUNCTION( glUniformBlockBinding );
+	GL_BIND_FUNCTION( glBindBufferBase );
+	GL_BIND_FUNCTION( glBufferSubData );
+	GL_BIND_FUNCTION( glFenceSync );
+	GL_BIND_FUNCTION( glClientWaitSync );
+	GL_BIND_FUNCTION( glDeleteSync );
+	GL_BIND_FUNCTION( glBufferStorage );
+	GL_BIND_FUNCTION( glMapBufferRange );
+	GL_BIND_FUNCTION( glUnmapBuffer );
+	GL_BIND_FUNCTION( glDrawElementsBaseVertex );
+	GL_BIND_FUNCTION( glGetIntegerv );
+	GL_BIND_FUNCTION( glGetStringi );
 }
\ No newline at end of file
@@ -103,6 +103,20 @@ extern PFNGLDELETETEXTURESPROC				glDeleteTextures;
 extern PFNGLGENERATEMIPMAPPROC				glGenerateMipmap;
 extern PFNGLVIEWPORTPROC					glViewport;
 extern PFNGLSAMPLERPARAMETERFVPROC			glSamplerParameterfv;
+extern PFNGLGETACTIVEUNIFORMPROC			glGetActiveUniform;
+extern PFNGLGETUNIFORMBLOCKINDEXPROC		glGetUniformBlockIndex;
+extern PFNGLUNIFORMBLOCKBINDINGPROC			glUniformBlockBinding;
+extern PFNGLBINDBUFFERBASEPROC				glBindBufferBase;
+extern PFNGLBUFFERSUBDATAPROC				glBufferSubData;
+extern PFNGLFENCESYNCPROC					glFenceSync;
+extern PFNGLCLIENTWAITSYNCPROC				glClientWaitSync;
+extern PFNGLDELETESYNCPROC					glDeleteSync;
+extern PFNGLBUFFERSTORAGEPROC				glBufferStorage;
+extern PFNGLMAPBUFFERRANGEPROC				glMapBufferRange;
+extern PFNGLUNMAPBUFFERPROC					glUnmapBuffer;
+extern PFNGLDRAWELEMENTSBASEVERTEXPROC		glDrawElementsBaseVertex;
+extern PFNGLGETINTEGERVPROC					glGetIntegerv;
+extern PFNGLGETSTRINGIPROC					glGetStringi;
 
 
 void BindGLFunctions();
@@ -67,6 +67,7 @@ void App::Run() {
 		g_theRenderer->EndFrame();
 
 	}
+	Profiler::Shutdown();
 	DebugRenderShutdown();
 	void (*fncptr)( unsigned int msg, size_t wparam, size_t lparam ) = GetMessages;
 	Profiler::MarkFrame();
@@ -1,8 +1,14 @@
 #version 420 core
 
 uniform mat4 MODEL;
-uniform mat4 VIEW;
-uniform mat4 PROJECTION;
+
+layout(std140, binding = 2) uniform CameraBlock {
+	mat4 VIEW;
+	mat4 PROJECTION;
+	mat4 CAMERA;
+	vec3 EYE_POSITION;
+	vec3 EYE_DIRECTION;
+};
 
 in vec3 POSITION;
 in vec4 COLOR;
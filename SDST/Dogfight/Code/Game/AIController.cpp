@@ -35,11 +35,12 @@ void AIController::DoHomingBehavior() {
 
 	Entity* target = TheGame::GetMultiplayerState()->GetEntityByID( entity->currentState.lockedEntityID );
 
-	Vector3 targetForward = target->currentState.transform.GetWorldForward();
-	Vector3 myForward = entity->currentState.transform.GetWorldForward();
-	Vector3 myUp = entity->currentState.transform.GetWorldUp();
-	Vector3 myRight = entity->currentState.transform.GetWorldRight();
-	Vector3 directionToTarget = target->currentState.transform.position - entity->currentState.transform.position;
+	TransformWorld_T myWorld = entity->currentState.GetTransform().ComputeWorld();
+	Vector3 targetForward = target->GetForward();
+	Vector3 myForward = myWorld.forward;
+	Vector3 myUp = myWorld.up;
+	Vector3 myRight = myWorld.right;
+	Vector3 directionToTarget = target->currentState.position - entity->currentState.position;
 	directionToTarget.Normalize();
 
 	float dotRightDisplacement = DotProduct( myRight, directionToTarget );
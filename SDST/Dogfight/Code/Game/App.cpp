@@ -16,6 +16,11 @@
 #include "Engine/Core/BytePacker.hpp"
 #include "Engine/Net/Net.hpp"
 #include "Engine/Async/JobSystem.hpp"
+#include "Engine/Math/MatrixKernels.hpp"
+#include "Engine/Renderer/DrawQueue.hpp"
+#include "Engine/Renderer/LightClusterGrid.hpp"
+#include "Engine/Math/AABBTree.hpp"
+#include "Engine/Renderer/RingAllocator.hpp"
 
 
 
@@ -85,6 +90,7 @@ void App::Run() {
 
 		g_masterClock->BeginFrame();
 		Profiler::MarkFrame();
+		g_theJobSystem->ProcessFinishedJobs();
 		g_theRenderer->BeginFrame();
 		g_theInputSystem->BeginFrame();
 		g_audioSystem->BeginFrame();
@@ -102,6 +108,7 @@ void App::Run() {
 
 	}
 
+	Profiler::Shutdown();
 	g_theJobSystem->Shutdown();
 	CommandRegistration::SaveCommandHistory();
 	DebugRenderShutdown();
@@ -131,6 +138,12 @@ void App::Initialize() {
 	g_theGame->Initialize();
 
 	DebugRenderStartup(g_theRenderer);
+	MatrixKernelsStartup();
+	DrawQueueStartup();
+	LightClusterGridStartup();
+	AABBTreeStartup();
+	RingAllocatorStartup();
+	RenderStatsStartup();
 	RegisterDebugTimeCommands();
 
 	void (*fncptr)( unsigned int msg, size_t wparam, size_t lparam ) = GetMessages;
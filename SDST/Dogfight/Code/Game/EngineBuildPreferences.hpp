@@ -9,6 +9,7 @@
 //
 
 //#define ENGINE_DISABLE_AUDIO	// (If uncommented) Disables AudioSystem code and fmod linkage.
+//#define ENGINE_DISABLE_SIMD	// (If uncommented) Uses the scalar Matrix44 and frustum culling kernels instead of SSE/AVX.
 
 // Choose a basis for the engine.
 // EXACTLY ONE SHOULD BE UNCOMMENTED.
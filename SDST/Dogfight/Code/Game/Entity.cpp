@@ -25,7 +25,7 @@ Entity::Entity( const EntityDefinition& def ) : def( def ) {
 	m_machineGunTimer->SetTimer( 0.1f );
 	currentState.health = def.GetMaxHealth();
 
-	currentState.transform.position = Vector3( 0.f, 5000.f, 0.f );
+	currentState.position = Vector3( 0.f, 5000.f, 0.f );
 }
 
 
@@ -72,7 +72,7 @@ Renderable* Entity::CreatePlaneRenderable() {
 
 	contrails = new ParticleEmitter();
 	contrails->renderable->SetMaterial( g_theRenderer->GetMaterial("contrail") );
-	contrails->transform.parent = &currentState.transform;
+	contrails->transform.parent = &transform;
 	contrails->transform.position = Vector3( 0.f, -1.f, -15.f );
 
 	contrails->SetLifetime(20.f, 20.f);
@@ -138,17 +138,17 @@ void Entity::Update() {
 		}
 	}
 	
-	renderable->SetModelMatrix( currentState.transform.GetLocalToWorldMatrix() );
-
-	if ( g_theGame->netSession->AmIHost() && g_theGame->GetMultiplayerState()->IsPointBelowTerrain( currentState.transform.position ) ) {
-		Kill(-1);
-	}
+	transform.position = currentState.position;
+	transform.euler = currentState.euler;
+	transform.UpdateWorld();
+	TransformWorld_T world = transform.ComputeWorld();
+	renderable->SetModelMatrix( world.localToWorld );
 
 	if ( followCamera != nullptr ) {
-		Vector3 forward = currentState.transform.GetWorldForward();
-		Vector3 up = currentState.transform.GetWorldUp();
-		followCamera->transform.position = currentState.transform.position - (forward * 30.f) + (up * 5.f);
-		followCamera->transform.euler = currentState.transform.euler;
+		Vector3 forward = world.forward;
+		Vector3 up = world.up;
+		followCamera->transform.position = currentState.position - (forward * 30.f) + (up * 5.f);
+		followCamera->transform.euler = currentState.euler;
 		followCamera->transform.Rotate( Vector3( controller->cameraPitchAxis * 60.f, controller->cameraYawAxis * 60.f, 0.f ) );
 	}
 
@@ -156,7 +156,7 @@ void Entity::Update() {
 		contrails->Update( contrails );
 	}
 
-	currentState.age += g_theGame->GetDeltaTime();
+	m_age += g_theGame->GetDeltaTime();
 
 	// If I'm a client and this entity is controlled by me
 	if ( !g_theGame->netSession->AmIHost() && g_theGame->netSession->GetMyConnectionIndex() == controller->connectionID ) {
@@ -164,8 +164,8 @@ void Entity::Update() {
 	}
 
 	if ( !g_theGame->netSession->AmIHost() && g_theGame->GetMultiplayerState()->m_debugDraw ) {	
-		DebugRenderWireSphere( 0.f, currentState.transform.position, def.GetPhysicalRadius(), Rgba(0, 255, 0, 255), Rgba(0, 255, 0, 255) );
-		DebugRenderWireSphere( 0.f, m_lastReceivedSnapshot.transform.position, def.GetPhysicalRadius(), Rgba(255, 0, 0, 255), Rgba(255, 0, 0, 255) );
+		DebugRenderWireSphere( 0.f, currentState.position, def.GetPhysicalRadius(), Rgba(0, 255, 0, 255), Rgba(0, 255, 0, 255) );
+		DebugRenderWireSphere( 0.f, m_lastReceivedSnapshot.position, def.GetPhysicalRadius(), Rgba(255, 0, 0, 255), Rgba(255, 0, 0, 255) );
 	}
 
 }
@@ -179,8 +179,11 @@ void Entity::SimulateFlightPhysicsOnSnapshot( float deltaTime, EntitySnapshot_T*
 
 	// We will need our percentage of max velocity to figure out our drag force and limits on rotations
 	// We also need to know how aligned our plane is with the direction it is moving.
+	// The world basis is built once per orientation change below rather than on every read
 	float percentOfMaxVelocity = speed / def.GetMaxVelocity();
-	float forwardVelocityDot = fabsf( DotProduct( ss->transform.GetWorldForward().GetNormalized(), velocityDirection ) );
+	Transform planeTransform = ss->GetTransform();
+	TransformWorld_T world = planeTransform.ComputeWorld();
+	float forwardVelocityDot = fabsf( DotProduct( world.forward.GetNormalized(), velocityDirection ) );
 
 	// We will handle rotating the plane next
 	ss->angularVelocity.x += ss->pitchAxis * 75.f * dt * ClampFloat( 1.f - percentOfMaxVelocity, 0.25f, 1.f);
@@ -193,46 +196,51 @@ void Entity::SimulateFlightPhysicsOnSnapshot( float deltaTime, EntitySnapshot_T*
 	ss->angularVelocity.z *= 1.f - (def.GetRollDrag() * dt);
 
 	// Perform plane rotations first
-	ss->transform.Rotate( ss->angularVelocity * dt );
+	planeTransform.Rotate( ss->angularVelocity * dt, world.localToWorld );
+	world = planeTransform.ComputeWorld();
 
-	float angleOfAttack = 90.f - AcosDegrees( DotProduct( ss->transform.GetWorldForward(), Vector3::UP ) );
-	float angleOfRoll = fabsf( 90.f - AcosDegrees( DotProduct( ss->transform.GetWorldRight(), Vector3::UP ) ) );
+	float angleOfAttack = 90.f - AcosDegrees( DotProduct( world.forward, Vector3::UP ) );
+	float angleOfRoll = fabsf( 90.f - AcosDegrees( DotProduct( world.right, Vector3::UP ) ) );
 
 
 	// Rotate the plane down a bit if looking up
-	Vector3 forwardOnHorizontal = Vector3::CrossProduct( ss->transform.GetWorldRight(), Vector3::UP ).GetNormalized();
+	Vector3 forwardOnHorizontal = Vector3::CrossProduct( world.right, Vector3::UP ).GetNormalized();
 	if ( forwardOnHorizontal.GetLengthSquared() != 1.f ) {
-		forwardOnHorizontal = ss->transform.GetWorldForward(); // Check for gimbal lock
+		forwardOnHorizontal = world.forward; // Check for gimbal lock
 	}
 
 	Vector3 rightOnHorizontal = Vector3::CrossProduct( Vector3::UP, forwardOnHorizontal ).GetNormalized();
 	if ( rightOnHorizontal.GetLengthSquared() != 1.f ) {
-		rightOnHorizontal = ss->transform.GetWorldRight(); // Check for gimbal lock
+		rightOnHorizontal = world.right; // Check for gimbal lock
 	}
 
 	Matrix44 targetOrientation( rightOnHorizontal, Vector3::UP, forwardOnHorizontal );
-	ss->transform.TurnToward( ss->transform.GetLocalToWorldMatrix(), targetOrientation, ClampFloatZeroToOne(angleOfAttack) * 0.1f * g_theGame->GetDeltaTime() );
+	planeTransform.TurnToward( world.localToWorld, targetOrientation, ClampFloatZeroToOne(angleOfAttack) * 0.1f * g_theGame->GetDeltaTime() );
+	world = planeTransform.ComputeWorld();
 
 	// Force the plane to rotate nose down if we reach stalling speed or are above the max altitude
-	if ( ss->velocity.GetLength() < def.GetStallSpeed() || ss->transform.position.y > MAX_ALTITUDE ) {
+	if ( ss->velocity.GetLength() < def.GetStallSpeed() || ss->position.y > MAX_ALTITUDE ) {
 		Matrix44 stallOrientation( rightOnHorizontal, forwardOnHorizontal, Vector3::UP * -1.f );
-		float dotForwardWithStallOrientation = DotProduct( Vector3::UP * -1.f, ss->transform.GetWorldForward() );
+		float dotForwardWithStallOrientation = DotProduct( Vector3::UP * -1.f, world.forward );
 
 		// Don't force stall if we're close to pointing down - this causes jittering and some disorienting flipping due to
 		// using eulers to represent rotation. 
 		if ( dotForwardWithStallOrientation < 0.95f ) {
-			ss->transform.TurnToward( ss->transform.GetLocalToWorldMatrix(), stallOrientation, 80.f * g_theGame->GetDeltaTime() );
+			planeTransform.TurnToward( world.localToWorld, stallOrientation, 80.f * g_theGame->GetDeltaTime() );
+			world = planeTransform.ComputeWorld();
 		}
 	}
 
 	// we also want to make the plane pitch up locally a bit when rolling
 	float rollPitchFactor = RangeMapFloat( angleOfRoll, 0.f, 90.f, 0.f, 1.f );
-	ss->transform.Rotate( Vector3( rollPitchFactor * dt * 10.f, 0.f, 0.f ) );
+	planeTransform.Rotate( Vector3( rollPitchFactor * dt * 10.f, 0.f, 0.f ), world.localToWorld );
+	world = planeTransform.ComputeWorld();
+	ss->euler = planeTransform.euler;
 
 	// Save off plane orientation now that we've finished rotations and update our angle of attack and roll
-	Vector3 planeForward = ss->transform.GetWorldForward();
-	Vector3 planeUp = ss->transform.GetWorldUp();
-	Vector3 planeRight = ss->transform.GetWorldRight();
+	Vector3 planeForward = world.forward;
+	Vector3 planeUp = world.up;
+	Vector3 planeRight = world.right;
 
 	angleOfAttack = 90.f - AcosDegrees( DotProduct( planeForward, Vector3::UP ) );
 	angleOfRoll = fabsf( 90.f - AcosDegrees( DotProduct( planeRight, Vector3::UP ) ) );
@@ -292,13 +300,13 @@ void Entity::SimulateFlightPhysicsOnSnapshot( float deltaTime, EntitySnapshot_T*
 		ss->velocity = ss->velocity.GetNormalized() * def.GetMaxVelocity();
 	}
 
-	ss->transform.position += ss->velocity * dt;
+	ss->position += ss->velocity * dt;
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
 void Entity::SimulateDumbPhysicsOnSnapshot( float deltaTime, EntitySnapshot_T* ss ) {
-	ss->transform.position += ss->velocity * deltaTime;
+	ss->position += ss->velocity * deltaTime;
 }
 
 
@@ -336,7 +344,7 @@ void Entity::UpdateLastReceivedSnapshot( EntitySnapshot_T* ss, float snapshotAge
 //----------------------------------------------------------------------------------------------------------------
 void Entity::NudgeClientTowardsHostSnapshot() {
 
-	Vector3 displacementBetweenCurrentAndHost = currentState.transform.position - m_lastReceivedSnapshot.transform.position;
+	Vector3 displacementBetweenCurrentAndHost = currentState.position - m_lastReceivedSnapshot.position;
 	if ( displacementBetweenCurrentAndHost.GetLengthSquared() > NET_SNAPPING_THRESHOLD ) {
 		currentState = m_lastReceivedSnapshot;
 	}
@@ -344,12 +352,12 @@ void Entity::NudgeClientTowardsHostSnapshot() {
 	else {
 		float nudgeFactor = CLIENT_NUDGE_FACTOR_PER_SECOND * g_theGame->GetDeltaTime();
 
-		Matrix44 currentRotation = Matrix44::MakeRotationDegrees( currentState.transform.euler );
-		Matrix44 hostEstimatedRotation = Matrix44::MakeRotationDegrees( m_lastReceivedSnapshot.transform.euler );
+		Matrix44 currentRotation = Matrix44::MakeRotationDegrees( currentState.euler );
+		Matrix44 hostEstimatedRotation = Matrix44::MakeRotationDegrees( m_lastReceivedSnapshot.euler );
 		Matrix44 newClientRotation = InterpolateRotation( currentRotation, hostEstimatedRotation, nudgeFactor );
-		currentState.transform.euler = newClientRotation.GetRotation();
+		currentState.euler = newClientRotation.GetRotation();
 
-		currentState.transform.position = Interpolate( currentState.transform.position, m_lastReceivedSnapshot.transform.position, nudgeFactor );
+		currentState.position = Interpolate( currentState.position, m_lastReceivedSnapshot.position, nudgeFactor );
 		currentState.velocity = Interpolate( currentState.velocity, m_lastReceivedSnapshot.velocity, nudgeFactor );
 		currentState.angularVelocity = Interpolate( currentState.angularVelocity, m_lastReceivedSnapshot.angularVelocity, nudgeFactor );
 	}
@@ -401,15 +409,15 @@ void Entity::Spawn() {
 //----------------------------------------------------------------------------------------------------------------
 void Entity::FireMissile() {
 
-	Vector3 missileSpawnPos = currentState.transform.position + (currentState.transform.GetWorldUp() * -3.f);
-	Vector3 missileSpawnOrientation = currentState.transform.euler;
+	Vector3 missileSpawnPos = currentState.position + (currentState.GetTransform().GetWorldUp() * -3.f);
+	Vector3 missileSpawnOrientation = currentState.euler;
 	Vector3 missileSpawnVel = currentState.velocity;
 
 	Entity* missile = TheGame::GetMultiplayerStateAsHost()->CreateEntity( 10, new MissileController(), controller->connectionID );
 	missile->LockOntoEntity( currentState.lockedEntityID );
 	missile->Spawn();
-	missile->currentState.transform.position = missileSpawnPos;
-	missile->currentState.transform.euler = missileSpawnOrientation;
+	missile->currentState.position = missileSpawnPos;
+	missile->currentState.euler = missileSpawnOrientation;
 	missile->currentState.velocity = missileSpawnVel;
 }
 
@@ -420,9 +428,10 @@ void Entity::FireMachineGun() {
 	Entity* missile = TheGame::GetMultiplayerStateAsHost()->CreateEntity( 20, new EntityController(), controller->connectionID );
 	missile->LockOntoEntity( currentState.lockedEntityID );
 	missile->Spawn();
-	missile->currentState.transform.position = currentState.transform.position + (currentState.transform.GetWorldForward() * 20.f);
-	missile->currentState.transform.euler = currentState.transform.euler;
-	missile->currentState.velocity = currentState.velocity + (currentState.transform.GetWorldForward() * 400.f);
+	Vector3 forward = currentState.GetTransform().GetWorldForward();
+	missile->currentState.position = currentState.position + (forward * 20.f);
+	missile->currentState.euler = currentState.euler;
+	missile->currentState.velocity = currentState.velocity + (forward * 400.f);
 
  	if ( followCamera != nullptr ) {
  		FirstPersonCamera* cam = dynamic_cast<FirstPersonCamera*>( followCamera );
@@ -477,13 +486,19 @@ void Entity::Heal(float healAmount) {
 
 //----------------------------------------------------------------------------------------------------------------
 float Entity::GetAge() const {
-	return currentState.age;
+	return m_age;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void Entity::SetAge( float age ) {
+	m_age = age;
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
 Vector3 Entity::GetPosition() {
-	return currentState.transform.position;
+	return currentState.position;
 }
 
 
@@ -495,7 +510,7 @@ Vector3 Entity::GetVelocity() {
 
 //----------------------------------------------------------------------------------------------------------------
 Vector3 Entity::GetForward() {
-	return currentState.transform.GetWorldForward();
+	return currentState.GetTransform().GetWorldForward();
 }
 
 
@@ -581,93 +596,99 @@ void UpdateContrailEmitter( ParticleEmitter* pe ) {
 
 
 //----------------------------------------------------------------------------------------------------------------
+// One ribbon quad between two trail particles, faded from the older one's color to the newer one's. out can be
+// mapped memory, so only write to it.
+static void WriteContrailQuad( Vertex3D_PCU* out, const Vector3& bl, const Vector3& br, const Vector3& tr, const Vector3& tl, const Rgba& secondColor, const Rgba& firstColor ) {
+	out[0] = Vertex3D_PCU( bl, Vector2( 0.f, 0.f ), secondColor );
+	out[1] = Vertex3D_PCU( br, Vector2( 1.f, 0.f ), firstColor );
+	out[2] = Vertex3D_PCU( tr, Vector2( 1.f, 1.f ), firstColor );
+	out[3] = Vertex3D_PCU( bl, Vector2( 0.f, 0.f ), secondColor );
+	out[4] = Vertex3D_PCU( tr, Vector2( 1.f, 1.f ), firstColor );
+	out[5] = Vertex3D_PCU( tl, Vector2( 0.f, 1.f ), secondColor );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Two crossed ribbons per pair of particles, written straight into the renderer's dynamic vertex stream. The
+// emitter keeps its Mesh and only points it at this frame's range.
 void PreRenderContrailEmitter( ParticleEmitter* pe, Camera* camera ) {
-	if (pe->mesh != nullptr) {
-		delete pe->mesh;
-	}
-	pe->mesh = new Mesh();
-	MeshBuilder builder;
-	builder.Begin(TRIANGLES, false);
-
-	if ( pe->particles.size() > 1 ) {
-
-		for ( int i = pe->particles.size() - 1; i > 0; i-- ) {
-			Particle* first = &(pe->particles[i]);
-			Particle* second = &(pe->particles[i-1]);
-
-			Vector3 particleDisplacement = first->position - second->position;
-			Vector3 quadForward = particleDisplacement.GetNormalized();
-			Vector3 quadRight = Vector3::CrossProduct( quadForward, Vector3::UP );
-			Vector3 quadUp = Vector3::CrossProduct( quadForward, Vector3::RIGHT );
-			quadRight.Normalize();
-			quadUp.Normalize();
-
-			float firstAge = first->GetNormalizedAge( pe->clock->total.seconds );
-			float secondAge = second->GetNormalizedAge( pe->clock->total.seconds );
-			int indexCount = pe->particles.size() - 1 - i;
-			unsigned char currentAlpha = ClampInt( indexCount * 32, 0, 255 );
-			Rgba firstStartColor = pe->startColor;
-			firstStartColor.a = currentAlpha;
-			Rgba firstColor = Interpolate( firstStartColor, pe->endColor, firstAge );
-			
-			currentAlpha = ClampInt( (indexCount + 1) * 32, 0, 255 );
-			Rgba secondStartColor = pe->startColor;
-			secondStartColor.a = currentAlpha;
-			Rgba secondColor = Interpolate( secondStartColor, pe->endColor, secondAge );
-
-			float firstSize = RangeMapFloat(firstAge, 0.f, pe->particleLifespan.max, 1.f, 50.f);
-			float secondSize = RangeMapFloat(secondAge, 0.f, pe->particleLifespan.max, 1.f, 50.f);
-
-			Vector3 bl = second->position + (quadUp * -1.f * secondSize);
-			Vector3 br = first->position + (quadUp * -1.f * firstSize);
-			Vector3 tr = first->position + (quadUp * firstSize);
-			Vector3 tl = second->position + (quadUp * secondSize);
-			
-			builder.SetColor( secondColor );
-			builder.SetUV(Vector2(0.f, 0.f));
-			builder.PushVertex(bl);
-			builder.SetColor( firstColor );
-			builder.SetUV(Vector2(1.f, 0.f));
-			builder.PushVertex(br);
-			builder.SetUV(Vector2(1.f, 1.f));
-			builder.PushVertex(tr);
-			builder.SetColor( secondColor );
-			builder.SetUV(Vector2(0.f, 0.f));
-			builder.PushVertex(bl);
-			builder.SetColor( firstColor );
-			builder.SetUV(Vector2(1.f, 1.f));
-			builder.PushVertex(tr);
-			builder.SetColor( secondColor );
-			builder.SetUV(Vector2(0.f, 1.f));
-			builder.PushVertex(tl);
-
-			bl = second->position + (quadRight * -1.f * secondSize);
-			tl = second->position + (quadRight * secondSize);
-			tr = first->position + (quadRight * firstSize);
-			br = first->position + (quadRight * -1.f * firstSize);
-			
-			builder.SetColor( secondColor );
-			builder.SetUV(Vector2(0.f, 0.f));
-			builder.PushVertex(bl);
-			builder.SetColor( firstColor );
-			builder.SetUV(Vector2(1.f, 0.f));
-			builder.PushVertex(br);
-			builder.SetUV(Vector2(1.f, 1.f));
-			builder.PushVertex(tr);
-			builder.SetColor( secondColor );
-			builder.SetUV(Vector2(0.f, 0.f));
-			builder.PushVertex(bl);
-			builder.SetColor( firstColor );
-			builder.SetUV(Vector2(1.f, 1.f));
-			builder.PushVertex(tr);
-			builder.SetColor( secondColor );
-			builder.SetUV(Vector2(0.f, 1.f));
-			builder.PushVertex(tl);
-		}
+	if ( pe->mesh == nullptr ) {
+		pe->mesh = new Mesh();
+	}
+
+	unsigned int segmentCount = ( pe->particles.size() > 1 ) ? (unsigned int) pe->particles.size() - 1 : 0;
+	unsigned int vertexCount = segmentCount * 12;
+	DynamicRange_T range;
+	std::vector<Vertex3D_PCU> fallbackVertices;
+	Vertex3D_PCU* vertices = nullptr;
+	bool isDynamic = ( vertexCount > 0 ) && g_theRenderer->MapDynamicVertices<Vertex3D_PCU>( vertexCount, range );
+	if ( isDynamic ) {
+		vertices = (Vertex3D_PCU*) range.data;
+	} else {
+		fallbackVertices.resize( vertexCount );
+		vertices = fallbackVertices.data();
+	}
+
+	AABB3 bounds;
+	Vertex3D_PCU* out = vertices;
+	for ( int i = (int) pe->particles.size() - 1; i > 0; i-- ) {
+		Particle* first = &(pe->particles[i]);
+		Particle* second = &(pe->particles[i-1]);
+
+		Vector3 particleDisplacement = first->position - second->position;
+		Vector3 quadForward = particleDisplacement.GetNormalized();
+		Vector3 quadRight = Vector3::CrossProduct( quadForward, Vector3::UP );
+		Vector3 quadUp = Vector3::CrossProduct( quadForward, Vector3::RIGHT );
+		quadRight.Normalize();
+		quadUp.Normalize();
+
+		float firstAge = first->GetNormalizedAge( pe->clock->total.seconds );
+		float secondAge = second->GetNormalizedAge( pe->clock->total.seconds );
+		int indexCount = pe->particles.size() - 1 - i;
+		unsigned char currentAlpha = ClampInt( indexCount * 32, 0, 255 );
+		Rgba firstStartColor = pe->startColor;
+		firstStartColor.a = currentAlpha;
+		Rgba firstColor = Interpolate( firstStartColor, pe->endColor, firstAge );
+		
+		currentAlpha = ClampInt( (indexCount + 1) * 32, 0, 255 );
+		Rgba secondStartColor = pe->startColor;
+		secondStartColor.a = currentAlpha;
+		Rgba secondColor = Interpolate( secondStartColor, pe->endColor, secondAge );
+
+		float firstSize = RangeMapFloat(firstAge, 0.f, pe->particleLifespan.max, 1.f, 50.f);
+		float secondSize = RangeMapFloat(secondAge, 0.f, pe->particleLifespan.max, 1.f, 50.f);
+
+		Vector3 bl = second->position + (quadUp * -1.f * secondSize);
+		Vector3 br = first->position + (quadUp * -1.f * firstSize);
+		Vector3 tr = first->position + (quadUp * firstSize);
+		Vector3 tl = second->position + (quadUp * secondSize);
+		WriteContrailQuad( out, bl, br, tr, tl, secondColor, firstColor );
+		out += 6;
+		bounds.StretchToIncludePoint( bl );
+		bounds.StretchToIncludePoint( br );
+		bounds.StretchToIncludePoint( tr );
+		bounds.StretchToIncludePoint( tl );
+
+		bl = second->position + (quadRight * -1.f * secondSize);
+		tl = second->position + (quadRight * secondSize);
+		tr = first->position + (quadRight * firstSize);
+		br = first->position + (quadRight * -1.f * firstSize);
+		WriteContrailQuad( out, bl, br, tr, tl, secondColor, firstColor );
+		out += 6;
+		bounds.StretchToIncludePoint( bl );
+		bounds.StretchToIncludePoint( br );
+		bounds.StretchToIncludePoint( tr );
+		bounds.StretchToIncludePoint( tl );
+	}
+
+	if ( isDynamic ) {
+		g_theRenderer->UnmapDynamic( range );
+		pe->mesh->SetDynamicVertices<Vertex3D_PCU>( range, vertexCount );
+		pe->mesh->SetBounds( bounds );
+	} else {
+		pe->mesh->SetVertices<Vertex3D_PCU>( vertexCount, vertices );
 	}
-
-	builder.End();
-	pe->mesh->FromBuilderAsType<Vertex3D_PCU>( &builder );
+	pe->mesh->SetDrawPrimitive( TRIANGLES );
 	pe->renderable->SetMesh( pe->mesh );
 	pe->renderable->SetModelMatrix( Matrix44() );
 }
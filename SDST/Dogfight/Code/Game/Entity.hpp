@@ -23,14 +23,16 @@ constexpr int ENTITY_SNAPSHOT_HISTORY_LENGTH = 3;
 constexpr float CLIENT_NUDGE_FACTOR_PER_SECOND = 1.f;
 
 
+// Plain data only, the snapshot layout in TheGame.cpp reads the fields by offset. Age and send time aren't in here,
+// both change every tick and the client works them out itself.
 struct EntitySnapshot_T {
 	int		id;
-	Transform transform;
+	Vector3 position;
+	Vector3 euler;
 	Vector3 velocity = Vector3(0.f, 0.f, 200.f);
 	Vector3 acceleration;
 	Vector3 angularVelocity;
 	float	currentThrust = 0.f;
-	float	age = 0.f;
 	float	ageAtDeath = -1.f;
 	float	health = 1.f;
 	bool	isAlive = true;
@@ -42,17 +44,17 @@ struct EntitySnapshot_T {
 	bool	isFireMissilePressed = false;
 	bool	isFireGunPressed = false;
 	int		lockedEntityID = -1;
-	float	timestamp;
+
+	Transform GetTransform() const { return Transform( nullptr, position, euler ); }
 
 	void WriteToBytePacker( BytePacker* bp ) {
 		bp->WriteValue<int>(id);
-		bp->WriteValue<Vector3>( transform.position );
-		bp->WriteValue<Vector3>( transform.euler );
+		bp->WriteValue<Vector3>( position );
+		bp->WriteValue<Vector3>( euler );
 		bp->WriteValue<Vector3>( velocity );
 		bp->WriteValue<Vector3>( acceleration );
 		bp->WriteValue<Vector3>( angularVelocity );
 		bp->WriteValue<float>( currentThrust );
-		bp->WriteValue<float>( age );
 		bp->WriteValue<float>( ageAtDeath );
 		bp->WriteValue<float>( health );
 		bp->WriteValue<float>( throttle );
@@ -62,20 +64,18 @@ struct EntitySnapshot_T {
 		bp->WriteValue<int>( lockedEntityID );
 		bp->WriteValue<bool>( isAlive );
 		bp->WriteValue<uint8_t>( killedBy );
-		bp->WriteValue<float>( timestamp );
 		bp->WriteValue<bool>( isFireMissilePressed );
 		bp->WriteValue<bool>( isFireGunPressed );
 	}
 
 	void ReadFromBytePacker( BytePacker* bp ) {
 		bp->ReadValue<int>( &id );
-		bp->ReadValue<Vector3>( &transform.position );
-		bp->ReadValue<Vector3>( &transform.euler );
+		bp->ReadValue<Vector3>( &position );
+		bp->ReadValue<Vector3>( &euler );
 		bp->ReadValue<Vector3>( &velocity );
 		bp->ReadValue<Vector3>( &acceleration );
 		bp->ReadValue<Vector3>( &angularVelocity );
 		bp->ReadValue<float>( &currentThrust );
-		bp->ReadValue<float>( &age );
 		bp->ReadValue<float>( &ageAtDeath );
 		bp->ReadValue<float>( &health );
 		bp->ReadValue<float>( &throttle );
@@ -85,7 +85,6 @@ struct EntitySnapshot_T {
 		bp->ReadValue<int>(	&lockedEntityID );
 		bp->ReadValue<bool>( &isAlive );
 		bp->ReadValue<uint8_t>( &killedBy );
-		bp->ReadValue<float>( &timestamp );
 		bp->ReadValue<bool>( &isFireMissilePressed );
 		bp->ReadValue<bool>( &isFireGunPressed );
 	}
@@ -104,6 +103,7 @@ public:
 			void				Update();
 
 			float				GetAge() const;	
+			void				SetAge( float age );
 			float				GetHealth() const;
 			bool				IsAlive() const;
 			bool				IsWeapon() const;
@@ -137,6 +137,7 @@ private:
 
 			EntitySnapshot_T	m_lastReceivedSnapshot;
 			bool				m_isLastReceivedSnapshotValid = false;
+			float				m_age = 0.f;		// Ticked locally on host and clients alike, never in snapshots
 
 			std::deque<EntitySnapshot_T> m_snapshotHistory; // Used to keep track of player inputs for correcting client players
 
@@ -156,6 +157,7 @@ public:
 			//float				ageAtDeath = -1.f;
 
 			EntitySnapshot_T	currentState;
+			Transform			transform;			// currentState as of the last Update, the contrails hang off it
 
 			Renderable*			renderable = nullptr;
 			EntityController*	controller = nullptr;
@@ -183,4 +185,5 @@ void	RecvEntityDestroy( NetMessage* msg, void* obj );
 void	GetEntitySnapshot( void*& snapshot, void* obj );
 void	SendEntitySnapshot( NetMessage* msg, void* snapshot );
 void	RecvEntitySnapshot( NetMessage* msg, void* snapshot );
-void	ApplyEntitySnapshot( void* snapshot, void* obj, float snapshotAge );
\ No newline at end of file
+void	ApplyEntitySnapshot( void* snapshot, void* obj, float snapshotAge );
+Vector3	GetEntityPosition( void* obj );
\ No newline at end of file
@@ -32,7 +32,7 @@ void EntityController::Update() {
 	pitchAxis = 0.f;
 	throttle = 0.25f;
 
-	if ( entity->currentState.age > entity->def.GetLifespan() ) {
+	if ( entity->GetAge() > entity->def.GetLifespan() ) {
 		entity->Kill(-1);
 	}
 }
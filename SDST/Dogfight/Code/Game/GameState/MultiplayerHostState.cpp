@@ -37,7 +37,7 @@ void MultiplayerHostState::Update() {
 		if ( g_theInputSystem->WasKeyJustPressed('M') ) {
 			Entity* aiPlane = CreateEntity( 1 );
 			aiPlane->Spawn();
-			aiPlane->currentState.transform.position = Vector3( GetRandomFloatInRange(-2000.f, 2000.f), 0.f, 0.f );
+			aiPlane->currentState.position = Vector3( GetRandomFloatInRange(-2000.f, 2000.f), 0.f, 0.f );
 		}
 
 		if ( (g_theInputSystem->WasKeyJustPressed('P') || g_theInputSystem->GetController(0).WasButtonJustPressed(InputSystem::XBOX_START))
@@ -54,8 +54,10 @@ void MultiplayerHostState::Update() {
 		}
 		
 		UpdateEntitiesAndControllers();
+		CheckTerrainCollisions();
 		CheckEntityCollisions();
 		ClearDeadEntities();
+		UpdateReplicationFocus();
 	
 		m_camera->Update();
 		hud->Update();
@@ -183,6 +185,22 @@ Entity* MultiplayerHostState::CreateEntity( int entityDefID, EntityController* c
 }
 
 
+//----------------------------------------------------------------------------------------------------------------
+// Planes near a client's own plane get sent to that client more often
+void MultiplayerHostState::UpdateReplicationFocus() {
+	for ( int connIndex = 0; connIndex < MAX_CLIENTS; connIndex++ ) {
+		if ( netSession->GetConnection( connIndex ) == nullptr ) {
+			continue;
+		}
+
+		Entity* player = FindPlayerByConnection( (uint8_t) connIndex );
+		if ( player != nullptr ) {
+			netSession->netObjectSystem->SetConnectionFocus( (uint8_t) connIndex, player->currentState.position );
+		}
+	}
+}
+
+
 //----------------------------------------------------------------------------------------------------------------
 void MultiplayerHostState::CheckWinConditions() {
 	for ( int i = 0; i < MAX_CLIENTS; i++ ) {
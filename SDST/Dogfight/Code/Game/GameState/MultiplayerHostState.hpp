@@ -43,6 +43,7 @@ private:
 	virtual void SpawnPlayer() override;
 	virtual void DrawEndScreen() override;
 	void CheckWinConditions();
+	void UpdateReplicationFocus();
 
 	
 private:
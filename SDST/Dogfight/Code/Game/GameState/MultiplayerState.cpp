@@ -214,6 +214,31 @@ void MultiplayerState::CheckEntityCollisions() {
 }
 
 
+//----------------------------------------------------------------------------------------------------------------
+// One batched height lookup for every live entity instead of a query per Entity::Update
+void MultiplayerState::CheckTerrainCollisions() {
+	m_terrainCheckEntities.clear();
+	m_terrainCheckPositions.clear();
+
+	std::map< int, Entity* >::iterator entityIt = entities.begin();
+	while ( entityIt != entities.end() ) {
+		if ( entityIt->second->IsAlive() ) {
+			m_terrainCheckEntities.push_back( entityIt->second );
+			m_terrainCheckPositions.push_back( entityIt->second->GetPosition() );
+		}
+		entityIt++;
+	}
+
+	m_terrain->GetHeightsAtPositions( m_terrainCheckPositions, m_terrainCheckHeights );
+
+	for ( unsigned int i = 0; i < m_terrainCheckEntities.size(); i++ ) {
+		if ( m_terrainCheckPositions[i].y < m_terrainCheckHeights[i] ) {
+			m_terrainCheckEntities[i]->Kill(-1);
+		}
+	}
+}
+
+
 //----------------------------------------------------------------------------------------------------------------
 bool MultiplayerState::AreOwnedBySamePlayer( Entity* first, Entity* second ) {
 	if ( first->controller->connectionID != -1 && second->controller->connectionID != -1 ) {
@@ -61,6 +61,7 @@ protected:
 	void ProcessPlayerInput();
 	void UpdateEntitiesAndControllers();
 	void CheckEntityCollisions();
+	void CheckTerrainCollisions();
 	void ClearDeadEntities();
 
 	void DrawScaleGridAroundPlayer();
@@ -83,6 +84,9 @@ protected:
 	Rgba ambientColor;
 
 	Terrain* m_terrain = nullptr;
+	std::vector< Entity* > m_terrainCheckEntities;		// Scratch for CheckTerrainCollisions, kept to avoid reallocating
+	std::vector< Vector3 > m_terrainCheckPositions;
+	std::vector< float > m_terrainCheckHeights;
 	Light* m_cameraLight = nullptr;
 	Light* m_sun = nullptr;
 	Vector3 lightPos = Vector3();
@@ -0,0 +1,125 @@
+#include "Game/Jobs/TerrainTileJob.hpp"
+#include "Game/GameCommon.hpp"
+
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Renderer/MeshBuilder.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/SmoothNoise.hpp"
+
+//----------------------------------------------------------------------------------------------------------------
+TerrainTileJob::TerrainTileJob( const IntVector2& tileCoords, Terrain* terrain )
+	: m_tileCoords( tileCoords )
+	, m_terrain( terrain )
+{
+	// Copied so the worker never reads the terrain while the main thread might be changing it
+	m_quadsPerSide = terrain->quadsPerTileSide;
+	m_distPerVertex = terrain->tileSize / (float) terrain->quadsPerTileSide;
+	m_maxHeight = terrain->maxHeight;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+TerrainTileJob::~TerrainTileJob() {
+
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Each tile is one job and a view radius change submits dozens at once, which is what keeps the workers busy.
+// A tile is only ~1k samples, splitting it further with ParallelFor costs more in chunk overhead than it saves.
+void TerrainTileJob::Execute() {
+
+	int verticesOnSide = m_quadsPerSide + 1;
+	int samplesOnSide = verticesOnSide + 2;		// One sample border for the normals
+	int firstGlobalX = (m_tileCoords.x * m_quadsPerSide) - 1;
+	int firstGlobalZ = (m_tileCoords.y * m_quadsPerSide) - 1;
+
+	// Positions come from the global vertex index so neighboring tiles produce identical edge vertices
+	std::vector<float> heights( samplesOnSide * samplesOnSide );
+	std::vector<float> rowX( samplesOnSide );
+	std::vector<float> rowZ( samplesOnSide );
+	for ( int column = 0; column < samplesOnSide; column++ ) {
+		rowX[column] = (float) (firstGlobalX + column) * m_distPerVertex;
+	}
+
+	for ( int row = 0; row < samplesOnSide; row++ ) {
+		float z = (float) (firstGlobalZ + row) * m_distPerVertex;
+		for ( int column = 0; column < samplesOnSide; column++ ) {
+			rowZ[column] = z;
+		}
+
+		float* rowHeights = &heights[ row * samplesOnSide ];
+		Compute2dPerlinNoiseBatch( rowX.data(), rowZ.data(), samplesOnSide, rowHeights, m_maxHeight, 3 );
+		for ( int column = 0; column < samplesOnSide; column++ ) {
+			rowHeights[column] = RangeMapFloat( SmoothStart2( rowHeights[column] ), -1.f, 1.f, 0.f, m_maxHeight );
+		}
+	}
+
+	m_mb.Begin(TRIANGLES, true);
+	m_mb.SetColor(Rgba(255,255,255,255));
+
+	// Collision height cache, same grid as the vertices
+	m_quantizedHeights.resize( verticesOnSide * verticesOnSide );
+	for ( int row = 0; row < verticesOnSide; row++ ) {
+		for ( int column = 0; column < verticesOnSide; column++ ) {
+			float height = heights[ ((row + 1) * samplesOnSide) + column + 1 ];
+			float fraction = ClampFloat( height / m_maxHeight, 0.f, 1.f );
+			m_quantizedHeights[ (row * verticesOnSide) + column ] = (uint16_t) ((fraction * 65535.f) + 0.5f);
+		}
+	}
+
+	// One vertex per grid point, shared by every quad that touches it
+	for ( int row = 1; row <= verticesOnSide; row++ ) {
+		for ( int column = 1; column <= verticesOnSide; column++ ) {
+			int index = (row * samplesOnSide) + column;
+
+			float x = (float) (firstGlobalX + column) * m_distPerVertex;
+			float z = (float) (firstGlobalZ + row) * m_distPerVertex;
+
+			Vector3 eastPos  = Vector3( x + m_distPerVertex, heights[index + 1],             z );
+			Vector3 westPos  = Vector3( x - m_distPerVertex, heights[index - 1],             z );
+			Vector3 northPos = Vector3( x,                   heights[index + samplesOnSide], z + m_distPerVertex );
+			Vector3 southPos = Vector3( x,                   heights[index - samplesOnSide], z - m_distPerVertex );
+
+			Vector3 tangent = (westPos - eastPos).GetNormalized();
+			Vector3 bitangent = (northPos - southPos).GetNormalized();
+
+			m_mb.SetNormal( Vector3::CrossProduct( tangent, bitangent ) );
+			m_mb.SetTangent( tangent );
+			m_mb.SetUV( Vector2( (float) (column - 1), (float) (row - 1) ) );
+			m_mb.PushVertex( Vector3( x, heights[index], z ) );
+		}
+	}
+
+	// push back indices
+	for ( int z = 0; z < m_quadsPerSide; z++ ) {
+		for ( int x = 0; x < m_quadsPerSide; x++ ) {
+			int bottomLeftIndex = (z * verticesOnSide) + x;
+			int bottomRightIndex = bottomLeftIndex + 1;
+			int topLeftIndex = bottomLeftIndex + verticesOnSide;
+			int topRightIndex = topLeftIndex + 1;
+
+			m_mb.PushIndex(bottomLeftIndex);
+			m_mb.PushIndex(bottomRightIndex);
+			m_mb.PushIndex(topRightIndex);
+			m_mb.PushIndex(bottomLeftIndex);
+			m_mb.PushIndex(topRightIndex);
+			m_mb.PushIndex(topLeftIndex);
+		}
+	}
+
+	// magic happens
+	m_mb.End();
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void TerrainTileJob::OnComplete() {
+	if ( m_terrain == nullptr ) {
+		return;
+	}
+
+	Mesh* tileMesh = new Mesh();
+	tileMesh->FromBuilderAsType<Vertex3D_Lit>(&m_mb);
+	m_terrain->OnTileBuilt( m_tileCoords, tileMesh, m_quantizedHeights );
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include "Game/Terrain.hpp"
+
+#include "Engine/Renderer/MeshBuilder.hpp"
+#include "Engine/Math/IntVector2.hpp"
+#include "Engine/Async/Job.hpp"
+
+
+class TerrainTileJob : public Job {
+public:
+	TerrainTileJob( const IntVector2& tileCoords, Terrain* terrain );
+	~TerrainTileJob();
+
+	virtual void Execute() override;
+	virtual void OnComplete() override;
+
+	void DetachTerrain() { m_terrain = nullptr; }	// Main thread only, the result is dropped
+
+
+private:
+	IntVector2 m_tileCoords;
+	Terrain* m_terrain;
+	int m_quadsPerSide;
+	float m_distPerVertex;
+	float m_maxHeight;
+	MeshBuilder m_mb;
+	std::vector<uint16_t> m_quantizedHeights;
+};
@@ -46,13 +46,15 @@ void MissileController::TurnTowardTarget() {
 	Vector3 newUp = Vector3::CrossProduct( newForward, newRight ).GetNormalized();
 	Matrix44 rotation( newRight, newUp, newForward );
 
-	entity->currentState.transform.TurnToward( entity->currentState.transform.GetLocalToWorldMatrix(), rotation, entity->def.GetMaxRollSpeed() * g_theGame->GetDeltaTime() );
+	Transform missileTransform = entity->currentState.GetTransform();
+	missileTransform.TurnToward( missileTransform.GetLocalToWorldMatrix(), rotation, entity->def.GetMaxRollSpeed() * g_theGame->GetDeltaTime() );
+	entity->currentState.euler = missileTransform.euler;
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
 void MissileController::CheckIfExpired() {
-	if ( entity->currentState.age > entity->def.GetLifespan() ) {
+	if ( entity->GetAge() > entity->def.GetLifespan() ) {
 		entity->Kill(-1);
 		return;
 	}
@@ -64,7 +66,7 @@ void MissileController::CheckIfExpired() {
 
 	Entity* target = TheGame::GetMultiplayerState()->GetEntityByID( entity->currentState.lockedEntityID );
 	Vector3 displacement = target->GetPosition() - entity->GetPosition();
-	float missileLostTargetCheck = DotProduct( entity->currentState.transform.GetWorldForward(), displacement );
+	float missileLostTargetCheck = DotProduct( entity->GetForward(), displacement );
 	if ( missileLostTargetCheck < 0.f ) {
 		entity->Kill(-1);
 		return;
@@ -180,16 +180,16 @@ void PlayerHUD::DrawDirectionToTargetIcon() const {
 
 		Vector3 displacementToTarget = target->GetPosition() - player->entity->GetPosition();
 		Vector3 directionToTarget = displacementToTarget.GetNormalized();
-		const Transform& myTransform = player->entity->currentState.transform;
+		TransformWorld_T myWorld = player->entity->currentState.GetTransform().ComputeWorld();
 
-		float dotForward = DotProduct( myTransform.GetWorldForward(), directionToTarget );
+		float dotForward = DotProduct( myWorld.forward, directionToTarget );
 		if ( dotForward <= 0.95f ) {
 
 			float screenHalfWidth = Window::GetInstance()->GetWidth() * 0.5f;
 			float screenHalfHeight = Window::GetInstance()->GetHeight() * 0.5f;
 
-			float dotUp = DotProduct( myTransform.GetWorldUp(), directionToTarget );
-			float dotRight = DotProduct( myTransform.GetWorldRight(), directionToTarget );
+			float dotUp = DotProduct( myWorld.up, directionToTarget );
+			float dotRight = DotProduct( myWorld.right, directionToTarget );
 			Vector2 directionOnHUD( dotRight, dotUp );
 			directionOnHUD.NormalizeAndGetLength();
 			float orientation = directionOnHUD.GetOrientationDegrees();
@@ -246,8 +246,9 @@ void PlayerHUD::DrawCenterReticle() const {
 		float screenHalfWidth = Window::GetInstance()->GetWidth();
 		float screenHalfHeight = Window::GetInstance()->GetHeight();
 
-		float dotUp = DotProduct( Vector3::UP, player->entity->currentState.transform.GetWorldUp() );
-		float dotRight = DotProduct( Vector3::UP, player->entity->currentState.transform.GetWorldRight() );
+		TransformWorld_T world = player->entity->currentState.GetTransform().ComputeWorld();
+		float dotUp = DotProduct( Vector3::UP, world.up );
+		float dotRight = DotProduct( Vector3::UP, world.right );
 		Vector2 directionOnHUD( dotRight, dotUp );
 		directionOnHUD.NormalizeAndGetLength();
 		float orientation = directionOnHUD.GetOrientationDegrees();
@@ -303,8 +304,9 @@ void PlayerHUD::DrawVelocityVectorIcon() const {
 		float screenHalfWidth = Window::GetInstance()->GetWidth();
 		float screenHalfHeight = Window::GetInstance()->GetHeight();
 
-		float dotUp = DotProduct( Vector3::UP, player->entity->currentState.transform.GetWorldUp() );
-		float dotRight = DotProduct( Vector3::UP, player->entity->currentState.transform.GetWorldRight() );
+		TransformWorld_T world = player->entity->currentState.GetTransform().ComputeWorld();
+		float dotUp = DotProduct( Vector3::UP, world.up );
+		float dotRight = DotProduct( Vector3::UP, world.right );
 		Vector2 directionOnHUD( dotRight, dotUp );
 		directionOnHUD.NormalizeAndGetLength();
 		float orientation = directionOnHUD.GetOrientationDegrees();
@@ -358,7 +360,7 @@ void PlayerHUD::DrawAltitudeAndSpeed() const {
 	g_theRenderer->DrawTextInBox2D( altLabelBounds, Vector2(0.f, 0.5f), "altitude", 13.f, Rgba(182, 255, 118, 220), 1.f, g_theRenderer->CreateOrGetBitmapFont("ibm-plex-mono"), TEXT_DRAW_OVERRUN );
 
 	g_theRenderer->DrawTextInBox2D( velBounds, Vector2(1.f, 0.5f), std::to_string((int) player->entity->currentState.velocity.GetLength()), 30.f, Rgba(182, 255, 118, 220), 1.f, g_theRenderer->CreateOrGetBitmapFont("ibm-plex-mono"), TEXT_DRAW_OVERRUN );
-	g_theRenderer->DrawTextInBox2D( altBounds, Vector2(0.f, 0.5f), std::to_string((int) player->entity->currentState.transform.position.y), 30.f, Rgba(182, 255, 118, 220), 1.f, g_theRenderer->CreateOrGetBitmapFont("ibm-plex-mono"), TEXT_DRAW_OVERRUN );
+	g_theRenderer->DrawTextInBox2D( altBounds, Vector2(0.f, 0.5f), std::to_string((int) player->entity->currentState.position.y), 30.f, Rgba(182, 255, 118, 220), 1.f, g_theRenderer->CreateOrGetBitmapFont("ibm-plex-mono"), TEXT_DRAW_OVERRUN );
 
 	g_theRenderer->BindMaterial(g_theRenderer->GetMaterial("ui"));
 	float thrustBarHeight = RangeMapFloat( player->entity->currentState.velocity.GetLength(), 0.f, player->entity->def.GetMaxVelocity(), screenHeight * 0.25f, screenHeight * 0.75f );
@@ -21,14 +21,14 @@ void PlayerInfo::SetName( const std::string& name ) {
 void PlayerInfo::GivePoints( int points ) {
 	m_roundScore += points;
 
-	Logger::PrintTaggedf("Net", "Adding %d points to player %d", points, m_connectionID );
+	LOG_TAGGEDF("Net", "Adding %d points to player %d", points, m_connectionID );
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
 void PlayerInfo::RecordGunHit() {
 	m_roundGunHits++;
-	Logger::PrintTaggedf("Net", "Adding gun hit to player %d", m_connectionID );
+	LOG_TAGGEDF("Net", "Adding gun hit to player %d", m_connectionID );
 	GivePoints(70);
 }
 
@@ -36,7 +36,7 @@ void PlayerInfo::RecordGunHit() {
 //----------------------------------------------------------------------------------------------------------------
 void PlayerInfo::RecordMissileHit() {
 	m_roundMissileHits++;
-	Logger::PrintTaggedf("Net", "Adding missile hit to player %d", m_connectionID );
+	LOG_TAGGEDF("Net", "Adding missile hit to player %d", m_connectionID );
 
 	GivePoints(700);
 }
@@ -45,7 +45,7 @@ void PlayerInfo::RecordMissileHit() {
 //----------------------------------------------------------------------------------------------------------------
 void PlayerInfo::RecordKill() {
 	m_roundKills++;
-	Logger::PrintTaggedf("Net", "Adding kill to player %d", m_connectionID );
+	LOG_TAGGEDF("Net", "Adding kill to player %d", m_connectionID );
 	GivePoints(700);
 }
 
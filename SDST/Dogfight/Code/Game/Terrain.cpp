@@ -1,31 +1,45 @@
 #include "Game/Terrain.hpp"
-#include "Game/Jobs/TerrainRebuildJob.hpp"
+#include "Game/Jobs/TerrainTileJob.hpp"
 #include "Game/GameCommon.hpp"
 
+#include "Engine/Math/MathUtils.hpp"
 #include "Engine/Math/SmoothNoise.hpp"
 
+#include <algorithm>
+
 
 //----------------------------------------------------------------------------------------------------------------
-Terrain::Terrain( Camera* cam ) 
+Terrain::Terrain( Camera* cam )
 	: m_camera( cam )
 {
-	CreateRebuildJob();
+	m_centerTile = GetTileCoordsForPosition( m_camera->transform.position );
 	g_theRenderer->CreateOrGetTexture("Data/Images/grass01.png")->SetSamplerMode(SAMPLER_LINEAR_MIPMAP_LINEAR);
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
 Terrain::~Terrain() {
-	if ( m_terrainMesh != nullptr ) {
-		delete m_terrainMesh;
-		m_terrainMesh = nullptr;
-		m_terrainRenderable->SetMesh( nullptr );
+
+	// Tile jobs still in flight lose their pointer back to us and go back to the job system, which
+	// frees them after their (now empty) OnComplete. Nothing else in the job system is touched.
+	for ( unsigned int i = 0; i < m_tileJobs.size(); i++ ) {
+		TerrainTileJob* job = m_tileJobs[i];
+		if ( job->IsComplete() ) {
+			delete job;
+		} else {
+			job->DetachTerrain();
+			job->SetDeleteWhenComplete( true );
+		}
 	}
+	m_tileJobs.clear();
+
+	m_heightLookup.clear();
 
-	if ( m_terrainRenderable != nullptr ) {
-		delete m_terrainRenderable;
-		m_terrainRenderable = nullptr;
+	std::map<IntVector2, TerrainTile_T*>::iterator it;
+	for ( it = m_tiles.begin(); it != m_tiles.end(); it++ ) {
+		DestroyTile( it->second );
 	}
+	m_tiles.clear();
 
 	m_camera = nullptr;
 }
@@ -34,51 +48,298 @@ Terrain::~Terrain() {
 //----------------------------------------------------------------------------------------------------------------
 void Terrain::Update() {
 
-	if ( m_terrainRebuildJobID != -1 ) {
-		Job* claimedBuildJob = g_theJobSystem->ClaimFinishedJob( m_terrainRebuildJobID ); 
-		if ( claimedBuildJob != nullptr ) {
-			m_terrainRebuildJobID = -1;
-			delete claimedBuildJob;
-			claimedBuildJob = nullptr;
+	IntVector2 centerTile = GetTileCoordsForPosition( m_camera->transform.position );
+	if ( !(centerTile == m_centerTile) ) {
+		m_centerTile = centerTile;
+		m_areVisibleTilesDirty = true;
+	}
+
+	if ( m_areVisibleTilesDirty ) {
+		UpdateVisibleTiles();
+		EvictUnusedTiles();
+		m_areVisibleTilesDirty = false;
+	}
+
+	DeleteCompletedTileJobs();
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void Terrain::DeleteCompletedTileJobs() {
+	for ( unsigned int i = 0; i < m_tileJobs.size(); ) {
+		if ( m_tileJobs[i]->IsComplete() ) {
+			delete m_tileJobs[i];
+			m_tileJobs[i] = m_tileJobs.back();
+			m_tileJobs.pop_back();
+		} else {
+			i++;
 		}
 	}
+}
+
 
-	if ( (m_camera->transform.position - m_positionLastRebuild).GetLength() > 5000.f ) {
-		CreateRebuildJob();
+//----------------------------------------------------------------------------------------------------------------
+IntVector2 Terrain::GetTileCoordsForPosition( const Vector3& pos ) const {
+	return IntVector2( (int) floorf( pos.x / tileSize ), (int) floorf( pos.z / tileSize ) );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Only tiles that just came into range get built, everything else is already cached or in flight
+void Terrain::UpdateVisibleTiles() {
+	m_visibleGeneration++;
+
+	// Walk outward ring by ring so the tiles under the plane are queued first
+	for ( int ring = 0; ring <= tileViewRadius; ring++ ) {
+		for ( int z = -ring; z <= ring; z++ ) {
+			for ( int x = -ring; x <= ring; x++ ) {
+				if ( abs(x) != ring && abs(z) != ring ) {
+					continue;
+				}
+
+				IntVector2 coords( m_centerTile.x + x, m_centerTile.y + z );
+				TerrainTile_T* tile = nullptr;
+
+				std::map<IntVector2, TerrainTile_T*>::iterator found = m_tiles.find( coords );
+				if ( found != m_tiles.end() ) {
+					tile = found->second;
+				} else {
+					tile = new TerrainTile_T();
+					tile->coords = coords;
+					m_tiles[coords] = tile;
+				}
+
+				tile->lastVisibleGeneration = m_visibleGeneration;
+
+				if ( tile->mesh != nullptr ) {
+					AddTileToScene( tile );
+				} else if ( !tile->isBuilding ) {
+					SubmitTileJob( tile );
+				}
+			}
+		}
 	}
+
+	std::map<IntVector2, TerrainTile_T*>::iterator it;
+	for ( it = m_tiles.begin(); it != m_tiles.end(); it++ ) {
+		if ( it->second->lastVisibleGeneration != m_visibleGeneration ) {
+			RemoveTileFromScene( it->second );
+		}
+	}
+
+	RebuildHeightLookup();
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
-void Terrain::SetMesh( Mesh* mesh ) {
+// Every visible tile is in m_tiles and can't be evicted, so the pointers stay good until the next rebuild
+void Terrain::RebuildHeightLookup() {
+	m_heightLookupSide = (tileViewRadius * 2) + 1;
+	m_heightLookupOrigin = IntVector2( m_centerTile.x - tileViewRadius, m_centerTile.y - tileViewRadius );
+	m_heightLookup.assign( m_heightLookupSide * m_heightLookupSide, nullptr );
 
-	if ( m_terrainRenderable == nullptr ) {
-		m_terrainRenderable = new Renderable();
-		m_terrainRenderable->SetMaterial( g_theRenderer->GetMaterial("terrain") );
-		g_theGame->GetMultiplayerState()->m_scene->AddRenderable(m_terrainRenderable);
+	for ( int z = 0; z < m_heightLookupSide; z++ ) {
+		for ( int x = 0; x < m_heightLookupSide; x++ ) {
+			IntVector2 coords( m_heightLookupOrigin.x + x, m_heightLookupOrigin.y + z );
+			std::map<IntVector2, TerrainTile_T*>::iterator found = m_tiles.find( coords );
+			if ( found != m_tiles.end() ) {
+				m_heightLookup[ (z * m_heightLookupSide) + x ] = found->second;
+			}
+		}
 	}
+}
 
-	if ( m_terrainMesh != nullptr ) {
-		delete m_terrainMesh;
-		m_terrainMesh = nullptr;
+
+//----------------------------------------------------------------------------------------------------------------
+// Drops the least recently visible tiles once the cache is over budget
+void Terrain::EvictUnusedTiles() {
+	if ( (int) m_tiles.size() <= maxCachedTiles ) {
+		return;
 	}
 
+	std::vector<TerrainTile_T*> candidates;
+	std::map<IntVector2, TerrainTile_T*>::iterator it;
+	for ( it = m_tiles.begin(); it != m_tiles.end(); it++ ) {
+		TerrainTile_T* tile = it->second;
+		if ( tile->lastVisibleGeneration != m_visibleGeneration && !tile->isBuilding ) {
+			candidates.push_back( tile );
+		}
+	}
+
+	std::sort( candidates.begin(), candidates.end(), []( const TerrainTile_T* a, const TerrainTile_T* b ) {
+		return a->lastVisibleGeneration < b->lastVisibleGeneration;
+	});
+
+	for ( unsigned int i = 0; i < candidates.size() && (int) m_tiles.size() > maxCachedTiles; i++ ) {
+		m_tiles.erase( candidates[i]->coords );
+		DestroyTile( candidates[i] );
+	}
+}
+
 
-	m_terrainMesh = mesh;
-	m_terrainRenderable->SetMesh( m_terrainMesh );
+//----------------------------------------------------------------------------------------------------------------
+void Terrain::SubmitTileJob( TerrainTile_T* tile ) {
+	tile->isBuilding = true;
+
+	TerrainTileJob* job = new TerrainTileJob( tile->coords, this );
+	job->SetDeleteWhenComplete( false );
+	m_tileJobs.push_back( job );
+	g_theJobSystem->SubmitJob( job );
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
-void Terrain::CreateRebuildJob() {
-	TerrainRebuildJob* rebuildJob = new TerrainRebuildJob( m_camera->transform.position, this );
-	m_terrainRebuildJobID = g_theJobSystem->SubmitJob( rebuildJob );
-	m_positionLastRebuild = m_camera->transform.position;
+void Terrain::OnTileBuilt( const IntVector2& tileCoords, Mesh* mesh, std::vector<uint16_t>& heights ) {
+	std::map<IntVector2, TerrainTile_T*>::iterator found = m_tiles.find( tileCoords );
+	if ( found == m_tiles.end() ) {
+		delete mesh;
+		return;
+	}
+
+	TerrainTile_T* tile = found->second;
+	tile->isBuilding = false;
+	tile->mesh = mesh;
+	tile->heights.swap( heights );
+
+	if ( tile->lastVisibleGeneration == m_visibleGeneration ) {
+		AddTileToScene( tile );
+	}
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
-bool Terrain::IsPointBelowTerrain( const Vector3& pos ) {
-	float height = RangeMapFloat( SmoothStart2( Compute2dPerlinNoise( pos.x, pos.z, maxHeight, 3 ) ), -1.f, 1.f, 0.f, maxHeight );
-	return pos.y < height;
-}
\ No newline at end of file
+void Terrain::AddTileToScene( TerrainTile_T* tile ) {
+	if ( tile->isInScene ) {
+		return;
+	}
+
+	if ( tile->renderable == nullptr ) {
+		tile->renderable = new Renderable();
+		tile->renderable->SetMaterial( g_theRenderer->GetMaterial("terrain") );
+	}
+
+	tile->renderable->SetMesh( tile->mesh );
+	g_theGame->GetMultiplayerState()->m_scene->AddRenderable( tile->renderable );
+	tile->isInScene = true;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void Terrain::RemoveTileFromScene( TerrainTile_T* tile ) {
+	if ( !tile->isInScene ) {
+		return;
+	}
+
+	g_theGame->GetMultiplayerState()->m_scene->RemoveRenderable( tile->renderable );
+	tile->isInScene = false;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void Terrain::DestroyTile( TerrainTile_T* tile ) {
+	RemoveTileFromScene( tile );
+
+	if ( tile->renderable != nullptr ) {
+		tile->renderable->SetMesh( nullptr );
+		delete tile->renderable;
+		tile->renderable = nullptr;
+	}
+
+	if ( tile->mesh != nullptr ) {
+		delete tile->mesh;
+		tile->mesh = nullptr;
+	}
+
+	delete tile;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+const TerrainTile_T* Terrain::GetCachedTile( const IntVector2& tileCoords ) const {
+	int x = tileCoords.x - m_heightLookupOrigin.x;
+	int z = tileCoords.y - m_heightLookupOrigin.y;
+	if ( x < 0 || z < 0 || x >= m_heightLookupSide || z >= m_heightLookupSide ) {
+		return nullptr;
+	}
+
+	const TerrainTile_T* tile = m_heightLookup[ (z * m_heightLookupSide) + x ];
+	if ( tile == nullptr || tile->heights.empty() ) {
+		return nullptr;
+	}
+	return tile;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Bilinear between the four cached heights around pos. They're the quad's vertex heights, but the mesh splits the
+// quad into two triangles, so between the vertices this is close to the drawn surface rather than on it
+float Terrain::SampleTileHeight( const TerrainTile_T* tile, const Vector3& pos ) const {
+	int verticesOnSide = quadsPerTileSide + 1;
+	float quadsPerUnit = (float) quadsPerTileSide / tileSize;
+
+	float localX = ClampFloat( (pos.x * quadsPerUnit) - (float) (tile->coords.x * quadsPerTileSide), 0.f, (float) quadsPerTileSide );
+	float localZ = ClampFloat( (pos.z * quadsPerUnit) - (float) (tile->coords.y * quadsPerTileSide), 0.f, (float) quadsPerTileSide );
+
+	int column = ClampInt( (int) localX, 0, quadsPerTileSide - 1 );
+	int row = ClampInt( (int) localZ, 0, quadsPerTileSide - 1 );
+	float fractionX = localX - (float) column;
+	float fractionZ = localZ - (float) row;
+
+	const uint16_t* bottom = &tile->heights[ (row * verticesOnSide) + column ];
+	const uint16_t* top = bottom + verticesOnSide;
+
+	float bottomHeight = (float) bottom[0] + (((float) bottom[1] - (float) bottom[0]) * fractionX);
+	float topHeight = (float) top[0] + (((float) top[1] - (float) top[0]) * fractionX);
+	float quantized = bottomHeight + ((topHeight - bottomHeight) * fractionZ);
+
+	return quantized * (maxHeight / 65535.f);
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Only hit for tiles that aren't built yet
+float Terrain::SampleNoiseHeight( const Vector3& pos ) const {
+	return RangeMapFloat( SmoothStart2( Compute2dPerlinNoise( pos.x, pos.z, maxHeight, 3 ) ), -1.f, 1.f, 0.f, maxHeight );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+float Terrain::GetHeightAtPosition( const Vector3& pos ) const {
+	const TerrainTile_T* tile = GetCachedTile( GetTileCoordsForPosition( pos ) );
+	if ( tile == nullptr ) {
+		return SampleNoiseHeight( pos );
+	}
+	return SampleTileHeight( tile, pos );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+bool Terrain::IsPointBelowTerrain( const Vector3& pos ) const {
+	return pos.y < GetHeightAtPosition( pos );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Points in the same tile tend to come in runs, so the last tile is reused until the coords change
+void Terrain::GetHeightsAtPositions( const std::vector<Vector3>& positions, std::vector<float>& out_heights ) const {
+	out_heights.resize( positions.size() );
+
+	IntVector2 lastCoords;
+	const TerrainTile_T* lastTile = nullptr;
+	bool hasLastTile = false;
+
+	for ( unsigned int i = 0; i < positions.size(); i++ ) {
+		IntVector2 coords = GetTileCoordsForPosition( positions[i] );
+		if ( !hasLastTile || !(coords == lastCoords) ) {
+			lastCoords = coords;
+			lastTile = GetCachedTile( coords );
+			hasLastTile = true;
+		}
+
+		if ( lastTile == nullptr ) {
+			out_heights[i] = SampleNoiseHeight( positions[i] );
+		} else {
+			out_heights[i] = SampleTileHeight( lastTile, positions[i] );
+		}
+	}
+}
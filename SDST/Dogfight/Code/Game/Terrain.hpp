@@ -1,6 +1,25 @@
 #pragma once
 
 #include "Engine/Renderer/Camera.hpp"
+#include "Engine/Math/IntVector2.hpp"
+
+#include <map>
+#include <vector>
+#include <cstdint>
+
+
+class TerrainTileJob;
+
+
+struct TerrainTile_T {
+	IntVector2 coords;
+	Mesh* mesh = nullptr;
+	Renderable* renderable = nullptr;
+	bool isBuilding = false;
+	bool isInScene = false;
+	unsigned int lastVisibleGeneration = 0;		// For LRU eviction
+	std::vector<uint16_t> heights;				// (quadsPerTileSide + 1)^2 samples, quantized over [0, maxHeight]
+};
 
 
 class Terrain {
@@ -10,29 +29,49 @@ public:
 	~Terrain();
 
 	void Update();
-	void SetMesh( Mesh* mesh );
+	void OnTileBuilt( const IntVector2& tileCoords, Mesh* mesh, std::vector<uint16_t>& heights );
 
-	bool IsPointBelowTerrain( const Vector3& pos );
+	float GetHeightAtPosition( const Vector3& pos ) const;
+	bool IsPointBelowTerrain( const Vector3& pos ) const;
+	void GetHeightsAtPositions( const std::vector<Vector3>& positions, std::vector<float>& out_heights ) const;
 
 
 private:
-	void RebuildTerrainMesh();
-	void CreateRebuildJob();
+	IntVector2 GetTileCoordsForPosition( const Vector3& pos ) const;
+	void UpdateVisibleTiles();
+	void EvictUnusedTiles();
+	void SubmitTileJob( TerrainTile_T* tile );
+	void AddTileToScene( TerrainTile_T* tile );
+	void RemoveTileFromScene( TerrainTile_T* tile );
+	void DestroyTile( TerrainTile_T* tile );
+	void RebuildHeightLookup();
+	void DeleteCompletedTileJobs();
+	const TerrainTile_T* GetCachedTile( const IntVector2& tileCoords ) const;
+	float SampleTileHeight( const TerrainTile_T* tile, const Vector3& pos ) const;
+	float SampleNoiseHeight( const Vector3& pos ) const;
 
 
 public:
-	int verticesPerSide = 500;
-	float meshLength = 200000.f;
+	float tileSize = 5000.f;
+	int quadsPerTileSide = 32;
+	int tileViewRadius = 5;			// In tiles, 11x11 tiles around the camera
+	int maxCachedTiles = 256;
 	float maxHeight = 3000.f;
 
-	
+
 private:
 
 	Camera* m_camera = nullptr;
 
-	Renderable* m_terrainRenderable = nullptr;
-	Mesh* m_terrainMesh = nullptr;
-	Vector3 m_positionLastRebuild;
+	std::map<IntVector2, TerrainTile_T*> m_tiles;
+	std::vector<TerrainTileJob*> m_tileJobs;		// Owned here until complete, so the destructor can cancel them
+
+	IntVector2 m_centerTile;
+	unsigned int m_visibleGeneration = 0;
+	bool m_areVisibleTilesDirty = true;
 
-	int m_terrainRebuildJobID = -1;
-};
\ No newline at end of file
+	// Visible tiles in a flat window around m_centerTile so height queries skip the map
+	std::vector<TerrainTile_T*> m_heightLookup;
+	IntVector2 m_heightLookupOrigin;
+	int m_heightLookupSide = 0;
+};
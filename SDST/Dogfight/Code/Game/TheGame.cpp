@@ -183,6 +183,31 @@ void TheGame::Initialize() {
 	entityType->sendSnapshotCB = SendEntitySnapshot;
 	entityType->recvSnapshotCB = RecvEntitySnapshot;
 	entityType->applySnapshotCB = ApplyEntitySnapshot;
+	entityType->getPositionCB = GetEntityPosition;
+	entityType->priorityFalloffDistance = 2000.f;
+
+	// Positions to 1/64th of a unit, velocities to 1/128th, inputs to 1/512th, rotations to ~0.005 degrees
+	NetSnapshotLayout& entityLayout = entityType->snapshotLayout;
+	entityLayout.SetSnapshotSize( sizeof(EntitySnapshot_T) );
+	entityLayout.AddField( NETFIELD_INT32, offsetof(EntitySnapshot_T, id) );
+	entityLayout.AddQuantizedVector3( offsetof(EntitySnapshot_T, position), -131072.f, 131072.f, 24 );
+	entityLayout.AddAngles( offsetof(EntitySnapshot_T, euler), 16 );
+	entityLayout.AddQuantizedVector3( offsetof(EntitySnapshot_T, velocity), -4096.f, 4096.f, 20 );
+	entityLayout.AddQuantizedVector3( offsetof(EntitySnapshot_T, acceleration), -4096.f, 4096.f, 20 );
+	entityLayout.AddQuantizedVector3( offsetof(EntitySnapshot_T, angularVelocity), -2048.f, 2048.f, 18 );
+	entityLayout.AddField( NETFIELD_FLOAT, offsetof(EntitySnapshot_T, currentThrust) );
+	entityLayout.AddField( NETFIELD_FLOAT, offsetof(EntitySnapshot_T, ageAtDeath) );
+	entityLayout.AddField( NETFIELD_FLOAT, offsetof(EntitySnapshot_T, health) );
+	entityLayout.AddQuantizedFloat( offsetof(EntitySnapshot_T, throttle), -1.f, 1.f, 10 );
+	entityLayout.AddQuantizedFloat( offsetof(EntitySnapshot_T, rollAxis), -1.f, 1.f, 10 );
+	entityLayout.AddQuantizedFloat( offsetof(EntitySnapshot_T, pitchAxis), -1.f, 1.f, 10 );
+	entityLayout.AddQuantizedFloat( offsetof(EntitySnapshot_T, yawAxis), -1.f, 1.f, 10 );
+	entityLayout.AddField( NETFIELD_INT32, offsetof(EntitySnapshot_T, lockedEntityID) );
+	entityLayout.AddField( NETFIELD_BOOL, offsetof(EntitySnapshot_T, isAlive) );
+	entityLayout.AddField( NETFIELD_UINT8, offsetof(EntitySnapshot_T, killedBy) );
+	entityLayout.AddField( NETFIELD_BOOL, offsetof(EntitySnapshot_T, isFireMissilePressed) );
+	entityLayout.AddField( NETFIELD_BOOL, offsetof(EntitySnapshot_T, isFireGunPressed) );
+
 	netSession->netObjectSystem->RegisterObjectType( entityType );
 
 	NetObjectDef_T* playerInfoType = new NetObjectDef_T();
@@ -195,6 +220,15 @@ void TheGame::Initialize() {
 	playerInfoType->sendSnapshotCB = SendPlayerInfoSnapshot;
 	playerInfoType->recvSnapshotCB = RecvPlayerInfoSnapshot;
 	playerInfoType->applySnapshotCB = ApplyPlayerInfoSnapshot;
+	playerInfoType->priorityWeight = 0.25f;		// Scores only change on hits and kills
+
+	NetSnapshotLayout& playerInfoLayout = playerInfoType->snapshotLayout;
+	playerInfoLayout.SetSnapshotSize( sizeof(PlayerInfoSnapshot_T) );
+	playerInfoLayout.AddField( NETFIELD_INT32, offsetof(PlayerInfoSnapshot_T, score) );
+	playerInfoLayout.AddField( NETFIELD_INT32, offsetof(PlayerInfoSnapshot_T, kills) );
+	playerInfoLayout.AddField( NETFIELD_INT32, offsetof(PlayerInfoSnapshot_T, gunHits) );
+	playerInfoLayout.AddField( NETFIELD_INT32, offsetof(PlayerInfoSnapshot_T, missileHits) );
+
 	netSession->netObjectSystem->RegisterObjectType( playerInfoType );
 
 
@@ -379,7 +413,7 @@ void TheGame::UpdateMyCallsign( const std::string& name ) {
 		msg.WriteValue<uint8_t>( myInfo->GetConnectionID() );
 		msg.WriteString( myInfo->GetName().c_str() );
 		netSession->GetHostConnection()->Send( msg );
-		Logger::PrintTaggedf("DevConsole", "Sent name change request %s", myInfo->GetName().c_str());
+		LOG_TAGGEDF("DevConsole", "Sent name change request %s", myInfo->GetName().c_str());
 	}
 }
 
@@ -506,7 +540,7 @@ bool ChangePlayerNameCB( NetMessage& message, NetConnection& sender ) {
 
 	// If a client requested this name change, forward that to all connected clients
 	if ( session->AmIHost() ) {
-		Logger::PrintTaggedf("Net", "Received a player name change from client %s", newName.c_str());
+		LOG_TAGGEDF("Net", "Received a player name change from client %s", newName.c_str());
 		session->SendToAllOtherConnections( message );
 	} 
 
@@ -580,6 +614,7 @@ void SendEntityCreate( NetMessage* msg, void* obj ) {
 
 	msg->WriteValue<int>( ent->def.GetID() );
 	msg->WriteValue<uint8_t>( ent->controller->connectionID );
+	msg->WriteValue<float>( ent->GetAge() );
 	ent->currentState.WriteToBytePacker( msg );
 }
 
@@ -590,9 +625,11 @@ void* RecvEntityCreate( NetMessage* msg ) {
 	EntitySnapshot_T entityState;
 	int defID;
 	uint8_t connectionID;
+	float age;
 
 	msg->ReadValue<int>( &defID );
 	msg->ReadValue<uint8_t>( &connectionID );
+	msg->ReadValue<float>( &age );
 	entityState.ReadFromBytePacker(msg);
 
 
@@ -607,6 +644,7 @@ void* RecvEntityCreate( NetMessage* msg ) {
 	Entity* ent = TheGame::GetMultiplayerStateAsClient()->CreateEntityFromNet( entityState.id, defID, controller );
 
 	ent->currentState = entityState;
+	ent->SetAge( age );
 
 	TheGame::GetMultiplayerStateAsClient()->entities[entityState.id] = ent;
 	ent->Spawn();
@@ -631,12 +669,14 @@ void RecvEntityDestroy( NetMessage* msg, void* obj ) {
 
 //----------------------------------------------------------------------------------------------------------------
 void GetEntitySnapshot( void*& snapshot, void* obj ) {
-	EntitySnapshot_T* ss = new EntitySnapshot_T();
+	if ( snapshot == nullptr ) {
+		snapshot = new EntitySnapshot_T();
+	}
+
+	EntitySnapshot_T* ss = (EntitySnapshot_T*) snapshot;
 	Entity* entity = (Entity*) obj;
-	entity->currentState.timestamp = g_theGame->m_gameClock->GetCurrentTimeSeconds();
 
 	*ss = entity->currentState;
-	snapshot = ss;
 }
 
 
@@ -660,7 +700,14 @@ void RecvEntitySnapshot( NetMessage* msg, void* snapshot ) {
 void ApplyEntitySnapshot( void* snapshot, void* obj, float snapshotAge ) {
 	EntitySnapshot_T* ss = (EntitySnapshot_T*) snapshot;
 	Entity* entity = (Entity*) obj;
-	entity->UpdateLastReceivedSnapshot( ss, g_theGame->m_gameClock->GetCurrentTimeSeconds() - ss->timestamp );
+	entity->UpdateLastReceivedSnapshot( ss, snapshotAge );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+Vector3 GetEntityPosition( void* obj ) {
+	Entity* entity = (Entity*) obj;
+	return entity->currentState.position;
 }
 
 
@@ -705,15 +752,17 @@ void RecvPlayerInfoDestroy( NetMessage* msg, void* obj ) {
 
 //----------------------------------------------------------------------------------------------------------------
 void GetPlayerInfoSnapshot( void*& snapshot, void* obj ) {
-	PlayerInfoSnapshot_T* ss = new PlayerInfoSnapshot_T();
+	if ( snapshot == nullptr ) {
+		snapshot = new PlayerInfoSnapshot_T();
+	}
+
+	PlayerInfoSnapshot_T* ss = (PlayerInfoSnapshot_T*) snapshot;
 	PlayerInfo* playerInfo = (PlayerInfo*) obj;
 
 	ss->kills = playerInfo->GetKills();
 	ss->gunHits = playerInfo->GetGunHits();
 	ss->missileHits = playerInfo->GetMissileHits();
 	ss->score = playerInfo->GetScore();
-
-	snapshot = ss;
 }
 
 
@@ -3,10 +3,14 @@
 #define MAX_LIGHTS 8
 
 uniform mat4 MODEL;
-uniform mat4 VIEW;
 
-uniform vec3 EYE_POSITION;
-uniform vec3 EYE_DIRECTION;
+layout(std140, binding = 2) uniform CameraBlock {
+	mat4 VIEW;
+	mat4 PROJECTION;
+	mat4 CAMERA;
+	vec3 EYE_POSITION;
+	vec3 EYE_DIRECTION;
+};
 
 uniform vec4 AMBIENT_COLOR;
 uniform float AMBIENT_INTENSITY;
@@ -27,9 +31,12 @@ uniform mat4 SHADOW_INVERSE_VP[MAX_LIGHTS];
 uniform float SPECULAR_POWER;
 uniform float SPECULAR_AMOUNT;
 
-uniform float MAX_FOG_DISTANCE;
-uniform float FOG_FACTOR;
-uniform vec4 FOG_COLOR;
+layout(std140, binding = 1) uniform FrameBlock {
+	float TIME_IN_SECONDS;
+	float MAX_FOG_DISTANCE;
+	float FOG_FACTOR;
+	vec4 FOG_COLOR;
+};
 
 layout(binding = 0) uniform sampler2D gTexDiffuse;
 layout(binding = 1) uniform sampler2D gTexNormal;
@@ -12,6 +12,7 @@
 #include "Engine/Profiler/Profiler.hpp"
 #include "Engine/Profiler/ProfilerWindow.hpp"
 #include "Game/GameDebug.hpp"
+#include "Game/Map/MapGeometryCompiler.hpp"
 
 typedef void (*windows_message_handler_cb)( unsigned int msg, size_t wparam, size_t lparam ); 
 
@@ -69,6 +70,10 @@ void App::Run() {
 		g_theInputSystem->EndFrame();
 
 	}
+	Profiler::Shutdown();
+
+	// Nothing draws after this, and the GL context is still up to free the buffers
+	MapGeometryCompiler::ClearCache();
 	DebugRenderShutdown();
 	void (*fncptr)( unsigned int msg, size_t wparam, size_t lparam ) = GetMessages;
 	Window::GetInstance()->UnregisterHandler(fncptr);
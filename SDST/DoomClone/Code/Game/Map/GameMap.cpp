@@ -1,11 +1,16 @@
 #include "Game/GameCommon.hpp"
 #include "Game/Map/GameMap.hpp"
+#include "Game/Map/MapGeometryCompiler.hpp"
 #include "Game/EntityDefinition.hpp"
 #include "Game/Entity.hpp"
 
+#include "Engine/Math/MathUtils.hpp"
 #include "Engine/Renderer/MeshBuilder.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 
+#include <algorithm>
+#include <math.h>
+
 
 struct LightComparisonData {
 	unsigned int index;
@@ -67,6 +72,10 @@ GameMap::~GameMap() {
 	m_minimapCamera = nullptr;
 	delete m_minimapRenderable;
 	m_minimapRenderable = nullptr;
+	for (unsigned int renderableIndex = 0; renderableIndex < m_tileRenderables.size(); renderableIndex++) {
+		delete m_tileRenderables[renderableIndex];
+	}
+	m_tileRenderables.clear();
 	delete m_playerCamera;
 	m_playerCamera = nullptr;
 	delete m_forwardRenderPath;
@@ -107,198 +116,27 @@ void GameMap::SpawnPlayer( Player* playerFromPlayState ) {
 	player = playerFromPlayState;
 	player->m_position = m_playerSpawn;
 	m_entities.push_back(player);
+
+	// The player is the last entity added, and the first Update needs the index for collisions
+	RebuildEntityIndex();
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
+// The merged meshes are shared with the compiler's cache, only the renderables are the map's. Each one sits at its
+// region's center, which is where its lights are picked from.
 void GameMap::AddTileMeshesToScene() {
+	const MapGeometry_T* geometry = MapGeometryCompiler::GetOrCompile( m_tiles, m_dimensions );
 
-	for (int col = 0; col < m_dimensions.x; col++) {
-		for (int row = 0; row < m_dimensions.y; row++) {
-			if (IsTileVisible( IntVector2( col, row ) )) {
-
-				Renderable* tileRenderable = new Renderable();
-				Mesh* tileMesh = new Mesh();
-				tileRenderable->SetMaterial(g_theRenderer->GetMaterial("tile"));
-				tileRenderable->SetMesh(tileMesh);
-
-				MeshBuilder mb;
-				mb.Begin(TRIANGLES, false);
-
-				TileDefinition* currentDef = m_tiles[row * m_dimensions.x + col];
-				if (currentDef->IsSolid()) {
-					AABB2 wallUVs = currentDef->GetWallUVs();
-
-					// front
-					mb.SetNormal(Vector3::FORWARD * -1.f);
-					mb.SetTangent(Vector3::RIGHT);
-					// bl
-					mb.SetUV(Vector2(wallUVs.mins.x, wallUVs.mins.y));
-					mb.PushVertex(Vector3(0.f, 0.f, 0.f));
-
-					// br
-					mb.SetUV(Vector2(wallUVs.maxs.x, wallUVs.mins.y));
-					mb.PushVertex(Vector3(1.f, 0.f, 0.f));
-
-					// tl
-					mb.SetUV(Vector2(wallUVs.mins.x, wallUVs.maxs.y));
-					mb.PushVertex(Vector3(0.f, 1.f, 0.f));
-
-					// br
-					mb.SetUV(Vector2(wallUVs.maxs.x, wallUVs.mins.y));
-					mb.PushVertex(Vector3(1.f, 0.f, 0.f));
-
-					// tr 
-					mb.SetUV(Vector2(wallUVs.maxs.x, wallUVs.maxs.y));
-					mb.PushVertex(Vector3(1.f, 1.f, 0.f));
-					// tl
-					mb.SetUV(Vector2(wallUVs.mins.x, wallUVs.maxs.y));
-					mb.PushVertex(Vector3(0.f, 1.f, 0.f));
-
-					// left
-					mb.SetNormal(Vector3::RIGHT * -1.f);
-					mb.SetTangent(Vector3::FORWARD);
-					// bl
-					mb.SetUV(Vector2(wallUVs.mins.x, wallUVs.mins.y));
-					mb.PushVertex(Vector3(0.f, 0.f, 0.f));
-
-					// br
-					mb.SetUV(Vector2(wallUVs.maxs.x, wallUVs.mins.y));
-					mb.PushVertex(Vector3(0.f, 0.f, 1.f));
-
-					// tl
-					mb.SetUV(Vector2(wallUVs.mins.x, wallUVs.maxs.y));
-					mb.PushVertex(Vector3(0.f, 1.f, 0.f));
-
-					// br
-					mb.SetUV(Vector2(wallUVs.maxs.x, wallUVs.mins.y));
-					mb.PushVertex(Vector3(0.f, 0.f, 1.f));
-
-					// tr 
-					mb.SetUV(Vector2(wallUVs.maxs.x, wallUVs.maxs.y));
-					mb.PushVertex(Vector3(0.f, 1.f, 1.f));
-					// tl
-					mb.SetUV(Vector2(wallUVs.mins.x, wallUVs.maxs.y));
-					mb.PushVertex(Vector3(0.f, 1.f, 0.f));
-
-					// right
-					mb.SetNormal(Vector3::RIGHT);
-					mb.SetTangent(Vector3::FORWARD * -1.f);
-					// bl
-					mb.SetUV(Vector2(wallUVs.mins.x, wallUVs.mins.y));
-					mb.PushVertex(Vector3(1.f, 0.f, 0.f));
-
-					// br
-					mb.SetUV(Vector2(wallUVs.maxs.x, wallUVs.mins.y));
-					mb.PushVertex(Vector3(1.f, 0.f, 1.f));
-
-					// tl
-					mb.SetUV(Vector2(wallUVs.mins.x, wallUVs.maxs.y));
-					mb.PushVertex(Vector3(1.f, 1.f, 0.f));
-
-					// br
-					mb.SetUV(Vector2(wallUVs.maxs.x, wallUVs.mins.y));
-					mb.PushVertex(Vector3(1.f, 0.f, 1.f));
-
-					// tr 
-					mb.SetUV(Vector2(wallUVs.maxs.x, wallUVs.maxs.y));
-					mb.PushVertex(Vector3(1.f, 1.f, 1.f));
-					// tl
-					mb.SetUV(Vector2(wallUVs.mins.x, wallUVs.maxs.y));
-					mb.PushVertex(Vector3(1.f, 1.f, 0.f));
-
-					// back
-					mb.SetNormal(Vector3::FORWARD);
-					mb.SetTangent(Vector3::RIGHT * -1.f);
-					//bl
-					mb.SetUV(Vector2(wallUVs.mins.x, wallUVs.mins.y));
-					mb.PushVertex(Vector3(0.f, 0.f, 1.f));
-
-					// br
-					mb.SetUV(Vector2(wallUVs.maxs.x, wallUVs.mins.y));
-					mb.PushVertex(Vector3(1.f, 0.f, 1.f));
-
-					// tl
-					mb.SetUV(Vector2(wallUVs.mins.x, wallUVs.maxs.y));
-					mb.PushVertex(Vector3(0.f, 1.f, 1.f));
-
-					// br
-					mb.SetUV(Vector2(wallUVs.maxs.x, wallUVs.mins.y));
-					mb.PushVertex(Vector3(1.f, 0.f, 1.f));
-
-					// tr 
-					mb.SetUV(Vector2(wallUVs.maxs.x, wallUVs.maxs.y));
-					mb.PushVertex(Vector3(1.f, 1.f, 1.f));
-					// tl
-					mb.SetUV(Vector2(wallUVs.mins.x, wallUVs.maxs.y));
-					mb.PushVertex(Vector3(0.f, 1.f, 1.f));
-
-				}
-				else {
-
-					AABB2 floorUVs = currentDef->GetFloorUVs();
-					AABB2 ceilingUVs = currentDef->GetCeilingUVs();
-
-					// front
-					mb.SetNormal(Vector3::UP);
-					mb.SetTangent(Vector3::RIGHT);
-					// bl
-					mb.SetUV(Vector2(floorUVs.mins.x, floorUVs.mins.y));
-					mb.PushVertex(Vector3(0.f, 0.f, 0.f));
-
-					// br
-					mb.SetUV(Vector2(floorUVs.maxs.x, floorUVs.mins.y));
-					mb.PushVertex(Vector3(1.f, 0.f, 0.f));
-
-					// tl
-					mb.SetUV(Vector2(floorUVs.mins.x, floorUVs.maxs.y));
-					mb.PushVertex(Vector3(0.f, 0.f, 1.f));
-
-					// br
-					mb.SetUV(Vector2(floorUVs.maxs.x, floorUVs.mins.y));
-					mb.PushVertex(Vector3(1.f, 0.f, 0.f));
-
-					// tr 
-					mb.SetUV(Vector2(floorUVs.maxs.x, floorUVs.maxs.y));
-					mb.PushVertex(Vector3(1.f, 0.f, 1.f));
-
-					// tl
-					mb.SetUV(Vector2(floorUVs.mins.x, floorUVs.maxs.y));
-					mb.PushVertex(Vector3(0.f, 0.f, 1.f));
-
-					mb.SetNormal(Vector3::UP * -1.f);
-					mb.SetTangent(Vector3::RIGHT * -1.f);
-					// bl
-					mb.SetUV(Vector2(ceilingUVs.mins.x, ceilingUVs.mins.y));
-					mb.PushVertex(Vector3(0.f, 1.f, 0.f));
-
-					// br
-					mb.SetUV(Vector2(ceilingUVs.maxs.x, ceilingUVs.mins.y));
-					mb.PushVertex(Vector3(1.f, 1.f, 0.f));
-
-					// tl
-					mb.SetUV(Vector2(ceilingUVs.mins.x, ceilingUVs.maxs.y));
-					mb.PushVertex(Vector3(0.f, 1.f, 1.f));
-
-					// br
-					mb.SetUV(Vector2(ceilingUVs.maxs.x, ceilingUVs.mins.y));
-					mb.PushVertex(Vector3(1.f, 1.f, 0.f));
-
-					// tr 
-					mb.SetUV(Vector2(ceilingUVs.maxs.x, ceilingUVs.maxs.y));
-					mb.PushVertex(Vector3(1.f, 1.f, 1.f));
-
-					// tl
-					mb.SetUV(Vector2(ceilingUVs.mins.x, ceilingUVs.maxs.y));
-					mb.PushVertex(Vector3(0.f, 1.f, 1.f));
-				}
+	for (unsigned int batchIndex = 0; batchIndex < geometry->batches.size(); batchIndex++) {
+		const MapGeometryBatch_T& batch = geometry->batches[batchIndex];
 
-				tileRenderable->SetModelMatrix(Matrix44::MakeTranslation(Vector3((float) col, 0.f, (float) row)));
-				mb.End();
-				tileMesh->FromBuilderAsType<Vertex3D_Lit>(&mb);
-				scene->AddRenderable(tileRenderable);
-			}
-		}
+		Renderable* tileRenderable = new Renderable();
+		tileRenderable->SetModelMatrix(Matrix44::MakeTranslation(batch.origin));
+		tileRenderable->SetMesh(batch.mesh);
+		tileRenderable->SetMaterial(g_theRenderer->GetMaterial(batch.materialName));
+		scene->AddRenderable(tileRenderable);
+		m_tileRenderables.push_back(tileRenderable);
 	}
 }
 
@@ -337,19 +175,21 @@ void GameMap::Update() {
 		m_isMinimapZoomed = !m_isMinimapZoomed;
 	}
 
+	// The index is from the end of last frame, and the margin covers what collisions push before entities shoot
 	CorrectEntityCollisions();
-	
 	for (unsigned int entityIndex = 0; entityIndex < m_entities.size(); entityIndex++) {
 		m_entities[entityIndex]->Update();
 	}
 
+	// Deleting swaps entities around, so it goes before the sort, and the index is built once for the final order
+	DeleteDeadEntities();
 	SortEntitiesByDistanceToPlayer();
+	RebuildEntityIndex();
+
 	m_playerCamera->transform.position = Vector3(player->m_position.x, 0.5f, player->m_position.y);
 	m_playerCamera->transform.euler.y = -player->m_orientationDegrees + 90.f;
 	m_playerCamera->Update();
 
-	DeleteDeadEntities();
-
 	m_playerLight->SetAsSpotLight(Vector3(player->m_position.x, 1.f, player->m_position.y),m_playerCamera->GetForward(), 15.f, 20.f, Rgba());
 }
 
@@ -503,16 +343,33 @@ void GameMap::SetClosestLightsToPoint( Vector3 const& point ) const {
 
 
 //----------------------------------------------------------------------------------------------------------------
+// Only entities sharing a tile can touch. A pair that shares several tiles is handled in the first one, the min corner
+// of where their ranges overlap, and only from the entity with the lower index, so each pair is corrected once.
 void GameMap::CorrectEntityCollisions() {
 
 	for (unsigned int entityIndex = 0; entityIndex < m_entities.size(); entityIndex++) {
 		Entity* thisEntity = m_entities[entityIndex];
+		if (!thisEntity->IsAlive() || !thisEntity->IsSolid()) {
+			continue;
+		}
 
-		if (thisEntity->IsAlive() && thisEntity->IsSolid()) {
-			for(unsigned int otherEntityIndex = 0; otherEntityIndex < m_entities.size(); otherEntityIndex++) {
-				if (entityIndex != otherEntityIndex) {
-					Entity* otherEntity = m_entities[otherEntityIndex];
+		const EntityTileRange_T& thisRange = m_entityTileRanges[entityIndex];
+		for (int row = thisRange.mins.y; row <= thisRange.maxs.y; row++) {
+			for (int col = thisRange.mins.x; col <= thisRange.maxs.x; col++) {
+				unsigned int tileIndex = row * m_dimensions.x + col;
 
+				for (unsigned int bucketIndex = m_entityBucketStarts[tileIndex]; bucketIndex < m_entityBucketStarts[tileIndex + 1]; bucketIndex++) {
+					unsigned int otherEntityIndex = m_entityBuckets[bucketIndex];
+					if (otherEntityIndex <= entityIndex) {
+						continue;
+					}
+
+					const EntityTileRange_T& otherRange = m_entityTileRanges[otherEntityIndex];
+					if (col != Max(thisRange.mins.x, otherRange.mins.x) || row != Max(thisRange.mins.y, otherRange.mins.y)) {
+						continue;
+					}
+
+					Entity* otherEntity = m_entities[otherEntityIndex];
 					if (otherEntity->IsAlive() && otherEntity->IsSolid()) {
 						// check if they are intersecting
 						Vector2 displacement = thisEntity->m_position - otherEntity->m_position;
@@ -535,6 +392,51 @@ void GameMap::CorrectEntityCollisions() {
 }
 
 
+//----------------------------------------------------------------------------------------------------------------
+// A counting sort into one array: count per tile, turn the counts into starts, then fill. Entities go in in order,
+// so each tile's list keeps the m_entities order.
+void GameMap::RebuildEntityIndex() {
+	unsigned int tileCount = (unsigned int) (m_dimensions.x * m_dimensions.y);
+	m_entityBucketStarts.assign(tileCount + 1, 0);
+	m_entityTileRanges.resize(m_entities.size());
+
+	unsigned int entryCount = 0;
+	for (unsigned int entityIndex = 0; entityIndex < m_entities.size(); entityIndex++) {
+		const Entity* entity = m_entities[entityIndex];
+		float reach = entity->m_physicalRadius + ENTITY_INDEX_MARGIN;
+
+		EntityTileRange_T& range = m_entityTileRanges[entityIndex];
+		range.mins.x = ClampInt((int) floorf(entity->m_position.x - reach), 0, m_dimensions.x - 1);
+		range.mins.y = ClampInt((int) floorf(entity->m_position.y - reach), 0, m_dimensions.y - 1);
+		range.maxs.x = ClampInt((int) floorf(entity->m_position.x + reach), 0, m_dimensions.x - 1);
+		range.maxs.y = ClampInt((int) floorf(entity->m_position.y + reach), 0, m_dimensions.y - 1);
+
+		for (int row = range.mins.y; row <= range.maxs.y; row++) {
+			for (int col = range.mins.x; col <= range.maxs.x; col++) {
+				m_entityBucketStarts[row * m_dimensions.x + col + 1]++;
+				entryCount++;
+			}
+		}
+	}
+
+	for (unsigned int tileIndex = 0; tileIndex < tileCount; tileIndex++) {
+		m_entityBucketStarts[tileIndex + 1] += m_entityBucketStarts[tileIndex];
+	}
+
+	// Filled through a copy of the starts, which ends up at each tile's end
+	m_entityBuckets.resize(entryCount);
+	m_entityBucketWritePositions.assign(m_entityBucketStarts.begin(), m_entityBucketStarts.end() - 1);
+	for (unsigned int entityIndex = 0; entityIndex < m_entities.size(); entityIndex++) {
+		const EntityTileRange_T& range = m_entityTileRanges[entityIndex];
+		for (int row = range.mins.y; row <= range.maxs.y; row++) {
+			for (int col = range.mins.x; col <= range.maxs.x; col++) {
+				m_entityBuckets[m_entityBucketWritePositions[row * m_dimensions.x + col]++] = entityIndex;
+			}
+		}
+	}
+}
+
+
 //----------------------------------------------------------------------------------------------------------------
 Camera* GameMap::GetPlayerCamera() {
 	return m_playerCamera;
@@ -542,57 +444,128 @@ Camera* GameMap::GetPlayerCamera() {
 
 
 //----------------------------------------------------------------------------------------------------------------
+// Farthest first, so the sprites blend back to front. The player is at distance zero and ends up last.
 void GameMap::SortEntitiesByDistanceToPlayer() {
-	for (unsigned int entityIndex = 0; entityIndex < m_entities.size() - 1; entityIndex++) {
-		if (m_entities[entityIndex] != player) {
-			float thisDistanceToPlayer = (player->m_position - m_entities[entityIndex]->m_position).GetLengthSquared();
-			float nextDistanceToPlayer = (player->m_position - m_entities[entityIndex+1]->m_position).GetLengthSquared();
-			if (thisDistanceToPlayer < nextDistanceToPlayer) {
-				Entity* temp = m_entities[entityIndex];
-				m_entities[entityIndex] = m_entities[entityIndex + 1];
-				m_entities[entityIndex + 1] = temp;
-			}
-		}
+	m_entitySortData.resize(m_entities.size());
+	for (unsigned int entityIndex = 0; entityIndex < m_entities.size(); entityIndex++) {
+		m_entitySortData[entityIndex].distanceSquared = (player->m_position - m_entities[entityIndex]->m_position).GetLengthSquared();
+		m_entitySortData[entityIndex].entity = m_entities[entityIndex];
+	}
+
+	std::stable_sort(m_entitySortData.begin(), m_entitySortData.end(), [](const EntitySortData& a, const EntitySortData& b) {
+		return a.distanceSquared > b.distanceSquared;
+	});
+
+	for (unsigned int entityIndex = 0; entityIndex < m_entities.size(); entityIndex++) {
+		m_entities[entityIndex] = m_entitySortData[entityIndex].entity;
 	}
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
+// Amanatides-Woo: walks exactly the tiles the ray passes through, in order, knowing the distance at which it leaves
+// each one. Entities are hit on their physical disc, checked against the ones bucketed in each tile the ray walks
+// through. The nearest disc hit so far is only returned once the ray has left every tile nearer than it, since an
+// entity spanning several tiles can be found before the tile its hit is in.
 RaycastResult GameMap::Raycast( Vector2 const& startPosition, float direction ) const {
-	Vector2 rayStep = Vector2::MakeDirectionAtDegrees(direction) * 0.1f;
-
-	Vector2 currentStep = startPosition + rayStep;
+	Vector2 rayDirection = Vector2::MakeDirectionAtDegrees(direction);
 	RaycastResult result;
 
-	while (!result.hitWall && !result.hitEntity) {
-		// Check wall
-		result.hitWall = IsTileSolid( IntVector2(currentStep) );
-		if (result.hitWall) {
-			result.location = currentStep;
+	IntVector2 tile( (int) floorf(startPosition.x), (int) floorf(startPosition.y) );
+	int stepX = (rayDirection.x > 0.f) ? 1 : -1;
+	int stepY = (rayDirection.y > 0.f) ? 1 : -1;
+
+	// Distance along the ray to the next vertical and horizontal tile edge, and between edges
+	float tDeltaX = (rayDirection.x != 0.f) ? 1.f / fabsf(rayDirection.x) : INFINITY;
+	float tDeltaY = (rayDirection.y != 0.f) ? 1.f / fabsf(rayDirection.y) : INFINITY;
+	float tMaxX = (rayDirection.x > 0.f) ? ((float) tile.x + 1.f - startPosition.x) * tDeltaX : (startPosition.x - (float) tile.x) * tDeltaX;
+	float tMaxY = (rayDirection.y > 0.f) ? ((float) tile.y + 1.f - startPosition.y) * tDeltaY : (startPosition.y - (float) tile.y) * tDeltaY;
+	if (rayDirection.x == 0.f) {
+		tMaxX = INFINITY;
+	}
+	if (rayDirection.y == 0.f) {
+		tMaxY = INFINITY;
+	}
+
+	float tEnter = 0.f;
+	float bestEntityDistance = INFINITY;
+	Entity* bestEntity = nullptr;
+
+	while (true) {
+		// Off the map counts as a wall, maps are meant to be closed anyway
+		bool isOnMap = tile.x >= 0 && tile.y >= 0 && tile.x < m_dimensions.x && tile.y < m_dimensions.y;
+		if (!isOnMap || IsTileSolid(tile)) {
+			if (bestEntity != nullptr && bestEntityDistance <= tEnter) {
+				break;
+			}
+			result.hitWall = true;
+			result.location = startPosition + rayDirection * tEnter;
+			return result;
 		}
 
-		// Check entities
-		result.entity = GetEntityAtPoint( currentStep );
-		if (result.entity != nullptr && result.entity->IsAlive()) {
-			result.hitEntity = true;
-			result.location = currentStep;
+		unsigned int tileIndex = tile.y * m_dimensions.x + tile.x;
+		for (unsigned int bucketIndex = m_entityBucketStarts[tileIndex]; bucketIndex < m_entityBucketStarts[tileIndex + 1]; bucketIndex++) {
+			Entity* entity = m_entities[m_entityBuckets[bucketIndex]];
+			if (!entity->IsAlive()) {
+				continue;
+			}
+
+			// Ray against the disc, from the start to the center: t^2 + 2bt + c = 0
+			Vector2 startToCenter = startPosition - entity->m_position;
+			float b = DotProduct(startToCenter, rayDirection);
+			float c = startToCenter.GetLengthSquared() - entity->m_physicalRadius * entity->m_physicalRadius;
+			float discriminant = b * b - c;
+			if (discriminant < 0.f) {
+				continue;
+			}
+
+			float root = sqrtf(discriminant);
+			float tExitDisc = -b + root;
+			if (tExitDisc < RAYCAST_MIN_DISTANCE) {
+				continue;
+			}
+
+			float tHit = Max(-b - root, RAYCAST_MIN_DISTANCE);
+			if (tHit < bestEntityDistance) {
+				bestEntityDistance = tHit;
+				bestEntity = entity;
+			}
 		}
-		else {
-			result.entity = nullptr;
+
+		float tExit = Min(tMaxX, tMaxY);
+		if (bestEntity != nullptr && bestEntityDistance <= tExit) {
+			break;
 		}
 
-		currentStep = currentStep + rayStep;
+		tEnter = tExit;
+		if (tMaxX < tMaxY) {
+			tile.x += stepX;
+			tMaxX += tDeltaX;
+		}
+		else {
+			tile.y += stepY;
+			tMaxY += tDeltaY;
+		}
 	}
 
+	result.hitEntity = true;
+	result.entity = bestEntity;
+	result.location = startPosition + rayDirection * bestEntityDistance;
 	return result;
 }
 
 
 //----------------------------------------------------------------------------------------------------------------
+// Any entity covering the point is bucketed in the point's tile, so that's the only list to look through
 Entity* GameMap::GetEntityAtPoint( Vector2 const& point ) const {
+	IntVector2 tile( (int) floorf(point.x), (int) floorf(point.y) );
+	if (tile.x < 0 || tile.y < 0 || tile.x >= m_dimensions.x || tile.y >= m_dimensions.y) {
+		return nullptr;
+	}
 
-	for (unsigned int entityIndex = 0; entityIndex < m_entities.size(); entityIndex++) {
-		Entity* current = m_entities[entityIndex];
+	unsigned int tileIndex = tile.y * m_dimensions.x + tile.x;
+	for (unsigned int bucketIndex = m_entityBucketStarts[tileIndex]; bucketIndex < m_entityBucketStarts[tileIndex + 1]; bucketIndex++) {
+		Entity* current = m_entities[m_entityBuckets[bucketIndex]];
 		if ((current->GetPosition() - point).GetLengthSquared() < current->m_physicalRadius * current->m_physicalRadius) {
 			return current;
 		}
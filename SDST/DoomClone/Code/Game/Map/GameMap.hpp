@@ -11,6 +11,10 @@
 #include <vector>
 
 
+#define ENTITY_INDEX_MARGIN 0.25f		// The index is built at the end of Update, then collisions and movement shift entities
+#define RAYCAST_MIN_DISTANCE 0.01f		// The shooter's own disc ends right where its shots start
+
+
 struct RaycastResult {
 	bool hitEntity = false;
 	bool hitWall = false;
@@ -18,6 +22,19 @@ struct RaycastResult {
 	Entity* entity = nullptr;
 };
 
+
+struct EntitySortData {
+	float distanceSquared;
+	Entity* entity;
+};
+
+
+// The tiles an entity's physical disc (plus the margin) covers, inclusive
+struct EntityTileRange_T {
+	IntVector2 mins;
+	IntVector2 maxs;
+};
+
 class GameMap {
 
 public:
@@ -54,6 +71,7 @@ private:
 	void	SpawnEntities( Image const& mapImage );
 	void	SpawnEntityFromIDOnTile( unsigned char id, IntVector2 const& coord );
 	void	CorrectEntityCollisions();
+	void	RebuildEntityIndex();
 
 	void	SortEntitiesByDistanceToPlayer();
 	void	DeleteDeadEntities();
@@ -61,8 +79,16 @@ private:
 	void	SetClosestLightsToPoint( Vector3 const& point ) const;
 
 	std::vector<TileDefinition*> m_tiles;
+	std::vector<Renderable*> m_tileRenderables;
 	std::vector<Entity*> m_entities;
 	IntVector2 m_dimensions;
+
+	// Entities bucketed by tile, for rays and collisions. Rebuilt from scratch once per Update since entities move themselves.
+	std::vector<unsigned int> m_entityBucketStarts;		// Per tile where its entities start in m_entityBuckets, plus one past the end
+	std::vector<unsigned int> m_entityBuckets;			// Indices into m_entities, in m_entities order within each tile
+	std::vector<EntityTileRange_T> m_entityTileRanges;	// Per entity
+	std::vector<unsigned int> m_entityBucketWritePositions;	// Scratch for filling m_entityBuckets, kept to save the allocation
+	std::vector<EntitySortData> m_entitySortData;		// Scratch for the draw order sort, kept to save the allocation
 	Vector2 m_playerSpawn;
 
 	Mesh* m_minimap = nullptr;
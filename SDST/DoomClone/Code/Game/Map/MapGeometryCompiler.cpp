@@ -0,0 +1,346 @@
+#include "Game/Map/MapGeometryCompiler.hpp"
+
+#include "Engine/Core/Time.hpp"
+#include "Engine/Core/Vertex.hpp"
+#include "Engine/DevConsole/DevConsole.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+
+
+std::map<uint64_t, std::vector<MapGeometry_T*>> MapGeometryCompiler::s_cache;
+
+
+//----------------------------------------------------------------------------------------------------------------
+// A wall face as the per tile meshes had it, from the tile's min corner. Strips grow along stripAxis, which is also
+// the way u runs, so the winding and texture direction stay what they were.
+struct WallFace_T {
+	IntVector2 neighborOffset;		// The tile that has to be open for the face to be seen
+	IntVector2 stripStep;
+	Vector3 origin;
+	Vector3 stripAxis;
+	Vector3 normal;
+	Vector3 tangent;
+};
+
+static const WallFace_T WALL_FACES[] = {
+	{ IntVector2(  0, -1 ), IntVector2( 1, 0 ), Vector3( 0.f, 0.f, 0.f ), Vector3( 1.f, 0.f, 0.f ), Vector3(  0.f, 0.f, -1.f ), Vector3(  1.f, 0.f,  0.f ) },	// front
+	{ IntVector2( -1,  0 ), IntVector2( 0, 1 ), Vector3( 0.f, 0.f, 0.f ), Vector3( 0.f, 0.f, 1.f ), Vector3( -1.f, 0.f,  0.f ), Vector3(  0.f, 0.f,  1.f ) },	// left
+	{ IntVector2(  1,  0 ), IntVector2( 0, 1 ), Vector3( 1.f, 0.f, 0.f ), Vector3( 0.f, 0.f, 1.f ), Vector3(  1.f, 0.f,  0.f ), Vector3(  0.f, 0.f, -1.f ) },	// right
+	{ IntVector2(  0,  1 ), IntVector2( 1, 0 ), Vector3( 0.f, 0.f, 1.f ), Vector3( 1.f, 0.f, 0.f ), Vector3(  0.f, 0.f,  1.f ), Vector3( -1.f, 0.f,  0.f ) },	// back
+};
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Everything one region's mesh is built from. maxs is exclusive.
+struct MapGeometryBuild_T {
+	const std::vector<TileDefinition*>* tiles = nullptr;
+	IntVector2 dimensions;
+	IntVector2 regionMins;
+	IntVector2 regionMaxs;
+	std::vector<Vertex3D_LitTiled> vertices;
+	std::vector<unsigned int> indices;
+	std::vector<bool> isMerged;						// Per region tile, for the floor and ceiling rectangles
+	unsigned int quadCount = 0;
+};
+
+
+//----------------------------------------------------------------------------------------------------------------
+static const TileDefinition* GetTile( const MapGeometryBuild_T& build, const IntVector2& coords ) {
+	return (*build.tiles)[coords.y * build.dimensions.x + coords.x];
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Tiles off the map count as solid, nobody stands there to see the outside of the map
+static bool IsOpen( const MapGeometryBuild_T& build, const IntVector2& coords ) {
+	if ( coords.x < 0 || coords.y < 0 || coords.x >= build.dimensions.x || coords.y >= build.dimensions.y ) {
+		return false;
+	}
+	return !GetTile( build, coords )->IsSolid();
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+static bool AreUVsEqual( const AABB2& a, const AABB2& b ) {
+	return a.mins == b.mins && a.maxs == b.maxs;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Where the region's vertices are measured from, the middle of its floor
+static Vector3 GetRegionOrigin( const MapGeometryBuild_T& build ) {
+	return Vector3( (float) ( build.regionMins.x + build.regionMaxs.x ) * 0.5f, 0.f, (float) ( build.regionMins.y + build.regionMaxs.y ) * 0.5f );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// origin is in world space, the vertices are stored relative to the region. uv counts tiles from the bl corner, so
+// the sprite repeats once per tile in both directions.
+static void PushQuad( MapGeometryBuild_T& build, const Vector3& origin, const Vector3& uAxis, const Vector3& vAxis, float uLength, float vLength,
+					  const Vector3& normal, const Vector3& tangent, const AABB2& atlasUVs ) {
+	Vector4 atlasBounds( atlasUVs.mins.x, atlasUVs.mins.y, atlasUVs.maxs.x, atlasUVs.maxs.y );
+	Rgba white;
+
+	Vector3 bl = origin - GetRegionOrigin( build );
+	Vector3 br = origin + uAxis * uLength;
+	Vector3 tl = origin + vAxis * vLength;
+	Vector3 tr = br + vAxis * vLength;
+
+	unsigned int firstVertex = (unsigned int) build.vertices.size();
+	build.vertices.push_back( Vertex3D_LitTiled( bl, white, Vector2( 0.f,	  0.f ),	 normal, tangent, atlasBounds ) );
+	build.vertices.push_back( Vertex3D_LitTiled( br, white, Vector2( uLength, 0.f ),	 normal, tangent, atlasBounds ) );
+	build.vertices.push_back( Vertex3D_LitTiled( tl, white, Vector2( 0.f,	  vLength ), normal, tangent, atlasBounds ) );
+	build.vertices.push_back( Vertex3D_LitTiled( tr, white, Vector2( uLength, vLength ), normal, tangent, atlasBounds ) );
+
+	// bl, br, tl, br, tr, tl, the same winding the per tile meshes used
+	build.indices.push_back( firstVertex + 0 );
+	build.indices.push_back( firstVertex + 1 );
+	build.indices.push_back( firstVertex + 2 );
+	build.indices.push_back( firstVertex + 1 );
+	build.indices.push_back( firstVertex + 3 );
+	build.indices.push_back( firstVertex + 2 );
+	build.quadCount++;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Walks each row (or column) of the region in the face's strip direction and ends the strip wherever the face is
+// hidden or the texture changes
+static void AddWallStrips( MapGeometryBuild_T& build, const WallFace_T& face ) {
+	bool isAlongX = face.stripStep.x != 0;
+	int lineCount = isAlongX ? build.regionMaxs.y - build.regionMins.y : build.regionMaxs.x - build.regionMins.x;
+	int lineLength = isAlongX ? build.regionMaxs.x - build.regionMins.x : build.regionMaxs.y - build.regionMins.y;
+
+	for ( int lineIndex = 0; lineIndex < lineCount; lineIndex++ ) {
+		IntVector2 lineStart = isAlongX ? IntVector2( build.regionMins.x, build.regionMins.y + lineIndex ) : IntVector2( build.regionMins.x + lineIndex, build.regionMins.y );
+
+		IntVector2 stripStart;
+		AABB2 stripUVs;
+		int stripLength = 0;
+
+		// One step past the end closes the last strip
+		for ( int stepIndex = 0; stepIndex <= lineLength; stepIndex++ ) {
+			IntVector2 coords( lineStart.x + face.stripStep.x * stepIndex, lineStart.y + face.stripStep.y * stepIndex );
+
+			bool hasFace = false;
+			AABB2 wallUVs;
+			if ( stepIndex < lineLength ) {
+				const TileDefinition* tile = GetTile( build, coords );
+				hasFace = tile->IsSolid() && IsOpen( build, coords + face.neighborOffset );
+				if ( hasFace ) {
+					wallUVs = tile->GetWallUVs();
+				}
+			}
+
+			if ( stripLength > 0 && ( !hasFace || !AreUVsEqual( wallUVs, stripUVs ) ) ) {
+				Vector3 origin = Vector3( (float) stripStart.x, 0.f, (float) stripStart.y ) + face.origin;
+				PushQuad( build, origin, face.stripAxis, Vector3::UP, (float) stripLength, 1.f, face.normal, face.tangent, stripUVs );
+				stripLength = 0;
+			}
+
+			if ( hasFace ) {
+				if ( stripLength == 0 ) {
+					stripStart = coords;
+					stripUVs = wallUVs;
+				}
+				stripLength++;
+			}
+		}
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Greedy rectangles: grow along x while the texture matches, then grow the whole row along z while it still does
+static void AddFlatRectangles( MapGeometryBuild_T& build, bool isCeiling ) {
+	int regionWidth = build.regionMaxs.x - build.regionMins.x;
+	build.isMerged.assign( regionWidth * ( build.regionMaxs.y - build.regionMins.y ), false );
+
+	for ( int row = build.regionMins.y; row < build.regionMaxs.y; row++ ) {
+		for ( int col = build.regionMins.x; col < build.regionMaxs.x; col++ ) {
+			if ( build.isMerged[( row - build.regionMins.y ) * regionWidth + ( col - build.regionMins.x )] || !IsOpen( build, IntVector2( col, row ) ) ) {
+				continue;
+			}
+
+			const TileDefinition* startTile = GetTile( build, IntVector2( col, row ) );
+			AABB2 uvs = isCeiling ? startTile->GetCeilingUVs() : startTile->GetFloorUVs();
+
+			int width = 1;
+			while ( col + width < build.regionMaxs.x ) {
+				IntVector2 coords( col + width, row );
+				if ( build.isMerged[( row - build.regionMins.y ) * regionWidth + ( coords.x - build.regionMins.x )] || !IsOpen( build, coords ) ) {
+					break;
+				}
+				const TileDefinition* tile = GetTile( build, coords );
+				if ( !AreUVsEqual( uvs, isCeiling ? tile->GetCeilingUVs() : tile->GetFloorUVs() ) ) {
+					break;
+				}
+				width++;
+			}
+
+			int height = 1;
+			bool canGrow = true;
+			while ( canGrow && row + height < build.regionMaxs.y ) {
+				for ( int widthIndex = 0; widthIndex < width; widthIndex++ ) {
+					IntVector2 coords( col + widthIndex, row + height );
+					if ( build.isMerged[( coords.y - build.regionMins.y ) * regionWidth + ( coords.x - build.regionMins.x )] || !IsOpen( build, coords ) ) {
+						canGrow = false;
+						break;
+					}
+					const TileDefinition* tile = GetTile( build, coords );
+					if ( !AreUVsEqual( uvs, isCeiling ? tile->GetCeilingUVs() : tile->GetFloorUVs() ) ) {
+						canGrow = false;
+						break;
+					}
+				}
+				if ( canGrow ) {
+					height++;
+				}
+			}
+
+			for ( int heightIndex = 0; heightIndex < height; heightIndex++ ) {
+				for ( int widthIndex = 0; widthIndex < width; widthIndex++ ) {
+					build.isMerged[( row + heightIndex - build.regionMins.y ) * regionWidth + ( col + widthIndex - build.regionMins.x )] = true;
+				}
+			}
+
+			if ( isCeiling ) {
+				PushQuad( build, Vector3( (float) col, 1.f, (float) row ), Vector3::RIGHT, Vector3::FORWARD, (float) width, (float) height, Vector3::UP * -1.f, Vector3::RIGHT * -1.f, uvs );
+			} else {
+				PushQuad( build, Vector3( (float) col, 0.f, (float) row ), Vector3::RIGHT, Vector3::FORWARD, (float) width, (float) height, Vector3::UP, Vector3::RIGHT, uvs );
+			}
+		}
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+const MapGeometry_T* MapGeometryCompiler::GetOrCompile( const std::vector<TileDefinition*>& tiles, const IntVector2& dimensions ) {
+	uint64_t hash = HashTiles( tiles, dimensions );
+
+	// A collision is practically never, but the other map may still be drawing its meshes, so both stay
+	std::vector<MapGeometry_T*>& sameHash = s_cache[hash];
+	for ( size_t cachedIndex = 0; cachedIndex < sameHash.size(); cachedIndex++ ) {
+		MapGeometry_T* cached = sameHash[cachedIndex];
+		bool isSameMap = cached->dimensions == dimensions && cached->tileIDs.size() == tiles.size();
+		for ( size_t tileIndex = 0; isSameMap && tileIndex < tiles.size(); tileIndex++ ) {
+			isSameMap = cached->tileIDs[tileIndex] == tiles[tileIndex]->GetID();
+		}
+
+		if ( isSameMap ) {
+			DevConsole::Printf( "Map geometry: %d tiles, %u draws and %u triangles from the cache", dimensions.x * dimensions.y,
+				(unsigned int) cached->batches.size(), cached->quadCount * 2 );
+			return cached;
+		}
+	}
+
+	MapGeometry_T* geometry = Compile( tiles, dimensions );
+	geometry->hash = hash;
+	sameHash.push_back( geometry );
+
+	DevConsole::Printf( "Map geometry: %d tiles, %u draws and %u triangles (%u draws and %u triangles per tile), compiled in %.2fms",
+		dimensions.x * dimensions.y, (unsigned int) geometry->batches.size(), geometry->quadCount * 2,
+		geometry->tileDrawCount, geometry->tileTriangleCount, geometry->compileSeconds * 1000.0 );
+	return geometry;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void MapGeometryCompiler::ClearCache() {
+	std::map<uint64_t, std::vector<MapGeometry_T*>>::iterator it = s_cache.begin();
+	while ( it != s_cache.end() ) {
+		for ( MapGeometry_T* geometry : it->second ) {
+			for ( size_t batchIndex = 0; batchIndex < geometry->batches.size(); batchIndex++ ) {
+				delete geometry->batches[batchIndex].mesh;
+			}
+			delete geometry;
+		}
+		it++;
+	}
+	s_cache.clear();
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// 64 bit FNV-1a over the version, the size and every tile's ID. A tile's ID decides everything about its faces.
+uint64_t MapGeometryCompiler::HashTiles( const std::vector<TileDefinition*>& tiles, const IntVector2& dimensions ) {
+	uint64_t hash = 14695981039346656037ULL;
+	const uint64_t prime = 1099511628211ULL;
+
+	int header[3] = { MAP_GEOMETRY_VERSION, dimensions.x, dimensions.y };
+	const unsigned char* headerBytes = (const unsigned char*) header;
+	for ( size_t byteIndex = 0; byteIndex < sizeof( header ); byteIndex++ ) {
+		hash = ( hash ^ headerBytes[byteIndex] ) * prime;
+	}
+
+	for ( size_t tileIndex = 0; tileIndex < tiles.size(); tileIndex++ ) {
+		hash = ( hash ^ tiles[tileIndex]->GetID() ) * prime;
+	}
+	return hash;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+MapGeometry_T* MapGeometryCompiler::Compile( const std::vector<TileDefinition*>& tiles, const IntVector2& dimensions ) {
+	double startTime = GetCurrentTimeSeconds();
+
+	MapGeometry_T* geometry = new MapGeometry_T();
+	geometry->dimensions = dimensions;
+	geometry->tileIDs.reserve( tiles.size() );
+	for ( size_t tileIndex = 0; tileIndex < tiles.size(); tileIndex++ ) {
+		geometry->tileIDs.push_back( tiles[tileIndex]->GetID() );
+	}
+
+	MapGeometryBuild_T build;
+	build.tiles = &tiles;
+	build.dimensions = dimensions;
+
+	// What GameMap used to draw: every tile next to an open one, walls with all four sides, open tiles floor and ceiling
+	for ( int row = 0; row < dimensions.y; row++ ) {
+		for ( int col = 0; col < dimensions.x; col++ ) {
+			IntVector2 coords( col, row );
+			bool isVisible = IsOpen( build, coords + IntVector2( 0, 1 ) ) || IsOpen( build, coords + IntVector2( 0, -1 ) )
+				|| IsOpen( build, coords + IntVector2( 1, 0 ) ) || IsOpen( build, coords + IntVector2( -1, 0 ) );
+			if ( isVisible ) {
+				geometry->tileDrawCount++;
+				geometry->tileTriangleCount += GetTile( build, coords )->IsSolid() ? 8 : 4;
+			}
+		}
+	}
+
+	for ( int regionY = 0; regionY < dimensions.y; regionY += MAP_GEOMETRY_REGION_SIZE ) {
+		for ( int regionX = 0; regionX < dimensions.x; regionX += MAP_GEOMETRY_REGION_SIZE ) {
+			build.regionMins = IntVector2( regionX, regionY );
+			build.regionMaxs = IntVector2( Min( regionX + MAP_GEOMETRY_REGION_SIZE, dimensions.x ), Min( regionY + MAP_GEOMETRY_REGION_SIZE, dimensions.y ) );
+			build.vertices.clear();
+			build.indices.clear();
+			build.quadCount = 0;
+
+			for ( int faceIndex = 0; faceIndex < (int) ( sizeof( WALL_FACES ) / sizeof( WALL_FACES[0] ) ); faceIndex++ ) {
+				AddWallStrips( build, WALL_FACES[faceIndex] );
+			}
+			AddFlatRectangles( build, false );
+			AddFlatRectangles( build, true );
+
+			// Solid all the way through
+			if ( build.quadCount == 0 ) {
+				continue;
+			}
+
+			MapGeometryBatch_T batch;
+			batch.mesh = new Mesh();
+			batch.mesh->SetVertices<Vertex3D_LitTiled>( (unsigned int) build.vertices.size(), build.vertices.data() );
+			batch.mesh->SetIndices( (unsigned int) build.indices.size(), build.indices.data() );
+			batch.mesh->SetDrawPrimitive( TRIANGLES );
+			batch.origin = GetRegionOrigin( build );
+			batch.materialName = MAP_GEOMETRY_MATERIAL;
+			batch.quadCount = build.quadCount;
+
+			geometry->batches.push_back( batch );
+			geometry->quadCount += build.quadCount;
+		}
+	}
+
+	geometry->compileSeconds = GetCurrentTimeSeconds() - startTime;
+	return geometry;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include "Game/Map/TileDefinition.hpp"
+
+#include "Engine/Math/IntVector2.hpp"
+#include "Engine/Math/Vector3.hpp"
+#include "Engine/Renderer/Mesh.hpp"
+
+#include <map>
+#include <stdint.h>
+#include <vector>
+
+
+#define MAP_GEOMETRY_REGION_SIZE 4				// Tiles along each side of a region, each region is one draw. See below.
+#define MAP_GEOMETRY_VERSION 2					// Part of the hash, bump it when the output changes
+#define MAP_GEOMETRY_MATERIAL "tile-merged"		// Every tile shares the one sprite sheet, so one material covers them all
+
+
+//----------------------------------------------------------------------------------------------------------------
+// One region's faces, relative to the region's center on the floor
+struct MapGeometryBatch_T {
+	Mesh* mesh = nullptr;
+	Vector3 origin;								// Where the region's center is in the world, the renderable's translation
+	std::string materialName;
+	unsigned int quadCount = 0;
+};
+
+
+//----------------------------------------------------------------------------------------------------------------
+struct MapGeometry_T {
+	uint64_t hash = 0;
+	IntVector2 dimensions;
+	std::vector<unsigned char> tileIDs;			// Compared on a hash hit, so a collision can't hand back another level
+	std::vector<MapGeometryBatch_T> batches;
+
+	unsigned int quadCount = 0;
+	unsigned int tileDrawCount = 0;				// What drawing every visible tile on its own would have cost
+	unsigned int tileTriangleCount = 0;
+	double compileSeconds = 0.0;
+};
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Turns a tile map into a few big indexed meshes. Walls only get the faces that look into an open tile, runs of
+// the same wall texture along a row or column become one strip, and floors and ceilings are merged into rectangles.
+// Merged faces repeat their sprite with the lit-tiled shader, which wraps the UV into the atlas bounds each vertex
+// carries.
+//
+// Each draw gets the MAX_LIGHTS lights that rank highest from its renderable's position, which for a region is its
+// center. Tiles used to be drawn one at a time and pick their own, so regions are kept small enough that a region's
+// eight lights are the ones its tiles would have picked unless more than eight lights crowd within a few tiles.
+//
+// Results are cached by a hash of the tiles for the rest of the session, so restarting or coming back to a level
+// doesn't build anything. The meshes belong to the cache, and an entry is never replaced while the game runs, so
+// maps can keep pointing at them. ClearCache frees them all and is only for shutdown, once nothing draws anymore.
+class MapGeometryCompiler {
+
+public:
+	static const MapGeometry_T* GetOrCompile( const std::vector<TileDefinition*>& tiles, const IntVector2& dimensions );
+	static void ClearCache();
+
+private:
+	static uint64_t HashTiles( const std::vector<TileDefinition*>& tiles, const IntVector2& dimensions );
+	static MapGeometry_T* Compile( const std::vector<TileDefinition*>& tiles, const IntVector2& dimensions );
+
+	static std::map<uint64_t, std::vector<MapGeometry_T*>> s_cache;		// Every map that landed on the hash
+};
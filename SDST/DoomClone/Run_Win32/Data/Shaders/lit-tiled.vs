@@ -0,0 +1,52 @@
+#version 420 core
+
+#define MAX_LIGHTS 8
+
+uniform mat4 MODEL;
+
+layout(std140, binding = 2) uniform CameraBlock {
+	mat4 VIEW;
+	mat4 PROJECTION;
+	mat4 CAMERA;
+	vec3 EYE_POSITION;
+	vec3 EYE_DIRECTION;
+};
+
+uniform vec3 UP;
+
+uniform vec4 AMBIENT_COLOR;
+uniform float AMBIENT_INTENSITY;
+
+in vec3 POSITION;
+in vec4 COLOR;
+in vec2 UV;
+in vec3 NORMAL;
+in vec3 TANGENT;
+in vec4 ATLAS_BOUNDS;
+
+out vec2 passUV;
+out vec3 passNormal;
+out vec3 passTangent;
+out vec3 passBitangent;
+out vec4 passColor;
+out vec4 passWorldPos;
+out mat4 passView;
+out vec4 passAtlasBounds;
+
+
+void main (void) {
+
+	vec4 localPosition = vec4(POSITION, 1);
+
+	passUV = UV;
+	passColor = COLOR;
+	passNormal = NORMAL;
+	passTangent = TANGENT;
+	passBitangent = cross(TANGENT, NORMAL);
+	passWorldPos = MODEL * localPosition;
+	passView = VIEW;
+	passAtlasBounds = ATLAS_BOUNDS;
+
+	gl_Position = PROJECTION * VIEW * MODEL * localPosition;
+
+}
\ No newline at end of file
@@ -3,8 +3,15 @@
 #define MAX_LIGHTS 8
 
 uniform mat4 MODEL;
-uniform mat4 VIEW;
-uniform mat4 PROJECTION;
+
+layout(std140, binding = 2) uniform CameraBlock {
+	mat4 VIEW;
+	mat4 PROJECTION;
+	mat4 CAMERA;
+	vec3 EYE_POSITION;
+	vec3 EYE_DIRECTION;
+};
+
 uniform vec3 UP;
 
 uniform vec4 AMBIENT_COLOR;
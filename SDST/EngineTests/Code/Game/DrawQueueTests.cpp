@@ -0,0 +1,139 @@
+#include "Game/UnitTest.hpp"
+#include "Engine/Renderer/DrawQueue.hpp"
+#include "Engine/Renderer/ForwardRenderPath.hpp"
+
+#include <stdio.h>
+#include <vector>
+
+
+//----------------------------------------------------------------------------------------------------------------
+// The queue only compares material and mesh addresses, so these never touch GL
+static DrawCall MakeTestDrawCall( Material* material, Mesh* mesh, int queue, const Vector3& position, unsigned int lightIndex ) {
+	DrawCall drawCall;
+	drawCall.m_model = Matrix44::MakeTranslation( position );
+	drawCall.m_material = material;
+	drawCall.m_mesh = mesh;
+	drawCall.m_lightCount = 1;
+	drawCall.m_lightIndices[0] = lightIndex;
+	drawCall.m_layer = 0;
+	drawCall.m_queue = queue;
+	return drawCall;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+static void AddTestDrawCall( DrawQueue& drawQueue, const DrawCall& drawCall ) {
+	drawQueue.Add( drawCall, drawCall.m_model.GetTranslation().GetLengthSquared() );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+UNIT_TEST( DrawQueue_OpaqueFirstThenAlphaBackToFront ) {
+	Shader* noShader = nullptr;
+	Material material( noShader );
+	Mesh mesh;
+
+	DrawQueue drawQueue;
+	AddTestDrawCall( drawQueue, MakeTestDrawCall( &material, &mesh, DRAW_QUEUE_ALPHA, Vector3( 0.f, 0.f, 10.f ), 0 ) );
+	AddTestDrawCall( drawQueue, MakeTestDrawCall( &material, &mesh, 0, Vector3( 0.f, 0.f, 50.f ), 0 ) );
+	AddTestDrawCall( drawQueue, MakeTestDrawCall( &material, &mesh, DRAW_QUEUE_ALPHA, Vector3( 0.f, 0.f, 30.f ), 0 ) );
+	AddTestDrawCall( drawQueue, MakeTestDrawCall( &material, &mesh, 0, Vector3( 0.f, 0.f, 5.f ), 0 ) );
+	AddTestDrawCall( drawQueue, MakeTestDrawCall( &material, &mesh, DRAW_QUEUE_ALPHA, Vector3( 0.f, 0.f, 20.f ), 0 ) );
+	drawQueue.Sort();
+
+	// Opaque front to back, alpha farthest first
+	const float expectedDistances[] = { 5.f, 50.f, 30.f, 20.f, 10.f };
+	const int expectedQueues[] = { 0, 0, DRAW_QUEUE_ALPHA, DRAW_QUEUE_ALPHA, DRAW_QUEUE_ALPHA };
+	TEST_CHECK( drawQueue.GetDrawCount() == 5 );
+	for ( int sortedIndex = 0; sortedIndex < drawQueue.GetDrawCount(); sortedIndex++ ) {
+		const DrawCall& drawCall = drawQueue.GetSortedDraw( sortedIndex );
+		TEST_CHECK( drawCall.m_queue == expectedQueues[ sortedIndex ] );
+		TEST_CHECK_NEAR( drawCall.m_model.GetTranslation().z, expectedDistances[ sortedIndex ], 0.001f );
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+UNIT_TEST( DrawQueue_SubmitMergesRunsIntoBatches ) {
+	Shader* noShader = nullptr;
+	Material materialA( noShader );
+	Material materialB( noShader );
+	Mesh meshA;
+	Mesh meshB;
+
+	// Three of A/A sharing a light, one of A/A with another light, two of A/B, one of B/A
+	DrawQueue drawQueue;
+	AddTestDrawCall( drawQueue, MakeTestDrawCall( &materialA, &meshA, 0, Vector3( 1.f, 0.f, 0.f ), 0 ) );
+	AddTestDrawCall( drawQueue, MakeTestDrawCall( &materialA, &meshB, 0, Vector3( 2.f, 0.f, 0.f ), 0 ) );
+	AddTestDrawCall( drawQueue, MakeTestDrawCall( &materialB, &meshA, 0, Vector3( 3.f, 0.f, 0.f ), 0 ) );
+	AddTestDrawCall( drawQueue, MakeTestDrawCall( &materialA, &meshA, 0, Vector3( 4.f, 0.f, 0.f ), 0 ) );
+	AddTestDrawCall( drawQueue, MakeTestDrawCall( &materialA, &meshB, 0, Vector3( 5.f, 0.f, 0.f ), 0 ) );
+	AddTestDrawCall( drawQueue, MakeTestDrawCall( &materialA, &meshA, 0, Vector3( 6.f, 0.f, 0.f ), 0 ) );
+	AddTestDrawCall( drawQueue, MakeTestDrawCall( &materialA, &meshA, 0, Vector3( 7.f, 0.f, 0.f ), 3 ) );
+	drawQueue.Sort();
+
+	RecordingDrawBackend backend;
+	drawQueue.Submit( &backend );
+
+	TEST_CHECK( backend.GetCount( DRAW_COMMAND_BIND_MATERIAL ) == 2 );
+	TEST_CHECK( backend.GetCount( DRAW_COMMAND_BIND_MESH ) == 3 );
+	TEST_CHECK( backend.GetCount( DRAW_COMMAND_DRAW ) == 4 );
+	TEST_CHECK( backend.GetInstanceCount() == 7 );
+
+	// Light 3 sorts by depth with the others, so it splits the A/A run in two: 1 4 6 | 7
+	int batchSizes[4] = { 0, 0, 0, 0 };
+	int batchIndex = 0;
+	for ( const DrawCommand_T& drawCommand : backend.GetCommands() ) {
+		if ( drawCommand.type == DRAW_COMMAND_DRAW && batchIndex < 4 ) {
+			batchSizes[ batchIndex++ ] = drawCommand.instanceCount;
+		}
+	}
+	TEST_CHECK( batchSizes[0] == 3 );
+	TEST_CHECK( batchSizes[1] == 1 );
+	TEST_CHECK( batchSizes[2] == 2 );
+	TEST_CHECK( batchSizes[3] == 1 );
+
+	// Instances come out in sorted order
+	const float expectedX[] = { 1.f, 4.f, 6.f, 7.f, 2.f, 5.f, 3.f };
+	const std::vector<Matrix44>& models = backend.GetInstanceModels();
+	for ( int instanceIndex = 0; instanceIndex < (int) models.size() && instanceIndex < 7; instanceIndex++ ) {
+		TEST_CHECK_NEAR( models[ instanceIndex ].GetTranslation().x, expectedX[ instanceIndex ], 0.001f );
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// The old sort only guarantees queue order, and put alpha draws front to back
+UNIT_TEST( DrawQueue_LegacySortStillRuns ) {
+	Shader* noShader = nullptr;
+	Material material( noShader );
+	Mesh mesh;
+
+	std::vector<DrawCall> drawCalls;
+	drawCalls.push_back( MakeTestDrawCall( &material, &mesh, DRAW_QUEUE_ALPHA, Vector3( 0.f, 0.f, 30.f ), 0 ) );
+	drawCalls.push_back( MakeTestDrawCall( &material, &mesh, 0, Vector3( 0.f, 0.f, 5.f ), 0 ) );
+	drawCalls.push_back( MakeTestDrawCall( &material, &mesh, DRAW_QUEUE_ALPHA, Vector3( 0.f, 0.f, 10.f ), 0 ) );
+	ForwardRenderPath::SortDrawCallsLegacy( drawCalls, Vector3::ZERO );
+
+	TEST_CHECK( drawCalls[0].m_queue == 0 );
+	TEST_CHECK_NEAR( drawCalls[1].m_model.GetTranslation().z, 10.f, 0.001f );
+	TEST_CHECK_NEAR( drawCalls[2].m_model.GetTranslation().z, 30.f, 0.001f );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+UNIT_TEST( DrawQueue_Benchmark ) {
+	const int drawCounts[] = { 1000, 5000 };		// The legacy sort is quadratic, 20000 takes seconds
+
+	for ( int drawCount : drawCounts ) {
+		DrawQueueBenchmarkResult_T result = DrawQueue::RunBenchmark( drawCount );
+		double newSortSeconds = result.keyBuildSeconds + result.radixSortSeconds;
+		printf( "    %6d draws: legacy sort %.1fns/draw, key build + radix sort %.1fns/draw (%.1fx), submit %.1fns/draw, %d batches\n", drawCount,
+			result.legacySortSeconds * 1000000000.0 / drawCount, newSortSeconds * 1000000000.0 / drawCount, result.legacySortSeconds / ( newSortSeconds > 0.0 ? newSortSeconds : 0.000000001 ),
+			result.submitSeconds * 1000000000.0 / drawCount, result.drawBatches );
+
+		TEST_CHECK( result.isOrdered );
+		TEST_CHECK( result.drawnInstances == drawCount );
+		TEST_CHECK( result.drawBatches <= drawCount );
+	}
+}
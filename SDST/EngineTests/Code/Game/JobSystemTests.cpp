@@ -0,0 +1,403 @@
+#include "Game/UnitTest.hpp"
+#include "Engine/Async/JobAllocator.hpp"
+#include "Engine/Async/JobSystem.hpp"
+#include "Engine/Async/LockFreeQueue.hpp"
+
+#include <atomic>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+
+//----------------------------------------------------------------------------------------------------------------
+class CountingJob : public Job {
+public:
+	CountingJob( std::atomic<int>* runCount ) : m_runCount( runCount ) {}
+
+	virtual void Execute() override { m_runCount->fetch_add( 1 ); }
+	virtual void OnComplete() override {}
+
+private:
+	std::atomic<int>* m_runCount;
+};
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Submits childCount more jobs from inside a worker, so they go through the worker deques
+class SpawningJob : public Job {
+public:
+	SpawningJob( JobSystem* system, std::atomic<int>* runCount, int childCount )
+		: m_system( system )
+		, m_runCount( runCount )
+		, m_childCount( childCount )
+	{}
+
+	virtual void Execute() override {
+		m_runCount->fetch_add( 1 );
+		for ( int i = 0; i < m_childCount; i++ ) {
+			m_system->SubmitJob( new CountingJob( m_runCount ) );
+		}
+	}
+	virtual void OnComplete() override {}
+
+private:
+	JobSystem* m_system;
+	std::atomic<int>* m_runCount;
+	int m_childCount;
+};
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Set around the main thread's WaitForCounter, a job that finds it set on its own thread was run by the main thread
+static thread_local bool t_isMainThreadWaiting = false;
+
+
+class ForeignJob : public Job {
+public:
+	ForeignJob( std::atomic<int>* runCount, std::atomic<int>* runByMainThreadCount )
+		: m_runCount( runCount )
+		, m_runByMainThreadCount( runByMainThreadCount )
+	{}
+
+	virtual void Execute() override {
+		if ( t_isMainThreadWaiting ) {
+			m_runByMainThreadCount->fetch_add( 1 );
+		}
+		m_runCount->fetch_add( 1 );
+	}
+	virtual void OnComplete() override {}
+
+private:
+	std::atomic<int>* m_runCount;
+	std::atomic<int>* m_runByMainThreadCount;
+};
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Queues a group on its own worker, then unrelated work on top of it, then waits for the group
+class GroupWaitingJob : public Job {
+public:
+	GroupWaitingJob( JobSystem* system, std::atomic<int>* groupRunCount, std::atomic<int>* foreignRunCount, std::atomic<int>* runByMainThreadCount )
+		: m_system( system )
+		, m_groupRunCount( groupRunCount )
+		, m_foreignRunCount( foreignRunCount )
+		, m_runByMainThreadCount( runByMainThreadCount )
+	{}
+
+	virtual void Execute() override {
+		JobCounter counter;
+		for ( int i = 0; i < 50; i++ ) {
+			m_system->SubmitJob( new CountingJob( m_groupRunCount ), &counter );
+		}
+
+		for ( int i = 0; i < 50; i++ ) {
+			m_system->SubmitJob( new ForeignJob( m_foreignRunCount, m_runByMainThreadCount ) );
+		}
+
+		m_system->WaitForCounter( &counter );
+
+		m_isGroupDone = counter.IsDone();
+	}
+	virtual void OnComplete() override {}
+
+	bool m_isGroupDone = false;
+
+private:
+	JobSystem* m_system;
+	std::atomic<int>* m_groupRunCount;
+	std::atomic<int>* m_foreignRunCount;
+	std::atomic<int>* m_runByMainThreadCount;
+};
+
+
+//----------------------------------------------------------------------------------------------------------------
+UNIT_TEST( LockFreeQueue_FIFOAndBounds ) {
+	LockFreeQueue<int, 8> queue;
+	int value = -1;
+
+	TEST_CHECK( queue.IsEmpty() );
+	TEST_CHECK( !queue.Pop( &value ) );
+
+	// Two laps, so every cell gets reused
+	for ( int lap = 0; lap < 2; lap++ ) {
+		for ( int i = 0; i < 8; i++ ) {
+			TEST_CHECK( queue.Push( lap * 100 + i ) );
+		}
+		TEST_CHECK( !queue.Push( 999 ) );
+
+		for ( int i = 0; i < 8; i++ ) {
+			TEST_CHECK( queue.Pop( &value ) && value == lap * 100 + i );
+		}
+		TEST_CHECK( !queue.Pop( &value ) );
+		TEST_CHECK( queue.IsEmpty() );
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Small capacity so producers keep hitting full and consumers keep hitting empty
+UNIT_TEST( LockFreeQueue_ManyProducersManyConsumers ) {
+	const int threadCount = 4;
+	const int valuesPerProducer = 50000;
+	const int totalValues = threadCount * valuesPerProducer;
+
+	LockFreeQueue<int, 64>* queue = new LockFreeQueue<int, 64>();
+	std::vector< std::atomic<int> > seenCounts( totalValues );
+	for ( int i = 0; i < totalValues; i++ ) {
+		seenCounts[i].store( 0 );
+	}
+	std::atomic<int> poppedCount( 0 );
+
+	std::vector<std::thread> threads;
+	for ( int producer = 0; producer < threadCount; producer++ ) {
+		threads.emplace_back( [queue, producer, valuesPerProducer]() {
+			for ( int i = 0; i < valuesPerProducer; i++ ) {
+				while ( !queue->Push( producer * valuesPerProducer + i ) ) {
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+	for ( int consumer = 0; consumer < threadCount; consumer++ ) {
+		threads.emplace_back( [queue, &seenCounts, &poppedCount, totalValues]() {
+			int value = 0;
+			while ( poppedCount.load() < totalValues ) {
+				if ( queue->Pop( &value ) ) {
+					seenCounts[value].fetch_add( 1 );
+					poppedCount.fetch_add( 1 );
+				} else {
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+	for ( unsigned int i = 0; i < threads.size(); i++ ) {
+		threads[i].join();
+	}
+
+	int wrongCount = 0;
+	for ( int i = 0; i < totalValues; i++ ) {
+		if ( seenCounts[i].load() != 1 ) {
+			wrongCount++;
+		}
+	}
+	TEST_CHECK( wrongCount == 0 );
+	TEST_CHECK( queue->IsEmpty() );
+	delete queue;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// More jobs than the injection queue holds, so the submitter has to wait for room
+UNIT_TEST( JobSystem_RunsEveryInjectedJob ) {
+	const int jobCount = JOB_SYSTEM_INJECTION_QUEUE_CAPACITY * 3;
+
+	JobSystem* system = new JobSystem();
+	system->Startup( 4 );
+
+	std::atomic<int> runCount( 0 );
+	JobCounter counter;
+	for ( int i = 0; i < jobCount; i++ ) {
+		system->SubmitJob( new CountingJob( &runCount ), &counter );
+	}
+	system->WaitForCounter( &counter );
+	system->ProcessFinishedJobs();
+
+	TEST_CHECK( runCount.load() == jobCount );
+
+	system->Shutdown();
+	delete system;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Workers park between bursts; every burst still has to run, with nothing polling on a timer
+UNIT_TEST( JobSystem_WakesParkedWorkers ) {
+	JobSystem* system = new JobSystem();
+	system->Startup( 8 );
+
+	std::atomic<int> runCount( 0 );
+	for ( int burst = 0; burst < 20; burst++ ) {
+		std::this_thread::sleep_for( std::chrono::milliseconds( 2 ) );
+
+		JobCounter counter;
+		for ( int i = 0; i <= burst; i++ ) {
+			system->SubmitJob( new CountingJob( &runCount ), &counter );
+		}
+		while ( !counter.IsDone() ) {
+			std::this_thread::yield();
+		}
+		system->ProcessFinishedJobs();
+	}
+
+	TEST_CHECK( runCount.load() == 20 * 21 / 2 );
+
+	system->Shutdown();
+	delete system;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Shutdown right after submitting, including jobs that are still spawning more into full worker deques
+UNIT_TEST( JobSystem_ShutdownDrainsQueuedJobs ) {
+	const int spawnerCount = 16;
+	const int childCount = JOB_SYSTEM_WORKER_QUEUE_CAPACITY + 100;
+
+	JobSystem* system = new JobSystem();
+	system->Startup( 4 );
+
+	std::atomic<int> runCount( 0 );
+	for ( int i = 0; i < spawnerCount; i++ ) {
+		system->SubmitJob( new SpawningJob( system, &runCount, childCount ) );
+	}
+	system->Shutdown();
+
+	TEST_CHECK( runCount.load() == spawnerCount * (childCount + 1) );
+	delete system;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Every waiter's group sits under unrelated jobs on its own deque. With a single worker nobody can steal it, so
+// the waiting worker has to get through the unrelated jobs itself or this never finishes.
+UNIT_TEST( JobSystem_WaitForCounterRunsWhatIsOnTop ) {
+	const int waiterCount = 16;
+	const int workerCounts[] = { 1, 4 };
+
+	for ( int workerCount : workerCounts ) {
+		JobSystem* system = new JobSystem();
+		system->Startup( workerCount );
+
+		std::atomic<int> groupRunCount( 0 );
+		std::atomic<int> foreignRunCount( 0 );
+		std::atomic<int> runByMainThreadCount( 0 );
+
+		JobCounter waiterCounter;
+		std::vector<GroupWaitingJob*> waiters;
+		for ( int i = 0; i < waiterCount; i++ ) {
+			GroupWaitingJob* waiter = new GroupWaitingJob( system, &groupRunCount, &foreignRunCount, &runByMainThreadCount );
+			waiter->SetDeleteWhenComplete( false );
+			waiters.push_back( waiter );
+			system->SubmitJob( waiter, &waiterCounter );
+		}
+
+		// The main thread has no deque, it shouldn't run anything at all while it waits
+		t_isMainThreadWaiting = true;
+		system->WaitForCounter( &waiterCounter );
+		t_isMainThreadWaiting = false;
+		system->Shutdown();
+
+		for ( int i = 0; i < waiterCount; i++ ) {
+			TEST_CHECK( waiters[i]->m_isGroupDone );
+			delete waiters[i];
+		}
+		TEST_CHECK( groupRunCount.load() == waiterCount * 50 );
+		TEST_CHECK( foreignRunCount.load() == waiterCount * 50 );
+		TEST_CHECK( runByMainThreadCount.load() == 0 );
+		delete system;
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+UNIT_TEST( JobSystem_ParallelForCoversRangeOnce ) {
+	JobSystem* system = new JobSystem();
+	system->Startup( 4 );
+
+	const int rangeCount = 5;
+	const int ranges[rangeCount][3] = {
+		// begin, end, grain
+		{ 0, 1, 1 },
+		{ 0, 10, 100 },
+		{ 0, 1000, 1 },
+		{ -37, 9001, 64 },
+		{ 5, 100000, 333 },
+	};
+
+	for ( int rangeIndex = 0; rangeIndex < rangeCount; rangeIndex++ ) {
+		int begin = ranges[rangeIndex][0];
+		int end = ranges[rangeIndex][1];
+		int grainSize = ranges[rangeIndex][2];
+
+		std::vector< std::atomic<int> > hitCounts( end - begin );
+		for ( unsigned int i = 0; i < hitCounts.size(); i++ ) {
+			hitCounts[i].store( 0 );
+		}
+
+		std::atomic<int> oversizedGrainCount( 0 );
+		system->ParallelFor( begin, end, grainSize, [&]( int grainBegin, int grainEnd ) {
+			if ( grainEnd - grainBegin > grainSize ) {
+				oversizedGrainCount.fetch_add( 1 );
+			}
+			for ( int i = grainBegin; i < grainEnd; i++ ) {
+				hitCounts[i - begin].fetch_add( 1 );
+			}
+		});
+
+		int wrongCount = 0;
+		for ( unsigned int i = 0; i < hitCounts.size(); i++ ) {
+			if ( hitCounts[i].load() != 1 ) {
+				wrongCount++;
+			}
+		}
+		if ( wrongCount != 0 || oversizedGrainCount.load() != 0 ) {
+			UnitTestRegistry::ReportFailure( __FILE__, __LINE__, Stringf( "[%d, %d) grain %d: %d indices not hit once, %d grains too big", begin, end, grainSize, wrongCount, oversizedGrainCount.load() ) );
+		}
+	}
+
+	system->Shutdown();
+	delete system;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Helpers and their shared state come from the job pool, not one heap allocation per grain
+UNIT_TEST( JobSystem_ParallelForUsesJobPool ) {
+	JobSystem* system = new JobSystem();
+	system->Startup( 4 );
+
+	std::atomic<int> sum( 0 );
+	auto addRange = [&]( int grainBegin, int grainEnd ) {
+		for ( int i = grainBegin; i < grainEnd; i++ ) {
+			sum.fetch_add( i );
+		}
+	};
+
+	// Warm the pool up first
+	for ( int i = 0; i < 2000; i++ ) {
+		system->ParallelFor( 0, 1000, 10, addRange );
+	}
+
+	int heapAllocationsBefore = JobAllocator::GetHeapAllocationCount();
+	sum.store( 0 );
+	for ( int i = 0; i < 1000; i++ ) {
+		system->ParallelFor( 0, 1000, 10, addRange );
+	}
+	TEST_CHECK( sum.load() == 1000 * (999 * 1000 / 2) );
+
+	// Workers free what the main thread allocates and those slots sit in the worker caches for a while, so a few
+	// more chunks can still get carved while the caches even out. Bounded by what every thread's cache can hold in
+	// the two size classes (helper jobs and shared states), thousands of helpers shouldn't get near it.
+	int chunkAllocations = JobAllocator::GetHeapAllocationCount() - heapAllocationsBefore;
+	int cachedSlotLimit = (system->GetWorkerCount() + 1) * JOB_ALLOCATOR_THREAD_CACHE_LIMIT * 2;
+	TEST_CHECK( chunkAllocations <= cachedSlotLimit / JOB_ALLOCATOR_SLOTS_PER_CHUNK );
+
+	system->Shutdown();
+	delete system;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Same numbers as job_bench, EngineTests.exe JobSystem_Benchmark runs just this
+UNIT_TEST( JobSystem_Benchmark ) {
+	const int jobCount = 50000;
+	const int latencySamples = 256;
+
+	printf( "    %d jobs per run, %d latency samples\n", jobCount, latencySamples );
+	for ( int threadCount = 1; threadCount <= JOB_SYSTEM_MAX_WORKER_THREAD_COUNT; threadCount *= 2 ) {
+		JobBenchmarkResult_T result = JobSystem::RunBenchmark( threadCount, jobCount, latencySamples );
+		printf( "    %2d threads: latency avg %.1fus max %.1fus, %.0f jobs/sec, %d job heap allocations\n", result.threadCount, result.averageLatencySeconds * 1000000.0, result.maxLatencySeconds * 1000000.0, result.jobsPerSecond, result.heapAllocations );
+
+		TEST_CHECK( result.jobsPerSecond > 0.0 );
+	}
+}
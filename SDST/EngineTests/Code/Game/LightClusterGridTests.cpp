@@ -0,0 +1,128 @@
+#include "Game/UnitTest.hpp"
+#include "Engine/Renderer/LightClusterGrid.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+#include <stdio.h>
+#include <vector>
+
+
+//----------------------------------------------------------------------------------------------------------------
+static ClusterLight_T MakeTestLight( const Vector3& position, float intensity, float attenuation ) {
+	ClusterLight_T light;
+	light.position = position;
+	light.intensity = intensity;
+	light.attenuation = attenuation;
+	return light;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// A bright light 200 units out still outweighs eight dim ones close by, it has to reach the position through
+// the grid and come first
+UNIT_TEST( LightCluster_BrightDistantLightBeatsDimNearOnes ) {
+	std::vector<ClusterLight_T> lights;
+	for ( int lightIndex = 0; lightIndex < 8; lightIndex++ ) {
+		lights.push_back( MakeTestLight( Vector3( (float) lightIndex - 4.f, 0.f, 60.f ), 0.5f, 1.f ) );
+	}
+	lights.push_back( MakeTestLight( Vector3( 0.f, 0.f, 250.f ), 50.f, 1.f ) );
+	lights.push_back( MakeTestLight( Vector3( 0.f, 0.f, 300.f ), 0.5f, 1.f ) );		// Under the cutoff at both positions
+
+	Vector3 positions[2] = { Vector3( 0.f, 0.f, 50.f ), Vector3( 0.f, 0.f, 200.f ) };
+	Matrix44 viewProjection = Matrix44::MakeProjection( 60.f, 16.f / 9.f, 0.1f, 1000.f );
+
+	LightClusterGrid grid;
+	grid.Build( viewProjection, lights.data(), (int) lights.size(), positions, 2 );
+	TEST_CHECK( grid.GetClusterIndex( positions[0] ) >= 0 );
+
+	unsigned int indices[8];
+	int count = grid.SelectLights( positions[0], indices, 8 );
+	TEST_CHECK( count == 8 );
+	TEST_CHECK( indices[0] == 8 );
+
+	unsigned int unfilteredIndices[8];
+	int unfilteredCount = LightClusterGrid::SelectLightsUnfiltered( lights.data(), (int) lights.size(), positions[0], unfilteredIndices, 8 );
+	TEST_CHECK( unfilteredCount == count );
+	for ( int slot = 0; slot < count && slot < unfilteredCount; slot++ ) {
+		TEST_CHECK( indices[ slot ] == unfilteredIndices[ slot ] );
+	}
+
+	// Out at 200 the dim lights are all under the cutoff, the unfiltered ranking still fills every slot with them
+	count = grid.SelectLights( positions[1], indices, 8 );
+	TEST_CHECK( count == 1 && indices[0] == 8 );
+	TEST_CHECK( LightClusterGrid::SelectLightsUnfiltered( lights.data(), (int) lights.size(), positions[1], unfilteredIndices, 8 ) == 8 );
+	TEST_CHECK( unfilteredIndices[0] == 8 );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Directional lights and lights without attenuation never drop, however dim
+UNIT_TEST( LightCluster_GlobalLightsAreNeverCutOff ) {
+	ClusterLight_T lights[2];
+	lights[0] = MakeTestLight( Vector3( 0.f, 0.f, 900.f ), 0.001f, 0.f );
+	lights[1] = MakeTestLight( Vector3( 0.f, 0.f, 900.f ), 0.001f, 1.f );
+	lights[1].isPointLight = false;
+
+	Vector3 position( 0.f, 0.f, 10.f );
+	LightClusterGrid grid;
+	grid.Build( Matrix44::MakeProjection( 60.f, 16.f / 9.f, 0.1f, 1000.f ), lights, 2, &position, 1 );
+	TEST_CHECK( grid.GetGlobalLightCount() == 2 );
+
+	unsigned int indices[8];
+	TEST_CHECK( grid.SelectLights( position, indices, 8 ) == 2 );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// In front of a camera at the origin looking down +z, inside a 60 degree cone out to 400 units
+static Vector3 GetRandomPositionInView() {
+	float depth = GetRandomFloatInRange( 1.f, 400.f );
+	float halfWidth = depth * 0.6f;
+	return Vector3( GetRandomFloatInRange( -halfWidth, halfWidth ), GetRandomFloatInRange( -halfWidth, halfWidth ), depth );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Random lights from barely there to bright, checked for both projections. One position in ten is anywhere
+// around the camera, for the brute force fallback.
+UNIT_TEST( LightCluster_MatchesUnfilteredRanking ) {
+	const int lightCount = 512;
+	const int positionCount = 20000;
+	const int maxLights = 8;
+
+	std::vector<ClusterLight_T> lights( lightCount );
+	for ( int lightIndex = 0; lightIndex < lightCount; lightIndex++ ) {
+		ClusterLight_T& light = lights[ lightIndex ];
+		light.position = GetRandomPositionInView();
+		light.intensity = GetRandomFloatInRange( 0.005f, 2.f );
+		light.attenuation = GetRandomFloatInRange( 1.f, 10.f );
+		if ( GetRandomIntLessThan( 64 ) == 0 ) {
+			light.intensity *= 20.f;
+		}
+		light.isPointLight = ( GetRandomIntLessThan( 64 ) != 0 );
+	}
+
+	std::vector<Vector3> positions( positionCount );
+	for ( int positionIndex = 0; positionIndex < positionCount; positionIndex++ ) {
+		if ( GetRandomIntLessThan( 10 ) == 0 ) {
+			positions[ positionIndex ] = Vector3( GetRandomFloatInRange( -400.f, 400.f ), GetRandomFloatInRange( -400.f, 400.f ), GetRandomFloatInRange( -400.f, 400.f ) );
+		}
+		else {
+			positions[ positionIndex ] = GetRandomPositionInView();
+		}
+	}
+
+	Matrix44 viewProjections[2];
+	viewProjections[0] = Matrix44::MakeProjection( 60.f, 16.f / 9.f, 0.1f, 1000.f );
+	viewProjections[1] = Matrix44::MakeOrthographic( -150.f, 150.f, 100.f, -100.f, 400.f, -400.f );
+	const char* cameraNames[2] = { "perspective", "orthographic" };
+
+	for ( int cameraIndex = 0; cameraIndex < 2; cameraIndex++ ) {
+		LightClusterTestResult_T result = LightClusterGrid::RunComparison( viewProjections[ cameraIndex ], lights.data(), lightCount, positions.data(), positionCount, maxLights );
+		printf( "    %s: %d of %d positions in the grid, %d light/cluster pairs, %d faint picks dropped, select %.1f ns clustered vs %.1f ns unfiltered\n",
+			cameraNames[ cameraIndex ], result.inGridCount, positionCount, result.assignmentCount, result.droppedCount,
+			result.clusteredSeconds * 1000000000.0 / positionCount, result.unfilteredSeconds * 1000000000.0 / positionCount );
+
+		TEST_CHECK( result.inGridCount > positionCount / 2 );
+		TEST_CHECK( result.mismatchCount == 0 );
+	}
+}
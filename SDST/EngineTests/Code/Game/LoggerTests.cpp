@@ -0,0 +1,132 @@
+#include "Game/UnitTest.hpp"
+#include "Engine/Core/Logger.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Async/Threads.hpp"
+
+#include <mutex>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Hooks can't be removed, so one hook and its messages live for the whole run
+static std::mutex s_loggedLock;
+static std::vector<std::string> s_loggedMessages;
+static LogTagID s_loggerTestTag = 0;
+
+
+//----------------------------------------------------------------------------------------------------------------
+static void LoggerTestHook( const LogEntry* entry, void* arguments ) {
+	if ( entry->tag == s_loggerTestTag ) {
+		std::lock_guard<std::mutex> lock( s_loggedLock );
+		s_loggedMessages.push_back( entry->text );
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Which thread and message it is, then a letter that depends on both, out to the length
+static std::string MakeLoggerTestMessage( int threadIndex, int messageIndex, int length ) {
+	std::string message = Stringf( "%d:%d:", threadIndex, messageIndex );
+	message.resize( Max( length, (int) message.size() ), (char) ( 'a' + ( ( threadIndex * 7 + messageIndex ) % 26 ) ) );
+	return message;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+struct LoggerTestThread_T {
+	int threadIndex;
+	int messageCount;
+};
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Every fifth message is long enough to need several records
+static int GetLoggerTestLength( int messageIndex ) {
+	return ( messageIndex % 5 == 0 ) ? 400 + ( messageIndex * 37 ) % 2000 : 20 + messageIndex % 300;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+static void LoggerTestThreadCB( void* userData ) {
+	LoggerTestThread_T* thread = (LoggerTestThread_T*) userData;
+	for ( int messageIndex = 0; messageIndex < thread->messageCount; messageIndex++ ) {
+		std::string message = MakeLoggerTestMessage( thread->threadIndex, messageIndex, GetLoggerTestLength( messageIndex ) );
+		Logger::PrintTaggedf( s_loggerTestTag, "%s", message.c_str() );
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+UNIT_TEST( Logger_LongMessagesSpanRecords ) {
+	Logger::Startup();
+	s_loggerTestTag = Logger::InternTag( "LoggerTest" );
+	Logger::AddHook( LoggerTestHook, nullptr );
+
+	// Around each record boundary, DevConsole's 2047, and past the most a message can span
+	const int lengths[] = { 0, 10, LOGGER_RECORD_TEXT_SIZE - 2, LOGGER_RECORD_TEXT_SIZE - 1, LOGGER_RECORD_TEXT_SIZE, ( LOGGER_RECORD_TEXT_SIZE - 1 ) * 2, ( LOGGER_RECORD_TEXT_SIZE - 1 ) * 2 + 1, 2047, 10000 };
+	const int lengthCount = sizeof( lengths ) / sizeof( lengths[0] );
+	const int maxLength = ( LOGGER_RECORD_TEXT_SIZE - 1 ) * LOGGER_MAX_MESSAGE_PARTS;
+
+	for ( int lengthIndex = 0; lengthIndex < lengthCount; lengthIndex++ ) {
+		std::string message( lengths[ lengthIndex ], (char) ( 'a' + lengthIndex ) );
+		Logger::PrintTaggedf( s_loggerTestTag, "%s", message.c_str() );
+	}
+	Logger::Flush();
+
+	{
+		std::lock_guard<std::mutex> lock( s_loggedLock );
+		TEST_CHECK( (int) s_loggedMessages.size() == lengthCount );
+		for ( int lengthIndex = 0; lengthIndex < lengthCount && lengthIndex < (int) s_loggedMessages.size(); lengthIndex++ ) {
+			std::string expected( Min( lengths[ lengthIndex ], maxLength ), (char) ( 'a' + lengthIndex ) );
+			if ( s_loggedMessages[ lengthIndex ] != expected ) {
+				UnitTestRegistry::ReportFailure( __FILE__, __LINE__, Stringf( "%d characters logged as %d", lengths[ lengthIndex ], (int) s_loggedMessages[ lengthIndex ].size() ) );
+			}
+		}
+		s_loggedMessages.clear();
+	}
+
+	// Several threads racing long and short messages through a ring small enough to wrap many times
+	const int threadCount = 4;
+	const int messageCount = 3000;
+	LoggerTestThread_T threads[ threadCount ];
+	ThreadHandle handles[ threadCount ];
+	for ( int threadIndex = 0; threadIndex < threadCount; threadIndex++ ) {
+		threads[ threadIndex ].threadIndex = threadIndex;
+		threads[ threadIndex ].messageCount = messageCount;
+		handles[ threadIndex ] = CreateNewThread( "log test", LoggerTestThreadCB, &threads[ threadIndex ] );
+	}
+	for ( int threadIndex = 0; threadIndex < threadCount; threadIndex++ ) {
+		JoinThread( handles[ threadIndex ] );
+	}
+	Logger::Flush();
+
+	{
+		std::lock_guard<std::mutex> lock( s_loggedLock );
+		TEST_CHECK( (int) s_loggedMessages.size() == threadCount * messageCount );
+
+		// Each thread's messages whole and in the order it logged them
+		int nextMessage[ threadCount ] = { 0, 0, 0, 0 };
+		int mismatchCount = 0;
+		for ( const std::string& logged : s_loggedMessages ) {
+			int threadIndex = -1;
+			int messageIndex = -1;
+			if ( sscanf( logged.c_str(), "%d:%d:", &threadIndex, &messageIndex ) != 2 || threadIndex < 0 || threadIndex >= threadCount ) {
+				mismatchCount++;
+				continue;
+			}
+			if ( messageIndex != nextMessage[ threadIndex ] || logged != MakeLoggerTestMessage( threadIndex, messageIndex, GetLoggerTestLength( messageIndex ) ) ) {
+				mismatchCount++;
+			}
+			nextMessage[ threadIndex ] = messageIndex + 1;
+		}
+		if ( mismatchCount > 0 ) {
+			UnitTestRegistry::ReportFailure( __FILE__, __LINE__, Stringf( "%d messages torn or out of order", mismatchCount ) );
+		}
+		s_loggedMessages.clear();
+	}
+
+	Logger::Shutdown();
+}
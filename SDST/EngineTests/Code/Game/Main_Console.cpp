@@ -0,0 +1,24 @@
+#include "Engine/Core/EngineCommon.hpp"
+#include "Game/UnitTest.hpp"
+
+
+// Nothing here starts the engine systems, tests that need one create it themselves
+Renderer* g_theRenderer = nullptr;
+InputSystem* g_theInputSystem = nullptr;
+Blackboard* g_theBlackboard = nullptr;
+Clock* g_masterClock = nullptr;
+AudioSystem* g_audioSystem = nullptr;
+JobSystem* g_theJobSystem = nullptr;
+bool g_isQuitting = false;
+
+
+//----------------------------------------------------------------------------------------------------------------
+// EngineTests.exe [nameFilter] - returns the number of failed tests, so a build script can check it
+int main( int argc, char** argv ) {
+	std::string nameFilter;
+	if ( argc > 1 ) {
+		nameFilter = argv[ 1 ];
+	}
+
+	return UnitTestRegistry::RunAll( nameFilter );
+}
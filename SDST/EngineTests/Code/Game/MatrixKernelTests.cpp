@@ -0,0 +1,289 @@
+#include "Game/UnitTest.hpp"
+#include "Engine/Math/MatrixKernels.hpp"
+
+#include <math.h>
+#include <vector>
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Every SIMD kernel against the scalar one, and GetInverse against the double precision cofactor path it used to
+// take for every matrix. Inputs come from a fixed seed so a failure reproduces.
+#define MATRIX_TEST_COUNT 257		// Odd, so the batch kernels run their remainder loops too
+
+
+//----------------------------------------------------------------------------------------------------------------
+class MatrixTestRandom {
+
+public:
+	explicit MatrixTestRandom( unsigned int seed ) : m_state( seed ) {}
+
+	float GetFloatInRange( float minValue, float maxValue ) {
+		m_state = (m_state * 1664525u) + 1013904223u;
+		float zeroToOne = (float) (m_state >> 8) / (float) (1u << 24);
+		return minValue + ((maxValue - minValue) * zeroToOne);
+	}
+
+	Vector3 GetVector3( float range ) {
+		float x = GetFloatInRange( -range, range );
+		float y = GetFloatInRange( -range, range );
+		float z = GetFloatInRange( -range, range );
+		return Vector3( x, y, z );
+	}
+
+	Matrix44 GetAffineMatrix( float translationRange ) {
+		Matrix44 matrix = Matrix44::MakeRotationDegrees( GetVector3( 180.f ) );
+		float scaleX = GetFloatInRange( 0.25f, 4.f );
+		float scaleY = GetFloatInRange( 0.25f, 4.f );
+		float scaleZ = GetFloatInRange( 0.25f, 4.f );
+		matrix.Append( Matrix44::MakeScale( Vector3( scaleX, scaleY, scaleZ ) ) );
+		matrix.Tx = GetFloatInRange( -translationRange, translationRange );
+		matrix.Ty = GetFloatInRange( -translationRange, translationRange );
+		matrix.Tz = GetFloatInRange( -translationRange, translationRange );
+		return matrix;
+	}
+
+	Matrix44 GetProjectiveMatrix( float translationRange ) {
+		float fov = GetFloatInRange( 30.f, 120.f );
+		float aspect = GetFloatInRange( 1.f, 2.f );
+		Matrix44 matrix = Matrix44::MakeProjection( fov, aspect, 0.1f, 1000.f );
+		matrix.Append( GetAffineMatrix( translationRange ) );
+		return matrix;
+	}
+
+private:
+	unsigned int m_state;
+};
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Relative to the largest expected entry, same measure math_test prints
+static float GetMatrixError( const Matrix44& actual, const Matrix44& expected ) {
+	const float* actualValues = &actual.Ix;
+	const float* expectedValues = &expected.Ix;
+	float scale = 1.f;
+	for ( int index = 0; index < 16; index++ ) {
+		scale = fmaxf( scale, fabsf( expectedValues[ index ] ) );
+	}
+
+	float maxError = 0.f;
+	for ( int index = 0; index < 16; index++ ) {
+		maxError = fmaxf( maxError, fabsf( actualValues[ index ] - expectedValues[ index ] ) / scale );
+	}
+	return maxError;
+}
+
+
+static float GetVectorError( const Vector3& actual, const Vector3& expected ) {
+	float error = fabsf( actual.x - expected.x ) / fmaxf( 1.f, fabsf( expected.x ) );
+	error = fmaxf( error, fabsf( actual.y - expected.y ) / fmaxf( 1.f, fabsf( expected.y ) ) );
+	error = fmaxf( error, fabsf( actual.z - expected.z ) / fmaxf( 1.f, fabsf( expected.z ) ) );
+	return error;
+}
+
+
+static void CheckMaxError( const char* file, int line, const char* kernelName, float maxError ) {
+	if ( !(maxError <= MATRIX_KERNEL_TEST_EPSILON) ) {
+		UnitTestRegistry::ReportFailure( file, line, Stringf( "%s: max error %g, epsilon %g", kernelName, maxError, MATRIX_KERNEL_TEST_EPSILON ) );
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+UNIT_TEST( Matrix_MultiplyMatchesScalar ) {
+	MatrixTestRandom random( 15u );
+	float maxError = 0.f;
+	float aliasedError = 0.f;
+
+	for ( int index = 0; index < MATRIX_TEST_COUNT; index++ ) {
+		Matrix44 left = random.GetProjectiveMatrix( 1000.f );
+		Matrix44 right = random.GetAffineMatrix( 1000.f );
+
+		Matrix44 expected;
+		Matrix44 actual;
+		MultiplyMatrix_Scalar( left, right, &expected );
+		MultiplyMatrix_SSE( left, right, &actual );
+		maxError = fmaxf( maxError, GetMatrixError( actual, expected ) );
+
+		Matrix44 aliased = left;
+		MultiplyMatrix_SSE( aliased, right, &aliased );
+		aliasedError = fmaxf( aliasedError, GetMatrixError( aliased, expected ) );
+	}
+
+	CheckMaxError( __FILE__, __LINE__, "MultiplyMatrix_SSE", maxError );
+	CheckMaxError( __FILE__, __LINE__, "MultiplyMatrix_SSE aliased", aliasedError );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+UNIT_TEST( Matrix_BatchMultiplyMatchesScalar ) {
+	MatrixTestRandom random( 16u );
+	std::vector<Matrix44> left( MATRIX_TEST_COUNT );
+	std::vector<Matrix44> right( MATRIX_TEST_COUNT );
+	for ( int index = 0; index < MATRIX_TEST_COUNT; index++ ) {
+		left[ index ] = random.GetProjectiveMatrix( 1000.f );
+		right[ index ] = random.GetAffineMatrix( 1000.f );
+	}
+
+	std::vector<Matrix44> expected( MATRIX_TEST_COUNT );
+	std::vector<Matrix44> actual( MATRIX_TEST_COUNT );
+	MultiplyMatrices_Scalar( left.data(), right.data(), expected.data(), MATRIX_TEST_COUNT );
+
+	float maxError = 0.f;
+	MultiplyMatrices_SSE( left.data(), right.data(), actual.data(), MATRIX_TEST_COUNT );
+	for ( int index = 0; index < MATRIX_TEST_COUNT; index++ ) {
+		maxError = fmaxf( maxError, GetMatrixError( actual[ index ], expected[ index ] ) );
+	}
+	CheckMaxError( __FILE__, __LINE__, "MultiplyMatrices_SSE", maxError );
+
+	if ( IsAVXSupported() ) {
+		maxError = 0.f;
+		MultiplyMatrices_AVX( left.data(), right.data(), actual.data(), MATRIX_TEST_COUNT );
+		for ( int index = 0; index < MATRIX_TEST_COUNT; index++ ) {
+			maxError = fmaxf( maxError, GetMatrixError( actual[ index ], expected[ index ] ) );
+		}
+		CheckMaxError( __FILE__, __LINE__, "MultiplyMatrices_AVX", maxError );
+	}
+
+	// One left side against many, what the view-projection upload does
+	maxError = 0.f;
+	MultiplyMatrices( left[0], right.data(), actual.data(), MATRIX_TEST_COUNT );
+	for ( int index = 0; index < MATRIX_TEST_COUNT; index++ ) {
+		Matrix44 single;
+		MultiplyMatrix_Scalar( left[0], right[ index ], &single );
+		maxError = fmaxf( maxError, GetMatrixError( actual[ index ], single ) );
+	}
+	CheckMaxError( __FILE__, __LINE__, "MultiplyMatrices shared left", maxError );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// The block inverse is only used on well conditioned matrices, so keep the translations small here
+UNIT_TEST( Matrix_InverseMatchesScalar ) {
+	MatrixTestRandom random( 17u );
+	float maxError = 0.f;
+
+	for ( int index = 0; index < MATRIX_TEST_COUNT; index++ ) {
+		Matrix44 matrix = random.GetProjectiveMatrix( 10.f );
+
+		Matrix44 expected;
+		Matrix44 actual;
+		InvertMatrix_Scalar( matrix, &expected );
+		InvertMatrix_SSE( matrix, &actual );
+		maxError = fmaxf( maxError, GetMatrixError( actual, expected ) );
+	}
+
+	CheckMaxError( __FILE__, __LINE__, "InvertMatrix_SSE", maxError );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+UNIT_TEST( Matrix_AffineInverseMatchesScalar ) {
+	MatrixTestRandom random( 18u );
+	float scalarError = 0.f;
+	float simdError = 0.f;
+
+	for ( int index = 0; index < MATRIX_TEST_COUNT; index++ ) {
+		Matrix44 matrix = random.GetAffineMatrix( 1000.f );
+
+		Matrix44 expected;
+		Matrix44 actual;
+		InvertMatrix_Scalar( matrix, &expected );
+		InvertAffineMatrix_Scalar( matrix, &actual );
+		scalarError = fmaxf( scalarError, GetMatrixError( actual, expected ) );
+		InvertAffineMatrix_SSE( matrix, &actual );
+		simdError = fmaxf( simdError, GetMatrixError( actual, expected ) );
+	}
+
+	CheckMaxError( __FILE__, __LINE__, "InvertAffineMatrix_Scalar", scalarError );
+	CheckMaxError( __FILE__, __LINE__, "InvertAffineMatrix_SSE", simdError );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// GetInverse used to run the double cofactor path for everything. Affine matrices now go through the float affine
+// inverse, projective ones still use doubles, both have to stay within the epsilon of the old results.
+UNIT_TEST( Matrix_GetInverseMatchesDoublePath ) {
+	MatrixTestRandom random( 19u );
+	float affineError = 0.f;
+	float projectiveError = 0.f;
+
+	for ( int index = 0; index < MATRIX_TEST_COUNT; index++ ) {
+		Matrix44 affine = random.GetAffineMatrix( 1000.f );
+		Matrix44 projective = random.GetProjectiveMatrix( 1000.f );
+
+		Matrix44 expected;
+		InvertMatrix_Scalar( affine, &expected );
+		affineError = fmaxf( affineError, GetMatrixError( affine.GetInverse(), expected ) );
+		InvertMatrix_Scalar( projective, &expected );
+		projectiveError = fmaxf( projectiveError, GetMatrixError( projective.GetInverse(), expected ) );
+	}
+
+	CheckMaxError( __FILE__, __LINE__, "GetInverse affine", affineError );
+	TEST_CHECK( projectiveError == 0.f );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+UNIT_TEST( Matrix_TransformPositionMatchesScalar ) {
+	MatrixTestRandom random( 20u );
+	float maxError = 0.f;
+
+	for ( int index = 0; index < MATRIX_TEST_COUNT; index++ ) {
+		Matrix44 matrix = random.GetAffineMatrix( 1000.f );
+		Vector3 position = random.GetVector3( 100.f );
+		maxError = fmaxf( maxError, GetVectorError( TransformPosition_SSE( matrix, position ), TransformPosition_Scalar( matrix, position ) ) );
+	}
+
+	CheckMaxError( __FILE__, __LINE__, "TransformPosition_SSE", maxError );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Vertex-like layout, so the stride is exercised and the neighbouring fields must come through untouched
+struct MatrixTestVertex_T {
+	Vector3 position;
+	float marker;
+};
+
+
+UNIT_TEST( Matrix_BatchTransformMatchesScalar ) {
+	MatrixTestRandom random( 21u );
+	Matrix44 matrix = random.GetAffineMatrix( 1000.f );
+	const int stride = (int) sizeof( MatrixTestVertex_T );
+
+	std::vector<MatrixTestVertex_T> source( MATRIX_TEST_COUNT );
+	for ( int index = 0; index < MATRIX_TEST_COUNT; index++ ) {
+		source[ index ].position = random.GetVector3( 100.f );
+		source[ index ].marker = (float) index;
+	}
+
+	for ( int isDirection = 0; isDirection < 2; isDirection++ ) {
+		std::vector<MatrixTestVertex_T> expected = source;
+		std::vector<MatrixTestVertex_T> actual = source;
+		std::vector<MatrixTestVertex_T> inPlace = source;
+		if ( isDirection ) {
+			TransformDirections_Scalar( matrix, &source[0].position, &expected[0].position, MATRIX_TEST_COUNT, stride );
+			TransformDirections_SSE( matrix, &source[0].position, &actual[0].position, MATRIX_TEST_COUNT, stride );
+			TransformDirections( matrix, &inPlace[0].position, &inPlace[0].position, MATRIX_TEST_COUNT, stride );
+		} else {
+			TransformPositions_Scalar( matrix, &source[0].position, &expected[0].position, MATRIX_TEST_COUNT, stride );
+			TransformPositions_SSE( matrix, &source[0].position, &actual[0].position, MATRIX_TEST_COUNT, stride );
+			TransformPositions( matrix, &inPlace[0].position, &inPlace[0].position, MATRIX_TEST_COUNT, stride );
+		}
+
+		float maxError = 0.f;
+		float inPlaceError = 0.f;
+		int clobberedCount = 0;
+		for ( int index = 0; index < MATRIX_TEST_COUNT; index++ ) {
+			maxError = fmaxf( maxError, GetVectorError( actual[ index ].position, expected[ index ].position ) );
+			inPlaceError = fmaxf( inPlaceError, GetVectorError( inPlace[ index ].position, expected[ index ].position ) );
+			if ( actual[ index ].marker != (float) index || inPlace[ index ].marker != (float) index ) {
+				clobberedCount++;
+			}
+		}
+
+		CheckMaxError( __FILE__, __LINE__, isDirection ? "TransformDirections_SSE" : "TransformPositions_SSE", maxError );
+		CheckMaxError( __FILE__, __LINE__, isDirection ? "TransformDirections in place" : "TransformPositions in place", inPlaceError );
+		TEST_CHECK( clobberedCount == 0 );
+	}
+}
@@ -0,0 +1,103 @@
+#include "Game/UnitTest.hpp"
+#include "Engine/Net/NetMessage.hpp"
+#include "Engine/Net/NetObjectSystem.hpp"
+
+#include <stdio.h>
+#include <vector>
+
+
+//----------------------------------------------------------------------------------------------------------------
+static Vector3 GetTestObjectPosition( void* obj ) {
+	return *(Vector3*) obj;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Three objects at 0, 1000 and 4000 from the focus, plus one weighted object far away
+UNIT_TEST( NetPriority_NearAndHeavyObjectsGoFirst ) {
+	NetObjectDef_T positionedType;
+	positionedType.id = 0;
+	positionedType.getPositionCB = GetTestObjectPosition;
+	NetObjectDef_T heavyType;
+	heavyType.id = 1;
+	heavyType.priorityWeight = 100.f;
+	std::vector< NetObjectDef_T* > types;
+	types.push_back( &positionedType );
+	types.push_back( &heavyType );
+
+	Vector3 positions[4] = { Vector3( 0.f, 0.f, 0.f ), Vector3( 1000.f, 0.f, 0.f ), Vector3( 4000.f, 0.f, 0.f ), Vector3( 9000.f, 0.f, 0.f ) };
+	NetObject objects[4];
+	for ( int i = 0; i < 4; i++ ) {
+		objects[i].typeID = ( i == 3 ) ? 1 : 0;
+		objects[i].networkID = (uint16_t) i;
+		objects[i].localPtr = &positions[i];
+		objects[i].position = positions[i];
+	}
+
+	NetObjectConnectionView view;
+	view.focusPosition = Vector3::ZERO;
+	view.hasFocus = true;
+	for ( int i = 3; i >= 0; i-- ) {
+		view.AddNetObject( &objects[i], 0.0 );
+	}
+
+	// Nothing has waited yet
+	view.BuildSendQueue();
+	TEST_CHECK( view.PopHighestPriorityView() == nullptr );
+
+	view.AccumulatePriority( 0.05f, types );
+	view.BuildSendQueue();
+	const uint16_t expectedOrder[4] = { 3, 0, 1, 2 };
+	for ( int i = 0; i < 4; i++ ) {
+		NetObjectView_T* next = view.PopHighestPriorityView();
+		TEST_CHECK( next != nullptr && next->networkID == expectedOrder[i] );
+		if ( next != nullptr && i < 2 ) {
+			next->priority = 0.f;
+		}
+	}
+	TEST_CHECK( view.PopHighestPriorityView() == nullptr );
+
+	// 1 kept what it had, so after a shorter wait it's still ahead of 0, which just went
+	view.AccumulatePriority( 0.01f, types );
+	view.BuildSendQueue();
+	NetObjectView_T* next = view.PopHighestPriorityView();
+	TEST_CHECK( next != nullptr && next->networkID == 3 );
+	next = view.PopHighestPriorityView();
+	TEST_CHECK( next != nullptr && next->networkID == 1 );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+UNIT_TEST( NetPriority_LegacyScanFindsOldest ) {
+	NetObject objects[3];
+	NetObjectConnectionView view;
+	for ( int i = 0; i < 3; i++ ) {
+		objects[i].networkID = (uint16_t) i;
+		objects[i].localPtr = &objects[i];
+		view.AddNetObject( &objects[i], 1.0 );
+	}
+	view.objectViews[0]->timeLastSent = 3.0;
+	view.objectViews[2]->timeLastSent = 2.0;
+
+	NetObjectView_T* oldest = view.FindOldestView( 4.0 );
+	TEST_CHECK( oldest != nullptr && oldest->networkID == 1 );
+	TEST_CHECK( view.FindOldestView( 1.0 ) == nullptr );		// Nothing older than now
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+UNIT_TEST( NetPriority_Benchmark ) {
+	const int objectCounts[] = { 1000, 10000 };
+
+	for ( int objectCount : objectCounts ) {
+		NetPriorityBenchmarkResult_T result = NetObjectSystem::RunPriorityBenchmark( objectCount, 32, 20 );
+		printf( "    %6d objects x %d connections: priority %.3fms/tick, oldest-first scan %.3fms/tick (%.1fx), nearest tenth got %.0f%% vs %.0f%% of updates\n",
+			objectCount, result.connectionCount, result.prioritySeconds * 1000.0 / result.tickCount, result.legacyScanSeconds * 1000.0 / result.tickCount,
+			result.legacyScanSeconds / ( result.prioritySeconds > 0.0 ? result.prioritySeconds : 0.000000001 ), result.priorityNearShare * 100.f, result.legacyNearShare * 100.f );
+
+		int const expectedUpdates = result.tickCount * result.connectionCount * ( MTU / 40 );
+		TEST_CHECK( result.priorityUpdates == expectedUpdates );
+		TEST_CHECK( result.legacyUpdates == expectedUpdates );
+		TEST_CHECK( result.priorityNearShare > result.legacyNearShare );
+	}
+}
@@ -0,0 +1,309 @@
+#include "Game/UnitTest.hpp"
+#include "Engine/Core/BytePacker.hpp"
+#include "Engine/Net/NetBitStream.hpp"
+#include "Engine/Net/NetMessage.hpp"
+#include "Engine/Net/NetSnapshotLayout.hpp"
+
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+
+
+//----------------------------------------------------------------------------------------------------------------
+struct TestSnapshot_T {
+	float position[3];
+	float euler[3];
+	float forward[3];
+	float health;
+	float rawValue;
+	int32_t score;
+	uint8_t team;
+	bool isAlive;
+};
+
+
+//----------------------------------------------------------------------------------------------------------------
+static void SetupTestLayout( NetSnapshotLayout* layout ) {
+	layout->SetSnapshotSize( sizeof(TestSnapshot_T) );
+	layout->AddQuantizedVector3( offsetof( TestSnapshot_T, position ), -1000.f, 1000.f, 20 );
+	layout->AddAngles( offsetof( TestSnapshot_T, euler ), 12 );
+	layout->AddUnitVector( offsetof( TestSnapshot_T, forward ), 12 );
+	layout->AddQuantizedFloat( offsetof( TestSnapshot_T, health ), 0.f, 100.f, 7 );
+	layout->AddField( NETFIELD_FLOAT, offsetof( TestSnapshot_T, rawValue ) );
+	layout->AddField( NETFIELD_INT32, offsetof( TestSnapshot_T, score ) );
+	layout->AddField( NETFIELD_UINT8, offsetof( TestSnapshot_T, team ) );
+	layout->AddField( NETFIELD_BOOL, offsetof( TestSnapshot_T, isAlive ) );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+static TestSnapshot_T MakeTestSnapshot() {
+	TestSnapshot_T snapshot;
+	memset( &snapshot, 0, sizeof(snapshot) );
+
+	snapshot.position[0] = 123.456f;
+	snapshot.position[1] = -987.654f;
+	snapshot.position[2] = 0.001f;
+	snapshot.euler[0] = 45.3f;
+	snapshot.euler[1] = -90.7f;			// Comes back as 269.3
+	snapshot.euler[2] = 719.9f;			// Comes back as 359.9, or 0 if it rounds up to a full turn
+	snapshot.forward[0] = 0.267261f;
+	snapshot.forward[1] = -0.534522f;
+	snapshot.forward[2] = -0.801784f;
+	snapshot.health = 42.4f;
+	snapshot.rawValue = 3.14159265f;
+	snapshot.score = -12345;
+	snapshot.team = 3;
+	snapshot.isAlive = true;
+	return snapshot;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+static float GetAngleDistance( float a, float b ) {
+	float distance = fmodf( fabsf( a - b ), 360.f );
+	return (distance > 180.f) ? (360.f - distance) : distance;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+UNIT_TEST( NetBitStream_RoundTripsMixedWidths ) {
+	NetBitWriter writer;
+	uint32_t expected[ 64 ];
+	uint8_t widths[ 64 ];
+
+	uint32_t seed = 0x12345678u;
+	for ( int i = 0; i < 64; i++ ) {
+		seed = (seed * 1664525u) + 1013904223u;
+		widths[i] = (uint8_t) ((i % 32) + 1);
+		expected[i] = (widths[i] == 32) ? seed : (seed & ((1u << widths[i]) - 1u));
+		writer.Write( seed, widths[i] );			// High bits past the width are dropped
+	}
+
+	size_t totalBits = 0;
+	for ( int i = 0; i < 64; i++ ) {
+		totalBits += widths[i];
+	}
+	TEST_CHECK( writer.GetByteCount() == (totalBits + 7) / 8 );
+
+	NetBitReader reader( writer.GetBytes(), writer.GetByteCount() );
+	for ( int i = 0; i < 64; i++ ) {
+		uint32_t value = 0;
+		TEST_CHECK( reader.Read( &value, widths[i] ) );
+		TEST_CHECK( value == expected[i] );
+	}
+	TEST_CHECK( reader.GetByteCount() == writer.GetByteCount() );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+UNIT_TEST( NetBitStream_ReaderStopsAtEnd ) {
+	NetBitWriter writer;
+	writer.Write( 0x5u, 3 );
+	writer.Write( 0x1Fu, 5 );
+	writer.Write( 0x1u, 1 );
+	TEST_CHECK( writer.GetByteCount() == 2 );
+
+	NetBitReader reader( writer.GetBytes(), writer.GetByteCount() );
+	uint32_t value = 0;
+	TEST_CHECK( reader.Read( &value, 8 ) );
+	TEST_CHECK( value == (0x5u | (0x1Fu << 3)) );
+	TEST_CHECK( reader.Read( &value, 8 ) );
+	TEST_CHECK( value == 0x1u );				// Padding bits in the last byte read as zero
+
+	TEST_CHECK( !reader.Read( &value, 1 ) );
+	TEST_CHECK( value == 0x1u );				// A failed read leaves the output alone
+
+	NetBitReader emptyReader( writer.GetBytes(), 0 );
+	TEST_CHECK( !emptyReader.Read( &value, 1 ) );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+UNIT_TEST( NetSnapshotLayout_FullSnapshotRoundTrip ) {
+	NetSnapshotLayout layout;
+	SetupTestLayout( &layout );
+
+	TestSnapshot_T sent = MakeTestSnapshot();
+	BytePacker packer;
+	TEST_CHECK( layout.WriteDelta( &packer, nullptr, &sent ) == 8 );
+
+	TestSnapshot_T received;
+	memset( &received, 0, sizeof(received) );
+	TEST_CHECK( layout.ReadDelta( &packer, &received ) );
+	TEST_CHECK( packer.GetRemainingReadableByteCount() == 0 );
+
+	float positionStep = 2000.f / (float) ((1 << 20) - 1);
+	for ( int i = 0; i < 3; i++ ) {
+		TEST_CHECK_NEAR( received.position[i], sent.position[i], positionStep * 0.5f + 1e-4f );
+	}
+
+	float angleStep = 360.f / (float) (1 << 12);
+	for ( int i = 0; i < 3; i++ ) {
+		TEST_CHECK( received.euler[i] >= 0.f && received.euler[i] < 360.f );
+		TEST_CHECK_NEAR( GetAngleDistance( received.euler[i], sent.euler[i] ), 0.f, angleStep * 0.5f + 1e-4f );
+	}
+
+	float length = sqrtf( (received.forward[0] * received.forward[0]) + (received.forward[1] * received.forward[1]) + (received.forward[2] * received.forward[2]) );
+	TEST_CHECK_NEAR( length, 1.f, 1e-5f );
+	float dot = (received.forward[0] * sent.forward[0]) + (received.forward[1] * sent.forward[1]) + (received.forward[2] * sent.forward[2]);
+	TEST_CHECK( dot > 0.99999f );					// Well under a degree at 12 bits
+
+	TEST_CHECK_NEAR( received.health, sent.health, (100.f / 127.f) * 0.5f + 1e-4f );
+	TEST_CHECK( memcmp( &received.rawValue, &sent.rawValue, sizeof(float) ) == 0 );
+	TEST_CHECK( received.score == sent.score );
+	TEST_CHECK( received.team == sent.team );
+	TEST_CHECK( received.isAlive == sent.isAlive );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+UNIT_TEST( NetSnapshotLayout_QuantizedFloatEndpoints ) {
+	NetSnapshotLayout layout;
+	layout.SetSnapshotSize( sizeof(float) );
+	layout.AddQuantizedFloat( 0, -10.f, 10.f, 8 );
+
+	float values[] = { -10.f, 10.f, -25.f, 25.f, 0.f };
+	float expected[] = { -10.f, 10.f, -10.f, 10.f, 10.f / 255.f };		// Out of range clamps, 0 lands on the nearest step
+	for ( int i = 0; i < 5; i++ ) {
+		BytePacker packer;
+		layout.WriteDelta( &packer, nullptr, &values[i] );
+
+		float received = 1234.f;
+		TEST_CHECK( layout.ReadDelta( &packer, &received ) );
+		TEST_CHECK_NEAR( received, expected[i], 1e-5f );
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+UNIT_TEST( NetSnapshotLayout_DeltaOnlyWritesChangedFields ) {
+	NetSnapshotLayout layout;
+	SetupTestLayout( &layout );
+
+	TestSnapshot_T baseline = MakeTestSnapshot();
+	TestSnapshot_T snapshot = baseline;
+	snapshot.position[0] += 0.0001f;				// Inside one quantization step, not a change
+	TEST_CHECK( !layout.HasChanged( &baseline, &snapshot ) );
+
+	BytePacker unchangedPacker;
+	TEST_CHECK( layout.WriteDelta( &unchangedPacker, &baseline, &snapshot ) == 0 );
+	TEST_CHECK( unchangedPacker.GetWrittenByteCount() == 1 );		// Just the change mask
+
+	snapshot.score = 99;
+	snapshot.isAlive = false;
+	TEST_CHECK( layout.HasChanged( &baseline, &snapshot ) );
+
+	BytePacker packer;
+	TEST_CHECK( layout.WriteDelta( &packer, &baseline, &snapshot ) == 2 );
+
+	// Received on top of the baseline, everything not in the delta keeps the baseline's bits
+	TestSnapshot_T received = baseline;
+	TEST_CHECK( layout.ReadDelta( &packer, &received ) );
+	TEST_CHECK( received.score == 99 );
+	TEST_CHECK( received.isAlive == false );
+	TEST_CHECK( memcmp( received.position, baseline.position, sizeof(received.position) ) == 0 );
+	TEST_CHECK( received.health == baseline.health );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+UNIT_TEST( NetSnapshotLayout_TruncatedDeltaFails ) {
+	NetSnapshotLayout layout;
+	SetupTestLayout( &layout );
+
+	TestSnapshot_T sent = MakeTestSnapshot();
+	BytePacker fullPacker;
+	layout.WriteDelta( &fullPacker, nullptr, &sent );
+
+	BytePacker truncatedPacker;
+	truncatedPacker.WriteBytes( fullPacker.GetWrittenByteCount() - 1, fullPacker.GetBuffer() );
+
+	TestSnapshot_T received = sent;
+	TEST_CHECK( !layout.ReadDelta( &truncatedPacker, &received ) );
+	TEST_CHECK( truncatedPacker.GetRemainingReadableByteCount() == fullPacker.GetWrittenByteCount() - 1 );	// Nothing consumed
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+UNIT_TEST( NetSnapshotHistory_FindsRecentAndDropsOverwritten ) {
+	NetSnapshotHistory history;
+	history.Initialize( sizeof(uint32_t) );
+	TEST_CHECK( history.IsEmpty() );
+
+	for ( uint32_t id = 1; id <= NET_SNAPSHOT_HISTORY_SIZE + 4; id++ ) {
+		uint32_t value = id * 10;
+		history.Store( id, &value );
+	}
+
+	TEST_CHECK( history.GetLatestID() == NET_SNAPSHOT_HISTORY_SIZE + 4 );
+	TEST_CHECK( *((uint32_t const*) history.GetLatest()) == (NET_SNAPSHOT_HISTORY_SIZE + 4) * 10 );
+	TEST_CHECK( history.Find( 1 ) == nullptr );
+	TEST_CHECK( history.Find( 4 ) == nullptr );
+	TEST_CHECK( history.Find( 5 ) != nullptr );
+	TEST_CHECK( *((uint32_t const*) history.Find( 5 )) == 50 );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// How NetMessage keeps small payloads inline and moves big ones to the heap
+UNIT_TEST( BytePacker_WrappedBufferSpillsToHeap ) {
+	byte_t inlineStorage[8];
+	BytePacker packer( inlineStorage, sizeof(inlineStorage), 0, LITTLE_ENDIAN, BYTEPACKER_SPILLS_TO_HEAP );
+	TEST_CHECK( packer.WriteValue<uint32_t>( 0x01020304u ) );
+	TEST_CHECK( packer.GetBuffer() == inlineStorage );
+	TEST_CHECK( packer.GetRemainingReadableByteCount() == 4 );		// Only what was written, not the rest of the buffer
+
+	for ( uint32_t value = 0; value < 100; value++ ) {
+		TEST_CHECK( packer.WriteValue<uint32_t>( value ) );
+	}
+	TEST_CHECK( packer.GetBuffer() != inlineStorage );
+	TEST_CHECK( packer.GetWrittenByteCount() == 404 );
+
+	uint32_t readValue = 0;
+	packer.ReadValue<uint32_t>( &readValue );
+	TEST_CHECK( readValue == 0x01020304u );
+	for ( uint32_t value = 0; value < 100; value++ ) {
+		packer.ReadValue<uint32_t>( &readValue );
+		TEST_CHECK( readValue == value );
+	}
+	TEST_CHECK( packer.GetRemainingReadableByteCount() == 0 );
+
+	// Without the option a wrapped buffer still refuses to grow
+	byte_t fixedStorage[4];
+	BytePacker fixedPacker( fixedStorage, sizeof(fixedStorage), 0 );
+	TEST_CHECK( fixedPacker.WriteValue<uint32_t>( 1u ) );
+	TEST_CHECK( !fixedPacker.WriteValue<uint8_t>( 2 ) );
+	TEST_CHECK( fixedPacker.GetBuffer() == fixedStorage );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// A message that outgrows its inline storage gets its buffer from NetAllocator, so the stats count it
+UNIT_TEST( NetMessage_SpillIsCountedByNetAllocator ) {
+	int const heapAllocationsBefore = NetAllocator::GetHeapAllocationCount();
+	int const liveBuffersBefore = NetAllocator::GetLiveBufferCount();
+	{
+		NetMessage message( (uint8_t) 0 );
+		for ( uint32_t value = 0; value < NET_MESSAGE_INLINE_SIZE / 4; value++ ) {
+			TEST_CHECK( message.WriteValue<uint32_t>( value ) );
+		}
+		TEST_CHECK( NetAllocator::GetHeapAllocationCount() == heapAllocationsBefore );
+
+		TEST_CHECK( message.WriteValue<uint32_t>( 0u ) );
+		TEST_CHECK( NetAllocator::GetHeapAllocationCount() == heapAllocationsBefore + 1 );
+		TEST_CHECK( NetAllocator::GetLiveBufferCount() == liveBuffersBefore + 1 );
+
+		// Growing again swaps one counted buffer for another
+		for ( uint32_t value = 0; value < NET_MESSAGE_INLINE_SIZE / 4; value++ ) {
+			TEST_CHECK( message.WriteValue<uint32_t>( value ) );
+		}
+		TEST_CHECK( NetAllocator::GetHeapAllocationCount() == heapAllocationsBefore + 2 );
+		TEST_CHECK( NetAllocator::GetLiveBufferCount() == liveBuffersBefore + 1 );
+
+		NetMessage copy( message );
+		TEST_CHECK( NetAllocator::GetLiveBufferCount() == liveBuffersBefore + 2 );
+		TEST_CHECK( copy.GetWrittenByteCount() == message.GetWrittenByteCount() );
+	}
+	TEST_CHECK( NetAllocator::GetLiveBufferCount() == liveBuffersBefore );
+}
@@ -0,0 +1,113 @@
+#include "Game/UnitTest.hpp"
+#include "Engine/Math/NoiseSIMD.hpp"
+#include "Engine/Math/RawNoise.hpp"
+#include "Engine/Math/SmoothNoise.hpp"
+
+#include <string.h>
+#include <vector>
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Every batch path has to match the scalar functions bit for bit, so each test runs once per path
+static const eNoisePath s_noisePaths[] = { NOISE_PATH_SCALAR, NOISE_PATH_SSE2, NOISE_PATH_AVX2 };
+static const char* s_noisePathNames[] = { "scalar", "SSE2", "AVX2" };
+
+
+//----------------------------------------------------------------------------------------------------------------
+UNIT_TEST( Noise_UintRowMatchesScalar ) {
+	const int startIndices[] = { 0, -37, 2147483647 - 20 };		// The last row wraps past INT_MAX
+	std::vector< unsigned int > values( 67 );
+
+	for ( int pathIndex = 0; pathIndex < 3; pathIndex++ ) {
+		SetNoisePathLimit( s_noisePaths[ pathIndex ] );
+
+		for ( int startIndex : startIndices ) {
+			Get1dNoiseUintRow( startIndex, (int) values.size(), values.data(), 1234u );
+
+			int mismatchCount = 0;
+			for ( int i = 0; i < (int) values.size(); i++ ) {
+				if ( values[i] != Get1dNoiseUint( (int) ((unsigned int) startIndex + (unsigned int) i), 1234u ) ) {
+					mismatchCount++;
+				}
+			}
+			if ( mismatchCount > 0 ) {
+				UnitTestRegistry::ReportFailure( __FILE__, __LINE__, Stringf( "%s row at %d: %d mismatches", s_noisePathNames[ pathIndex ], startIndex, mismatchCount ) );
+			}
+		}
+	}
+
+	SetNoisePathLimit( NOISE_PATH_AVX2 );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+UNIT_TEST( Noise_UintGridMatchesScalar ) {
+	const int width = 19;
+	const int height = 7;
+	std::vector< unsigned int > values( width * height );
+
+	for ( int pathIndex = 0; pathIndex < 3; pathIndex++ ) {
+		SetNoisePathLimit( s_noisePaths[ pathIndex ] );
+		Get2dNoiseUintGrid( -5, -3, width, height, values.data(), 99u );
+
+		int mismatchCount = 0;
+		for ( int y = 0; y < height; y++ ) {
+			for ( int x = 0; x < width; x++ ) {
+				if ( values[ (y * width) + x ] != Get2dNoiseUint( x - 5, y - 3, 99u ) ) {
+					mismatchCount++;
+				}
+			}
+		}
+		if ( mismatchCount > 0 ) {
+			UnitTestRegistry::ReportFailure( __FILE__, __LINE__, Stringf( "%s grid: %d mismatches", s_noisePathNames[ pathIndex ], mismatchCount ) );
+		}
+	}
+
+	SetNoisePathLimit( NOISE_PATH_AVX2 );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+UNIT_TEST( Noise_PerlinBatchMatchesScalarBits ) {
+	// Odd count so every path also runs its scalar tail, positions on both sides of zero and on lattice lines
+	const int count = 1021;
+	std::vector< float > positionsX( count );
+	std::vector< float > positionsY( count );
+	for ( int i = 0; i < count; i++ ) {
+		positionsX[i] = -300.f + ((float) i * 0.73f);
+		positionsY[i] = 250.f - ((float) (i % 97) * 5.5f);
+	}
+	positionsX[0] = 0.f;
+	positionsY[0] = -0.f;
+	positionsX[1] = -1.f;
+	positionsY[1] = 64.f;
+
+	struct PerlinSettings_T {
+		float scale;
+		unsigned int numOctaves;
+		bool renormalize;
+		unsigned int seed;
+	};
+	const PerlinSettings_T settings[] = { { 1.f, 1, true, 0u }, { 37.5f, 5, true, 7u }, { 200.f, 3, false, 12345u } };
+
+	std::vector< float > values( count );
+	for ( const PerlinSettings_T& setting : settings ) {
+		for ( int pathIndex = 0; pathIndex < 3; pathIndex++ ) {
+			SetNoisePathLimit( s_noisePaths[ pathIndex ] );
+			Compute2dPerlinNoiseBatch( positionsX.data(), positionsY.data(), count, values.data(), setting.scale, setting.numOctaves, 0.5f, 2.f, setting.renormalize, setting.seed );
+
+			int mismatchCount = 0;
+			for ( int i = 0; i < count; i++ ) {
+				float expected = Compute2dPerlinNoise( positionsX[i], positionsY[i], setting.scale, setting.numOctaves, 0.5f, 2.f, setting.renormalize, setting.seed );
+				if ( memcmp( &values[i], &expected, sizeof(float) ) != 0 ) {
+					mismatchCount++;
+				}
+			}
+			if ( mismatchCount > 0 ) {
+				UnitTestRegistry::ReportFailure( __FILE__, __LINE__, Stringf( "%s, %u octaves at scale %g: %d of %d samples differ", s_noisePathNames[ pathIndex ], setting.numOctaves, setting.scale, mismatchCount, count ) );
+			}
+		}
+	}
+
+	SetNoisePathLimit( NOISE_PATH_AVX2 );
+}
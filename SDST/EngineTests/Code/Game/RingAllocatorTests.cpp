@@ -0,0 +1,113 @@
+#include "Game/UnitTest.hpp"
+#include "Engine/Renderer/RingAllocator.hpp"
+
+
+//----------------------------------------------------------------------------------------------------------------
+// 60 then 30 bytes as two frames, the first frame done. 50 doesn't fit in the 10 left at the end, so it wraps to
+// the start and the skipped 10 are charged to it.
+UNIT_TEST( RingAllocator_WrapsToTheStart ) {
+	RingAllocator ring( 100 );
+	size_t offset = 0;
+
+	TEST_CHECK( ring.Allocate( 60, 1, offset ) && offset == 0 );
+	uint64_t firstFence = ring.Fence();
+	TEST_CHECK( ring.Allocate( 30, 1, offset ) && offset == 60 );
+	uint64_t secondFence = ring.Fence();
+	TEST_CHECK( firstFence == 1 && secondFence == 2 );
+
+	TEST_CHECK( !ring.Allocate( 50, 1, offset ) );
+	TEST_CHECK( offset == RING_ALLOCATOR_INVALID_OFFSET );
+	ring.Release( firstFence );
+	TEST_CHECK( ring.Allocate( 50, 1, offset ) && offset == 0 );
+	TEST_CHECK( ring.GetUsedBytes() == 90 );
+	TEST_CHECK( ring.GetOpenRegionBytes() == 60 );
+
+	// Head is behind the tail now, only 10 bytes up to the second frame
+	TEST_CHECK( !ring.Allocate( 11, 1, offset ) );
+	TEST_CHECK( ring.Allocate( 10, 1, offset ) && offset == 50 );
+
+	ring.Fence();
+	ring.Release( secondFence + 1 );
+	TEST_CHECK( ring.GetUsedBytes() == 0 );
+	TEST_CHECK( !ring.HasPendingRegions() );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Offsets are aligned to any stride, not only powers of two, and the padding counts as used
+UNIT_TEST( RingAllocator_AlignsToStride ) {
+	RingAllocator ring( 1000 );
+	size_t offset = 0;
+
+	TEST_CHECK( ring.Allocate( 10, 4, offset ) && offset == 0 );
+	TEST_CHECK( ring.Allocate( 48, 24, offset ) && offset == 24 );
+	TEST_CHECK( ring.Allocate( 36, 36, offset ) && offset == 72 );
+	TEST_CHECK( ring.Allocate( 4, 36, offset ) && offset == 108 );
+	TEST_CHECK( ring.GetUsedBytes() == 112 );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// A ring filled to the last byte has head == tail, which must read as full and not as empty
+UNIT_TEST( RingAllocator_FullRingRefuses ) {
+	RingAllocator ring( 64 );
+	size_t offset = 0;
+
+	TEST_CHECK( !ring.Allocate( 65, 1, offset ) );
+	TEST_CHECK( !ring.Allocate( 0, 1, offset ) );
+
+	TEST_CHECK( ring.Allocate( 32, 1, offset ) && offset == 0 );
+	TEST_CHECK( ring.Allocate( 32, 1, offset ) && offset == 32 );
+	TEST_CHECK( ring.GetUsedBytes() == 64 );
+	TEST_CHECK( !ring.Allocate( 1, 1, offset ) );
+
+	// Fencing doesn't free anything, only the release does
+	uint64_t fenceValue = ring.Fence();
+	TEST_CHECK( !ring.Allocate( 1, 1, offset ) );
+	TEST_CHECK( ring.GetOldestPendingFence() == fenceValue );
+	ring.Release( fenceValue );
+	TEST_CHECK( ring.Allocate( 64, 1, offset ) && offset == 0 );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Nothing a frame allocated is handed out again until its fence is released, and releases go oldest first
+UNIT_TEST( RingAllocator_ReuseWaitsForFence ) {
+	RingAllocator ring( 100 );
+	size_t offset = 0;
+
+	TEST_CHECK( ring.Allocate( 40, 1, offset ) && offset == 0 );
+	uint64_t firstFence = ring.Fence();
+	TEST_CHECK( ring.Allocate( 40, 1, offset ) && offset == 40 );
+	uint64_t secondFence = ring.Fence();
+
+	TEST_CHECK( !ring.Allocate( 40, 1, offset ) );
+	ring.Release( firstFence - 1 );
+	TEST_CHECK( !ring.Allocate( 40, 1, offset ) );
+	TEST_CHECK( ring.GetOldestPendingFence() == firstFence );
+
+	ring.Release( firstFence );
+	TEST_CHECK( ring.GetOldestPendingFence() == secondFence );
+	TEST_CHECK( ring.Allocate( 40, 1, offset ) && offset == 0 );
+
+	// The second frame's 40 to 80 is still off limits, everything else is taken
+	TEST_CHECK( !ring.Allocate( 1, 1, offset ) );
+	ring.Release( secondFence );
+	TEST_CHECK( ring.Allocate( 20, 1, offset ) && offset == 40 );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Once everything is released the ring starts over at 0, so a request bigger than either side of where head and
+// tail stopped still fits
+UNIT_TEST( RingAllocator_EmptyRingStartsOver ) {
+	RingAllocator ring( 100 );
+	size_t offset = 0;
+
+	TEST_CHECK( ring.Allocate( 70, 1, offset ) && offset == 0 );
+	ring.Release( ring.Fence() );
+	TEST_CHECK( ring.GetUsedBytes() == 0 );
+
+	TEST_CHECK( ring.Allocate( 80, 1, offset ) && offset == 0 );
+	TEST_CHECK( ring.GetUsedBytes() == 80 );
+}
@@ -0,0 +1,91 @@
+#include "Game/UnitTest.hpp"
+#include "Engine/Core/Transform.hpp"
+#include "Engine/Core/TransformHierarchy.hpp"
+
+
+//----------------------------------------------------------------------------------------------------------------
+static bool AreMatricesEqual( const Matrix44& a, const Matrix44& b ) {
+	const float* aValues = &a.Ix;
+	const float* bValues = &b.Ix;
+	for ( int valueIndex = 0; valueIndex < 16; valueIndex++ ) {
+		if ( aValues[ valueIndex ] != bValues[ valueIndex ] ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// What the getters returned before there was a cache
+static Matrix44 BuildChain( const Transform& transform ) {
+	Matrix44 localToParent = Transform::MakeLocalToParentMatrix( transform.position, transform.euler, transform.scale );
+	if ( transform.parent == nullptr ) {
+		return localToParent;
+	}
+	Matrix44 localToWorld = BuildChain( *transform.parent );
+	localToWorld.Append( localToParent );
+	return localToWorld;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+UNIT_TEST( Transform_CacheFollowsDirectWrites ) {
+	Transform root( nullptr, Vector3( 10.f, 0.f, 0.f ), Vector3( 0.f, 90.f, 0.f ) );
+	Transform child( &root, Vector3( 0.f, 0.f, 5.f ), Vector3( 30.f, 0.f, 0.f ), Vector3( 2.f, 2.f, 2.f ) );
+	Transform grandchild( &child, Vector3( 1.f, 2.f, 3.f ) );
+
+	TEST_CHECK( !grandchild.IsWorldCurrent() );
+	TEST_CHECK( grandchild.UpdateWorld() );
+	TEST_CHECK( root.IsWorldCurrent() && child.IsWorldCurrent() && grandchild.IsWorldCurrent() );
+	TEST_CHECK( AreMatricesEqual( grandchild.GetLocalToWorldMatrix(), BuildChain( grandchild ) ) );
+	TEST_CHECK( !grandchild.UpdateWorld() );
+
+	// Moving the root makes everything under it stale, the getters build the chain again until the next update
+	uint32_t childVersion = child.GetWorldVersion();
+	root.position.y = 4.f;
+	TEST_CHECK( root.GetWorldVersion() != 0 && !grandchild.IsWorldCurrent() );
+	TEST_CHECK( AreMatricesEqual( grandchild.GetLocalToWorldMatrix(), BuildChain( grandchild ) ) );
+	TEST_CHECK( grandchild.UpdateWorld() );
+	TEST_CHECK( child.GetWorldVersion() != childVersion );
+	TEST_CHECK( AreMatricesEqual( grandchild.GetLocalToWorldMatrix(), BuildChain( grandchild ) ) );
+
+	// So does swapping a parent out
+	Transform otherRoot( nullptr, Vector3( -3.f, 0.f, 0.f ) );
+	otherRoot.UpdateWorld();
+	child.parent = &otherRoot;
+	TEST_CHECK( !grandchild.IsWorldCurrent() );
+	TEST_CHECK( AreMatricesEqual( grandchild.GetLocalToWorldMatrix(), BuildChain( grandchild ) ) );
+
+	TransformWorld_T world = grandchild.ComputeWorld();
+	TEST_CHECK( world.forward == grandchild.GetWorldForward() );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Only what moved, or sits under something that moved, gets rebuilt
+UNIT_TEST( TransformHierarchy_RebuildsOnlyWhatChanged ) {
+	Transform root;
+	Transform children[4] = { Transform( &root ), Transform( &root ), Transform( &root ), Transform( &root ) };
+	Transform loner;
+
+	TransformHierarchy hierarchy;
+	for ( int childIndex = 3; childIndex >= 0; childIndex-- ) {
+		hierarchy.Add( &children[ childIndex ] );		// Children first, the parent gets updated on the way anyway
+	}
+	hierarchy.Add( &loner );
+	hierarchy.Add( &root );
+
+	TEST_CHECK( hierarchy.UpdateWorlds() == 5 );		// The root was rebuilt by its first child
+	TEST_CHECK( hierarchy.UpdateWorlds() == 0 );
+
+	children[2].euler.x = 45.f;
+	TEST_CHECK( hierarchy.UpdateWorlds() == 1 );
+
+	root.scale = Vector3( 3.f, 3.f, 3.f );
+	TEST_CHECK( hierarchy.UpdateWorlds() == 4 );
+	TEST_CHECK( AreMatricesEqual( children[2].GetLocalToWorldMatrix(), BuildChain( children[2] ) ) );
+
+	hierarchy.Remove( &loner );
+	TEST_CHECK( hierarchy.GetTransformCount() == 5 );
+}
@@ -0,0 +1,350 @@
+#include "Game/UnitTest.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Renderer/Shader.hpp"
+#include "Engine/Renderer/ShaderProgram.hpp"
+#include "Engine/Renderer/UniformBuffer.hpp"
+#include "Engine/Renderer/UniformTable.hpp"
+#include "Engine/Renderer/Mesh.hpp"
+#include "Engine/Renderer/glbindings.h"
+
+#include <string.h>
+#include <vector>
+
+
+//----------------------------------------------------------------------------------------------------------------
+// The gl* bindings are plain function pointers, so these tests point the ones the uniform path touches at a stub
+// driver that counts every call, then run the real ShaderProgram link and reflection, Renderer::SetUniform,
+// Renderer::BindMesh and UniformBuffer::Flush against it. Nothing here needs a window or a context.
+struct StubGLUniform_T {
+	const char* activeName;		// As glGetActiveUniform reports it
+	int location;				// -1 for block members
+	GLenum type;
+	int arraySize;
+};
+
+
+struct StubGLCounts_T {
+	int uniformNameLookups = 0;
+	int attributeNameLookups = 0;
+	int uniformUploads = 0;
+	int bufferUploads = 0;
+	int bufferBaseBinds = 0;
+	std::vector<int> uploadedLocations;
+};
+
+
+static std::vector<StubGLUniform_T> s_stubUniforms;
+static bool s_stubHasBlocks = false;
+static StubGLCounts_T s_stubCounts;
+static GLuint s_stubNextHandle = 1;
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Real drivers take either "NAME" or "NAME[0]" for element zero of an array
+static const StubGLUniform_T* FindStubUniform( const char* name ) {
+	for ( size_t uniformIndex = 0; uniformIndex < s_stubUniforms.size(); uniformIndex++ ) {
+		const char* activeName = s_stubUniforms[uniformIndex].activeName;
+		size_t nameLength = strlen( name );
+		if ( strcmp( activeName, name ) == 0 ) {
+			return &s_stubUniforms[uniformIndex];
+		}
+		if ( strncmp( activeName, name, nameLength ) == 0 && strcmp( activeName + nameLength, "[0]" ) == 0 ) {
+			return &s_stubUniforms[uniformIndex];
+		}
+	}
+	return nullptr;
+}
+
+
+static GLuint APIENTRY StubCreateShader( GLenum ) { return s_stubNextHandle++; }
+static GLuint APIENTRY StubCreateProgram() { return s_stubNextHandle++; }
+static void APIENTRY StubShaderSource( GLuint, GLsizei, const GLchar* const*, const GLint* ) {}
+static void APIENTRY StubCompileShader( GLuint ) {}
+static void APIENTRY StubDeleteShader( GLuint ) {}
+static void APIENTRY StubAttachShader( GLuint, GLuint ) {}
+static void APIENTRY StubDetachShader( GLuint, GLuint ) {}
+static void APIENTRY StubLinkProgram( GLuint ) {}
+static void APIENTRY StubUseProgram( GLuint ) {}
+static GLenum APIENTRY StubGetError() { return GL_NO_ERROR; }
+static void APIENTRY StubGetShaderiv( GLuint, GLenum, GLint* params ) { *params = GL_TRUE; }
+
+
+static void APIENTRY StubGetProgramiv( GLuint, GLenum parameter, GLint* params ) {
+	switch ( parameter ) {
+		case GL_ACTIVE_UNIFORMS:			*params = (GLint) s_stubUniforms.size();	break;
+		case GL_ACTIVE_UNIFORM_MAX_LENGTH:	*params = 64;								break;
+		default:							*params = GL_TRUE;							break;
+	}
+}
+
+
+static void APIENTRY StubGetActiveUniform( GLuint, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name ) {
+	const StubGLUniform_T& uniform = s_stubUniforms[index];
+	strncpy( name, uniform.activeName, bufSize - 1 );
+	name[bufSize - 1] = '\0';
+	*length = (GLsizei) strlen( name );
+	*size = uniform.arraySize;
+	*type = uniform.type;
+}
+
+
+static GLint APIENTRY StubGetUniformLocation( GLuint, const GLchar* name ) {
+	s_stubCounts.uniformNameLookups++;
+	const StubGLUniform_T* uniform = FindStubUniform( name );
+	return ( uniform == nullptr ) ? -1 : uniform->location;
+}
+
+
+static GLuint APIENTRY StubGetUniformBlockIndex( GLuint, const GLchar* blockName ) {
+	if ( !s_stubHasBlocks ) {
+		return GL_INVALID_INDEX;
+	}
+	return ( strcmp( blockName, "FrameBlock" ) == 0 ) ? 0 : 1;
+}
+
+
+static void APIENTRY StubUniformBlockBinding( GLuint, GLuint, GLuint ) {}
+
+
+// Vertex3D_PCU's attributes; lit.vs has no COLOR
+static GLint APIENTRY StubGetAttribLocation( GLuint, const GLchar* name ) {
+	s_stubCounts.attributeNameLookups++;
+	if ( strcmp( name, "POSITION" ) == 0 ) {
+		return 0;
+	}
+	if ( strcmp( name, "UV" ) == 0 ) {
+		return 2;
+	}
+	return -1;
+}
+
+
+static void RecordUpload( GLint location ) {
+	s_stubCounts.uniformUploads++;
+	s_stubCounts.uploadedLocations.push_back( location );
+}
+
+
+static void APIENTRY StubUniform1fv( GLint location, GLsizei, const GLfloat* ) { RecordUpload( location ); }
+static void APIENTRY StubUniform3fv( GLint location, GLsizei, const GLfloat* ) { RecordUpload( location ); }
+static void APIENTRY StubUniform4fv( GLint location, GLsizei, const GLfloat* ) { RecordUpload( location ); }
+static void APIENTRY StubProgramUniformMatrix4fv( GLuint, GLint location, GLsizei, GLboolean, const GLfloat* ) { RecordUpload( location ); }
+
+
+static void APIENTRY StubGenBuffers( GLsizei count, GLuint* buffers ) {
+	for ( GLsizei bufferIndex = 0; bufferIndex < count; bufferIndex++ ) {
+		buffers[bufferIndex] = s_stubNextHandle++;
+	}
+}
+static void APIENTRY StubDeleteBuffers( GLsizei, const GLuint* ) {}
+static void APIENTRY StubBindBuffer( GLenum, GLuint ) {}
+static void APIENTRY StubBufferData( GLenum, GLsizeiptr, const void*, GLenum ) { s_stubCounts.bufferUploads++; }
+static void APIENTRY StubBufferSubData( GLenum, GLintptr, GLsizeiptr, const void* ) { s_stubCounts.bufferUploads++; }
+static void APIENTRY StubBindBufferBase( GLenum, GLuint, GLuint ) { s_stubCounts.bufferBaseBinds++; }
+static void APIENTRY StubEnableVertexAttribArray( GLuint ) {}
+static void APIENTRY StubVertexAttribPointer( GLuint, GLint, GLenum, GLboolean, GLsizei, const void* ) {}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// lit.vs + lit.fs as the driver reports them. With blocks, the camera and frame members are active but have no
+// location.
+static void InstallStubGL( bool hasBlocks ) {
+	glCreateShader = StubCreateShader;
+	glCreateProgram = StubCreateProgram;
+	glShaderSource = StubShaderSource;
+	glCompileShader = StubCompileShader;
+	glDeleteShader = StubDeleteShader;
+	glAttachShader = StubAttachShader;
+	glDetachShader = StubDetachShader;
+	glLinkProgram = StubLinkProgram;
+	glUseProgram = StubUseProgram;
+	glGetError = StubGetError;
+	glGetShaderiv = StubGetShaderiv;
+	glGetProgramiv = (PFNGLGETPROGRAMIVARBPROC) StubGetProgramiv;
+	glGetActiveUniform = StubGetActiveUniform;
+	glGetUniformLocation = StubGetUniformLocation;
+	glGetUniformBlockIndex = StubGetUniformBlockIndex;
+	glUniformBlockBinding = StubUniformBlockBinding;
+	glGetAttribLocation = StubGetAttribLocation;
+	glUniform1fv = StubUniform1fv;
+	glUniform3fv = StubUniform3fv;
+	glUniform4fv = StubUniform4fv;
+	glProgramUniformMatrix4fv = StubProgramUniformMatrix4fv;
+	glGenBuffers = StubGenBuffers;
+	glDeleteBuffers = StubDeleteBuffers;
+	glBindBuffer = StubBindBuffer;
+	glBufferData = StubBufferData;
+	glBufferSubData = StubBufferSubData;
+	glBindBufferBase = StubBindBufferBase;
+	glEnableVertexAttribArray = StubEnableVertexAttribArray;
+	glVertexAttribPointer = StubVertexAttribPointer;
+
+	s_stubHasBlocks = hasBlocks;
+	s_stubCounts = StubGLCounts_T();
+	s_stubUniforms.clear();
+	s_stubUniforms.push_back( { "MODEL", 0, GL_FLOAT_MAT4, 1 } );
+	s_stubUniforms.push_back( { "AMBIENT_COLOR", 1, GL_FLOAT_VEC4, 1 } );
+	s_stubUniforms.push_back( { "AMBIENT_INTENSITY", 2, GL_FLOAT, 1 } );
+	s_stubUniforms.push_back( { "LIGHT_POSITION[0]", 3, GL_FLOAT_VEC3, 8 } );
+	s_stubUniforms.push_back( { "LIGHT_COLOR[0]", 11, GL_FLOAT_VEC4, 8 } );
+	s_stubUniforms.push_back( { "SHADOW_VP[0]", 19, GL_FLOAT_MAT4, 8 } );
+	s_stubUniforms.push_back( { "SPECULAR_POWER", 27, GL_FLOAT, 1 } );
+	s_stubUniforms.push_back( { "gTexDiffuse", 28, GL_SAMPLER_2D, 1 } );
+	s_stubUniforms.push_back( { "VIEW", hasBlocks ? -1 : 29, GL_FLOAT_MAT4, 1 } );
+	s_stubUniforms.push_back( { "EYE_POSITION", hasBlocks ? -1 : 30, GL_FLOAT_VEC3, 1 } );
+	s_stubUniforms.push_back( { "FOG_FACTOR", hasBlocks ? -1 : 31, GL_FLOAT, 1 } );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+UNIT_TEST( Uniform_ReflectFillsTableFromDriver ) {
+	InstallStubGL( true );
+	ShaderProgram program;
+	TEST_CHECK( program.LoadFromString( "", "" ) );
+
+	// One name lookup per active uniform at link, none after
+	TEST_CHECK( s_stubCounts.uniformNameLookups == (int) s_stubUniforms.size() );
+	TEST_CHECK( program.GetUniforms().GetUniformCount() == 8 );
+	TEST_CHECK( program.HasUniformBlock( UNIFORM_BLOCK_FRAME ) );
+	TEST_CHECK( program.HasUniformBlock( UNIFORM_BLOCK_CAMERA ) );
+
+	for ( size_t uniformIndex = 0; uniformIndex < s_stubUniforms.size(); uniformIndex++ ) {
+		std::string bareName = s_stubUniforms[uniformIndex].activeName;
+		bareName = bareName.substr( 0, bareName.find( '[' ) );
+		int location = program.GetUniformLocation( MakeUniformID( bareName ) );
+		if ( location != s_stubUniforms[uniformIndex].location ) {
+			UnitTestRegistry::ReportFailure( __FILE__, __LINE__, Stringf( "%s: table says %d, driver says %d", bareName.c_str(), location, s_stubUniforms[uniformIndex].location ) );
+		}
+	}
+
+	const UniformInfo_T* lightColor = program.GetUniforms().Find( MakeUniformID( "LIGHT_COLOR" ) );
+	TEST_CHECK( lightColor != nullptr && lightColor->name == "LIGHT_COLOR" && lightColor->arraySize == 8 );
+	TEST_CHECK( program.GetUniformLocation( MakeUniformID( "NOT_A_UNIFORM" ) ) == UNIFORM_LOCATION_NONE );
+	TEST_CHECK( s_stubCounts.uniformNameLookups == (int) s_stubUniforms.size() );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+UNIT_TEST( Uniform_RendererUploadsToReflectedLocations ) {
+	InstallStubGL( false );
+	ShaderProgram program;
+	TEST_CHECK( program.LoadFromString( "", "" ) );
+	Shader shader( &program );
+	Renderer* renderer = new Renderer();
+	renderer->SetShader( &shader );
+	s_stubCounts = StubGLCounts_T();
+
+	Matrix44 model;
+	Rgba ambient;
+	float intensity = 1.f;
+	Vector3 lightPositions[8];
+	Rgba lightColors[8];
+	Matrix44 shadowVPs[8];
+
+	renderer->SetUniform( MakeUniformID( "MODEL" ), &model );
+	renderer->SetUniform( MakeUniformID( "AMBIENT_COLOR" ), &ambient );
+	renderer->SetUniform( MakeUniformID( "AMBIENT_INTENSITY" ), &intensity );
+	renderer->SetUniform( MakeUniformID( "LIGHT_POSITION" ), lightPositions, 8 );
+	renderer->SetUniform( MakeUniformID( "LIGHT_COLOR" ), lightColors, 8 );
+	renderer->SetUniform( MakeUniformID( "SHADOW_VP" ), shadowVPs, 8 );
+	renderer->SetUniform( std::string( "FOG_FACTOR" ), &intensity );
+	renderer->SetUniform( MakeUniformID( "NOT_A_UNIFORM" ), &intensity );
+
+	const int expectedLocations[] = { 0, 1, 2, 3, 11, 19, 31 };
+	const int expectedCount = sizeof( expectedLocations ) / sizeof( expectedLocations[0] );
+	TEST_CHECK( s_stubCounts.uniformUploads == expectedCount );
+	TEST_CHECK( (int) s_stubCounts.uploadedLocations.size() == expectedCount );
+	for ( int uploadIndex = 0; uploadIndex < expectedCount && uploadIndex < (int) s_stubCounts.uploadedLocations.size(); uploadIndex++ ) {
+		TEST_CHECK( s_stubCounts.uploadedLocations[uploadIndex] == expectedLocations[uploadIndex] );
+	}
+	TEST_CHECK( s_stubCounts.uniformNameLookups == 0 );
+
+	delete renderer;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+UNIT_TEST( Uniform_BindMeshCachesAttributeLocations ) {
+	InstallStubGL( false );
+	ShaderProgram program;
+	TEST_CHECK( program.LoadFromString( "", "" ) );
+	Shader shader( &program );
+	Renderer* renderer = new Renderer();
+	renderer->SetShader( &shader );
+
+	Vertex3D_PCU vertices[3];
+	Mesh mesh( 3, vertices );
+	s_stubCounts = StubGLCounts_T();
+
+	renderer->BindMesh( &mesh );
+	TEST_CHECK( s_stubCounts.attributeNameLookups == (int) Vertex3D_PCU::LAYOUT.GetAttributeCount() );
+	for ( int bindIndex = 0; bindIndex < 10; bindIndex++ ) {
+		renderer->BindMesh( &mesh );
+	}
+	TEST_CHECK( s_stubCounts.attributeNameLookups == (int) Vertex3D_PCU::LAYOUT.GetAttributeCount() );
+
+	int nameLookups = -1;
+	const std::vector<int>& locations = program.GetAttributeLocations( &Vertex3D_PCU::LAYOUT, &nameLookups );
+	TEST_CHECK( nameLookups == 0 );
+	TEST_CHECK( locations.size() == 3 && locations[0] == 0 && locations[1] == -1 && locations[2] == 2 );
+
+	// A relink can move attributes, so it starts over
+	TEST_CHECK( program.LoadFromString( "", "" ) );
+	s_stubCounts = StubGLCounts_T();
+	renderer->BindMesh( &mesh );
+	TEST_CHECK( s_stubCounts.attributeNameLookups == (int) Vertex3D_PCU::LAYOUT.GetAttributeCount() );
+
+	delete renderer;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+UNIT_TEST( Uniform_BufferFlushesOnlyOnChange ) {
+	InstallStubGL( true );
+	UniformBuffer buffer;
+
+	CameraBlock_T camera;
+	memset( &camera, 0, sizeof( camera ) );
+	camera.eyePosition = Vector3( 1.f, 2.f, 3.f );
+
+	TEST_CHECK( buffer.Set( camera ) );
+	TEST_CHECK( buffer.Flush( UNIFORM_BLOCK_CAMERA ) );
+	TEST_CHECK( s_stubCounts.bufferUploads == 1 && s_stubCounts.bufferBaseBinds == 1 );
+
+	// Same contents every draw, nothing reaches the driver
+	for ( int drawIndex = 0; drawIndex < 100; drawIndex++ ) {
+		TEST_CHECK( !buffer.Set( camera ) );
+		TEST_CHECK( !buffer.Flush( UNIFORM_BLOCK_CAMERA ) );
+	}
+	TEST_CHECK( s_stubCounts.bufferUploads == 1 && s_stubCounts.bufferBaseBinds == 1 );
+
+	camera.eyePosition.x = 4.f;
+	TEST_CHECK( buffer.Set( camera ) );
+	TEST_CHECK( buffer.Flush( UNIFORM_BLOCK_CAMERA ) );
+	TEST_CHECK( s_stubCounts.bufferUploads == 2 && s_stubCounts.bufferBaseBinds == 2 );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Lookups compare the whole ID, a name that only shares the slot can't pick up another uniform's location
+UNIT_TEST( Uniform_TableOnlyMatchesWholeID ) {
+	UniformTable table;
+	TEST_CHECK( table.Add( "MODEL", 5 ) );
+	TEST_CHECK( table.Add( "LIGHT_COLOR[0]", 9, 0, 8 ) );
+	TEST_CHECK( table.Add( "LIGHT_COLOR", 9 ) );		// Same name again is fine
+
+	UniformID modelID = MakeUniformID( "MODEL" );
+	TEST_CHECK( table.GetLocation( modelID ) == 5 );
+	TEST_CHECK( table.GetLocation( modelID ^ ( 1ull << 40 ) ) == UNIFORM_LOCATION_NONE );
+	TEST_CHECK( table.GetLocation( MakeUniformID( "LIGHT_COLOR" ) ) == 9 );
+
+	// Enough uniforms to force a couple of rehashes
+	for ( int uniformIndex = 0; uniformIndex < 40; uniformIndex++ ) {
+		TEST_CHECK( table.Add( Stringf( "U%d", uniformIndex ).c_str(), 100 + uniformIndex ) );
+	}
+	for ( int uniformIndex = 0; uniformIndex < 40; uniformIndex++ ) {
+		TEST_CHECK( table.GetLocation( MakeUniformID( Stringf( "U%d", uniformIndex ) ) ) == 100 + uniformIndex );
+	}
+	TEST_CHECK( table.GetLocation( modelID ) == 5 );
+	TEST_CHECK( table.GetUniformCount() == 42 );
+}
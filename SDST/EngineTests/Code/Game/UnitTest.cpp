@@ -0,0 +1,66 @@
+#include "Game/UnitTest.hpp"
+
+#include <stdio.h>
+#include <vector>
+
+
+//----------------------------------------------------------------------------------------------------------------
+struct UnitTestEntry_T {
+	const char* name;
+	UnitTestFunction function;
+};
+
+
+// Function statics, registrars in other translation units can run before a file-scope vector is constructed
+//----------------------------------------------------------------------------------------------------------------
+static std::vector< UnitTestEntry_T >& GetUnitTests() {
+	static std::vector< UnitTestEntry_T > s_tests;
+	return s_tests;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+static int& GetCurrentFailureCount() {
+	static int s_failureCount = 0;
+	return s_failureCount;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void UnitTestRegistry::Register( const char* name, UnitTestFunction function ) {
+	GetUnitTests().push_back( UnitTestEntry_T{ name, function } );
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+int UnitTestRegistry::RunAll( const std::string& nameFilter ) {
+	int runCount = 0;
+	int failedTestCount = 0;
+
+	for ( const UnitTestEntry_T& test : GetUnitTests() ) {
+		if ( !nameFilter.empty() && std::string( test.name ).find( nameFilter ) == std::string::npos ) {
+			continue;
+		}
+
+		GetCurrentFailureCount() = 0;
+		test.function();
+		runCount++;
+
+		if ( GetCurrentFailureCount() > 0 ) {
+			failedTestCount++;
+			printf( "[FAIL] %s\n", test.name );
+		} else {
+			printf( "[ OK ] %s\n", test.name );
+		}
+	}
+
+	printf( "%d of %d tests passed\n", runCount - failedTestCount, runCount );
+	return failedTestCount;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------
+void UnitTestRegistry::ReportFailure( const char* file, int line, const std::string& message ) {
+	GetCurrentFailureCount()++;
+	printf( "    %s(%d): %s\n", file, line, message.c_str() );
+}
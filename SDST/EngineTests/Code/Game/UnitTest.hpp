@@ -0,0 +1,43 @@
+#pragma once
+#include "Engine/Core/StringUtils.hpp"
+
+#include <string>
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Headless engine tests. Each UNIT_TEST registers itself before main, EngineTests.exe runs every test whose name
+// contains the first argument (or all of them) and returns the number that failed.
+typedef void (*UnitTestFunction)();
+
+
+class UnitTestRegistry {
+
+public:
+	static void Register( const char* name, UnitTestFunction function );
+	static int RunAll( const std::string& nameFilter );
+
+	static void ReportFailure( const char* file, int line, const std::string& message );
+};
+
+
+struct UnitTestRegistrar_T {
+	UnitTestRegistrar_T( const char* name, UnitTestFunction function ) { UnitTestRegistry::Register( name, function ); }
+};
+
+
+#define UNIT_TEST( name ) \
+	static void UnitTest_##name(); \
+	static UnitTestRegistrar_T s_unitTestRegistrar_##name( #name, &UnitTest_##name ); \
+	static void UnitTest_##name()
+
+#define TEST_CHECK( expr ) \
+	do { if ( !(expr) ) { UnitTestRegistry::ReportFailure( __FILE__, __LINE__, #expr ); } } while ( 0 )
+
+#define TEST_CHECK_NEAR( a, b, epsilon ) \
+	do { \
+		double testA = (double) (a); \
+		double testB = (double) (b); \
+		if ( !(testA - testB <= (epsilon) && testB - testA <= (epsilon)) ) { \
+			UnitTestRegistry::ReportFailure( __FILE__, __LINE__, Stringf( "%s = %g, %s = %g", #a, testA, #b, testB ) ); \
+		} \
+	} while ( 0 )
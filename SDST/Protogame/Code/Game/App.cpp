@@ -100,6 +100,7 @@ void App::Run() {
 
 	}
 
+	Profiler::Shutdown();
 	CommandRegistration::SaveCommandHistory();
 	DebugRenderShutdown();
 	void (*fncptr)( unsigned int msg, size_t wparam, size_t lparam ) = GetMessages;
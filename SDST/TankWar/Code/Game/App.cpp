@@ -14,6 +14,12 @@
 #include "Engine/Profiler/Profiler.hpp"
 #include "Engine/Profiler/ProfilerWindow.hpp"
 #include "Engine/Net/Net.hpp"
+#include "Engine/Async/JobSystem.hpp"
+#include "Engine/Math/MatrixKernels.hpp"
+#include "Engine/Renderer/DrawQueue.hpp"
+#include "Engine/Renderer/LightClusterGrid.hpp"
+#include "Engine/Math/AABBTree.hpp"
+#include "Engine/Renderer/RingAllocator.hpp"
 #include "Game/GameDebug.hpp"
 
 typedef void (*windows_message_handler_cb)( unsigned int msg, size_t wparam, size_t lparam ); 
@@ -28,6 +34,7 @@ InputSystem* g_theInputSystem;
 Blackboard* g_theBlackboard;
 Clock* g_masterClock;
 AudioSystem* g_audioSystem;
+JobSystem* g_theJobSystem;
 
 bool g_isQuitting = false;
 
@@ -56,6 +63,7 @@ void App::Run() {
 
 		g_masterClock->BeginFrame();
 		Profiler::MarkFrame();
+		g_theJobSystem->ProcessFinishedJobs();
 		g_theRenderer->BeginFrame();
 		g_theInputSystem->BeginFrame();
 		g_audioSystem->BeginFrame();
@@ -71,6 +79,10 @@ void App::Run() {
 		g_theRenderer->EndFrame();
 
 	}
+	Profiler::Shutdown();
+	g_theJobSystem->Shutdown();
+	delete g_theJobSystem;
+	g_theJobSystem = nullptr;
 	Net::Shutdown();
 	DebugRenderShutdown();
 	void (*fncptr)( unsigned int msg, size_t wparam, size_t lparam ) = GetMessages;
@@ -85,6 +97,8 @@ void App::Run() {
 void App::Initialize() {
 	Logger::Startup();
 	g_masterClock = new Clock();
+	g_theJobSystem = new JobSystem();
+	g_theJobSystem->Startup();
 	g_theBlackboard = new Blackboard("Data/GameConfig.xml");
 	g_theRenderer = new Renderer();
 	g_theInputSystem = new InputSystem();
@@ -97,6 +111,12 @@ void App::Initialize() {
 	ProfilerWindow::Initialize();
 
 	DebugRenderStartup(g_theRenderer);
+	MatrixKernelsStartup();
+	DrawQueueStartup();
+	LightClusterGridStartup();
+	AABBTreeStartup();
+	RingAllocatorStartup();
+	RenderStatsStartup();
 	RegisterDebugTimeCommands();
 
 	void (*fncptr)( unsigned int msg, size_t wparam, size_t lparam ) = GetMessages;
@@ -5,9 +5,11 @@
 #include "Engine/Renderer/Renderer.hpp"
 
 
-Bullet::Bullet(PlayState* playState, eTeam team) 
+Bullet::Bullet(PlayState* playState, eTeam team, const Vector3& spawnPosition) 
 	: GameObject(playState, team)
 	, lifeTimer(currentState->m_sceneClock) {
+	transform.position = spawnPosition;
+	m_previousPosition = spawnPosition;		// The first frame's swept test starts at the muzzle
 	linearDrag = 0.f;
 	angularDrag = 0.f;
 	m_collisionRadius = 0.1f;
@@ -44,15 +46,12 @@ void Bullet::BuildBulletMesh() {
 
 
 void Bullet::Update() {
+	m_previousPosition = transform.position;
 	GameObject::Update();
 	m_bulletLight->m_position = transform.position;
 	if (lifeTimer.HasElapsed()) {
 		Kill();
 	}
-
-	if (currentState->testGameMap->GetHeightAboveTerrainAtPoint(transform.position) <= 0.f) {
-		Kill();
-	}
 }
 
 
@@ -64,4 +63,9 @@ void Bullet::Kill() {
 
 float Bullet::GetDamage() const {
 	return m_damage;
+}
+
+
+const Vector3& Bullet::GetPreviousPosition() const {
+	return m_previousPosition;
 }
\ No newline at end of file
@@ -9,7 +9,7 @@
 class Bullet : public GameObject {
 
 public:
-	Bullet(PlayState* state, eTeam team);
+	Bullet(PlayState* state, eTeam team, const Vector3& spawnPosition);
 	~Bullet();
 
 
@@ -17,6 +17,7 @@ public:
 	virtual void Kill() override;
 
 	float GetDamage() const;
+	const Vector3& GetPreviousPosition() const;
 
 private:
 	void BuildBulletMesh();
@@ -24,6 +25,7 @@ private:
 	Light* m_bulletLight = nullptr;
 	Mesh* m_bulletMesh = nullptr;
 	Stopwatch lifeTimer;
+	Vector3 m_previousPosition;	// Before this frame's move, PlayState casts from here to check for terrain hits
 
 	AudioCue* m_explosionSound = nullptr;
 
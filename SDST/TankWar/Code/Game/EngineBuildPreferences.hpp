@@ -9,4 +9,5 @@
 //
 
 //#define ENGINE_DISABLE_AUDIO	// (If uncommented) Disables AudioSystem code and fmod linkage.
+//#define ENGINE_DISABLE_SIMD	// (If uncommented) Uses the scalar Matrix44 and frustum culling kernels instead of SSE/AVX.
 
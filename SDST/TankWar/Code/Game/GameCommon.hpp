@@ -5,6 +5,7 @@
 #include "Engine/InputSystem/InputSystem.hpp"
 #include "Engine/Core/Window.hpp"
 #include "Engine/Core/Clock.hpp"
+#include "Engine/Async/JobSystem.hpp"
 
 #define UNUSED(x) (void)(x);
 
@@ -17,6 +18,7 @@ extern TheGame* g_theGame;
 extern InputSystem* g_theInputSystem;
 extern Clock* g_masterClock;
 extern AudioSystem* g_audioSystem;
+extern JobSystem* g_theJobSystem;
 
 extern bool g_devModeActive;
 
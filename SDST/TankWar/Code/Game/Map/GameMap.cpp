@@ -4,9 +4,13 @@
 #include "Engine/Math/SmoothNoise.hpp"
 #include "Engine/Renderer/MeshBuilder.hpp"
 #include "Engine/Renderer/DebugRender.hpp"
+#include "Engine/Profiler/Profiler.hpp"
+
+#include <math.h>
 
 GameMap::GameMap() {
 	GenerateHeightMap(GetRandomIntLessThan(1000000), MAP_CHUNKS_X, MAP_CHUNKS_Y, MAP_CHUNK_SIZE, MAP_MIN_HEIGHT, MAP_MAX_HEIGHT);
+	BuildHeightBoundsTree();
 	GenerateNewChunks( MAP_CHUNKS_X, MAP_CHUNKS_Y );
 }
 
@@ -19,142 +23,87 @@ GameMap::~GameMap() {
 }
 
 
+//-----------------------------------------------------------------------------------------------
+// Each chunk samples noise for its own block of the height field on a job worker, then normals
+// are filled in by row bands once every height is known.
+//
 void GameMap::GenerateHeightMap( unsigned int seed, unsigned int chunksX, unsigned int chunksY, unsigned int chunkSize, float minHeight, float maxHeight ) {
-	
-	m_heightMap = new Image();
-	m_heightMap->SetDimensions(chunksX * chunkSize + 1, chunksY * chunkSize + 1);
-	m_normals.resize((chunksX * chunkSize + 1) * (chunksY * chunkSize + 1));
+	PROFILER_SCOPED_PUSH();
 	m_dimensions = IntVector2(chunksX * chunkSize + 1, chunksY * chunkSize + 1);
+	m_heightField.SetDimensions(m_dimensions);
 	m_bounds = AABB3( Vector3(0.f, minHeight - 10.f, 0.f), Vector3((float) m_dimensions.x - 1.f, maxHeight + 10.f, (float) m_dimensions.y - 1.f) );
 
 	m_maxHeight = maxHeight;
 	m_minHeight = minHeight;
 	m_chunkSize = chunkSize;
 
-	for (unsigned int row = 0; row < chunksY * chunkSize + 1; row++) {
-		for (unsigned int col = 0; col < chunksX * chunkSize + 1; col++) {
-			float noiseValue = Compute2dPerlinNoise( (float) col, (float) row, 60, 3, 0.5f, 2.f, true, seed );
-			float mappedNoiseValue = RangeMapFloat(noiseValue, -1.f, 1.f, 0.f, 255.f);
-			m_heightMap->PushTexel( Rgba((unsigned char) RoundToNearestInt(mappedNoiseValue), 0, 0, 0) );
+	// The last chunk in each row and column also owns the shared edge samples
+	g_theJobSystem->ParallelFor(0, (int) (chunksX * chunksY), 1, [&]( int chunkBegin, int chunkEnd ) {
+		std::vector<float> noiseValues;
+		for (int chunkIndex = chunkBegin; chunkIndex < chunkEnd; chunkIndex++) {
+			int startX = (chunkIndex % chunksX) * chunkSize;
+			int startY = (chunkIndex / chunksX) * chunkSize;
+			int width = (startX + (int) chunkSize == m_dimensions.x - 1) ? chunkSize + 1 : chunkSize;
+			int height = (startY + (int) chunkSize == m_dimensions.y - 1) ? chunkSize + 1 : chunkSize;
+
+			noiseValues.resize(width * height);
+			Compute2dPerlinNoiseGrid( Vector2((float) startX, (float) startY), Vector2(1.f, 1.f), width, height, noiseValues.data(), 60, 3, 0.5f, 2.f, true, seed );
+
+			for (int row = 0; row < height; row++) {
+				for (int col = 0; col < width; col++) {
+					float noiseValue = noiseValues[ (row * width) + col ];
+					m_heightField.SetHeight( startX + col, startY + row, RangeMapFloat(noiseValue, -1.f, 1.f, minHeight, maxHeight) );
+				}
+			}
 		}
-	}
-
+	});
 
+	g_theJobSystem->ParallelFor(0, m_dimensions.y, (int) chunkSize, [&]( int rowBegin, int rowEnd ) {
+		m_heightField.ComputeNormals(rowBegin, rowEnd);
+	});
+}
 
-	for (int normal = 0; normal < m_heightMap->GetDimensions().x * m_heightMap->GetDimensions().y; normal++) {
-		IntVector2 coord = GetCoordForIndex(normal);
-		
-
-		/*
-
-	    ul---u
-		|\ 2|\
-		| \ | \
-		| 1\|3 \
-		l---c---r
-		 \ 6|\ 4| 
-		  \ | \ | 
-		   \|5 \|  
-            d---dr
-		*/
-
-		int trianglesInvolved = 0;
-
-		IntVector2 uCoord	= coord + IntVector2( 0, 1);
-		IntVector2 dCoord	= coord + IntVector2( 0,-1);
-		IntVector2 rCoord	= coord + IntVector2( 1, 0);
-		IntVector2 lCoord	= coord + IntVector2(-1, 0);
-		IntVector2 ulCoord	= coord + IntVector2(-1, 1);
-		IntVector2 drCoord	= coord + IntVector2( 1,-1);
-
-		float cHeight	= GetHeightAtDiscretePoint(coord);
-		Vector3 c	= Vector3( (float) coord.x, cHeight, (float) coord.y); 
-
-		Vector3 averageNormal = Vector3::ZERO;
-		
-		// Check if triangles 1 and 2 exist
-		if (IsCoordValid(ulCoord)) {
-			float uHeight	= GetHeightAtDiscretePoint(uCoord);
-			float lHeight	= GetHeightAtDiscretePoint(lCoord);
-			float ulHeight	= GetHeightAtDiscretePoint(ulCoord);
-			Vector3 u	= Vector3( (float) uCoord.x, uHeight, (float) uCoord.y ); 
-			Vector3 l	= Vector3( (float) lCoord.x, lHeight, (float) lCoord.y ); 
-			Vector3 ul	= Vector3( (float) ulCoord.x, ulHeight, (float) ulCoord.y ); 
-			
-			Vector3 tangent1 = c - l;
-			Vector3 bitangent1 = ul - l;
-			Vector3 normal1 = Vector3::CrossProduct(bitangent1, tangent1);
-
-			Vector3 tangent2 = u - c;
-			Vector3 bitangent2 = u - ul;
-			Vector3 normal2 = Vector3::CrossProduct(bitangent2, tangent2);
-			
-			trianglesInvolved += 2;
-			averageNormal += normal1;
-			averageNormal += normal2;
-		}
-
-		// check if triangle 3 exists
-		if (IsCoordValid(uCoord) && IsCoordValid(rCoord)) {
-			float uHeight	= GetHeightAtDiscretePoint(uCoord);
-			float rHeight	= GetHeightAtDiscretePoint(rCoord);
-			Vector3 u	= Vector3( (float) uCoord.x, uHeight, (float) uCoord.y ); 
-			Vector3 r	= Vector3( (float) rCoord.x, rHeight, (float) rCoord.y ); 
-
-			Vector3 tangent3 = r - c;
-			Vector3 bitangent3 = u - c;
-			Vector3 normal3 = Vector3::CrossProduct(bitangent3, tangent3);
-
-			trianglesInvolved += 1;
-			averageNormal += normal3;
-		}
 
-		// Check if triangles 4 and 5 exist
-		if (IsCoordValid(drCoord)) {
-			float dHeight	= GetHeightAtDiscretePoint(dCoord);
-			float rHeight	= GetHeightAtDiscretePoint(rCoord);
-			float drHeight	= GetHeightAtDiscretePoint(drCoord);
-			Vector3 d	= Vector3( (float) dCoord.x, dHeight, (float) dCoord.y ); 
-			Vector3 r	= Vector3( (float) rCoord.x, rHeight, (float) rCoord.y );
-			Vector3 dr	= Vector3( (float) drCoord.x, drHeight, (float) drCoord.y );
-
-			Vector3 tangent4 = r - c;
-			Vector3 bitangent4 = r - dr;
-			Vector3 normal4 = Vector3::CrossProduct(bitangent4, tangent4);
-
-			Vector3 tangent5 = dr - d;
-			Vector3 bitangent5 = c - d;
-			Vector3 normal5 = Vector3::CrossProduct(bitangent5, tangent5);
-
-			trianglesInvolved += 2;
-			averageNormal += normal4;
-			averageNormal += normal5;
+void GameMap::BuildHeightBoundsTree() {
+	m_heightBounds.clear();
+	m_heightBoundsDimensions.clear();
+
+	// Level 0: a cell's bilinear patch never leaves the range of its four corners
+	IntVector2 cells( m_dimensions.x - 1, m_dimensions.y - 1 );
+	m_heightBounds.push_back( std::vector<FloatRange>( cells.x * cells.y ) );
+	m_heightBoundsDimensions.push_back( cells );
+	for (int cellY = 0; cellY < cells.y; cellY++) {
+		for (int cellX = 0; cellX < cells.x; cellX++) {
+			float h00 = GetHeightAtDiscretePoint( IntVector2( cellX, cellY ) );
+			float h10 = GetHeightAtDiscretePoint( IntVector2( cellX + 1, cellY ) );
+			float h01 = GetHeightAtDiscretePoint( IntVector2( cellX, cellY + 1 ) );
+			float h11 = GetHeightAtDiscretePoint( IntVector2( cellX + 1, cellY + 1 ) );
+			m_heightBounds[0][ (cellY * cells.x) + cellX ] = FloatRange( Min( Min( h00, h10 ), Min( h01, h11 ) ), Max( Max( h00, h10 ), Max( h01, h11 ) ) );
 		}
+	}
 
-		// check if triangle 6 exists
-		if (IsCoordValid(dCoord) && IsCoordValid(lCoord)) {
-			float dHeight	= GetHeightAtDiscretePoint(dCoord);
-			float lHeight	= GetHeightAtDiscretePoint(lCoord);
-			Vector3 d	= Vector3( (float) dCoord.x, dHeight, (float) dCoord.y ); 
-			Vector3 l	= Vector3( (float) lCoord.x, lHeight, (float) lCoord.y ); 
-
-			Vector3 tangent6 = c - l;
-			Vector3 bitangent6 = c - d;
-			Vector3 normal6 = Vector3::CrossProduct(bitangent6, tangent6);
-
-			trianglesInvolved += 1;
-			averageNormal += normal6;
+	// Each level above merges 2x2 blocks, odd edges just carry their one or two children
+	while (m_heightBoundsDimensions.back().x > 1 || m_heightBoundsDimensions.back().y > 1) {
+		const IntVector2 childDimensions = m_heightBoundsDimensions.back();
+		IntVector2 dimensions( (childDimensions.x + 1) / 2, (childDimensions.y + 1) / 2 );
+		std::vector<FloatRange> level( dimensions.x * dimensions.y, FloatRange( 1.0e30f, -1.0e30f ) );
+
+		const std::vector<FloatRange>& children = m_heightBounds.back();
+		for (int childY = 0; childY < childDimensions.y; childY++) {
+			for (int childX = 0; childX < childDimensions.x; childX++) {
+				const FloatRange& child = children[ (childY * childDimensions.x) + childX ];
+				FloatRange& parent = level[ ((childY / 2) * dimensions.x) + (childX / 2) ];
+				parent.min = Min( parent.min, child.min );
+				parent.max = Max( parent.max, child.max );
+			}
 		}
 
-		averageNormal = averageNormal * (1.f / (float) trianglesInvolved);
-
-		m_normals[normal] = averageNormal.GetNormalized();
-		
+		m_heightBounds.push_back( level );
+		m_heightBoundsDimensions.push_back( dimensions );
 	}
 }
 
 
-
 void GameMap::GenerateNewChunks( unsigned int x, unsigned int y ) {
 
 	Mesh* waterChunkMesh = new Mesh();
@@ -171,7 +120,7 @@ void GameMap::GenerateNewChunks( unsigned int x, unsigned int y ) {
 			Mesh* chunkMesh = new Mesh();
 			MeshBuilder chunkBuilder;
 			chunkBuilder.Begin(TRIANGLES, false);
-			chunkBuilder.BuildTexturedGridFromHeightMap(m_heightMap, m_normals, IntVector2(m_chunkSize * col, m_chunkSize * row), m_chunkSize, m_minHeight, m_maxHeight );
+			chunkBuilder.BuildTexturedGridFromHeightField(m_heightField, IntVector2(m_chunkSize * col, m_chunkSize * row), m_chunkSize );
 			chunkBuilder.End();
 			chunkMesh->FromBuilderAsType<Vertex3D_Lit>(&chunkBuilder);
 
@@ -195,31 +144,17 @@ void GameMap::GenerateNewChunks( unsigned int x, unsigned int y ) {
 
 
 float GameMap::GetHeightAtDiscretePoint( IntVector2 const& coord ) {
-	return RangeMapFloat(m_heightMap->GetTexel(coord.x, coord.y).r, 0.f, 255.f, m_minHeight, m_maxHeight);
+	return m_heightField.GetHeight(coord.x, coord.y);
 }
 
 
 Vector3 GameMap::GetNormalAtDiscretePoint( IntVector2 const& coord ) {
-	return m_normals[coord.y * m_dimensions.x + coord.x];
+	return m_heightField.GetNormal(coord.x, coord.y);
 }
 
 
 float GameMap::GetHeightAtPoint( Vector2 const& point ) {
-	IntVector2 lowerCoord(point);
-	IntVector2 upperCoord(point + Vector2(1.f, 1.f));
-	float xRemainder = point.x - (float) lowerCoord.x;
-	float yRemainder = point.y - (float) lowerCoord.y;
-	
-	float bottomLeftHeight	= GetHeightAtDiscretePoint( IntVector2( lowerCoord.x, lowerCoord.y ) );
-	float bottomRightHeight = GetHeightAtDiscretePoint( IntVector2( upperCoord.x, lowerCoord.y ) );
-	float topLeftHeight		= GetHeightAtDiscretePoint( IntVector2( lowerCoord.x, upperCoord.y ) );
-	float topRightHeight	= GetHeightAtDiscretePoint( IntVector2( upperCoord.x, upperCoord.y ) );
-
-	float topInterpolated = Interpolate(topLeftHeight, topRightHeight, xRemainder);
-	float bottomInterpolated = Interpolate(bottomLeftHeight, bottomRightHeight, xRemainder);
-	float finalHeight = Interpolate(bottomInterpolated, topInterpolated, yRemainder);
-
-	return finalHeight;
+	return m_heightField.SampleHeight(point.x, point.y);
 }
 
 
@@ -230,95 +165,239 @@ float GameMap::GetHeightAboveTerrainAtPoint( Vector3 const& point ) {
 
 
 Vector3 GameMap::GetNormalAtPoint( Vector2 const& point ) {
-	IntVector2 lowerCoord(point);
-	IntVector2 upperCoord(point + Vector2(1.f, 1.f));
-	float xRemainder = point.x - (float) lowerCoord.x;
-	float yRemainder = point.y - (float) lowerCoord.y;
+	return m_heightField.SampleNormal(point.x, point.y);
+}
 
-	Vector3 bottomLeftNormal	= GetNormalAtDiscretePoint( IntVector2( lowerCoord.x, lowerCoord.y ) );
-	Vector3 bottomRightNormal	= GetNormalAtDiscretePoint( IntVector2( upperCoord.x, lowerCoord.y ) );
-	Vector3 topLeftNormal		= GetNormalAtDiscretePoint( IntVector2( lowerCoord.x, upperCoord.y ) );
-	Vector3 topRightNormal		= GetNormalAtDiscretePoint( IntVector2( upperCoord.x, upperCoord.y ) );
 
-	Vector3 topInterpolated = Interpolate(topLeftNormal, topRightNormal, xRemainder);
-	Vector3 bottomInterpolated = Interpolate(bottomLeftNormal, bottomRightNormal, xRemainder);
-	Vector3 finalHeight = Interpolate(bottomInterpolated, topInterpolated, yRemainder);
+RaycastHit3 GameMap::Raycast( unsigned int maxContacts, const Ray3& ray ) {
+	PROFILER_SCOPED_PUSH();
+	RaycastHit3 result = TraceRay( ray, GAMEMAP_RAYCAST_MAX_DISTANCE );
 
-	return finalHeight;
-}
+	if (!result.hit) {
+		return result;
+	}
 
+	// debug render collision point
+	if (g_theGame->IsDevModeActive()) {
+		DebugRenderPoint(10.f, result.position);
+	}
 
-RaycastHit3 GameMap::Raycast( unsigned int maxContacts, const Ray3& ray ) {
-	std::vector<RaycastHit3> boundsHits = m_bounds.DoesRayIntersect(ray);
+	// debug render the ray of contact
+	if ( g_theGame->IsDevModeActive()) {
+		DebugRenderLineSegment(10.f, ray.position, Rgba(255, 0, 0, 255), result.position, Rgba(255, 0, 0, 255));
+	}
 
-	// If the ray hits bounds, then we should continue
+	return result;
+}
 
-	Vector3 abovePoint;
-	Vector3 belowPoint;
 
-	// If there was only one intersection with the bounds, then we start at the ray origin
-	if ( boundsHits.size() <= 1 ) {
-		abovePoint = ray.position;
+//-----------------------------------------------------------------------------------------------
+// Many rays against the terrain in one call, e.g. every bullet's movement this frame. maxDistances
+// can be null to use GAMEMAP_RAYCAST_MAX_DISTANCE for every ray. No debug drawing per ray.
+//
+void GameMap::RaycastBatch( int rayCount, const Ray3* rays, const float* maxDistances, RaycastHit3* outHits ) {
+	PROFILER_SCOPED_PUSH();
+	for (int rayIndex = 0; rayIndex < rayCount; rayIndex++) {
+		float maxDistance = (maxDistances != nullptr) ? maxDistances[rayIndex] : GAMEMAP_RAYCAST_MAX_DISTANCE;
+		outHits[rayIndex] = TraceRay( rays[rayIndex], maxDistance );
 	}
-	else {
-		abovePoint = boundsHits[0].position;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Clips [tMin, tMax] to one axis of a box. Returns false if the ray misses the slab entirely.
+//
+static bool ClipRayToSlab( float origin, float direction, float slabMin, float slabMax, float& tMin, float& tMax ) {
+	if (direction == 0.f) {
+		return origin >= slabMin && origin <= slabMax;
 	}
 
-	belowPoint = abovePoint + (ray.direction * 0.5f);
-
-	// Step and sample until we get a point below the terrain. If we do 500,000 steps
-	// then say we didn't hit anything
-	unsigned int stepCount = 0;
-	while(m_bounds.Contains(belowPoint) && GetHeightAboveTerrainAtPoint(belowPoint) > 0.f ) {
-		if (stepCount == 500000) {
-			// Early out if we never hit anything in a huge number of steps
-			return RaycastHit3(false, ray.position + (ray.direction * 50000.f), 50000.f);
-		} 
-		abovePoint = belowPoint;
-		belowPoint = abovePoint + (ray.direction * 0.5f);
-		stepCount++;
+	float inverseDirection = 1.f / direction;
+	float tNear = (slabMin - origin) * inverseDirection;
+	float tFar = (slabMax - origin) * inverseDirection;
+	if (tNear > tFar) {
+		float temp = tNear;
+		tNear = tFar;
+		tFar = temp;
 	}
 
-	if (!m_bounds.Contains(belowPoint)) {
-		if (g_theGame->IsDevModeActive()) {
-			DebugRenderPoint(1.f, belowPoint, Rgba(0, 0, 255, 255));
-		}
-		// Early out if the collision point is out of bounds of the game map
-		return RaycastHit3(false, ray.position + (ray.direction * 50000.f), 50000.f);
+	tMin = Max( tMin, tNear );
+	tMax = Min( tMax, tFar );
+	return tMin <= tMax;
+}
+
 
+//-----------------------------------------------------------------------------------------------
+// Walks the min/max quadtree along the ray. A block the ray passes entirely above is skipped in
+// one step and the walk moves back up a level, otherwise it descends until it reaches a single
+// cell and intersects the ray with that cell's bilinear patch exactly.
+//
+RaycastHit3 GameMap::TraceRay( const Ray3& ray, float maxDistance ) {
+	RaycastHit3 miss( false, ray.position + (ray.direction * maxDistance), maxDistance );
+
+	Vector3 direction = ray.direction;
+	float directionLength = direction.NormalizeAndGetLength();
+	if (directionLength == 0.f) {
+		direction = Vector3::UP * -1.f;
+	}
+	const Vector3& origin = ray.position;
+
+	const IntVector2 cells = m_heightBoundsDimensions[0];
+	const int topLevel = (int) m_heightBounds.size() - 1;
+	const FloatRange& mapRange = m_heightBounds[topLevel][0];
+
+	float tStart = 0.f;
+	float tEnd = maxDistance;
+	if (!ClipRayToSlab( origin.x, direction.x, 0.f, (float) cells.x, tStart, tEnd )
+		|| !ClipRayToSlab( origin.z, direction.z, 0.f, (float) cells.y, tStart, tEnd )
+		|| !ClipRayToSlab( origin.y, direction.y, -1.0e30f, mapRange.max, tStart, tEnd )) {
+		return miss;
 	}
 
+	// Cells are tracked as integers and stepped across exact block boundaries, so the walk always moves forward
+	// no matter how far along the ray t is. Only the axis that isn't being crossed is ever read back from t.
+	const int stepX = (direction.x > 0.f) ? 1 : ((direction.x < 0.f) ? -1 : 0);
+	const int stepZ = (direction.z > 0.f) ? 1 : ((direction.z < 0.f) ? -1 : 0);
+
+	Vector3 entry = origin + (direction * tStart);
+	int cellX = ClampInt( (int) floorf(entry.x), 0, cells.x - 1 );
+	int cellZ = ClampInt( (int) floorf(entry.z), 0, cells.y - 1 );
+
+	float t = tStart;
+	int level = topLevel;
+	while (t <= tEnd) {
+		int blockX = cellX >> level;
+		int blockZ = cellZ >> level;
+		int blockMinX = blockX << level;
+		int blockMinZ = blockZ << level;
+		int blockMaxX = Min( blockMinX + (1 << level), cells.x );
+		int blockMaxZ = Min( blockMinZ + (1 << level), cells.y );
+
+		float tExitX = tEnd;
+		float tExitZ = tEnd;
+		if (stepX != 0) {
+			tExitX = ((float) ((stepX > 0) ? blockMaxX : blockMinX) - origin.x) / direction.x;
+		}
+		if (stepZ != 0) {
+			tExitZ = ((float) ((stepZ > 0) ? blockMaxZ : blockMinZ) - origin.z) / direction.z;
+		}
+		float tExit = Max( t, Min( tEnd, Min( tExitX, tExitZ ) ) );
+
+		const FloatRange& bounds = m_heightBounds[level][ (blockZ * m_heightBoundsDimensions[level].x) + blockX ];
+		float lowestY = Min( origin.y + (direction.y * t), origin.y + (direction.y * tExit) );
+
+		if (lowestY <= bounds.max) {
+			if (level > 0) {
+				level--;
+				continue;
+			}
+
+			float hitT = 0.f;
+			Vector3 hitNormal;
+			if (IntersectCell( cellX, cellZ, origin, direction, t, tExit, hitT, hitNormal )) {
+				RaycastHit3 hit( true, origin + (direction * hitT), hitT );
+				hit.normal = hitNormal;
+				return hit;
+			}
+		}
 
-	// Now that we have a belowPoint actually below the terrain, close in on the exact
-	// collision spot.
-	Vector3 midpoint = Average(abovePoint, belowPoint);
-	float terrainHeightAtMidpoint = GetHeightAboveTerrainAtPoint(midpoint);
-	stepCount = 0;
+		if (tExit >= tEnd) {
+			break;
+		}
 
-	while (abs(terrainHeightAtMidpoint) > 0.0005f && stepCount < 10000) {
-		if (terrainHeightAtMidpoint < 0.0f) {
-			belowPoint = midpoint;
+		// Step onto the neighbouring block along whichever axes exit first. The other axis comes from the
+		// position at tExit but never moves backwards, which is what could otherwise undo a step.
+		Vector3 exitPoint = origin + (direction * tExit);
+		int nextX = cellX;
+		int nextZ = cellZ;
+		if (tExitX <= tExitZ) {
+			nextX = (stepX > 0) ? blockMaxX : blockMinX - 1;
+		}
+		else if (stepX != 0) {
+			int exitCellX = ClampInt( (int) floorf(exitPoint.x), blockMinX, blockMaxX - 1 );
+			nextX = (stepX > 0) ? Max( cellX, exitCellX ) : Min( cellX, exitCellX );
 		}
-		else {
-			abovePoint = midpoint;
+		if (tExitZ <= tExitX) {
+			nextZ = (stepZ > 0) ? blockMaxZ : blockMinZ - 1;
 		}
-		midpoint = Average(abovePoint, belowPoint);
-		terrainHeightAtMidpoint = GetHeightAboveTerrainAtPoint(midpoint);
-		stepCount++;
+		else if (stepZ != 0) {
+			int exitCellZ = ClampInt( (int) floorf(exitPoint.z), blockMinZ, blockMaxZ - 1 );
+			nextZ = (stepZ > 0) ? Max( cellZ, exitCellZ ) : Min( cellZ, exitCellZ );
+		}
+
+		if (nextX < 0 || nextX >= cells.x || nextZ < 0 || nextZ >= cells.y) {
+			break;
+		}
+
+		cellX = nextX;
+		cellZ = nextZ;
+		t = tExit;
+		level = (lowestY > bounds.max) ? Min( level + 1, topLevel ) : Min( 1, topLevel );
 	}
 
-	// debug render collision point
-	if (g_theGame->IsDevModeActive()) {
-		DebugRenderPoint(10.f, midpoint);
+	return miss;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Inside a cell the terrain is the bilinear patch GetHeightAtPoint samples,
+//   h(u,v) = h00 + (h10 - h00)u + (h01 - h00)v + (h00 - h10 - h01 + h11)uv
+// and along the ray u, v and y are linear in t, so y - h is a quadratic in t. The hit is its first
+// root in [tStart, tEnd], or tStart itself if the ray is already at or under the surface there.
+//
+bool GameMap::IntersectCell( int cellX, int cellZ, const Vector3& origin, const Vector3& direction, float tStart, float tEnd, float& outT, Vector3& outNormal ) {
+	float h00 = GetHeightAtDiscretePoint( IntVector2( cellX, cellZ ) );
+	float h10 = GetHeightAtDiscretePoint( IntVector2( cellX + 1, cellZ ) );
+	float h01 = GetHeightAtDiscretePoint( IntVector2( cellX, cellZ + 1 ) );
+	float h11 = GetHeightAtDiscretePoint( IntVector2( cellX + 1, cellZ + 1 ) );
+	float slopeU = h10 - h00;
+	float slopeV = h01 - h00;
+	float twist = h00 - h10 - h01 + h11;
+
+	// Parameterize from tStart so everything stays in cell-local, well conditioned numbers
+	float u0 = origin.x + (direction.x * tStart) - (float) cellX;
+	float v0 = origin.z + (direction.z * tStart) - (float) cellZ;
+	float y0 = origin.y + (direction.y * tStart);
+
+	float a = -twist * direction.x * direction.z;
+	float b = direction.y - (slopeU * direction.x) - (slopeV * direction.z) - (twist * ((u0 * direction.z) + (v0 * direction.x)));
+	float c = y0 - h00 - (slopeU * u0) - (slopeV * v0) - (twist * u0 * v0);
+	float sEnd = tEnd - tStart;
+
+	float s = -1.f;
+	if (c <= 0.f) {
+		s = 0.f;
+	}
+	else if (fabsf(a) < 1.0e-7f) {
+		if (b < 0.f) {
+			s = -c / b;
+		}
+	}
+	else {
+		float discriminant = (b * b) - (4.f * a * c);
+		if (discriminant >= 0.f) {
+			// Stable form of the quadratic formula, then pick the smallest non-negative root
+			float q = -0.5f * (b + (b < 0.f ? -sqrtf(discriminant) : sqrtf(discriminant)));
+			float root0 = q / a;
+			float root1 = (q != 0.f) ? c / q : root0;
+			if (root0 > root1) {
+				float temp = root0;
+				root0 = root1;
+				root1 = temp;
+			}
+			s = (root0 >= 0.f) ? root0 : root1;
+		}
 	}
 
-	// debug render the ray of contact
-	if ( g_theGame->IsDevModeActive()) {
-		DebugRenderLineSegment(10.f, ray.position, Rgba(255, 0, 0, 255), midpoint, Rgba(255, 0, 0, 255));
+	if (s < 0.f || s > sEnd) {
+		return false;
 	}
 
-	// Now that we have closed in on our actual collision spot, lets return it
-	return RaycastHit3(true, midpoint, (midpoint - ray.position).GetLength()); 
+	float u = ClampFloatZeroToOne( u0 + (direction.x * s) );
+	float v = ClampFloatZeroToOne( v0 + (direction.z * s) );
+	outT = tStart + s;
+	outNormal = Vector3( -(slopeU + (twist * v)), 1.f, -(slopeV + (twist * u)) ).GetNormalized();
+	return true;
 }
 
 
@@ -332,22 +411,6 @@ unsigned int GameMap::GetChunkSize() const {
 }
 
 
-bool GameMap::IsCoordValid( IntVector2 const& coord ) {
-
-	if (coord.x < 0 || coord.x >= m_dimensions.x) {
-		return false;
-	}
-	if (coord.y < 0 || coord.y >= m_dimensions.y) {
-		return false;
-	}
-
-	return true;
-}
-
 unsigned int GameMap::GetIndexForCoord( IntVector2 const& coord ) {
 	return (coord.y * m_dimensions.x) + coord.x;
-}
-
-IntVector2 GameMap::GetCoordForIndex( unsigned int index ) {
-	return IntVector2( index % m_dimensions.x, index / m_dimensions.x);
 }
\ No newline at end of file
@@ -2,9 +2,15 @@
 #include "Engine/Math/FloatRange.hpp"
 #include "Engine/Math/AABB3.hpp"
 #include "Engine/Math/Ray.hpp"
+#include "Engine/Math/HeightField.hpp"
 #include "Engine/Renderer/Renderable.h"
 #include <vector>
 
+
+// Rays that leave the map without touching it report a miss this far along
+#define GAMEMAP_RAYCAST_MAX_DISTANCE 50000.f
+
+
 class GameMap {
 	
 public:
@@ -17,18 +23,21 @@ public:
 	Vector3 GetNormalAtDiscretePoint( IntVector2 const& coord );
 	Vector3 GetNormalAtPoint( Vector2 const& point );
 	RaycastHit3 Raycast( unsigned int maxContacts, const Ray3& ray );
+	void RaycastBatch( int rayCount, const Ray3* rays, const float* maxDistances, RaycastHit3* outHits );
 
 
 	IntVector2 GetDimensions();
 	unsigned int GetChunkSize() const;
-	bool IsCoordValid( IntVector2 const& coord );
 
 	unsigned int GetIndexForCoord( IntVector2 const& coord );
-	IntVector2 GetCoordForIndex( unsigned int index );
 
 private:
 	void GenerateHeightMap( unsigned int seed, unsigned int chunksX, unsigned int chunksY, unsigned int chunkSize, float minHeight, float maxHeight );
 	void GenerateNewChunks( unsigned int x, unsigned int y );
+	void BuildHeightBoundsTree();
+
+	RaycastHit3 TraceRay( const Ray3& ray, float maxDistance );
+	bool IntersectCell( int cellX, int cellZ, const Vector3& origin, const Vector3& direction, float tStart, float tEnd, float& outT, Vector3& outNormal );
 
 private:
 	float m_minHeight;
@@ -40,6 +49,10 @@ private:
 	std::vector<Renderable*> m_chunks;
 	std::vector<Renderable*> m_waterChunks;
 
-	Image* m_heightMap;
-	std::vector<Vector3> m_normals;
+	HeightField m_heightField;
+
+	// Min/max height quadtree over the cells between heightmap points. Level 0 has one range per cell,
+	// each level above covers 2x2 blocks of the one below, up to a single range for the whole map.
+	std::vector< std::vector<FloatRange> > m_heightBounds;
+	std::vector<IntVector2> m_heightBoundsDimensions;
 };
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "Engine/DevConsole/DevConsole.hpp"
 #include "Engine/Renderer/DebugRender.hpp"
 #include "Engine/Profiler/Profiler.hpp"
+#include "Engine/Core/Time.hpp"
 
 #include "Game/States/PlayState.hpp"
 #include "Game/GameCommon.hpp"
@@ -13,6 +14,8 @@
 PlayState::PlayState()
 	: m_sceneClock(new Clock(g_masterClock))
 	, m_playerRespawnTimer(m_sceneClock)
+	, m_swarmerGrid(SWARMER_FLOCK_RADIUS)
+	, m_baseGrid(4.f, 64)
 {
 	m_playerRespawnTimer.SetTimer(3.f);
 }
@@ -20,6 +23,7 @@ PlayState::PlayState()
 
 void PlayState::Initialize() {
 	CommandRegistration::RegisterCommand("debug-sphere", SpawnDebugSphereOverPlayer);
+	CommandRegistration::RegisterCommand("swarm_bench", SwarmBenchmarkCommand, "[frames] - Times real frames at 1k, 10k and 50k swarmers, then kills every swarmer");
 
 	g_theRenderer->CreateOrGetBitmapFont("Courier");
 	terrain = new SpriteSheet(g_theRenderer->CreateOrGetTexture("Data/Images/Terrain_8x8.png"), IntVector2(8,8));
@@ -145,6 +149,7 @@ void PlayState::CheckForPlayerVictory() {
 
 void PlayState::Update() {
 	PROFILER_SCOPED_PUSH();
+	UpdateSwarmBenchmark();
 	CheckForPlayerVictory();
 
 	if (g_theInputSystem->WasKeyJustPressed(InputSystem::KEYBOARD_ENTER) && !IsFading() && !DevConsole::GetInstance()->IsOpen()) {
@@ -169,11 +174,19 @@ void PlayState::Update() {
 	m_camera->Update();	
 	m_cameraLight->SetAsPointLight(m_camera->transform.position, Rgba(), 1.f, 0.04f);
 
+	// The grids are built once, after everything has moved and the dead are gone. Collisions use them right
+	// away, and next frame's flocking reads the same grid as the start-of-frame positions, so grid IDs stay valid
+	// until the next ClearDeadGameObjects. Objects killed in combat are removed at the top of the next pass.
 	for (unsigned int i = 0; i < m_sceneObjects.size(); i++) {
-		m_sceneObjects[i]->Update();
+		if (!m_sceneObjects[i]->IsDeletable()) {
+			m_sceneObjects[i]->Update();
+		}
 	}
-	CheckForCombatCollisions();
+	CheckForBulletTerrainCollisions();
 	ClearDeadGameObjects();
+	RebuildSwarmerGrid();
+	RebuildBaseGrid();
+	CheckForCombatCollisions();
 
 	g_audioSystem->SetListenerParameters(m_camera->transform.position, Vector3::ZERO, m_camera->GetForward(), m_camera->GetUp());
 	g_audioSystem->SetSound3DParameters(m_bgMusic, m_camera->transform.position, Vector3::ZERO);
@@ -264,8 +277,7 @@ void PlayState::CheckIfPauseStateChanged() {
 
 void PlayState::SpawnBullet( const Vector3& position, const Vector3& forward, float speed, eTeam team ) {
 	PROFILER_SCOPED_PUSH();
-	Bullet* bullet = new Bullet(this, team);
-	bullet->transform.position = position;
+	Bullet* bullet = new Bullet(this, team, position);
 	bullet->transform.LookToward(forward, Vector3::UP);
 	bullet->SetForwardVelocity(speed);
 	m_bullets.push_back(bullet);
@@ -372,39 +384,71 @@ RaycastHit3 PlayState::Raycast( unsigned int maxContacts, const Ray3& ray ) {
 }
 
  
+void PlayState::RebuildSwarmerGrid() {
+	PROFILER_SCOPED_PUSH();
+	m_swarmerGrid.Clear();
+	for (unsigned int swarmerIndex = 0; swarmerIndex < m_swarmers.size(); swarmerIndex++) {
+		SwarmEnemy* swarmer = m_swarmers[swarmerIndex];
+		if (!swarmer->IsDeletable()) {
+			m_swarmerGrid.Insert((int) swarmerIndex, swarmer->GetPosition(), swarmer->GetCollisionRadius());
+		}
+	}
+	m_swarmerGrid.Build();
+}
+
+
+void PlayState::RebuildBaseGrid() {
+	PROFILER_SCOPED_PUSH();
+	m_baseGrid.Clear();
+	for (unsigned int baseIndex = 0; baseIndex < m_bases.size(); baseIndex++) {
+		Base* base = m_bases[baseIndex];
+		if (!base->IsDeletable()) {
+			m_baseGrid.Insert((int) baseIndex, base->GetPosition(), base->GetCollisionRadius());
+		}
+	}
+	m_baseGrid.Build();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Results land in m_overlapResults, which grows and re-runs the query if a swarm packs more
+// items into one spot than it has room for, so no hit is ever dropped.
+//
+int PlayState::QueryOverlaps( const SpatialHashGrid& grid, const Vector3& center, float radius ) {
+	int hitCount = grid.QueryOverlaps(center, radius, m_overlapResults.data(), (int) m_overlapResults.size());
+	if (hitCount > (int) m_overlapResults.size()) {
+		m_overlapResults.resize(hitCount * 2);
+		hitCount = grid.QueryOverlaps(center, radius, m_overlapResults.data(), (int) m_overlapResults.size());
+	}
+	return hitCount;
+}
+
+
 void PlayState::CheckForCombatCollisions() {
 	PROFILER_SCOPED_PUSH();
-	// Check if player bullets hit a swarmer
 
+	// Check if player bullets hit a swarmer or a base
 	for ( unsigned int bulletIndex = 0; bulletIndex < m_bullets.size(); bulletIndex++ ) {
 		Bullet* bullet = m_bullets[bulletIndex];
-		if (!bullet->IsDeletable()) {
-			for ( unsigned int swarmerIndex = 0; swarmerIndex < m_swarmers.size(); swarmerIndex++ ) {
-				SwarmEnemy* swarmer = m_swarmers[swarmerIndex];
-
-				if (!swarmer->IsDeletable()) {
-					if ((bullet->GetPosition() - swarmer->GetPosition()).GetLength() < (bullet->GetCollisionRadius() + swarmer->GetCollisionRadius())) {
-						swarmer->Damage(bullet->GetDamage());
-						bullet->Kill();
-					}
-				}
+		if (bullet->IsDeletable()) {
+			continue;
+		}
+
+		int hitCount = QueryOverlaps(m_swarmerGrid, bullet->GetPosition(), bullet->GetCollisionRadius());
+		for ( int hitIndex = 0; hitIndex < hitCount; hitIndex++ ) {
+			SwarmEnemy* swarmer = m_swarmers[m_overlapResults[hitIndex]];
+			if (!swarmer->IsDeletable()) {
+				swarmer->Damage(bullet->GetDamage());
+				bullet->Kill();
 			}
 		}
-	}
 
-	// Check if player bullets hit a base
-	for ( unsigned int bulletIndex = 0; bulletIndex < m_bullets.size(); bulletIndex++ ) {
-		Bullet* bullet = m_bullets[bulletIndex];
-		if (!bullet->IsDeletable()) {
-			for ( unsigned int baseIndex = 0; baseIndex < m_bases.size(); baseIndex++ ) {
-				Base* base = m_bases[baseIndex];
-
-				if (!base->IsDeletable()) {
-					if ((bullet->GetPosition() - base->GetPosition()).GetLength() < (bullet->GetCollisionRadius() + base->GetCollisionRadius())) {
-						base->Damage(bullet->GetDamage());
-						bullet->Kill();
-					}
-				}
+		hitCount = QueryOverlaps(m_baseGrid, bullet->GetPosition(), bullet->GetCollisionRadius());
+		for ( int hitIndex = 0; hitIndex < hitCount; hitIndex++ ) {
+			Base* base = m_bases[m_overlapResults[hitIndex]];
+			if (!base->IsDeletable()) {
+				base->Damage(bullet->GetDamage());
+				bullet->Kill();
 			}
 		}
 	}
@@ -413,20 +457,44 @@ void PlayState::CheckForCombatCollisions() {
 	// Check if swarmer hits a player
 
 	if (!player->IsDeletable()) {
-		for ( unsigned int swarmerIndex = 0; swarmerIndex < m_swarmers.size(); swarmerIndex++ ) {
-			SwarmEnemy* swarmer = m_swarmers[swarmerIndex];
-
+		int hitCount = QueryOverlaps(m_swarmerGrid, player->GetPosition(), player->GetCollisionRadius());
+		for ( int hitIndex = 0; hitIndex < hitCount; hitIndex++ ) {
+			SwarmEnemy* swarmer = m_swarmers[m_overlapResults[hitIndex]];
 			if (!swarmer->IsDeletable()) {
-				if ((player->GetPosition() - swarmer->GetPosition()).GetLength() < (player->GetCollisionRadius() + swarmer->GetCollisionRadius())) {
-					player->Damage(swarmer->GetDamageToPlayer());
-					swarmer->Kill();
-				}
+				player->Damage(swarmer->GetDamageToPlayer());
+				swarmer->Kill();
 			}
 		}
 	}
 }
 
 
+//-----------------------------------------------------------------------------------------------
+// One terrain raycast per bullet along the segment it moved this frame, so fast bullets can't
+// skip through a ridge between samples.
+//
+void PlayState::CheckForBulletTerrainCollisions() {
+	PROFILER_SCOPED_PUSH();
+	m_bulletRays.clear();
+	m_bulletRayLengths.clear();
+	for (unsigned int bulletIndex = 0; bulletIndex < m_bullets.size(); bulletIndex++) {
+		Bullet* bullet = m_bullets[bulletIndex];
+		Vector3 movement = bullet->GetPosition() - bullet->GetPreviousPosition();
+		m_bulletRays.push_back(Ray3(bullet->GetPreviousPosition(), movement));
+		m_bulletRayLengths.push_back(movement.GetLength());
+	}
+
+	m_bulletRayHits.resize(m_bulletRays.size(), RaycastHit3(false, Vector3::ZERO, 0.f));
+	testGameMap->RaycastBatch((int) m_bulletRays.size(), m_bulletRays.data(), m_bulletRayLengths.data(), m_bulletRayHits.data());
+
+	for (unsigned int bulletIndex = 0; bulletIndex < m_bullets.size(); bulletIndex++) {
+		if (m_bulletRayHits[bulletIndex].hit && !m_bullets[bulletIndex]->IsDeletable()) {
+			m_bullets[bulletIndex]->Kill();
+		}
+	}
+}
+
+
 void PlayState::ClearDeadGameObjects() {
 	PROFILER_SCOPED_PUSH();
 	for (int swarmerIndex = (int) m_swarmers.size() - 1; swarmerIndex >= 0; swarmerIndex--) {
@@ -453,16 +521,73 @@ void PlayState::SignalPlayerDied() {
 }
 
 
-std::vector<SwarmEnemy*> PlayState::GetSwarmersInRadius( const Vector3& point, float radius ) {
-	PROFILER_SCOPED_PUSH();
-	std::vector<SwarmEnemy*> swarmersInRange;
+//-----------------------------------------------------------------------------------------------
+// swarm_bench: real frames of the running game at 1k, 10k and 50k swarmers. Each stage tops the
+// swarm up to its count on one frame (not timed, it builds every new swarmer's mesh), then times
+// the next frames from one PlayState::Update to the next, so update, render and present are all
+// in it. Swarmers that reach the player die along the way, the count left at the end is printed.
+//
+static const int s_swarmBenchmarkCounts[] = { 1000, 10000, 50000 };
+static const int s_swarmBenchmarkStageCount = sizeof(s_swarmBenchmarkCounts) / sizeof(s_swarmBenchmarkCounts[0]);
 
-	for (unsigned int swarmerIndex = 0; swarmerIndex < m_swarmers.size(); swarmerIndex++) {
-		SwarmEnemy* enemy = m_swarmers[swarmerIndex];
-		if ((enemy->GetPosition() - point).GetLength() <= radius) {
-			swarmersInRange.push_back(enemy);
+
+void PlayState::SwarmBenchmarkCommand( const std::string& command ) {
+	PlayState* playState = g_theGame->GetCurrentPlayState();
+	if (playState == nullptr) {
+		DevConsole::Printf(Rgba(255, 0, 0, 255), "swarm_bench: only runs while playing");
+		return;
+	}
+
+	Command parsed( command );
+	int frameCount = 60;
+	int argument = 0;
+	if ( parsed.PeekNextInt( argument ) && parsed.GetNextInt( argument ) && argument > 0 ) {
+		frameCount = argument;
+	}
+
+	playState->m_swarmBenchmarkStage = 0;
+	playState->m_swarmBenchmarkFrames = frameCount;
+	playState->m_swarmBenchmarkFrame = 0;
+	playState->m_swarmBenchmarkTime = 0;
+	DevConsole::Printf("swarm_bench: %d frames per stage", frameCount);
+}
+
+
+void PlayState::UpdateSwarmBenchmark() {
+	if (m_swarmBenchmarkStage < 0) {
+		return;
+	}
+
+	// Frame 0 spawns, frame 1 starts the clock, every later frame adds the one before it
+	uint64_t now = GetPerformanceCount();
+	if (m_swarmBenchmarkFrame >= 2) {
+		m_swarmBenchmarkTime += now - m_swarmBenchmarkFrameStart;
+	}
+	m_swarmBenchmarkFrameStart = now;
+
+	if (m_swarmBenchmarkFrame == m_swarmBenchmarkFrames + 1) {
+		double frameMS = PerformanceCountToSeconds(m_swarmBenchmarkTime) * 1000.0 / (double) m_swarmBenchmarkFrames;
+		DevConsole::Printf("%6d swarmers: %.3fms/frame (%d left at the end)", s_swarmBenchmarkCounts[m_swarmBenchmarkStage], frameMS, (int) m_swarmers.size());
+
+		m_swarmBenchmarkStage++;
+		m_swarmBenchmarkFrame = 0;
+		m_swarmBenchmarkTime = 0;
+		if (m_swarmBenchmarkStage == s_swarmBenchmarkStageCount) {
+			m_swarmBenchmarkStage = -1;
+			for (unsigned int swarmerIndex = 0; swarmerIndex < m_swarmers.size(); swarmerIndex++) {
+				m_swarmers[swarmerIndex]->Kill();
+			}
+			return;
 		}
 	}
 
-	return swarmersInRange;
-}
\ No newline at end of file
+	if (m_swarmBenchmarkFrame == 0) {
+		const float mapSize = (float) (MAP_CHUNKS_X * MAP_CHUNK_SIZE);
+		int swarmerCount = s_swarmBenchmarkCounts[m_swarmBenchmarkStage];
+		while ((int) m_swarmers.size() < swarmerCount) {
+			SpawnSwarmEnemyAtSpot(Vector3(GetRandomFloatInRange(0.f, mapSize), 0.f, GetRandomFloatInRange(0.f, mapSize)), nullptr);
+		}
+	}
+
+	m_swarmBenchmarkFrame++;
+}
@@ -6,6 +6,7 @@
 #include "Engine/Renderer/OrbitCamera.hpp"
 #include "Engine/Math/Ray.hpp"
 #include "Engine/Physics/Contacts.hpp"
+#include "Engine/Physics/SpatialHashGrid.hpp"
 
 #include "Game/GameObject.hpp"
 #include "Game/Tank.hpp"
@@ -44,6 +45,7 @@ public:
 	SwarmEnemy* SpawnSwarmEnemyAtSpot( const Vector3& position, Base* parent );
 	void SpawnBullet( const Vector3& position, const Vector3& forward, float speed, eTeam team );
 	static void SpawnDebugSphereOverPlayer( const std::string& command );
+	static void SwarmBenchmarkCommand( const std::string& command );
 
 	void SignalPlayerDied();
 	void SignalPlayerWins();
@@ -53,7 +55,8 @@ public:
 	void RemoveBullet( Bullet* bullet );
 
 	RaycastHit3 Raycast( unsigned int maxContacts, const Ray3& ray );
-	std::vector<SwarmEnemy*> GetSwarmersInRadius( const Vector3& point, float radius );
+	template <typename CALLBACK_T>
+	void ForEachSwarmerInRadius( const Vector3& point, float radius, CALLBACK_T callback ) const;
 
 	
 public:
@@ -71,11 +74,16 @@ public:
 
 private:
 
+	void RebuildSwarmerGrid();
+	void RebuildBaseGrid();
+	int QueryOverlaps( const SpatialHashGrid& grid, const Vector3& center, float radius );
 	void CheckForCombatCollisions();
+	void CheckForBulletTerrainCollisions();
 	void CheckForPlayerVictory();
 	void ClearDeadGameObjects();
 
 	void RenderUI() const;
+	void UpdateSwarmBenchmark();
 
 	int m_enemyCount = 0;
 
@@ -83,6 +91,24 @@ private:
 	std::vector<Bullet*> m_bullets;
 	std::vector<Base*> m_bases;
 	std::vector<SwarmEnemy*> m_swarmers;
+
+	// Grid IDs are indices into m_swarmers/m_bases at the time of the rebuild, so they only stay valid until the
+	// next removal. Spawns append and don't disturb them.
+	SpatialHashGrid m_swarmerGrid;
+	SpatialHashGrid m_baseGrid;
+	std::vector<int> m_overlapResults = std::vector<int>( 64 );
+
+	// swarm_bench, stage is -1 when it isn't running
+	int m_swarmBenchmarkStage = -1;
+	int m_swarmBenchmarkFrames = 0;
+	int m_swarmBenchmarkFrame = 0;
+	uint64_t m_swarmBenchmarkFrameStart = 0;
+	uint64_t m_swarmBenchmarkTime = 0;
+
+	// Scratch for the per-frame bullet vs terrain batch, kept around so it doesn't reallocate
+	std::vector<Ray3> m_bulletRays;
+	std::vector<float> m_bulletRayLengths;
+	std::vector<RaycastHit3> m_bulletRayHits;
 	
 	Stopwatch m_playerRespawnTimer;
 
@@ -126,3 +152,17 @@ private:
 
 
 };
+
+
+//----------------------------------------------------------------------------------------------------------------
+// Swarmers as of the last grid rebuild, minus any killed since. Positions passed to the callback are live, not the
+// ones bucketed.
+template <typename CALLBACK_T>
+void PlayState::ForEachSwarmerInRadius( const Vector3& point, float radius, CALLBACK_T callback ) const {
+	m_swarmerGrid.ForEachInRadius( point, radius, [&]( const SpatialHashItem_T& item ) {
+		SwarmEnemy* swarmer = m_swarmers[ item.id ];
+		if ( !swarmer->IsDeletable() ) {
+			callback( swarmer );
+		}
+	} );
+}
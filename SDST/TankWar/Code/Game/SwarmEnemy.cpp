@@ -61,29 +61,28 @@ void SwarmEnemy::SwarmPlayer() {
 	AddForce((direction * m_moveSpeed) - linearVelocity);
 
 	// Do the flocking stuff
-	std::vector<SwarmEnemy*> neighbors = currentState->GetSwarmersInRadius(GetPosition(), SWARMER_FLOCK_RADIUS);
-
-	if (neighbors.size() > 1) {
-		Vector3 separationForce = Vector3::ZERO;
-		Vector3 averagePosition = Vector3::ZERO;
-		Vector3 averageVelocity = Vector3::ZERO;
-		for (int neighborIndex = 0; neighborIndex < neighbors.size(); neighborIndex++) {
-			SwarmEnemy* other = neighbors[neighborIndex];
-			if (this != other) {
-				averagePosition += neighbors[neighborIndex]->transform.position; // For cohesiveness
-				averageVelocity += neighbors[neighborIndex]->linearVelocity;	// For alignment
-
-				// Get the separation force
-				separationForce += (transform.position - neighbors[neighborIndex]->transform.position).GetNormalized();
-			}
+	Vector3 separationForce = Vector3::ZERO;
+	Vector3 averagePosition = Vector3::ZERO;
+	Vector3 averageVelocity = Vector3::ZERO;
+	int neighborCount = 0;
+	currentState->ForEachSwarmerInRadius(GetPosition(), SWARMER_FLOCK_RADIUS, [&]( SwarmEnemy* other ) {
+		neighborCount++;
+		if (this != other) {
+			averagePosition += other->transform.position; // For cohesiveness
+			averageVelocity += other->linearVelocity;	// For alignment
+
+			// Get the separation force
+			separationForce += (transform.position - other->transform.position).GetNormalized();
 		}
+	});
 
+	if (neighborCount > 1) {
 		if (separationForce.GetLengthSquared() > 0.f) {
 			AddForce((separationForce.GetNormalized() * SWARMER_SEPARATION_FACTOR) - linearVelocity);
 		}
 
-		averagePosition = averagePosition * ( 1.f / (float) neighbors.size() );
-		averageVelocity = averageVelocity * ( 1.f / (float) neighbors.size() );
+		averagePosition = averagePosition * ( 1.f / (float) neighborCount );
+		averageVelocity = averageVelocity * ( 1.f / (float) neighborCount );
 
 		AddForce(((averagePosition - transform.position).GetNormalized() * SWARMER_COHESION_FACTOR) - linearVelocity);
 		if (averageVelocity.GetLengthSquared() > 0.f) {
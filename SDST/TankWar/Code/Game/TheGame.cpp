@@ -74,7 +74,7 @@ void TheGame::Update() {
 	}
 
 	if (m_spam) {
-		Logger::PrintTaggedf("spam", "This is an annoying spam message");
+		LOG_TAGGEDF("spam", "This is an annoying spam message");
 		Logger::Warningf("There's some spam going on! Restart to get rid of it");
 		Logger::Errorf("something is really wrong here");
 	}
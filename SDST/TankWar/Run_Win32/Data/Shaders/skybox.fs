@@ -1,9 +1,19 @@
 #version 420 core
 
-uniform mat4 VIEW;
-uniform float MAX_FOG_DISTANCE;
-uniform float FOG_FACTOR;
-uniform vec4 FOG_COLOR;
+layout(std140, binding = 2) uniform CameraBlock {
+	mat4 VIEW;
+	mat4 PROJECTION;
+	mat4 CAMERA;
+	vec3 EYE_POSITION;
+	vec3 EYE_DIRECTION;
+};
+
+layout(std140, binding = 1) uniform FrameBlock {
+	float TIME_IN_SECONDS;
+	float MAX_FOG_DISTANCE;
+	float FOG_FACTOR;
+	vec4 FOG_COLOR;
+};
 
 layout(binding = 0) uniform samplerCube skybox;
 